@@ -36,6 +36,7 @@
 
 #include <cdogs/campaign_entry.h>
 #include <cdogs/json_utils.h>
+#include <cdogs/json_writer.h>
 #include <cdogs/sys_specifics.h>
 #include <cdogs/utils.h>
 
@@ -106,15 +107,14 @@ static void LoadCampaignNode(CampaignEntry *c, json_t *node)
 	}
 	c->Mode = GAME_MODE_NORMAL;
 }
-static void AddCampaignNode(CampaignEntry *c, json_t *root)
+static void WriteCampaign(const CampaignEntry *c, JSONWriter *w)
 {
-	json_t *subConfig = json_new_object();
+	JSONWriterBeginObject(w, "Campaign");
 	// Save relative path so that save files are portable across installs
 	char path[CDOGS_PATH_MAX] = "";
 	RelPathFromCWD(path, c->Path);
-	json_insert_pair_into_object(
-		subConfig, "Path", json_new_string(json_escape(path)));
-	json_insert_pair_into_object(root, "Campaign", subConfig);
+	JSONWriterString(w, "Path", path);
+	JSONWriterEndObject(w);
 }
 
 static void LoadPlayersNode(CArray *players, json_t *node)
@@ -152,27 +152,26 @@ static void LoadPlayersNode(CArray *players, json_t *node)
 		CArrayPushBack(players, &ps);
 	}
 }
-static void AddPlayersNode(CArray *players, json_t *root)
+static void WritePlayers(const CArray *players, JSONWriter *w)
 {
-	json_t *playersNode = json_new_array();
+	JSONWriterBeginArray(w, "Players");
 
 	CA_FOREACH(const PlayerSave, ps, *players)
-	json_t *playerNode = json_new_object();
+	JSONWriterBeginObject(w, NULL);
 
-	json_t *gunsNode = json_new_array();
+	JSONWriterBeginArray(w, "Guns");
 	for (int i = 0; i < MAX_WEAPONS; i++)
 	{
-		json_insert_child(
-			gunsNode, json_new_string(ps->Guns[i] != NULL ? ps->Guns[i] : ""));
+		JSONWriterString(w, NULL, ps->Guns[i]);
 	}
-	json_insert_pair_into_object(playerNode, "Guns", gunsNode);
-	AddIntArray(playerNode, "Ammo", &ps->ammo);
-	AddIntPair(playerNode, "Lives", ps->Lives);
+	JSONWriterEndArray(w);
+	JSONWriterIntArray(w, "Ammo", &ps->ammo);
+	JSONWriterInt(w, "Lives", ps->Lives);
 
-	json_insert_child(playersNode, playerNode);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
 
-	json_insert_pair_into_object(root, "Players", playersNode);
+	JSONWriterEndArray(w);
 }
 
 static void LoadMissionNode(CampaignSave *m, json_t *node, const int version)
@@ -195,20 +194,22 @@ static void LoadMissionNode(CampaignSave *m, json_t *node, const int version)
 	{
 		LoadIntArray(&m->MissionsCompleted, node, "MissionsCompleted");
 	}
+	LoadInt(&m->RandomSeed, node, "RandomSeed");
 	// Check that file exists
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, m->Campaign.Path);
 	m->IsValid = access(buf, F_OK | R_OK) != -1;
 	LoadPlayersNode(&m->Players, node);
 }
-static json_t *CreateMissionNode(CampaignSave *m)
+static void WriteMission(const CampaignSave *m, JSONWriter *w)
 {
-	json_t *subConfig = json_new_object();
-	AddCampaignNode(&m->Campaign, subConfig);
-	AddIntPair(subConfig, "NextMission", m->NextMission);
-	AddIntArray(subConfig, "MissionsCompleted", &m->MissionsCompleted);
-	AddPlayersNode(&m->Players, subConfig);
-	return subConfig;
+	JSONWriterBeginObject(w, NULL);
+	WriteCampaign(&m->Campaign, w);
+	JSONWriterInt(w, "NextMission", m->NextMission);
+	JSONWriterIntArray(w, "MissionsCompleted", &m->MissionsCompleted);
+	JSONWriterInt(w, "RandomSeed", m->RandomSeed);
+	WritePlayers(&m->Players, w);
+	JSONWriterEndObject(w);
 }
 
 static void LoadMissionNodes(
@@ -228,13 +229,14 @@ static void LoadMissionNodes(
 		child = child->next;
 	}
 }
-static void AddMissionNodes(Autosave *a, json_t *root, const char *nodeName)
+static void WriteMissions(
+	const Autosave *a, JSONWriter *w, const char *nodeName)
 {
-	json_t *missions = json_new_array();
-	CA_FOREACH(CampaignSave, m, a->Campaigns)
-	json_insert_child(missions, CreateMissionNode(m));
+	JSONWriterBeginArray(w, nodeName);
+	CA_FOREACH(const CampaignSave, m, a->Campaigns)
+	WriteMission(m, w);
 	CA_FOREACH_END()
-	json_insert_pair_into_object(root, nodeName, missions);
+	JSONWriterEndArray(w);
 }
 
 static CampaignSave *FindCampaign(
@@ -291,30 +293,21 @@ bail:
 
 void AutosaveSave(Autosave *autosave, const char *filename)
 {
-	char *text = NULL;
-	json_t *root;
-
-	root = json_new_object();
-	AddIntPair(root, "Version", VERSION);
-	AddIntPair(root, "LastCampaignIndex", autosave->LastCampaignIndex);
-	AddMissionNodes(autosave, root, "Missions");
-
-	json_tree_to_string(root, &text);
-	char *formatText = json_format_string(text);
-	
-	FILE *f = fopen(filename, "w");
-	if (f == NULL)
+	JSONWriter w;
+	if (!JSONWriterOpen(&w, filename))
 	{
 		printf("Error saving autosave '%s'\n", filename);
 		return;
 	}
-	fputs(formatText, f);
-	fclose(f);
-
-	// clean up
-	CFREE(formatText);
-	CFREE(text);
-	json_free_value(&root);
+	JSONWriterBeginObject(&w, NULL);
+	JSONWriterInt(&w, "Version", VERSION);
+	JSONWriterInt(&w, "LastCampaignIndex", autosave->LastCampaignIndex);
+	WriteMissions(autosave, &w, "Missions");
+	JSONWriterEndObject(&w);
+	if (!JSONWriterClose(&w))
+	{
+		printf("Error saving autosave '%s'\n", filename);
+	}
 
 #ifdef __EMSCRIPTEN__
 	EM_ASM(
@@ -352,13 +345,14 @@ static CampaignSave *FindCampaign(
 
 void AutosaveAdd(
 	Autosave *a, const CampaignEntry *ce, const int missionIndex,
-	const int nextMission, const CArray *playerDatas)
+	const int nextMission, const int randomSeed, const CArray *playerDatas)
 {
 	CampaignSave ms;
 	CampaignSaveInit(&ms);
 	CampaignEntryCopy(&ms.Campaign, ce);
 	CArrayPushBack(&ms.MissionsCompleted, &missionIndex);
 	ms.NextMission = nextMission;
+	ms.RandomSeed = randomSeed;
 	CA_FOREACH(const PlayerData, pd, *playerDatas)
 	PlayerSave ps;
 	PlayerSaveInit(&ps);
@@ -394,6 +388,7 @@ void AutosaveAddCampaign(Autosave *autosave, CampaignSave *cs)
 	}
 
 	existing->NextMission = cs->NextMission;
+	existing->RandomSeed = cs->RandomSeed;
 	// Update missions completed
 	CA_FOREACH(const int, missionIndex, cs->MissionsCompleted)
 	bool found = false;
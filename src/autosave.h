@@ -48,6 +48,7 @@ typedef struct
 	bool IsValid;
 	int NextMission;
 	CArray MissionsCompleted;	// of int
+	int RandomSeed;	// Game.RandomSeed the campaign was played with
 	CArray Players;	// of PlayerSave
 } CampaignSave;
 
@@ -66,7 +67,7 @@ void AutosaveInit(Autosave *autosave);
 void AutosaveTerminate(Autosave *autosave);
 void AutosaveLoad(Autosave *autosave, const char *filename);
 void AutosaveSave(Autosave *autosave, const char *filename);
-void AutosaveAdd(Autosave *a, const CampaignEntry *ce, const int missionIndex, const int nextMission, const CArray *playerDatas);
+void AutosaveAdd(Autosave *a, const CampaignEntry *ce, const int missionIndex, const int nextMission, const int randomSeed, const CArray *playerDatas);
 void AutosaveAddCampaign(Autosave *autosave, CampaignSave *cs);
 const CampaignSave *AutosaveGetCampaign(
 	Autosave *autosave, const char *path);
@@ -149,15 +149,9 @@ static void CampaignIntroDraw(GameLoopData *data)
 	CFREE(buf);
 
 	// Display campaign description
-	// allow some slack for newlines
-	if (strlen(sData->c->Description) > 0)
-	{
-		CMALLOC(buf, strlen(sData->c->Description) * 2);
-		// Pad about 1/6th of the screen width total (1/12th left and right)
-		FontSplitLines(sData->c->Description, buf, w * 5 / 6);
-		FontStr(buf, svec2i(w / 12, y));
-		CFREE(buf);
-	}
+	// Pad about 1/6th of the screen width total (1/12th left and right)
+	FontStrMaskWrap(
+		sData->c->Description, svec2i(w / 12, y), colorWhite, w * 5 / 6);
 
 	BlitUpdateFromBuf(&gGraphicsDevice, gGraphicsDevice.screen);
 }
@@ -255,6 +249,12 @@ static void MissionBriefingOnEnter(GameLoopData *data)
 			&gSoundDevice.music, MUSIC_BRIEFING,
 			&mData->C->CustomSongs[MUSIC_BRIEFING]);
 	}
+	// Load what the mission needs while the player reads the briefing
+	ResidencyLogStats(&gTextureResidency);
+	ResidencyLogStats(&gSoundResidency);
+	VoiceManagerLogStats(&gSoundDevice.voices);
+	SoundOcclusionLogStats(&gSoundDevice.occlusion);
+	MissionPrefetch(mData->MissionOptions->missionData, &mData->C->characters);
 }
 static void MissionBriefingOnExit(GameLoopData *data)
 {
@@ -472,7 +472,8 @@ static void MissionSummaryOnEnter(GameLoopData *data)
 	{
 		AutosaveAdd(
 			&gAutosave, &mData->c->Entry, mData->m->index,
-			mData->m->NextMission, &gPlayerDatas);
+			mData->m->NextMission, ConfigGetInt(&gConfig, "Game.RandomSeed"),
+			&gPlayerDatas);
 		AutosaveSave(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
 	}
 
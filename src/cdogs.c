@@ -65,6 +65,8 @@
 #include <cdogs/font_utils.h>
 #include <cdogs/grafx.h>
 #include <cdogs/handle_game_events.h>
+#include <cdogs/hot_reload.h>
+#include <cdogs/image_cache.h>
 #include <cdogs/joystick.h>
 #include <cdogs/keyboard.h>
 #include <cdogs/log.h>
@@ -105,7 +107,6 @@ int main(int argc, char *argv[])
 	ENetAddress connectAddr;
 	memset(&connectAddr, 0, sizeof connectAddr);
 
-	srand((unsigned int)time(NULL));
 	LogInit();
 
 	PrintTitle();
@@ -139,10 +140,14 @@ int main(int argc, char *argv[])
 	ProcessCommandLine(buf, argc, argv);
 	LOG(LM_MAIN, LL_INFO, "Command line (%d args):%s", argc, buf);
     int demoQuitTimer = 0;
-	if (!ParseArgs(argc, argv, &connectAddr, &loadCampaign, &demoQuitTimer))
+	uint64_t seed = (uint64_t)time(NULL);
+	if (!ParseArgs(
+			argc, argv, &connectAddr, &loadCampaign, &demoQuitTimer, &seed))
 	{
 		goto bail;
 	}
+	LOG(LM_MAIN, LL_INFO, "Random seed %llu", (unsigned long long)seed);
+	RngSeedAll(seed);
 
 #ifndef __EMSCRIPTEN__
 	const int sdlFlags = SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_VIDEO |
@@ -185,7 +190,17 @@ int main(int argc, char *argv[])
 	FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
 	LoadingScreenInit(&gLoadingScreen, &gGraphicsDevice);
 	LoadingScreenDraw(&gLoadingScreen, "Loading graphics...", 0.0f);
-	PicManagerLoad(&gPicManager);
+#ifndef __EMSCRIPTEN__
+	ImageCacheInit(
+		&gImageCache, GetConfigFilePath("cache/images"),
+		(uint64_t)ConfigGetInt(&gConfig, "Graphics.ImageCacheSize") * 1024 *
+			1024);
+#endif
+	// Graphics, sounds and char sprites decode in the background while the
+	// rest of the startup runs
+	AssetLoader assets;
+	AssetLoaderInit(&assets, -1);
+	PicManagerQueueLoad(&assets, &gPicManager);
 
 	GetDataFilePath(buf, "");
 	LOG(LM_MAIN, LL_INFO, "data dir(%s)", buf);
@@ -203,13 +218,14 @@ int main(int argc, char *argv[])
 	{
 		LOG(LM_MAIN, LL_ERROR, "An error occurred while initializing ENet.");
 		err = EXIT_FAILURE;
+		AssetLoaderTerminate(&assets);
 		goto bail;
 	}
 	NetClientInit(&gNetClient);
 #endif
 
 	LoadingScreenDraw(&gLoadingScreen, "Initializing sound device...", 0.25f);
-	SoundInitialize(&gSoundDevice, "sounds");
+	SoundInitializeQueue(&gSoundDevice, "sounds", &assets);
 	if (!gSoundDevice.isInitialised)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Sound initialization failed!");
@@ -219,7 +235,8 @@ int main(int argc, char *argv[])
     gEventHandlers.DemoQuitTimer = demoQuitTimer;
 	NetServerInit(&gNetServer);
 	LoadingScreenDraw(&gLoadingScreen, "Loading character sprites...", 0.34f);
-	CharSpriteClassesInit(&gCharSpriteClasses);
+	CharSpriteClassesInitQueue(&gCharSpriteClasses, &assets);
+	AssetLoaderTerminate(&assets);
 
 	LoadingScreenDraw(&gLoadingScreen, "Loading particles...", 0.42f);
 	ParticleClassesInit(&gParticleClasses, "data/particles.json");
@@ -242,6 +259,7 @@ int main(int argc, char *argv[])
 	LoadingScreenDraw(&gLoadingScreen, "Loading map objects...", 0.92f);
 	MapObjectsInit(
 		&gMapObjects, "data/map_objects.json", &gAmmo, &gWeaponClasses);
+	HotReloadInit(&gHotReload);
 	CollisionSystemInit(&gCollisionSystem);
 	CampaignInit(&gCampaign);
 	PlayerDataInit(&gPlayerDatas);
@@ -297,6 +315,7 @@ int main(int argc, char *argv[])
 bail:
 	NetServerTerminate(&gNetServer);
 	PlayerDataTerminate(&gPlayerDatas);
+	HotReloadTerminate(&gHotReload);
 	MapObjectsTerminate(&gMapObjects);
 	PickupClassesTerminate(&gPickupClasses);
 	ParticleClassesTerminate(&gParticleClasses);
@@ -314,6 +333,7 @@ bail:
 
 	CharSpriteClassesTerminate(&gCharSpriteClasses);
 	PicManagerTerminate(&gPicManager);
+	ImageCacheTerminate(&gImageCache);
 	FontTerminate(&gFont);
 	GraphicsTerminate(&gGraphicsDevice);
 	AutosaveSave(&gAutosave, GetConfigFilePath(AUTOSAVE_FILE));
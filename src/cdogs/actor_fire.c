@@ -103,7 +103,8 @@ void OnGunFire(const NGunFire gf, SoundDevice *sd)
 			(wc->u.Normal.Spread.Count - 1) * wc->u.Normal.Spread.Width / 2;
 		for (int i = 0; i < wc->u.Normal.Spread.Count; i++)
 		{
-			const float recoil = RAND_FLOAT(-0.5f, 0.5f) * wc->u.Normal.Recoil;
+			const float recoil = RAND_FLOAT(RNG_GAMEPLAY, -0.5f, 0.5f) *
+								 wc->u.Normal.Recoil;
 			const float finalAngle = gf.Angle + spreadStartAngle +
 									 i * wc->u.Normal.Spread.Width + recoil;
 			GameEvent ab = GameEventNew(GAME_EVENT_ADD_BULLET);
@@ -111,7 +112,8 @@ void OnGunFire(const NGunFire gf, SoundDevice *sd)
 			ab.u.AddBullet.MuzzleHeight = gf.Z;
 			ab.u.AddBullet.Angle = finalAngle;
 			ab.u.AddBullet.Elevation = RAND_INT(
-				wc->u.Normal.ElevationLow, wc->u.Normal.ElevationHigh);
+				RNG_GAMEPLAY, wc->u.Normal.ElevationLow,
+				wc->u.Normal.ElevationHigh);
 			ab.u.AddBullet.Flags = gf.Flags;
 			ab.u.AddBullet.ActorUID = gf.ActorUID;
 
@@ -33,38 +33,69 @@
 #include "game_events.h"
 #include "gamedata.h"
 #include "handle_game_events.h"
+#include "log.h"
 
+// Used if there is nowhere to place an actor
+#define DEFAULT_PLACEMENT svec2(TILE_WIDTH * 3 / 2, TILE_HEIGHT * 3 / 2)
+
+typedef struct
+{
+	int halfMap;
+	int attemptsAwayFromExits;
+	bool hasFallback;
+	struct vec2 fallback;
+	struct vec2 pos;
+} PlacePlayerSimpleData;
+static bool TryPlacePlayerSimple(
+	const Map *map, const struct vec2 pos, void *data);
 static struct vec2 PlacePlayerSimple(const Map *map)
 {
-	const int halfMap =
+	PlacePlayerSimpleData data;
+	memset(&data, 0, sizeof data);
+	data.halfMap =
 		MAX(map->Size.x * TILE_WIDTH, map->Size.y * TILE_HEIGHT) / 2;
-	int attemptsAwayFromExits = 0;
-
-	struct vec2 pos = svec2_zero();
-	bool ok = false;
-	for (int j = 0; j < 10000 && !ok; j++)
+	if (MapPlaceRandomPos(
+			map, PLACEMENT_ACCESS_ANY, TryPlacePlayerSimple, &data))
+	{
+		return data.pos;
+	}
+	if (data.hasFallback)
 	{
-		pos = MapGetRandomPos(map);
-		ok = MapIsPosOKForPlayer(map, pos, false);
-		if (!ok)
-			continue;
-		if (attemptsAwayFromExits < 100)
+		return data.fallback;
+	}
+	LOG(LM_MAP, LL_ERROR, "nowhere to place player");
+	return DEFAULT_PLACEMENT;
+}
+static bool TryPlacePlayerSimple(
+	const Map *map, const struct vec2 pos, void *data)
+{
+	PlacePlayerSimpleData *pData = data;
+	if (!MapIsPosOKForPlayer(map, pos, false))
+	{
+		return false;
+	}
+	if (pData->attemptsAwayFromExits < 100)
+	{
+		pData->attemptsAwayFromExits++;
+		// Try to place at least half the map away from any exits
+		for (int i = 0; i < (int)map->exits.size; i++)
 		{
-			attemptsAwayFromExits++;
-			// Try to place at least half the map away from any exits
-			for (int i = 0; i < (int)map->exits.size; i++)
+			const struct vec2 exitPos = MapGetExitPos(map, i);
+			if (fabsf(pos.x - exitPos.x) > pData->halfMap &&
+				fabsf(pos.y - exitPos.y) > pData->halfMap)
 			{
-				const struct vec2 exitPos = MapGetExitPos(map, i);
-				if (fabsf(pos.x - exitPos.x) > halfMap &&
-					fabsf(pos.y - exitPos.y) > halfMap)
+				// Still usable if nowhere better turns up
+				if (!pData->hasFallback)
 				{
-					ok = false;
-					break;
+					pData->hasFallback = true;
+					pData->fallback = pos;
 				}
+				return false;
 			}
 		}
 	}
-	return pos;
+	pData->pos = pos;
+	return true;
 }
 
 static struct vec2 PlaceActorNear(
@@ -116,8 +147,10 @@ static struct vec2 PlaceActorNear(
 
 static bool TryPlaceOneAwayFromPlayers(
 	const Map *map, const struct vec2 pos, void *data);
+static bool TryPlaceOneClear(
+	const Map *map, const struct vec2 pos, void *data);
 struct vec2 PlaceAwayFromPlayers(
-	const Map *map, const bool giveUp, const PlacementAccessFlags paFlags)
+	const Map *map, const PlacementAccessFlags paFlags)
 {
 	struct vec2 out;
 	if (MapPlaceRandomPos(map, paFlags, TryPlaceOneAwayFromPlayers, &out))
@@ -125,20 +158,15 @@ struct vec2 PlaceAwayFromPlayers(
 		return out;
 	}
 
-	// Keep trying, but this time try spawning anywhere,
+	// Try again, but this time try spawning anywhere,
 	// even close to player
-	for (int i = 0; i < 10000 || !giveUp; i++)
+	if (MapPlaceRandomPos(map, PLACEMENT_ACCESS_ANY, TryPlaceOneClear, &out))
 	{
-		const struct vec2 pos = MapGetRandomPos(map);
-		if (MapIsTileAreaClear(map, pos, svec2i(ACTOR_W, ACTOR_H)))
-		{
-			return pos;
-		}
+		return out;
 	}
 
-	// Uh oh
-	// TODO: scan map for a safe position, to use as default
-	return svec2(TILE_WIDTH * 3 / 2, TILE_HEIGHT * 3 / 2);
+	LOG(LM_MAP, LL_ERROR, "nowhere to place actor");
+	return DEFAULT_PLACEMENT;
 }
 static bool TryPlaceOneAwayFromPlayers(
 	const Map *map, const struct vec2 pos, void *data)
@@ -158,18 +186,28 @@ static bool TryPlaceOneAwayFromPlayers(
 	}
 	return false;
 }
+static bool TryPlaceOneClear(
+	const Map *map, const struct vec2 pos, void *data)
+{
+	struct vec2 *out = data;
+	if (MapIsTileAreaClear(map, pos, svec2i(ACTOR_W, ACTOR_H)))
+	{
+		*out = pos;
+		return true;
+	}
+	return false;
+}
 
 struct vec2 PlacePrisoner(const Map *map)
 {
 	struct vec2 pos;
-	do
+	if (MapPlaceRandomPos(
+			map, PLACEMENT_ACCESS_LOCKED, TryPlaceOneClear, &pos))
 	{
-		do
-		{
-			pos = MapGetRandomPos(map);
-		} while (!MapPosIsInLockedRoom(map, pos));
-	} while (!MapIsTileAreaClear(map, pos, svec2i(ACTOR_W, ACTOR_H)));
-	return pos;
+		return pos;
+	}
+	LOG(LM_MAP, LL_WARN, "no clear locked room for prisoner");
+	return PlaceAwayFromPlayers(map, PLACEMENT_ACCESS_ANY);
 }
 
 struct vec2 PlacePlayer(
@@ -180,7 +218,7 @@ struct vec2 PlacePlayer(
 	if (IsPVP(gCampaign.Entry.Mode))
 	{
 		// In a PVP mode, always place players apart
-		pos = PlaceAwayFromPlayers(map, false, PLACEMENT_ACCESS_ANY);
+		pos = PlaceAwayFromPlayers(map, PLACEMENT_ACCESS_ANY);
 	}
 	else if (
 		ConfigGetEnum(&gConfig, "Interface.Splitscreen") ==
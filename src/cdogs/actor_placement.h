@@ -32,8 +32,10 @@
 #include "net_util.h"
 
 
+// Places are tried at most once per walkable tile; if none are clear,
+// logs an error and returns a default position
 struct vec2 PlaceAwayFromPlayers(
-	const Map *map, const bool giveUp, const PlacementAccessFlags paFlags);
+	const Map *map, const PlacementAccessFlags paFlags);
 struct vec2 PlacePrisoner(const Map *map);
 
 struct vec2 PlacePlayer(
@@ -670,7 +670,9 @@ void ActorHeal(TActor *actor, int health)
 	ap.Z = 10;
 	for (int i = 0; i < MAX(health / 20, 1); i++)
 	{
-		ap.Vel = svec2(RAND_FLOAT(-0.2f, 0.2f), RAND_FLOAT(-0.2f, 0.2f));
+		ap.Vel = svec2(
+			RAND_FLOAT(RNG_COSMETIC, -0.2f, 0.2f),
+			RAND_FLOAT(RNG_COSMETIC, -0.2f, 0.2f));
 		EmitterStart(&actor->healEffect, &ap);
 	}
 }
@@ -1451,8 +1453,8 @@ static void ActorAddAmmoPickup(const TActor *actor)
 			sprintf(e.u.AddPickup.PickupClass, "ammo_%s", a->Name);
 			// Add a little random offset so the pickups aren't all together
 			const struct vec2 offset = svec2(
-				(float)RAND_INT(-TILE_WIDTH, TILE_WIDTH) / 2,
-				(float)RAND_INT(-TILE_HEIGHT, TILE_HEIGHT) / 2);
+				(float)RAND_INT(RNG_GAMEPLAY, -TILE_WIDTH, TILE_WIDTH) / 2,
+				(float)RAND_INT(RNG_GAMEPLAY, -TILE_HEIGHT, TILE_HEIGHT) / 2);
 			e.u.AddPickup.Pos = Vec2ToNet(svec2_add(actor->Pos, offset));
 			GameEventsEnqueue(&gGameEvents, e);
 		}
@@ -1933,8 +1935,10 @@ void ActorHit(const NThingDamage d)
 		// See if there is one already; if so remove it and add a new one,
 		// combining the damage numbers
 		int damage = (int)d.Power;
-		struct vec2 pos =
-			svec2_add(a->Pos, svec2(RAND_FLOAT(-3, 3), RAND_FLOAT(-3, 3)));
+		struct vec2 pos = svec2_add(
+			a->Pos, svec2(
+						RAND_FLOAT(RNG_COSMETIC, -3, 3),
+						RAND_FLOAT(RNG_COSMETIC, -3, 3)));
 		CA_FOREACH(const Particle, p, gParticles)
 		if (p->isInUse && p->ActorUID == a->uid)
 		{
@@ -2069,8 +2073,8 @@ static void ActorAddBloodSplatters(
 		{
 			bloodSize = 1;
 		}
-		const struct vec2 vel =
-			svec2_scale(hitVNorm, speedBase * RAND_FLOAT(0.5f, 1));
+		const struct vec2 vel = svec2_scale(
+			hitVNorm, speedBase * RAND_FLOAT(RNG_COSMETIC, 0.5f, 1));
 		AddParticle ap;
 		memset(&ap, 0, sizeof ap);
 		ap.Pos = a->Pos;
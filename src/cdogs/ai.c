@@ -392,7 +392,7 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 	}
 
 	bool bypass = false;
-	const int roll = rand() % rollLimit;
+	const int roll = RAND_INT(RNG_AI, 0, rollLimit);
 	if (actor->flags & FLAGS_FOLLOWER)
 	{
 		cmd = Follow(actor);
@@ -445,7 +445,7 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 		}
 		else if (roll < bot->probabilityToMove)
 		{
-			cmd = DirectionToCmd(rand() & 7);
+			cmd = DirectionToCmd(RAND_INT(RNG_AI, 0, 8));
 			ActorSetAIState(actor, AI_STATE_TRACK);
 		}
 		actor->aiContext->Delay = bot->actionDelay * delayModifier;
@@ -461,7 +461,8 @@ static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit)
 				// Shoot in a random direction away
 				for (int j = 0; j < 10; j++)
 				{
-					direction_e d = (direction_e)(rand() % DIRECTION_COUNT);
+					direction_e d =
+						(direction_e)RAND_INT(RNG_AI, 0, DIRECTION_COUNT);
 					if (!IsFacingPlayer(actor, d))
 					{
 						cmd = DirectionToCmd(d) | CMD_BUTTON1;
@@ -608,7 +609,7 @@ void AIAddRandomEnemies(const int enemies, const Mission *m)
 		const Character *c =
 			CArrayGet(&gCampaign.Setting.characters.OtherChars, charId);
 		GameEvent e = GameEventNewActorAdd(
-			PlaceAwayFromPlayers(&gMap, true, PLACEMENT_ACCESS_ANY), c, true);
+			PlaceAwayFromPlayers(&gMap, PLACEMENT_ACCESS_ANY), c, true);
 		e.u.ActorAdd.CharId = charId;
 		GameEventsEnqueue(&gGameEvents, e);
 		gBaddieCount++;
@@ -629,7 +630,7 @@ void InitializeBadGuys(void)
 		for (; o->placed < o->Count; o->placed++)
 		{
 			GameEvent e = GameEventNewActorAdd(
-				PlaceAwayFromPlayers(&gMap, false, paFlags), c, true);
+				PlaceAwayFromPlayers(&gMap, paFlags), c, true);
 			e.u.ActorAdd.CharId = charId;
 			e.u.ActorAdd.ThingFlags = ObjectiveToThing(_ca_index);
 			GameEventsEnqueue(&gGameEvents, e);
@@ -649,7 +650,7 @@ void InitializeBadGuys(void)
 			GameEvent e = GameEventNewActorAdd(
 				MapHasLockedRooms(&gMap)
 					? PlacePrisoner(&gMap)
-					: PlaceAwayFromPlayers(&gMap, false, paFlags),
+					: PlaceAwayFromPlayers(&gMap, paFlags),
 				c, true);
 			e.u.ActorAdd.CharId = charId;
 			e.u.ActorAdd.ThingFlags = ObjectiveToThing(_ca_index);
@@ -681,7 +682,7 @@ void CreateEnemies(void)
 		const Character *c =
 			CArrayGet(&gCampaign.Setting.characters.OtherChars, charId);
 		GameEvent e = GameEventNewActorAdd(
-			PlaceAwayFromPlayers(&gMap, true, PLACEMENT_ACCESS_ANY), c, true);
+			PlaceAwayFromPlayers(&gMap, PLACEMENT_ACCESS_ANY), c, true);
 		e.u.ActorAdd.CharId = charId;
 		GameEventsEnqueue(&gGameEvents, e);
 		gBaddieCount++;
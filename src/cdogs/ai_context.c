@@ -80,9 +80,9 @@ bool AIContextShowChatter(const AIChatterFrequency f)
 	case AICHATTER_NONE:
 		return false;
 	case AICHATTER_SELDOM:
-		return RAND_INT(0, 100) > 90;
+		return RAND_INT(RNG_AI, 0, 100) > 90;
 	case AICHATTER_OFTEN:
-		return RAND_INT(0, 100) > 50;
+		return RAND_INT(RNG_AI, 0, 100) > 50;
 	case AICHATTER_ALWAYS:
 		return true;
 	default:
@@ -63,8 +63,9 @@ int AICoopGetCmd(TActor *actor, const int ticks)
 		actor->aiContext->Delay = MAX(0, actor->aiContext->Delay - ticks);
 		if (actor->aiContext->Delay == 0)
 		{
-			actor->aiContext->Delay = CONFUSION_STATE_TICKS_MIN +
-									  (rand() % CONFUSION_STATE_TICKS_RANGE);
+			actor->aiContext->Delay =
+				CONFUSION_STATE_TICKS_MIN +
+				RAND_INT(RNG_AI, 0, CONFUSION_STATE_TICKS_RANGE);
 			if (s->Type == AI_CONFUSION_CONFUSED)
 			{
 				s->Type = AI_CONFUSION_CORRECT;
@@ -74,8 +75,9 @@ int AICoopGetCmd(TActor *actor, const int ticks)
 				ActorSetAIState(actor, AI_STATE_CONFUSED);
 				s->Type = AI_CONFUSION_CONFUSED;
 				// Generate the confused action
-				s->Cmd = rand() & (CMD_LEFT | CMD_RIGHT | CMD_UP | CMD_DOWN |
-								   CMD_BUTTON1 | CMD_BUTTON2);
+				s->Cmd = (int)RngNext(RNG_AI) &
+						 (CMD_LEFT | CMD_RIGHT | CMD_UP | CMD_DOWN |
+						  CMD_BUTTON1 | CMD_BUTTON2);
 			}
 		}
 		// Choose confusion action based on state
@@ -49,6 +49,12 @@ int StrAmmoId(const char *s)
 	{
 		return 0;
 	}
+	const int id = AmmoFindId(s);
+	CASSERT(id >= 0, "cannot parse ammo name");
+	return id >= 0 ? id : 0;
+}
+int AmmoFindId(const char *s)
+{
 	CA_FOREACH(Ammo, a, gAmmo.CustomAmmo)
 		if (strcmp(s, a->Name) == 0)
 		{
@@ -61,8 +67,7 @@ int StrAmmoId(const char *s)
 			return _ca_index;
 		}
 	CA_FOREACH_END()
-	CASSERT(false, "cannot parse ammo name");
-	return 0;
+	return -1;
 }
 
 #define VERSION 2
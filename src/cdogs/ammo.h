@@ -51,6 +51,8 @@ extern AmmoClasses gAmmo;
 
 Ammo *StrAmmo(const char *s);
 int StrAmmoId(const char *s);
+// Find an ammo id by name, or -1 if there is none
+int AmmoFindId(const char *s);
 
 void AmmoInitialize(AmmoClasses *ammo, const char *path);
 void AmmoLoadJSON(CArray *ammo, json_t *node);
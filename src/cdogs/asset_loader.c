@@ -0,0 +1,254 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "asset_loader.h"
+
+#include <SDL_cpuinfo.h>
+#include <SDL_timer.h>
+
+#include "log.h"
+#include "utils.h"
+
+// Decoding is mostly bound by inflating PNG/OGG data; more threads than
+// this just contend for the disk
+#define MAX_WORKERS 8
+
+static int AssetWorker(void *data);
+void AssetLoaderInit(AssetLoader *l, int numThreads)
+{
+	memset(l, 0, sizeof *l);
+	CArrayInit(&l->jobs, sizeof(AssetJob *));
+	CArrayInit(&l->threads, sizeof(SDL_Thread *));
+#ifdef __EMSCRIPTEN__
+	numThreads = 0;
+#else
+	if (numThreads < 0)
+	{
+		numThreads = MIN(SDL_GetCPUCount() - 1, MAX_WORKERS);
+	}
+#endif
+	l->lock = SDL_CreateMutex();
+	l->cond = SDL_CreateCond();
+	l->doneCond = SDL_CreateCond();
+	if (l->lock == NULL || l->cond == NULL || l->doneCond == NULL)
+	{
+		numThreads = 0;
+	}
+	for (int i = 0; i < numThreads; i++)
+	{
+		char name[32];
+		sprintf(name, "AssetLoader%d", i);
+		SDL_Thread *t = SDL_CreateThread(AssetWorker, name, l);
+		if (t == NULL)
+		{
+			// Fall back to decoding on the main thread
+			LOG(LM_MAIN, LL_WARN, "cannot create asset loader thread: %s",
+				SDL_GetError());
+			break;
+		}
+		CArrayPushBack(&l->threads, &t);
+	}
+}
+void AssetLoaderTerminate(AssetLoader *l)
+{
+	if (l->jobs.size > 0)
+	{
+		AssetLoaderFinish(l);
+	}
+	SDL_LockMutex(l->lock);
+	l->quit = true;
+	SDL_CondBroadcast(l->cond);
+	SDL_UnlockMutex(l->lock);
+	CA_FOREACH(SDL_Thread *, t, l->threads)
+	SDL_WaitThread(*t, NULL);
+	CA_FOREACH_END()
+	CArrayTerminate(&l->threads);
+	CArrayTerminate(&l->jobs);
+	SDL_DestroyCond(l->doneCond);
+	SDL_DestroyCond(l->cond);
+	SDL_DestroyMutex(l->lock);
+	memset(l, 0, sizeof *l);
+}
+
+void AssetLoaderQueue(
+	AssetLoader *l, const AssetKind *kind, const char *path, const char *name,
+	void *context, map_t map, map_t map2)
+{
+	AssetJob *job;
+	CCALLOC(job, sizeof *job);
+	job->Kind = kind;
+	CSTRDUP(job->Path, path);
+	CSTRDUP(job->Name, name);
+	job->Context = context;
+	job->Maps[0] = map;
+	job->Maps[1] = map2;
+	SDL_LockMutex(l->lock);
+	if (l->jobs.size == 0)
+	{
+		l->start = SDL_GetPerformanceCounter();
+	}
+	CArrayPushBack(&l->jobs, &job);
+	SDL_CondSignal(l->cond);
+	SDL_UnlockMutex(l->lock);
+}
+
+static void AssetJobDecode(AssetJob *job)
+{
+	const Uint64 start = SDL_GetPerformanceCounter();
+	job->Data = job->Kind->Decode(job);
+	job->DecodeTicks = SDL_GetPerformanceCounter() - start;
+}
+static int AssetWorker(void *data)
+{
+	AssetLoader *l = data;
+	SDL_LockMutex(l->lock);
+	for (;;)
+	{
+		while (!l->quit && l->next == (int)l->jobs.size)
+		{
+			SDL_CondWait(l->cond, l->lock);
+		}
+		if (l->quit)
+		{
+			break;
+		}
+		AssetJob *job = *(AssetJob **)CArrayGet(&l->jobs, l->next);
+		l->next++;
+		SDL_UnlockMutex(l->lock);
+
+		AssetJobDecode(job);
+
+		SDL_LockMutex(l->lock);
+		job->Decoded = true;
+		SDL_CondBroadcast(l->doneCond);
+	}
+	SDL_UnlockMutex(l->lock);
+	return 0;
+}
+
+typedef struct
+{
+	const AssetKind *Kind;
+	void *Context;
+	int Count;
+	Uint64 DecodeTicks;
+	Uint64 AddTicks;
+} AssetStats;
+static AssetStats *GetStats(
+	CArray *stats, const AssetKind *kind, void *context);
+static void WaitDecoded(AssetLoader *l, AssetJob *job);
+static double TicksToMs(const Uint64 ticks);
+void AssetLoaderFinish(AssetLoader *l)
+{
+	CArray stats;
+	CArrayInit(&stats, sizeof(AssetStats));
+	// Only this thread queues jobs, so the array is stable until we clear it
+	CA_FOREACH(AssetJob *, jobp, l->jobs)
+	AssetJob *job = *jobp;
+	WaitDecoded(l, job);
+	AssetStats *s = GetStats(&stats, job->Kind, job->Context);
+	s->Count++;
+	s->DecodeTicks += job->DecodeTicks;
+	if (job->Data != NULL)
+	{
+		const Uint64 start = SDL_GetPerformanceCounter();
+		job->Kind->Add(job, job->Data);
+		s->AddTicks += SDL_GetPerformanceCounter() - start;
+	}
+	CFREE(job->Path);
+	CFREE(job->Name);
+	CFREE(job);
+	CA_FOREACH_END()
+
+	CA_FOREACH(AssetStats, s, stats)
+	if (s->Kind->Finish)
+	{
+		const Uint64 start = SDL_GetPerformanceCounter();
+		s->Kind->Finish(s->Context);
+		s->AddTicks += SDL_GetPerformanceCounter() - start;
+	}
+	LOG(LM_MAIN, LL_INFO, "loaded %d %s: decode %.1fms, add %.1fms",
+		s->Count, s->Kind->Name, TicksToMs(s->DecodeTicks),
+		TicksToMs(s->AddTicks));
+	CA_FOREACH_END()
+	if (l->jobs.size > 0)
+	{
+		LOG(LM_MAIN, LL_INFO, "loaded %d assets in %.1fms using %d threads",
+			(int)l->jobs.size,
+			TicksToMs(SDL_GetPerformanceCounter() - l->start),
+			(int)l->threads.size);
+	}
+	CArrayTerminate(&stats);
+
+	SDL_LockMutex(l->lock);
+	CArrayClear(&l->jobs);
+	l->next = 0;
+	SDL_UnlockMutex(l->lock);
+}
+static AssetStats *GetStats(
+	CArray *stats, const AssetKind *kind, void *context)
+{
+	CA_FOREACH(AssetStats, s, *stats)
+	if (s->Kind == kind && s->Context == context)
+	{
+		return s;
+	}
+	CA_FOREACH_END()
+	AssetStats s;
+	memset(&s, 0, sizeof s);
+	s.Kind = kind;
+	s.Context = context;
+	CArrayPushBack(stats, &s);
+	return CArrayGet(stats, stats->size - 1);
+}
+static void WaitDecoded(AssetLoader *l, AssetJob *job)
+{
+	SDL_LockMutex(l->lock);
+	while (!job->Decoded)
+	{
+		if (l->next < (int)l->jobs.size)
+		{
+			// Help decode rather than sit idle
+			AssetJob *next = *(AssetJob **)CArrayGet(&l->jobs, l->next);
+			l->next++;
+			SDL_UnlockMutex(l->lock);
+			AssetJobDecode(next);
+			SDL_LockMutex(l->lock);
+			next->Decoded = true;
+			SDL_CondBroadcast(l->doneCond);
+		}
+		else
+		{
+			SDL_CondWait(l->doneCond, l->lock);
+		}
+	}
+	SDL_UnlockMutex(l->lock);
+}
+static double TicksToMs(const Uint64 ticks)
+{
+	return (double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
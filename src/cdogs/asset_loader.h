@@ -0,0 +1,85 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
+#include "c_array.h"
+#include "c_hashmap/hashmap.h"
+
+// Loads asset files in two stages: decoding into CPU-side buffers on a pool
+// of worker threads, then adding to the managers on the main thread.
+// Jobs are added in the order they were queued, so the results are the same
+// as loading each file in turn.
+typedef struct AssetJob AssetJob;
+typedef struct
+{
+	const char *Name; // for logging, e.g. "graphics"
+	// Called on a worker thread; returns decoded data or NULL to skip
+	void *(*Decode)(const AssetJob *job);
+	// Called on the main thread, taking ownership of data
+	void (*Add)(const AssetJob *job, void *data);
+	// Optional; called on the main thread once all the jobs with this kind
+	// and context have been added
+	void (*Finish)(void *context);
+} AssetKind;
+struct AssetJob
+{
+	const AssetKind *Kind;
+	char *Path;
+	char *Name;
+	void *Context;
+	map_t Maps[2];
+	void *Data;
+	Uint64 DecodeTicks;
+	bool Decoded;
+};
+
+typedef struct
+{
+	CArray jobs; // of AssetJob *
+	int next;	 // index of the next job to decode
+	CArray threads; // of SDL_Thread *
+	SDL_mutex *lock;
+	SDL_cond *cond;		// jobs queued, or quit
+	SDL_cond *doneCond; // a job was decoded
+	bool quit;
+	Uint64 start;
+} AssetLoader;
+
+// Use numThreads < 0 for one per CPU, less the main thread
+// With no threads, jobs are decoded on the main thread in AssetLoaderFinish
+void AssetLoaderInit(AssetLoader *l, int numThreads);
+void AssetLoaderTerminate(AssetLoader *l);
+void AssetLoaderQueue(
+	AssetLoader *l, const AssetKind *kind, const char *path, const char *name,
+	void *context, map_t map, map_t map2);
+// Block until all queued jobs are decoded and added; logs timings for each
+// kind of asset. The loader can be reused afterwards.
+void AssetLoaderFinish(AssetLoader *l);
@@ -37,6 +37,7 @@
 
 #include "config.h"
 #include "log.h"
+#include "pixel_ops.h"
 
 color_t *CharColorGetByType(CharColors *c, const CharColorType t)
 {
@@ -175,9 +176,9 @@ void BlitClearBuf(GraphicsDevice *g)
 void BlitFillBuf(GraphicsDevice *g, const color_t c)
 {
 	const Uint32 pixel = COLOR2PIXEL(c);
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), g->cachedConfig.Res))
-	g->buf[_i] = pixel;
-	RECT_FOREACH_END()
+	PixelsFill(
+		g->buf, (size_t)(g->cachedConfig.Res.x * g->cachedConfig.Res.y),
+		pixel);
 }
 void BlitUpdateFromBuf(GraphicsDevice *g, SDL_Texture *t)
 {
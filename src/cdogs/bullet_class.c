@@ -77,12 +77,8 @@ int BulletClassesCount(const BulletClasses *classes)
 }
 
 // TODO: use map structure?
-BulletClass *StrBulletClass(const char *s)
+BulletClass *BulletClassFind(const char *s)
 {
-	if (s == NULL || strlen(s) == 0)
-	{
-		return NULL;
-	}
 	CA_FOREACH(BulletClass, b, gBulletClasses.CustomClasses)
 	if (strcmp(s, b->Name) == 0)
 	{
@@ -95,9 +91,25 @@ BulletClass *StrBulletClass(const char *s)
 		return b;
 	}
 	CA_FOREACH_END()
-	CASSERT(false, "cannot parse bullet name");
 	return NULL;
 }
+bool BulletClassNameIsValid(const json_t *node)
+{
+	char *name = json_unescape(node->text);
+	const bool valid = strlen(name) == 0 || BulletClassFind(name) != NULL;
+	CFREE(name);
+	return valid;
+}
+BulletClass *StrBulletClass(const char *s)
+{
+	if (s == NULL || strlen(s) == 0)
+	{
+		return NULL;
+	}
+	BulletClass *b = BulletClassFind(s);
+	CASSERT(b != NULL, "cannot parse bullet name");
+	return b;
+}
 BulletClass *IdBulletClass(const int i)
 {
 	CASSERT(
@@ -395,7 +407,9 @@ bool BulletUpdate(struct MobileObject *obj, const int ticks)
 			obj->thing.Vel = svec2_add(
 				obj->thing.Vel,
 				svec2_scale(
-					svec2((float)(rand() % 3) - 1, (float)(rand() % 3) - 1),
+					svec2(
+						(float)RAND_INT(RNG_GAMEPLAY, -1, 2),
+						(float)RAND_INT(RNG_GAMEPLAY, -1, 2)),
 					0.5f));
 		}
 	}
@@ -666,6 +680,7 @@ void BulletLoadJSON(
 	BulletClasses *bullets, CArray *classes, json_t *bulletNode)
 {
 	LOG(LM_MAP, LL_DEBUG, "loading bullets");
+	JSONTrackVisits(bulletNode, LM_MAP);
 	int version;
 	LoadInt(&version, bulletNode, "Version");
 	if (version > VERSION || version <= 0)
@@ -976,6 +991,7 @@ void BulletLoadWeapons(BulletClasses *bullets)
 {
 	BulletClassesLoadWeapons(&bullets->Classes);
 	BulletClassesLoadWeapons(&bullets->CustomClasses);
+	JSONLogUnvisited(bullets->root, LM_MAP, "bullets");
 	json_free_value(&bullets->root);
 }
 static void BulletClassesLoadWeapons(CArray *classes)
@@ -1001,6 +1017,116 @@ static void BulletClassesLoadWeapons(CArray *classes)
 		b->node = NULL;
 	}
 }
+static bool SpecialDamageNameIsValid(const json_t *node)
+{
+	const char *names[] = {"Flame", "Poison", "Petrify", "Confuse"};
+	for (int i = 0; i < (int)(sizeof names / sizeof names[0]); i++)
+	{
+		if (strcmp(node->text, names[i]) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+static const JSONField bulletFields[] = {
+	{"Name", JSON_FIELD_STRING, NULL, 0},
+	{"Pic", JSON_FIELD_OBJECT, CPicIsValidJSON, 0},
+	{"Trail", JSON_FIELD_OBJECT, NULL, 0},
+	{"Trail/Particle", JSON_FIELD_STRING, ParticleClassNameIsValid, 0},
+	{"Trail/Width", JSON_FIELD_NUMBER, NULL, 0},
+	{"Trail/TicksPerEmit", JSON_FIELD_NUMBER, NULL, 0},
+	{"ShadowSize", JSON_FIELD_VEC2, NULL, 0},
+	{"Delay", JSON_FIELD_NUMBER, NULL, 0},
+	{"Speed", JSON_FIELD_NUMBER, NULL, 0},
+	{"SpeedLow", JSON_FIELD_NUMBER, NULL, 0},
+	{"SpeedHigh", JSON_FIELD_NUMBER, NULL, 0},
+	{"SpeedScale", JSON_FIELD_BOOL, NULL, 0},
+	{"Friction", JSON_FIELD_NUMBER, NULL, 0},
+	{"Range", JSON_FIELD_NUMBER, NULL, 0},
+	{"RangeLow", JSON_FIELD_NUMBER, NULL, 0},
+	{"RangeHigh", JSON_FIELD_NUMBER, NULL, 0},
+	{"Power", JSON_FIELD_NUMBER, NULL, 0},
+	{"Mass", JSON_FIELD_NUMBER, NULL, 2},
+	{"Size", JSON_FIELD_VEC2, NULL, 0},
+	{"Special", JSON_FIELD_OBJECT, NULL, 4},
+	{"Special/Effect", JSON_FIELD_STRING, SpecialDamageNameIsValid, 4},
+	{"Special/Ticks", JSON_FIELD_NUMBER, NULL, 4},
+	{"HurtAlways", JSON_FIELD_BOOL, NULL, 0},
+	{"Persists", JSON_FIELD_BOOL, NULL, 0},
+	{"Spark", JSON_FIELD_STRING, ParticleClassNameIsValid, 0},
+	{"OutOfRangeSpark", JSON_FIELD_STRING, ParticleClassNameIsValid, 0},
+	{"WallMark", JSON_FIELD_STRING, ParticleClassNameIsValid, 0},
+	{"Hit", JSON_FIELD_OBJECT, NULL, 5},
+	{"Hit/Object", JSON_FIELD_OBJECT, NULL, 5},
+	{"Hit/Object/Sound", JSON_FIELD_STRING, NULL, 5},
+	{"Hit/Flesh", JSON_FIELD_OBJECT, NULL, 5},
+	{"Hit/Flesh/Sound", JSON_FIELD_STRING, NULL, 5},
+	{"Hit/Wall", JSON_FIELD_OBJECT, NULL, 5},
+	{"Hit/Wall/Sound", JSON_FIELD_STRING, NULL, 5},
+	{"WallBounces", JSON_FIELD_BOOL, NULL, 0},
+	{"Falling", JSON_FIELD_OBJECT, NULL, 0},
+	{"Falling/GravityFactor", JSON_FIELD_NUMBER, NULL, 0},
+	{"Falling/FallsDown", JSON_FIELD_BOOL, NULL, 0},
+	{"Falling/DestroyOnDrop", JSON_FIELD_BOOL, NULL, 0},
+	{"Falling/Bounces", JSON_FIELD_BOOL, NULL, 0},
+	{"Falling/DropGuns", JSON_FIELD_STRINGS, WeaponClassNameIsValid, 0},
+	{"SeekFactor", JSON_FIELD_NUMBER, NULL, 0},
+	{"Erratic", JSON_FIELD_BOOL, NULL, 0},
+	{"OutOfRangeGuns", JSON_FIELD_STRINGS, WeaponClassNameIsValid, 0},
+	{"HitGuns", JSON_FIELD_STRINGS, WeaponClassNameIsValid, 0},
+	{"ProximityGuns", JSON_FIELD_STRINGS, WeaponClassNameIsValid, 0},
+	{NULL, JSON_FIELD_BOOL, NULL, 0}};
+bool BulletReloadJSON(BulletClasses *bullets, json_t *root)
+{
+	if (!JSONCheckClassList(root, VERSION, "Bullets", "bullets", bulletFields))
+	{
+		return false;
+	}
+	int version = 0;
+	LoadInt(&version, root, "Version");
+	json_t *defaultNode = json_find_first_label(root, "DefaultBullet");
+	if (defaultNode != NULL &&
+		(defaultNode->child == NULL || defaultNode->child->type != JSON_OBJECT))
+	{
+		LOG(LM_MAIN, LL_ERROR, "bullets: DefaultBullet is not an object");
+		return false;
+	}
+	if (defaultNode != NULL &&
+		!JSONCheckFields(
+			defaultNode->child, bulletFields, version, "DefaultBullet",
+			"bullets"))
+	{
+		return false;
+	}
+	BulletClasses loaded;
+	BulletInitialize(&loaded);
+	BulletLoadJSON(&loaded, &loaded.Classes, root);
+	int patched = 0;
+	CA_FOREACH(BulletClass, b, loaded.Classes)
+	for (int i = 0; i < (int)bullets->Classes.size; i++)
+	{
+		BulletClass *existing = CArrayGet(&bullets->Classes, i);
+		if (strcmp(existing->Name, b->Name) == 0)
+		{
+			BulletClassFree(existing);
+			memcpy(existing, b, sizeof *b);
+			memset(b, 0, sizeof *b);
+			patched++;
+			break;
+		}
+	}
+	CA_FOREACH_END()
+	// Only the patched classes still have nodes to load guns from
+	BulletClassesLoadWeapons(&bullets->Classes);
+	BulletClassFree(&bullets->Default);
+	memcpy(&bullets->Default, &loaded.Default, sizeof loaded.Default);
+	memset(&loaded.Default, 0, sizeof loaded.Default);
+	LOG(LM_MAIN, LL_INFO, "reloaded %d bullets, %d new ignored", patched,
+		(int)loaded.Classes.size - patched);
+	BulletTerminate(&loaded);
+	return true;
+}
 void BulletTerminate(BulletClasses *bullets)
 {
 	BulletClassFree(&bullets->Default);
@@ -1066,15 +1192,18 @@ void BulletAdd(const NAddBullet add)
 
 	obj->thing.Vel = svec2_scale(
 		Vec2FromRadians(add.Angle),
-		RAND_FLOAT(obj->bulletClass->SpeedLow, obj->bulletClass->SpeedHigh));
+		RAND_FLOAT(
+			RNG_GAMEPLAY, obj->bulletClass->SpeedLow,
+			obj->bulletClass->SpeedHigh));
 	if (obj->bulletClass->SpeedScale)
 	{
 		obj->thing.Vel.y *= (float)TILE_WIDTH / TILE_HEIGHT;
 	}
 
 	obj->ActorUID = add.ActorUID;
-	obj->range =
-		RAND_INT(obj->bulletClass->RangeLow, obj->bulletClass->RangeHigh);
+	obj->range = RAND_INT(
+		RNG_GAMEPLAY, obj->bulletClass->RangeLow,
+		obj->bulletClass->RangeHigh);
 
 	obj->flags = add.Flags;
 	if (obj->bulletClass->HurtAlways)
@@ -1115,7 +1244,8 @@ void BulletBounce(const NBulletBounce bb)
 		s.u.AddParticle.Class = o->bulletClass->WallMark;
 		s.u.AddParticle.Pos = bouncePos;
 		// Randomise Z on the wall
-		s.u.AddParticle.Z = o->z + (int)RAND_FLOAT(-WALL_MARK_Z, WALL_MARK_Z);
+		s.u.AddParticle.Z =
+			o->z + (int)RAND_FLOAT(RNG_COSMETIC, -WALL_MARK_Z, WALL_MARK_Z);
 		GameEventsEnqueue(&gGameEvents, s);
 	}
 	MapTryMoveThing(&gMap, &o->thing, NetToVec2(bb.Pos));
@@ -133,6 +133,10 @@ extern BulletClasses gBulletClasses;
 
 int BulletClassesCount(const BulletClasses *classes);
 
+// Find a class by name, or NULL if there is none
+BulletClass *BulletClassFind(const char *s);
+// Whether a JSON string is empty or names a loaded bullet class
+bool BulletClassNameIsValid(const json_t *node);
 BulletClass *StrBulletClass(const char *s);
 
 void BulletInitialize(BulletClasses *bullets);
@@ -140,6 +144,9 @@ void BulletLoadJSON(
 	BulletClasses *bullets, CArray *classes, json_t *bulletNode);
 // 2-step initialisation since bullet and weapon reference each other
 void BulletLoadWeapons(BulletClasses *bullets);
+// Update classes from the bullets file root in place, keeping pointers to
+// them valid; the weapons must already be loaded
+bool BulletReloadJSON(BulletClasses *bullets, json_t *root);
 void BulletClassesClear(CArray *classes);
 void BulletTerminate(BulletClasses *bullets);
 
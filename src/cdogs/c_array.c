@@ -197,12 +197,12 @@ void CArrayConcat(CArray *a, const CArray *a2)
 	a->size += a2->size;
 }
 
-void CArrayShuffle(CArray *a)
+void CArrayShuffle(CArray *a, const RngStream s)
 {
 	void *buf;
 	CMALLOC(buf, a->elemSize);
 	CA_FOREACH(void, e, *a)
-	const int j = rand() % (_ca_index + 1);
+	const int j = RAND_INT(s, 0, (int)_ca_index + 1);
 	void *je = CArrayGet(a, j);
 	// Swap index and j elements
 	memcpy(buf, e, a->elemSize);
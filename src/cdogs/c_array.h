@@ -28,6 +28,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "rng.h"
+
 // dynamic array
 typedef struct
 {
@@ -55,7 +57,8 @@ void CArrayRemoveIf(CArray *a, bool (*removeIf)(const void *));
 void CArrayFill(CArray *a, const void *elem);
 void CArrayFillZero(CArray *a);
 void CArrayConcat(CArray *a, const CArray *a2);
-void CArrayShuffle(CArray *a);
+// Shuffle using one of the RngStream streams
+void CArrayShuffle(CArray *a, const RngStream s);
 // Remove consecutive duplicates
 void CArrayUnique(CArray *a, bool (*isEqual)(const void *, const void *));
 void CArrayTerminate(CArray *a);
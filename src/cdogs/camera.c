@@ -45,6 +45,10 @@ void CameraInit(Camera *camera)
 	camera->lastPosition = svec2_zero();
 	HUDInit(&camera->HUD, &gGraphicsDevice, &gMission);
 	camera->shake = ScreenShakeZero();
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		LOSBitsInit(&camera->viewLOS[i]);
+	}
 }
 
 void CameraReset(Camera *camera)
@@ -58,6 +62,10 @@ void CameraTerminate(Camera *camera)
 {
 	DrawBufferTerminate(&camera->Buffer);
 	HUDTerminate(&camera->HUD);
+	for (int i = 0; i < MAX_LOCAL_PLAYERS; i++)
+	{
+		LOSBitsTerminate(&camera->viewLOS[i]);
+	}
 }
 
 void CameraInput(Camera *camera, const int cmd, const int lastCmd)
@@ -275,9 +283,22 @@ static struct vec2 GetFollowPlayerPos(
 	return a->Pos;
 }
 
+typedef struct
+{
+	struct vec2 Center;
+	int Width;
+	struct vec2i Offset;
+	Rect2i Clip;
+} CameraView;
 static void DoBuffer(
 	DrawBuffer *b, const struct vec2 center, const int w, const struct vec2 noise,
 	const struct vec2i offset);
+static int GetSplitViews(
+	Camera *camera, CameraView *views, const HUDDrawData drawData,
+	const struct vec2i centerOffset);
+static void DrawViews(
+	Camera *camera, const CameraView *views, const int numViews,
+	const struct vec2 noise);
 void CameraDraw(Camera *camera, const HUDDrawData drawData)
 {
 	const struct vec2i centerOffset = svec2i(-4, -8);
@@ -294,118 +315,49 @@ void CameraDraw(Camera *camera, const HUDDrawData drawData)
 			camera->lastPosition,
 			X_TILES, noise, centerOffset);
 	}
-	else
+	else if (camera->NumViews == 1)
 	{
-		// Redo LOS if PVP, so that each split screen has its own LOS
-		if (IsPVP(gCampaign.Entry.Mode) && drawData.NumScreens > 0)
-		{
-			LOSReset(&gMap.LOS);
-		}
-		if (camera->NumViews == 1)
-		{
-			// Single camera screen
-
-			// Redo LOS for every local human player
-			if (IsPVP(gCampaign.Entry.Mode))
-			{
-				CA_FOREACH(const PlayerData, p, gPlayerDatas)
-					if (!p->IsLocal || !IsPlayerAliveOrDying(p) ||
-						!IsPlayerHuman(p))
-					{
-						continue;
-					}
-					const TActor *a = ActorGetByUID(p->ActorUID);
-					LOSCalcFrom(&gMap, Vec2ToTile(a->thing.Pos), false);
-				CA_FOREACH_END()
-			}
+		// Single camera screen
 
-			DoBuffer(
-				&camera->Buffer,
-				camera->lastPosition,
-				X_TILES, noise, centerOffset);
-		}
-		else if (drawData.NumScreens == 2)
+		// Redo LOS for every local human player
+		if (IsPVP(gCampaign.Entry.Mode))
 		{
-			// side-by-side split
-			for (int i = 0; i < drawData.NumScreens; i++)
-			{
-				const PlayerData *p = drawData.Players[i];
-				if (!IsPlayerAliveOrDying(p))
+			LOSReset(&gMap.LOS);
+			CA_FOREACH(const PlayerData, p, gPlayerDatas)
+				if (!p->IsLocal || !IsPlayerAliveOrDying(p) ||
+					!IsPlayerHuman(p))
 				{
 					continue;
 				}
 				const TActor *a = ActorGetByUID(p->ActorUID);
-				if (a == NULL)
-				{
-					continue;
-				}
-				camera->lastPosition = a->thing.Pos;
-				struct vec2i centerOffsetPlayer = centerOffset;
-				const Rect2i clip = Rect2iNew(
-					svec2i((i & 1) ? w / 2 : 0, 0), svec2i(w / 2, h));
-				GraphicsSetClip(gGraphicsDevice.gameWindow.renderer, clip);
-				if (i == 1)
-				{
-					centerOffsetPlayer.x += w / 2 - centerOffset.x;
-				}
-
-				LOSCalcFrom(&gMap, Vec2ToTile(camera->lastPosition), false);
-				DoBuffer(
-					&camera->Buffer,
-					camera->lastPosition,
-					X_TILES_HALF, noise, centerOffsetPlayer);
-			}
-			Draw_Line(w / 2 - 1, 0, w / 2 - 1, h - 1, colorBlack);
-			Draw_Line(w / 2, 0, w / 2, h - 1, colorBlack);
+				LOSCalcFrom(&gMap, Vec2ToTile(a->thing.Pos), false);
+			CA_FOREACH_END()
 		}
-		else if (drawData.NumScreens >= 3 && drawData.NumScreens <= 4)
+
+		DoBuffer(
+			&camera->Buffer,
+			camera->lastPosition,
+			X_TILES, noise, centerOffset);
+	}
+	else if (drawData.NumScreens >= 2 && drawData.NumScreens <= 4)
+	{
+		CameraView views[MAX_LOCAL_PLAYERS];
+		const int numViews =
+			GetSplitViews(camera, views, drawData, centerOffset);
+		DrawViews(camera, views, numViews, noise);
+		// side-by-side split
+		Draw_Line(w / 2 - 1, 0, w / 2 - 1, h - 1, colorBlack);
+		Draw_Line(w / 2, 0, w / 2, h - 1, colorBlack);
+		if (drawData.NumScreens > 2)
 		{
 			// 4 player split screen
-			for (int i = 0; i < drawData.NumScreens; i++)
-			{
-				const PlayerData *p = drawData.Players[i];
-				if (!IsPlayerAliveOrDying(p))
-				{
-					continue;
-				}
-				const TActor *a = ActorGetByUID(p->ActorUID);
-				if (a == NULL)
-				{
-					continue;
-				}
-				camera->lastPosition = a->thing.Pos;
-				struct vec2i centerOffsetPlayer = centerOffset;
-				const Rect2i clip = Rect2iNew(
-					svec2i((i & 1) ? w / 2 : 0, (i < 2) ? 0 : h / 2 - 1),
-					svec2i(w / 2, h / 2));
-				GraphicsSetClip(gGraphicsDevice.gameWindow.renderer, clip);
-				if (i & 1)
-				{
-					centerOffsetPlayer.x += w / 2 - centerOffset.x;
-				}
-				if (i < 2)
-				{
-					centerOffsetPlayer.y -= h / 4 + centerOffset.y;
-				}
-				else
-				{
-					centerOffsetPlayer.y += h / 4 - centerOffset.y;
-				}
-				LOSCalcFrom(&gMap, Vec2ToTile(camera->lastPosition), false);
-				DoBuffer(
-					&camera->Buffer,
-					camera->lastPosition,
-					X_TILES_HALF, noise, centerOffsetPlayer);
-			}
-			Draw_Line(w / 2 - 1, 0, w / 2 - 1, h - 1, colorBlack);
-			Draw_Line(w / 2, 0, w / 2, h - 1, colorBlack);
 			Draw_Line(0, h / 2 - 1, w - 1, h / 2 - 1, colorBlack);
 			Draw_Line(0, h / 2, w - 1, h / 2, colorBlack);
 		}
-		else
-		{
-			assert(0 && "not implemented yet");
-		}
+	}
+	else
+	{
+		assert(0 && "not implemented yet");
 	}
 	GraphicsResetClip(gGraphicsDevice.gameWindow.renderer);
 }
@@ -416,13 +368,128 @@ static void DoBuffer(
 	DrawBufferSetFromMap(b, &gMap, svec2_add(center, noise), w);
 	if (gPlayerDatas.size > 0)
 	{
-		DrawBufferFix(b);
+		DrawBufferFix(b, &gMap.LOS.LOS);
 	}
 	DrawBufferArgs args;
 	memset(&args, 0, sizeof args);
 	args.HUD = ConfigGetBool(&gConfig, "Graphics.ShowHUD");
 	DrawBufferDraw(b, offset, &args);
 }
+// Get the views for each living local player, for 2 or 4 player split screen
+static int GetSplitViews(
+	Camera *camera, CameraView *views, const HUDDrawData drawData,
+	const struct vec2i centerOffset)
+{
+	const int w = gGraphicsDevice.cachedConfig.Res.x;
+	const int h = gGraphicsDevice.cachedConfig.Res.y;
+	const bool isQuad = drawData.NumScreens > 2;
+	int numViews = 0;
+	for (int i = 0; i < drawData.NumScreens; i++)
+	{
+		const PlayerData *p = drawData.Players[i];
+		if (!IsPlayerAliveOrDying(p))
+		{
+			continue;
+		}
+		const TActor *a = ActorGetByUID(p->ActorUID);
+		if (a == NULL)
+		{
+			continue;
+		}
+		camera->lastPosition = a->thing.Pos;
+		CameraView *v = &views[numViews];
+		numViews++;
+		v->Center = camera->lastPosition;
+		v->Width = X_TILES_HALF;
+		v->Offset = centerOffset;
+		if (i & 1)
+		{
+			v->Offset.x += w / 2 - centerOffset.x;
+		}
+		if (!isQuad)
+		{
+			v->Clip = Rect2iNew(
+				svec2i((i & 1) ? w / 2 : 0, 0), svec2i(w / 2, h));
+			continue;
+		}
+		v->Clip = Rect2iNew(
+			svec2i((i & 1) ? w / 2 : 0, (i < 2) ? 0 : h / 2 - 1),
+			svec2i(w / 2, h / 2));
+		if (i < 2)
+		{
+			v->Offset.y -= h / 4 + centerOffset.y;
+		}
+		else
+		{
+			v->Offset.y += h / 4 - centerOffset.y;
+		}
+	}
+	return numViews;
+}
+static void CalcViewLOS(
+	Camera *camera, const CameraView *views, const int numViews);
+// Draw multiple views, gathering and sorting their things only once
+static void DrawViews(
+	Camera *camera, const CameraView *views, const int numViews,
+	const struct vec2 noise)
+{
+	if (numViews == 0)
+	{
+		return;
+	}
+	// Each PVP view has its own LOS; co-op views share the LOS that was
+	// calculated for all players during the game update
+	const bool isPVP = IsPVP(gCampaign.Entry.Mode);
+	if (isPVP)
+	{
+		CalcViewLOS(camera, views, numViews);
+	}
+
+	DrawBuffer *b = &camera->Buffer;
+	Rect2i rects[MAX_LOCAL_PLAYERS];
+	for (int i = 0; i < numViews; i++)
+	{
+		DrawBufferSetFromMap(
+			b, &gMap, svec2_add(views[i].Center, noise), views[i].Width);
+		rects[i] = DrawBufferGetTileRect(b);
+	}
+	DrawListGather(&b->list, &gMap, rects, numViews);
+
+	DrawBufferArgs args;
+	memset(&args, 0, sizeof args);
+	args.HUD = ConfigGetBool(&gConfig, "Graphics.ShowHUD");
+	args.List = &b->list;
+	for (int i = 0; i < numViews; i++)
+	{
+		GraphicsSetClip(gGraphicsDevice.gameWindow.renderer, views[i].Clip);
+		DrawBufferSetFromMap(
+			b, &gMap, svec2_add(views[i].Center, noise), views[i].Width);
+		if (gPlayerDatas.size > 0)
+		{
+			if (isPVP)
+			{
+				DrawBufferFixBits(b, &camera->viewLOS[i]);
+			}
+			else
+			{
+				DrawBufferFix(b, &gMap.LOS.LOS);
+			}
+		}
+		DrawBufferDraw(b, views[i].Offset, &args);
+	}
+}
+static void CalcViewLOS(
+	Camera *camera, const CameraView *views, const int numViews)
+{
+	for (int i = 0; i < numViews; i++)
+	{
+		CArrayFillZero(&gMap.LOS.LOS);
+		LOSCalcFrom(&gMap, Vec2ToTile(views[i].Center), false);
+		LOSBitsFromLOS(&camera->viewLOS[i], &gMap.LOS);
+	}
+	// Leave the map LOS as the union of all views
+	LOSBitsUnionToLOS(&gMap.LOS, camera->viewLOS, numViews);
+}
 
 void CameraDrawMode(const Camera *camera)
 {
@@ -28,6 +28,7 @@
 
 #include "draw/draw_buffer.h"
 #include "hud/hud.h"
+#include "player.h"
 #include "screen_shake.h"
 
 #define CAMERA_SPLIT_PADDING 40
@@ -53,6 +54,8 @@ typedef struct
 	// immediately follow the next player to join
 	bool FollowNextPlayer;
 	int NumViews;
+	// Per-view LOS for PVP split screen
+	LOSBits viewLOS[MAX_LOCAL_PLAYERS];
 } Camera;
 
 void CameraInit(Camera *camera);
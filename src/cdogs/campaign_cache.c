@@ -0,0 +1,589 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "campaign_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+#include "files.h"
+#include "json_utils.h"
+#include "log.h"
+#include "mission.h"
+#include "mission_static.h"
+#include "sys_specifics.h"
+#include "utils.h"
+
+#define CACHE_MAGIC 0x43434443 // "CDCC"
+// Bump when the layout of the cache or of what it holds changes
+#define CACHE_VERSION 1
+#define CACHE_ALIGN 16
+#define CACHE_ROUND(x) (((x) + CACHE_ALIGN - 1) & ~(uint64_t)(CACHE_ALIGN - 1))
+
+// The JSON files of an archive, in the order they are cached
+static const char *docNames[] = {
+	"campaign.json", "particles.json", "character_classes.json",
+	"bullets.json",	 "ammo.json",	   "guns.json",
+	"pickups.json",	 "map_objects.json", "missions.json",
+	"characters.json"};
+#define NUM_DOCS (sizeof docNames / sizeof docNames[0])
+#define DOC_CAMPAIGN 0
+#define DOC_MISSIONS 8
+
+typedef struct
+{
+	// The source file, to check that it hasn't changed
+	int64_t MTime;
+	uint64_t SourceSize;
+	uint64_t SourceHash;
+	// The image; offset 0 if the archive doesn't have the file
+	uint64_t Offset;
+	uint64_t Length;
+	uint64_t Checksum;
+} CacheDoc;
+typedef struct
+{
+	// Tiles as int32, then access as uint16; offset 0 if not decoded
+	uint64_t Offset;
+	uint32_t Count;
+	uint32_t AccessCount;
+	uint64_t Checksum;
+} CacheTiles;
+typedef struct
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t Size;
+	uint64_t ArchiveHash;
+	uint64_t TilesOffset; // of NumMissions CacheTiles
+	uint32_t NumMissions;
+	uint32_t Pad;
+	CacheDoc Docs[NUM_DOCS];
+} CacheHeader;
+
+static uint64_t Hash(const void *data, const size_t size)
+{
+	return HashBytes(data, size, 0);
+}
+
+static void GetCachePath(char *buf, const char *archive)
+{
+	// Archives are scanned off the main thread; don't share its buffer
+	char dir[CDOGS_PATH_MAX];
+	GetConfigFilePathBuf(dir, "cache/");
+	sprintf(
+		buf, "%s%016llx.cdogscache", dir,
+		(unsigned long long)Hash(archive, strlen(archive)));
+}
+
+static bool StatSource(
+	const char *archive, const char *name, int64_t *mtime, uint64_t *size)
+{
+	char path[CDOGS_PATH_MAX];
+	sprintf(path, "%s/%s", archive, name);
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return false;
+	}
+	*mtime = (int64_t)st.st_mtime;
+	*size = (uint64_t)st.st_size;
+	return true;
+}
+static char *ReadSource(const char *archive, const char *name, long *len)
+{
+	char path[CDOGS_PATH_MAX];
+	sprintf(path, "%s/%s", archive, name);
+	return ReadFileIntoBuf(path, "rb", len);
+}
+
+static bool TryOpen(CampaignCache *c, const char *path, const char *archive);
+static bool Build(const char *path, const char *archive);
+bool CampaignCacheOpen(CampaignCache *c, const char *archive, const bool build)
+{
+	memset(c, 0, sizeof *c);
+	char path[CDOGS_PATH_MAX];
+	GetCachePath(path, archive);
+	if (TryOpen(c, path, archive))
+	{
+		return true;
+	}
+	if (!build || !Build(path, archive))
+	{
+		return false;
+	}
+	LOG(LM_MAP, LL_DEBUG, "compiled campaign cache %s for %s", path, archive);
+	return TryOpen(c, path, archive);
+}
+
+static bool MapFile(CampaignCache *c, const char *path);
+static bool IsSourceCurrent(
+	const CacheDoc *d, const char *archive, const char *name);
+static bool TryOpen(CampaignCache *c, const char *path, const char *archive)
+{
+	if (!MapFile(c, path))
+	{
+		return false;
+	}
+	const CacheHeader *h = (const CacheHeader *)c->Data;
+	if (c->Size < sizeof *h || h->Magic != CACHE_MAGIC ||
+		h->Version != CACHE_VERSION || h->Size != c->Size ||
+		h->ArchiveHash != Hash(archive, strlen(archive)) ||
+		h->TilesOffset > c->Size ||
+		(c->Size - h->TilesOffset) / sizeof(CacheTiles) < h->NumMissions)
+	{
+		LOG(LM_MAP, LL_DEBUG, "campaign cache %s is invalid", path);
+		goto bail;
+	}
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		if (!IsSourceCurrent(&h->Docs[i], archive, docNames[i]))
+		{
+			LOG(LM_MAP, LL_DEBUG, "campaign cache %s is out of date (%s)",
+				path, docNames[i]);
+			goto bail;
+		}
+	}
+	return true;
+
+bail:
+	CampaignCacheClose(c);
+	return false;
+}
+static bool MapFile(CampaignCache *c, const char *path)
+{
+#ifdef _WIN32
+	long len;
+	c->Data = (uint8_t *)ReadFileIntoBuf(path, "rb", &len);
+	if (c->Data == NULL)
+	{
+		return false;
+	}
+	c->Size = (size_t)len;
+	c->Mapped = false;
+#else
+	const int fd = open(path, O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	// Private and writable, as images are fixed up in place
+	void *data = mmap(
+		NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot map campaign cache %s: %s", path,
+			strerror(errno));
+		return false;
+	}
+	c->Data = data;
+	c->Size = (size_t)st.st_size;
+	c->Mapped = true;
+#endif
+	return true;
+}
+static bool IsSourceCurrent(
+	const CacheDoc *d, const char *archive, const char *name)
+{
+	int64_t mtime;
+	uint64_t size;
+	if (!StatSource(archive, name, &mtime, &size))
+	{
+		return d->Offset == 0;
+	}
+	if (d->Offset == 0 || size != d->SourceSize)
+	{
+		return false;
+	}
+	if (mtime == d->MTime)
+	{
+		return true;
+	}
+	// Touched, e.g. by copying or checking out; see if it really changed
+	long len;
+	char *buf = ReadSource(archive, name, &len);
+	if (buf == NULL)
+	{
+		return false;
+	}
+	const bool same = Hash(buf, (size_t)len) == d->SourceHash;
+	CFREE(buf);
+	return same;
+}
+
+void CampaignCacheClose(CampaignCache *c)
+{
+	if (c->Data == NULL)
+	{
+		return;
+	}
+#ifndef _WIN32
+	if (c->Mapped)
+	{
+		munmap(c->Data, c->Size);
+	}
+	else
+#endif
+	{
+		CFREE(c->Data);
+	}
+	memset(c, 0, sizeof *c);
+}
+
+bool CampaignCacheTryGetJSON(
+	CampaignCache *c, const char *filename, json_t **root)
+{
+	*root = NULL;
+	if (c == NULL || c->Data == NULL)
+	{
+		return false;
+	}
+	int i;
+	for (i = 0; i < (int)NUM_DOCS; i++)
+	{
+		if (strcmp(docNames[i], filename) == 0)
+		{
+			break;
+		}
+	}
+	if (i == (int)NUM_DOCS || (c->Loaded & (1u << i)))
+	{
+		return false;
+	}
+	const CacheDoc *d = &((const CacheHeader *)c->Data)->Docs[i];
+	if (d->Offset == 0)
+	{
+		return true;
+	}
+	if (d->Offset > c->Size || d->Length > c->Size - d->Offset ||
+		d->Offset % CACHE_ALIGN != 0 ||
+		Hash(c->Data + d->Offset, (size_t)d->Length) != d->Checksum)
+	{
+		LOG(LM_MAP, LL_WARN, "corrupt campaign cache document %s", filename);
+		return false;
+	}
+	c->Loaded |= 1u << i;
+	*root = json_image_load(c->Data + d->Offset, (size_t)d->Length);
+	if (*root == NULL)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot load campaign cache document %s",
+			filename);
+		return false;
+	}
+	return true;
+}
+
+bool CampaignCacheLoadTiles(
+	const CampaignCache *c, const int mission, CArray *tiles, CArray *access)
+{
+	if (c == NULL || c->Data == NULL || mission < 0)
+	{
+		return false;
+	}
+	const CacheHeader *h = (const CacheHeader *)c->Data;
+	if ((uint32_t)mission >= h->NumMissions)
+	{
+		return false;
+	}
+	const CacheTiles *t =
+		(const CacheTiles *)(c->Data + h->TilesOffset) + mission;
+	if (t->Offset == 0)
+	{
+		return false;
+	}
+	const uint64_t length =
+		(uint64_t)t->Count * sizeof(int32_t) +
+		(uint64_t)t->AccessCount * sizeof(uint16_t);
+	if (t->Offset > c->Size || length > c->Size - t->Offset ||
+		t->Offset % CACHE_ALIGN != 0 ||
+		Hash(c->Data + t->Offset, (size_t)length) != t->Checksum)
+	{
+		LOG(LM_MAP, LL_WARN, "corrupt campaign cache tiles for mission %d",
+			mission);
+		return false;
+	}
+	const int32_t *src = (const int32_t *)(c->Data + t->Offset);
+	const size_t start = tiles->size;
+	CArrayResize(tiles, start + t->Count, NULL);
+	int *dst = (int *)tiles->data + start;
+	for (uint32_t i = 0; i < t->Count; i++)
+	{
+		dst[i] = (int)src[i];
+	}
+	const size_t accessStart = access->size;
+	CArrayResize(access, accessStart + t->AccessCount, NULL);
+	memcpy(
+		(uint16_t *)access->data + accessStart, src + t->Count,
+		t->AccessCount * sizeof(uint16_t));
+	return true;
+}
+
+// Compiling
+
+typedef struct
+{
+	json_t *Root;
+	int64_t MTime;
+	uint64_t SourceSize;
+	uint64_t SourceHash;
+	uint64_t Length;
+} BuildDoc;
+typedef struct
+{
+	CArray Tiles;  // of int
+	CArray Access; // of uint16_t
+	bool Decoded;
+} BuildTiles;
+
+static bool BuildLoadDoc(BuildDoc *d, const char *archive, const char *name);
+static void BuildDecodeTiles(CArray *missions, BuildDoc *docs);
+static bool WriteCache(const char *path, const uint8_t *data, const size_t size);
+static bool Build(const char *path, const char *archive)
+{
+	bool ok = false;
+	BuildDoc docs[NUM_DOCS];
+	memset(docs, 0, sizeof docs);
+	CArray missions; // of BuildTiles
+	CArrayInit(&missions, sizeof(BuildTiles));
+	uint8_t *data = NULL;
+
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		if (!BuildLoadDoc(&docs[i], archive, docNames[i]))
+		{
+			goto bail;
+		}
+	}
+	BuildDecodeTiles(&missions, docs);
+
+	// Lay out the header, tile table, images and tiles
+	uint64_t size = CACHE_ROUND(sizeof(CacheHeader));
+	const uint64_t tilesOffset = size;
+	size = CACHE_ROUND(size + missions.size * sizeof(CacheTiles));
+	uint64_t docOffsets[NUM_DOCS];
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		docOffsets[i] = 0;
+		if (docs[i].Root != NULL)
+		{
+			docOffsets[i] = size;
+			size = CACHE_ROUND(size + docs[i].Length);
+		}
+	}
+	CArray tileOffsets; // of uint64_t
+	CArrayInit(&tileOffsets, sizeof(uint64_t));
+	CA_FOREACH(const BuildTiles, bt, missions)
+	uint64_t offset = 0;
+	if (bt->Decoded)
+	{
+		offset = size;
+		size = CACHE_ROUND(
+			size + bt->Tiles.size * sizeof(int32_t) +
+			bt->Access.size * sizeof(uint16_t));
+	}
+	CArrayPushBack(&tileOffsets, &offset);
+	CA_FOREACH_END()
+
+	CCALLOC(data, (size_t)size);
+	CacheHeader *h = (CacheHeader *)data;
+	h->Magic = CACHE_MAGIC;
+	h->Version = CACHE_VERSION;
+	h->Size = size;
+	h->ArchiveHash = Hash(archive, strlen(archive));
+	h->TilesOffset = tilesOffset;
+	h->NumMissions = (uint32_t)missions.size;
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		CacheDoc *d = &h->Docs[i];
+		d->MTime = docs[i].MTime;
+		d->SourceSize = docs[i].SourceSize;
+		d->SourceHash = docs[i].SourceHash;
+		if (docs[i].Root == NULL)
+		{
+			continue;
+		}
+		d->Offset = docOffsets[i];
+		d->Length = docs[i].Length;
+		json_image_write(docs[i].Root, data + d->Offset, (size_t)d->Length);
+		d->Checksum = Hash(data + d->Offset, (size_t)d->Length);
+	}
+	CacheTiles *tiles = (CacheTiles *)(data + tilesOffset);
+	CA_FOREACH(const BuildTiles, bt, missions)
+	CacheTiles *t = &tiles[_ca_index];
+	t->Offset = *(const uint64_t *)CArrayGet(&tileOffsets, _ca_index);
+	if (t->Offset == 0)
+	{
+		continue;
+	}
+	t->Count = (uint32_t)bt->Tiles.size;
+	t->AccessCount = (uint32_t)bt->Access.size;
+	int32_t *dst = (int32_t *)(data + t->Offset);
+	for (int i = 0; i < (int)bt->Tiles.size; i++)
+	{
+		dst[i] = (int32_t) * (const int *)CArrayGet(&bt->Tiles, i);
+	}
+	if (bt->Access.size > 0)
+	{
+		memcpy(
+			dst + t->Count, bt->Access.data,
+			bt->Access.size * sizeof(uint16_t));
+	}
+	t->Checksum = Hash(
+		dst, t->Count * sizeof(int32_t) + t->AccessCount * sizeof(uint16_t));
+	CA_FOREACH_END()
+	CArrayTerminate(&tileOffsets);
+
+	ok = WriteCache(path, data, (size_t)size);
+
+bail:
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		json_free_value(&docs[i].Root);
+	}
+	CA_FOREACH(BuildTiles, bt, missions)
+	CArrayTerminate(&bt->Tiles);
+	CArrayTerminate(&bt->Access);
+	CA_FOREACH_END()
+	CArrayTerminate(&missions);
+	CFREE(data);
+	return ok;
+}
+static bool BuildLoadDoc(BuildDoc *d, const char *archive, const char *name)
+{
+	if (!StatSource(archive, name, &d->MTime, &d->SourceSize))
+	{
+		// Not in this archive
+		d->MTime = 0;
+		d->SourceSize = 0;
+		return true;
+	}
+	long len;
+	char *buf = ReadSource(archive, name, &len);
+	if (buf == NULL)
+	{
+		return false;
+	}
+	d->SourceHash = Hash(buf, (size_t)len);
+	// Leave invalid files to the normal loader, which reports them
+	const enum json_error e = json_parse_buffer(&d->Root, buf, (size_t)len);
+	CFREE(buf);
+	if (e != JSON_OK || (uint64_t)len != d->SourceSize)
+	{
+		d->Root = NULL;
+		return false;
+	}
+	d->Length = json_image_write(d->Root, NULL, 0);
+	return d->Length != 0;
+}
+static void BuildDecodeTiles(CArray *missions, BuildDoc *docs)
+{
+	json_t *campaign = docs[DOC_CAMPAIGN].Root;
+	json_t *missionsRoot = docs[DOC_MISSIONS].Root;
+	if (campaign == NULL || missionsRoot == NULL)
+	{
+		return;
+	}
+	int version = 0;
+	LoadInt(&version, campaign, "Version");
+	const json_t *missionsNode =
+		json_find_first_label(missionsRoot, "Missions");
+	if (missionsNode == NULL || missionsNode->child == NULL)
+	{
+		return;
+	}
+	// Same conditions as loading the tiles in MissionStaticTryLoadJSON
+	for (json_t *child = missionsNode->child->child; child;
+		 child = child->next)
+	{
+		BuildTiles bt;
+		memset(&bt, 0, sizeof bt);
+		CArrayInit(&bt.Tiles, sizeof(int));
+		CArrayInit(&bt.Access, sizeof(uint16_t));
+		const json_t *type = json_find_first_label(child, "Type");
+		if (version > 14 && type != NULL && type->child != NULL &&
+			StrMapType(type->child->text) == MAPTYPE_STATIC)
+		{
+			// Invalid tiles are left to the normal loader, which reports them
+			struct vec2i size = svec2i_zero();
+			LoadInt(&size.x, child, "Width");
+			LoadInt(&size.y, child, "Height");
+			bt.Decoded =
+				MissionStaticLoadTiles(&bt.Tiles, &bt.Access, child, size);
+		}
+		CArrayPushBack(missions, &bt);
+	}
+}
+static bool WriteCache(const char *path, const uint8_t *data, const size_t size)
+{
+	char dir[CDOGS_PATH_MAX];
+	GetConfigFilePathBuf(dir, "cache");
+	if (!mkdir_deep(dir))
+	{
+		LOG(LM_MAP, LL_WARN, "cannot create cache dir %s", dir);
+		return false;
+	}
+	// Write to a temporary file first so a partial cache is never opened
+	char tmp[CDOGS_PATH_MAX];
+	sprintf(tmp, "%s.tmp", path);
+	FILE *f = fopen(tmp, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot write campaign cache %s: %s", tmp,
+			strerror(errno));
+		return false;
+	}
+	const bool written = fwrite(data, 1, size, f) == size;
+	if (fclose(f) != 0 || !written)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot write campaign cache %s", tmp);
+		remove(tmp);
+		return false;
+	}
+	remove(path);
+	if (rename(tmp, path) != 0)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot write campaign cache %s: %s", path,
+			strerror(errno));
+		remove(tmp);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,68 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <json/json.h>
+
+#include "c_array.h"
+
+// Compiled campaign archives, cached next to the config file.
+// A cache holds the archive's JSON documents as relocatable images, which
+// are built from a memory-mapped file by turning node numbers into pointers,
+// and the tiles of static missions as raw arrays.
+// It is rebuilt when any source file changes.
+typedef struct
+{
+	uint8_t *Data;
+	size_t Size;
+	bool Mapped;
+	uint32_t Loaded; // bit per document already handed out
+} CampaignCache;
+
+// Open the cache of an archive if it is up to date.
+// If not and build is set, compile the archive into a new cache first.
+// Returns false if there is no usable cache; load from the archive instead.
+bool CampaignCacheOpen(CampaignCache *c, const char *archive, const bool build);
+void CampaignCacheClose(CampaignCache *c);
+
+// Get one of the archive's JSON documents, e.g. "missions.json".
+// Returns false if the cache cannot provide it; read the file instead.
+// Otherwise root is the document, or NULL if the archive doesn't have it.
+// Free the document with json_free_value before closing the cache.
+// Each document can only be got once per open.
+bool CampaignCacheTryGetJSON(
+	CampaignCache *c, const char *filename, json_t **root);
+
+// Load the decoded tiles of a static mission, by its index in the archive.
+// Returns false if the cache doesn't have them; c can be NULL.
+bool CampaignCacheLoadTiles(
+	const CampaignCache *c, const int mission, CArray *tiles, CArray *access);
@@ -83,10 +83,17 @@ void CampaignEntryCopy(CampaignEntry *dst, const CampaignEntry *src)
 }
 bool CampaignEntryTryLoad(
 	CampaignEntry *entry, const char *path, GameMode mode)
+{
+	return CampaignEntryTryLoadIndexed(entry, path, mode, NULL);
+}
+bool CampaignEntryTryLoadIndexed(
+	CampaignEntry *entry, const char *path, GameMode mode, CampaignIndex *ci)
 {
 	char *buf;
 	int numMissions;
-	if (!IsCampaignOK(path, &buf, &numMissions))
+	const bool ok = ci ? CampaignIndexScan(ci, path, &buf, &numMissions)
+					   : IsCampaignOK(path, &buf, &numMissions);
+	if (!ok)
 	{
 		return false;
 	}
@@ -28,6 +28,7 @@
 */
 #pragma once
 
+#include "campaign_index.h"
 #include "game_mode.h"
 
 typedef struct
@@ -43,6 +44,9 @@ void CampaignEntryInit(CampaignEntry *entry, const char *title, GameMode mode);
 void CampaignEntryCopy(CampaignEntry *dst, const CampaignEntry *src);
 bool CampaignEntryTryLoad(
 	CampaignEntry *entry, const char *path, GameMode mode);
+// As above, but only scanning the file if it isn't in the index
+bool CampaignEntryTryLoadIndexed(
+	CampaignEntry *entry, const char *path, GameMode mode, CampaignIndex *ci);
 void CampaignEntryTerminate(CampaignEntry *entry);
 
 bool IsCampaignOK(const char *path, char **buf, int *numMissions);
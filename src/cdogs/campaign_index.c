@@ -0,0 +1,320 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "campaign_index.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "campaign_entry.h"
+#include "files.h"
+#include "log.h"
+#include "utils.h"
+
+#define INDEX_MAGIC 0x58494443 // "CDIX"
+// Bump when the layout of the index changes
+#define INDEX_VERSION 1
+
+typedef struct
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t Count;
+	uint32_t Pad;
+	uint64_t Checksum; // of everything after the header
+} IndexHeader;
+// Followed by the path and then the title, without terminators
+typedef struct
+{
+	int64_t MTime;
+	int64_t Size;
+	int32_t NumMissions;
+	uint32_t OK;
+	uint32_t PathLen;
+	uint32_t TitleLen;
+} IndexRecord;
+
+static void EntryDestroy(any_t data)
+{
+	CampaignIndexEntry *e = data;
+	CFREE(e->Path);
+	CFREE(e->Title);
+	CFREE(e);
+}
+
+static bool ParseIndex(CampaignIndex *ci, const uint8_t *data, const size_t size);
+void CampaignIndexInit(CampaignIndex *ci, const char *path)
+{
+	memset(ci, 0, sizeof *ci);
+	strcpy(ci->Path, path);
+	ci->entries = hashmap_new();
+	long len;
+	char *buf = ReadFileIntoBuf(path, "rb", &len);
+	if (buf == NULL)
+	{
+		return;
+	}
+	if (!ParseIndex(ci, (const uint8_t *)buf, (size_t)len))
+	{
+		LOG(LM_MAIN, LL_WARN, "campaign index %s is invalid", path);
+		hashmap_clear(ci->entries, EntryDestroy);
+		// Overwrite it even if nothing changes
+		ci->Dirty = true;
+	}
+	CFREE(buf);
+}
+static bool ParseIndex(CampaignIndex *ci, const uint8_t *data, const size_t size)
+{
+	const IndexHeader *h = (const IndexHeader *)data;
+	if (size < sizeof *h || h->Magic != INDEX_MAGIC ||
+		h->Version != INDEX_VERSION ||
+		HashBytes(data + sizeof *h, size - sizeof *h, 0) != h->Checksum)
+	{
+		return false;
+	}
+	const uint8_t *p = data + sizeof *h;
+	const uint8_t *end = data + size;
+	for (uint32_t i = 0; i < h->Count; i++)
+	{
+		IndexRecord r;
+		if ((size_t)(end - p) < sizeof r)
+		{
+			return false;
+		}
+		memcpy(&r, p, sizeof r);
+		p += sizeof r;
+		if ((size_t)(end - p) < (size_t)r.PathLen + r.TitleLen ||
+			r.PathLen == 0 || r.PathLen >= CDOGS_PATH_MAX)
+		{
+			return false;
+		}
+		CampaignIndexEntry *e;
+		CCALLOC(e, sizeof *e);
+		CCALLOC(e->Path, r.PathLen + 1);
+		memcpy(e->Path, p, r.PathLen);
+		p += r.PathLen;
+		CCALLOC(e->Title, r.TitleLen + 1);
+		memcpy(e->Title, p, r.TitleLen);
+		p += r.TitleLen;
+		e->MTime = r.MTime;
+		e->Size = r.Size;
+		e->OK = r.OK != 0;
+		e->NumMissions = r.NumMissions;
+		if (hashmap_put(ci->entries, e->Path, e) != MAP_OK)
+		{
+			EntryDestroy(e);
+			return false;
+		}
+	}
+	return p == end;
+}
+void CampaignIndexTerminate(CampaignIndex *ci)
+{
+	LOG(LM_MAIN, LL_DEBUG, "campaign index %s: %d hits, %d misses",
+		ci->Path, ci->Stats.Hits, ci->Stats.Misses);
+	hashmap_destroy(ci->entries, EntryDestroy);
+	memset(ci, 0, sizeof *ci);
+}
+
+typedef struct
+{
+	bool Prune;
+	uint32_t Count;
+	int Dropped;
+	size_t Size;
+	uint8_t *Data; // NULL when measuring
+} WriteData;
+static int WriteEntry(any_t data, any_t item)
+{
+	WriteData *w = data;
+	const CampaignIndexEntry *e = item;
+	if (w->Prune && !e->Seen)
+	{
+		w->Dropped++;
+		return MAP_OK;
+	}
+	IndexRecord r;
+	memset(&r, 0, sizeof r);
+	r.MTime = e->MTime;
+	r.Size = e->Size;
+	r.NumMissions = e->NumMissions;
+	r.OK = e->OK;
+	r.PathLen = (uint32_t)strlen(e->Path);
+	r.TitleLen = (uint32_t)strlen(e->Title);
+	if (w->Data != NULL)
+	{
+		uint8_t *p = w->Data + w->Size;
+		memcpy(p, &r, sizeof r);
+		p += sizeof r;
+		memcpy(p, e->Path, r.PathLen);
+		p += r.PathLen;
+		memcpy(p, e->Title, r.TitleLen);
+	}
+	w->Size += sizeof r + r.PathLen + r.TitleLen;
+	w->Count++;
+	return MAP_OK;
+}
+void CampaignIndexSave(CampaignIndex *ci, const bool prune)
+{
+	WriteData w;
+	memset(&w, 0, sizeof w);
+	w.Prune = prune;
+	w.Size = sizeof(IndexHeader);
+	hashmap_iterate(ci->entries, WriteEntry, &w);
+	if (!ci->Dirty && w.Dropped == 0)
+	{
+		return;
+	}
+	const size_t size = w.Size;
+	CMALLOC(w.Data, size);
+	w.Count = 0;
+	w.Size = sizeof(IndexHeader);
+	hashmap_iterate(ci->entries, WriteEntry, &w);
+	IndexHeader *h = (IndexHeader *)w.Data;
+	memset(h, 0, sizeof *h);
+	h->Magic = INDEX_MAGIC;
+	h->Version = INDEX_VERSION;
+	h->Count = w.Count;
+	h->Checksum = HashBytes(w.Data + sizeof *h, size - sizeof *h, 0);
+
+	char dir[CDOGS_PATH_MAX];
+	PathGetDirname(dir, ci->Path);
+	if (strlen(dir) > 0 && !mkdir_deep(dir))
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot create dir %s", dir);
+		goto bail;
+	}
+	// Write to a temporary file first so a partial index is never loaded
+	char tmp[CDOGS_PATH_MAX];
+	sprintf(tmp, "%s.tmp", ci->Path);
+	FILE *f = fopen(tmp, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot write campaign index %s: %s", tmp,
+			strerror(errno));
+		goto bail;
+	}
+	const bool written = fwrite(w.Data, 1, size, f) == size;
+	if (fclose(f) != 0 || !written)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot write campaign index %s", tmp);
+		remove(tmp);
+		goto bail;
+	}
+	remove(ci->Path);
+	if (rename(tmp, ci->Path) != 0)
+	{
+		remove(tmp);
+		goto bail;
+	}
+	ci->Dirty = false;
+	LOG(LM_MAIN, LL_DEBUG, "wrote campaign index %s (%u files, %d dropped)",
+		ci->Path, w.Count, w.Dropped);
+
+bail:
+	CFREE(w.Data);
+}
+
+// Folders use the time of their campaign.json if they have one, as that is
+// where the title and mission count come from
+static bool StatCampaign(const char *path, int64_t *mtime, int64_t *size)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return false;
+	}
+	if (st.st_mode & S_IFDIR)
+	{
+		char buf[CDOGS_PATH_MAX];
+		sprintf(buf, "%s/campaign.json", path);
+		struct stat stJSON;
+		if (stat(buf, &stJSON) == 0)
+		{
+			st = stJSON;
+		}
+	}
+	*mtime = (int64_t)st.st_mtime;
+	*size = (int64_t)st.st_size;
+	return true;
+}
+bool CampaignIndexScan(
+	CampaignIndex *ci, const char *path, char **title, int *numMissions)
+{
+	int64_t mtime, size;
+	if (!StatCampaign(path, &mtime, &size))
+	{
+		return false;
+	}
+	CampaignIndexEntry *e = NULL;
+	if (hashmap_get(ci->entries, path, (any_t *)&e) != MAP_OK)
+	{
+		CCALLOC(e, sizeof *e);
+		CSTRDUP(e->Path, path);
+		if (hashmap_put(ci->entries, e->Path, e) != MAP_OK)
+		{
+			EntryDestroy(e);
+			return IsCampaignOK(path, title, numMissions);
+		}
+	}
+	else if (e->MTime == mtime && e->Size == size)
+	{
+		ci->Stats.Hits++;
+		goto done;
+	}
+	ci->Stats.Misses++;
+	CFREE(e->Title);
+	e->Title = NULL;
+	e->MTime = mtime;
+	e->Size = size;
+	e->NumMissions = 0;
+	e->OK = IsCampaignOK(path, &e->Title, &e->NumMissions);
+	if (!e->OK)
+	{
+		CFREE(e->Title);
+		e->Title = NULL;
+		e->NumMissions = 0;
+	}
+	if (e->Title == NULL)
+	{
+		CSTRDUP(e->Title, "");
+	}
+	ci->Dirty = true;
+
+done:
+	e->Seen = true;
+	if (!e->OK)
+	{
+		return false;
+	}
+	CSTRDUP(*title, e->Title);
+	*numMissions = e->NumMissions;
+	return true;
+}
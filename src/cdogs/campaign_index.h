@@ -0,0 +1,73 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_hashmap/hashmap.h"
+#include "sys_config.h"
+
+#define CAMPAIGN_INDEX_FILE "cache/campaigns.cdogsidx"
+
+// Title and mission count of every file found when listing campaigns, kept
+// next to the config file. Listing only needs to stat each file; files are
+// scanned again only if they are new or their size or time has changed.
+// Not thread safe; use one index per scanning thread.
+typedef struct
+{
+	char *Path;
+	int64_t MTime;
+	int64_t Size;
+	bool OK; // whether the file is a campaign at all
+	char *Title;
+	int NumMissions;
+	bool Seen;
+} CampaignIndexEntry;
+typedef struct
+{
+	char Path[CDOGS_PATH_MAX];
+	map_t entries; // of CampaignIndexEntry *, by path
+	bool Dirty;
+	struct
+	{
+		int Hits;
+		int Misses;
+	} Stats;
+} CampaignIndex;
+
+// Load the index at path; starts empty if missing or invalid
+void CampaignIndexInit(CampaignIndex *ci, const char *path);
+void CampaignIndexTerminate(CampaignIndex *ci);
+// Write the index back if anything has changed.
+// With prune, drop the files that weren't seen since it was loaded.
+void CampaignIndexSave(CampaignIndex *ci, const bool prune);
+
+// Like IsCampaignOK, but using the index if the file hasn't changed
+bool CampaignIndexScan(
+	CampaignIndex *ci, const char *path, char **title, int *numMissions);
@@ -109,39 +109,85 @@ bool CampaignListIsEmpty(const CampaignList *c)
 
 static void CampaignListInit(CampaignList *list);
 static void CampaignListTerminate(CampaignList *list);
+typedef struct
+{
+	CustomCampaigns *Campaigns;
+	CampaignIndex Index;
+} CampaignScan;
 static void LoadCampaignsFromFolder(
-	CampaignList *list, const char *name, const char *path,
-	const GameMode mode);
+	CampaignScan *scan, CampaignList *list, const char *name,
+	const char *path, const GameMode mode);
 static void LoadQuickPlayEntry(CampaignEntry *entry);
+static int LoadCampaignLists(void *data);
 
 void LoadAllCampaigns(CustomCampaigns *campaigns)
 {
 	MapWolfInit();
 
-	char buf[CDOGS_PATH_MAX];
-
 	CampaignListInit(&campaigns->campaignList);
 	CampaignListInit(&campaigns->dogfightList);
+	SDL_AtomicSet(&campaigns->loaded, 0);
+	SDL_AtomicSet(&campaigns->cancel, 0);
+
+	LOG(LM_MAIN, LL_INFO, "Load quick play...");
+	LoadQuickPlayEntry(&campaigns->quickPlayEntry);
+
+	// Scanning large campaign folders is slow; do it in the background and
+	// let the menus fill in the lists as they are loaded
+	campaigns->thread =
+		SDL_CreateThread(LoadCampaignLists, "LoadCampaigns", campaigns);
+	if (campaigns->thread == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "cannot create campaign loader thread: %s",
+			SDL_GetError());
+		LoadCampaignLists(campaigns);
+	}
+}
+static int LoadCampaignLists(void *data)
+{
+	CampaignScan scan;
+	scan.Campaigns = data;
+	char buf[CDOGS_PATH_MAX];
+	GetConfigFilePathBuf(buf, CAMPAIGN_INDEX_FILE);
+	CampaignIndexInit(&scan.Index, buf);
+	const Uint32 ticksStart = SDL_GetTicks();
 
 	LOG(LM_MAIN, LL_INFO, "Load campaigns from system...");
-	MapWolfLoadCampaignsFromSystem(&campaigns->campaignList);
+	MapWolfLoadCampaignsFromSystem(&scan.Campaigns->campaignList);
 
 	GetDataFilePath(buf, CDOGS_CAMPAIGN_DIR);
 	LOG(LM_MAIN, LL_INFO, "Load campaigns from dir %s...", buf);
 	LoadCampaignsFromFolder(
-		&campaigns->campaignList, "", buf, GAME_MODE_NORMAL);
+		&scan, &scan.Campaigns->campaignList, "", buf, GAME_MODE_NORMAL);
+	SDL_AtomicSet(&scan.Campaigns->loaded, CAMPAIGN_LIST_CAMPAIGNS);
 
 	GetDataFilePath(buf, CDOGS_DOGFIGHT_DIR);
 	LOG(LM_MAIN, LL_INFO, "Load dogfights from dir %s...", buf);
 	LoadCampaignsFromFolder(
-		&campaigns->dogfightList, "", buf, GAME_MODE_DOGFIGHT);
+		&scan, &scan.Campaigns->dogfightList, "", buf, GAME_MODE_DOGFIGHT);
+	SDL_AtomicSet(&scan.Campaigns->loaded, CAMPAIGN_LIST_ALL);
 
-	LOG(LM_MAIN, LL_INFO, "Load quick play...");
-	LoadQuickPlayEntry(&campaigns->quickPlayEntry);
+	// Only forget missing files if the scan wasn't cut short
+	const bool cancelled = SDL_AtomicGet(&scan.Campaigns->cancel) != 0;
+	CampaignIndexSave(&scan.Index, !cancelled);
+	LOG(LM_MAIN, LL_INFO, "Loaded campaign lists in %ums (%d scanned)",
+		SDL_GetTicks() - ticksStart, scan.Index.Stats.Misses);
+	CampaignIndexTerminate(&scan.Index);
+	return 0;
+}
+int CampaignsLoaded(CustomCampaigns *campaigns)
+{
+	return SDL_AtomicGet(&campaigns->loaded);
 }
 
 void UnloadAllCampaigns(CustomCampaigns *campaigns)
 {
+	if (campaigns && campaigns->thread)
+	{
+		SDL_AtomicSet(&campaigns->cancel, 1);
+		SDL_WaitThread(campaigns->thread, NULL);
+		campaigns->thread = NULL;
+	}
 	MapWolfTerminate();
 	if (campaigns)
 	{
@@ -178,8 +224,8 @@ static void LoadQuickPlayEntry(CampaignEntry *entry)
 }
 
 static void LoadCampaignsFromFolder(
-	CampaignList *list, const char *name, const char *path,
-	const GameMode mode)
+	CampaignScan *scan, CampaignList *list, const char *name,
+	const char *path, const GameMode mode)
 {
 	tinydir_dir dir;
 	int i;
@@ -193,6 +239,10 @@ static void LoadCampaignsFromFolder(
 
 	for (i = 0; i < (int)dir.n_files; i++)
 	{
+		if (SDL_AtomicGet(&scan->Campaigns->cancel))
+		{
+			break;
+		}
 		tinydir_file file;
 		tinydir_readfile_n(&dir, &file, i);
 		// Ignore campaigns that start with a ~; these are autosaved
@@ -207,7 +257,8 @@ static void LoadCampaignsFromFolder(
 		{
 			CampaignList subFolder;
 			CampaignListInit(&subFolder);
-			LoadCampaignsFromFolder(&subFolder, file.name, file.path, mode);
+			LoadCampaignsFromFolder(
+				scan, &subFolder, file.name, file.path, mode);
 			if (CampaignListIsEmpty(&subFolder))
 			{
 				CampaignListTerminate(&subFolder);
@@ -218,7 +269,8 @@ static void LoadCampaignsFromFolder(
 			}
 		}
 		CampaignEntry entry;
-		if (CampaignEntryTryLoad(&entry, file.path, mode))
+		if (CampaignEntryTryLoadIndexed(
+				&entry, file.path, mode, &scan->Index))
 		{
 			CArrayPushBack(&list->list, &entry);
 		}
@@ -241,7 +293,10 @@ void CampaignSeedRandom(const Campaign *campaign)
 	const int seed = 10 * campaign->MissionIndex +
 					 ConfigGetInt(&gConfig, "Game.RandomSeed");
 	LOG(LM_MAIN, LL_INFO, "Seeding with %d", seed);
-	srand((unsigned int)seed);
+	// Cosmetic randomness (menus, particles) is left alone
+	RngSeed(RNG_MAPGEN, (uint64_t)seed);
+	RngSeed(RNG_GAMEPLAY, (uint64_t)seed);
+	RngSeed(RNG_AI, (uint64_t)seed);
 }
 
 void CampaignAndMissionSetup(Campaign *campaign, struct MissionOptions *mo)
@@ -28,6 +28,9 @@
 */
 #pragma once
 
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+
 #include "c_array.h"
 #include "campaign_entry.h"
 #include "character.h"
@@ -41,11 +44,23 @@ typedef struct
 	CArray list;	   // of CampaignEntry
 } CampaignList;
 
+typedef enum
+{
+	CAMPAIGN_LIST_CAMPAIGNS = 1,
+	CAMPAIGN_LIST_DOGFIGHTS = 2,
+	CAMPAIGN_LIST_ALL = CAMPAIGN_LIST_CAMPAIGNS | CAMPAIGN_LIST_DOGFIGHTS
+} CampaignListFlags;
+
 typedef struct
 {
 	CampaignList campaignList;
 	CampaignList dogfightList;
 	CampaignEntry quickPlayEntry;
+	// The lists are loaded on a background thread, and can only be used once
+	// they are flagged as loaded
+	SDL_Thread *thread;
+	SDL_atomic_t loaded;
+	SDL_atomic_t cancel;
 } CustomCampaigns;
 
 typedef struct
@@ -88,7 +103,10 @@ void CampaignSettingTerminateAll(CampaignSetting *setting);
 
 bool CampaignListIsEmpty(const CampaignList *c);
 
+// Start loading the campaign lists in the background
 void LoadAllCampaigns(CustomCampaigns *campaigns);
+// Get which lists (CampaignListFlags) have been loaded
+int CampaignsLoaded(CustomCampaigns *campaigns);
 void UnloadAllCampaigns(CustomCampaigns *campaigns);
 
 Mission *CampaignGetCurrentMission(Campaign *campaign);
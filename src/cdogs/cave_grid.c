@@ -0,0 +1,207 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "cave_grid.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+#define ALL_WALLS (~(uint64_t)0)
+
+// Set the padding bits past the right edge of every row
+static void PadRows(const CaveGrid *g, uint64_t *words)
+{
+	const int rem = g->Size.x % 64;
+	if (rem == 0)
+	{
+		return;
+	}
+	const uint64_t pad = ALL_WALLS << rem;
+	for (int y = 0; y < g->Size.y; y++)
+	{
+		words[y * g->Stride + g->Stride - 1] |= pad;
+	}
+}
+
+void CaveGridInit(CaveGrid *g, const struct vec2i size)
+{
+	g->Size = size;
+	g->Stride = (size.x + 63) / 64;
+	const size_t n = (size_t)g->Stride * size.y;
+	CCALLOC(g->Words, MAX(n, 1) * sizeof *g->Words);
+	CCALLOC(g->buf, MAX(n, 1) * sizeof *g->buf);
+	PadRows(g, g->Words);
+}
+void CaveGridTerminate(CaveGrid *g)
+{
+	CFREE(g->Words);
+	CFREE(g->buf);
+}
+
+bool CaveGridIsWall(const CaveGrid *g, const struct vec2i pos)
+{
+	if (pos.x < 0 || pos.y < 0 || pos.x >= g->Size.x || pos.y >= g->Size.y)
+	{
+		return true;
+	}
+	const uint64_t w = g->Words[pos.y * g->Stride + pos.x / 64];
+	return (w >> (pos.x % 64)) & 1;
+}
+void CaveGridSetWall(CaveGrid *g, const struct vec2i pos, const bool wall)
+{
+	uint64_t *w = &g->Words[pos.y * g->Stride + pos.x / 64];
+	const uint64_t bit = (uint64_t)1 << (pos.x % 64);
+	if (wall)
+	{
+		*w |= bit;
+	}
+	else
+	{
+		*w &= ~bit;
+	}
+}
+
+void CaveGridShuffle(CaveGrid *g, const RngStream s)
+{
+	for (int i = 0; i < g->Size.x * g->Size.y; i++)
+	{
+		const int j = RAND_INT(s, 0, i + 1);
+		const struct vec2i vi = svec2i(i % g->Size.x, i / g->Size.x);
+		const struct vec2i vj = svec2i(j % g->Size.x, j / g->Size.x);
+		const bool wi = CaveGridIsWall(g, vi);
+		CaveGridSetWall(g, vi, CaveGridIsWall(g, vj));
+		CaveGridSetWall(g, vj, wi);
+	}
+}
+
+// Word k of a row, shifted so that each bit holds the tile dx away;
+// rows and words outside the map are walls
+static uint64_t Shifted(const uint64_t *row, const int stride, const int k,
+	const int dx)
+{
+	const uint64_t w = row[k];
+	if (dx == 0)
+	{
+		return w;
+	}
+	if (dx > 0)
+	{
+		const uint64_t next = k + 1 < stride ? row[k + 1] : ALL_WALLS;
+		return (w >> dx) | (next << (64 - dx));
+	}
+	const uint64_t prev = k > 0 ? row[k - 1] : ALL_WALLS;
+	return (w << -dx) | (prev >> (64 + dx));
+}
+// Add one bit to each lane of a bit-sliced counter
+static void Add(uint64_t *slices, const int n, uint64_t bits)
+{
+	for (int i = 0; i < n && bits; i++)
+	{
+		const uint64_t carry = slices[i] & bits;
+		slices[i] ^= bits;
+		bits = carry;
+	}
+}
+// Lanes where the counter is less than k / greater than k
+static void Compare(
+	const uint64_t *slices, const int n, const int k, uint64_t *lt,
+	uint64_t *gt)
+{
+	*lt = 0;
+	*gt = 0;
+	if (k < 0)
+	{
+		*gt = ALL_WALLS;
+		return;
+	}
+	if (k >= 1 << n)
+	{
+		*lt = ALL_WALLS;
+		return;
+	}
+	uint64_t eq = ALL_WALLS;
+	for (int i = n - 1; i >= 0; i--)
+	{
+		if ((k >> i) & 1)
+		{
+			*lt |= eq & ~slices[i];
+			eq &= slices[i];
+		}
+		else
+		{
+			*gt |= eq & slices[i];
+			eq &= ~slices[i];
+		}
+	}
+}
+// Enough for 9 and 25
+#define SLICES_3X3 4
+#define SLICES_5X5 5
+void CaveGridStep(CaveGrid *g, const int r1, const int r2)
+{
+	for (int y = 0; y < g->Size.y; y++)
+	{
+		// NULL for rows outside the map
+		const uint64_t *rows[5];
+		for (int dy = -2; dy <= 2; dy++)
+		{
+			const int ry = y + dy;
+			rows[dy + 2] =
+				ry >= 0 && ry < g->Size.y ? &g->Words[ry * g->Stride] : NULL;
+		}
+		for (int k = 0; k < g->Stride; k++)
+		{
+			uint64_t c3[SLICES_3X3] = {0, 0, 0, 0};
+			uint64_t c5[SLICES_5X5] = {0, 0, 0, 0, 0};
+			for (int dy = -2; dy <= 2; dy++)
+			{
+				for (int dx = -2; dx <= 2; dx++)
+				{
+					const uint64_t bits =
+						rows[dy + 2] != NULL
+							? Shifted(rows[dy + 2], g->Stride, k, dx)
+							: ALL_WALLS;
+					Add(c5, SLICES_5X5, bits);
+					if (abs(dx) <= 1 && abs(dy) <= 1)
+					{
+						Add(c3, SLICES_3X3, bits);
+					}
+				}
+			}
+			uint64_t lt3, gt3, lt5, gt5;
+			Compare(c3, SLICES_3X3, r1, &lt3, &gt3);
+			Compare(c5, SLICES_5X5, r2, &lt5, &gt5);
+			g->buf[y * g->Stride + k] = ~lt3 | ~gt5;
+		}
+	}
+	PadRows(g, g->buf);
+	uint64_t *tmp = g->Words;
+	g->Words = g->buf;
+	g->buf = tmp;
+}
@@ -0,0 +1,63 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rng.h"
+#include "vector.h"
+
+// Wall/floor bitplane for generating caves; one bit per tile, set for walls.
+// Rows are padded to whole 64-bit words, with the padding bits set so that
+// tiles outside the map count as walls.
+typedef struct
+{
+	struct vec2i Size;
+	int Stride; // words per row
+	uint64_t *Words;
+	uint64_t *buf; // for the next generation
+} CaveGrid;
+
+void CaveGridInit(CaveGrid *g, const struct vec2i size);
+void CaveGridTerminate(CaveGrid *g);
+
+bool CaveGridIsWall(const CaveGrid *g, const struct vec2i pos);
+void CaveGridSetWall(CaveGrid *g, const struct vec2i pos, const bool wall);
+
+// Shuffle the tiles, using the stream the same way as CArrayShuffle on an
+// array of the tiles in row order
+void CaveGridShuffle(CaveGrid *g, const RngStream s);
+
+// Perform one generation of cellular automata:
+// If the number of walls within 1 distance is at least r1, OR
+// if the number of walls within 2 distance is at most r2, then the tile
+// becomes a wall; otherwise it is a floor.
+// Counts include the tile itself and tiles outside the map.
+// 64 tiles are counted at a time, using bit-sliced adders.
+void CaveGridStep(CaveGrid *g, const int r1, const int r2);
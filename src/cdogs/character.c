@@ -33,6 +33,7 @@
 #include "actors.h"
 #include "files.h"
 #include "json_utils.h"
+#include "json_writer.h"
 #include "player_template.h"
 
 #define CHARACTER_VERSION 13
@@ -209,54 +210,52 @@ void CharacterLoadJSON(
 
 bool CharacterSave(CharacterStore *s, const char *path)
 {
-	json_t *root = json_new_object();
-	AddIntPair(root, "Version", CHARACTER_VERSION);
-	bool res = true;
+	char buf[CDOGS_PATH_MAX];
+	sprintf(buf, "%s/characters.json", path);
+	JSONWriter w;
+	if (!JSONWriterOpen(&w, buf))
+	{
+		return false;
+	}
+	JSONWriterBeginObject(&w, NULL);
+	JSONWriterInt(&w, "Version", CHARACTER_VERSION);
 
-	json_t *charNode = json_new_array();
-	CA_FOREACH(Character, c, s->OtherChars)
-	json_t *node = json_new_object();
-	AddStringPair(node, "Class", c->Class->Name);
+	JSONWriterBeginArray(&w, "Characters");
+	CA_FOREACH(const Character, c, s->OtherChars)
+	JSONWriterBeginObject(&w, NULL);
+	JSONWriterString(&w, "Class", c->Class->Name);
 	if (c->PlayerTemplateName)
 	{
-		AddStringPair(node, "PlayerTemplateName", c->PlayerTemplateName);
+		JSONWriterString(&w, "PlayerTemplateName", c->PlayerTemplateName);
 	}
 	if (c->Hair)
 	{
-		AddStringPair(node, "HairType", c->Hair);
+		JSONWriterString(&w, "HairType", c->Hair);
 	}
-	AddColorPair(node, "Skin", c->Colors.Skin);
-	AddColorPair(node, "Arms", c->Colors.Arms);
-	AddColorPair(node, "Body", c->Colors.Body);
-	AddColorPair(node, "Legs", c->Colors.Legs);
-	AddColorPair(node, "Hair", c->Colors.Hair);
-	AddColorPair(node, "Feet", c->Colors.Feet);
-	AddIntPair(node, "speed", (int)(c->speed * 256));
-	json_insert_pair_into_object(node, "Gun", json_new_string(c->Gun->name));
-	AddIntPair(node, "maxHealth", c->maxHealth);
-	AddIntPair(node, "flags", c->flags);
+	JSONWriterColor(&w, "Skin", c->Colors.Skin);
+	JSONWriterColor(&w, "Arms", c->Colors.Arms);
+	JSONWriterColor(&w, "Body", c->Colors.Body);
+	JSONWriterColor(&w, "Legs", c->Colors.Legs);
+	JSONWriterColor(&w, "Hair", c->Colors.Hair);
+	JSONWriterColor(&w, "Feet", c->Colors.Feet);
+	JSONWriterInt(&w, "speed", (int)(c->speed * 256));
+	JSONWriterString(&w, "Gun", c->Gun->name);
+	JSONWriterInt(&w, "maxHealth", c->maxHealth);
+	JSONWriterInt(&w, "flags", c->flags);
 	if (c->Drop != NULL)
 	{
-		json_insert_pair_into_object(node, "Drop", json_new_string(c->Drop->Name));
+		JSONWriterString(&w, "Drop", c->Drop->Name);
 	}
-	AddIntPair(node, "probabilityToMove", c->bot->probabilityToMove);
-	AddIntPair(node, "probabilityToTrack", c->bot->probabilityToTrack);
-	AddIntPair(node, "probabilityToShoot", c->bot->probabilityToShoot);
-	AddIntPair(node, "actionDelay", c->bot->actionDelay);
-	json_insert_child(charNode, node);
+	JSONWriterInt(&w, "probabilityToMove", c->bot->probabilityToMove);
+	JSONWriterInt(&w, "probabilityToTrack", c->bot->probabilityToTrack);
+	JSONWriterInt(&w, "probabilityToShoot", c->bot->probabilityToShoot);
+	JSONWriterInt(&w, "actionDelay", c->bot->actionDelay);
+	JSONWriterEndObject(&w);
 	CA_FOREACH_END()
-	json_insert_pair_into_object(root, "Characters", charNode);
-	char buf[CDOGS_PATH_MAX];
-	sprintf(buf, "%s/characters.json", path);
-	if (!TrySaveJSONFile(root, buf))
-	{
-		res = false;
-		goto bail;
-	}
+	JSONWriterEndArray(&w);
 
-bail:
-	json_free_value(&root);
-	return res;
+	JSONWriterEndObject(&w);
+	return JSONWriterClose(&w);
 }
 
 Character *CharacterStoreAddOther(CharacterStore *store)
@@ -309,12 +308,14 @@ int CharacterStoreGetSpecialId(const CharacterStore *store, const int i)
 int CharacterStoreGetRandomBaddieId(const CharacterStore *store)
 {
 	return *(int *)CArrayGet(
-		&store->baddieIds, rand() % store->baddieIds.size);
+		&store->baddieIds,
+		RAND_INT(RNG_GAMEPLAY, 0, (int)store->baddieIds.size));
 }
 int CharacterStoreGetRandomSpecialId(const CharacterStore *store)
 {
 	return *(int *)CArrayGet(
-		&store->specialIds, rand() % store->specialIds.size);
+		&store->specialIds,
+		RAND_INT(RNG_GAMEPLAY, 0, (int)store->specialIds.size));
 }
 
 bool CharacterIsPrisoner(const CharacterStore *store, const Character *c)
@@ -351,7 +352,7 @@ void CharacterShuffleAppearance(Character *c)
 	// Choose a random character class
 	const int numCharClasses = (int)gCharacterClasses.Classes.size +
 							   (int)gCharacterClasses.CustomClasses.size;
-	const int charClass = rand() % numCharClasses;
+	const int charClass = RAND_INT(RNG_COSMETIC, 0, numCharClasses);
 	if (charClass < (int)gCharacterClasses.Classes.size)
 	{
 		c->Class = CArrayGet(&gCharacterClasses.Classes, charClass);
@@ -364,7 +365,8 @@ void CharacterShuffleAppearance(Character *c)
 	}
 	CFREE(c->Hair);
 	const char *hairStyleName = *(char **)CArrayGet(
-		&gPicManager.hairstyleNames, rand() % gPicManager.hairstyleNames.size);
+		&gPicManager.hairstyleNames,
+		RAND_INT(RNG_COSMETIC, 0, (int)gPicManager.hairstyleNames.size));
 	CSTRDUP(c->Hair, hairStyleName);
 	c->Colors.Skin = RandomColor();
 	c->Colors.Arms = RandomColor();
@@ -376,9 +378,9 @@ void CharacterShuffleAppearance(Character *c)
 static color_t RandomColor(void)
 {
 	color_t c;
-	c.r = rand() & 255;
-	c.g = rand() & 255;
-	c.b = rand() & 255;
+	c.r = RAND_INT(RNG_COSMETIC, 0, 256);
+	c.g = RAND_INT(RNG_COSMETIC, 0, 256);
+	c.b = RAND_INT(RNG_COSMETIC, 0, 256);
 	c.a = 255;
 	return c;
 }
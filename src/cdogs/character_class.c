@@ -245,6 +245,7 @@ bail:
 static void LoadCharacterClass(CharacterClass *c, json_t *node);
 void CharacterClassesLoadJSON(CArray *classes, json_t *root)
 {
+	JSONTrackVisits(root, LM_MAIN);
 	int version;
 	LoadInt(&version, root, "Version");
 	if (version > VERSION || version <= 0)
@@ -261,6 +262,7 @@ void CharacterClassesLoadJSON(CArray *classes, json_t *root)
 		LoadCharacterClass(&cc, child);
 		CArrayPushBack(classes, &cc);
 	}
+	JSONLogUnvisited(root, LM_MAIN, "characters");
 }
 static void LoadCharacterClass(CharacterClass *c, json_t *node)
 {
@@ -299,6 +301,63 @@ static void LoadCharacterClass(CharacterClass *c, json_t *node)
 	LoadStr(&c->Corpse, node, "Corpse");
 }
 static void CharacterClassFree(CharacterClass *c);
+static const JSONField characterFields[] = {
+	{"Vehicle", JSON_FIELD_BOOL, NULL, 0},
+	{"HeadPics", JSON_FIELD_OBJECT, NULL, 0},
+	{"HeadPics/Sprites", JSON_FIELD_STRING, NULL, 0},
+	{"Body", JSON_FIELD_STRING, NULL, 0},
+	{"DeathSprites", JSON_FIELD_STRING, NULL, 0},
+	{"Mass", JSON_FIELD_NUMBER, NULL, 0},
+	{"Sounds", JSON_FIELD_STRING, NULL, 0},
+	{"Footsteps", JSON_FIELD_STRING, NULL, 0},
+	{"FootstepsDistancePlus", JSON_FIELD_NUMBER, NULL, 0},
+	{"BloodColor", JSON_FIELD_STRING, NULL, 0},
+	{"HasHair", JSON_FIELD_BOOL, NULL, 0},
+	{"Corpse", JSON_FIELD_STRING, NULL, 0},
+	{NULL, JSON_FIELD_BOOL, NULL, 0}};
+bool CharacterClassesReloadJSON(CArray *classes, json_t *root)
+{
+	if (!JSONCheckClassList(
+			root, VERSION, "Characters", "characters", characterFields))
+	{
+		return false;
+	}
+	// Head sprites are required
+	int i = 0;
+	for (json_t *child = JSONFindNode(root, "Characters")->child; child;
+		 child = child->next, i++)
+	{
+		if (JSONFindNode(child, "HeadPics/Sprites") == NULL)
+		{
+			LOG(LM_MAIN, LL_ERROR, "characters: Characters[%d] has no head",
+				i);
+			return false;
+		}
+	}
+	CArray loaded;
+	CArrayInit(&loaded, sizeof(CharacterClass));
+	CharacterClassesLoadJSON(&loaded, root);
+	int patched = 0;
+	CA_FOREACH(CharacterClass, c, loaded)
+	for (int j = 0; j < (int)classes->size; j++)
+	{
+		CharacterClass *existing = CArrayGet(classes, j);
+		if (strcmp(existing->Name, c->Name) == 0)
+		{
+			CharacterClassFree(existing);
+			memcpy(existing, c, sizeof *c);
+			memset(c, 0, sizeof *c);
+			patched++;
+			break;
+		}
+	}
+	CA_FOREACH_END()
+	LOG(LM_MAIN, LL_INFO, "reloaded %d characters, %d new ignored", patched,
+		(int)loaded.size - patched);
+	CharacterClassesClear(&loaded);
+	CArrayTerminate(&loaded);
+	return true;
+}
 void CharacterClassesClear(CArray *classes)
 {
 	for (int i = 0; i < (int)classes->size; i++)
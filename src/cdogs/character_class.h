@@ -70,5 +70,7 @@ void CharacterClassGetSound(const CharacterClass *c, char *out, const char *soun
 
 void CharacterClassesInitialize(CharacterClasses *c, const char *filename);
 void CharacterClassesLoadJSON(CArray *classes, json_t *root);
+// Update classes from root in place, keeping pointers to them valid
+bool CharacterClassesReloadJSON(CArray *classes, json_t *root);
 void CharacterClassesClear(CArray *classes);
 void CharacterClassesTerminate(CharacterClasses *c);
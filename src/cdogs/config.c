@@ -643,6 +643,13 @@ Config ConfigDefault(void)
 		"Gore", GORE_LOW, GORE_NONE, GORE_HIGH, StrGoreAmount, GoreAmountStr));
 	ConfigGroupAdd(&gfx, ConfigNewBool("Brass", true));
 	ConfigGroupAdd(&gfx, ConfigNewBool("SecondWindow", false));
+	ConfigGroupAdd(&gfx, ConfigNewBool("ThreadedRender", true));
+	// In MB; 0 for no limit
+	ConfigGroupAdd(&gfx,
+		ConfigNewInt("TextureBudget", 256, 0, 4096, 32, NULL, NULL));
+	// On-disk cache of decoded images, in MB; 0 to disable
+	ConfigGroupAdd(&gfx,
+		ConfigNewInt("ImageCacheSize", 256, 0, 2047, 32, NULL, NULL));
 	ConfigGroupAdd(&root, gfx);
 
 	Config input = ConfigNewGroup("Input");
@@ -696,6 +703,9 @@ Config ConfigDefault(void)
 		ConfigNewInt("SoundVolume", 64, 0, 64, 8, NULL, Div8Str));
 	ConfigGroupAdd(&snd, ConfigNewBool("Footsteps", true));
 	ConfigGroupAdd(&snd, ConfigNewBool("Reloads", true));
+	// In MB; 0 for no limit
+	ConfigGroupAdd(&snd,
+		ConfigNewInt("SoundBudget", 64, 0, 1024, 16, NULL, NULL));
 	ConfigGroupAdd(&root, snd);
 
 	Config qp = ConfigNewGroup("QuickPlay");
@@ -739,6 +749,10 @@ Config ConfigDefault(void)
 	ConfigGroupAdd(&root, qp);
 	
 	ConfigGroupAdd(&root, ConfigNewBool("StartServer", false));
+	// Reload class data files when they change, for tuning
+	ConfigGroupAdd(&root, ConfigNewBool("HotReload", false));
+	// Save static map tiles run-length encoded; smaller for large maps
+	ConfigGroupAdd(&root, ConfigNewBool("CompactTiles", false));
 
 	return root;
 }
@@ -34,6 +34,7 @@
 
 #include "config.h"
 #include "json_utils.h"
+#include "json_writer.h"
 #include "keyboard.h"
 #include "log.h"
 
@@ -171,34 +172,25 @@ static void ConfigLoadVisit(Config *c, json_t *node)
 	}
 }
 
-static void ConfigSaveVisit(const Config *c, json_t *node);
+static void ConfigSaveVisit(const Config *c, JSONWriter *w);
 void ConfigSaveJSON(const Config *config, const char *filename)
 {
-	FILE *f = fopen(filename, "w");
-	char *text = NULL;
-	json_t *root;
-
-	if (f == NULL)
+	JSONWriter w;
+	if (!JSONWriterOpen(&w, filename))
 	{
 		printf("Error saving config '%s'\n", filename);
 		return;
 	}
 
-	root = json_new_object();
-	json_insert_pair_into_object(
-		root, "Version", json_new_number(TOSTRING(CONFIG_VERSION)));
-	ConfigSaveVisit(config, root);
-
-	json_tree_to_string(root, &text);
-	char *formatText = json_format_string(text);
-	fputs(formatText, f);
-
-	// clean up
-	CFREE(formatText);
-	CFREE(text);
-	json_free_value(&root);
+	JSONWriterBeginObject(&w, NULL);
+	JSONWriterInt(&w, "Version", CONFIG_VERSION);
+	ConfigSaveVisit(config, &w);
+	JSONWriterEndObject(&w);
 
-	fclose(f);
+	if (!JSONWriterClose(&w))
+	{
+		printf("Error saving config '%s'\n", filename);
+	}
 
 #ifdef __EMSCRIPTEN__
     EM_ASM(
@@ -209,7 +201,7 @@ void ConfigSaveJSON(const Config *config, const char *filename)
     );
 #endif
 }
-static void ConfigSaveVisit(const Config *c, json_t *node)
+static void ConfigSaveVisit(const Config *c, JSONWriter *w)
 {
 	switch (c->Type)
 	{
@@ -217,35 +209,32 @@ static void ConfigSaveVisit(const Config *c, json_t *node)
 		CASSERT(false, "not implemented");
 		break;
 	case CONFIG_TYPE_INT:
-		AddIntPair(node, c->Name, c->u.Int.Value);
+		JSONWriterInt(w, c->Name, c->u.Int.Value);
 		break;
 	case CONFIG_TYPE_FLOAT:
 		CASSERT(false, "not implemented");
 		break;
 	case CONFIG_TYPE_BOOL:
-		json_insert_pair_into_object(
-			node, c->Name, json_new_bool(c->u.Bool.Value));
+		JSONWriterBool(w, c->Name, c->u.Bool.Value);
 		break;
 	case CONFIG_TYPE_ENUM:
-		JSON_UTILS_ADD_ENUM_PAIR(
-			node, c->Name, c->u.Enum.Value, c->u.Enum.EnumToStr);
+		JSONWriterString(w, c->Name, c->u.Enum.EnumToStr(c->u.Enum.Value));
 		break;
 	case CONFIG_TYPE_GROUP:
 		{
-			json_t *child = node;
 			// If the config has no name, then it is the root element
-			// Add children directly to the node
+			// Add children directly to the root object
 			// Otherwise, create a new child
 			if (c->Name != NULL)
 			{
-				child = json_new_object();
+				JSONWriterBeginObject(w, c->Name);
 			}
 			CA_FOREACH(Config, cg, c->u.Group)
-				ConfigSaveVisit(cg, child);
+				ConfigSaveVisit(cg, w);
 			CA_FOREACH_END()
 			if (c->Name != NULL)
 			{
-				json_insert_pair_into_object(node, c->Name, child);
+				JSONWriterEndObject(w);
 			}
 		}
 		break;
@@ -70,6 +70,7 @@ void NamedSpritesInit(NamedSprites *ns, const char *name)
 {
 	CSTRDUP(ns->name, name);
 	CArrayInit(&ns->pics, sizeof(Pic));
+	ns->CacheKey = 0;
 }
 void NamedSpritesFree(NamedSprites *ns)
 {
@@ -134,6 +135,63 @@ bail:
 	return;
 }
 
+static bool IsStringField(const json_t *node, const char *name)
+{
+	const json_t *label = json_find_first_label(node, name);
+	return label != NULL && label->child != NULL &&
+		   label->child->type == JSON_STRING;
+}
+bool CPicIsValidJSON(const json_t *node)
+{
+	if (node->type != JSON_OBJECT || !IsStringField(node, "Type"))
+	{
+		return false;
+	}
+	const char *type = json_find_first_label(node, "Type")->child->text;
+	if (strcmp(type, "Normal") == 0)
+	{
+		if (!IsStringField(node, "Pic"))
+		{
+			return false;
+		}
+	}
+	else if (
+		strcmp(type, "Directional") == 0 || strcmp(type, "Animated") == 0 ||
+		strcmp(type, "AnimatedRandom") == 0)
+	{
+		if (!IsStringField(node, "Sprites"))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+	if (json_find_first_label(node, "Mask") != NULL)
+	{
+		return IsStringField(node, "Mask");
+	}
+	const json_t *tint = json_find_first_label(node, "Tint");
+	if (tint != NULL)
+	{
+		int count = 0;
+		if (tint->child == NULL || tint->child->type != JSON_ARRAY)
+		{
+			return false;
+		}
+		for (const json_t *c = tint->child->child; c; c = c->next, count++)
+		{
+			if (c->type != JSON_NUMBER)
+			{
+				return false;
+			}
+		}
+		return count == 3;
+	}
+	return true;
+}
+
 void CPicInitNormal(CPic *p, const Pic *pic)
 {
 	p->Type = PICTYPE_NORMAL;
@@ -220,10 +278,43 @@ void CPicCopyPic(CPic *dest, const CPic *src)
 	if (dest->Type == PICTYPE_ANIMATED_RANDOM)
 	{
 		// initialise frame with a random value
-		dest->u.Animated.Frame = rand() % (int)dest->u.Animated.Sprites->size;
+		dest->u.Animated.Frame = RAND_INT(
+			RNG_COSMETIC, 0, (int)dest->u.Animated.Sprites->size);
 	}
 }
 
+void CPicPrefetch(const CPic *p)
+{
+	switch (p->Type)
+	{
+	case PICTYPE_NORMAL:
+		if (p->u.Pic != NULL)
+		{
+			PicPrefetch(p->u.Pic);
+		}
+		break;
+	case PICTYPE_DIRECTIONAL:
+		if (p->u.Sprites != NULL)
+		{
+			CA_FOREACH(const Pic, pic, *p->u.Sprites)
+			PicPrefetch(pic);
+			CA_FOREACH_END()
+		}
+		break;
+	case PICTYPE_ANIMATED:
+	case PICTYPE_ANIMATED_RANDOM:
+		if (p->u.Animated.Sprites != NULL)
+		{
+			CA_FOREACH(const Pic, pic, *p->u.Animated.Sprites)
+			PicPrefetch(pic);
+			CA_FOREACH_END()
+		}
+		break;
+	default:
+		CASSERT(false, "unknown pic type");
+		break;
+	}
+}
 void CPicUpdate(CPic *p, const int ticks)
 {
 	switch (p->Type)
@@ -249,13 +340,15 @@ void CPicUpdate(CPic *p, const int ticks)
 		if (p->u.Animated.Count == 0)
 		{
 			// Initial frame
-			p->u.Animated.Frame = rand() % (int)p->u.Animated.Sprites->size;
+			p->u.Animated.Frame = RAND_INT(
+				RNG_COSMETIC, 0, (int)p->u.Animated.Sprites->size);
 		}
 		p->u.Animated.Count += ticks;
 		if (p->u.Animated.TicksPerFrame > 0 &&
 			p->u.Animated.Count >= p->u.Animated.TicksPerFrame)
 		{
-			p->u.Animated.Frame = rand() % (int)p->u.Animated.Sprites->size;
+			p->u.Animated.Frame = RAND_INT(
+				RNG_COSMETIC, 0, (int)p->u.Animated.Sprites->size);
 			p->u.Animated.Count = 0;
 		}
 		break;
@@ -37,11 +37,15 @@ typedef struct
 {
 	Pic pic;
 	char *name;
+	// Key of the decoded pixels in gImageCache, or 0
+	uint64_t CacheKey;
 } NamedPic;
 typedef struct
 {
 	CArray pics;	// of Pic
 	char *name;
+	// Key of the decoded pixels in gImageCache, or 0
+	uint64_t CacheKey;
 } NamedSprites;
 
 typedef enum
@@ -88,6 +92,8 @@ void NamedSpritesInit(NamedSprites *ns, const char *name);
 void NamedSpritesFree(NamedSprites *ns);
 
 void CPicLoadJSON(CPic *p, json_t *node);
+// Whether node has the fields CPicLoadJSON needs, of the right types
+bool CPicIsValidJSON(const json_t *node);
 void CPicInitNormal(CPic *p, const Pic *pic);
 void CPicInitNormalFromName(CPic *p, const char *name);
 void CPicLoadNormal(CPic *p, const json_t *node);
@@ -95,6 +101,8 @@ bool CPicIsLoaded(const CPic *p);
 struct vec2i CPicGetSize(const CPic *p);
 // Copy everything except frame
 void CPicCopyPic(CPic *dest, const CPic *src);
+// Make the textures now so that the first draw doesn't stall
+void CPicPrefetch(const CPic *p);
 void CPicUpdate(CPic *p, const int ticks);
 const Pic *CPicGetPic(const CPic *p, const int idx);
 void CPicDraw(
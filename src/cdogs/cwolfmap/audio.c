@@ -10,7 +10,10 @@
 
 #define PATH_MAX 4096
 static int volume = 20;
+// Sounds and music use separate chips so that synthesising sounds doesn't
+// disturb the state of streaming music
 static const int oplChip = 0;
+static const int musicChip = 1;
 #define OPL_CHANNELS 9
 #define MUSIC_RATE 700
 #define SOUND_RATE 140 // Also affects PC Speaker sounds
@@ -43,7 +46,7 @@ static const AlInstrument ChannelRelease = {
 
 	0, 0, {0, 0, 0}};
 
-#define alOut(n, b) YM3812Write(oplChip, n, b, &volume)
+#define alOut(n, b) YM3812Write(chip, n, b, &volume)
 
 //      Register addresses
 // Operator stuff
@@ -59,7 +62,8 @@ static const AlInstrument ChannelRelease = {
 // Global stuff
 #define alEffects 0xbd
 
-static void AlSetChanInst(const AlInstrument *inst, unsigned int chan)
+static void AlSetChanInst(
+	const int chip, const AlInstrument *inst, unsigned int chan)
 {
 	static const uint8_t chanOps[OPL_CHANNELS] = {0,   1,	 2,	   8,	9,
 												  0xA, 0x10, 0x11, 0x12};
@@ -83,10 +87,22 @@ static void AlSetChanInst(const AlInstrument *inst, unsigned int chan)
 	alOut(chan + alFeedCon, 0);
 }
 
+// Synthesised sounds, by their raw data, so that each is only synthesised
+// once
+typedef struct
+{
+	char *raw;
+	size_t rawLen;
+	char *data;
+	size_t len;
+} AdlibSoundCache;
+static AdlibSoundCache *adlibCache = NULL;
+static int nAdlibCache = 0;
+
 bool CWAudioInit(void)
 {
 	// Init adlib
-	if (YM3812Init(1, 3579545, MUSIC_SAMPLE_RATE))
+	if (YM3812Init(2, 3579545, MUSIC_SAMPLE_RATE))
 	{
 		fprintf(stderr, "Unable to create virtual OPL\n");
 		return false;
@@ -96,6 +112,14 @@ bool CWAudioInit(void)
 void CWAudioTerminate(void)
 {
 	YM3812Shutdown();
+	for (int i = 0; i < nAdlibCache; i++)
+	{
+		free(adlibCache[i].raw);
+		free(adlibCache[i].data);
+	}
+	free(adlibCache);
+	adlibCache = NULL;
+	nAdlibCache = 0;
 }
 
 int CWAudioLoadHead(CWAudioHead *head, const char *path)
@@ -214,6 +238,33 @@ bail:
 	return err;
 }
 
+static const AdlibSoundCache *GetAdlibSoundCache(
+	const char *raw, const size_t rawLen)
+{
+	for (int i = 0; i < nAdlibCache; i++)
+	{
+		const AdlibSoundCache *c = &adlibCache[i];
+		if (c->rawLen == rawLen && memcmp(c->raw, raw, rawLen) == 0)
+		{
+			return c;
+		}
+	}
+	return NULL;
+}
+static void AddAdlibSoundCache(
+	const char *raw, const size_t rawLen, char *data, const size_t len)
+{
+	adlibCache =
+		realloc(adlibCache, (nAdlibCache + 1) * sizeof *adlibCache);
+	AdlibSoundCache *c = &adlibCache[nAdlibCache];
+	c->raw = malloc(rawLen);
+	memcpy(c->raw, raw, rawLen);
+	c->rawLen = rawLen;
+	c->data = data;
+	c->len = len;
+	nAdlibCache++;
+}
+
 int CWAudioGetAdlibSound(
 	const CWAudio *audio, const int idx, char **data, size_t *len)
 {
@@ -227,15 +278,24 @@ int CWAudioGetAdlibSound(
 		goto bail;
 	}
 
+	const AdlibSoundCache *c = GetAdlibSoundCache(rawData, rawLen);
+	if (c != NULL)
+	{
+		*data = c->data;
+		*len = c->len;
+		goto bail;
+	}
+
+	const int chip = oplChip;
 	const AdLibSound *sound = (const AdLibSound *)rawData;
 	const uint8_t alBlock = ((sound->block & 7) << 2) | 0x20;
-	AlSetChanInst(&sound->inst, 0);
+	AlSetChanInst(chip, &sound->inst, 0);
 
 	const uint8_t *alSound = sound->data;
 	*len = sound->length * SAMPLES_PER_MUSIC_TICK * SOUND_TICKS *
 		   MUSIC_AUDIO_CHANNELS * 2;
-	*data = malloc(*len);
-	int16_t *stream16 = (int16_t *)*data;
+	char *pcm = malloc(*len);
+	int16_t *stream16 = (int16_t *)pcm;
 	for (int alLengthLeft = (int)sound->length; alLengthLeft > 0;
 		 alLengthLeft--)
 	{
@@ -257,14 +317,10 @@ int CWAudioGetAdlibSound(
 	}
 	alOut(alFreqH, 0);
 
-	return err;
+	AddAdlibSoundCache(rawData, rawLen, pcm, *len);
+	*data = pcm;
 
 bail:
-	if (err != 0)
-	{
-		free(*data);
-		*data = NULL;
-	}
 	return err;
 }
 
@@ -291,6 +347,82 @@ bail:
 	return err;
 }
 
+static void MusicStreamRestart(CWMusicStream *s)
+{
+	const int chip = musicChip;
+	YM3812ResetChip(chip);
+	alOut(1, 0x20); // Set WSE=1
+	for (int i = 0; i < OPL_CHANNELS; i++)
+	{
+		AlSetChanInst(chip, &ChannelRelease, i);
+	}
+	s->ptr = s->start;
+	s->lenLeft = s->len;
+	s->time = 0;
+	s->tick = 0;
+	s->samplesLeft = 0;
+}
+
+int CWAudioMusicStreamInit(
+	CWMusicStream *s, const char *data, const size_t len)
+{
+	memset(s, 0, sizeof *s);
+	if (len < 2)
+	{
+		return -1;
+	}
+	const uint16_t *sqHack = (const uint16_t *)data;
+	if (*sqHack == 0)
+	{
+		// LumpLength?
+		s->len = (int)len;
+	}
+	else
+	{
+		s->len = *sqHack++;
+	}
+	if (s->len < 4)
+	{
+		return -1;
+	}
+	s->start = sqHack;
+	MusicStreamRestart(s);
+	return 0;
+}
+
+void CWAudioMusicStreamRender(CWMusicStream *s, int16_t *out, int n)
+{
+	const int chip = musicChip;
+	while (n > 0)
+	{
+		if (s->samplesLeft == 0)
+		{
+			if (s->lenLeft <= 0)
+			{
+				MusicStreamRestart(s);
+			}
+			do
+			{
+				if (s->time > s->tick)
+					break;
+				s->time = s->tick + *(s->ptr + 1);
+				alOut(
+					*(const uint8_t *)s->ptr,
+					*(((const uint8_t *)s->ptr) + 1));
+				s->ptr += 2;
+				s->lenLeft -= 4;
+			} while (s->lenLeft > 0);
+			s->tick++;
+			s->samplesLeft = SAMPLES_PER_MUSIC_TICK;
+		}
+		const int samples = n < s->samplesLeft ? n : s->samplesLeft;
+		YM3812UpdateOne(chip, out, samples);
+		out += samples * MUSIC_AUDIO_CHANNELS;
+		s->samplesLeft -= samples;
+		n -= samples;
+	}
+}
+
 int CWAudioGetMusic(
 	const CWAudio *audio, const int idx, char **data, size_t *len)
 {
@@ -308,25 +440,16 @@ int CWAudioGetMusic(
 		goto bail;
 	}
 
-	for (int i = 0; i < OPL_CHANNELS; i++)
+	CWMusicStream s;
+	err = CWAudioMusicStreamInit(&s, rawData, rawLen);
+	if (err != 0)
 	{
-		AlSetChanInst(&ChannelRelease, i);
+		goto bail;
 	}
 
 	// Measure length of music
-	const uint16_t *sqHack = (const uint16_t *)rawData;
-	int sqHackLen;
-	if (*sqHack == 0)
-	{
-		// LumpLength?
-		sqHackLen = (int)rawLen;
-	}
-	else
-	{
-		sqHackLen = *sqHack++;
-	}
-	const uint16_t *sqHackPtr = sqHack;
-
+	const uint16_t *sqHackPtr = s.start;
+	int sqHackLen = s.len;
 	int sqHackTime = 0;
 	int alTimeCount;
 	for (alTimeCount = 0; sqHackLen > 0; alTimeCount++)
@@ -343,49 +466,12 @@ int CWAudioGetMusic(
 
 	// Decode music
 	// 2 bytes per sample (16-bit audio fmt)
-	*len = alTimeCount * SAMPLES_PER_MUSIC_TICK * MUSIC_AUDIO_CHANNELS * 2;
+	const int samples = alTimeCount * SAMPLES_PER_MUSIC_TICK;
+	*len = samples * MUSIC_AUDIO_CHANNELS * 2;
 	*data = malloc(*len);
-	int16_t *stream16 = (int16_t *)*data;
-
-	sqHack = (const uint16_t *)rawData;
-	if (*sqHack == 0)
-	{
-		// LumpLength?
-		sqHackLen = (int)rawLen;
-	}
-	else
-	{
-		sqHackLen = *sqHack++;
-	}
-	sqHackPtr = sqHack;
-	sqHackTime = 0;
-	for (alTimeCount = 0; sqHackLen > 0; alTimeCount++)
-	{
-		do
-		{
-			if (sqHackTime > alTimeCount)
-				break;
-			sqHackTime = alTimeCount + *(sqHackPtr + 1);
-			alOut(
-				*(const uint8_t *)sqHackPtr,
-				*(((const uint8_t *)sqHackPtr) + 1));
-			sqHackPtr += 2;
-			sqHackLen -= 4;
-		} while (sqHackLen > 0);
-
-		YM3812UpdateOne(oplChip, stream16, SAMPLES_PER_MUSIC_TICK);
-
-		stream16 += SAMPLES_PER_MUSIC_TICK * MUSIC_AUDIO_CHANNELS;
-	}
-
-	return err;
+	CWAudioMusicStreamRender(&s, (int16_t *)*data, samples);
 
 bail:
-	if (err != 0)
-	{
-		free(*data);
-		*data = NULL;
-	}
 	return err;
 }
 
@@ -24,13 +24,35 @@ void CWAudioFree(CWAudio *audio);
 // http://www.vgmpf.com/Wiki/index.php?title=IMF
 int CWAudioGetAdlibSoundRaw(
 	const CWAudio *audio, const int i, const char **data, size_t *len);
+// Sounds are cached; data must not be freed, and is valid until
+// CWAudioTerminate
 int CWAudioGetAdlibSound(
 	const CWAudio *audio, const int i, char **data, size_t *len);
 int CWAudioGetMusicRaw(
 	const CWAudio *audio, const int i, const char **data, size_t *len);
+// Render a whole song; data must be freed
 int CWAudioGetMusic(
 	const CWAudio *audio, const int i, char **data, size_t *len);
 
+// Music rendered a bit at a time as it plays, looping at the end
+typedef struct
+{
+	const uint16_t *start;
+	int len;
+	const uint16_t *ptr;
+	int lenLeft;
+	int time; // tick of the next command
+	int tick;
+	int samplesLeft; // of the current tick
+} CWMusicStream;
+// data is raw music from CWAudioGetMusicRaw, and must outlive the stream.
+// Only one stream can play at a time, and the OPL emulator is shared with
+// sounds, so don't get sounds while rendering a stream on another thread.
+int CWAudioMusicStreamInit(
+	CWMusicStream *s, const char *data, const size_t len);
+// Render n samples of MUSIC_AUDIO_CHANNELS 16-bit audio
+void CWAudioMusicStreamRender(CWMusicStream *s, int16_t *out, int n);
+
 typedef enum
 {
 	SONG_INTRO,
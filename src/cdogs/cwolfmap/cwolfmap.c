@@ -80,7 +80,20 @@ CWMapType CWGetType(
 
 static int LoadMapHead(CWolfMap *map, const char *path);
 static int LoadMapData(CWolfMap *map, const char *path);
+static int Load(
+	CWolfMap *map, const char *path, const int spearMission,
+	const bool loadLevels);
 int CWLoad(CWolfMap *map, const char *path, const int spearMission)
+{
+	return Load(map, path, spearMission, true);
+}
+int CWLoadNoLevels(CWolfMap *map, const char *path, const int spearMission)
+{
+	return Load(map, path, spearMission, false);
+}
+static int Load(
+	CWolfMap *map, const char *path, const int spearMission,
+	const bool loadLevels)
 {
 	memset(map, 0, sizeof *map);
 	char pathBuf[PATH_MAX];
@@ -111,7 +124,10 @@ int CWLoad(CWolfMap *map, const char *path, const int spearMission)
 	}
 	_TRY_LOAD("MAPHEAD", LoadMapHead, map, pathBuf);
 
-	_TRY_LOAD("GAMEMAPS", LoadMapData, map, pathBuf);
+	if (loadLevels)
+	{
+		_TRY_LOAD("GAMEMAPS", LoadMapData, map, pathBuf);
+	}
 
 	_TRY_LOAD("AUDIOHED", CWAudioLoadHead, &map->audio.head, pathBuf);
 
@@ -255,6 +271,8 @@ static int LoadPlane(
 	unsigned char *buf, const int bufSize)
 {
 	int err = 0;
+	plane->len = 0;
+	plane->plane = NULL;
 
 	if (off == 0)
 	{
@@ -54,6 +54,8 @@ CWMapType CWGetType(
 	const char *path, const char **ext, const char **ext1,
 	const int spearMission);
 int CWLoad(CWolfMap *map, const char *path, const int spearMission);
+// Load everything but the levels, e.g. if they are cached
+int CWLoadNoLevels(CWolfMap *map, const char *path, const int spearMission);
 void CWCopy(CWolfMap *dst, const CWolfMap *src);
 void CWFree(CWolfMap *map);
 
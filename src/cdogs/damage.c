@@ -133,8 +133,12 @@ void DamageMelee(const NActorMelee m)
 			svec2_add(
 				svec2_normalize(svec2_subtract(target->Pos, a->Pos)),
 				svec2(
-					RAND_FLOAT(-MELEE_SPREAD_FACTOR, MELEE_SPREAD_FACTOR),
-					RAND_FLOAT(-MELEE_SPREAD_FACTOR, MELEE_SPREAD_FACTOR))),
+					RAND_FLOAT(
+						RNG_GAMEPLAY, -MELEE_SPREAD_FACTOR,
+						MELEE_SPREAD_FACTOR),
+					RAND_FLOAT(
+						RNG_GAMEPLAY, -MELEE_SPREAD_FACTOR,
+						MELEE_SPREAD_FACTOR))),
 			MELEE_VEL_SCALE);
 		Damage(
 			vel, b, a->flags, a, (ThingKind)m.TargetKind, m.TargetUID);
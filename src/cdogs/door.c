@@ -567,6 +567,6 @@ static void DoorDrawPic(
 		svec2i(pic->size.x, pic->size.y - (crop ? dy + bottom : 0)));
 	Rect2i dest = Rect2iNew(svec2i_add(pos, offset), src.Size);
 	TextureRender(
-		pic->Tex, gGraphicsDevice.gameWindow.renderer, src, dest, mask, 0.0,
+		PicGetTex(pic), gGraphicsDevice.gameWindow.renderer, src, dest, mask, 0.0,
 		SDL_FLIP_NONE);
 }
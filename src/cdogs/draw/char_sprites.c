@@ -51,18 +51,35 @@ const CharSprites *StrCharSpriteClass(const char *s)
 	return StrCharSpriteClass("base");
 }
 
-void CharSpriteClassesInit(CharSpriteClasses *c)
+void CharSpriteClassesInitQueue(CharSpriteClasses *c, AssetLoader *l)
 {
 	memset(c, 0, sizeof *c);
 	c->classes = hashmap_new();
 	c->customClasses = hashmap_new();
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, "");
-	CharSpriteClassesLoadDir(c->classes, buf);
+	CharSpriteClassesQueueDir(l, c->classes, buf);
 }
 
 static CharSprites *CharSpritesLoadJSON(const char *name, const char *path);
-void CharSpriteClassesLoadDir(map_t classes, const char *path)
+static void *CharSpritesDecode(const AssetJob *job)
+{
+	return CharSpritesLoadJSON(job->Name, job->Path);
+}
+static void CharSpritesAdd(const AssetJob *job, void *data)
+{
+	const int error = hashmap_put(job->Maps[0], job->Name, data);
+	if (error != MAP_OK)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to add char sprites %s: %d",
+			job->Name, error);
+	}
+}
+static const AssetKind charSpritesAssetKind = {
+	"char sprites", CharSpritesDecode, CharSpritesAdd, NULL};
+
+void CharSpriteClassesQueueDir(
+	AssetLoader *l, map_t classes, const char *path)
 {
 	char buf[CDOGS_PATH_MAX];
 	sprintf(buf, "%s/graphics/chars/bodies", path);
@@ -85,18 +102,9 @@ void CharSpriteClassesLoadDir(map_t classes, const char *path)
 		{
 			continue;
 		}
-		CharSprites *c = CharSpritesLoadJSON(file.name, file.path);
-		if (c == NULL)
-		{
-			continue;
-		}
-		const int error = hashmap_put(classes, file.name, c);
-		if (error != MAP_OK)
-		{
-			LOG(LM_MAIN, LL_ERROR, "failed to add char sprites %s: %d",
-				file.name, error);
-			continue;
-		}
+		AssetLoaderQueue(
+			l, &charSpritesAssetKind, file.path, file.name, NULL, classes,
+			NULL);
 	}
 
 bail:
@@ -27,6 +27,7 @@
 */
 #pragma once
 
+#include "asset_loader.h"
 #include "c_hashmap/hashmap.h"
 #include "defs.h"
 #include "mathc/mathc.h"
@@ -54,8 +55,10 @@ extern CharSpriteClasses gCharSpriteClasses;
 
 const CharSprites *StrCharSpriteClass(const char *s);
 
-void CharSpriteClassesInit(CharSpriteClasses *c);
-void CharSpriteClassesLoadDir(map_t classes, const char *path);
+// Queue the classes to be loaded in AssetLoaderFinish
+void CharSpriteClassesInitQueue(CharSpriteClasses *c, AssetLoader *l);
+void CharSpriteClassesQueueDir(
+	AssetLoader *l, map_t classes, const char *path);
 void CharSpriteClassesClear(map_t classes);
 void CharSpriteClassesTerminate(CharSpriteClasses *c);
 
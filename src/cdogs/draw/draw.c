@@ -121,9 +121,15 @@ static void DrawLOSPic(
 
 static void DrawThing(
 	DrawBuffer *b, const Thing *t, const struct vec2i offset);
+static void DrawListRow(
+	DrawBuffer *b, const DrawList *l, const DrawLayer layer, const int y,
+	const struct vec2i offset);
 
+// Draw tiles row by row; if layer is valid, things in that layer are drawn
+// after each row, sorted by Y
 static void DrawTiles(
-	DrawBuffer *b, const struct vec2i offset,
+	DrawBuffer *b, const struct vec2i offset, const DrawList *l,
+	const DrawLayer layer,
 	void (*drawTileFunc)(
 		DrawBuffer *, const struct vec2i, const Tile *, const struct vec2i,
 		const bool))
@@ -135,32 +141,56 @@ static void DrawTiles(
 	for (y = 0, pos.y = b->dy + offset.y; y < Y_TILES;
 		 y++, pos.y += TILE_HEIGHT)
 	{
-		CArrayClear(&b->displaylist);
-		for (x = 0, pos.x = b->dx + offset.x; x < b->Size.x;
-			 x++, tile++, pos.x += TILE_WIDTH)
+		if (drawTileFunc != NULL)
 		{
-			if (*tile == NULL)
-				continue;
-			drawTileFunc(b, offset, *tile, pos, useFog);
+			for (x = 0, pos.x = b->dx + offset.x; x < b->Size.x;
+				 x++, tile++, pos.x += TILE_WIDTH)
+			{
+				if (*tile == NULL)
+					continue;
+				drawTileFunc(b, offset, *tile, pos, useFog);
+			}
+			tile += X_TILES - b->Size.x;
+		}
+		if (layer != DRAW_LAYER_COUNT)
+		{
+			DrawListRow(b, l, layer, y + b->yStart, offset);
 		}
-		DrawBufferSortDisplayList(b);
-		CA_FOREACH(const Thing *, tp, b->displaylist)
-		DrawThing(b, *tp, offset);
-		CA_FOREACH_END()
-		tile += X_TILES - b->Size.x;
+	}
+}
+static void DrawListRow(
+	DrawBuffer *b, const DrawList *l, const DrawLayer layer, const int y,
+	const struct vec2i offset)
+{
+	const int row = y - l->YStart;
+	if (row < 0 || row >= l->Rows)
+	{
+		return;
+	}
+	const int start = *(const int *)CArrayGet(&l->RowStarts[layer], row);
+	const int end = *(const int *)CArrayGet(&l->RowStarts[layer], row + 1);
+	// The list may be shared with other views; only draw things that are
+	// on this buffer's tiles and in its LOS
+	for (int i = start; i < end; i++)
+	{
+		const DrawListItem *item = CArrayGet(&l->Items[layer], i);
+		if (item->TileX < b->xStart || item->TileX >= b->xStart + b->Size.x)
+		{
+			continue;
+		}
+		const Tile *t = MapGetTile(&gMap, svec2i(item->TileX, y));
+		if (t->outOfSight)
+		{
+			continue;
+		}
+		DrawThing(b, item->Thing, offset);
 	}
 }
 
 static void DrawFloor(
 	DrawBuffer *b, const struct vec2i offset, const Tile *t,
 	const struct vec2i pos, const bool useFog);
-static void DrawThingsBelow(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawWallsAndThings(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawThingsAbove(
+static void DrawWalls(
 	DrawBuffer *b, const struct vec2i offset, const Tile *t,
 	const struct vec2i pos, const bool useFog);
 static void DrawObjectiveHighlights(
@@ -175,20 +205,27 @@ static void DrawExtra(
 void DrawBufferDraw(
 	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args)
 {
+	const DrawList *l = args->List;
+	if (l == NULL)
+	{
+		const Rect2i r = DrawBufferGetTileRect(b);
+		DrawListGather(&b->list, &gMap, &r, 1);
+		l = &b->list;
+	}
 	// First draw the floor tiles (which do not obstruct anything)
-	DrawTiles(b, offset, DrawFloor);
+	DrawTiles(b, offset, l, DRAW_LAYER_COUNT, DrawFloor);
 	// Then draw things that are below everything like debris (wrecks)
-	DrawTiles(b, offset, DrawThingsBelow);
+	DrawTiles(b, offset, l, DRAW_LAYER_BELOW, NULL);
 	// Now draw walls and (non-wreck) things in proper order
-	DrawTiles(b, offset, DrawWallsAndThings);
+	DrawTiles(b, offset, l, DRAW_LAYER_NORMAL, DrawWalls);
 	// Draw things that are above everything
-	DrawTiles(b, offset, DrawThingsAbove);
+	DrawTiles(b, offset, l, DRAW_LAYER_ABOVE, NULL);
 	if (args->HUD)
 	{
 		// Draw objective highlights, for visible and always-visible objectives
-		DrawTiles(b, offset, DrawObjectiveHighlights);
+		DrawTiles(b, offset, l, DRAW_LAYER_COUNT, DrawObjectiveHighlights);
 		// Draw actor chatter
-		DrawTiles(b, offset, DrawChatters);
+		DrawTiles(b, offset, l, DRAW_LAYER_COUNT, DrawChatters);
 	}
 	// Draw editor-only things
 	DrawExtra(b, offset, args);
@@ -207,30 +244,11 @@ static void DrawFloor(
 	}
 }
 
-static void DrawThingsBelow(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
-{
-	UNUSED(pos);
-	UNUSED(offset);
-	UNUSED(useFog);
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawBelow(ti))
-	{
-		CArrayPushBack(&b->displaylist, &ti);
-	}
-	CA_FOREACH_END()
-}
-
-static void DrawWallsAndThings(
+static void DrawWalls(
 	DrawBuffer *b, const struct vec2i offset, const Tile *t,
 	const struct vec2i pos, const bool useFog)
 {
+	UNUSED(b);
 	UNUSED(offset);
 	if (t->Class->Type == TILE_CLASS_WALL)
 	{
@@ -246,40 +264,6 @@ static void DrawWallsAndThings(
 			DoorDraw(&t->Door, pos, mask);
 		}
 	}
-
-	// Draw the items that are in LOS
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawBelow(ti) || ThingDrawAbove(ti))
-	{
-		continue;
-	}
-	CArrayPushBack(&b->displaylist, &ti);
-	CA_FOREACH_END()
-}
-
-static void DrawThingsAbove(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
-{
-	UNUSED(offset);
-	UNUSED(pos);
-	UNUSED(useFog);
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawAbove(ti))
-	{
-		CArrayPushBack(&b->displaylist, &ti);
-	}
-	CA_FOREACH_END()
 }
 
 static void DrawObjectiveHighlights(
@@ -610,7 +594,7 @@ static void DrawGuideImage(
 	color_t mask = colorWhite;
 	mask.a = alpha;
 	TextureRender(
-		guideImage->Tex, gGraphicsDevice.gameWindow.renderer, Rect2iZero(),
+		PicGetTex(guideImage), gGraphicsDevice.gameWindow.renderer, Rect2iZero(),
 		Rect2iNew(
 			pos, svec2i(
 					 (mint_t)MROUND(guideImage->size.x * xScale),
@@ -357,6 +357,31 @@ static ActorPics GetUnorderedPics(
 		GUNSTATE_READY);
 	return pics;
 }
+void PreloadCharacterSprites(const Character *c, const WeaponClass *gun)
+{
+	if (c->Class == NULL)
+	{
+		return;
+	}
+	// Sprite sheets contain every direction and frame, so only the
+	// animation and gun pose need to vary
+	const ActorAnimation anims[] = {ACTORANIMATION_IDLE, ACTORANIMATION_WALKING};
+	const gunstate_e states[] = {GUNSTATE_READY, GUNSTATE_FIRING};
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			gunstate_e barrelStates[MAX_BARRELS];
+			for (int k = 0; k < MAX_BARRELS; k++)
+			{
+				barrelStates[k] = states[j];
+			}
+			GetUnorderedPics(
+				c, DIRECTION_UP, DIRECTION_UP, anims[i], 0, gun,
+				barrelStates, false, colorTransparent, NULL, NULL, 0);
+		}
+	}
+}
 static direction_e GetLegDirAndFrame(
 	const TActor *a, const direction_e bodyDir, int *frame)
 {
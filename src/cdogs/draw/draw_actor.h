@@ -95,6 +95,8 @@ ActorPics GetCharacterPics(
 	const color_t shadowMask, const color_t *mask, const CharColors *colors,
 	const int deadPic);
 ActorPics GetCharacterPicsFromActor(const TActor *a);
+// Start masking the sprites a character uses with a gun, if not already
+void PreloadCharacterSprites(const Character *c, const WeaponClass *gun);
 void DrawActorPics(
 	const ActorPics *pics, const struct vec2i pos, const Rect2i bounds);
 void DrawLaserSight(
@@ -49,10 +49,10 @@
 #include "draw/draw_buffer.h"
 
 #include <assert.h>
+#include <limits.h>
 
 #include "algorithms.h"
 #include "log.h"
-#include "los.h"
 
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g)
@@ -60,13 +60,12 @@ void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g)
 	b->OrigSize = size;
 	CArrayInitFillZero(&b->tiles, sizeof(Tile *), size.x * size.y);
 	b->g = g;
-	CArrayInit(&b->displaylist, sizeof(const Thing *));
-	CArrayReserve(&b->displaylist, 32);
+	DrawListInit(&b->list);
 }
 void DrawBufferTerminate(DrawBuffer *b)
 {
 	CArrayTerminate(&b->tiles);
-	CArrayTerminate(&b->displaylist);
+	DrawListTerminate(&b->list);
 }
 
 void DrawBufferSetFromMap(
@@ -116,7 +115,19 @@ void DrawBufferSetFromMap(
 }
 
 // Set visibility and draw order for wall/door columns
-void DrawBufferFix(DrawBuffer *buffer)
+// los: of bool, one per map tile
+static void FixTiles(
+	DrawBuffer *buffer, const CArray *los, const LOSBits *losBits);
+void DrawBufferFix(DrawBuffer *buffer, const CArray *los)
+{
+	FixTiles(buffer, los, NULL);
+}
+void DrawBufferFixBits(DrawBuffer *buffer, const LOSBits *los)
+{
+	FixTiles(buffer, NULL, los);
+}
+static void FixTiles(
+	DrawBuffer *buffer, const CArray *los, const LOSBits *losBits)
 {
 	int tileIdx = 0;
 	for (int y = 0; y < Y_TILES; y++)
@@ -127,30 +138,143 @@ void DrawBufferFix(DrawBuffer *buffer)
 			if (*tile == NULL) continue;
 			const struct vec2i mapTile =
 				svec2i(x + buffer->xStart, y + buffer->yStart);
-			(*tile)->outOfSight = !LOSTileIsVisible(&gMap, mapTile);
+			const int i = mapTile.y * gMap.Size.x + mapTile.x;
+			(*tile)->outOfSight = losBits != NULL
+									  ? !LOSBitsGet(losBits, i)
+									  : !*(const bool *)CArrayGet(los, i);
 		}
 		tileIdx += X_TILES - buffer->Size.x;
 	}
 }
 
+Rect2i DrawBufferGetTileRect(const DrawBuffer *b)
+{
+	return Rect2iNew(
+		svec2i(b->xStart, b->yStart), svec2i(b->Size.x, b->OrigSize.y));
+}
+
+void DrawListInit(DrawList *l)
+{
+	memset(l, 0, sizeof *l);
+	for (DrawLayer layer = 0; layer < DRAW_LAYER_COUNT; layer++)
+	{
+		CArrayInit(&l->Items[layer], sizeof(DrawListItem));
+		CArrayReserve(&l->Items[layer], 32);
+		CArrayInit(&l->RowStarts[layer], sizeof(int));
+	}
+}
+void DrawListTerminate(DrawList *l)
+{
+	for (DrawLayer layer = 0; layer < DRAW_LAYER_COUNT; layer++)
+	{
+		CArrayTerminate(&l->Items[layer]);
+		CArrayTerminate(&l->RowStarts[layer]);
+	}
+}
+
+#define DRAW_LIST_MAX_RECTS 4
+static void GatherTile(DrawList *l, const Tile *t, const int x);
 static int CompareY(const void *v1, const void *v2);
-void DrawBufferSortDisplayList(DrawBuffer *buffer)
+void DrawListGather(
+	DrawList *l, const Map *map, const Rect2i *rects, const int numRects)
 {
-	qsort(
-		buffer->displaylist.data,
-		buffer->displaylist.size,
-		buffer->displaylist.elemSize,
-		CompareY);
+	CASSERT(numRects > 0 && numRects <= DRAW_LIST_MAX_RECTS, "too many rects");
+	// Sort rects from left to right so that overlapping columns on the same
+	// row are only gathered once
+	Rect2i sorted[DRAW_LIST_MAX_RECTS];
+	for (int i = 0; i < numRects; i++)
+	{
+		int j = i;
+		for (; j > 0 && sorted[j - 1].Pos.x > rects[i].Pos.x; j--)
+		{
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = rects[i];
+	}
+	l->YStart = sorted[0].Pos.y;
+	int yEnd = sorted[0].Pos.y + sorted[0].Size.y;
+	for (int i = 1; i < numRects; i++)
+	{
+		l->YStart = MIN(l->YStart, sorted[i].Pos.y);
+		yEnd = MAX(yEnd, sorted[i].Pos.y + sorted[i].Size.y);
+	}
+	l->Rows = yEnd - l->YStart;
+
+	for (DrawLayer layer = 0; layer < DRAW_LAYER_COUNT; layer++)
+	{
+		CArrayClear(&l->Items[layer]);
+		CArrayClear(&l->RowStarts[layer]);
+	}
+	for (int y = l->YStart; y < yEnd; y++)
+	{
+		int rowStarts[DRAW_LAYER_COUNT];
+		for (DrawLayer layer = 0; layer < DRAW_LAYER_COUNT; layer++)
+		{
+			rowStarts[layer] = (int)l->Items[layer].size;
+			CArrayPushBack(&l->RowStarts[layer], &rowStarts[layer]);
+		}
+		int xCovered = INT_MIN;
+		for (int i = 0; i < numRects; i++)
+		{
+			const Rect2i r = sorted[i];
+			if (y < r.Pos.y || y >= r.Pos.y + r.Size.y)
+			{
+				continue;
+			}
+			for (int x = MAX(xCovered, r.Pos.x); x < r.Pos.x + r.Size.x; x++)
+			{
+				const Tile *t = MapGetTile(map, svec2i(x, y));
+				if (t != NULL)
+				{
+					GatherTile(l, t, x);
+				}
+			}
+			xCovered = MAX(xCovered, r.Pos.x + r.Size.x);
+		}
+		for (DrawLayer layer = 0; layer < DRAW_LAYER_COUNT; layer++)
+		{
+			const int count = (int)l->Items[layer].size - rowStarts[layer];
+			if (count > 1)
+			{
+				qsort(
+					CArrayGet(&l->Items[layer], rowStarts[layer]), count,
+					l->Items[layer].elemSize, CompareY);
+			}
+		}
+	}
+	for (DrawLayer layer = 0; layer < DRAW_LAYER_COUNT; layer++)
+	{
+		const int end = (int)l->Items[layer].size;
+		CArrayPushBack(&l->RowStarts[layer], &end);
+	}
+}
+static void GatherTile(DrawList *l, const Tile *t, const int x)
+{
+	CA_FOREACH(const ThingId, tid, t->things)
+		DrawListItem item;
+		item.Thing = ThingIdGetThing(tid);
+		item.TileX = x;
+		DrawLayer layer = DRAW_LAYER_NORMAL;
+		if (ThingDrawBelow(item.Thing))
+		{
+			layer = DRAW_LAYER_BELOW;
+		}
+		else if (ThingDrawAbove(item.Thing))
+		{
+			layer = DRAW_LAYER_ABOVE;
+		}
+		CArrayPushBack(&l->Items[layer], &item);
+	CA_FOREACH_END()
 }
 static int CompareY(const void *v1, const void *v2)
 {
-	const Thing * const *t1 = v1;
-	const Thing * const *t2 = v2;
-	if ((*t1)->Pos.y < (*t2)->Pos.y)
+	const DrawListItem *i1 = v1;
+	const DrawListItem *i2 = v2;
+	if (i1->Thing->Pos.y < i2->Thing->Pos.y)
 	{
 		return -1;
 	}
-	else if ((*t1)->Pos.y >(*t2)->Pos.y)
+	else if (i1->Thing->Pos.y > i2->Thing->Pos.y)
 	{
 		return 1;
 	}
@@ -48,8 +48,40 @@
 */
 #pragma once
 
+#include "los.h"
 #include "map.h"
 
+// Things are drawn in three layers, each sorted by Y within a tile row
+typedef enum
+{
+	DRAW_LAYER_BELOW,
+	DRAW_LAYER_NORMAL,
+	DRAW_LAYER_ABOVE,
+	DRAW_LAYER_COUNT
+} DrawLayer;
+
+typedef struct
+{
+	const Thing *Thing;
+	int TileX;
+} DrawListItem;
+
+// Things gathered from a set of tile rects (one per camera view) and sorted
+// once per frame, so that split screen views only need to filter them
+typedef struct
+{
+	int YStart;
+	int Rows;
+	CArray Items[DRAW_LAYER_COUNT];		// of DrawListItem
+	CArray RowStarts[DRAW_LAYER_COUNT]; // of int, Rows + 1 entries
+} DrawList;
+
+void DrawListInit(DrawList *l);
+void DrawListTerminate(DrawList *l);
+// Gather and sort all things on tiles covered by the rects (in tiles)
+void DrawListGather(
+	DrawList *l, const Map *map, const Rect2i *rects, const int numRects);
+
 typedef struct
 {
 	GraphicsDevice *g;
@@ -59,7 +91,7 @@ typedef struct
 	struct vec2i OrigSize;
 	struct vec2i Size;	// size in tiles
 	CArray tiles;	// of Tile *
-	CArray displaylist;	// of const Thing *, to determine draw order
+	DrawList list;	// used if there is no shared draw list
 } DrawBuffer;
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g);
@@ -68,6 +100,7 @@ void DrawBufferTerminate(DrawBuffer *b);
 void DrawBufferSetFromMap(
 	DrawBuffer *buffer, const Map *map, const struct vec2 origin,
 	const int width);
-void DrawBufferFix(DrawBuffer *buffer);
-void DrawBufferSortDisplayList(DrawBuffer *buffer);
+void DrawBufferFix(DrawBuffer *buffer, const CArray *los);
+void DrawBufferFixBits(DrawBuffer *buffer, const LOSBits *los);
+Rect2i DrawBufferGetTileRect(const DrawBuffer *b);
 const Tile **DrawBufferGetFirstTile(const DrawBuffer *b);
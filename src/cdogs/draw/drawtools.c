@@ -53,6 +53,7 @@
 #include "log.h"
 #include "palette.h"
 #include "pic_manager.h"
+#include "render_queue.h"
 #include "texture.h"
 #include "utils.h"
 #include "blit.h"
@@ -61,6 +62,13 @@
 
 void DrawPoint(const struct vec2i pos, const color_t c)
 {
+	if (gRenderQueue.Recording)
+	{
+		RenderQueuePushShape(
+			&gRenderQueue, RENDER_CMD_POINT,
+			gGraphicsDevice.gameWindow.renderer, pos, pos, c);
+		return;
+	}
 	if (SDL_SetRenderDrawBlendMode(
 		gGraphicsDevice.gameWindow.renderer, SDL_BLENDMODE_BLEND) != 0)
 	{
@@ -167,6 +175,13 @@ void DrawRectangle(
 	GraphicsDevice *g, const struct vec2i pos, const struct vec2i size,
 	const color_t color, const bool filled)
 {
+	if (gRenderQueue.Recording)
+	{
+		RenderQueuePushShape(
+			&gRenderQueue, filled ? RENDER_CMD_FILL_RECT : RENDER_CMD_RECT,
+			g->gameWindow.renderer, pos, size, color);
+		return;
+	}
 	if (SDL_SetRenderDrawBlendMode(
 		g->gameWindow.renderer, SDL_BLENDMODE_BLEND) != 0)
 	{
@@ -192,6 +207,16 @@ void DrawRectangle(
 
 void DrawCross(GraphicsDevice *g, const struct vec2i pos, const color_t c)
 {
+	if (gRenderQueue.Recording)
+	{
+		RenderQueuePushShape(
+			&gRenderQueue, RENDER_CMD_LINE, g->gameWindow.renderer,
+			svec2i(pos.x - 1, pos.y), svec2i(pos.x + 1, pos.y), c);
+		RenderQueuePushShape(
+			&gRenderQueue, RENDER_CMD_LINE, g->gameWindow.renderer,
+			svec2i(pos.x, pos.y - 1), svec2i(pos.x, pos.y + 1), c);
+		return;
+	}
 	if (SDL_SetRenderDrawBlendMode(
 		g->gameWindow.renderer, SDL_BLENDMODE_BLEND) != 0)
 	{
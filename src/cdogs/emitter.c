@@ -61,16 +61,17 @@ void EmitterStart(Emitter *em, const AddParticle *data)
 	{
 		e.u.AddParticle.Class = em->p;
 	}
-	const float speed = RAND_FLOAT(em->minSpeed, em->maxSpeed);
+	const float speed = RAND_FLOAT(RNG_COSMETIC, em->minSpeed, em->maxSpeed);
 	const struct vec2 baseVel = svec2_rotate(
-		svec2(0, speed), RAND_FLOAT(0, MPI * 2));
+		svec2(0, speed), RAND_FLOAT(RNG_COSMETIC, 0, MPI * 2));
 	e.u.AddParticle.Vel = svec2_add(data->Vel, baseVel);
 	if (isnan(data->Angle))
 	{
-		e.u.AddParticle.Angle = RAND_FLOAT(0, MPI * 2);
+		e.u.AddParticle.Angle = RAND_FLOAT(RNG_COSMETIC, 0, MPI * 2);
 	}
-	e.u.AddParticle.DZ = RAND_FLOAT(em->minDZ, em->maxDZ);
-	e.u.AddParticle.Spin = RAND_DOUBLE(em->minRotation, em->maxRotation);
+	e.u.AddParticle.DZ = RAND_FLOAT(RNG_COSMETIC, em->minDZ, em->maxDZ);
+	e.u.AddParticle.Spin =
+		RAND_DOUBLE(RNG_COSMETIC, em->minRotation, em->maxRotation);
 	GameEventsEnqueue(&gGameEvents, e);
 }
 
@@ -606,17 +606,20 @@ const char *GetHomeDirectory(void)
  */
 char cfpath[CDOGS_PATH_MAX];
 const char *GetConfigFilePath(const char *name)
+{
+	GetConfigFilePathBuf(cfpath, name);
+	return cfpath;
+}
+void GetConfigFilePathBuf(char *buf, const char *name)
 {
 	const char *homedir = GetHomeDirectory();
 
-	strcpy(cfpath, homedir);
+	strcpy(buf, homedir);
 
 #ifndef __EMSCRIPTEN__
-	strcat(cfpath, CDOGS_CFG_DIR);
+	strcat(buf, CDOGS_CFG_DIR);
 #endif
-	strcat(cfpath, name);
-
-	return cfpath;
+	strcat(buf, name);
 }
 
 static bool doMkdir(const char *path)
@@ -655,6 +658,50 @@ bool mkdir_deep(const char *path)
 	return true;
 }
 
+char *ReadFileIntoBuf(const char *path, const char *mode, long *len)
+{
+	char *buf = NULL;
+	FILE *f = fopen(path, mode);
+	if (f == NULL)
+	{
+		goto bail;
+	}
+
+	// Read into buffer
+	if (fseek(f, 0L, SEEK_END) != 0)
+	{
+		goto bail;
+	}
+	*len = ftell(f);
+	if (*len == -1)
+	{
+		goto bail;
+	}
+	CCALLOC(buf, *len + 1);
+	if (fseek(f, 0L, SEEK_SET) != 0)
+	{
+		goto bail;
+	}
+	if (fread(buf, 1, *len, f) == 0)
+	{
+		goto bail;
+	}
+
+	goto end;
+
+bail:
+	CFREE(buf);
+	buf = NULL;
+
+end:
+	if (f != NULL && fclose(f) != 0)
+	{
+		LOG(LM_MAP, LL_ERROR, "Cannot close file %s: %s", path,
+			strerror(errno));
+	}
+	return buf;
+}
+
 void SetupConfigDir(void)
 {
 	const char *cfg_p = GetConfigFilePath("");
@@ -212,6 +212,8 @@ int LoadCampaignOld(const char *filename, CampaignSettingOld *setting);
 
 const char *GetHomeDirectory(void);
 const char *GetConfigFilePath(const char *name);
+// As above but into buf, so it can be used off the main thread
+void GetConfigFilePathBuf(char *buf, const char *name);
 
 void SetupConfigDir(void);
 
@@ -225,3 +227,5 @@ color_t RangeToColor(const int range);
 #define COLORRANGE_COUNT 27
 
 bool mkdir_deep(const char *path);
+// Read a whole file into a null-terminated buffer; free with CFREE
+char *ReadFileIntoBuf(const char *path, const char *mode, long *len);
@@ -37,14 +37,23 @@
 #include "blit.h"
 #include "log.h"
 #include "pic.h"
+#include "render_queue.h"
 #include "sys_config.h"
+#include "texture.h"
 #include "utils.h"
 
 
 #define FIRST_CHAR 0
 #define LAST_CHAR 255
+// Must be a power of 2
+#define LAYOUT_CACHE_SIZE 256
 
 Font gFont;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+// Scratch buffers for drawing glyph runs
+static CArray sVertices; // of SDL_Vertex
+static CArray sIndices;	 // of int
+#endif
 
 
 FontOpts FontOptsNew(void)
@@ -55,6 +64,7 @@ FontOpts FontOptsNew(void)
 	return opts;
 }
 
+static void MakeAtlas(Font *f);
 void FontLoad(
 	Font *f, const char *imgPath, const bool isProportional,
 	const struct vec2i spaceSize)
@@ -78,6 +88,7 @@ void FontLoad(
 	}
 
 	CArrayInit(&f->Chars, sizeof(Pic));
+	CArrayInitFillZero(&f->Layouts, sizeof(FontLayout), LAYOUT_CACHE_SIZE);
 
 	// Check that the image is big enough for the dimensions
 	const struct vec2i step = svec2i(
@@ -124,6 +135,44 @@ void FontLoad(
 		}
 	}
 	SDL_UnlockSurface(image);
+
+	MakeAtlas(f);
+}
+static void MakeAtlas(Font *f)
+{
+	CArrayInit(&f->AtlasRects, sizeof(Rect2i));
+	memset(&f->Atlas, 0, sizeof f->Atlas);
+	if (f->Chars.size == 0)
+	{
+		return;
+	}
+	// Pack the chars into a grid, the same way as the source image
+	struct vec2i cell = svec2i_zero();
+	CA_FOREACH(const Pic, p, f->Chars)
+		cell = svec2i_max(cell, p->size);
+	CA_FOREACH_END()
+	const int rows = ((int)f->Chars.size + f->Stride - 1) / f->Stride;
+	Pic *a = &f->Atlas;
+	a->size = svec2i(cell.x * f->Stride, cell.y * rows);
+	CCALLOC(a->Data, a->size.x * a->size.y * sizeof *a->Data);
+	CA_FOREACH(const Pic, p, f->Chars)
+		const Rect2i r = Rect2iNew(
+			svec2i(
+				(_ca_index % f->Stride) * cell.x,
+				(_ca_index / f->Stride) * cell.y),
+			p->size);
+		for (int y = 0; y < p->size.y; y++)
+		{
+			memcpy(
+				a->Data + r.Pos.x + (r.Pos.y + y) * a->size.x,
+				p->Data + y * p->size.x, p->size.x * sizeof *a->Data);
+		}
+		CArrayPushBack(&f->AtlasRects, &r);
+	CA_FOREACH_END()
+	if (PicIsNone(a) || !PicTryMakeTex(a))
+	{
+		LOG(LM_GFX, LL_ERROR, "Cannot make font atlas");
+	}
 }
 void FontTerminate(Font *f)
 {
@@ -131,11 +180,33 @@ void FontTerminate(Font *f)
 		PicFree(p);
 	CA_FOREACH_END()
 	CArrayTerminate(&f->Chars);
+	PicFree(&f->Atlas);
+	CArrayTerminate(&f->AtlasRects);
+	CA_FOREACH(FontLayout, l, f->Layouts)
+		CFREE(l->Str);
+		CArrayTerminate(&l->Glyphs);
+	CA_FOREACH_END()
+	CArrayTerminate(&f->Layouts);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	CArrayTerminate(&sVertices);
+	CArrayTerminate(&sIndices);
+#endif
+}
+
+static int GlyphIndex(const char c)
+{
+	const int idx = (uint8_t)c - FIRST_CHAR;
+	if (idx >= (int)gFont.Chars.size)
+	{
+		fprintf(stderr, "invalid char %d\n", idx);
+		return 0;
+	}
+	return idx;
 }
 
 int FontW(const char c)
 {
-	const Pic *p = CArrayGet(&gFont.Chars, (int)c - FIRST_CHAR);
+	const Pic *p = CArrayGet(&gFont.Chars, GlyphIndex(c));
 	return p->size.x + gFont.Gap.x;
 }
 int FontH(void)
@@ -146,9 +217,10 @@ struct vec2i FontChSize(const char c)
 {
 	return svec2i(FontW(c), FontH());
 }
+static const FontLayout *GetLayout(const char *s, const int width);
 int FontStrW(const char *s)
 {
-	return FontSubstrW(s, (int)strlen(s));
+	return GetLayout(s, 0)->Size.x;
 }
 int FontSubstrW(const char *s, int len)
 {
@@ -180,23 +252,7 @@ int FontStrH(const char *s)
 }
 struct vec2i FontStrSize(const char *s)
 {
-	struct vec2i size = svec2i_zero();
-	while (*s)
-	{
-		char *lineEnd = strchr(s, '\n');
-		size.y += FontH();
-		if (lineEnd)
-		{
-			size.x = MAX(size.x, FontSubstrW(s, (int)(lineEnd - s)));
-			s = lineEnd + 1;
-		}
-		else
-		{
-			size.x = MAX(size.x, FontStrW(s));
-			s += strlen(s);
-		}
-	}
-	return size;
+	return GetLayout(s, 0)->Size;
 }
 int FontStrNumLines(const char *s)
 {
@@ -218,55 +274,37 @@ struct vec2i FontCh(const char c, const struct vec2i pos)
 }
 struct vec2i FontChMask(const char c, const struct vec2i pos, const color_t mask)
 {
-	int idx = (int)c - FIRST_CHAR;
-	if (idx < 0)
+	const Rect2i *src = CArrayGet(&gFont.AtlasRects, GlyphIndex(c));
+	if (!svec2i_is_zero(src->Size))
 	{
-		idx += 256;
-	}
-	if (idx < FIRST_CHAR || idx > LAST_CHAR)
-	{
-		fprintf(stderr, "invalid char %d\n", idx);
-		idx = FIRST_CHAR;
+		TextureRender(
+			gFont.Atlas.Tex, gGraphicsDevice.gameWindow.renderer, *src,
+			Rect2iNew(pos, src->Size), mask, 0, SDL_FLIP_NONE);
 	}
-	const Pic *pic = CArrayGet(&gFont.Chars, idx);
-	PicRender(
-		pic, gGraphicsDevice.gameWindow.renderer, pos, mask, 0, svec2_one(),
-		SDL_FLIP_NONE, Rect2iZero());
 	// Add gap between characters
-	return svec2i(pos.x + pic->size.x + gFont.Gap.x, pos.y);
+	return svec2i(pos.x + src->Size.x + gFont.Gap.x, pos.y);
 }
 struct vec2i FontStr(const char *s, struct vec2i pos)
 {
 	return FontStrMask(s, pos, colorWhite);
 }
+static void DrawLayout(
+	const FontLayout *l, const struct vec2i pos, const color_t mask);
 struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask)
 {
 	if (s == NULL)
 	{
 		return pos;
 	}
-	int left = pos.x;
-	while (*s)
-	{
-		if (*s == '\n')
-		{
-			pos.x = left;
-			pos.y += FontH();
-		}
-		else
-		{
-			pos = FontChMask(*s, pos, mask);
-		}
-		s++;
-	}
-	return pos;
+	const FontLayout *l = GetLayout(s, 0);
+	DrawLayout(l, pos, mask);
+	return svec2i_add(pos, l->End);
 }
 struct vec2i FontStrMaskWrap(const char *s, struct vec2i pos, color_t mask, const int width)
 {
-	char buf[1024];
-	CASSERT(strlen(s) < 1024, "string too long to wrap");
-	FontSplitLines(s, buf, width);
-	return FontStrMask(buf, pos, mask);
+	const FontLayout *l = GetLayout(s, width);
+	DrawLayout(l, pos, mask);
+	return svec2i_add(pos, l->End);
 }
 static struct vec2i GetStrPos(const char *s, struct vec2i pos, const FontOpts opts);
 void FontStrOpt(const char *s, struct vec2i pos, const FontOpts opts)
@@ -412,3 +450,178 @@ struct vec2i Vec2iAligned(
 	}
 	return vAligned;
 }
+
+static uint32_t LayoutHash(const char *s, const int width);
+static void LayoutBuild(FontLayout *l, const char *s, const int width);
+// Get the layout of a string, from the cache if it was laid out before
+static const FontLayout *GetLayout(const char *s, const int width)
+{
+	const size_t idx = LayoutHash(s, width) & (LAYOUT_CACHE_SIZE - 1);
+	FontLayout *l = CArrayGet(&gFont.Layouts, idx);
+	if (l->Str == NULL || l->Width != width || strcmp(l->Str, s) != 0)
+	{
+		LayoutBuild(l, s, width);
+	}
+	return l;
+}
+static uint32_t LayoutHash(const char *s, const int width)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u ^ (uint32_t)width;
+	for (; *s; s++)
+	{
+		hash = (hash ^ (uint8_t)*s) * 16777619u;
+	}
+	return hash;
+}
+static void LayoutBuild(FontLayout *l, const char *s, const int width)
+{
+	CFREE(l->Str);
+	CSTRDUP(l->Str, s);
+	l->Width = width;
+	if (l->Glyphs.elemSize == 0)
+	{
+		CArrayInit(&l->Glyphs, sizeof(FontGlyph));
+	}
+	CArrayClear(&l->Glyphs);
+	char *wrapped = NULL;
+	if (width > 0)
+	{
+		// allow some slack for newlines
+		CMALLOC(wrapped, strlen(s) * 2 + 1);
+		FontSplitLines(s, wrapped, width);
+		s = wrapped;
+	}
+
+	l->Size = svec2i_zero();
+	struct vec2i pos = svec2i_zero();
+	for (; *s; s++)
+	{
+		if (*s == '\n')
+		{
+			// Every line takes up height, except for an empty last line
+			l->Size.y += FontH();
+			pos.x = 0;
+			pos.y += FontH();
+			continue;
+		}
+		FontGlyph g;
+		g.Ch = (uint8_t)GlyphIndex(*s);
+		g.Pos = pos;
+		CArrayPushBack(&l->Glyphs, &g);
+		pos.x += FontW(*s);
+		l->Size.x = MAX(l->Size.x, pos.x);
+		if (s[1] == '\0')
+		{
+			l->Size.y += FontH();
+		}
+	}
+	l->End = pos;
+	CFREE(wrapped);
+}
+
+static void DrawLayout(
+	const FontLayout *l, const struct vec2i pos, const color_t mask)
+{
+	const Pic *atlas = &gFont.Atlas;
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	if (l->Glyphs.size == 0 || atlas->Tex == NULL)
+	{
+		return;
+	}
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	// Submit the whole string as one batch of quads from the atlas
+	if (sVertices.elemSize == 0)
+	{
+		CArrayInit(&sVertices, sizeof(SDL_Vertex));
+		CArrayInit(&sIndices, sizeof(int));
+	}
+	CArrayClear(&sVertices);
+	CArrayClear(&sIndices);
+	const SDL_Color color = {mask.r, mask.g, mask.b, mask.a};
+	const struct vec2 texScale =
+		svec2(1.0f / (float)atlas->size.x, 1.0f / (float)atlas->size.y);
+	CA_FOREACH(const FontGlyph, g, l->Glyphs)
+		const Rect2i *src = CArrayGet(&gFont.AtlasRects, g->Ch);
+		if (svec2i_is_zero(src->Size))
+		{
+			continue;
+		}
+		const struct vec2i dst = svec2i_add(pos, g->Pos);
+		const int base = (int)sVertices.size;
+		// Corners in order: top-left, top-right, bottom-left, bottom-right
+		for (int i = 0; i < 4; i++)
+		{
+			const struct vec2i corner =
+				svec2i((i & 1) * src->Size.x, (i >> 1) * src->Size.y);
+			SDL_Vertex v;
+			v.position.x = (float)(dst.x + corner.x);
+			v.position.y = (float)(dst.y + corner.y);
+			v.color = color;
+			v.tex_coord.x = (float)(src->Pos.x + corner.x) * texScale.x;
+			v.tex_coord.y = (float)(src->Pos.y + corner.y) * texScale.y;
+			CArrayPushBack(&sVertices, &v);
+		}
+		const int quad[] = {0, 1, 2, 1, 3, 2};
+		for (int i = 0; i < 6; i++)
+		{
+			const int idx = base + quad[i];
+			CArrayPushBack(&sIndices, &idx);
+		}
+	CA_FOREACH_END()
+	if (sVertices.size > 0 && gRenderQueue.Recording)
+	{
+		RenderQueuePushGeometry(
+			&gRenderQueue, r, atlas->Tex, sVertices.data, (int)sVertices.size,
+			sIndices.data, (int)sIndices.size);
+	}
+	else if (sVertices.size > 0 &&
+		SDL_RenderGeometry(
+			r, atlas->Tex, sVertices.data, (int)sVertices.size,
+			sIndices.data, (int)sIndices.size) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to render text: %s", SDL_GetError());
+	}
+#else
+	if (gRenderQueue.Recording)
+	{
+		CA_FOREACH(const FontGlyph, g, l->Glyphs)
+			const Rect2i *src = CArrayGet(&gFont.AtlasRects, g->Ch);
+			if (!svec2i_is_zero(src->Size))
+			{
+				TextureRender(
+					atlas->Tex, r, *src,
+					Rect2iNew(svec2i_add(pos, g->Pos), src->Size), mask, 0,
+					SDL_FLIP_NONE);
+			}
+		CA_FOREACH_END()
+		return;
+	}
+	// Render each glyph from the atlas; since they share the same texture
+	// and state, SDL can still batch them
+	if (SDL_SetTextureColorMod(atlas->Tex, mask.r, mask.g, mask.b) != 0 ||
+		SDL_SetTextureAlphaMod(atlas->Tex, mask.a) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to set texture mask: %s",
+			SDL_GetError());
+	}
+	CA_FOREACH(const FontGlyph, g, l->Glyphs)
+		const Rect2i *src = CArrayGet(&gFont.AtlasRects, g->Ch);
+		if (svec2i_is_zero(src->Size))
+		{
+			continue;
+		}
+		const struct vec2i dst = svec2i_add(pos, g->Pos);
+		const SDL_Rect srcRect = {
+			src->Pos.x, src->Pos.y, src->Size.x, src->Size.y
+		};
+		const SDL_Rect dstRect = {dst.x, dst.y, src->Size.x, src->Size.y};
+		if (SDL_RenderCopy(r, atlas->Tex, &srcRect, &dstRect) != 0)
+		{
+			LOG(LM_GFX, LL_ERROR, "Failed to render text: %s",
+				SDL_GetError());
+		}
+	CA_FOREACH_END()
+	SDL_SetTextureAlphaMod(atlas->Tex, 255);
+#endif
+}
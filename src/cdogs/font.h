@@ -28,6 +28,7 @@
 #include <SDL_surface.h>
 
 #include "c_array.h"
+#include "pic.h"
 #include "vector.h"
 
 #define ARROW_LEFT "\x11"
@@ -37,6 +38,21 @@
 
 // Defines interfaces for bitmap fonts
 
+typedef struct
+{
+	uint8_t Ch;
+	struct vec2i Pos; // relative to the start of the string
+} FontGlyph;
+// Cached positions of all the glyphs in a string
+typedef struct
+{
+	char *Str;
+	int Width; // wrap width, or 0 for no wrapping
+	struct vec2i Size;
+	struct vec2i End; // cursor position after the last glyph
+	CArray Glyphs;	  // of FontGlyph
+} FontLayout;
+
 typedef struct
 {
 	struct vec2i Size;
@@ -50,6 +66,11 @@ typedef struct
 	} Padding;
 	struct vec2i Gap;
 	CArray Chars; // of Pic
+	// All the chars packed into one texture, so that strings can be drawn
+	// in a single batch
+	Pic Atlas;
+	CArray AtlasRects; // of Rect2i, one per char
+	CArray Layouts;	   // of FontLayout, direct-mapped cache
 } Font;
 
 typedef enum
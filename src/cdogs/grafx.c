@@ -69,6 +69,7 @@
 #include "grafx_bg.h"
 #include "log.h"
 #include "palette.h"
+#include "render_queue.h"
 #include "files.h"
 #include "utils.h"
 
@@ -80,6 +81,7 @@ void GraphicsInit(GraphicsDevice *device, Config *c)
 	memset(device, 0, sizeof *device);
 	GraphicsConfigSetFromConfig(&device->cachedConfig, c);
 	device->cachedConfig.RestartFlags = RESTART_ALL;
+	RenderQueueInit(&gRenderQueue);
 }
 
 // Initialises the video subsystem.
@@ -302,6 +304,7 @@ void GraphicsTerminate(GraphicsDevice *g)
 	SDL_FreeFormat(g->Format);
 	SDL_VideoQuit();
 	CFREE(g->buf);
+	RenderQueueTerminate(&gRenderQueue);
 }
 
 int GraphicsGetScreenSize(GraphicsConfig *config)
@@ -367,10 +370,18 @@ void GraphicsConfigSetFromConfig(GraphicsConfig *gc, Config *c)
 		(ScaleMode)ConfigGetEnum(c, "Graphics.ScaleMode"),
 		ConfigGetInt(c, "Graphics.Brightness"),
 		ConfigGetBool(c, "Graphics.SecondWindow"));
+	// Takes effect without restarting, at the next eviction
+	gTextureResidency.Budget =
+		(size_t)ConfigGetInt(c, "Graphics.TextureBudget") * 1024 * 1024;
 }
 
 void GraphicsSetClip(SDL_Renderer *renderer, const Rect2i r)
 {
+	if (gRenderQueue.Recording)
+	{
+		RenderQueuePushClip(&gRenderQueue, renderer, r);
+		return;
+	}
 	const SDL_Rect rect = { r.Pos.x, r.Pos.y, r.Size.x, r.Size.y };
 	if (SDL_RenderSetClipRect(renderer, Rect2iIsZero(r) ? NULL : &rect) != 0)
 	{
@@ -380,6 +391,10 @@ void GraphicsSetClip(SDL_Renderer *renderer, const Rect2i r)
 
 Rect2i GraphicsGetClip(SDL_Renderer *renderer)
 {
+	if (gRenderQueue.Recording)
+	{
+		return gRenderQueue.Clip;
+	}
 	SDL_Rect rect;
 	SDL_RenderGetClipRect(renderer, &rect);
 	return Rect2iNew(svec2i(rect.x, rect.y), svec2i(rect.w, rect.h));
@@ -387,6 +402,11 @@ Rect2i GraphicsGetClip(SDL_Renderer *renderer)
 
 void GraphicsResetClip(SDL_Renderer *renderer)
 {
+	if (gRenderQueue.Recording)
+	{
+		RenderQueuePushClip(&gRenderQueue, renderer, Rect2iZero());
+		return;
+	}
 	if (SDL_RenderSetClipRect(renderer, NULL) != 0)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Could not reset clip rect: %s", SDL_GetError());
@@ -106,7 +106,9 @@ void GrafxRedrawBackground(GraphicsDevice *g, const struct vec2 pos)
 	memset(g->buf, 0, GraphicsGetMemSize(&g->cachedConfig));
 	DrawBuffer buffer;
 	DrawBufferInit(&buffer, svec2i(X_TILES, Y_TILES), g);
-	const HSV tint = {rand() * 360.0 / RAND_MAX, rand() * 1.0 / RAND_MAX, 0.5};
+	const HSV tint = {
+		RAND_DOUBLE(RNG_COSMETIC, 0, 360), RAND_DOUBLE(RNG_COSMETIC, 0, 1),
+		0.5};
 	DrawBufferArgs args;
 	memset(&args, 0, sizeof args);
 	GrafxDrawBackground(g, &buffer, tint, pos, &args);
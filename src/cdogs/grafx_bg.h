@@ -37,6 +37,9 @@ typedef struct
 	const Pic *GuideImage;
 	uint8_t GuideImageAlpha;
 	bool HUD;
+	// Things already gathered for this buffer's tiles, e.g. shared between
+	// split screen views; if NULL, the buffer gathers its own
+	const DrawList *List;
 } DrawBufferArgs;
 
 void GrafxDrawBackground(
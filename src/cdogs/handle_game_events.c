@@ -102,6 +102,7 @@ static void HandleGameEvent(
 				pos.y++;
 			}
 		}
+		SoundOcclusionInvalidate(&gSoundDevice.occlusion);
 	}
 	break;
 	case GAME_EVENT_THING_DAMAGE:
@@ -523,6 +524,7 @@ static void HandleGameEvent(
 	case GAME_EVENT_DOOR_TOGGLE: {
 		Tile *t = MapGetTile(&gMap, Net2Vec2i(e.u.DoorToggle.Pos));
 		DoorStateInit(&t->Door, e.u.DoorToggle.IsOpen);
+		SoundOcclusionInvalidate(&gSoundDevice.occlusion);
 	}
 	break;
 	case GAME_EVENT_MISSION_COMPLETE:
@@ -0,0 +1,163 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "hot_reload.h"
+
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "bullet_class.h"
+#include "character_class.h"
+#include "config.h"
+#include "files.h"
+#include "log.h"
+#include "particle.h"
+#include "weapon_class.h"
+
+// Check the files about once a second
+#define CHECK_TICKS FPS_FRAMELIMIT
+
+HotReload gHotReload;
+
+static bool ReloadParticles(json_t *root)
+{
+	return ParticleClassesReloadJSON(&gParticleClasses.Classes, root);
+}
+static bool ReloadBullets(json_t *root)
+{
+	return BulletReloadJSON(&gBulletClasses, root);
+}
+static bool ReloadGuns(json_t *root)
+{
+	return WeaponClassesReloadJSON(&gWeaponClasses, root);
+}
+static bool ReloadCharacters(json_t *root)
+{
+	return CharacterClassesReloadJSON(&gCharacterClasses.Classes, root);
+}
+
+static bool StatFile(const char *path, int64_t *mtime, int64_t *size)
+{
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return false;
+	}
+	*mtime = (int64_t)st.st_mtime;
+	*size = (int64_t)st.st_size;
+	return true;
+}
+
+static void AddFile(HotReload *h, const char *path, bool (*reload)(json_t *))
+{
+	HotReloadFile f;
+	memset(&f, 0, sizeof f);
+	f.Path = path;
+	f.Reload = reload;
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, path);
+	StatFile(buf, &f.MTime, &f.Size);
+	CArrayPushBack(&h->Files, &f);
+}
+void HotReloadInit(HotReload *h)
+{
+	memset(h, 0, sizeof *h);
+	CArrayInit(&h->Files, sizeof(HotReloadFile));
+	if (!ConfigGetBool(&gConfig, "HotReload"))
+	{
+		return;
+	}
+	// Particles first, as bullets and guns refer to them
+	AddFile(h, "data/particles.json", ReloadParticles);
+	AddFile(h, "data/bullets.json", ReloadBullets);
+	AddFile(h, "data/guns.json", ReloadGuns);
+	AddFile(h, "data/character_classes.json", ReloadCharacters);
+	LOG(LM_MAIN, LL_INFO, "watching %d data files for changes",
+		(int)h->Files.size);
+}
+void HotReloadTerminate(HotReload *h)
+{
+	CArrayTerminate(&h->Files);
+}
+
+static void ReloadFile(const HotReloadFile *f, const char *path);
+void HotReloadUpdate(HotReload *h, const int ticks)
+{
+	if (h->Files.size == 0)
+	{
+		return;
+	}
+	h->TicksUntilCheck -= ticks;
+	if (h->TicksUntilCheck > 0)
+	{
+		return;
+	}
+	h->TicksUntilCheck = CHECK_TICKS;
+	CA_FOREACH(HotReloadFile, f, h->Files)
+	char buf[CDOGS_PATH_MAX];
+	GetDataFilePath(buf, f->Path);
+	int64_t mtime, size;
+	if (!StatFile(buf, &mtime, &size) ||
+		(mtime == f->MTime && size == f->Size))
+	{
+		continue;
+	}
+	// Remember even if the reload fails, so that a bad file is only
+	// reported once per change
+	f->MTime = mtime;
+	f->Size = size;
+	ReloadFile(f, buf);
+	CA_FOREACH_END()
+}
+static void ReloadFile(const HotReloadFile *f, const char *path)
+{
+	long len;
+	char *buf = ReadFileIntoBuf(path, "rb", &len);
+	if (buf == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot read %s; not reloaded", path);
+		return;
+	}
+	json_t *root = NULL;
+	const enum json_error e = json_parse_buffer(&root, buf, (size_t)len);
+	if (e != JSON_OK)
+	{
+		LOG(LM_MAIN, LL_ERROR, "error parsing %s [error %d]; not reloaded",
+			path, (int)e);
+	}
+	else if (!f->Reload(root))
+	{
+		LOG(LM_MAIN, LL_ERROR, "invalid data in %s; not reloaded", path);
+	}
+	else
+	{
+		LOG(LM_MAIN, LL_INFO, "reloaded %s", path);
+	}
+	json_free_value(&root);
+	CFREE(buf);
+}
@@ -0,0 +1,62 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <json/json.h>
+
+#include "c_array.h"
+
+// Reload the built-in class data files (particles, bullets, guns and
+// character classes) when they change on disk, to tune them in a running
+// game. Changed files are parsed and checked, then their classes are patched
+// in place by name, so that the pointers held by actors, bullets and
+// particles stay valid. New classes need a restart to be added, and removed
+// classes keep their old definitions.
+typedef struct
+{
+	const char *Path; // relative to the data dir
+	bool (*Reload)(json_t *root);
+	int64_t MTime;
+	int64_t Size;
+} HotReloadFile;
+typedef struct
+{
+	CArray Files; // of HotReloadFile
+	int TicksUntilCheck;
+} HotReload;
+extern HotReload gHotReload;
+
+// Start watching the data files if enabled by the HotReload config
+void HotReloadInit(HotReload *h);
+void HotReloadTerminate(HotReload *h);
+// Check for changed files every so often and reload them.
+// Call between frames, when nothing is using the classes.
+void HotReloadUpdate(HotReload *h, const int ticks);
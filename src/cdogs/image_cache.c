@@ -0,0 +1,349 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "image_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <SDL_thread.h>
+#include <tinydir/tinydir.h>
+
+#include "files.h"
+#include "log.h"
+#include "pic.h"
+#include "utils.h"
+
+#define ENTRY_MAGIC 0x43494443 // "CDIC"
+// Bump when the layout of an entry changes
+#define ENTRY_VERSION 1
+#define ENTRY_EXT "cdogspx"
+
+ImageCache gImageCache;
+
+typedef struct
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t Key;
+	uint32_t Count;
+	uint32_t Pad;
+	uint64_t Checksum; // of everything after the header
+} EntryHeader;
+// Followed by the pixels of each pic in turn
+typedef struct
+{
+	int32_t W;
+	int32_t H;
+	int32_t OffsetX;
+	int32_t OffsetY;
+} EntryPic;
+
+static void GetEntryPath(char *buf, const ImageCache *c, const uint64_t key)
+{
+	sprintf(
+		buf, "%s/%016llx." ENTRY_EXT, c->Dir, (unsigned long long)key);
+}
+
+typedef struct
+{
+	char *Path;
+	uint64_t Size;
+	int64_t MTime;
+} CacheFile;
+static int CompareMTime(const void *v1, const void *v2)
+{
+	const CacheFile *f1 = v1;
+	const CacheFile *f2 = v2;
+	return f1->MTime < f2->MTime ? -1 : f1->MTime > f2->MTime ? 1 : 0;
+}
+void ImageCacheInit(ImageCache *c, const char *dir, const uint64_t maxBytes)
+{
+	memset(c, 0, sizeof *c);
+	if (maxBytes == 0)
+	{
+		return;
+	}
+	if (!mkdir_deep(dir))
+	{
+		LOG(LM_GFX, LL_WARN, "cannot create image cache dir %s", dir);
+		return;
+	}
+	strcpy(c->Dir, dir);
+	c->MaxBytes = maxBytes;
+
+	// Find the entries, and leftovers from interrupted writes
+	CArray files; // of CacheFile
+	CArrayInit(&files, sizeof(CacheFile));
+	uint64_t total = 0;
+	tinydir_dir d;
+	if (tinydir_open(&d, dir) == -1)
+	{
+		LOG(LM_GFX, LL_WARN, "cannot open image cache dir %s: %s", dir,
+			strerror(errno));
+		goto bail;
+	}
+	for (; d.has_next; tinydir_next(&d))
+	{
+		tinydir_file file;
+		if (tinydir_readfile(&d, &file) == -1 || !file.is_reg)
+		{
+			continue;
+		}
+		if (strcmp(file.extension, "tmp") == 0)
+		{
+			remove(file.path);
+			continue;
+		}
+		struct stat st;
+		if (strcmp(file.extension, ENTRY_EXT) != 0 ||
+			stat(file.path, &st) != 0)
+		{
+			continue;
+		}
+		CacheFile f;
+		CSTRDUP(f.Path, file.path);
+		f.Size = (uint64_t)st.st_size;
+		f.MTime = (int64_t)st.st_mtime;
+		CArrayPushBack(&files, &f);
+		total += f.Size;
+	}
+	tinydir_close(&d);
+
+	// Entries are touched when used, so the oldest are the least used
+	if (total > maxBytes)
+	{
+		qsort(files.data, files.size, files.elemSize, CompareMTime);
+		int removed = 0;
+		CA_FOREACH(const CacheFile, f, files)
+		if (total <= maxBytes - maxBytes / 4)
+		{
+			break;
+		}
+		if (remove(f->Path) == 0)
+		{
+			total -= f->Size;
+			removed++;
+		}
+		CA_FOREACH_END()
+		LOG(LM_GFX, LL_DEBUG, "pruned %d image cache entries", removed);
+	}
+	SDL_AtomicSet(&c->KBytes, (int)(total / 1024));
+
+bail:
+	CA_FOREACH(CacheFile, f, files)
+	CFREE(f->Path);
+	CA_FOREACH_END()
+	CArrayTerminate(&files);
+}
+void ImageCacheTerminate(ImageCache *c)
+{
+	if (!ImageCacheIsEnabled(c))
+	{
+		return;
+	}
+	LOG(LM_GFX, LL_INFO,
+		"image cache: %d hits, %d misses, %d writes, %d corrupt; %.1fMB",
+		SDL_AtomicGet(&c->Stats.Hits), SDL_AtomicGet(&c->Stats.Misses),
+		SDL_AtomicGet(&c->Stats.Writes), SDL_AtomicGet(&c->Stats.Corrupt),
+		SDL_AtomicGet(&c->KBytes) / 1024.0);
+	memset(c, 0, sizeof *c);
+}
+bool ImageCacheIsEnabled(const ImageCache *c)
+{
+	return c->MaxBytes > 0;
+}
+
+uint64_t ImageCacheKey(const void *data, const size_t size, const uint64_t seed)
+{
+	return HashBytes(data, size, seed);
+}
+
+static bool ParseEntry(
+	const uint8_t *data, const size_t size, const uint64_t key, CArray *pics);
+bool ImageCacheLoad(ImageCache *c, const uint64_t key, CArray *pics)
+{
+	if (!ImageCacheIsEnabled(c))
+	{
+		return false;
+	}
+	char path[CDOGS_PATH_MAX];
+	GetEntryPath(path, c, key);
+	long len;
+	char *buf = ReadFileIntoBuf(path, "rb", &len);
+	if (buf == NULL)
+	{
+		SDL_AtomicAdd(&c->Stats.Misses, 1);
+		return false;
+	}
+	const bool ok = ParseEntry((const uint8_t *)buf, (size_t)len, key, pics);
+	CFREE(buf);
+	if (!ok)
+	{
+		LOG(LM_GFX, LL_WARN, "corrupt image cache entry %s", path);
+		SDL_AtomicAdd(&c->Stats.Corrupt, 1);
+		SDL_AtomicAdd(&c->Stats.Misses, 1);
+		SDL_AtomicAdd(&c->KBytes, -(int)(len / 1024));
+		remove(path);
+		return false;
+	}
+	SDL_AtomicAdd(&c->Stats.Hits, 1);
+	// Mark as recently used, for pruning
+	utime(path, NULL);
+	return true;
+}
+static bool ParseEntry(
+	const uint8_t *data, const size_t size, const uint64_t key, CArray *pics)
+{
+	const EntryHeader *h = (const EntryHeader *)data;
+	if (size < sizeof *h || h->Magic != ENTRY_MAGIC ||
+		h->Version != ENTRY_VERSION || h->Key != key ||
+		(size - sizeof *h) / sizeof(EntryPic) < h->Count ||
+		HashBytes(data + sizeof *h, size - sizeof *h, 0) != h->Checksum)
+	{
+		return false;
+	}
+	const EntryPic *eps = (const EntryPic *)(h + 1);
+	const uint8_t *pixels = (const uint8_t *)(eps + h->Count);
+	const uint8_t *end = data + size;
+	const size_t start = pics->size;
+	for (uint32_t i = 0; i < h->Count; i++)
+	{
+		const EntryPic *ep = &eps[i];
+		const size_t n = (size_t)ep->W * (size_t)ep->H;
+		if (ep->W <= 0 || ep->H <= 0 ||
+			n * sizeof(Uint32) > (size_t)(end - pixels))
+		{
+			goto bail;
+		}
+		Pic p;
+		memset(&p, 0, sizeof p);
+		p.size = svec2i(ep->W, ep->H);
+		p.offset = svec2i(ep->OffsetX, ep->OffsetY);
+		CMALLOC(p.Data, n * sizeof *p.Data);
+		memcpy(p.Data, pixels, n * sizeof *p.Data);
+		pixels += n * sizeof *p.Data;
+		CArrayPushBack(pics, &p);
+	}
+	if (pixels == end)
+	{
+		return true;
+	}
+
+bail:
+	for (size_t i = start; i < pics->size; i++)
+	{
+		Pic *p = CArrayGet(pics, i);
+		CFREE(p->Data);
+	}
+	CArrayResize(pics, start, NULL);
+	return false;
+}
+
+void ImageCacheStore(ImageCache *c, const uint64_t key, const CArray *pics)
+{
+	if (!ImageCacheIsEnabled(c))
+	{
+		return;
+	}
+	size_t size = sizeof(EntryHeader) + pics->size * sizeof(EntryPic);
+	CA_FOREACH(const Pic, p, *pics)
+	if (p->Data == NULL)
+	{
+		return;
+	}
+	size += (size_t)(p->size.x * p->size.y) * sizeof *p->Data;
+	CA_FOREACH_END()
+	// Stop adding when full; pruned on the next start
+	if ((uint64_t)SDL_AtomicGet(&c->KBytes) * 1024 + size > c->MaxBytes)
+	{
+		return;
+	}
+
+	uint8_t *data;
+	CMALLOC(data, size);
+	EntryHeader *h = (EntryHeader *)data;
+	memset(h, 0, sizeof *h);
+	h->Magic = ENTRY_MAGIC;
+	h->Version = ENTRY_VERSION;
+	h->Key = key;
+	h->Count = (uint32_t)pics->size;
+	EntryPic *eps = (EntryPic *)(h + 1);
+	uint8_t *pixels = (uint8_t *)(eps + pics->size);
+	CA_FOREACH(const Pic, p, *pics)
+	EntryPic *ep = &eps[_ca_index];
+	ep->W = p->size.x;
+	ep->H = p->size.y;
+	ep->OffsetX = p->offset.x;
+	ep->OffsetY = p->offset.y;
+	const size_t n = (size_t)(p->size.x * p->size.y) * sizeof *p->Data;
+	memcpy(pixels, p->Data, n);
+	pixels += n;
+	CA_FOREACH_END()
+	h->Checksum = HashBytes(data + sizeof *h, size - sizeof *h, 0);
+
+	// Write to a temporary file first so a partial entry is never loaded;
+	// unique per thread in case two threads store the same image
+	char path[CDOGS_PATH_MAX];
+	GetEntryPath(path, c, key);
+	char tmp[CDOGS_PATH_MAX];
+	sprintf(tmp, "%s.%lu.tmp", path, (unsigned long)SDL_ThreadID());
+	FILE *f = fopen(tmp, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_GFX, LL_WARN, "cannot write image cache %s: %s", tmp,
+			strerror(errno));
+		goto bail;
+	}
+	const bool written = fwrite(data, 1, size, f) == size;
+	if (fclose(f) != 0 || !written)
+	{
+		LOG(LM_GFX, LL_WARN, "cannot write image cache %s", tmp);
+		remove(tmp);
+		goto bail;
+	}
+	remove(path);
+	if (rename(tmp, path) != 0)
+	{
+		remove(tmp);
+		goto bail;
+	}
+	SDL_AtomicAdd(&c->KBytes, (int)(size / 1024));
+	SDL_AtomicAdd(&c->Stats.Writes, 1);
+
+bail:
+	CFREE(data);
+}
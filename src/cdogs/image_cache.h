@@ -0,0 +1,71 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <SDL_atomic.h>
+
+#include "c_array.h"
+#include "sys_config.h"
+
+// Decoded and masked images, cached on disk in the renderer's pixel format.
+// Each entry is a file named by a key, which hashes the source bytes and
+// everything else that the pixels depend on; a changed source gets a new
+// key, and stale entries are pruned oldest first when over the size limit.
+// Safe to use from loader threads.
+typedef struct
+{
+	char Dir[CDOGS_PATH_MAX];
+	uint64_t MaxBytes; // 0 to disable
+	SDL_atomic_t KBytes;
+	struct
+	{
+		SDL_atomic_t Hits;
+		SDL_atomic_t Misses;
+		SDL_atomic_t Writes;
+		SDL_atomic_t Corrupt;
+	} Stats;
+} ImageCache;
+extern ImageCache gImageCache;
+
+// Set up a cache in dir, pruning it to maxBytes
+void ImageCacheInit(ImageCache *c, const char *dir, const uint64_t maxBytes);
+void ImageCacheTerminate(ImageCache *c);
+bool ImageCacheIsEnabled(const ImageCache *c);
+
+// Key for images decoded from data, or derived from an image with key seed
+uint64_t ImageCacheKey(const void *data, const size_t size, const uint64_t seed);
+
+// Load the pics (of Pic, without textures) cached under key, appending them.
+// Returns false if there is no valid entry.
+bool ImageCacheLoad(ImageCache *c, const uint64_t key, CArray *pics);
+// Cache pics (of Pic) under key
+void ImageCacheStore(ImageCache *c, const uint64_t key, const CArray *pics);
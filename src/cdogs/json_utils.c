@@ -100,6 +100,15 @@ void AddIntArray(json_t *parent, const char *name, const CArray *a)
 	json_insert_pair_into_object(parent, name, node);
 }
 
+int JSONGetInt(const json_t *node)
+{
+	return node->type == JSON_NUMBER ? (int)node->number : atoi(node->text);
+}
+double JSONGetNumber(const json_t *node)
+{
+	return node->type == JSON_NUMBER ? node->number : atof(node->text);
+}
+
 bool TryLoadValue(json_t **node, const char *name)
 {
 	if (*node == NULL || (*node)->type != JSON_OBJECT)
@@ -132,7 +141,7 @@ void LoadInt(int *value, json_t *node, const char *name)
 	{
 		return;
 	}
-	*value = atoi(node->text);
+	*value = JSONGetInt(node);
 }
 void LoadDouble(double *value, json_t *node, const char *name)
 {
@@ -140,7 +149,7 @@ void LoadDouble(double *value, json_t *node, const char *name)
 	{
 		return;
 	}
-	*value = atof(node->text);
+	*value = JSONGetNumber(node);
 }
 void LoadFloat(float *value, json_t *node, const char *name)
 {
@@ -148,7 +157,7 @@ void LoadFloat(float *value, json_t *node, const char *name)
 	{
 		return;
 	}
-	*value = strtof(node->text, NULL);
+	*value = (float)JSONGetNumber(node);
 }
 void LoadFullInt(float *value, json_t *node, const char *name)
 {
@@ -156,7 +165,7 @@ void LoadFullInt(float *value, json_t *node, const char *name)
 	{
 		return;
 	}
-	const int fullValue = atoi(node->text);
+	const int fullValue = JSONGetInt(node);
 	*value = fullValue / 256.0f;
 }
 void LoadVec2i(struct vec2i *value, json_t *node, const char *name)
@@ -166,9 +175,9 @@ void LoadVec2i(struct vec2i *value, json_t *node, const char *name)
 		return;
 	}
 	node = node->child;
-	value->x = atoi(node->text);
+	value->x = JSONGetInt(node);
 	node = node->next;
-	value->y = atoi(node->text);
+	value->y = JSONGetInt(node);
 }
 void LoadVec2(struct vec2 *value, json_t *node, const char *name)
 {
@@ -177,9 +186,9 @@ void LoadVec2(struct vec2 *value, json_t *node, const char *name)
 		return;
 	}
 	node = node->child;
-	value->x = strtof(node->text, NULL);
+	value->x = (float)JSONGetNumber(node);
 	node = node->next;
-	value->y = strtof(node->text, NULL);
+	value->y = (float)JSONGetNumber(node);
 }
 void LoadRect2i(Rect2i *value, json_t *node, const char *name)
 {
@@ -188,13 +197,13 @@ void LoadRect2i(Rect2i *value, json_t *node, const char *name)
 		return;
 	}
 	node = node->child;
-	value->Pos.x = atoi(node->text);
+	value->Pos.x = JSONGetInt(node);
 	node = node->next;
-	value->Pos.y = atoi(node->text);
+	value->Pos.y = JSONGetInt(node);
 	node = node->next;
-	value->Size.x = atoi(node->text);
+	value->Size.x = JSONGetInt(node);
 	node = node->next;
-	value->Size.y = atoi(node->text);
+	value->Size.y = JSONGetInt(node);
 }
 void LoadIntArray(CArray *a, const json_t *node, const char *name)
 {
@@ -206,7 +215,7 @@ void LoadIntArray(CArray *a, const json_t *node, const char *name)
 	child = child->child;
 	for (child = child->child; child; child = child->next)
 	{
-		const int n = atoi(child->text);
+		const int n = JSONGetInt(child);
 		CArrayPushBack(a, &n);
 	}
 }
@@ -280,28 +289,228 @@ void LoadColor(color_t *c, json_t *node, const char *name)
 
 json_t *JSONFindNode(json_t *node, const char *path)
 {
-	char *pathCopy;
-	CSTRDUP(pathCopy, path);
-	char *pch = strtok(pathCopy, "/");
-	while (pch != NULL)
+	for (const char *p = path; *p != '\0';)
 	{
-		node = json_find_first_label(node, pch);
-		if (node == NULL)
+		const size_t len = strcspn(p, "/");
+		if (len > 0)
 		{
-			goto bail;
+			node = json_find_first_label_n(node, p, len);
+			if (node == NULL)
+			{
+				return NULL;
+			}
+			node = node->child;
+			if (node == NULL)
+			{
+				return NULL;
+			}
 		}
-		node = node->child;
-		if (node == NULL)
+		p += len;
+		if (*p == '/')
 		{
-			goto bail;
+			p++;
 		}
-		pch = strtok(NULL, "/");
 	}
-bail:
-	CFREE(pathCopy);
 	return node;
 }
 
+static bool CheckFieldType(const json_t *node, const JSONFieldType type)
+{
+	switch (type)
+	{
+	case JSON_FIELD_BOOL:
+		return node->type == JSON_TRUE || node->type == JSON_FALSE;
+	case JSON_FIELD_NUMBER:
+		return node->type == JSON_NUMBER || node->type == JSON_STRING;
+	case JSON_FIELD_STRING:
+		return node->type == JSON_STRING;
+	case JSON_FIELD_OBJECT:
+		return node->type == JSON_OBJECT;
+	case JSON_FIELD_VEC2:
+		return node->type == JSON_ARRAY && node->child != NULL &&
+			   node->child->type == JSON_NUMBER &&
+			   node->child->next != NULL &&
+			   node->child->next->type == JSON_NUMBER;
+	case JSON_FIELD_ARRAY:
+		return node->type == JSON_ARRAY;
+	case JSON_FIELD_STRINGS:
+		if (node->type != JSON_ARRAY)
+		{
+			return false;
+		}
+		for (const json_t *c = node->child; c; c = c->next)
+		{
+			if (c->type != JSON_STRING)
+			{
+				return false;
+			}
+		}
+		return true;
+	default:
+		CASSERT(false, "unknown field type");
+		return false;
+	}
+}
+static bool CheckField(json_t *node, const JSONField *f)
+{
+	const json_t *value = JSONFindNode(node, f->Path);
+	if (value == NULL)
+	{
+		// Fields are optional
+		return true;
+	}
+	if (!CheckFieldType(value, f->Type))
+	{
+		return false;
+	}
+	if (f->IsValid == NULL)
+	{
+		return true;
+	}
+	if (f->Type != JSON_FIELD_STRINGS)
+	{
+		return f->IsValid(value);
+	}
+	for (const json_t *c = value->child; c; c = c->next)
+	{
+		if (!f->IsValid(c))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+bool JSONCheckFields(
+	json_t *node, const JSONField *fields, const int version, const char *path,
+	const char *name)
+{
+	for (const JSONField *f = fields; f != NULL && f->Path != NULL; f++)
+	{
+		if (version >= f->MinVersion && !CheckField(node, f))
+		{
+			LOG(LM_MAIN, LL_ERROR, "%s: %s/%s is invalid", name, path,
+				f->Path);
+			return false;
+		}
+	}
+	return true;
+}
+bool JSONCheckClassList(
+	json_t *root, const int maxVersion, const char *path, const char *name,
+	const JSONField *fields)
+{
+	if (root == NULL || root->type != JSON_OBJECT)
+	{
+		LOG(LM_MAIN, LL_ERROR, "%s: not an object", name);
+		return false;
+	}
+	int version = 0;
+	LoadInt(&version, root, "Version");
+	if (version > maxVersion || version <= 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "%s: unsupported version %d", name, version);
+		return false;
+	}
+	const json_t *classes = JSONFindNode(root, path);
+	if (classes == NULL || classes->type != JSON_ARRAY)
+	{
+		LOG(LM_MAIN, LL_ERROR, "%s: missing array %s", name, path);
+		return false;
+	}
+	int i = 0;
+	for (json_t *child = classes->child; child; child = child->next, i++)
+	{
+		const json_t *nameNode =
+			child->type == JSON_OBJECT ? json_find_first_label(child, "Name")
+									   : NULL;
+		if (nameNode == NULL || nameNode->child == NULL ||
+			nameNode->child->type != JSON_STRING)
+		{
+			LOG(LM_MAIN, LL_ERROR, "%s: %s[%d] has no name", name, path, i);
+			return false;
+		}
+		char buf[CDOGS_PATH_MAX];
+		snprintf(buf, sizeof buf, "%s[%d]", path, i);
+		if (!JSONCheckFields(child, fields, version, buf, name))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool HasVisitedLabel(const json_t *node)
+{
+	for (const json_t *child = node->child; child; child = child->next)
+	{
+		if (child->visited == JSON_VISIT_DONE)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+static void LogUnvisited(
+	const json_t *node, const LogModule m, const char *path);
+static void LogUnvisitedValue(
+	const json_t *node, const LogModule m, const char *path)
+{
+	char buf[CDOGS_PATH_MAX];
+	int i = 0;
+	switch (node->type)
+	{
+	case JSON_OBJECT:
+		// Objects with no members looked up were read some other way
+		if (HasVisitedLabel(node))
+		{
+			LogUnvisited(node, m, path);
+		}
+		break;
+	case JSON_ARRAY:
+		for (const json_t *child = node->child; child; child = child->next)
+		{
+			snprintf(buf, sizeof buf, "%s[%d]", path, i++);
+			LogUnvisitedValue(child, m, buf);
+		}
+		break;
+	default:
+		break;
+	}
+}
+static void LogUnvisited(
+	const json_t *node, const LogModule m, const char *path)
+{
+	char buf[CDOGS_PATH_MAX];
+	for (const json_t *label = node->child; label; label = label->next)
+	{
+		snprintf(buf, sizeof buf, "%s/%s", path, label->text);
+		if (label->visited == JSON_VISIT_PENDING)
+		{
+			LOG(m, LL_DEBUG, "unknown field %s", buf);
+		}
+		else if (label->child != NULL)
+		{
+			LogUnvisitedValue(label->child, m, buf);
+		}
+	}
+}
+void JSONTrackVisits(json_t *node, const LogModule m)
+{
+	if (node == NULL || LogModuleGetLevel(m) > LL_DEBUG)
+	{
+		return;
+	}
+	json_track_visits(node);
+}
+void JSONLogUnvisited(const json_t *node, const LogModule m, const char *name)
+{
+	if (node == NULL || LogModuleGetLevel(m) > LL_DEBUG)
+	{
+		return;
+	}
+	LogUnvisitedValue(node, m, name);
+}
+
 bool TrySaveJSONFile(json_t *node, const char *filename)
 {
 	bool res = true;
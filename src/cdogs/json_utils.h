@@ -32,6 +32,7 @@
 
 #include <json/json.h>
 
+#include "log.h"
 #include "pic.h"
 #include "sounds.h"
 #include "vector.h"
@@ -44,6 +45,10 @@ void AddVec2iPair(json_t *parent, const char *name, const struct vec2i v);
 void AddRect2iPair(json_t *parent, const char *name, const Rect2i r);
 void AddIntArray(json_t *parent, const char *name, const CArray *a);
 
+// Value of a number node; also accepts numbers stored as strings
+int JSONGetInt(const json_t *node);
+double JSONGetNumber(const json_t *node);
+
 void LoadBool(bool *value, json_t *node, const char *name);
 void LoadInt(int *value, json_t *node, const char *name);
 void LoadDouble(double *value, json_t *node, const char *name);
@@ -69,10 +74,55 @@ void LoadColor(color_t *c, json_t *node, const char *name);
 // If at any point the path fails, NULL is returned.
 json_t *JSONFindNode(json_t *node, const char *path);
 
+// Track which object members get looked up, if debug logging is on for m;
+// call before loading a tree that JSONLogUnvisited will check.
+// Lookups then write to the tree, so it must not be shared with other threads.
+void JSONTrackVisits(json_t *node, const LogModule m);
+// Log, at debug level, object members that were never looked up;
+// these are likely unknown or misspelled fields.
+// Objects where no members were looked up are skipped, as are trees that
+// were not passed to JSONTrackVisits.
+void JSONLogUnvisited(const json_t *node, const LogModule m, const char *name);
+
 #define JSON_UTILS_ADD_ENUM_PAIR(parent, name, value, func)                   \
 	json_insert_pair_into_object(                                             \
 		(parent), (name), json_new_string(func(value)));
 
+// Expected value of an optional class field, for JSONCheckClassList
+typedef enum
+{
+	JSON_FIELD_BOOL,
+	JSON_FIELD_NUMBER, // or a string holding one
+	JSON_FIELD_STRING,
+	JSON_FIELD_OBJECT,
+	JSON_FIELD_VEC2,    // array of at least two numbers
+	JSON_FIELD_ARRAY,   // any array; IsValid checks it as a whole
+	JSON_FIELD_STRINGS, // array of strings; IsValid checks each one
+} JSONFieldType;
+typedef struct
+{
+	// Slash-delimited, from each class object; check parent objects first
+	const char *Path;
+	JSONFieldType Type;
+	// Optional further check of the value, or of each string in an array
+	bool (*IsValid)(const json_t *node);
+	// Only checked in files of this version or later
+	int MinVersion;
+} JSONField;
+// Check that the fields of node that are present match their types;
+// fields is terminated by a NULL Path, or may be NULL.
+// Logs what is wrong, for the object at path in file name, if not.
+bool JSONCheckFields(
+	json_t *node, const JSONField *fields, const int version, const char *path,
+	const char *name);
+// Check that a class file has a version from 1 to maxVersion, and that the
+// array at path is of objects with a string "Name", as the class loaders
+// assume, and that each class passes JSONCheckFields.
+// Logs what is wrong, for file name, if not.
+bool JSONCheckClassList(
+	json_t *root, const int maxVersion, const char *path, const char *name,
+	const JSONField *fields);
+
 bool TryLoadValue(json_t **node, const char *name);
 #define JSON_UTILS_LOAD_ENUM(value, node, name, func)                         \
 	{                                                                         \
@@ -0,0 +1,311 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "json_writer.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "log.h"
+
+bool JSONWriterOpen(JSONWriter *w, const char *filename)
+{
+	FILE *f = fopen(filename, "w");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to open file(%s) for saving: %s",
+			filename, strerror(errno));
+		return false;
+	}
+	JSONWriterInit(w, f);
+	w->ownFile = true;
+	return true;
+}
+void JSONWriterInit(JSONWriter *w, FILE *f)
+{
+	w->f = f;
+	w->ownFile = false;
+	w->error = false;
+	w->depth = 0;
+	w->indent = 0;
+	w->len = 0;
+}
+
+static void Flush(JSONWriter *w)
+{
+	if (w->len > 0 && fwrite(w->buf, 1, w->len, w->f) != w->len)
+	{
+		w->error = true;
+	}
+	w->len = 0;
+}
+bool JSONWriterClose(JSONWriter *w)
+{
+	CASSERT(w->depth == 0, "unclosed JSON object or array");
+	Flush(w);
+	if (w->error)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to write JSON: %s", strerror(errno));
+	}
+	if (w->ownFile && fclose(w->f) != 0)
+	{
+		w->error = true;
+	}
+	w->f = NULL;
+	return !w->error;
+}
+
+static void Put(JSONWriter *w, const char *s, const size_t n)
+{
+	if (w->len + n > sizeof w->buf)
+	{
+		Flush(w);
+		if (n > sizeof w->buf)
+		{
+			if (fwrite(s, 1, n, w->f) != n)
+			{
+				w->error = true;
+			}
+			return;
+		}
+	}
+	memcpy(w->buf + w->len, s, n);
+	w->len += n;
+}
+static void PutC(JSONWriter *w, const char c)
+{
+	if (w->len == sizeof w->buf)
+	{
+		Flush(w);
+	}
+	w->buf[w->len++] = c;
+}
+static void PutIndent(JSONWriter *w)
+{
+	PutC(w, '\n');
+	for (int i = 0; i < w->indent; i++)
+	{
+		PutC(w, '\t');
+	}
+}
+// Escapes like json_escape
+static void PutString(JSONWriter *w, const char *s)
+{
+	PutC(w, '"');
+	for (const char *p = s; *p; p++)
+	{
+		switch (*p)
+		{
+		case '\\':
+			Put(w, "\\\\", 2);
+			break;
+		case '"':
+			Put(w, "\\\"", 2);
+			break;
+		case '/':
+			Put(w, "\\/", 2);
+			break;
+		case '\b':
+			Put(w, "\\b", 2);
+			break;
+		case '\f':
+			Put(w, "\\f", 2);
+			break;
+		case '\n':
+			Put(w, "\\n", 2);
+			break;
+		case '\r':
+			Put(w, "\\r", 2);
+			break;
+		case '\t':
+			Put(w, "\\t", 2);
+			break;
+		default:
+			if (*p >= 0 && *p < 0x20)
+			{
+				char buf[7];
+				sprintf(buf, "\\u%4.4x", *p);
+				Put(w, buf, 6);
+			}
+			else
+			{
+				PutC(w, *p);
+			}
+			break;
+		}
+	}
+	PutC(w, '"');
+}
+// Start a value: separator, indentation and key.
+// Like json_format_string, object members go on their own lines; arrays
+// aren't indented, and numbers in arrays stay on one line.
+static void BeginValue(JSONWriter *w, const char *key, const bool inlined)
+{
+	if (w->depth == 0)
+	{
+		return;
+	}
+	const bool isArray = w->stack[w->depth - 1].isArray;
+	const int count = w->stack[w->depth - 1].count++;
+	if (isArray)
+	{
+		CASSERT(key == NULL, "JSON array values cannot have keys");
+		if (count > 0)
+		{
+			PutC(w, ',');
+			if (inlined)
+			{
+				PutC(w, ' ');
+			}
+			else
+			{
+				PutIndent(w);
+			}
+		}
+		return;
+	}
+	CASSERT(key != NULL, "JSON object values need keys");
+	if (count > 0)
+	{
+		PutC(w, ',');
+	}
+	PutIndent(w);
+	PutString(w, key);
+	Put(w, ": ", 2);
+}
+static void Push(JSONWriter *w, const bool isArray)
+{
+	if (w->depth == JSON_WRITER_MAX_DEPTH)
+	{
+		CASSERT(false, "JSON too deep");
+		w->error = true;
+		return;
+	}
+	w->stack[w->depth].isArray = isArray;
+	w->stack[w->depth].count = 0;
+	w->depth++;
+}
+
+void JSONWriterBeginObject(JSONWriter *w, const char *key)
+{
+	BeginValue(w, key, false);
+	PutC(w, '{');
+	Push(w, false);
+	w->indent++;
+}
+void JSONWriterEndObject(JSONWriter *w)
+{
+	CASSERT(
+		w->depth > 0 && !w->stack[w->depth - 1].isArray,
+		"mismatched JSON object end");
+	w->indent--;
+	w->depth--;
+	if (w->stack[w->depth].count > 0)
+	{
+		PutIndent(w);
+	}
+	PutC(w, '}');
+}
+void JSONWriterBeginArray(JSONWriter *w, const char *key)
+{
+	BeginValue(w, key, false);
+	PutC(w, '[');
+	Push(w, true);
+}
+void JSONWriterEndArray(JSONWriter *w)
+{
+	CASSERT(
+		w->depth > 0 && w->stack[w->depth - 1].isArray,
+		"mismatched JSON array end");
+	w->depth--;
+	PutC(w, ']');
+}
+
+void JSONWriterInt(JSONWriter *w, const char *key, const int value)
+{
+	BeginValue(w, key, true);
+	char buf[16];
+	char *p = buf + sizeof buf;
+	unsigned u = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+	do
+	{
+		*--p = (char)('0' + u % 10);
+		u /= 10;
+	} while (u > 0);
+	if (value < 0)
+	{
+		*--p = '-';
+	}
+	Put(w, p, (size_t)(buf + sizeof buf - p));
+}
+void JSONWriterBool(JSONWriter *w, const char *key, const bool value)
+{
+	BeginValue(w, key, true);
+	if (value)
+	{
+		Put(w, "true", 4);
+	}
+	else
+	{
+		Put(w, "false", 5);
+	}
+}
+void JSONWriterString(JSONWriter *w, const char *key, const char *s)
+{
+	BeginValue(w, key, false);
+	PutString(w, s != NULL ? s : "");
+}
+void JSONWriterColor(JSONWriter *w, const char *key, const color_t c)
+{
+	char buf[COLOR_STR_BUF];
+	ColorStr(buf, c);
+	JSONWriterString(w, key, buf);
+}
+void JSONWriterVec2i(JSONWriter *w, const char *key, const struct vec2i v)
+{
+	JSONWriterBeginArray(w, key);
+	JSONWriterInt(w, NULL, v.x);
+	JSONWriterInt(w, NULL, v.y);
+	JSONWriterEndArray(w);
+}
+void JSONWriterRect2i(JSONWriter *w, const char *key, const Rect2i r)
+{
+	JSONWriterBeginArray(w, key);
+	JSONWriterInt(w, NULL, r.Pos.x);
+	JSONWriterInt(w, NULL, r.Pos.y);
+	JSONWriterInt(w, NULL, r.Size.x);
+	JSONWriterInt(w, NULL, r.Size.y);
+	JSONWriterEndArray(w);
+}
+void JSONWriterIntArray(JSONWriter *w, const char *key, const CArray *a)
+{
+	JSONWriterBeginArray(w, key);
+	CA_FOREACH(const int, i, *a)
+	JSONWriterInt(w, NULL, *i);
+	CA_FOREACH_END()
+	JSONWriterEndArray(w);
+}
@@ -0,0 +1,79 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "c_array.h"
+#include "color.h"
+#include "vector.h"
+
+// Writes pretty-printed JSON straight to a file as it goes, without
+// building a tree first. Parses the same as the tree saved by
+// json_tree_to_string and json_format_string.
+// Values in objects take a key; values in arrays or the root take NULL.
+// Errors are sticky and reported by JSONWriterClose.
+#define JSON_WRITER_MAX_DEPTH 32
+#define JSON_WRITER_BUF_SIZE 16384
+typedef struct
+{
+	FILE *f;
+	bool ownFile;
+	bool error;
+	int depth;
+	int indent;
+	struct
+	{
+		bool isArray;
+		int count;
+	} stack[JSON_WRITER_MAX_DEPTH];
+	size_t len;
+	char buf[JSON_WRITER_BUF_SIZE];
+} JSONWriter;
+
+bool JSONWriterOpen(JSONWriter *w, const char *filename);
+// Write to an already open file, which is left open on close
+void JSONWriterInit(JSONWriter *w, FILE *f);
+// Flushes and closes; returns whether everything was written
+bool JSONWriterClose(JSONWriter *w);
+
+void JSONWriterBeginObject(JSONWriter *w, const char *key);
+void JSONWriterEndObject(JSONWriter *w);
+void JSONWriterBeginArray(JSONWriter *w, const char *key);
+void JSONWriterEndArray(JSONWriter *w);
+
+void JSONWriterInt(JSONWriter *w, const char *key, const int value);
+void JSONWriterBool(JSONWriter *w, const char *key, const bool value);
+// NULL is written as an empty string
+void JSONWriterString(JSONWriter *w, const char *key, const char *s);
+void JSONWriterColor(JSONWriter *w, const char *key, const color_t c);
+void JSONWriterVec2i(JSONWriter *w, const char *key, const struct vec2i v);
+void JSONWriterRect2i(JSONWriter *w, const char *key, const Rect2i r);
+// Array of ints
+void JSONWriterIntArray(JSONWriter *w, const char *key, const CArray *a);
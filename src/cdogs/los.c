@@ -286,3 +286,46 @@ bool LOSTileIsVisible(Map *map, const struct vec2i pos)
 	if (MapGetTile(map, pos) == NULL) return false;
 	return *((bool *)CArrayGet(&map->LOS.LOS, pos.y * map->Size.x + pos.x));
 }
+
+void LOSBitsInit(LOSBits *b)
+{
+	CArrayInit(&b->Words, sizeof(uint32_t));
+}
+void LOSBitsTerminate(LOSBits *b)
+{
+	CArrayTerminate(&b->Words);
+}
+void LOSBitsFromLOS(LOSBits *b, const LineOfSight *los)
+{
+	const size_t numTiles = los->LOS.size;
+	CArrayResize(&b->Words, (numTiles + 31) / 32, NULL);
+	CArrayFillZero(&b->Words);
+	const bool *l = los->LOS.data;
+	uint32_t *words = b->Words.data;
+	for (size_t i = 0; i < numTiles; i++)
+	{
+		words[i / 32] |= (uint32_t)l[i] << (i % 32);
+	}
+}
+void LOSBitsUnionToLOS(LineOfSight *los, const LOSBits *views, const int n)
+{
+	const size_t numTiles = los->LOS.size;
+	bool *l = los->LOS.data;
+	for (size_t w = 0; w * 32 < numTiles; w++)
+	{
+		uint32_t word = 0;
+		for (int i = 0; i < n; i++)
+		{
+			word |= ((const uint32_t *)views[i].Words.data)[w];
+		}
+		for (size_t i = w * 32; i < numTiles && i < w * 32 + 32; i++)
+		{
+			l[i] = (word >> (i % 32)) & 1;
+		}
+	}
+}
+bool LOSBitsGet(const LOSBits *b, const int tileIdx)
+{
+	const uint32_t *words = b->Words.data;
+	return (words[tileIdx / 32] >> (tileIdx % 32)) & 1;
+}
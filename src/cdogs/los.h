@@ -28,9 +28,16 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "map.h"
 
+// LOS packed a bit per tile, for keeping one per split screen view
+typedef struct
+{
+	CArray Words; // of uint32_t
+} LOSBits;
+
 
 void LOSInit(Map *map);
 void LOSTerminate(LineOfSight *los);
@@ -43,3 +50,11 @@ void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore);
 bool LOSAddRun(
 	NExploreTiles *runs, bool *run, const struct vec2i tile, const bool explored);
 bool LOSTileIsVisible(Map *map, const struct vec2i pos);
+
+void LOSBitsInit(LOSBits *b);
+void LOSBitsTerminate(LOSBits *b);
+// Pack the map's LOS
+void LOSBitsFromLOS(LOSBits *b, const LineOfSight *los);
+// Set the map's LOS to the union of the packed LOS of n views
+void LOSBitsUnionToLOS(LineOfSight *los, const LOSBits *views, const int n);
+bool LOSBitsGet(const LOSBits *b, const int tileIdx);
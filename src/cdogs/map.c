@@ -65,6 +65,7 @@
 #include "map_build.h"
 #include "map_cave.h"
 #include "map_classic.h"
+#include "map_placement.h"
 #include "map_static.h"
 #include "mission.h"
 #include "net_util.h"
@@ -217,21 +218,22 @@ void MapRemoveThing(Map *map, Thing *t)
 
 struct vec2i MapGetRandomTile(const Map *map)
 {
-	return svec2i(rand() % map->Size.x, rand() % map->Size.y);
+	return svec2i(
+		RAND_INT(RNG_MAPGEN, 0, map->Size.x),
+		RAND_INT(RNG_MAPGEN, 0, map->Size.y));
 }
 
-struct vec2 MapGetRandomPos(const Map *map)
+struct vec2 MapGetRandomPosInTile(const struct vec2i tile, const RngStream s)
 {
 	for (;;)
 	{
-		const struct vec2 pos = svec2(
-			RAND_FLOAT(0, map->Size.x * TILE_WIDTH),
-			RAND_FLOAT(0, map->Size.y * TILE_HEIGHT));
+		const struct vec2 offset = svec2(
+			RAND_FLOAT(s, 0, TILE_WIDTH), RAND_FLOAT(s, 0, TILE_HEIGHT));
 		// RAND_FLOAT can sometimes produce the max size
-		if (pos.x < map->Size.x * TILE_WIDTH &&
-			pos.y < map->Size.y * TILE_HEIGHT)
+		if (offset.x < TILE_WIDTH && offset.y < TILE_HEIGHT)
 		{
-			return pos;
+			return svec2_add(
+				svec2(tile.x * TILE_WIDTH, tile.y * TILE_HEIGHT), offset);
 		}
 	}
 }
@@ -327,7 +329,7 @@ uint16_t MapGetAccessLevel(const Map *map, const struct vec2i pos)
 	return AccessCodeToFlags(t);
 }
 
-static bool MapTileIsInLockedRoom(const Map *map, const struct vec2i tilePos)
+bool MapTileIsInLockedRoom(const Map *map, const struct vec2i tilePos)
 {
 	return MapGetAccessLevel(map, tilePos) != 0;
 }
@@ -349,19 +351,6 @@ void MapPlaceCollectible(
 	GameEventsEnqueue(&gGameEvents, e);
 }
 
-struct vec2 MapGenerateFreePosition(Map *map, const struct vec2i size)
-{
-	for (int i = 0; i < 100; i++)
-	{
-		const struct vec2 v = MapGetRandomPos(map);
-		if (!IsCollisionWithWall(v, size))
-		{
-			return v;
-		}
-	}
-	return svec2_zero();
-}
-
 void MapPlaceKey(
 	MapBuilder *mb, const struct vec2i tilePos, const int keyIndex)
 {
@@ -373,51 +362,24 @@ void MapPlaceKey(
 	GameEventsEnqueue(&gGameEvents, e);
 }
 
-static int GetPlacementRetries(
-	const Map *map, const PlacementAccessFlags paFlags, bool *locked,
-	bool *unlocked)
-{
-	// Try more times if we need to place in a locked room or unlocked place
-	*locked = paFlags == PLACEMENT_ACCESS_LOCKED && MapHasLockedRooms(map);
-	*unlocked = paFlags == PLACEMENT_ACCESS_NOT_LOCKED;
-	return (*locked || *unlocked) ? 1000 : 100;
-}
-
-bool MapPlaceRandomTile(
-	MapBuilder *mb, const PlacementAccessFlags paFlags,
-	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, void *), void *data)
-{
-	// Try a bunch of times to place something on a random tile
-	bool locked, unlocked;
-	const int retries =
-		GetPlacementRetries(mb->Map, paFlags, &locked, &unlocked);
-	for (int i = 0; i < retries; i++)
-	{
-		const struct vec2i tilePos = MapGetRandomTile(mb->Map);
-		const bool isInLocked = MapTileIsInLockedRoom(mb->Map, tilePos);
-		if ((!locked || isInLocked) && (!unlocked || !isInLocked))
-		{
-			if (tryPlaceFunc(mb, tilePos, data))
-			{
-				return true;
-			}
-		}
-	}
-	return false;
-}
 bool MapPlaceRandomPos(
 	const Map *map, const PlacementAccessFlags paFlags,
 	bool (*tryPlaceFunc)(const Map *, const struct vec2, void *), void *data)
 {
-	// Try a bunch of times to place something at a random location
-	bool locked, unlocked;
-	const int retries = GetPlacementRetries(map, paFlags, &locked, &unlocked);
-	for (int i = 0; i < retries; i++)
+	const bool locked =
+		paFlags == PLACEMENT_ACCESS_LOCKED && MapHasLockedRooms(map);
+	const bool unlocked = paFlags == PLACEMENT_ACCESS_NOT_LOCKED;
+	PlacementOrder o;
+	PlacementOrderInit(&o, (int)map->WalkableTiles.size, RNG_GAMEPLAY);
+	int i;
+	while (PlacementOrderNext(&o, &i))
 	{
-		const struct vec2 v = MapGetRandomPos(map);
-		const bool isInLocked = MapPosIsInLockedRoom(map, v);
+		const struct vec2i *tilePos = CArrayGet(&map->WalkableTiles, i);
+		const bool isInLocked = MapTileIsInLockedRoom(map, *tilePos);
 		if ((!locked || isInLocked) && (!unlocked || !isInLocked))
 		{
+			const struct vec2 v =
+				MapGetRandomPosInTile(*tilePos, RNG_GAMEPLAY);
 			if (tryPlaceFunc(map, v, data))
 			{
 				return true;
@@ -481,6 +443,7 @@ void MapTerminate(Map *map)
 	TileClassesTerminate(map->TileClasses);
 	LOSTerminate(&map->LOS);
 	CArrayTerminate(&map->access);
+	CArrayTerminate(&map->WalkableTiles);
 	PathCacheTerminate(&gPathCache);
 }
 
@@ -497,6 +460,7 @@ void MapInit(Map *map, const struct vec2i size)
 	CArrayInitFillZero(&map->access, sizeof(uint16_t), size.x * size.y);
 	CArrayInit(&map->triggers, sizeof(Trigger *));
 	CArrayInit(&map->exits, sizeof(Exit));
+	CArrayInit(&map->WalkableTiles, sizeof(struct vec2i));
 	PathCacheInit(&gPathCache, map);
 
 	struct vec2i v;
@@ -52,6 +52,7 @@
 
 #include "map_object.h"
 #include "pic.h"
+#include "rng.h"
 #include "thing.h"
 #include "tile.h"
 #include "triggers.h"
@@ -114,6 +115,7 @@ typedef struct
 	CArray exits; // of Exit
 
 	int NumExplorableTiles;
+	CArray WalkableTiles; // of struct vec2i, for random placement
 } Map;
 
 extern Map gMap;
@@ -128,6 +130,7 @@ int MapIsTileInExit(const Map *map, const Thing *ti, const int exit);
 uint16_t MapGetAccessLevel(const Map *map, const struct vec2i pos);
 uint16_t AccessCodeToFlags(const uint16_t code);
 bool MapHasLockedRooms(const Map *map);
+bool MapTileIsInLockedRoom(const Map *map, const struct vec2i tilePos);
 bool MapPosIsInLockedRoom(const Map *map, const struct vec2 pos);
 int MapGetDoorKeycardFlag(Map *map, struct vec2i pos);
 
@@ -147,7 +150,9 @@ void MapShowExitArea(Map *map, const int i);
 // Returns the center of the tile that's the middle of the exit area
 struct vec2 MapGetExitPos(const Map *m, const int i);
 struct vec2i MapGetRandomTile(const Map *map);
-struct vec2 MapGetRandomPos(const Map *map);
+struct vec2 MapGetRandomPosInTile(const struct vec2i tile, const RngStream s);
+// Try tryPlaceFunc at a random position in each walkable tile, visiting the
+// tiles in random order; returns false once every tile has been tried
 bool MapPlaceRandomPos(
 	const Map *map, const PlacementAccessFlags paFlags,
 	bool (*tryPlaceFunc)(const Map *, const struct vec2, void *), void *data);
@@ -164,6 +169,5 @@ struct vec2i MapSearchTileAround(
 bool MapTileIsUnexplored(Map *map, struct vec2i tile);
 
 // Map construction functions
-struct vec2 MapGenerateFreePosition(Map *map, const struct vec2i size);
 
 Trigger *MapNewTrigger(Map *map);
@@ -30,21 +30,26 @@
 #include <tinydir/tinydir.h>
 
 #include "ammo.h"
+#include "campaign_cache.h"
 #include "character_class.h"
+#include "config.h"
 #include "files.h"
 #include "json_utils.h"
+#include "json_writer.h"
 #include "log.h"
 #include "map_new.h"
 #include "pickup.h"
 #include "player_template.h"
 
-static char *ReadFileIntoBuf(const char *path, const char *mode, long *len);
-
-static json_t *ReadArchiveJSON(const char *archive, const char *filename);
+static json_t *ReadArchiveJSON(
+	CampaignCache *cache, const char *archive, const char *filename);
 int MapNewScanArchive(const char *filename, char **title, int *numMissions)
 {
 	int err = 0;
-	json_t *root = ReadArchiveJSON(filename, "campaign.json");
+	// Only use an existing cache; they are compiled when loading campaigns
+	CampaignCache cache;
+	CampaignCacheOpen(&cache, filename, false);
+	json_t *root = ReadArchiveJSON(&cache, filename, "campaign.json");
 	if (root == NULL)
 	{
 		err = -1;
@@ -58,13 +63,27 @@ int MapNewScanArchive(const char *filename, char **title, int *numMissions)
 
 bail:
 	json_free_value(&root);
+	CampaignCacheClose(&cache);
 	return err;
 }
 
+static int LoadCampaignJSON(
+	CampaignCache *cache, const char *filename, CampaignSetting *c,
+	int *version);
 int MapLoadCampaignJSON(const char *filename, CampaignSetting *c, int *version)
+{
+	CampaignCache cache;
+	CampaignCacheOpen(&cache, filename, false);
+	const int err = LoadCampaignJSON(&cache, filename, c, version);
+	CampaignCacheClose(&cache);
+	return err;
+}
+static int LoadCampaignJSON(
+	CampaignCache *cache, const char *filename, CampaignSetting *c,
+	int *version)
 {
 	int err = 0;
-	json_t *root = ReadArchiveJSON(filename, "campaign.json");
+	json_t *root = ReadArchiveJSON(cache, filename, "campaign.json");
 	if (root == NULL)
 	{
 		err = -1;
@@ -87,45 +106,58 @@ bail:
 }
 
 static void LoadArchiveSounds(
-	SoundDevice *device, const char *archive, const char *dirname);
-static void LoadArchivePics(PicManager *pm, map_t cc, const char *archive);
+	AssetLoader *l, SoundDevice *device, const char *archive,
+	const char *dirname);
+static void LoadArchivePics(
+	AssetLoader *l, PicManager *pm, map_t cc, const char *archive);
 int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 {
 	LOG(LM_MAP, LL_DEBUG, "Loading archive map %s", filename);
 	int err = 0;
 	json_t *root = NULL;
 	int version = 0;
-	err = MapLoadCampaignJSON(filename, c, &version);
+	// Compile the archive on first load; the documents read from the cache
+	// point into it, so they must be freed before it is closed
+	CampaignCache cache;
+	CampaignCacheOpen(&cache, filename, true);
+	err = LoadCampaignJSON(&cache, filename, c, &version);
 	if (err != 0)
 	{
 		goto bail;
 	}
 
 	// Load any custom data
-	LoadArchiveSounds(&gSoundDevice, filename, "sounds");
-
-	LoadArchivePics(&gPicManager, gCharSpriteClasses.customClasses, filename);
-
-	root = ReadArchiveJSON(filename, "particles.json");
+	AssetLoader assets;
+	AssetLoaderInit(&assets, -1);
+	LoadArchiveSounds(&assets, &gSoundDevice, filename, "sounds");
+	LoadArchivePics(
+		&assets, &gPicManager, gCharSpriteClasses.customClasses, filename);
+	AssetLoaderTerminate(&assets);
+
+	root = ReadArchiveJSON(&cache, filename, "particles.json");
 	if (root != NULL)
 	{
 		ParticleClassesLoadJSON(&gParticleClasses.CustomClasses, root);
+		json_free_value(&root);
 	}
 
-	root = ReadArchiveJSON(filename, "character_classes.json");
+	root = ReadArchiveJSON(&cache, filename, "character_classes.json");
 	if (root != NULL)
 	{
 		CharacterClassesLoadJSON(&gCharacterClasses.CustomClasses, root);
+		json_free_value(&root);
 	}
 
-	root = ReadArchiveJSON(filename, "bullets.json");
-	if (root != NULL)
+	// Freed by BulletLoadWeapons
+	json_t *bulletsRoot = ReadArchiveJSON(&cache, filename, "bullets.json");
+	if (bulletsRoot != NULL)
 	{
-		BulletLoadJSON(&gBulletClasses, &gBulletClasses.CustomClasses, root);
+		BulletLoadJSON(
+			&gBulletClasses, &gBulletClasses.CustomClasses, bulletsRoot);
 	}
 
 	bool hasCustomAmmo = false;
-	root = ReadArchiveJSON(filename, "ammo.json");
+	root = ReadArchiveJSON(&cache, filename, "ammo.json");
 	if (root != NULL)
 	{
 		AmmoLoadJSON(&gAmmo.CustomAmmo, root);
@@ -134,7 +166,7 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 	}
 
 	bool hasCustomGuns = false;
-	root = ReadArchiveJSON(filename, "guns.json");
+	root = ReadArchiveJSON(&cache, filename, "guns.json");
 	if (root != NULL)
 	{
 		WeaponClassesLoadJSON(
@@ -145,10 +177,11 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 
 	BulletLoadWeapons(&gBulletClasses);
 
-	root = ReadArchiveJSON(filename, "pickups.json");
+	root = ReadArchiveJSON(&cache, filename, "pickups.json");
 	if (root != NULL)
 	{
 		PickupClassesLoadJSON(&gPickupClasses.CustomClasses, root);
+		json_free_value(&root);
 	}
 	if (hasCustomAmmo)
 	{
@@ -162,26 +195,28 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 	}
 	PickupClassesLoadKeys(&gPickupClasses.KeyClasses);
 
-	root = ReadArchiveJSON(filename, "map_objects.json");
+	root = ReadArchiveJSON(&cache, filename, "map_objects.json");
 	if (root != NULL)
 	{
 		MapObjectsLoadJSON(&gMapObjects.CustomClasses, root);
+		json_free_value(&root);
 	}
 	MapObjectsLoadAmmoAndGunSpawners(
 		&gMapObjects, &gAmmo, &gWeaponClasses, true);
 
-	root = ReadArchiveJSON(filename, "missions.json");
+	root = ReadArchiveJSON(&cache, filename, "missions.json");
 	if (root == NULL)
 	{
 		err = -1;
 		goto bail;
 	}
 	LoadMissions(
-		&c->Missions, json_find_first_label(root, "Missions")->child, version);
+		&c->Missions, json_find_first_label(root, "Missions")->child, version,
+		&cache);
 	json_free_value(&root);
 
 	// Note: some campaigns don't have characters (e.g. dogfights)
-	root = ReadArchiveJSON(filename, "characters.json");
+	root = ReadArchiveJSON(&cache, filename, "characters.json");
 	if (root != NULL)
 	{
 		CharacterLoadJSON(
@@ -190,19 +225,25 @@ int MapNewLoadArchive(const char *filename, CampaignSetting *c)
 
 bail:
 	json_free_value(&root);
+	CampaignCacheClose(&cache);
 	return err;
 }
 
-static json_t *ReadArchiveJSON(const char *archive, const char *filename)
+static json_t *ReadArchiveJSON(
+	CampaignCache *cache, const char *archive, const char *filename)
 {
 	json_t *root = NULL;
+	if (CampaignCacheTryGetJSON(cache, filename, &root))
+	{
+		return root;
+	}
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/%s", archive, filename);
 	long len;
 	char *buf = ReadFileIntoBuf(path, "rb", &len);
 	if (buf == NULL)
 		goto bail;
-	const enum json_error e = json_parse_document(&root, buf);
+	const enum json_error e = json_parse_buffer(&root, buf, (size_t)len);
 	if (e != JSON_OK)
 	{
 		LOG(LM_MAP, LL_ERROR, "Invalid syntax in JSON file (%s) error(%d)",
@@ -217,70 +258,42 @@ bail:
 }
 
 static void LoadArchiveSounds(
-	SoundDevice *device, const char *archive, const char *dirname)
+	AssetLoader *l, SoundDevice *device, const char *archive,
+	const char *dirname)
 {
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/%s", archive, dirname);
-	SoundLoadDir(device->customSounds, path, NULL);
+	SoundQueueDir(l, device->customSounds, path, NULL);
 }
-static void LoadArchivePics(PicManager *pm, map_t cc, const char *archive)
+static void LoadArchivePics(
+	AssetLoader *l, PicManager *pm, map_t cc, const char *archive)
 {
 	char path[CDOGS_PATH_MAX];
 	sprintf(path, "%s/graphics", archive);
-	PicManagerLoadDir(pm, path, NULL, pm->customPics, pm->customSprites);
-	CharSpriteClassesLoadDir(cc, archive);
+	PicManagerQueueDir(l, pm, path, NULL, pm->customPics, pm->customSprites);
+	CharSpriteClassesQueueDir(l, cc, archive);
 }
 
-static char *ReadFileIntoBuf(const char *path, const char *mode, long *len)
+static void SaveMissions(
+	const CArray *a, JSONWriter *w, const bool compactTiles);
+// RLE tiles need MAP_VERSION; without them, saves stay readable by older
+// builds
+static int SaveVersion(const CArray *missions, const bool compactTiles)
 {
-	char *buf = NULL;
-	FILE *f = fopen(path, mode);
-	if (f == NULL)
-	{
-		goto bail;
-	}
-
-	// Read into buffer
-	if (fseek(f, 0L, SEEK_END) != 0)
-	{
-		goto bail;
-	}
-	*len = ftell(f);
-	if (*len == -1)
-	{
-		goto bail;
-	}
-	CCALLOC(buf, *len + 1);
-	if (fseek(f, 0L, SEEK_SET) != 0)
+	if (!compactTiles)
 	{
-		goto bail;
-	}
-	if (fread(buf, 1, *len, f) == 0)
-	{
-		goto bail;
+		return MAP_VERSION_CSV;
 	}
-
-	goto end;
-
-bail:
-	CFREE(buf);
-	buf = NULL;
-
-end:
-	if (f != NULL && fclose(f) != 0)
+	CA_FOREACH(const Mission, m, *missions)
+	if (m->Type == MAPTYPE_STATIC)
 	{
-		LOG(LM_MAP, LL_ERROR, "Cannot close file %s: %s", path,
-			strerror(errno));
+		return MAP_VERSION;
 	}
-	return buf;
+	CA_FOREACH_END()
+	return MAP_VERSION_CSV;
 }
-
-static json_t *SaveMissions(CArray *a);
 int MapArchiveSave(const char *filename, CampaignSetting *c)
 {
-	int res = 1;
-	json_t *root = NULL;
-
 	char relbuf[CDOGS_PATH_MAX];
 	if (strcmp(StrGetFileExt(filename), "cdogscpn") == 0 ||
 		strcmp(StrGetFileExt(filename), "CDOGSCPN") == 0)
@@ -297,233 +310,224 @@ int MapArchiveSave(const char *filename, CampaignSetting *c)
 	mkdir_deep(buf);
 
 	// Campaign
-	root = json_new_object();
-	AddIntPair(root, "Version", MAP_VERSION);
-	AddStringPair(root, "Title", c->Title);
-	AddStringPair(root, "Author", c->Author);
-	AddStringPair(root, "Description", c->Description);
-	AddBoolPair(root, "Ammo", c->Ammo);
-	AddBoolPair(root, "SkipWeaponMenu", c->SkipWeaponMenu);
-	AddBoolPair(root, "RandomPickups", c->RandomPickups);
-	AddIntPair(root, "DoorOpenTicks", c->DoorOpenTicks);
-	AddIntPair(root, "Missions", (int)c->Missions.size);
 	char buf2[CDOGS_PATH_MAX];
 	sprintf(buf2, "%s/campaign.json", buf);
-	if (!TrySaveJSONFile(root, buf2))
+	JSONWriter w;
+	if (!JSONWriterOpen(&w, buf2))
 	{
-		res = 0;
-		goto bail;
+		return 0;
+	}
+	JSONWriterBeginObject(&w, NULL);
+	const bool compactTiles = ConfigGetBool(&gConfig, "CompactTiles");
+	JSONWriterInt(&w, "Version", SaveVersion(&c->Missions, compactTiles));
+	JSONWriterString(&w, "Title", c->Title);
+	JSONWriterString(&w, "Author", c->Author);
+	JSONWriterString(&w, "Description", c->Description);
+	JSONWriterBool(&w, "Ammo", c->Ammo);
+	JSONWriterBool(&w, "SkipWeaponMenu", c->SkipWeaponMenu);
+	JSONWriterBool(&w, "RandomPickups", c->RandomPickups);
+	JSONWriterInt(&w, "DoorOpenTicks", c->DoorOpenTicks);
+	JSONWriterInt(&w, "Missions", (int)c->Missions.size);
+	JSONWriterEndObject(&w);
+	if (!JSONWriterClose(&w))
+	{
+		return 0;
 	}
 
-	json_free_value(&root);
-	root = json_new_object();
-	json_insert_pair_into_object(root, "Missions", SaveMissions(&c->Missions));
 	sprintf(buf2, "%s/missions.json", buf);
-	if (!TrySaveJSONFile(root, buf2))
+	if (!JSONWriterOpen(&w, buf2))
 	{
-		res = 0;
-		goto bail;
+		return 0;
+	}
+	JSONWriterBeginObject(&w, NULL);
+	SaveMissions(&c->Missions, &w, compactTiles);
+	JSONWriterEndObject(&w);
+	if (!JSONWriterClose(&w))
+	{
+		return 0;
 	}
 
 	if (!CharacterSave(&c->characters, buf))
 	{
-		res = 0;
-		goto bail;
+		return 0;
 	}
 
-bail:
-	json_free_value(&root);
-	return res;
+	return 1;
 }
 
-static json_t *SaveObjectives(CArray *a);
-static json_t *SaveWeapons(const CArray *weapons);
-static json_t *SaveMissionTileClasses(const MissionTileClasses *mtc);
-static json_t *SaveRooms(const RoomParams r);
-static json_t *SaveDoors(const DoorParams d);
-static json_t *SavePillars(const PillarParams p);
-static json_t *SaveMissions(CArray *a)
+static void SaveObjectives(const CArray *a, JSONWriter *w);
+static void SaveWeapons(const CArray *weapons, JSONWriter *w);
+static void SaveMissionTileClasses(
+	const MissionTileClasses *mtc, JSONWriter *w);
+static void SaveRooms(const RoomParams r, JSONWriter *w);
+static void SaveDoors(const DoorParams d, JSONWriter *w);
+static void SavePillars(const PillarParams p, JSONWriter *w);
+static void SaveMissions(
+	const CArray *a, JSONWriter *w, const bool compactTiles)
 {
-	json_t *missionsNode = json_new_array();
+	JSONWriterBeginArray(w, "Missions");
 	for (int i = 0; i < (int)a->size; i++)
 	{
-		json_t *node = json_new_object();
-		Mission *mission = CArrayGet(a, i);
-		AddStringPair(node, "Title", mission->Title);
-		AddStringPair(node, "Description", mission->Description);
-		AddStringPair(node, "Type", MapTypeStr(mission->Type));
-		AddIntPair(node, "Width", mission->Size.x);
-		AddIntPair(node, "Height", mission->Size.y);
-
-		AddStringPair(node, "ExitStyle", mission->ExitStyle);
-		AddStringPair(node, "KeyStyle", mission->KeyStyle);
-
-		json_insert_pair_into_object(
-			node, "Objectives", SaveObjectives(&mission->Objectives));
-		AddIntArray(node, "Enemies", &mission->Enemies);
-		AddIntArray(node, "SpecialChars", &mission->SpecialChars);
-		json_t *modsNode = json_new_array();
+		const Mission *mission = CArrayGet(a, i);
+		JSONWriterBeginObject(w, NULL);
+		JSONWriterString(w, "Title", mission->Title);
+		JSONWriterString(w, "Description", mission->Description);
+		JSONWriterString(w, "Type", MapTypeStr(mission->Type));
+		JSONWriterInt(w, "Width", mission->Size.x);
+		JSONWriterInt(w, "Height", mission->Size.y);
+
+		JSONWriterString(w, "ExitStyle", mission->ExitStyle);
+		JSONWriterString(w, "KeyStyle", mission->KeyStyle);
+
+		SaveObjectives(&mission->Objectives, w);
+		JSONWriterIntArray(w, "Enemies", &mission->Enemies);
+		JSONWriterIntArray(w, "SpecialChars", &mission->SpecialChars);
+		JSONWriterBeginArray(w, "MapObjectDensities");
 		for (int j = 0; j < (int)mission->MapObjectDensities.size; j++)
 		{
 			const MapObjectDensity *mod =
 				CArrayGet(&mission->MapObjectDensities, j);
-			json_t *modNode = json_new_object();
-			AddStringPair(modNode, "MapObject", mod->M->Name);
-			AddIntPair(modNode, "Density", mod->Density);
-			json_insert_child(modsNode, modNode);
+			JSONWriterBeginObject(w, NULL);
+			JSONWriterString(w, "MapObject", mod->M->Name);
+			JSONWriterInt(w, "Density", mod->Density);
+			JSONWriterEndObject(w);
 		}
-		json_insert_pair_into_object(node, "MapObjectDensities", modsNode);
+		JSONWriterEndArray(w);
 
-		AddIntPair(node, "EnemyDensity", mission->EnemyDensity);
-		json_insert_pair_into_object(
-			node, "Weapons", SaveWeapons(&mission->Weapons));
-		AddBoolPair(node, "WeaponPersist", mission->WeaponPersist);
-		AddBoolPair(node, "SkipDebrief", mission->SkipDebrief);
+		JSONWriterInt(w, "EnemyDensity", mission->EnemyDensity);
+		SaveWeapons(&mission->Weapons, w);
+		JSONWriterBool(w, "WeaponPersist", mission->WeaponPersist);
+		JSONWriterBool(w, "SkipDebrief", mission->SkipDebrief);
 
 		if (mission->Music.Type == MUSIC_SRC_DYNAMIC &&
 			mission->Music.Data.Filename &&
 			strlen(mission->Music.Data.Filename) > 0)
 		{
-			json_insert_pair_into_object(
-				node, "Song", json_new_string(mission->Music.Data.Filename));
+			JSONWriterString(w, "Song", mission->Music.Data.Filename);
 		}
 
 		switch (mission->Type)
 		{
 		case MAPTYPE_CLASSIC:
-			json_insert_pair_into_object(
-				node, "TileClasses",
-				SaveMissionTileClasses(&mission->u.Classic.TileClasses));
-			AddIntPair(node, "Walls", mission->u.Classic.Walls);
-			AddIntPair(node, "WallLength", mission->u.Classic.WallLength);
-			AddIntPair(
-				node, "CorridorWidth", mission->u.Classic.CorridorWidth);
-			json_insert_pair_into_object(
-				node, "Rooms", SaveRooms(mission->u.Classic.Rooms));
-			AddIntPair(node, "Squares", mission->u.Classic.Squares);
-			AddBoolPair(node, "ExitEnabled", mission->u.Classic.ExitEnabled);
-			json_insert_pair_into_object(
-				node, "Doors", SaveDoors(mission->u.Classic.Doors));
-			json_insert_pair_into_object(
-				node, "Pillars", SavePillars(mission->u.Classic.Pillars));
+			SaveMissionTileClasses(&mission->u.Classic.TileClasses, w);
+			JSONWriterInt(w, "Walls", mission->u.Classic.Walls);
+			JSONWriterInt(w, "WallLength", mission->u.Classic.WallLength);
+			JSONWriterInt(
+				w, "CorridorWidth", mission->u.Classic.CorridorWidth);
+			SaveRooms(mission->u.Classic.Rooms, w);
+			JSONWriterInt(w, "Squares", mission->u.Classic.Squares);
+			JSONWriterBool(w, "ExitEnabled", mission->u.Classic.ExitEnabled);
+			SaveDoors(mission->u.Classic.Doors, w);
+			SavePillars(mission->u.Classic.Pillars, w);
 			break;
 		case MAPTYPE_STATIC:
-			MissionStaticSaveJSON(&mission->u.Static, mission->Size, node);
+			MissionStaticSave(
+				&mission->u.Static, mission->Size, w, compactTiles);
 			break;
 		case MAPTYPE_CAVE:
-			json_insert_pair_into_object(
-				node, "TileClasses",
-				SaveMissionTileClasses(&mission->u.Cave.TileClasses));
-			AddIntPair(node, "FillPercent", mission->u.Cave.FillPercent);
-			AddIntPair(node, "Repeat", mission->u.Cave.Repeat);
-			AddIntPair(node, "R1", mission->u.Cave.R1);
-			AddIntPair(node, "R2", mission->u.Cave.R2);
-			json_insert_pair_into_object(
-				node, "Rooms", SaveRooms(mission->u.Cave.Rooms));
-			AddIntPair(node, "Squares", mission->u.Cave.Squares);
-			AddBoolPair(node, "ExitEnabled", mission->u.Cave.ExitEnabled);
-			AddBoolPair(node, "DoorsEnabled", mission->u.Cave.DoorsEnabled);
+			SaveMissionTileClasses(&mission->u.Cave.TileClasses, w);
+			JSONWriterInt(w, "FillPercent", mission->u.Cave.FillPercent);
+			JSONWriterInt(w, "Repeat", mission->u.Cave.Repeat);
+			JSONWriterInt(w, "R1", mission->u.Cave.R1);
+			JSONWriterInt(w, "R2", mission->u.Cave.R2);
+			SaveRooms(mission->u.Cave.Rooms, w);
+			JSONWriterInt(w, "Squares", mission->u.Cave.Squares);
+			JSONWriterBool(w, "ExitEnabled", mission->u.Cave.ExitEnabled);
+			JSONWriterBool(w, "DoorsEnabled", mission->u.Cave.DoorsEnabled);
 			break;
 		case MAPTYPE_INTERIOR:
-			json_insert_pair_into_object(
-				node, "TileClasses",
-				SaveMissionTileClasses(&mission->u.Interior.TileClasses));
-			AddIntPair(
-				node, "CorridorWidth", mission->u.Interior.CorridorWidth);
-			json_insert_pair_into_object(
-				node, "Rooms", SaveRooms(mission->u.Interior.Rooms));
-			AddBoolPair(node, "ExitEnabled", mission->u.Interior.ExitEnabled);
-			json_insert_pair_into_object(
-				node, "Doors", SaveDoors(mission->u.Interior.Doors));
-			json_insert_pair_into_object(
-				node, "Pillars", SavePillars(mission->u.Interior.Pillars));
+			SaveMissionTileClasses(&mission->u.Interior.TileClasses, w);
+			JSONWriterInt(
+				w, "CorridorWidth", mission->u.Interior.CorridorWidth);
+			SaveRooms(mission->u.Interior.Rooms, w);
+			JSONWriterBool(
+				w, "ExitEnabled", mission->u.Interior.ExitEnabled);
+			SaveDoors(mission->u.Interior.Doors, w);
+			SavePillars(mission->u.Interior.Pillars, w);
 			break;
 		default:
 			CASSERT(false, "unknown map type");
 			break;
 		}
 
-		json_insert_child(missionsNode, node);
+		JSONWriterEndObject(w);
 	}
-	return missionsNode;
+	JSONWriterEndArray(w);
 }
-static json_t *SaveRooms(const RoomParams r)
+static void SaveRooms(const RoomParams r, JSONWriter *w)
 {
-	json_t *node = json_new_object();
-	AddIntPair(node, "Count", r.Count);
-	AddIntPair(node, "Min", r.Min);
-	AddIntPair(node, "Max", r.Max);
-	AddBoolPair(node, "Edge", r.Edge);
-	AddBoolPair(node, "Overlap", r.Overlap);
-	AddIntPair(node, "Walls", r.Walls);
-	AddIntPair(node, "WallLength", r.WallLength);
-	AddIntPair(node, "WallPad", r.WallPad);
-	return node;
+	JSONWriterBeginObject(w, "Rooms");
+	JSONWriterInt(w, "Count", r.Count);
+	JSONWriterInt(w, "Min", r.Min);
+	JSONWriterInt(w, "Max", r.Max);
+	JSONWriterBool(w, "Edge", r.Edge);
+	JSONWriterBool(w, "Overlap", r.Overlap);
+	JSONWriterInt(w, "Walls", r.Walls);
+	JSONWriterInt(w, "WallLength", r.WallLength);
+	JSONWriterInt(w, "WallPad", r.WallPad);
+	JSONWriterEndObject(w);
 }
-static json_t *SaveWeapons(const CArray *weapons)
+static void SaveWeapons(const CArray *weapons, JSONWriter *w)
 {
-	json_t *node = json_new_array();
+	JSONWriterBeginArray(w, "Weapons");
 	for (int i = 0; i < (int)weapons->size; i++)
 	{
 		const WeaponClass **wc = CArrayGet(weapons, i);
-		json_insert_child(node, json_new_string((*wc)->name));
+		JSONWriterString(w, NULL, (*wc)->name);
 	}
-	return node;
+	JSONWriterEndArray(w);
 }
-static json_t *SaveMissionTileClasses(const MissionTileClasses *mtc)
+static void SaveMissionTileClasses(
+	const MissionTileClasses *mtc, JSONWriter *w)
 {
-	json_t *node = json_new_object();
-	json_insert_pair_into_object(
-		node, "Wall", TileClassSaveJSON(&mtc->Wall));
-	json_insert_pair_into_object(
-		node, "Floor", TileClassSaveJSON(&mtc->Floor));
-	json_insert_pair_into_object(
-		node, "Room", TileClassSaveJSON(&mtc->Room));
-	json_insert_pair_into_object(
-		node, "Door", TileClassSaveJSON(&mtc->Door));
-	return node;
+	JSONWriterBeginObject(w, "TileClasses");
+	TileClassSave(&mtc->Wall, w, "Wall");
+	TileClassSave(&mtc->Floor, w, "Floor");
+	TileClassSave(&mtc->Room, w, "Room");
+	TileClassSave(&mtc->Door, w, "Door");
+	JSONWriterEndObject(w);
 }
-static json_t *SavePillars(const PillarParams p)
+static void SavePillars(const PillarParams p, JSONWriter *w)
 {
-	json_t *node = json_new_object();
-	AddIntPair(node, "Count", p.Count);
-	AddIntPair(node, "Min", p.Min);
-	AddIntPair(node, "Max", p.Max);
-	return node;
+	JSONWriterBeginObject(w, "Pillars");
+	JSONWriterInt(w, "Count", p.Count);
+	JSONWriterInt(w, "Min", p.Min);
+	JSONWriterInt(w, "Max", p.Max);
+	JSONWriterEndObject(w);
 }
-static json_t *SaveDoors(const DoorParams d)
+static void SaveDoors(const DoorParams d, JSONWriter *w)
 {
-	json_t *node = json_new_object();
-	AddBoolPair(node, "Enabled", d.Enabled);
-	AddIntPair(node, "Min", d.Min);
-	AddIntPair(node, "Max", d.Max);
-	AddBoolPair(node, "RandomPos", d.RandomPos);
-	return node;
+	JSONWriterBeginObject(w, "Doors");
+	JSONWriterBool(w, "Enabled", d.Enabled);
+	JSONWriterInt(w, "Min", d.Min);
+	JSONWriterInt(w, "Max", d.Max);
+	JSONWriterBool(w, "RandomPos", d.RandomPos);
+	JSONWriterEndObject(w);
 }
 
-static json_t *SaveObjectives(CArray *a)
+static void SaveObjectives(const CArray *a, JSONWriter *w)
 {
-	json_t *objectivesNode = json_new_array();
+	JSONWriterBeginArray(w, "Objectives");
 	CA_FOREACH(const Objective, o, *a)
-	json_t *objNode = json_new_object();
-	AddStringPair(objNode, "Description", o->Description);
-	AddStringPair(objNode, "Type", ObjectiveTypeStr(o->Type));
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterString(w, "Description", o->Description);
+	JSONWriterString(w, "Type", ObjectiveTypeStr(o->Type));
 	switch (o->Type)
 	{
 	case OBJECTIVE_COLLECT:
-		AddStringPair(objNode, "Pickup", o->u.Pickup->Name);
+		JSONWriterString(w, "Pickup", o->u.Pickup->Name);
 		break;
 	case OBJECTIVE_DESTROY:
-		AddStringPair(objNode, "MapObject", o->u.MapObject->Name);
+		JSONWriterString(w, "MapObject", o->u.MapObject->Name);
 		break;
 	default:
-		AddIntPair(objNode, "Index", o->u.Index);
+		JSONWriterInt(w, "Index", o->u.Index);
 		break;
 	}
-	AddIntPair(objNode, "Count", o->Count);
-	AddIntPair(objNode, "Required", o->Required);
-	AddIntPair(objNode, "Flags", o->Flags);
-	json_insert_child(objectivesNode, objNode);
+	JSONWriterInt(w, "Count", o->Count);
+	JSONWriterInt(w, "Required", o->Required);
+	JSONWriterInt(w, "Flags", o->Flags);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return objectivesNode;
+	JSONWriterEndArray(w);
 }
@@ -29,7 +29,9 @@
 
 #include "campaigns.h"
 
-#define MAP_VERSION 16
+#define MAP_VERSION 17
+// The last version without RLE tiles, written when they are not used
+#define MAP_VERSION_CSV 16
 
 int MapNewScanArchive(const char *filename, char **title, int *numMissions);
 int MapLoadCampaignJSON(const char *filename, CampaignSetting *c, int *version);
@@ -58,16 +58,35 @@
 #include "map_static.h"
 #include "net_util.h"
 #include "objs.h"
+#include "parallel.h"
+#include "pic_manager.h"
 
 #define COLLECTABLE_W 4
 #define COLLECTABLE_H 3
 #define EXIT_WIDTH 8
 #define EXIT_HEIGHT 8
+// Smallest band of rows worth setting up on its own thread
+#define MIN_BAND_ROWS 32
+
+static MapBuildProgressFunc sProgressFunc = NULL;
+static void *sProgressData = NULL;
+void MapBuildSetProgress(MapBuildProgressFunc func, void *data)
+{
+	sProgressFunc = func;
+	sProgressData = data;
+}
+static void ReportProgress(const char *phase, const float pct)
+{
+	if (sProgressFunc != NULL)
+	{
+		sProgressFunc(sProgressData, phase, pct);
+	}
+}
 
 static void MapSetupTilesAndWalls(MapBuilder *mb);
 static void MapSetupDoors(MapBuilder *mb);
 static void MapAddDrains(MapBuilder *mb);
-static void MapGenerateRandomExitArea(Map *map, const int mission);
+static void MapGenerateRandomExitArea(MapBuilder *mb, const int mission);
 void MapBuild(
 	Map *m, const Mission *mission, const bool loadDynamic, const int missionIndex, const GameMode mode, const CharacterStore *characters)
 {
@@ -75,6 +94,7 @@ void MapBuild(
 	MapBuilderInit(&mb, m, mission, mode, characters);
 	MapInit(mb.Map, mb.mission->Size);
 
+	ReportProgress("Generating map", 0);
 	switch (mb.mission->Type)
 	{
 	case MAPTYPE_CLASSIC:
@@ -95,9 +115,11 @@ void MapBuild(
 	}
 	CArrayCopy(&mb.Map->access, &mb.access);
 
+	ReportProgress("Setting up tiles", 0.5f);
 	MapSetupTilesAndWalls(&mb);
 	MapSetupDoors(&mb);
 	MapPrintDebug(mb.Map);
+	MapPlacementInit(&mb.placement, mb.Map, RNG_MAPGEN);
 
 	// Set exit now since we have set up all the tiles
 	switch (mb.mission->Type)
@@ -106,7 +128,7 @@ void MapBuild(
 		MapAddDrains(&mb);
 		if (HasExit(gCampaign.Entry.Mode) && mb.mission->u.Classic.ExitEnabled)
 		{
-			MapGenerateRandomExitArea(mb.Map, missionIndex);
+			MapGenerateRandomExitArea(&mb, missionIndex);
 		}
 		break;
 	case MAPTYPE_STATIC:
@@ -114,7 +136,7 @@ void MapBuild(
 	case MAPTYPE_CAVE:
 		if (HasExit(gCampaign.Entry.Mode) && mb.mission->u.Cave.ExitEnabled)
 		{
-			MapGenerateRandomExitArea(mb.Map, missionIndex);
+			MapGenerateRandomExitArea(&mb, missionIndex);
 		}
 		break;
 	case MAPTYPE_INTERIOR:
@@ -124,8 +146,18 @@ void MapBuild(
 		CASSERT(false, "unknown map type");
 		break;
 	}
+	if (mb.Map->exits.size > 0)
+	{
+		// Generate the exit tile pics now; showing the exit happens during
+		// game updates, which may run off the render thread
+		TileClassesGetExit(
+			mb.Map->TileClasses, &gPicManager, mb.mission->ExitStyle, false);
+		TileClassesGetExit(
+			mb.Map->TileClasses, &gPicManager, mb.mission->ExitStyle, true);
+	}
 
 	// Count total number of reachable tiles, for explored %
+	// and keep them for placing actors
 	mb.Map->NumExplorableTiles = 0;
 	struct vec2i v;
 	for (v.y = 0; v.y < mb.Map->Size.y; v.y++)
@@ -135,12 +167,14 @@ void MapBuild(
 			if (TileCanWalk(MapGetTile(mb.Map, v)))
 			{
 				mb.Map->NumExplorableTiles++;
+				CArrayPushBack(&mb.Map->WalkableTiles, &v);
 			}
 		}
 	}
 
 	if (loadDynamic)
 	{
+		ReportProgress("Placing objects", 0.75f);
 		MapLoadDynamic(&mb);
 		ActorsPilotVehicles();
 	}
@@ -248,6 +282,7 @@ void MapBuilderTerminate(MapBuilder *mb)
 	CArrayTerminate(&mb->access);
 	CArrayTerminate(&mb->tiles);
 	CArrayTerminate(&mb->leaveFree);
+	MapPlacementTerminate(&mb->placement);
 }
 
 uint16_t MapBuildGetAccess(const MapBuilder *mb, const struct vec2i pos)
@@ -285,16 +320,18 @@ static bool IsTileOKStrict(
 	const MapObject *obj, const Tile *tile, const Tile *tileAbove,
 	const Tile *tileBelow, const bool isLeaveFree, const int numWallsAdjacent,
 	const int numWallsAround);
-static int MapGetNumWallsAdjacentTile(const Map *map, const struct vec2i v);
-static int MapGetNumWallsAroundTile(const Map *map, const struct vec2i v);
+static bool MapObjectIsDisabled(const MapObject *mo)
+{
+	// Don't place ammo spawners if ammo is disabled
+	return !gCampaign.Setting.Ammo &&
+		   mo->Type == MAP_OBJECT_TYPE_PICKUP_SPAWNER &&
+		   PickupClassHasAmmoEffect(mo->u.PickupClass);
+}
 bool MapTryPlaceOneObject(
 	MapBuilder *mb, const struct vec2i v, const MapObject *mo,
 	const int extraFlags, const bool isStrictMode)
 {
-	// Don't place ammo spawners if ammo is disabled
-	if (!gCampaign.Setting.Ammo &&
-		mo->Type == MAP_OBJECT_TYPE_PICKUP_SPAWNER &&
-		PickupClassHasAmmoEffect(mo->u.PickupClass))
+	if (MapObjectIsDisabled(mo))
 	{
 		return false;
 	}
@@ -304,8 +341,8 @@ bool MapTryPlaceOneObject(
 	if (isStrictMode &&
 		!IsTileOKStrict(
 			mo, t, tAbove, tBelow, MapBuilderIsLeaveFree(mb, v),
-			MapGetNumWallsAdjacentTile(mb->Map, v),
-			MapGetNumWallsAroundTile(mb->Map, v)))
+			MapPlacementGetWallsAdjacent(&mb->placement, v),
+			MapPlacementGetWallsAround(&mb->placement, v)))
 	{
 		return false;
 	}
@@ -372,58 +409,7 @@ static bool IsTileOKStrict(
 
 	return true;
 }
-// Adjacent means to the left, right, above or below
-static int MapGetNumWallsAdjacentTile(const Map *map, const struct vec2i v)
-{
-	int count = 0;
-	if (v.x > 0 && v.y > 0 && v.x < map->Size.x - 1 && v.y < map->Size.y - 1)
-	{
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x - 1, v.y))))
-		{
-			count++;
-		}
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x + 1, v.y))))
-		{
-			count++;
-		}
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x, v.y - 1))))
-		{
-			count++;
-		}
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x, v.y + 1))))
-		{
-			count++;
-		}
-	}
-	return count;
-}
-// Around means the 8 tiles surrounding the tile
-static int MapGetNumWallsAroundTile(const Map *map, const struct vec2i v)
-{
-	int count = MapGetNumWallsAdjacentTile(map, v);
-	if (v.x > 0 && v.y > 0 && v.x < map->Size.x - 1 && v.y < map->Size.y - 1)
-	{
-		// Having checked the adjacencies, check the diagonals
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x - 1, v.y - 1))))
-		{
-			count++;
-		}
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x + 1, v.y + 1))))
-		{
-			count++;
-		}
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x + 1, v.y - 1))))
-		{
-			count++;
-		}
-		if (!TileCanWalk(MapGetTile(map, svec2i(v.x - 1, v.y + 1))))
-		{
-			count++;
-		}
-	}
-	return count;
-}
-
+static void AddObjectDensity(MapBuilder *mb, const MapObjectDensity *mod);
 static void AddObjectives(MapBuilder *mb);
 static void AddKeys(MapBuilder *mb);
 void MapLoadDynamic(MapBuilder *mb)
@@ -435,11 +421,7 @@ void MapLoadDynamic(MapBuilder *mb)
 
 	// Add map objects
 	CA_FOREACH(const MapObjectDensity, mod, mb->mission->MapObjectDensities)
-	for (int j = 0;
-		 j < (mod->Density * mb->Map->Size.x * mb->Map->Size.y) / 1000; j++)
-	{
-		MapTryPlaceOneObject(mb, MapGetRandomTile(mb->Map), mod->M, 0, true);
-	}
+	AddObjectDensity(mb, mod);
 	CA_FOREACH_END()
 
 	if (HasObjectives(gCampaign.Entry.Mode))
@@ -452,8 +434,43 @@ void MapLoadDynamic(MapBuilder *mb)
 		AddKeys(mb);
 	}
 }
+typedef struct
+{
+	MapBuilder *mb;
+	const MapObject *mo;
+} TryPlaceOneObjectData;
+static bool TryPlaceOneObject(void *data, const struct vec2i v)
+{
+	const TryPlaceOneObjectData *pData = data;
+	return MapTryPlaceOneObject(pData->mb, v, pData->mo, 0, true);
+}
+static void AddObjectDensity(MapBuilder *mb, const MapObjectDensity *mod)
+{
+	if (MapObjectIsDisabled(mod->M))
+	{
+		return;
+	}
+	// Density is per 1000 tiles; only count the tiles that the object's
+	// rules allow, as those are the only tiles it can be placed on
+	const int rules = MapObjectGetPlacementRules(mod->M);
+	const int count =
+		mod->Density * MapPlacementCount(&mb->placement, rules) / 1000;
+	TryPlaceOneObjectData data;
+	data.mb = mb;
+	data.mo = mod->M;
+	for (int i = 0; i < count; i++)
+	{
+		if (!MapPlacementTryPlace(
+				&mb->placement, rules, TryPlaceOneObject, &data))
+		{
+			LOG(LM_MAP, LL_DEBUG, "placed %d/%d of map object %s", i, count,
+				mod->M->Name);
+			break;
+		}
+	}
+}
 static bool MapTryPlaceBlowup(MapBuilder *mb, const int objective);
-static int MapTryPlaceCollectible(MapBuilder *mb, const int objective);
+static bool MapTryPlaceCollectible(MapBuilder *mb, const int objective);
 static void AddObjectives(MapBuilder *mb)
 {
 	// Try to add the objectives
@@ -464,25 +481,19 @@ static void AddObjectives(MapBuilder *mb)
 	{
 		continue;
 	}
-	if (o->Type == OBJECTIVE_COLLECT)
+	// Every suitable tile is tried before giving up, so stop at the first
+	// failure
+	while (o->placed < o->Count &&
+		   (o->Type == OBJECTIVE_COLLECT
+				? MapTryPlaceCollectible(mb, _ca_index)
+				: MapTryPlaceBlowup(mb, _ca_index)))
 	{
-		for (int i = o->placed; i < o->Count; i++)
-		{
-			if (MapTryPlaceCollectible(mb, _ca_index))
-			{
-				o->placed++;
-			}
-		}
+		o->placed++;
 	}
-	else if (o->Type == OBJECTIVE_DESTROY)
+	if (o->placed < o->Count)
 	{
-		for (int i = o->placed; i < o->Count; i++)
-		{
-			if (MapTryPlaceBlowup(mb, _ca_index))
-			{
-				o->placed++;
-			}
-		}
+		LOG(LM_MAP, LL_WARN, "placed %d/%d of objective %d", o->placed,
+			o->Count, _ca_index);
 	}
 	o->Count = o->placed;
 	if (o->Count < o->Required)
@@ -491,30 +502,54 @@ static void AddObjectives(MapBuilder *mb)
 	}
 	CA_FOREACH_END()
 }
-static int MapTryPlaceCollectible(MapBuilder *mb, const int objective)
+typedef struct
+{
+	MapBuilder *mb;
+	int objective;
+	bool locked;
+	bool unlocked;
+} TryPlaceObjectiveData;
+static TryPlaceObjectiveData MakeTryPlaceObjectiveData(
+	MapBuilder *mb, const int objective)
 {
 	const Objective *o = CArrayGet(&mb->mission->Objectives, objective);
-	const bool hasLockedRooms =
-		(o->Flags & OBJECTIVE_HIACCESS) && MapHasLockedRooms(mb->Map);
-	const bool noaccess = o->Flags & OBJECTIVE_NOACCESS;
-	int i = (noaccess || hasLockedRooms) ? 1000 : 100;
-
-	while (i)
+	const PlacementAccessFlags paFlags = ObjectiveGetPlacementAccessFlags(o);
+	TryPlaceObjectiveData data;
+	data.mb = mb;
+	data.objective = objective;
+	data.locked =
+		paFlags == PLACEMENT_ACCESS_LOCKED && MapHasLockedRooms(mb->Map);
+	data.unlocked = paFlags == PLACEMENT_ACCESS_NOT_LOCKED;
+	return data;
+}
+static bool TryPlaceObjectiveIsAccessOK(
+	const TryPlaceObjectiveData *data, const struct vec2i v)
+{
+	const bool isInLocked = MapTileIsInLockedRoom(data->mb->Map, v);
+	return (!data->locked || isInLocked) && (!data->unlocked || !isInLocked);
+}
+static bool TryPlaceOneCollectible(void *data, const struct vec2i v);
+static bool MapTryPlaceCollectible(MapBuilder *mb, const int objective)
+{
+	TryPlaceObjectiveData data = MakeTryPlaceObjectiveData(mb, objective);
+	return MapPlacementTryPlace(
+		&mb->placement, PLACEMENT_RULE_WALKABLE, TryPlaceOneCollectible,
+		&data);
+}
+static bool TryPlaceOneCollectible(void *data, const struct vec2i v)
+{
+	const TryPlaceObjectiveData *pData = data;
+	if (!TryPlaceObjectiveIsAccessOK(pData, v))
 	{
-		const struct vec2 v = MapGetRandomPos(mb->Map);
-		const struct vec2i size = svec2i(COLLECTABLE_W, COLLECTABLE_H);
-		if (!IsCollisionWithWall(v, size))
-		{
-			if ((!hasLockedRooms || MapPosIsInLockedRoom(mb->Map, v)) &&
-				(!noaccess || !MapPosIsInLockedRoom(mb->Map, v)))
-			{
-				MapPlaceCollectible(mb->mission, objective, v);
-				return 1;
-			}
-		}
-		i--;
+		return false;
+	}
+	const struct vec2 pos = MapGetRandomPosInTile(v, RNG_MAPGEN);
+	if (IsCollisionWithWall(pos, svec2i(COLLECTABLE_W, COLLECTABLE_H)))
+	{
+		return false;
 	}
-	return 0;
+	MapPlaceCollectible(pData->mb->mission, pData->objective, pos);
+	return true;
 }
 static void MapPlaceCard(
 	MapBuilder *mb, const int keyIndex, const int mapAccess);
@@ -537,45 +572,62 @@ static void AddKeys(MapBuilder *mb)
 		MapPlaceCard(mb, 0, 0);
 	}
 }
+typedef struct
+{
+	MapBuilder *mb;
+	int keyIndex;
+	int mapAccess;
+} TryPlaceOneCardData;
+static bool TryPlaceOneCard(void *data, const struct vec2i v);
 static void MapPlaceCard(
 	MapBuilder *mb, const int keyIndex, const int mapAccess)
 {
-	for (;;)
-	{
-		const struct vec2i v = MapGetRandomTile(mb->Map);
-		const Tile *t = MapGetTile(mb->Map, v);
-		if (t->Class->IsRoom && TileIsClear(t) && TileCanWalk(t) &&
-			MapBuildGetAccess(mb, v) == mapAccess &&
-			// Ensure keys are visible, not hidden behind walls
-			TileIsClear(MapGetTile(mb->Map, svec2i(v.x, v.y + 1))))
-		{
-			MapPlaceKey(mb, v, keyIndex);
-			return;
-		}
+	TryPlaceOneCardData data;
+	data.mb = mb;
+	data.keyIndex = keyIndex;
+	data.mapAccess = mapAccess;
+	// Ensure keys are visible, not hidden behind walls
+	const int rules = PLACEMENT_RULE_WALKABLE | (1 << PLACEMENT_INSIDE) |
+					  (1 << PLACEMENT_FREE_IN_FRONT);
+	if (!MapPlacementTryPlace(&mb->placement, rules, TryPlaceOneCard, &data))
+	{
+		LOG(LM_MAP, LL_ERROR, "cannot place key %d; no room with access %d",
+			keyIndex, mapAccess);
 	}
 }
-typedef struct
+static bool TryPlaceOneCard(void *data, const struct vec2i v)
 {
-	const Objective *o;
-	int objective;
-} TryPlaceOneBlowupData;
-static bool TryPlaceOneBlowup(
-	MapBuilder *mb, const struct vec2i tilePos, void *data);
+	const TryPlaceOneCardData *pData = data;
+	const Map *map = pData->mb->Map;
+	if (TileIsClear(MapGetTile(map, v)) &&
+		MapBuildGetAccess(pData->mb, v) == pData->mapAccess &&
+		TileIsClear(MapGetTile(map, svec2i(v.x, v.y + 1))))
+	{
+		MapPlaceKey(pData->mb, v, pData->keyIndex);
+		return true;
+	}
+	return false;
+}
+static bool TryPlaceOneBlowup(void *data, const struct vec2i v);
 static bool MapTryPlaceBlowup(MapBuilder *mb, const int objective)
 {
-	TryPlaceOneBlowupData data;
-	data.o = CArrayGet(&mb->mission->Objectives, objective);
-	const PlacementAccessFlags paFlags =
-		ObjectiveGetPlacementAccessFlags(data.o);
-	data.objective = objective;
-	return MapPlaceRandomTile(mb, paFlags, TryPlaceOneBlowup, &data);
+	TryPlaceObjectiveData data = MakeTryPlaceObjectiveData(mb, objective);
+	const Objective *o = CArrayGet(&mb->mission->Objectives, objective);
+	return MapPlacementTryPlace(
+		&mb->placement, MapObjectGetPlacementRules(o->u.MapObject),
+		TryPlaceOneBlowup, &data);
 }
-static bool TryPlaceOneBlowup(
-	MapBuilder *mb, const struct vec2i tilePos, void *data)
+static bool TryPlaceOneBlowup(void *data, const struct vec2i v)
 {
-	const TryPlaceOneBlowupData *pData = data;
+	const TryPlaceObjectiveData *pData = data;
+	if (!TryPlaceObjectiveIsAccessOK(pData, v))
+	{
+		return false;
+	}
+	const Objective *o =
+		CArrayGet(&pData->mb->mission->Objectives, pData->objective);
 	return MapTryPlaceOneObject(
-		mb, tilePos, pData->o->u.MapObject, ObjectiveToThing(pData->objective),
+		pData->mb, v, o->u.MapObject, ObjectiveToThing(pData->objective),
 		true);
 }
 
@@ -630,11 +682,24 @@ static bool MapTileIsNormalFloor(const MapBuilder *mb, const struct vec2i pos)
 	return true;
 }
 
-static void MapSetupTilesAndWalls(MapBuilder *mb)
+static void SetupTileRows(void *data, const int start, const int end)
 {
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
+	MapBuilder *mb = data;
+	const Rect2i r =
+		Rect2iNew(svec2i(0, start), svec2i(mb->Map->Size.x, end - start));
+	RECT_FOREACH(r)
 	MapSetupTile(mb, _v);
 	RECT_FOREACH_END()
+}
+void MapBuilderSetupTiles(MapBuilder *mb)
+{
+	// Each tile only depends on the builder's tiles, so rows can be set up
+	// in parallel
+	ParallelForBands(mb->Map->Size.y, MIN_BAND_ROWS, SetupTileRows, mb);
+}
+static void MapSetupTilesAndWalls(MapBuilder *mb)
+{
+	MapBuilderSetupTiles(mb);
 
 	if (mb->mission->Type != MAPTYPE_STATIC || mb->mission->u.Static.AltFloorsEnabled)
 	{
@@ -671,8 +736,11 @@ static void MapSetupTile(MapBuilder *mb, const struct vec2i pos)
 {
 	if (!MapIsTileIn(mb->Map, pos))
 		return;
-	const Tile *tAbove = MapGetTile(mb->Map, svec2i(pos.x, pos.y - 1));
-	const bool canSeeTileAbove = !(tAbove != NULL && TileIsOpaque(tAbove));
+	// Set up tiles have the opacity of their builder tiles; use those so
+	// that this doesn't depend on the tile above being set up first
+	const TileClass *tcAbove =
+		MapBuilderGetTile(mb, svec2i(pos.x, pos.y - 1));
+	const bool canSeeTileAbove = !(tcAbove != NULL && tcAbove->isOpaque);
 	Tile *t = MapGetTile(mb->Map, pos);
 	if (!t)
 	{
@@ -815,7 +883,9 @@ struct vec2i MapGetRoomSize(const RoomParams r, const int doorMin)
 	// make sure room is large enough to accommodate doors
 	const int roomMin = MAX(r.Min, doorMin + 2);
 	const int roomMax = MAX(r.Max, doorMin + 2);
-	return svec2i(RAND_INT(roomMin, roomMax), RAND_INT(roomMin, roomMax));
+	return svec2i(
+		RAND_INT(RNG_MAPGEN, roomMin, roomMax),
+		RAND_INT(RNG_MAPGEN, roomMin, roomMax));
 }
 
 static bool MapBuilderGetIsRoom(const MapBuilder *mb, const struct vec2i pos);
@@ -901,11 +971,15 @@ bool MapTryBuildWall(
 	const struct vec2i v =
 		Rect2iIsZero(r) ?
 		MapGetRandomTile(mb->Map) :
-		svec2i_add(r.Pos, svec2i(rand() % r.Size.x, rand() % r.Size.y));
+		svec2i_add(
+			r.Pos, svec2i(
+					   RAND_INT(RNG_MAPGEN, 0, r.Size.x),
+					   RAND_INT(RNG_MAPGEN, 0, r.Size.y)));
 	if (MapIsValidStartForWall(mb, v, isRoom, pad))
 	{
 		MapBuilderSetTile(mb, v, wall);
-		MapGrowWall(mb, v, isRoom, pad, rand() & 3, wallLength, wall);
+		MapGrowWall(
+			mb, v, isRoom, pad, RAND_INT(RNG_MAPGEN, 0, 4), wallLength, wall);
 		return true;
 	}
 	return false;
@@ -1003,11 +1077,11 @@ static void MapGrowWall(
 	}
 	MapBuilderSetTile(mb, pos, wall);
 	length--;
-	if (length > 0 && (rand() & 3) == 0)
+	if (length > 0 && RAND_INT(RNG_MAPGEN, 0, 4) == 0)
 	{
 		// Randomly try to grow the wall in a different direction
-		l = rand() % length;
-		MapGrowWall(mb, pos, isRoom, pad, rand() & 3, l, wall);
+		l = RAND_INT(RNG_MAPGEN, 0, length);
+		MapGrowWall(mb, pos, isRoom, pad, RAND_INT(RNG_MAPGEN, 0, 4), l, wall);
 		length -= l;
 	}
 	// Keep growing wall in same direction
@@ -1086,7 +1160,7 @@ void MapPlaceDoors(
 		{
 			continue;
 		}
-		const int doorSize = doorMax > doorMin ? RAND_INT(doorMin, doorMax) : doorMin;
+		const int doorSize = doorMax > doorMin ? RAND_INT(RNG_MAPGEN, doorMin, doorMax) : doorMin;
 		int roomDim;
 		struct vec2i d;
 		struct vec2i doorStart;
@@ -1133,7 +1207,7 @@ static void PlaceDoors(MapBuilder *mb, const int doorSize, const int roomDim, co
 	struct vec2i start = doorStart;
 	if (randomPos)
 	{
-		start = svec2i_add(start, svec2i_scale(dAcross, (float)RAND_INT(1, roomDim - size - 1)));
+		start = svec2i_add(start, svec2i_scale(dAcross, (float)RAND_INT(RNG_MAPGEN, 1, roomDim - size - 1)));
 	}
 	else
 	{
@@ -1427,7 +1501,7 @@ void MapFillRect(MapBuilder *mb, const Rect2i r, const TileClass *edge, const Ti
 uint16_t GenerateAccessMask(int *accessLevel)
 {
 	uint16_t accessMask = 0;
-	switch (rand() % 20)
+	switch (RAND_INT(RNG_MAPGEN, 0, 20))
 	{
 	case 0:
 		if (*accessLevel >= 4)
@@ -1480,22 +1554,43 @@ uint16_t GenerateAccessMask(int *accessLevel)
 	return accessMask;
 }
 
-static void MapGenerateRandomExitArea(Map *map, const int mission)
+typedef struct
+{
+	const Map *map;
+	Exit *exit;
+} TryPlaceExitData;
+static bool TryPlaceExit(void *data, const struct vec2i v);
+static void MapGenerateRandomExitArea(MapBuilder *mb, const int mission)
 {
-	const Tile *t = NULL;
 	Exit exit;
 	exit.Mission = mission + 1;
 	exit.Hidden = false;
-	for (int i = 0; i < 10000 && (t == NULL || !TileCanWalk(t)); i++)
+	exit.R = Rect2iNew(
+		svec2i_zero(), svec2i(EXIT_WIDTH + 1, EXIT_HEIGHT + 1));
+	// Centre the exit area on a walkable tile
+	TryPlaceExitData data;
+	data.map = mb->Map;
+	data.exit = &exit;
+	if (!MapPlacementTryPlace(
+			&mb->placement, PLACEMENT_RULE_WALKABLE, TryPlaceExit, &data))
+	{
+		LOG(LM_MAP, LL_ERROR, "no walkable tile for exit area");
+	}
+	CArrayPushBack(&mb->Map->exits, &exit);
+}
+static bool TryPlaceExit(void *data, const struct vec2i v)
+{
+	const TryPlaceExitData *pData = data;
+	const struct vec2i pos = svec2i_subtract(
+		v, svec2i_scale_divide(pData->exit->R.Size, 2));
+	if (pos.x < 0 || pos.y < 0 ||
+		pos.x >= pData->map->Size.x - EXIT_WIDTH - 1 ||
+		pos.y >= pData->map->Size.y - EXIT_HEIGHT - 1)
 	{
-		exit.R.Pos.x = (rand() % (abs(map->Size.x) - EXIT_WIDTH - 1));
-		exit.R.Size.x = EXIT_WIDTH + 1;
-		exit.R.Pos.y = (rand() % (abs(map->Size.y) - EXIT_HEIGHT - 1));
-		exit.R.Size.y = EXIT_HEIGHT + 1;
-		// Check that the exit area is walkable
-		t = MapGetTile(map, Rect2iCenter(exit.R));
+		return false;
 	}
-	CArrayPushBack(&map->exits, &exit);
+	pData->exit->R.Pos = pos;
+	return true;
 }
 
 static void MapAddDrains(MapBuilder *mb)
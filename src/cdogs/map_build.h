@@ -50,6 +50,7 @@
 
 #include "game_mode.h"
 #include "map.h"
+#include "map_placement.h"
 #include "mission.h"
 
 typedef struct
@@ -63,8 +64,16 @@ typedef struct
 	CArray access;	  // of uint16_t
 	CArray tiles;	  // of TileClass
 	CArray leaveFree; // of bool
+	// Set up once the tiles are final, for placing objects
+	MapPlacement placement;
 } MapBuilder;
 
+// Called between the phases of MapBuild with the phase name and the
+// fraction done, e.g. to redraw the loading screen
+typedef void (*MapBuildProgressFunc)(
+	void *data, const char *phase, const float pct);
+void MapBuildSetProgress(MapBuildProgressFunc func, void *data);
+
 void MapBuild(
 	Map *m, const Mission *mission, const bool loadDynamic, const int missionIndex, const GameMode mode, const CharacterStore *characters);
 void MapBuilderInit(
@@ -93,10 +102,6 @@ void MapPlaceCollectible(
 // TODO: refactor
 void MapPlaceKey(
 	MapBuilder *mb, const struct vec2i tilePos, const int keyIndex);
-bool MapPlaceRandomTile(
-	MapBuilder *mb, const PlacementAccessFlags paFlags,
-	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, void *),
-	void *data);
 
 bool MapIsAreaInside(
 	const Map *map, const struct vec2i pos, const struct vec2i size);
@@ -136,6 +141,8 @@ void MapPlaceDoors(
 
 void MapBuildTile(
 	MapBuilder *mb, const struct vec2i pos, const TileClass *tile);
+// Set up the map's tiles and wall pics from the builder's tiles
+void MapBuilderSetupTiles(MapBuilder *mb);
 
 uint16_t GenerateAccessMask(int *accessLevel);
 
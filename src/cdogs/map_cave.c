@@ -28,10 +28,11 @@
 #include "map_cave.h"
 
 #include "algorithms.h"
+#include "cave_grid.h"
 #include "log.h"
 #include "map_build.h"
+#include "map_regions.h"
 
-static void CaveRep(MapBuilder *mb, const int r1, const int r2);
 static void LinkDisconnectedAreas(MapBuilder *mb);
 static void FixCorridors(MapBuilder *mb, const int corridorWidth);
 static void PlaceSquares(MapBuilder *mb, const int squares);
@@ -50,12 +51,32 @@ void MapCaveLoad(MapBuilder *mb)
 			svec2i(i % mb->Map->Size.x, i / mb->Map->Size.x);
 		MapBuilderSetTile(mb, pos, &mb->mission->u.Cave.TileClasses.Wall);
 	}
-	// Shuffle
-	CArrayShuffle(&mb->tiles);
-	// Repetitions
-	for (int i = 0; i < mb->mission->u.Cave.Repeat; i++)
+	if (mb->mission->u.Cave.Repeat > 0)
+	{
+		// Run the automaton on walls alone; tile classes only need setting
+		// once all the generations are done
+		CaveGrid g;
+		CaveGridInit(&g, mb->Map->Size);
+		RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
+		CaveGridSetWall(
+			&g, _v, MapBuilderGetTile(mb, _v)->Type == TILE_CLASS_WALL);
+		RECT_FOREACH_END()
+		CaveGridShuffle(&g, RNG_MAPGEN);
+		for (int i = 0; i < mb->mission->u.Cave.Repeat; i++)
+		{
+			CaveGridStep(&g, mb->mission->u.Cave.R1, mb->mission->u.Cave.R2);
+		}
+		RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
+		MapBuilderSetTile(
+			mb, _v,
+			CaveGridIsWall(&g, _v) ? &mb->mission->u.Cave.TileClasses.Wall
+								   : &mb->mission->u.Cave.TileClasses.Floor);
+		RECT_FOREACH_END()
+		CaveGridTerminate(&g);
+	}
+	else
 	{
-		CaveRep(mb, mb->mission->u.Cave.R1, mb->mission->u.Cave.R2);
+		CArrayShuffle(&mb->tiles, RNG_MAPGEN);
 	}
 
 	LinkDisconnectedAreas(mb);
@@ -67,164 +88,34 @@ void MapCaveLoad(MapBuilder *mb)
 	PlaceRooms(mb);
 }
 
-// Perform one generation of cellular automata
-// If the number of walls within 1 distance is at least R1, OR
-// if the number of walls within 2 distance is at most R2, then the tile
-// becomes a wall; otherwise it is a floor
-static int CountWallsAround(
-	const MapBuilder *mb, const struct vec2i pos, const int d);
-static void CaveRep(MapBuilder *mb, const int r1, const int r2)
-{
-	CArray buf;
-	CArrayInitFill(
-		&buf, mb->tiles.elemSize, mb->tiles.size,
-		&mb->mission->u.Cave.TileClasses.Floor);
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-	TileClass *tile = CArrayGet(&buf, _i);
-	if (CountWallsAround(mb, _v, 1) >= r1 || CountWallsAround(mb, _v, 2) <= r2)
-	{
-		*tile = mb->mission->u.Cave.TileClasses.Wall;
-	}
-	else
-	{
-		*tile = mb->mission->u.Cave.TileClasses.Floor;
-	}
-	RECT_FOREACH_END()
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-	MapBuilderSetTile(mb, _v, CArrayGet(&buf, _i));
-	RECT_FOREACH_END()
-	CArrayTerminate(&buf);
-}
-static int CountWallsAround(
-	const MapBuilder *mb, const struct vec2i pos, const int d)
-{
-	int c = 0;
-	RECT_FOREACH(Rect2iNew(
-		svec2i_subtract(pos, svec2i(d, d)), svec2i(2 * d + 1, 2 * d + 1)))
-	// Also count edge of maps
-	if (!MapIsTileIn(mb->Map, _v) ||
-		MapBuilderGetTile(mb, _v)->Type == TILE_CLASS_WALL)
-	{
-		c++;
-	}
-	RECT_FOREACH_END()
-	return c;
-}
-
-static void MapFloodFill(
-	CArray *fl, const struct vec2i size, const int idx, const int elem);
 static void AddCorridor(
 	MapBuilder *mb, const struct vec2i v1, const struct vec2i v2,
 	const struct vec2i dInit, const TileClass *tile);
+static bool IsNotWall(void *data, struct vec2i v);
 static void LinkDisconnectedAreas(MapBuilder *mb)
 {
-	// Use flood fill to identify disconnected areas
-	CArray fl;
-	CArrayInitFillZero(&fl, sizeof(int), mb->tiles.size);
-	// First copy across the wall tiles (as -1)
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-	const TileClass *tile = MapBuilderGetTile(mb, _v);
-	if (tile->Type == TILE_CLASS_WALL)
-	{
-		*(int *)CArrayGet(&fl, _i) = -1;
-	}
-	RECT_FOREACH_END()
-	// Then perform flood fill conditionally on the flood layer
-	int idx = 1;
-	CA_FOREACH(int, i, fl)
-	if (*i == 0)
-	{
-		MapFloodFill(&fl, mb->Map->Size, _ca_index, idx);
-		idx++;
-	}
+	// Find the disconnected areas, and a random tile in each
+	MapRegions r;
+	MapRegionsInit(&r, mb->Map->Size, IsNotWall, mb, RNG_MAPGEN);
+	// Connect the areas with the shortest corridors between those tiles
+	CArray links;
+	MapRegionsLinks(&r, &links);
+	CA_FOREACH(const MapRegionLink, l, links)
+	const struct vec2i v1 = MapRegionsGetRep(&r, l->A);
+	const struct vec2i v2 = MapRegionsGetRep(&r, l->B);
+	const struct vec2i delta = svec2i(abs(v1.x - v2.x), abs(v1.y - v2.y));
+	const int dx = delta.x > delta.y ? 1 : 0;
+	const int dy = 1 - dx;
+	AddCorridor(
+		mb, v1, v2, svec2i(dx, dy), &mb->mission->u.Cave.TileClasses.Floor);
 	CA_FOREACH_END()
-
-	const int numAreas = idx - 1;
-	// Connect the disconnected areas, first to second, second to third etc.
-	// Select random tile from each area, using index shuffle
-	CArray areaTiles;
-	CArrayInit(&areaTiles, sizeof(int));
-	CA_FOREACH(int, i, fl)
-	UNUSED(i);
-	CArrayPushBack(&areaTiles, &_ca_index);
-	CA_FOREACH_END()
-	CArrayShuffle(&areaTiles);
-	CArray areaStarts;
-	CArrayInitFillZero(&areaStarts, sizeof(int), numAreas);
-	CA_FOREACH(int, areaIdx, areaTiles)
-	const int tile = *(int *)CArrayGet(&fl, *areaIdx) - 1;
-	if (tile >= 0 && tile < numAreas)
-	{
-		int *areaStart = CArrayGet(&areaStarts, tile);
-		if (*areaStart == 0)
-		{
-			*areaStart = *areaIdx;
-		}
-	}
-	CA_FOREACH_END()
-	CArrayTerminate(&fl);
-	CArrayTerminate(&areaTiles);
-	// Connect consecutive pairs of tiles
-	for (int i = 0; i < (int)areaStarts.size - 1; i++)
-	{
-		const int *a1 = CArrayGet(&areaStarts, i);
-		const int *a2 = CArrayGet(&areaStarts, i + 1);
-		const struct vec2i v1 =
-			svec2i(*a1 % mb->Map->Size.x, *a1 / mb->Map->Size.x);
-		const struct vec2i v2 =
-			svec2i(*a2 % mb->Map->Size.x, *a2 / mb->Map->Size.x);
-		const struct vec2i delta = svec2i(abs(v1.x - v2.x), abs(v1.y - v2.y));
-		const int dx = delta.x > delta.y ? 1 : 0;
-		const int dy = 1 - dx;
-		AddCorridor(
-			mb, v1, v2, svec2i(dx, dy),
-			&mb->mission->u.Cave.TileClasses.Floor);
-	}
-	CArrayTerminate(&areaStarts);
+	CArrayTerminate(&links);
+	MapRegionsTerminate(&r);
 }
-
-static void MapFloodFill(
-	CArray *fl, const struct vec2i size, const int idx, const int elem)
+static bool IsNotWall(void *data, struct vec2i v)
 {
-	CArray indices;
-	CArrayInit(&indices, sizeof(int));
-	CArrayPushBack(&indices, &idx);
-	const int floodTile = *(int *)CArrayGet(fl, idx);
-	*(int *)CArrayGet(fl, idx) = elem;
-	CA_FOREACH(int, i, indices)
-	const int x = *i % size.x;
-	const int y = *i / size.x;
-	int next;
-	// top
-	next = (y - 1) * size.x + x;
-	if (y > 0 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	// bottom
-	next = (y + 1) * size.x + x;
-	if (y < size.y - 1 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	// left
-	next = y * size.x + x - 1;
-	if (x > 0 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	// right
-	next = y * size.x + x + 1;
-	if (x < size.x - 1 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	CA_FOREACH_END()
-	CArrayTerminate(&indices);
+	const MapBuilder *mb = data;
+	return MapBuilderGetTile(mb, v)->Type != TILE_CLASS_WALL;
 }
 
 // Add an S-shaped corridor from one point to another, filling it with a
@@ -398,7 +289,8 @@ static void PlaceSquares(MapBuilder *mb, const int squares)
 	for (int i = 0; i < 1000 && count < squares; i++)
 	{
 		const struct vec2i v = MapGetRandomTile(mb->Map);
-		const struct vec2i size = svec2i(rand() % 9 + 8, rand() % 9 + 8);
+		const struct vec2i size = svec2i(
+			RAND_INT(RNG_MAPGEN, 8, 17), RAND_INT(RNG_MAPGEN, 8, 17));
 		if (!MapIsAreaClearForCaveSquare(mb, v, size))
 		{
 			continue;
@@ -154,7 +154,8 @@ void MapClassicLoad(MapBuilder *mb)
 static int MapTryBuildSquare(MapBuilder *mb)
 {
 	const struct vec2i v = MapGetRandomTile(mb->Map);
-	struct vec2i size = svec2i(rand() % 9 + 8, rand() % 9 + 8);
+	struct vec2i size =
+		svec2i(RAND_INT(RNG_MAPGEN, 8, 17), RAND_INT(RNG_MAPGEN, 8, 17));
 	if (MapIsAreaClear(mb, v, size))
 	{
 		MapFillRect(
@@ -234,7 +235,7 @@ static void MapBuildRoom(
 	const int doorMin, const int doorMax, const bool hasKeys,
 	const bool isOverlapRoom, const uint16_t overlapAccess)
 {
-	int doormask = rand() % 15 + 1;
+	int doormask = RAND_INT(RNG_MAPGEN, 1, 16);
 	bool doors[4];
 	int doorsUnplaced = 0;
 	int i;
@@ -311,8 +312,8 @@ static bool MapTryBuildPillar(MapBuilder *mb, const int pad)
 	const int pillarMin = mb->mission->u.Classic.Pillars.Min;
 	const int pillarMax = mb->mission->u.Classic.Pillars.Max;
 	struct vec2i size = svec2i(
-		rand() % (pillarMax - pillarMin + 1) + pillarMin,
-		rand() % (pillarMax - pillarMin + 1) + pillarMin);
+		RAND_INT(RNG_MAPGEN, pillarMin, pillarMax + 1),
+		RAND_INT(RNG_MAPGEN, pillarMin, pillarMax + 1));
 	const struct vec2i pos = MapGetRandomTile(mb->Map);
 	struct vec2i clearPos = svec2i(pos.x - pad, pos.y - pad);
 	struct vec2i clearSize = svec2i(size.x + 2 * pad, size.y + 2 * pad);
@@ -202,7 +202,7 @@ static bool BSPAreaTrySplit(
 	const int minSize, BSPArea *r1, BSPArea *r2);
 static void SplitAreas(MapBuilder *mb, CArray *areas)
 {
-	const int hcount = RAND_INT(0, 2);
+	const int hcount = RAND_INT(RNG_MAPGEN, 0, 2);
 
 	// Need to allow at least one split
 	const int minSize =
@@ -286,7 +286,7 @@ static bool BSPAreaTrySplit(
 	if (horizontal)
 	{
 		// Left/right children
-		const int x = RAND_INT(0, r) + minSize;
+		const int x = RAND_INT(RNG_MAPGEN, 0, r) + minSize;
 		a1->r = Rect2iNew(area->r.Pos, svec2i(x, area->r.Size.y));
 		a2->r = Rect2iNew(
 			svec2i(area->r.Pos.x + x, area->r.Pos.y),
@@ -295,7 +295,7 @@ static bool BSPAreaTrySplit(
 	else
 	{
 		// Top/bottom children
-		const int y = RAND_INT(0, r) + minSize;
+		const int y = RAND_INT(RNG_MAPGEN, 0, r) + minSize;
 		a1->r = Rect2iNew(area->r.Pos, svec2i(area->r.Size.x, y));
 		a2->r = Rect2iNew(
 			svec2i(area->r.Pos.x, area->r.Pos.y + y),
@@ -816,7 +816,8 @@ static void PlaceKeys(
 	while (lockedRoomCandidates.size > KEY_COUNT)
 	{
 		CArrayDelete(
-			&lockedRoomCandidates, RAND_INT(0, lockedRoomCandidates.size));
+			&lockedRoomCandidates,
+			RAND_INT(RNG_MAPGEN, 0, (int)lockedRoomCandidates.size));
 	}
 
 	CA_FOREACH(const int, idx, lockedRoomCandidates)
@@ -861,7 +862,7 @@ static void PlaceKeys(
 	// Place key in a child room before the locked corridor, but far away
 	CArray furthestChildren =
 		FindRoomsFurthestFromCriticalPath(areas, am, dCriticalPath, *idx);
-	CArrayShuffle(&furthestChildren);
+	CArrayShuffle(&furthestChildren, RNG_MAPGEN);
 	CASSERT(furthestChildren.size > 0, "Cannot find child for locked street");
 
 	const int child = *(int *)CArrayGet(&furthestChildren, 0);
@@ -913,7 +914,7 @@ static void AddLockedRooms(
 	{
 		continue;
 	}
-	if (RAND_BOOL())
+	if (RAND_BOOL(RNG_MAPGEN))
 	{
 		const BSPArea *room = CArrayGet(areas, *idx);
 		MapSetRoomAccessMask(
@@ -1000,7 +1001,7 @@ static void AddPillars(
 		{
 			break;
 		}
-		CArrayShuffle(&allChildren);
+		CArrayShuffle(&allChildren, RNG_MAPGEN);
 		CA_FOREACH(const int, idx, allChildren)
 		if (count == mb->mission->u.Interior.Pillars.Count)
 		{
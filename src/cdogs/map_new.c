@@ -139,7 +139,8 @@ int MapNewLoad(const char *filename, CampaignSetting *c)
 	}
 	MapNewLoadCampaignJSON(root, c);
 	LoadMissions(
-		&c->Missions, json_find_first_label(root, "Missions")->child, version);
+		&c->Missions, json_find_first_label(root, "Missions")->child, version,
+		NULL);
 	CharacterLoadJSON(
 		&c->characters, &gPlayerTemplates.CustomClasses, root, version);
 
@@ -176,8 +177,11 @@ static void LoadWeapons(CArray *weapons, json_t *weaponsNode);
 static void LoadRooms(RoomParams *r, json_t *roomsNode);
 static void LoadDoors(DoorParams *d, json_t *doorsNode);
 static void LoadPillars(PillarParams *p, json_t *pillarsNode);
-void LoadMissions(CArray *missions, json_t *missionsNode, int version)
+void LoadMissions(
+	CArray *missions, json_t *missionsNode, int version,
+	const CampaignCache *cache)
 {
+	JSONTrackVisits(missionsNode, LM_MAP);
 	json_t *child;
 	int mission = 0;
 	for (child = missionsNode->child; child; child = child->next, mission++)
@@ -245,9 +249,9 @@ void LoadMissions(CArray *missions, json_t *missionsNode, int version)
 					 modNode = modNode->next)
 				{
 					MapObjectDensity mod;
-					mod.M = StrMapObject(
-						json_find_first_label(modNode, "MapObject")
-							->child->text);
+					char *moName = GetString(modNode, "MapObject");
+					mod.M = StrMapObject(moName);
+					CFREE(moName);
 					LoadInt(&mod.Density, modNode, "Density");
 					CArrayPushBack(&m.MapObjectDensities, &mod);
 				}
@@ -282,7 +286,7 @@ void LoadMissions(CArray *missions, json_t *missionsNode, int version)
 			break;
 		case MAPTYPE_STATIC:
 			if (!MissionStaticTryLoadJSON(
-					&m.u.Static, child, m.Size, version, mission))
+					&m.u.Static, child, m.Size, version, mission, cache))
 			{
 				continue;
 			}
@@ -332,6 +336,7 @@ void LoadMissions(CArray *missions, json_t *missionsNode, int version)
 		}
 		CArrayPushBack(missions, &m);
 	}
+	JSONLogUnvisited(missionsNode, LM_MAP, "missions");
 }
 
 void LoadMissionTileClasses(
@@ -452,7 +457,9 @@ static void LoadWeapons(CArray *weapons, json_t *weaponsNode)
 	{
 		for (json_t *child = weaponsNode->child; child; child = child->next)
 		{
-			const WeaponClass *wc = StrWeaponClass(child->text);
+			char *name = json_unescape(child->text);
+			const WeaponClass *wc = StrWeaponClass(name);
+			CFREE(name);
 			if (wc == NULL)
 			{
 				continue;
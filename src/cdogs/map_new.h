@@ -30,6 +30,7 @@
 #include <json/json.h>
 
 #include "c_array.h"
+#include "campaign_cache.h"
 #include "map_archive.h"
 
 int MapNewLoad(const char *filename, CampaignSetting *c);
@@ -37,6 +38,8 @@ int MapNewLoad(const char *filename, CampaignSetting *c);
 // Helper methods for loading JSON maps
 int MapNewScanJSON(json_t *root, char **title, int *numMissions);
 void MapNewLoadCampaignJSON(json_t *root, CampaignSetting *c);
-void LoadMissions(CArray *missions, json_t *missionsNode, int version);
+void LoadMissions(
+	CArray *missions, json_t *missionsNode, int version,
+	const CampaignCache *cache);
 void LoadMissionTileClasses(
 	MissionTileClasses *mtc, json_t *node, const int version);
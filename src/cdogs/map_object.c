@@ -194,7 +194,7 @@ int DestructibleMapObjectIndex(const MapObject *mo)
 }
 const MapObject *GetRandomBloodPool(void)
 {
-	const int idx = rand() % (int)gMapObjects.Bloods.size;
+	const int idx = RAND_INT(RNG_COSMETIC, 0, (int)gMapObjects.Bloods.size);
 	const char **name = CArrayGet(&gMapObjects.Bloods, idx);
 	return StrMapObject(*name);
 }
@@ -259,6 +259,7 @@ static bool TryLoadMapObject(MapObject *m, json_t *node, const int version);
 static void ReloadDestructibles(MapObjects *mo);
 void MapObjectsLoadJSON(CArray *classes, json_t *root)
 {
+	JSONTrackVisits(root, LM_MAP);
 	int version;
 	LoadInt(&version, root, "Version");
 	if (version > VERSION || version <= 0)
@@ -276,6 +277,7 @@ void MapObjectsLoadJSON(CArray *classes, json_t *root)
 			CArrayPushBack(classes, &m);
 		}
 	}
+	JSONLogUnvisited(root, LM_MAP, "map objects");
 
 	ReloadDestructibles(&gMapObjects);
 	// Load blood objects
@@ -0,0 +1,267 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "map_placement.h"
+
+#include "parallel.h"
+#include "utils.h"
+
+// Smallest band of rows worth setting up on its own thread
+#define MIN_BAND_ROWS 32
+
+static int CountWalls(
+	const Map *map, const struct vec2i v, const struct vec2i *dirs,
+	const int n);
+static int TileRules(
+	const Map *map, const struct vec2i v, const int adjacent,
+	const int around);
+typedef struct
+{
+	MapPlacement *mp;
+	const Map *map;
+} SetupRowsData;
+static void SetupRows(void *data, const int start, const int end);
+void MapPlacementInit(MapPlacement *mp, const Map *map, const RngStream s)
+{
+	memset(mp, 0, sizeof *mp);
+	mp->Size = map->Size;
+	mp->rng = s;
+	const int n = map->Size.x * map->Size.y;
+	CMALLOC(mp->WallsAdjacent, n * sizeof *mp->WallsAdjacent);
+	CMALLOC(mp->WallsAround, n * sizeof *mp->WallsAround);
+	CMALLOC(mp->Rules, n * sizeof *mp->Rules);
+	CArrayInit(&mp->candidates, sizeof(PlacementCandidates));
+	// Each tile only depends on the map, so rows can be set up in parallel
+	SetupRowsData data;
+	data.mp = mp;
+	data.map = map;
+	ParallelForBands(map->Size.y, MIN_BAND_ROWS, SetupRows, &data);
+}
+static void SetupRows(void *data, const int start, const int end)
+{
+	// Adjacent directions first, so they can be reused for the count around
+	const struct vec2i dirs[] = {
+		{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, 1}, {1, -1}, {-1, 1}};
+	const SetupRowsData *pData = data;
+	MapPlacement *mp = pData->mp;
+	const Map *map = pData->map;
+	struct vec2i v;
+	for (v.y = start; v.y < end; v.y++)
+	{
+		for (v.x = 0; v.x < map->Size.x; v.x++)
+		{
+			const int i = v.y * map->Size.x + v.x;
+			const int adjacent = CountWalls(map, v, dirs, 4);
+			const int around = adjacent + CountWalls(map, v, dirs + 4, 4);
+			mp->WallsAdjacent[i] = (uint8_t)adjacent;
+			mp->WallsAround[i] = (uint8_t)around;
+			mp->Rules[i] = (uint16_t)TileRules(map, v, adjacent, around);
+		}
+	}
+}
+static int CountWalls(
+	const Map *map, const struct vec2i v, const struct vec2i *dirs,
+	const int n)
+{
+	// Only tiles in the interior have walls counted
+	if (v.x <= 0 || v.y <= 0 || v.x >= map->Size.x - 1 ||
+		v.y >= map->Size.y - 1)
+	{
+		return 0;
+	}
+	int count = 0;
+	for (int i = 0; i < n; i++)
+	{
+		if (!TileCanWalk(MapGetTile(map, svec2i_add(v, dirs[i]))))
+		{
+			count++;
+		}
+	}
+	return count;
+}
+static int TileRules(
+	const Map *map, const struct vec2i v, const int adjacent,
+	const int around)
+{
+	const Tile *t = MapGetTile(map, v);
+	const Tile *tAbove = MapGetTile(map, svec2i(v.x, v.y - 1));
+	int rules = 1 << PLACEMENT_NONE;
+	rules |= 1 << (t->Class->IsRoom ? PLACEMENT_INSIDE : PLACEMENT_OUTSIDE);
+	if (around == 0)
+	{
+		rules |= 1 << PLACEMENT_NO_WALLS;
+	}
+	if (adjacent == 1)
+	{
+		rules |= 1 << PLACEMENT_ONE_WALL;
+	}
+	if (adjacent >= 1)
+	{
+		rules |= 1 << PLACEMENT_ONE_OR_MORE_WALLS;
+	}
+	// Whether the tile in front is clear depends on what's placed there, but
+	// it can only be clear if it can be walked on
+	if (TileCanWalk(MapGetTile(map, svec2i(v.x, v.y + 1))))
+	{
+		rules |= 1 << PLACEMENT_FREE_IN_FRONT;
+	}
+	if (tAbove != NULL && tAbove->Class->Type == TILE_CLASS_WALL)
+	{
+		rules |= 1 << PLACEMENT_ON_WALL;
+	}
+	if (TileCanWalk(t))
+	{
+		rules |= PLACEMENT_RULE_WALKABLE;
+	}
+	return rules;
+}
+void MapPlacementTerminate(MapPlacement *mp)
+{
+	CFREE(mp->WallsAdjacent);
+	CFREE(mp->WallsAround);
+	CFREE(mp->Rules);
+	CA_FOREACH(PlacementCandidates, pc, mp->candidates)
+	CArrayTerminate(&pc->Tiles);
+	CA_FOREACH_END()
+	CArrayTerminate(&mp->candidates);
+	memset(mp, 0, sizeof *mp);
+}
+
+static int TileIndex(const MapPlacement *mp, const struct vec2i v)
+{
+	return v.y * mp->Size.x + v.x;
+}
+int MapPlacementGetWallsAdjacent(
+	const MapPlacement *mp, const struct vec2i v)
+{
+	return mp->WallsAdjacent[TileIndex(mp, v)];
+}
+int MapPlacementGetWallsAround(const MapPlacement *mp, const struct vec2i v)
+{
+	return mp->WallsAround[TileIndex(mp, v)];
+}
+int MapPlacementGetRules(const MapPlacement *mp, const struct vec2i v)
+{
+	return mp->Rules[TileIndex(mp, v)];
+}
+
+int MapObjectGetPlacementRules(const MapObject *mo)
+{
+	int rules = mo->Flags & ~(1 << PLACEMENT_NONE);
+	// Objects drawn above or below others can share tiles, including walls
+	if (!mo->DrawAbove && !mo->DrawBelow)
+	{
+		rules |= PLACEMENT_RULE_WALKABLE;
+	}
+	return rules;
+}
+
+static PlacementCandidates *GetCandidates(MapPlacement *mp, const int rules)
+{
+	CA_FOREACH(PlacementCandidates, pc, mp->candidates)
+	if (pc->Rules == rules)
+	{
+		return pc;
+	}
+	CA_FOREACH_END()
+	PlacementCandidates pc;
+	pc.Rules = rules;
+	CArrayInit(&pc.Tiles, sizeof(struct vec2i));
+	const Rect2i r = Rect2iNew(svec2i_zero(), mp->Size);
+	RECT_FOREACH(r)
+	if ((mp->Rules[_i] & rules) == rules)
+	{
+		CArrayPushBack(&pc.Tiles, &_v);
+	}
+	RECT_FOREACH_END()
+	pc.Total = (int)pc.Tiles.size;
+	CArrayPushBack(&mp->candidates, &pc);
+	return CArrayGet(&mp->candidates, mp->candidates.size - 1);
+}
+int MapPlacementCount(MapPlacement *mp, const int rules)
+{
+	return GetCandidates(mp, rules)->Total;
+}
+bool MapPlacementTryPlace(
+	MapPlacement *mp, const int rules,
+	bool (*tryPlace)(void *, const struct vec2i), void *data)
+{
+	CArray *tiles = &GetCandidates(mp, rules)->Tiles;
+	// Partial shuffle: swap each drawn tile to the end of the undrawn ones
+	for (int n = (int)tiles->size; n > 0; n--)
+	{
+		struct vec2i *drawn = CArrayGet(tiles, RAND_INT(mp->rng, 0, n));
+		struct vec2i *last = CArrayGet(tiles, n - 1);
+		const struct vec2i v = *drawn;
+		*drawn = *last;
+		*last = v;
+		if (tryPlace(data, v))
+		{
+			// Use up the tile by moving the last tile into its place
+			*last = *(const struct vec2i *)CArrayGet(
+				tiles, tiles->size - 1);
+			CArrayDelete(tiles, tiles->size - 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+static int Gcd(int a, int b)
+{
+	while (b != 0)
+	{
+		const int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+void PlacementOrderInit(PlacementOrder *o, const int n, const RngStream s)
+{
+	o->n = n;
+	o->count = 0;
+	o->next = RAND_INT(s, 0, n);
+	// Any stride coprime to n visits every index before repeating; n - 1
+	// always is, so this stops
+	o->stride = RAND_INT(s, 1, n);
+	while (n > 1 && Gcd(o->stride, n) != 1)
+	{
+		o->stride++;
+	}
+}
+bool PlacementOrderNext(PlacementOrder *o, int *i)
+{
+	if (o->count >= o->n)
+	{
+		return false;
+	}
+	*i = o->next;
+	o->next = (o->next + o->stride) % o->n;
+	o->count++;
+	return true;
+}
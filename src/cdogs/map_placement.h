@@ -0,0 +1,96 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "map.h"
+#include "map_object.h"
+#include "rng.h"
+
+// Rule bit for tiles that can be walked on; the other rule bits are shifted
+// by PlacementFlags
+#define PLACEMENT_RULE_WALKABLE (1 << PLACEMENT_COUNT)
+
+// Tiles that satisfy a set of placement rules
+typedef struct
+{
+	int Rules;
+	int Total;
+	CArray Tiles; // of struct vec2i; the ones that haven't been used yet
+} PlacementCandidates;
+
+// Placement data for a map whose tiles are set up. The wall counts and the
+// rules that each tile satisfies are computed once, so that objects can be
+// placed by drawing from the tiles that suit them instead of retrying random
+// tiles.
+typedef struct
+{
+	struct vec2i Size;
+	uint8_t *WallsAdjacent; // left, right, above and below
+	uint8_t *WallsAround;	// all 8 surrounding tiles
+	uint16_t *Rules;
+	CArray candidates; // of PlacementCandidates, made on first use
+	RngStream rng;
+} MapPlacement;
+
+void MapPlacementInit(MapPlacement *mp, const Map *map, const RngStream s);
+void MapPlacementTerminate(MapPlacement *mp);
+
+int MapPlacementGetWallsAdjacent(
+	const MapPlacement *mp, const struct vec2i v);
+int MapPlacementGetWallsAround(const MapPlacement *mp, const struct vec2i v);
+int MapPlacementGetRules(const MapPlacement *mp, const struct vec2i v);
+// The rules that a tile must satisfy to hold the map object; the rest of
+// IsTileOK depends on what has already been placed
+int MapObjectGetPlacementRules(const MapObject *mo);
+
+// Number of tiles that satisfy all of the rules, used or not
+int MapPlacementCount(MapPlacement *mp, const int rules);
+// Draw tiles that satisfy all of the rules at random and without
+// replacement, until tryPlace accepts one. The accepted tile is used up for
+// these rules. Returns false if there are no tiles left that it accepts,
+// after trying each of them once.
+bool MapPlacementTryPlace(
+	MapPlacement *mp, const int rules,
+	bool (*tryPlace)(void *, const struct vec2i), void *data);
+
+// Visits the indices [0, n) once each in a random order, stepping by a
+// random stride that is coprime to n. For sampling without replacement from
+// lists that can't be shuffled.
+typedef struct
+{
+	int n;
+	int stride;
+	int next;
+	int count;
+} PlacementOrder;
+void PlacementOrderInit(PlacementOrder *o, const int n, const RngStream s);
+bool PlacementOrderNext(PlacementOrder *o, int *i);
@@ -0,0 +1,200 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "map_regions.h"
+
+#include <limits.h>
+#include <stdlib.h>
+
+#include "utils.h"
+
+// Union-find over tile indices, stored in the labels array. Roots are always
+// the smallest index in their set, so every parent comes before its child.
+static int Find(int *parents, int i)
+{
+	while (parents[i] != i)
+	{
+		// Path halving
+		parents[i] = parents[parents[i]];
+		i = parents[i];
+	}
+	return i;
+}
+static void Union(int *parents, const int a, const int b)
+{
+	const int ra = Find(parents, a);
+	const int rb = Find(parents, b);
+	if (ra < rb)
+	{
+		parents[rb] = ra;
+	}
+	else if (rb < ra)
+	{
+		parents[ra] = rb;
+	}
+}
+
+void MapRegionsInit(
+	MapRegions *r, const struct vec2i size,
+	bool (*isOpen)(void *, struct vec2i), void *data, const RngStream s)
+{
+	r->Size = size;
+	r->Count = 0;
+	CArrayInit(&r->Reps, sizeof(struct vec2i));
+	CArrayInit(&r->Sizes, sizeof(int));
+	CMALLOC(r->Labels, size.x * size.y * sizeof *r->Labels);
+	int *labels = r->Labels;
+
+	// Merge each open tile with the open tiles left of and above it
+	int i = 0;
+	for (int y = 0; y < size.y; y++)
+	{
+		for (int x = 0; x < size.x; x++, i++)
+		{
+			if (!isOpen(data, svec2i(x, y)))
+			{
+				labels[i] = -1;
+				continue;
+			}
+			labels[i] = i;
+			if (x > 0 && labels[i - 1] >= 0)
+			{
+				Union(labels, i, i - 1);
+			}
+			if (y > 0 && labels[i - size.x] >= 0)
+			{
+				Union(labels, i, i - size.x);
+			}
+		}
+	}
+
+	// Replace parents with region numbers; since parents come first, they
+	// have already been numbered. Pick each region's representative by
+	// reservoir sampling as we go.
+	i = 0;
+	for (int y = 0; y < size.y; y++)
+	{
+		for (int x = 0; x < size.x; x++, i++)
+		{
+			const int parent = labels[i];
+			if (parent < 0)
+			{
+				continue;
+			}
+			const struct vec2i v = svec2i(x, y);
+			int region;
+			if (parent == i)
+			{
+				region = r->Count++;
+				const int one = 1;
+				CArrayPushBack(&r->Sizes, &one);
+				CArrayPushBack(&r->Reps, &v);
+			}
+			else
+			{
+				region = labels[parent];
+				int *regionSize = CArrayGet(&r->Sizes, region);
+				(*regionSize)++;
+				if (RAND_INT(s, 0, *regionSize) == 0)
+				{
+					CArraySet(&r->Reps, region, &v);
+				}
+			}
+			labels[i] = region;
+		}
+	}
+}
+void MapRegionsTerminate(MapRegions *r)
+{
+	CFREE(r->Labels);
+	CArrayTerminate(&r->Reps);
+	CArrayTerminate(&r->Sizes);
+}
+
+int MapRegionsGet(const MapRegions *r, const struct vec2i v)
+{
+	return r->Labels[v.y * r->Size.x + v.x];
+}
+struct vec2i MapRegionsGetRep(const MapRegions *r, const int region)
+{
+	return *(const struct vec2i *)CArrayGet(&r->Reps, region);
+}
+
+static int Distance(const struct vec2i a, const struct vec2i b)
+{
+	return abs(a.x - b.x) + abs(a.y - b.y);
+}
+void MapRegionsLinks(const MapRegions *r, CArray *links)
+{
+	CArrayInit(links, sizeof(MapRegionLink));
+	if (r->Count < 2)
+	{
+		return;
+	}
+	// Prim's algorithm on the complete graph of regions
+	const struct vec2i *reps = r->Reps.data;
+	int *dists;
+	int *nearest;
+	CMALLOC(dists, r->Count * sizeof *dists);
+	CMALLOC(nearest, r->Count * sizeof *nearest);
+	for (int i = 1; i < r->Count; i++)
+	{
+		dists[i] = Distance(reps[0], reps[i]);
+		nearest[i] = 0;
+	}
+	// Regions in the tree are marked with a negative distance
+	dists[0] = -1;
+	for (int n = 1; n < r->Count; n++)
+	{
+		int next = -1;
+		for (int i = 1; i < r->Count; i++)
+		{
+			if (dists[i] >= 0 && (next < 0 || dists[i] < dists[next]))
+			{
+				next = i;
+			}
+		}
+		const MapRegionLink l = {nearest[next], next};
+		CArrayPushBack(links, &l);
+		dists[next] = -1;
+		for (int i = 1; i < r->Count; i++)
+		{
+			if (dists[i] < 0)
+			{
+				continue;
+			}
+			const int d = Distance(reps[next], reps[i]);
+			if (d < dists[i])
+			{
+				dists[i] = d;
+				nearest[i] = next;
+			}
+		}
+	}
+	CFREE(dists);
+	CFREE(nearest);
+}
@@ -0,0 +1,66 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include "c_array.h"
+#include "rng.h"
+#include "vector.h"
+
+// Connected regions of open tiles, e.g. cave floors that can reach each
+// other. Regions are 4-connected and numbered in the order their first tile
+// appears in row order.
+typedef struct
+{
+	struct vec2i Size;
+	int *Labels; // region of each tile, or -1 if the tile isn't open
+	int Count;
+	CArray Reps;  // of struct vec2i; a random tile from each region
+	CArray Sizes; // of int; number of tiles in each region
+} MapRegions;
+
+// A pair of regions to connect
+typedef struct
+{
+	int A;
+	int B;
+} MapRegionLink;
+
+void MapRegionsInit(
+	MapRegions *r, const struct vec2i size,
+	bool (*isOpen)(void *, struct vec2i), void *data, const RngStream s);
+void MapRegionsTerminate(MapRegions *r);
+
+int MapRegionsGet(const MapRegions *r, const struct vec2i v);
+struct vec2i MapRegionsGetRep(const MapRegions *r, const int region);
+
+// Fill links (of MapRegionLink) with the minimum spanning tree over the
+// regions, using the Manhattan distance between representative tiles.
+// Connecting every link joins all the regions with Count - 1 links.
+void MapRegionsLinks(const MapRegions *r, CArray *links);
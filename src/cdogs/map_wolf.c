@@ -33,8 +33,10 @@
 
 #include "cwolfmap/audio.h"
 #include "cwolfmap/cwolfmap.h"
+#include "files.h"
 #include "map_archive.h"
 #include "player_template.h"
+#include "wolf_cache.h"
 
 CWolfMap *defaultWolfMap = NULL;
 CWolfMap *defaultSpearMap = NULL;
@@ -47,6 +49,10 @@ CWolfMap *defaultSpearMap = NULL;
 
 #define TILE_CLASS_WALL_OFFSET 63
 
+// Music streams on the audio thread while sounds are synthesised on the
+// main thread; both use the same OPL emulator
+static SDL_mutex *oplLock = NULL;
+
 void MapWolfInit(void)
 {
 	defaultWolfMap = NULL;
@@ -55,6 +61,7 @@ void MapWolfInit(void)
 	{
 		CASSERT(false, "failed to init wolf audio!");
 	}
+	oplLock = SDL_CreateMutex();
 }
 void MapWolfTerminate(void)
 {
@@ -63,6 +70,8 @@ void MapWolfTerminate(void)
 	CWFree(defaultSpearMap);
 	defaultSpearMap = NULL;
 	CWAudioTerminate();
+	SDL_DestroyMutex(oplLock);
+	oplLock = NULL;
 }
 
 static void GetCampaignPath(
@@ -439,19 +448,46 @@ static const CWSongType songsCampaign[] = {
 	SONG_ROSTER,  // lose
 	SONG_VICTORY, // victory
 };
-static Mix_Chunk *LoadMusic(const CWolfMap *map, const int i)
+// A music stream with its own copy of the song, so that it can outlive the
+// map
+typedef struct
 {
-	char *data;
+	CWMusicStream Stream;
+	char *Data; // allocated after the struct, and freed with it
+} WolfMusicStream;
+static void FillMusic(void *data, Uint8 *stream, int len)
+{
+	WolfMusicStream *wms = data;
+	SDL_LockMutex(oplLock);
+	CWAudioMusicStreamRender(
+		&wms->Stream, (int16_t *)stream, len / (MUSIC_AUDIO_CHANNELS * 2));
+	SDL_UnlockMutex(oplLock);
+}
+static bool LoadMusic(const CWolfMap *map, const int i, MusicStream *s)
+{
+	const char *data;
 	size_t len;
-	const int err = CWAudioGetMusic(&map->audio, i, &data, &len);
+	int err = CWAudioGetMusicRaw(&map->audio, i, &data, &len);
+	if (err != 0 || len == 0)
+	{
+		return false;
+	}
+	WolfMusicStream *wms;
+	CMALLOC(wms, sizeof *wms + len);
+	wms->Data = (char *)(wms + 1);
+	memcpy(wms->Data, data, len);
+	SDL_LockMutex(oplLock);
+	err = CWAudioMusicStreamInit(&wms->Stream, wms->Data, len);
+	SDL_UnlockMutex(oplLock);
 	if (err != 0)
 	{
-		goto bail;
+		LOG(LM_MAP, LL_ERROR, "Failed to load wolf music %d: %d\n", i, err);
+		CFREE(wms);
+		return false;
 	}
-	return Mix_QuickLoad_RAW((Uint8 *)data, (Uint32)len);
-
-bail:
-	return NULL;
+	s->Fill = FillMusic;
+	s->Data = wms;
+	return true;
 }
 
 static bool IsDefaultMap(const char *filename)
@@ -596,7 +632,8 @@ bail:
 	return err;
 }
 
-static void LoadSounds(const SoundDevice *s, const CWolfMap *map);
+static void LoadSounds(
+	const SoundDevice *s, const CWolfMap *map, WolfCache *wc);
 static void LoadMission(
 	CampaignSetting *c, const map_t tileClasses, const CWolfMap *map,
 	const int spearMission, const int missionIndex, const int numMissions);
@@ -605,11 +642,12 @@ typedef struct
 	const CWolfMap *Map;
 	MusicType Type;
 } CampaignSongData;
-static Mix_Chunk *GetCampaignSong(void *data)
+static bool GetCampaignSong(void *data, MusicStream *s)
 {
 	CampaignSongData *csd = data;
 	const int songIndex = songsCampaign[csd->Type];
-	return LoadMusic(csd->Map, CWAudioGetSong(csd->Map->type, songIndex));
+	return LoadMusic(
+		csd->Map, CWAudioGetSong(csd->Map->type, songIndex), s);
 }
 int MapWolfLoad(
 	const char *filename, const int spearMission, CampaignSetting *c)
@@ -623,8 +661,28 @@ int MapWolfLoad(
 	CharacterStore cs;
 	memset(&cs, 0, sizeof cs);
 
+	WolfCache wc;
+#ifdef __EMSCRIPTEN__
+	WolfCacheInit(&wc, NULL, filename, spearMission);
+#else
+	WolfCacheInit(
+		&wc, GetConfigFilePath("cache/wolf"), filename, spearMission);
+#endif
+
 	const bool loadedFromDefault = LoadDefault(map, filename);
-	err = CWLoad(map, filename, spearMission);
+	// The levels are expanded from the game files unless they are cached
+	CWolfMap cached;
+	memset(&cached, 0, sizeof cached);
+	if (WolfCacheLoad(&wc, &cached))
+	{
+		err = CWLoadNoLevels(map, filename, spearMission);
+		map->levels = cached.levels;
+		map->nLevels = cached.nLevels;
+	}
+	else
+	{
+		err = CWLoad(map, filename, spearMission);
+	}
 	if (loadedFromDefault)
 	{
 		err = 0;
@@ -634,7 +692,8 @@ int MapWolfLoad(
 		goto bail;
 	}
 
-	LoadSounds(&gSoundDevice, map);
+	LoadSounds(&gSoundDevice, map, &wc);
+	WolfCacheStore(&wc, map);
 	for (int i = 0; i < MUSIC_COUNT; i++)
 	{
 		CampaignSongData *csd;
@@ -642,7 +701,7 @@ int MapWolfLoad(
 		csd->Map = map;
 		csd->Type = i;
 		c->CustomSongs[i].Data = csd;
-		c->CustomSongs[i].GetData = GetCampaignSong;
+		c->CustomSongs[i].GetStream = GetCampaignSong;
 		c->CustomSongs[i].Chunk = NULL;
 	}
 
@@ -722,18 +781,21 @@ bail:
 	{
 		CWFree(map);
 	}
+	WolfCacheTerminate(&wc);
 	hashmap_destroy(tileClasses, TileClassDestroy);
 	CharacterStoreTerminate(&cs);
 	return err;
 }
 
-static Mix_Chunk *LoadSoundData(const CWolfMap *map, const int i);
-static Mix_Chunk *LoadAdlibSoundData(const CWolfMap *map, const int i);
+static Mix_Chunk *GetSoundData(
+	const CWolfMap *map, WolfCache *wc, const WolfSoundType type,
+	const int i);
 static void AddNormalSound(
 	const SoundDevice *s, const char *name, Mix_Chunk *data);
 static void AddRandomSound(
 	const SoundDevice *s, const char *name, Mix_Chunk *data);
-static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
+static void LoadSounds(
+	const SoundDevice *s, const CWolfMap *map, WolfCache *wc)
 {
 	if (!s->isInitialised)
 	{
@@ -748,7 +810,7 @@ static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
 		{
 			continue;
 		}
-		Mix_Chunk *data = LoadAdlibSoundData(map, i);
+		Mix_Chunk *data = GetSoundData(map, wc, WOLF_SOUND_ADLIB, i);
 		if (name[strlen(name) - 1] == '/')
 		{
 
@@ -770,7 +832,7 @@ static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
 		}
 		if (name[strlen(name) - 1] == '/')
 			continue;
-		Mix_Chunk *data = LoadSoundData(map, i);
+		Mix_Chunk *data = GetSoundData(map, wc, WOLF_SOUND_DIGI, i);
 		if (data == NULL)
 		{
 			continue;
@@ -786,6 +848,34 @@ static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
 		}
 	}
 }
+static Mix_Chunk *LoadSoundData(const CWolfMap *map, const int i);
+static Mix_Chunk *LoadAdlibSoundData(const CWolfMap *map, const int i);
+// Get a sound from the import cache, or decode it and add it to the cache
+static Mix_Chunk *GetSoundData(
+	const CWolfMap *map, WolfCache *wc, const WolfSoundType type,
+	const int i)
+{
+	const WolfCacheSound *cs = WolfCacheGetSound(wc, type, i);
+	if (cs != NULL)
+	{
+		Uint8 *buf = SDL_malloc(cs->Len);
+		memcpy(buf, cs->Data, cs->Len);
+		Mix_Chunk *data = Mix_QuickLoad_RAW(buf, cs->Len);
+		if (data != NULL)
+		{
+			// Free the copy with the chunk
+			data->allocated = 1;
+		}
+		return data;
+	}
+	Mix_Chunk *data = type == WOLF_SOUND_ADLIB ? LoadAdlibSoundData(map, i)
+											   : LoadSoundData(map, i);
+	if (data != NULL)
+	{
+		WolfCacheAddSound(wc, type, i, data->abuf, data->alen);
+	}
+	return data;
+}
 static Mix_Chunk *LoadSoundData(const CWolfMap *map, const int i)
 {
 	const char *data;
@@ -815,7 +905,9 @@ static Mix_Chunk *LoadAdlibSoundData(const CWolfMap *map, const int i)
 {
 	char *data;
 	size_t len;
+	SDL_LockMutex(oplLock);
 	const int err = CWAudioGetAdlibSound(&map->audio, i, &data, &len);
+	SDL_UnlockMutex(oplLock);
 	if (err != 0)
 	{
 		LOG(LM_MAP, LL_ERROR, "Failed to load adlib wolf sound %d: %d\n", i,
@@ -877,11 +969,12 @@ typedef struct
 	const CWolfMap *Map;
 	int MissionIndex;
 } MissionSongData;
-static Mix_Chunk *GetMissionSong(void *data)
+static bool GetMissionSong(void *data, MusicStream *s)
 {
 	MissionSongData *msd = data;
 	return LoadMusic(
-		msd->Map, CWAudioGetLevelMusic(msd->Map->type, msd->MissionIndex));
+		msd->Map, CWAudioGetLevelMusic(msd->Map->type, msd->MissionIndex),
+		s);
 }
 static void LoadMission(
 	CampaignSetting *c, const map_t tileClasses, const CWolfMap *map,
@@ -927,7 +1020,7 @@ static void LoadMission(
 		msd->Map = map;
 		msd->MissionIndex = missionIndex;
 		m.Music.Data.Chunk.Data = msd;
-		m.Music.Data.Chunk.GetData = GetMissionSong;
+		m.Music.Data.Chunk.GetStream = GetMissionSong;
 		m.Music.Data.Chunk.Chunk = NULL;
 
 		MissionStaticInit(&m.u.Static);
@@ -369,6 +369,85 @@ void SetupMission(Mission *m, struct MissionOptions *mo, int missionIndex)
 	SetupBadguysForMission(m);
 	SetupWeapons(&mo->Weapons, &m->Weapons);
 }
+static void PrefetchWeapon(const WeaponClass *wc);
+static void PrefetchMapObject(const MapObject *mo);
+static void PrefetchCharacter(const Character *c);
+void MissionPrefetch(const Mission *m, const CharacterStore *cs)
+{
+	CA_FOREACH(const WeaponClass *, wc, m->Weapons)
+	PrefetchWeapon(*wc);
+	CA_FOREACH_END()
+	CA_FOREACH(const int, charId, m->Enemies)
+	PrefetchCharacter(CArrayGet(&cs->OtherChars, *charId));
+	CA_FOREACH_END()
+	CA_FOREACH(const int, charId, m->SpecialChars)
+	PrefetchCharacter(CArrayGet(&cs->OtherChars, *charId));
+	CA_FOREACH_END()
+	CA_FOREACH(const MapObjectDensity, mod, m->MapObjectDensities)
+	PrefetchMapObject(mod->M);
+	CA_FOREACH_END()
+}
+static void PrefetchWeapon(const WeaponClass *wc)
+{
+	if (wc == NULL)
+	{
+		return;
+	}
+	if (wc->Icon != NULL)
+	{
+		PicPrefetch(wc->Icon);
+	}
+	SoundPrefetch(wc->SwitchSound);
+	if (wc->Type == GUNTYPE_MULTI)
+	{
+		for (int i = 0; i < MAX_BARRELS; i++)
+		{
+			if (wc->u.Guns[i] != NULL)
+			{
+				PrefetchWeapon(StrWeaponClass(wc->u.Guns[i]));
+			}
+		}
+		return;
+	}
+	SoundPrefetch(wc->u.Normal.Sound);
+	SoundPrefetch(wc->u.Normal.ReloadSound);
+	CA_FOREACH(const BulletClass *, bc, wc->u.Normal.Bullets)
+	CPicPrefetch(&(*bc)->CPic);
+	CA_FOREACH_END()
+}
+static void PrefetchMapObject(const MapObject *mo)
+{
+	if (mo == NULL)
+	{
+		return;
+	}
+	CPicPrefetch(&mo->Pic);
+	SoundPrefetch(mo->Wreck.Sound);
+	if (mo->Wreck.MO != NULL)
+	{
+		const MapObject *wreck = StrMapObject(mo->Wreck.MO);
+		if (wreck != NULL)
+		{
+			CPicPrefetch(&wreck->Pic);
+		}
+	}
+	CA_FOREACH(const WeaponClass *, wc, mo->DestroyGuns)
+	PrefetchWeapon(*wc);
+	CA_FOREACH_END()
+}
+static void PrefetchCharacter(const Character *c)
+{
+	// Character sprites are already made by the time they are masked
+	PrefetchWeapon(c->Gun);
+	if (c->Class != NULL)
+	{
+		char buf[CDOGS_PATH_MAX];
+		CharacterClassGetSound(c->Class, buf, "die");
+		SoundPrefetchName(buf);
+		CharacterClassGetSound(c->Class, buf, "alert");
+		SoundPrefetchName(buf);
+	}
+}
 void MissionSetupTileClasses(
 	Map *m, PicManager *pm, const MissionTileClasses *mtc)
 {
@@ -229,6 +229,9 @@ void MissionTerminate(Mission *m);
 MissionTileClasses *MissionGetTileClasses(Mission *m);
 
 void SetupMission(Mission *m, struct MissionOptions *mo, int missionIndex);
+// Load the textures and sounds that the mission will use, so that they
+// aren't loaded on first use during play
+void MissionPrefetch(const Mission *m, const CharacterStore *cs);
 void MissionSetupTileClasses(
 	Map *m, PicManager *pm, const MissionTileClasses *mtc);
 void MissionTileClassesInitDefault(MissionTileClasses *mtc);
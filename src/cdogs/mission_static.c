@@ -34,6 +34,7 @@
 #include "map_archive.h"
 #include "map_new.h"
 #include "mission.h"
+#include "tile_codec.h"
 #include "utils.h"
 
 void MissionStaticInit(MissionStatic *m)
@@ -52,8 +53,6 @@ void MissionStaticInit(MissionStatic *m)
 }
 
 static void LoadTileClasses(map_t tileClasses, const json_t *node);
-static void LoadOldStaticTileCSV(CArray *tiles, char *tileCSV);
-static void LoadStaticTileCSV(CArray *tiles, char *tileCSV);
 static void ConvertOldTile(
 	MissionStatic *m, const uint16_t t, const TileClass *base);
 static void LoadStaticItems(
@@ -71,7 +70,7 @@ static void LoadStaticExits(
 	MissionStatic *m, const json_t *node, const char *name);
 bool MissionStaticTryLoadJSON(
 	MissionStatic *m, json_t *node, const struct vec2i size, const int version,
-	const int mission)
+	const int mission, const CampaignCache *cache)
 {
 	MissionStaticInit(m);
 	if (version <= 14)
@@ -92,16 +91,19 @@ bool MissionStaticTryLoadJSON(
 			tiles = tiles->child;
 			for (tiles = tiles->child; tiles; tiles = tiles->next)
 			{
-				const uint16_t n = (uint16_t)atoi(tiles->text);
+				const uint16_t n = (uint16_t)JSONGetInt(tiles);
 				CArrayPushBack(&oldTiles, &n);
 			}
 		}
 		else if (version <= 14)
 		{
 			// CSV string
-			char *tileCSV = GetString(node, "Tiles");
-			LoadOldStaticTileCSV(&oldTiles, tileCSV);
-			CFREE(tileCSV);
+			const json_t *tiles = json_find_first_label(node, "Tiles");
+			if (!tiles || !tiles->child)
+			{
+				return false;
+			}
+			TileCSVDecode(&oldTiles, tiles->child->text);
 		}
 		// Convert old tiles to new
 		CA_FOREACH(uint16_t, t, oldTiles)
@@ -136,26 +138,12 @@ bool MissionStaticTryLoadJSON(
 		// Tile class definitions
 		LoadTileClasses(m->TileClasses, node);
 
-		// CSV string per row
-		const json_t *tile =
-			json_find_first_label(node, "Tiles")->child->child;
-		while (tile)
+		// Use the tiles already decoded by the campaign cache if possible
+		if (!CampaignCacheLoadTiles(cache, mission, &m->Tiles, &m->Access) &&
+			!MissionStaticLoadTiles(&m->Tiles, &m->Access, node, size))
 		{
-			LoadStaticTileCSV(&m->Tiles, tile->text);
-			tile = tile->next;
-		}
-		const json_t *a = json_find_first_label(node, "Access")->child->child;
-		while (a)
-		{
-			CArray mAccess;
-			CArrayInit(&mAccess, sizeof(int));
-			LoadStaticTileCSV(&mAccess, a->text);
-			CA_FOREACH(const int, aInt, mAccess)
-			const uint16_t a16 = (uint16_t)*aInt;
-			CArrayPushBack(&m->Access, &a16);
-			CA_FOREACH_END()
-			CArrayTerminate(&mAccess);
-			a = a->next;
+			LOG(LM_MAP, LL_ERROR, "cannot load tiles of mission %d", mission);
+			return false;
 		}
 	}
 
@@ -204,25 +192,81 @@ static void LoadTileClasses(map_t tileClasses, const json_t *node)
 		}
 	}
 }
-static void LoadOldStaticTileCSV(CArray *tiles, char *tileCSV)
+static bool LoadTileRows(
+	CArray *values, const json_t *node, const char *name, const int count);
+static bool LoadTileCSVRows(CArray *values, const json_t *node);
+bool MissionStaticLoadTiles(
+	CArray *tiles, CArray *access, const json_t *node, const struct vec2i size)
 {
-	char *pch = strtok(tileCSV, ",");
-	while (pch != NULL)
+	const int count = size.x * size.y;
+	const size_t tilesStart = tiles->size;
+	if (!LoadTileRows(tiles, node, "Tiles", count))
 	{
-		const uint16_t n = (uint16_t)atoi(pch);
-		CArrayPushBack(tiles, &n);
-		pch = strtok(NULL, ",");
+		return false;
+	}
+	if (!LoadTileRows(access, node, "Access", count))
+	{
+		CArrayResize(tiles, tilesStart, NULL);
+		return false;
 	}
+	return true;
 }
-static void LoadStaticTileCSV(CArray *tiles, char *tileCSV)
+static bool LoadTileRows(
+	CArray *values, const json_t *node, const char *name, const int count)
 {
-	char *pch = strtok(tileCSV, ",");
-	while (pch != NULL)
+	const json_t *label = json_find_first_label(node, name);
+	if (label == NULL || label->child == NULL)
 	{
-		const int n = atoi(pch);
-		CArrayPushBack(tiles, &n);
-		pch = strtok(NULL, ",");
+		LOG(LM_MAP, LL_ERROR, "missing %s", name);
+		return false;
 	}
+	node = label->child;
+	const size_t start = values->size;
+	if (node->type == JSON_STRING)
+	{
+		// RLE
+		if (!TileRLEDecode(values, node->text))
+		{
+			LOG(LM_MAP, LL_ERROR, "invalid RLE %s", name);
+			return false;
+		}
+	}
+	else if (node->type != JSON_ARRAY || !LoadTileCSVRows(values, node))
+	{
+		LOG(LM_MAP, LL_ERROR, "invalid %s", name);
+		return false;
+	}
+	if ((int)(values->size - start) != count)
+	{
+		LOG(LM_MAP, LL_ERROR, "expected %d %s, got %d", count, name,
+			(int)(values->size - start));
+		CArrayResize(values, start, NULL);
+		return false;
+	}
+	return true;
+}
+static bool LoadTileCSVRows(CArray *values, const json_t *node)
+{
+	// CSV string per row; rows are the same length so size for all of them
+	int rows = 0;
+	for (const json_t *row = node->child; row; row = row->next)
+	{
+		if (row->type != JSON_STRING)
+		{
+			return false;
+		}
+		rows++;
+	}
+	if (rows > 0)
+	{
+		CArrayReserve(
+			values, values->size + rows * TileCSVCount(node->child->text));
+	}
+	for (const json_t *row = node->child; row; row = row->next)
+	{
+		TileCSVDecode(values, row->text);
+	}
+	return true;
 }
 static void ConvertOldTile(
 	MissionStatic *m, const uint16_t t, const TileClass *base)
@@ -313,8 +357,7 @@ static const MapObject *LoadMapObjectRef(json_t *itemNode, const int version)
 	}
 	else
 	{
-		const char *moName =
-			json_find_first_label(itemNode, "MapObject")->child->text;
+		char *moName = GetString(itemNode, "MapObject");
 		const MapObject *mo = StrMapObject(moName);
 		if (mo == NULL && version <= 11 && StrEndsWith(moName, " spawner"))
 		{
@@ -330,6 +373,7 @@ static const MapObject *LoadMapObjectRef(json_t *itemNode, const int version)
 		{
 			LOG(LM_MAP, LL_ERROR, "Failed to load map object (%s)", moName);
 		}
+		CFREE(moName);
 		return mo;
 	}
 }
@@ -342,15 +386,18 @@ static const MapObject *LoadMapObjectWreckRef(
 		LoadInt(&idx, itemNode, "Index");
 		return IntMapObject(idx);
 	}
-	const char *moName =
-		json_find_first_label(itemNode, "MapObject")->child->text;
+	char *moName = GetString(itemNode, "MapObject");
 	const MapObject *mo = StrMapObject(moName);
+	const MapObject *wreck = NULL;
 	if (mo == NULL)
 	{
 		LOG(LM_MAP, LL_ERROR, "Failed to load map object (%s)", moName);
-		return NULL;
 	}
-	const MapObject *wreck = StrMapObject(mo->Wreck.MO);
+	else
+	{
+		wreck = StrMapObject(mo->Wreck.MO);
+	}
+	CFREE(moName);
 	return wreck;
 }
 static void LoadStaticCharacters(MissionStatic *m, json_t *node, char *name)
@@ -375,7 +422,7 @@ static void LoadStaticCharacters(MissionStatic *m, json_t *node, char *name)
 			CA_FOREACH(const struct vec2i, pos, positions)
 			CharacterPlace cp;
 			cp.Pos = *pos;
-			cp.Dir = rand() % DIRECTION_COUNT;
+			cp.Dir = RAND_INT(RNG_MAPGEN, 0, DIRECTION_COUNT);
 			CArrayPushBack(&cps.Places, &cp);
 			CA_FOREACH_END()
 		}
@@ -413,11 +460,11 @@ static void LoadStaticObjectives(
 		{
 			struct vec2i pos;
 			json_t *position = positions->child;
-			pos.x = atoi(position->text);
+			pos.x = JSONGetInt(position);
 			position = position->next;
 			if (position == NULL)
 				continue;
-			pos.y = atoi(position->text);
+			pos.y = JSONGetInt(position);
 			// Ignore objectives outside map
 			if (!Rect2iIsInside(Rect2iNew(svec2i_zero(), size), pos))
 			{
@@ -490,12 +537,13 @@ static void LoadStaticPickups(MissionStatic *m, json_t *node, char *name)
 }
 static const PickupClass *LoadPickupRef(const json_t *itemNode)
 {
-	const char *pName = json_find_first_label(itemNode, "Pickup")->child->text;
+	char *pName = GetString(itemNode, "Pickup");
 	const PickupClass *p = StrPickupClass(pName);
 	if (p == NULL)
 	{
 		LOG(LM_MAP, LL_ERROR, "Failed to load pickup (%s)", pName);
 	}
+	CFREE(pName);
 	return p;
 }
 static bool TryLoadPositions(CArray *a, const json_t *node)
@@ -511,9 +559,9 @@ static bool TryLoadPositions(CArray *a, const json_t *node)
 	{
 		struct vec2i pos;
 		json_t *position = positions->child;
-		pos.x = atoi(position->text);
+		pos.x = JSONGetInt(position);
 		position = position->next;
-		pos.y = atoi(position->text);
+		pos.y = JSONGetInt(position);
 		CArrayPushBack(a, &pos);
 	}
 	return true;
@@ -624,60 +672,50 @@ void MissionStaticTerminate(MissionStatic *m)
 	CArrayTerminate(&m->Exits);
 }
 
-static json_t *SaveStaticTileClasses(const MissionStatic *m);
-static json_t *SaveStaticCSV(const CArray *values, const struct vec2i size);
-static json_t *SaveStaticItems(const MissionStatic *m);
-static json_t *SaveStaticCharacters(const MissionStatic *m);
-static json_t *SaveStaticObjectives(const MissionStatic *m);
-static json_t *SaveStaticKeys(const MissionStatic *m);
-static json_t *SaveStaticPickups(const MissionStatic *m);
-static json_t *SaveExits(const MissionStatic *m);
-static json_t *SaveVec2i(struct vec2i v);
-void MissionStaticSaveJSON(
-	const MissionStatic *m, const struct vec2i size, json_t *node)
-{
-	json_insert_pair_into_object(
-		node, "TileClasses", SaveStaticTileClasses(m));
-	json_insert_pair_into_object(
-		node, "Tiles", SaveStaticCSV(&m->Tiles, size));
-	CArray mAccess;
-	CArrayInit(&mAccess, sizeof(int));
-	CA_FOREACH(const uint16_t, a, m->Access)
-	const int aInt = (int)*a;
-	CArrayPushBack(&mAccess, &aInt);
-	CA_FOREACH_END()
-	json_insert_pair_into_object(
-		node, "Access", SaveStaticCSV(&mAccess, size));
-	CArrayTerminate(&mAccess);
-	json_insert_pair_into_object(node, "StaticItems", SaveStaticItems(m));
-	json_insert_pair_into_object(
-		node, "StaticCharacters", SaveStaticCharacters(m));
-	json_insert_pair_into_object(
-		node, "StaticObjectives", SaveStaticObjectives(m));
-	json_insert_pair_into_object(node, "StaticKeys", SaveStaticKeys(m));
-	json_insert_pair_into_object(node, "StaticPickups", SaveStaticPickups(m));
+static void SaveStaticTileClasses(const MissionStatic *m, JSONWriter *w);
+static void SaveStaticTiles(
+	JSONWriter *w, const char *key, const CArray *values,
+	const struct vec2i size, const bool compact);
+static void SaveStaticItems(const MissionStatic *m, JSONWriter *w);
+static void SaveStaticCharacters(const MissionStatic *m, JSONWriter *w);
+static void SaveStaticObjectives(const MissionStatic *m, JSONWriter *w);
+static void SaveStaticKeys(const MissionStatic *m, JSONWriter *w);
+static void SaveStaticPickups(const MissionStatic *m, JSONWriter *w);
+static void SaveExits(const MissionStatic *m, JSONWriter *w);
+void MissionStaticSave(
+	const MissionStatic *m, const struct vec2i size, JSONWriter *w,
+	const bool compactTiles)
+{
+	SaveStaticTileClasses(m, w);
+	SaveStaticTiles(w, "Tiles", &m->Tiles, size, compactTiles);
+	SaveStaticTiles(w, "Access", &m->Access, size, compactTiles);
+	SaveStaticItems(m, w);
+	SaveStaticCharacters(m, w);
+	SaveStaticObjectives(m, w);
+	SaveStaticKeys(m, w);
+	SaveStaticPickups(m, w);
 
-	json_insert_pair_into_object(node, "Start", SaveVec2i(m->Start));
-	json_insert_pair_into_object(node, "Exits", SaveExits(m));
+	JSONWriterVec2i(w, "Start", m->Start);
+	SaveExits(m, w);
 
-	AddBoolPair(node, "AltFloorsEnabled", m->AltFloorsEnabled);
+	JSONWriterBool(w, "AltFloorsEnabled", m->AltFloorsEnabled);
 }
 typedef struct
 {
-	json_t *items;
+	JSONWriter *w;
 	map_t tileClasses;
 } SaveStaticTileClassData;
 static int SaveStaticTileClass(any_t data, any_t key);
-static json_t *SaveStaticTileClasses(const MissionStatic *m)
+static void SaveStaticTileClasses(const MissionStatic *m, JSONWriter *w)
 {
-	json_t *items = json_new_object();
-	SaveStaticTileClassData data = {items, m->TileClasses};
+	JSONWriterBeginObject(w, "TileClasses");
+	SaveStaticTileClassData data = {w, m->TileClasses};
 	if (hashmap_iterate_keys_sorted(
 			m->TileClasses, SaveStaticTileClass, &data) != MAP_OK)
 	{
 		CASSERT(false, "Failed to save static tile classes");
 	}
-	return items;
+	JSONWriterEndObject(w);
 }
 static int SaveStaticTileClass(any_t data, any_t key)
 {
@@ -690,147 +728,132 @@ static int SaveStaticTileClass(any_t data, any_t key)
 		CASSERT(false, "cannot find tile class");
 		return error;
 	}
-	json_insert_pair_into_object(
-		sData->items, (const char *)key, TileClassSaveJSON(tc));
+	TileClassSave(tc, sData->w, (const char *)key);
 	return MAP_OK;
 }
-static json_t *SaveStaticCSV(const CArray *values, const struct vec2i size)
+static void SaveStaticTiles(
+	JSONWriter *w, const char *key, const CArray *values,
+	const struct vec2i size, const bool compact)
 {
+	if (compact)
+	{
+		char *rle = TileRLEEncode(values);
+		JSONWriterString(w, key, rle);
+		CFREE(rle);
+		return;
+	}
 	// Write out each row of tiles individually as a single CSV
-	json_t *rows = json_new_array();
-	// Create a text buffer for CSV
-	// The buffer will contain n*5 chars (tiles, allow 5 chars each),
-	// and n - 1 commas, so 6n total
+	JSONWriterBeginArray(w, key);
 	char *rowBuf;
-	CMALLOC(rowBuf, size.x * 6);
+	CMALLOC(rowBuf, TILE_CSV_MAX_LEN(size.x));
 	for (int i = 0; i < size.y; i++)
 	{
-		char *pBuf = rowBuf;
-		*pBuf = '\0';
-		for (int j = 0; j < size.x; j++)
-		{
-			char buf[6];
-			snprintf(buf, 6, "%d", *(int *)CArrayGet(values, i * size.x + j));
-			strcpy(pBuf, buf);
-			pBuf += strlen(buf);
-			if (j < size.x - 1)
-			{
-				*pBuf++ = ',';
-			}
-		}
-		json_insert_child(rows, json_new_string(rowBuf));
+		TileCSVEncode(rowBuf, values, i * size.x, size.x);
+		JSONWriterString(w, NULL, rowBuf);
 	}
 	CFREE(rowBuf);
-	return rows;
-}
-static void SavePositions(json_t *node, const CArray *positions);
-static void SaveCharacterPlaces(json_t *node, const CArray *cps);
-static json_t *SaveStaticItems(const MissionStatic *m)
-{
-	json_t *items = json_new_array();
-	CA_FOREACH(MapObjectPositions, mop, m->Items)
-	json_t *itemNode = json_new_object();
-	AddStringPair(itemNode, "MapObject", mop->M->Name);
-	SavePositions(itemNode, &mop->Positions);
-	json_insert_child(items, itemNode);
+	JSONWriterEndArray(w);
+}
+static void SavePositions(JSONWriter *w, const CArray *positions);
+static void SaveCharacterPlaces(JSONWriter *w, const CArray *cps);
+static void SaveStaticItems(const MissionStatic *m, JSONWriter *w)
+{
+	JSONWriterBeginArray(w, "StaticItems");
+	CA_FOREACH(const MapObjectPositions, mop, m->Items)
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterString(w, "MapObject", mop->M->Name);
+	SavePositions(w, &mop->Positions);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return items;
+	JSONWriterEndArray(w);
 }
-static json_t *SaveStaticCharacters(const MissionStatic *m)
+static void SaveStaticCharacters(const MissionStatic *m, JSONWriter *w)
 {
-	json_t *chars = json_new_array();
+	JSONWriterBeginArray(w, "StaticCharacters");
 	CA_FOREACH(const CharacterPlaces, cp, m->Characters)
-	json_t *charNode = json_new_object();
-	AddIntPair(charNode, "Index", cp->Index);
-	SaveCharacterPlaces(charNode, &cp->Places);
-	json_insert_child(chars, charNode);
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterInt(w, "Index", cp->Index);
+	SaveCharacterPlaces(w, &cp->Places);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return chars;
+	JSONWriterEndArray(w);
 }
-static json_t *SaveStaticObjectives(const MissionStatic *m)
+static void SaveStaticObjectives(const MissionStatic *m, JSONWriter *w)
 {
-	json_t *objs = json_new_array();
-	CA_FOREACH(ObjectivePositions, op, m->Objectives)
-	json_t *objNode = json_new_object();
-	AddIntPair(objNode, "Index", op->Index);
-	json_t *positions = json_new_array();
-	json_t *indices = json_new_array();
+	JSONWriterBeginArray(w, "StaticObjectives");
+	CA_FOREACH(const ObjectivePositions, op, m->Objectives)
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterInt(w, "Index", op->Index);
+	JSONWriterBeginArray(w, "Positions");
 	for (int j = 0; j < (int)op->PositionIndices.size; j++)
 	{
 		const PositionIndex *pi = CArrayGet(&op->PositionIndices, j);
-		json_insert_child(positions, SaveVec2i(pi->Position));
-		char buf[32];
-		sprintf(buf, "%d", pi->Index);
-		json_insert_child(indices, json_new_number(buf));
-	}
-	json_insert_pair_into_object(objNode, "Positions", positions);
-	json_insert_pair_into_object(objNode, "Indices", indices);
-	json_insert_child(objs, objNode);
+		JSONWriterVec2i(w, NULL, pi->Position);
+	}
+	JSONWriterEndArray(w);
+	JSONWriterBeginArray(w, "Indices");
+	for (int j = 0; j < (int)op->PositionIndices.size; j++)
+	{
+		const PositionIndex *pi = CArrayGet(&op->PositionIndices, j);
+		JSONWriterInt(w, NULL, pi->Index);
+	}
+	JSONWriterEndArray(w);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return objs;
+	JSONWriterEndArray(w);
 }
-static json_t *SaveStaticKeys(const MissionStatic *m)
+static void SaveStaticKeys(const MissionStatic *m, JSONWriter *w)
 {
-	json_t *keys = json_new_array();
-	CA_FOREACH(KeyPositions, kp, m->Keys)
-	json_t *keyNode = json_new_object();
-	AddIntPair(keyNode, "Index", kp->Index);
-	SavePositions(keyNode, &kp->Positions);
-	json_insert_child(keys, keyNode);
+	JSONWriterBeginArray(w, "StaticKeys");
+	CA_FOREACH(const KeyPositions, kp, m->Keys)
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterInt(w, "Index", kp->Index);
+	SavePositions(w, &kp->Positions);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return keys;
+	JSONWriterEndArray(w);
 }
-static json_t *SaveStaticPickups(const MissionStatic *m)
+static void SaveStaticPickups(const MissionStatic *m, JSONWriter *w)
 {
-	json_t *pickups = json_new_array();
+	JSONWriterBeginArray(w, "StaticPickups");
 	CA_FOREACH(const PickupPositions, pp, m->Pickups)
-	json_t *pNode = json_new_object();
-	AddStringPair(pNode, "Pickup", pp->P->Name);
-	SavePositions(pNode, &pp->Positions);
-	json_insert_child(pickups, pNode);
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterString(w, "Pickup", pp->P->Name);
+	SavePositions(w, &pp->Positions);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return pickups;
+	JSONWriterEndArray(w);
 }
-static void SavePositions(json_t *node, const CArray *positions)
+static void SavePositions(JSONWriter *w, const CArray *positions)
 {
-	json_t *a = json_new_array();
+	JSONWriterBeginArray(w, "Positions");
 	CA_FOREACH(const struct vec2i, pos, *positions)
-	json_insert_child(a, SaveVec2i(*pos));
+	JSONWriterVec2i(w, NULL, *pos);
 	CA_FOREACH_END()
-	json_insert_pair_into_object(node, "Positions", a);
+	JSONWriterEndArray(w);
 }
-static void SaveCharacterPlaces(json_t *node, const CArray *cps)
+static void SaveCharacterPlaces(JSONWriter *w, const CArray *cps)
 {
-	json_t *a = json_new_array();
+	JSONWriterBeginArray(w, "Places");
 	CA_FOREACH(const CharacterPlace, cp, *cps)
-	json_t *cpNode = json_new_object();
-	AddVec2iPair(cpNode, "Pos", cp->Pos);
-	AddIntPair(cpNode, "Dir", (int)cp->Dir);
-	json_insert_child(a, cpNode);
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterVec2i(w, "Pos", cp->Pos);
+	JSONWriterInt(w, "Dir", (int)cp->Dir);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	json_insert_pair_into_object(node, "Places", a);
+	JSONWriterEndArray(w);
 }
-static json_t *SaveExits(const MissionStatic *m)
+static void SaveExits(const MissionStatic *m, JSONWriter *w)
 {
-	json_t *exits = json_new_array();
+	JSONWriterBeginArray(w, "Exits");
 	CA_FOREACH(const Exit, exit, m->Exits)
-	json_t *exitNode = json_new_object();
-	AddRect2iPair(exitNode, "Rect", exit->R);
-	AddIntPair(exitNode, "Mission", exit->Mission);
-	AddBoolPair(exitNode, "Hidden", exit->Hidden);
-	json_insert_child(exits, exitNode);
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterRect2i(w, "Rect", exit->R);
+	JSONWriterInt(w, "Mission", exit->Mission);
+	JSONWriterBool(w, "Hidden", exit->Hidden);
+	JSONWriterEndObject(w);
 	CA_FOREACH_END()
-	return exits;
-}
-static json_t *SaveVec2i(struct vec2i v)
-{
-	json_t *node = json_new_array();
-	char buf[32];
-	sprintf(buf, "%d", v.x);
-	json_insert_child(node, json_new_number(buf));
-	sprintf(buf, "%d", v.y);
-	json_insert_child(node, json_new_number(buf));
-	return node;
+	JSONWriterEndArray(w);
 }
 
 static void MapObjectPositionsCopy(CArray *dst, const CArray *src);
@@ -29,7 +29,9 @@
 
 #include "c_array.h"
 #include "c_hashmap/hashmap.h"
+#include "campaign_cache.h"
 #include "json_utils.h"
+#include "json_writer.h"
 #include "map.h"
 #include "map_object.h"
 #include "mathc/mathc.h"
@@ -89,11 +91,20 @@ typedef struct
 void MissionStaticInit(MissionStatic *m);
 bool MissionStaticTryLoadJSON(
 	MissionStatic *m, json_t *node, const struct vec2i size, const int version,
-	const int mission);
+	const int mission, const CampaignCache *cache);
+// Decode the tiles and access of a static mission (version 15+), as per-row
+// CSV or RLE (version 17+). Returns false, leaving the arrays unchanged,
+// if either layer is invalid or does not have size.x * size.y values.
+bool MissionStaticLoadTiles(
+	CArray *tiles, CArray *access, const json_t *node,
+	const struct vec2i size);
 void MissionStaticFromMap(MissionStatic *m, const Map *map);
 void MissionStaticTerminate(MissionStatic *m);
-void MissionStaticSaveJSON(
-	const MissionStatic *m, const struct vec2i size, json_t *node);
+// Write the static map members of the mission object being written.
+// compactTiles: save the tiles and access as RLE instead of CSV
+void MissionStaticSave(
+	const MissionStatic *m, const struct vec2i size, JSONWriter *w,
+	const bool compactTiles);
 
 void MissionStaticCopy(MissionStatic *dst, const MissionStatic *src);
 
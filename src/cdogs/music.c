@@ -170,7 +170,7 @@ void MusicPlayGeneral(MusicPlayer *mp, const MusicType type)
 	{
 		while (mp->u.general == *(Mix_Music **)CArrayGet(tracks, 0))
 		{
-			CArrayShuffle(tracks);
+			CArrayShuffle(tracks, RNG_COSMETIC);
 		}
 	}
 	PlayMusic(mp);
@@ -221,6 +221,32 @@ void MusicPlayChunk(MusicPlayer *mp, const MusicType type, Mix_Chunk *chunk)
 	}
 }
 
+void MusicPlayStream(
+	MusicPlayer *mp, const MusicType type, const MusicStream *stream)
+{
+	MusicStop(mp);
+	if (stream == NULL)
+	{
+		MusicPlayGeneral(mp, type);
+		return;
+	}
+	mp->type = MUSIC_SRC_STREAM;
+	mp->u.stream = *stream;
+	PlayMusic(mp);
+}
+static void StreamHook(void *udata, Uint8 *stream, int len)
+{
+	const MusicStream *s = udata;
+	s->Fill(s->Data, stream, len);
+	// Hooked music skips the mixer's music volume
+	const int volume = Mix_VolumeMusic(-1);
+	Sint16 *samples = (Sint16 *)stream;
+	for (int i = 0; i < len / (int)sizeof *samples; i++)
+	{
+		samples[i] = (Sint16)(samples[i] * volume / MIX_MAX_VOLUME);
+	}
+}
+
 void MusicStop(MusicPlayer *mp)
 {
 	switch (mp->type)
@@ -244,6 +270,12 @@ void MusicStop(MusicPlayer *mp)
 		}
 		mp->u.chunk.chunk = NULL;
 		break;
+	case MUSIC_SRC_STREAM:
+		// Waits for the hook to finish
+		Mix_HookMusic(NULL, NULL);
+		CFREE(mp->u.stream.Data);
+		mp->u.stream.Data = NULL;
+		break;
 	}
 }
 
@@ -261,6 +293,9 @@ void MusicPause(MusicPlayer *mp)
 	case MUSIC_SRC_CHUNK:
 		Mix_Pause(mp->u.chunk.channel);
 		break;
+	case MUSIC_SRC_STREAM:
+		Mix_HookMusic(NULL, NULL);
+		break;
 	}
 	
 }
@@ -300,6 +335,13 @@ void MusicResume(MusicPlayer *mp)
 	case MUSIC_SRC_CHUNK:
 		Mix_Resume(mp->u.chunk.channel);
 		break;
+	case MUSIC_SRC_STREAM:
+		if (mp->u.stream.Data == NULL)
+		{
+			return;
+		}
+		Mix_HookMusic(StreamHook, &mp->u.stream);
+		break;
 	}
 }
 
@@ -333,6 +375,16 @@ void MusicChunkTerminate(MusicChunk *chunk)
 void MusicPlayFromChunk(
 	MusicPlayer *mp, const MusicType type, MusicChunk *chunk)
 {
+	if (chunk->GetStream)
+	{
+		// Stop first so the old stream isn't rendering while the new one
+		// starts; keep the data for starting the stream again
+		MusicStop(mp);
+		MusicStream s;
+		MusicPlayStream(
+			mp, type, chunk->GetStream(chunk->Data, &s) ? &s : NULL);
+		return;
+	}
 	if (chunk->Chunk == NULL && chunk->GetData)
 	{
 		chunk->Chunk =
@@ -72,9 +72,19 @@ typedef enum
 {
 	MUSIC_SRC_GENERAL,
 	MUSIC_SRC_DYNAMIC,
-	MUSIC_SRC_CHUNK
+	MUSIC_SRC_CHUNK,
+	MUSIC_SRC_STREAM // only used by the player, for chunk streams
 } MusicSourceType;
 
+// Music rendered as it plays, by the mixer's music hook.
+// Fill writes len bytes in the audio device format; Data is freed when the
+// stream stops.
+typedef struct
+{
+	void (*Fill)(void *data, Uint8 *stream, int len);
+	void *Data;
+} MusicStream;
+
 typedef struct
 {
 	bool isInitialised;
@@ -87,6 +97,7 @@ typedef struct
 			Mix_Chunk *chunk;
 			int channel;
 		} chunk;
+		MusicStream stream;
 	} u;
 	CArray generalTracks[MUSIC_COUNT]; // of Mix_Music *
 	char errorMessage[128];
@@ -97,6 +108,8 @@ typedef struct
 	void *Data;
 	Mix_Chunk *(*GetData)(void *);
 	Mix_Chunk *Chunk;
+	// Alternatively, start a new stream each time it plays
+	bool (*GetStream)(void *, MusicStream *);
 } MusicChunk;
 
 void MusicPlayerInit(MusicPlayer *mp);
@@ -107,6 +120,8 @@ void MusicPlayFile(
 	MusicPlayer *mp, const MusicType type, const char *missionPath,
 	const char *music);
 void MusicPlayChunk(MusicPlayer *mp, const MusicType type, Mix_Chunk *chunk);
+void MusicPlayStream(
+	MusicPlayer *mp, const MusicType type, const MusicStream *stream);
 void MusicStop(MusicPlayer *mp);
 void MusicPause(MusicPlayer *mp);
 void MusicResume(MusicPlayer *mp);
@@ -99,7 +99,9 @@ void DamageObject(const NThingDamage d)
 	for (int i = 0; i < MIN(o->Health, d.Power); i++)
 	{
 		char buf[256];
-		sprintf(buf, "spall%d", rand() % NUM_SPALL_PARTICLES + 1);
+		sprintf(
+			buf, "spall%d",
+			RAND_INT(RNG_COSMETIC, 1, NUM_SPALL_PARTICLES + 1));
 		ap.Class = StrParticleClass(&gParticleClasses, buf);
 		// Choose random colour from object
 		ap.Mask = PicGetRandomColor(CPicGetPic(&o->Class->Pic, 0));
@@ -126,7 +128,9 @@ void DamageObject(const NThingDamage d)
 		for (int i = 0; i < 20; i++)
 		{
 			char buf[256];
-			sprintf(buf, "spall%d", rand() % NUM_SPALL_PARTICLES + 1);
+			sprintf(
+				buf, "spall%d",
+				RAND_INT(RNG_COSMETIC, 1, NUM_SPALL_PARTICLES + 1));
 			ap.Class = StrParticleClass(&gParticleClasses, buf);
 			// Choose random colour from object
 			ap.Mask = PicGetRandomColor(CPicGetPic(&o->Class->Pic, 0));
@@ -154,7 +158,8 @@ static void AddPickupAtObject(const TObject *o, const PickupType type)
 		}
 		// Pick a random ammo type and spawn it
 		{
-			const int ammoId = rand() % AmmoGetNumClasses(&gAmmo);
+			const int ammoId =
+				RAND_INT(RNG_GAMEPLAY, 0, AmmoGetNumClasses(&gAmmo));
 			const Ammo *a = AmmoGetById(&gAmmo, ammoId);
 			sprintf(e.u.AddPickup.PickupClass, "ammo_%s", a->Name);
 		}
@@ -162,7 +167,8 @@ static void AddPickupAtObject(const TObject *o, const PickupType type)
 	case PICKUP_GUN:
 		// Pick a random mission gun type and spawn it
 		{
-			const int gunId = (int)(rand() % gMission.Weapons.size);
+			const int gunId =
+				RAND_INT(RNG_GAMEPLAY, 0, (int)gMission.Weapons.size);
 			const WeaponClass **wc = CArrayGet(&gMission.Weapons, gunId);
 			sprintf(e.u.AddPickup.PickupClass, "gun_%s", (*wc)->name);
 		}
@@ -210,7 +216,7 @@ void ObjRemove(const NMapObjectRemove mor)
 		{
 			CA_FOREACH(
 				const MapObjectDestroySpawn, mods, o->Class->DestroySpawn)
-			const double chance = (double)rand() / RAND_MAX;
+			const double chance = RAND_DOUBLE(RNG_GAMEPLAY, 0, 1);
 			if (chance < mods->SpawnChance)
 			{
 				AddPickupAtObject(o, mods->Type);
@@ -547,9 +553,12 @@ void UpdateObjects(const int ticks)
 			ap.Pos = svec2_add(
 				obj->thing.Pos,
 				svec2(
-					RAND_FLOAT(-obj->thing.size.x / 4, obj->thing.size.x / 4),
 					RAND_FLOAT(
-						-obj->thing.size.y / 4, obj->thing.size.y / 4)));
+						RNG_COSMETIC, -obj->thing.size.x / 4,
+						obj->thing.size.x / 4),
+					RAND_FLOAT(
+						RNG_COSMETIC, -obj->thing.size.y / 4,
+						obj->thing.size.y / 4)));
 			ap.Mask = colorWhite;
 			EmitterUpdate(&obj->damageSmoke, &ap, ticks);
 		}
@@ -0,0 +1,108 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "parallel.h"
+
+#include <SDL_cpuinfo.h>
+#include <SDL_thread.h>
+
+#include "log.h"
+#include "utils.h"
+
+#define MAX_BANDS 8
+
+static int sForceBands = 0;
+void ParallelSetBands(const int numBands)
+{
+	sForceBands = CLAMP(numBands, 0, MAX_BANDS);
+}
+
+typedef struct
+{
+	void (*f)(void *data, const int start, const int end);
+	void *data;
+	int start;
+	int end;
+} Band;
+static int BandRun(void *arg)
+{
+	const Band *b = arg;
+	b->f(b->data, b->start, b->end);
+	return 0;
+}
+void ParallelForBands(
+	const int n, const int minBand,
+	void (*f)(void *data, const int start, const int end), void *data)
+{
+	int numBands = 1;
+#ifndef __EMSCRIPTEN__
+	const int numCPUs = SDL_GetCPUCount();
+	numBands = CLAMP(numCPUs, 1, MAX_BANDS);
+#endif
+	if (sForceBands > 0)
+	{
+		numBands = sForceBands;
+	}
+	if (minBand > 0)
+	{
+		numBands = MIN(numBands, n / minBand);
+	}
+	numBands = MAX(numBands, 1);
+
+	Band bands[MAX_BANDS];
+	SDL_Thread *threads[MAX_BANDS];
+	for (int i = 0; i < numBands; i++)
+	{
+		bands[i].f = f;
+		bands[i].data = data;
+		bands[i].start = n * i / numBands;
+		bands[i].end = n * (i + 1) / numBands;
+		threads[i] = NULL;
+		if (i > 0)
+		{
+			threads[i] = SDL_CreateThread(BandRun, "Band", &bands[i]);
+			if (threads[i] == NULL)
+			{
+				// Fall back to running the band on this thread
+				LOG(LM_MAIN, LL_WARN, "cannot create band thread: %s",
+					SDL_GetError());
+			}
+		}
+	}
+	BandRun(&bands[0]);
+	for (int i = 1; i < numBands; i++)
+	{
+		if (threads[i] != NULL)
+		{
+			SDL_WaitThread(threads[i], NULL);
+		}
+		else
+		{
+			BandRun(&bands[i]);
+		}
+	}
+}
@@ -100,6 +100,56 @@ void ParticleClassesLoadJSON(CArray *classes, json_t *root)
 		CArrayPushBack(classes, &c);
 	}
 }
+static const JSONField particleFields[] = {
+	{"Sprites", JSON_FIELD_STRING, NULL, 0},
+	{"Mask", JSON_FIELD_STRING, NULL, 0},
+	{"TicksPerFrame", JSON_FIELD_NUMBER, NULL, 0},
+	{"Type", JSON_FIELD_STRING, NULL, 2},
+	{"Pic", JSON_FIELD_OBJECT, CPicIsValidJSON, 2},
+	{"TextMask", JSON_FIELD_STRING, NULL, 2},
+	{"Range", JSON_FIELD_NUMBER, NULL, 0},
+	{"RangeLow", JSON_FIELD_NUMBER, NULL, 0},
+	{"RangeHigh", JSON_FIELD_NUMBER, NULL, 0},
+	{"GravityFactor", JSON_FIELD_NUMBER, NULL, 0},
+	{"HitsWalls", JSON_FIELD_BOOL, NULL, 0},
+	{"Bounces", JSON_FIELD_BOOL, NULL, 0},
+	{"BounceFriction", JSON_FIELD_NUMBER, NULL, 0},
+	{"WallBounces", JSON_FIELD_BOOL, NULL, 0},
+	{"ZDarken", JSON_FIELD_BOOL, NULL, 0},
+	{"DrawBelow", JSON_FIELD_BOOL, NULL, 0},
+	{"DrawAbove", JSON_FIELD_BOOL, NULL, 0},
+	{NULL, JSON_FIELD_BOOL, NULL, 0}};
+bool ParticleClassesReloadJSON(CArray *classes, json_t *root)
+{
+	if (!JSONCheckClassList(
+			root, VERSION, "Particles", "particles", particleFields))
+	{
+		return false;
+	}
+	CArray loaded;
+	CArrayInit(&loaded, sizeof(ParticleClass));
+	ParticleClassesLoadJSON(&loaded, root);
+	int patched = 0;
+	CA_FOREACH(ParticleClass, c, loaded)
+	for (int i = 0; i < (int)classes->size; i++)
+	{
+		ParticleClass *existing = CArrayGet(classes, i);
+		if (strcmp(existing->Name, c->Name) == 0)
+		{
+			CFREE(existing->Name);
+			memcpy(existing, c, sizeof *c);
+			memset(c, 0, sizeof *c);
+			patched++;
+			break;
+		}
+	}
+	CA_FOREACH_END()
+	LOG(LM_MAIN, LL_INFO, "reloaded %d particles, %d new ignored", patched,
+		(int)loaded.size - patched);
+	ParticleClassesClear(&loaded);
+	CArrayTerminate(&loaded);
+	return true;
+}
 void ParticleClassesTerminate(ParticleClasses *classes)
 {
 	ParticleClassesClear(&classes->Classes);
@@ -211,13 +261,9 @@ static void LoadParticleClass(
 	LoadBool(&c->DrawAbove, node, "DrawAbove");
 }
 
-const ParticleClass *StrParticleClass(
+const ParticleClass *ParticleClassFind(
 	const ParticleClasses *classes, const char *name)
 {
-	if (name == NULL || strlen(name) == 0)
-	{
-		return NULL;
-	}
 	CA_FOREACH(const ParticleClass, c, classes->CustomClasses)
 	if (strcmp(c->Name, name) == 0)
 	{
@@ -230,9 +276,27 @@ const ParticleClass *StrParticleClass(
 		return c;
 	}
 	CA_FOREACH_END()
-	CASSERT(false, "Cannot find particle class");
 	return NULL;
 }
+bool ParticleClassNameIsValid(const json_t *node)
+{
+	char *name = json_unescape(node->text);
+	const bool valid = strlen(name) == 0 ||
+					   ParticleClassFind(&gParticleClasses, name) != NULL;
+	CFREE(name);
+	return valid;
+}
+const ParticleClass *StrParticleClass(
+	const ParticleClasses *classes, const char *name)
+{
+	if (name == NULL || strlen(name) == 0)
+	{
+		return NULL;
+	}
+	const ParticleClass *c = ParticleClassFind(classes, name);
+	CASSERT(c != NULL, "Cannot find particle class");
+	return c;
+}
 
 void ParticlesInit(CArray *particles)
 {
@@ -461,7 +525,8 @@ int ParticleAdd(CArray *particles, const AddParticle add)
 	p->Angle = add.Angle;
 	p->DZ = (float)add.DZ;
 	p->Spin = add.Spin;
-	p->Range = RAND_INT(add.Class->RangeLow, add.Class->RangeHigh);
+	p->Range =
+		RAND_INT(RNG_COSMETIC, add.Class->RangeLow, add.Class->RangeHigh);
 	p->isInUse = true;
 	p->thing.Pos.x = p->thing.Pos.y = -1;
 	p->thing.Vel = add.Vel;
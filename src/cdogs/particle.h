@@ -105,8 +105,15 @@ typedef struct
 
 void ParticleClassesInit(ParticleClasses *classes, const char *filename);
 void ParticleClassesLoadJSON(CArray *classes, json_t *root);
+// Update classes from root in place, keeping pointers to them valid
+bool ParticleClassesReloadJSON(CArray *classes, json_t *root);
 void ParticleClassesTerminate(ParticleClasses *classes);
 void ParticleClassesClear(CArray *classes);
+// Find a class by name, or NULL if there is none
+const ParticleClass *ParticleClassFind(
+	const ParticleClasses *classes, const char *name);
+// Whether a JSON string is empty or names a loaded particle class
+bool ParticleClassNameIsValid(const json_t *node);
 const ParticleClass *StrParticleClass(
 	const ParticleClasses *classes, const char *name);
 
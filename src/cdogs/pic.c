@@ -32,11 +32,21 @@
 #include "defs.h"
 #include "grafx.h"
 #include "log.h"
+#include "pixel_ops.h"
 #include "texture.h"
 #include "utils.h"
 
 map_t textureDebugger = NULL;
 
+static size_t PicLoadTex(void *asset);
+static void PicUnloadTex(void *asset);
+static void PicSetResidentId(void *asset, const int id);
+Residency gTextureResidency = {
+	.Name = "textures",
+	.Load = PicLoadTex,
+	.Unload = PicUnloadTex,
+	.SetId = PicSetResidentId};
+
 
 color_t PixelToColor(
 	const SDL_PixelFormat *f, const Uint8 aShift, const Uint32 pixel)
@@ -59,6 +69,20 @@ Uint32 ColorToPixel(
 
 void PicLoad(
 	Pic *p, const struct vec2i size, const struct vec2i offset, const SDL_Surface *image)
+{
+	PicLoadPixels(p, size, offset, image);
+	if (p->Data == NULL)
+	{
+		return;
+	}
+	if (!PicTryMakeTex(p))
+	{
+		PicFree(p);
+	}
+}
+void PicLoadPixels(
+	Pic *p, const struct vec2i size, const struct vec2i offset,
+	const SDL_Surface *image)
 {
 	memset(p, 0, sizeof *p);
 	p->size = size;
@@ -70,37 +94,45 @@ void PicLoad(
 	}
 	// Manually copy the pixels and replace the alpha component,
 	// since our gfx device format has no alpha
-	int srcI = offset.y*image->w + offset.x;
-	for (int i = 0; i < size.x * size.y; i++, srcI++)
+	PixelLayout from, to;
+	if (PixelLayoutTryFromFormat(&from, image->format) &&
+		PixelLayoutTryFromFormat(&to, gGraphicsDevice.Format))
 	{
-		const Uint32 pixel = ((Uint32 *)image->pixels)[srcI];
-		color_t c;
-		SDL_GetRGBA(pixel, image->format, &c.r, &c.g, &c.b, &c.a);
-		// If completely transparent, replace rgb with black (0) too
-		// This is because transparency blitting checks entire pixel
-		if (c.a == 0)
+		for (int y = 0; y < size.y; y++)
 		{
-			p->Data[i] = 0;
-		}
-		else
-		{
-			p->Data[i] = COLOR2PIXEL(c);
-		}
-		if ((i + 1) % size.x == 0)
-		{
-			srcI += image->w - size.x;
+			PixelsConvert(
+				p->Data + y * size.x,
+				(const Uint32 *)image->pixels + (offset.y + y) * image->w +
+					offset.x,
+				size.x, from, to);
 		}
 	}
-
-	if (!PicTryMakeTex(p))
+	else
 	{
-		goto bail;
+		int srcI = offset.y * image->w + offset.x;
+		for (int i = 0; i < size.x * size.y; i++, srcI++)
+		{
+			const Uint32 pixel = ((Uint32 *)image->pixels)[srcI];
+			color_t c;
+			SDL_GetRGBA(pixel, image->format, &c.r, &c.g, &c.b, &c.a);
+			// If completely transparent, replace rgb with black (0) too
+			// This is because transparency blitting checks entire pixel
+			if (c.a == 0)
+			{
+				p->Data[i] = 0;
+			}
+			else
+			{
+				p->Data[i] = COLOR2PIXEL(c);
+			}
+			if ((i + 1) % size.x == 0)
+			{
+				srcI += image->w - size.x;
+			}
+		}
 	}
-	return;
-
-bail:
-	PicFree(p);
 }
+static void PicDestroyTex(Pic *p);
 bool PicTryMakeTex(Pic *p)
 {
 	CASSERT(!PicIsNone(p), "cannot make tex of none pic");
@@ -108,32 +140,7 @@ bool PicTryMakeTex(Pic *p)
 	{
 		textureDebugger = hashmap_new();
 	}
-	if (p->Tex != NULL)
-	{
-		LOG(LM_GFX, LL_TRACE, "destroying texture %p data(%p)", p->Tex, p->Data);
-		SDL_DestroyTexture(p->Tex);
-		if (LL_TRACE >= LogModuleGetLevel(LM_GFX))
-		{
-			char key[32];
-			sprintf(key, "%p", p->Tex);
-			if (hashmap_get(textureDebugger, key, NULL) == MAP_OK)
-			{
-				if (hashmap_remove(textureDebugger, key) != MAP_OK)
-				{
-					LOG(LM_GFX, LL_TRACE, "Error: cannot remove tex from debugger");
-				}
-				else
-				{
-					LOG(LM_GFX, LL_TRACE, "Texture count: %d",
-						hashmap_length(textureDebugger));
-				}
-			}
-			else
-			{
-				LOG(LM_GFX, LL_TRACE, "Error: destroying unknown texture");
-			}
-		}
-	}
+	PicDestroyTex(p);
 	p->Tex = TextureCreate(
 		gGraphicsDevice.gameWindow.renderer, SDL_TEXTUREACCESS_STATIC,
 		p->size, SDL_BLENDMODE_NONE, 255);
@@ -180,14 +187,16 @@ Pic PicCopy(const Pic *src)
 	CMALLOC(p.Data, size);
 	memcpy(p.Data, src->Data, size);
 	p.Tex = NULL;
+	p.ResidentId = 0;
 	return p;
 }
 
-void PicFree(Pic *pic)
+static void PicDestroyTex(Pic *pic)
 {
 	if (pic->Tex != NULL)
 	{
-		LOG(LM_GFX, LL_TRACE, "freeing texture %p data(%p)", pic->Tex, pic->Data);
+		LOG(LM_GFX, LL_TRACE, "destroying texture %p data(%p)", pic->Tex,
+			pic->Data);
 		SDL_DestroyTexture(pic->Tex);
 		if (LL_TRACE >= LogModuleGetLevel(LM_GFX))
 		{
@@ -211,6 +220,13 @@ void PicFree(Pic *pic)
 			}
 		}
 	}
+	pic->Tex = NULL;
+}
+void PicFree(Pic *pic)
+{
+	ResidencyRemove(&gTextureResidency, pic->ResidentId, pic);
+	pic->ResidentId = 0;
+	PicDestroyTex(pic);
 	pic->size = svec2i_zero();
 	CFREE(pic->Data);
 	pic->Data = NULL;
@@ -282,7 +298,15 @@ void PicShrink(Pic *pic, const struct vec2i size, const struct vec2i offset)
 	pic->Data = newData;
 	pic->size = size;
 	pic->offset = svec2i_zero();
-	PicTryMakeTex(pic);
+	if (ResidencyHas(&gTextureResidency, pic->ResidentId, pic))
+	{
+		// Remade from the new pixels on next use
+		ResidencyUnload(&gTextureResidency, pic->ResidentId);
+	}
+	else
+	{
+		PicTryMakeTex(pic);
+	}
 }
 
 bool PicPxIsEdge(const Pic *pic, const struct vec2i pos, const bool isPixel)
@@ -315,7 +339,8 @@ color_t PicGetRandomColor(const Pic *p)
 	// Get a random non-transparent pixel from the pic
 	for (;;)
 	{
-		const uint32_t px = p->Data[rand() % (p->size.x * p->size.y)];
+		const uint32_t px = p->Data[RAND_INT(
+			RNG_COSMETIC, 0, p->size.x * p->size.y)];
 		const color_t c = PIXEL2COLOR(px);
 		if (c.a > 0)
 		{
@@ -344,5 +369,45 @@ void PicRender(
 		dest.Size.y = (mint_t)MROUND(src.Size.y * scale.y);
 	}
 	const double angle = ToDegrees(radians);
-	TextureRender(p->Tex, r, src, dest, mask, angle, flip);
+	TextureRender(PicGetTex(p), r, src, dest, mask, angle, flip);
+}
+
+void PicMakeLazy(Pic *p)
+{
+	PicDestroyTex(p);
+	p->ResidentId = ResidencyAdd(&gTextureResidency, p);
+}
+SDL_Texture *PicGetTex(const Pic *p)
+{
+	if (ResidencyHas(&gTextureResidency, p->ResidentId, p))
+	{
+		ResidencyUse(&gTextureResidency, p->ResidentId);
+	}
+	return p->Tex;
+}
+void PicPrefetch(const Pic *p)
+{
+	if (ResidencyHas(&gTextureResidency, p->ResidentId, p))
+	{
+		ResidencyPrefetch(&gTextureResidency, p->ResidentId);
+	}
+}
+static size_t PicLoadTex(void *asset)
+{
+	Pic *p = asset;
+	if (!PicTryMakeTex(p))
+	{
+		PicDestroyTex(p);
+		return 0;
+	}
+	return (size_t)(p->size.x * p->size.y) * sizeof *p->Data;
+}
+static void PicUnloadTex(void *asset)
+{
+	PicDestroyTex(asset);
+}
+static void PicSetResidentId(void *asset, const int id)
+{
+	Pic *p = asset;
+	p->ResidentId = id;
 }
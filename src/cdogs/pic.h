@@ -27,6 +27,7 @@
 
 #include <SDL_render.h>
 
+#include "residency.h"
 #include "vector.h"
 
 typedef struct
@@ -35,8 +36,12 @@ typedef struct
 	struct vec2i offset;
 	Uint32 *Data;
 	SDL_Texture *Tex;
+	// Id in gTextureResidency if the texture is made on first use, else 0
+	int ResidentId;
 } Pic;
 
+extern Residency gTextureResidency;
+
 color_t PixelToColor(
 	const SDL_PixelFormat *f, const Uint8 aShift, const Uint32 pixel);
 Uint32 ColorToPixel(
@@ -49,7 +54,17 @@ Uint32 ColorToPixel(
 void PicLoad(
 	Pic *p, const struct vec2i size, const struct vec2i offset,
 	const SDL_Surface *image);
+// Convert pixels only, without making the texture; safe on any thread
+void PicLoadPixels(
+	Pic *p, const struct vec2i size, const struct vec2i offset,
+	const SDL_Surface *image);
 bool PicTryMakeTex(Pic *p);
+// Make the texture on first use instead, and allow it to be evicted;
+// the pic must not move afterwards
+void PicMakeLazy(Pic *p);
+// Use instead of Tex for drawing
+SDL_Texture *PicGetTex(const Pic *p);
+void PicPrefetch(const Pic *p);
 Pic PicCopy(const Pic *src);
 void PicFree(Pic *pic);
 bool PicIsNone(const Pic *pic);
@@ -36,12 +36,17 @@
 #include <tinydir/tinydir.h>
 
 #include "files.h"
+#include "image_cache.h"
 #include "log.h"
+#include "pixel_ops.h"
 
 #define GRAPHICS_DIR "graphics"
 
 PicManager gPicManager;
 
+static void CharMaskQueueInit(CharMaskQueue *q);
+static void CharMaskQueueCancel(CharMaskQueue *q);
+static void CharMaskQueueTerminate(CharMaskQueue *q);
 void PicManagerInit(PicManager *pm)
 {
 	if (!IMG_Init(IMG_INIT_PNG))
@@ -60,15 +65,29 @@ void PicManagerInit(PicManager *pm)
 	CArrayInit(&pm->exitStyleNames, sizeof(char *));
 	CArrayInit(&pm->doorStyleNames, sizeof(char *));
 	CArrayInit(&pm->keyStyleNames, sizeof(char *));
+	CharMaskQueueInit(&pm->maskQueue);
 }
 
 static NamedPic *AddNamedPic(map_t pics, const char *name, const Pic *p);
 static NamedSprites *AddNamedSprites(map_t sprites, const char *name);
 static void AfterAdd(PicManager *pm);
-static void PicManagerAdd(
-	map_t pics, map_t sprites, const char *name, SDL_Surface *imageIn)
+// Pixels of an image file, decoded on a loader thread; textures are made
+// when it is added on the main thread
+typedef struct
 {
-	char buf[CDOGS_FILENAME_MAX];
+	char Name[CDOGS_FILENAME_MAX];
+	bool IsSpritesheet;
+	CArray Pics; // of Pic, without textures
+	uint64_t CacheKey;
+} PicDecoded;
+// Get the pic name from the file name; if it is a spritesheet, get the size
+// of each sprite too, otherwise size is zero
+static PicDecoded *PicDecodedNew(const char *name, struct vec2i *size)
+{
+	PicDecoded *d;
+	CCALLOC(d, sizeof *d);
+	CArrayInit(&d->Pics, sizeof(Pic));
+	char *buf = d->Name;
 	const char *dot = strrchr(name, '.');
 	if (dot)
 	{
@@ -83,32 +102,30 @@ static void PicManagerAdd(
 	// Special case: if the file name is in the form foobar_WxH.ext,
 	// this is a spritesheet where each sprite is W wide by H high
 	// Load multiple images from this single sheet
-	struct vec2i size = svec2i(imageIn->w, imageIn->h);
-	bool isSpritesheet = false;
+	*size = svec2i_zero();
 	char *underscore = strrchr(buf, '_');
 	const char *x = strrchr(buf, 'x');
 	if (underscore != NULL && x != NULL && underscore + 1 < x &&
 		x + 1 < buf + strlen(buf))
 	{
-		if (sscanf(underscore, "_%dx%d", &size.x, &size.y) != 2)
+		if (sscanf(underscore, "_%dx%d", &size->x, &size->y) != 2)
 		{
-			size = svec2i(imageIn->w, imageIn->h);
+			*size = svec2i_zero();
 		}
 		else
 		{
 			*underscore = '\0';
-			isSpritesheet = true;
+			d->IsSpritesheet = true;
 		}
 	}
-	NamedSprites *nsp = NULL;
-	NamedPic *np = NULL;
-	if (isSpritesheet)
-	{
-		nsp = AddNamedSprites(sprites, buf);
-	}
-	else
+	return d;
+}
+static void PicDecodeSurface(
+	PicDecoded *d, SDL_Surface *imageIn, struct vec2i size)
+{
+	if (!d->IsSpritesheet)
 	{
-		np = AddNamedPic(pics, buf, NULL);
+		size = svec2i(imageIn->w, imageIn->h);
 	}
 	// Use 32-bit image
 	SDL_Surface *image =
@@ -119,56 +136,166 @@ static void PicManagerAdd(
 	{
 		for (offset.x = 0; offset.x < image->w; offset.x += size.x)
 		{
-			Pic *pic;
-			if (isSpritesheet)
-			{
-				Pic p;
-				memset(&p, 0, sizeof p);
-				CArrayPushBack(&nsp->pics, &p);
-				pic = CArrayGet(&nsp->pics, nsp->pics.size - 1);
-			}
-			else
-			{
-				pic = &np->pic;
-			}
-			PicLoad(pic, size, offset, image);
-
-			if (strncmp("chars/", buf, strlen("chars/")) == 0)
-			{
-				// Convert char pics to multichannel version
-				for (int i = 0; i < pic->size.x * pic->size.y; i++)
-				{
-					color_t c = PIXEL2COLOR(pic->Data[i]);
-					// Don't bother if the alpha has already been modified; it
-					// means we have already processed this pixel
-					if (c.a != 255)
-					{
-						continue;
-					}
-					// Convert character color keyed color to
-					// greyscale + special alpha
-					const CharColorType colorType = CharColorTypeFromColor(c);
-					color_t converted = c;
-					if (colorType != CHAR_COLOR_COUNT)
-					{
-						const uint8_t value = MAX(MAX(c.r, c.g), c.b);
-						converted.r = converted.g = converted.b = value;
-						converted.a = CharColorTypeAlpha(colorType);
-					}
-					pic->Data[i] = COLOR2PIXEL(converted);
-				}
-			}
+			Pic p;
+			PicLoadPixels(&p, size, offset, image);
+			CArrayPushBack(&d->Pics, &p);
 		}
 	}
 	SDL_UnlockSurface(image);
 	SDL_FreeSurface(image);
+}
+static void ConvertCharPic(Pic *pic)
+{
+	// Convert char pics to multichannel version
+	for (int i = 0; i < pic->size.x * pic->size.y; i++)
+	{
+		color_t c = PIXEL2COLOR(pic->Data[i]);
+		// Don't bother if the alpha has already been modified; it
+		// means we have already processed this pixel
+		if (c.a != 255)
+		{
+			continue;
+		}
+		// Convert character color keyed color to
+		// greyscale + special alpha
+		const CharColorType colorType = CharColorTypeFromColor(c);
+		color_t converted = c;
+		if (colorType != CHAR_COLOR_COUNT)
+		{
+			const uint8_t value = MAX(MAX(c.r, c.g), c.b);
+			converted.r = converted.g = converted.b = value;
+			converted.a = CharColorTypeAlpha(colorType);
+		}
+		pic->Data[i] = COLOR2PIXEL(converted);
+	}
+}
 
-	AfterAdd(&gPicManager);
+static void *PicDecode(const AssetJob *job)
+{
+	long len;
+	char *buf = ReadFileIntoBuf(job->Path, "rb", &len);
+	if (buf == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Cannot open image '%s'", job->Path);
+		return NULL;
+	}
+	SDL_RWops *rwops = SDL_RWFromConstMem(buf, (int)len);
+	PicDecoded *d = NULL;
+	if (rwops == NULL || !IMG_isPNG(rwops))
+	{
+		goto bail;
+	}
+	struct vec2i size;
+	d = PicDecodedNew(job->Name, &size);
+	// The pixels also depend on how the sheet is split, and our format
+	const Uint32 params[] = {
+		(Uint32)size.x, (Uint32)size.y, gGraphicsDevice.Format->format};
+	d->CacheKey = ImageCacheKey(
+		buf, (size_t)len, ImageCacheKey(params, sizeof params, 0));
+	if (ImageCacheLoad(&gImageCache, d->CacheKey, &d->Pics))
+	{
+		goto bail;
+	}
+	SDL_Surface *data = IMG_Load_RW(rwops, 0);
+	if (!data)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Cannot load image IMG_Load: %s",
+			IMG_GetError());
+		CArrayTerminate(&d->Pics);
+		CFREE(d);
+		d = NULL;
+		goto bail;
+	}
+	PicDecodeSurface(d, data, size);
+	SDL_FreeSurface(data);
+	ImageCacheStore(&gImageCache, d->CacheKey, &d->Pics);
+
+bail:
+	if (rwops != NULL)
+	{
+		rwops->close(rwops);
+	}
+	CFREE(buf);
+	return d;
 }
+static void PicAdd(const AssetJob *job, void *data)
+{
+	PicDecoded *d = data;
+	NamedSprites *nsp = NULL;
+	NamedPic *np = NULL;
+	if (d->IsSpritesheet)
+	{
+		nsp = AddNamedSprites(job->Maps[1], d->Name);
+		if (nsp != NULL)
+		{
+			nsp->CacheKey = d->CacheKey;
+		}
+	}
+	else
+	{
+		np = AddNamedPic(job->Maps[0], d->Name, NULL);
+		if (np != NULL)
+		{
+			np->CacheKey = d->CacheKey;
+		}
+	}
+	const bool isChar = strncmp("chars/", d->Name, strlen("chars/")) == 0;
+	CA_FOREACH(Pic, pic, d->Pics)
+	// Note: textures keep the original colours, so char pics need them now
+	if (isChar && pic->Data != NULL)
+	{
+		if (!PicTryMakeTex(pic))
+		{
+			PicFree(pic);
+		}
+		else
+		{
+			ConvertCharPic(pic);
+		}
+	}
+	if (nsp != NULL)
+	{
+		CArrayPushBack(&nsp->pics, pic);
+	}
+	else if (np != NULL)
+	{
+		np->pic = *pic;
+	}
+	else
+	{
+		PicFree(pic);
+	}
+	CA_FOREACH_END()
+	// Other textures are made on first use; the pics no longer move
+	if (!isChar)
+	{
+		if (nsp != NULL)
+		{
+			CA_FOREACH(Pic, pic, nsp->pics)
+			if (pic->Data != NULL)
+			{
+				PicMakeLazy(pic);
+			}
+			CA_FOREACH_END()
+		}
+		else if (np != NULL && np->pic.Data != NULL)
+		{
+			PicMakeLazy(&np->pic);
+		}
+	}
+	CArrayTerminate(&d->Pics);
+	CFREE(d);
+}
+static void PicFinish(void *context)
+{
+	AfterAdd(context);
+}
+static const AssetKind picAssetKind = {
+	"graphics", PicDecode, PicAdd, PicFinish};
 
-void PicManagerLoadDir(
-	PicManager *pm, const char *path, const char *prefix, map_t pics,
-	map_t sprites)
+void PicManagerQueueDir(
+	AssetLoader *l, PicManager *pm, const char *path, const char *prefix,
+	map_t pics, map_t sprites)
 {
 	tinydir_dir dir;
 	if (tinydir_open(&dir, path) == -1)
@@ -192,33 +319,19 @@ void PicManagerLoadDir(
 		}
 		if (file.is_reg)
 		{
-			SDL_RWops *rwops = SDL_RWFromFile(file.path, "rb");
-			const bool isPng = IMG_isPNG(rwops);
-			if (isPng)
+			char buf[CDOGS_PATH_MAX];
+			if (prefix)
 			{
-				SDL_Surface *data = IMG_Load_RW(rwops, 0);
-				if (!data)
-				{
-					LOG(LM_MAIN, LL_ERROR, "Cannot load image IMG_Load: %s",
-						IMG_GetError());
-				}
-				else
-				{
-					char buf[CDOGS_PATH_MAX];
-					if (prefix)
-					{
-						char buf1[CDOGS_PATH_MAX];
-						sprintf(buf1, "%s/%s", prefix, file.name);
-						PathGetWithoutExtension(buf, buf1);
-					}
-					else
-					{
-						PathGetBasenameWithoutExtension(buf, file.name);
-					}
-					PicManagerAdd(pics, sprites, buf, data);
-				}
+				char buf1[CDOGS_PATH_MAX];
+				sprintf(buf1, "%s/%s", prefix, file.name);
+				PathGetWithoutExtension(buf, buf1);
 			}
-			rwops->close(rwops);
+			else
+			{
+				PathGetBasenameWithoutExtension(buf, file.name);
+			}
+			AssetLoaderQueue(
+				l, &picAssetKind, file.path, buf, pm, pics, sprites);
 		}
 		else if (file.is_dir && file.name[0] != '.')
 		{
@@ -226,11 +339,12 @@ void PicManagerLoadDir(
 			{
 				char buf[CDOGS_PATH_MAX];
 				sprintf(buf, "%s/%s", prefix, file.name);
-				PicManagerLoadDir(pm, file.path, buf, pics, sprites);
+				PicManagerQueueDir(l, pm, file.path, buf, pics, sprites);
 			}
 			else
 			{
-				PicManagerLoadDir(pm, file.path, file.name, pics, sprites);
+				PicManagerQueueDir(
+					l, pm, file.path, file.name, pics, sprites);
 			}
 		}
 	}
@@ -238,11 +352,11 @@ void PicManagerLoadDir(
 bail:
 	tinydir_close(&dir);
 }
-void PicManagerLoad(PicManager *pm)
+void PicManagerQueueLoad(AssetLoader *l, PicManager *pm)
 {
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, GRAPHICS_DIR);
-	PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites);
+	PicManagerQueueDir(l, pm, buf, NULL, pm->pics, pm->sprites);
 }
 
 static void FindStylePics(
@@ -412,12 +526,14 @@ static void NamedPicDestroy(any_t data);
 static void NamedSpritesDestroy(any_t data);
 void PicManagerClearCustom(PicManager *pm)
 {
+	CharMaskQueueCancel(&pm->maskQueue);
 	hashmap_clear(pm->customPics, NamedPicDestroy);
 	hashmap_clear(pm->customSprites, NamedSpritesDestroy);
 	AfterAdd(pm);
 }
 static void PicManagerUnload(PicManager *pm)
 {
+	CharMaskQueueCancel(&pm->maskQueue);
 	hashmap_clear(pm->pics, NamedPicDestroy);
 	hashmap_clear(pm->sprites, NamedSpritesDestroy);
 	hashmap_clear(pm->customPics, NamedPicDestroy);
@@ -433,6 +549,7 @@ static void StyleNamesDestroy(CArray *a)
 }
 void PicManagerTerminate(PicManager *pm)
 {
+	CharMaskQueueTerminate(&pm->maskQueue);
 	PicManagerUnload(pm);
 	StyleNamesDestroy(&pm->hairstyleNames);
 	StyleNamesDestroy(&pm->wallStyleNames);
@@ -467,7 +584,11 @@ static int ReloadTexture(any_t data, any_t item)
 {
 	UNUSED(data);
 	NamedPic *n = item;
-	if (!PicTryMakeTex(&n->pic))
+	if (ResidencyHas(&gTextureResidency, n->pic.ResidentId, &n->pic))
+	{
+		ResidencyUnload(&gTextureResidency, n->pic.ResidentId);
+	}
+	else if (!PicTryMakeTex(&n->pic))
 	{
 		LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
 		n->pic.Tex = NULL;
@@ -479,7 +600,11 @@ static int ReloadSpriteTexture(any_t data, any_t item)
 	UNUSED(data);
 	NamedSprites *n = item;
 	CA_FOREACH(Pic, op, n->pics)
-	if (!PicTryMakeTex(op))
+	if (ResidencyHas(&gTextureResidency, op->ResidentId, op))
+	{
+		ResidencyUnload(&gTextureResidency, op->ResidentId);
+	}
+	else if (!PicTryMakeTex(op))
 	{
 		LOG(LM_MAIN, LL_ERROR, "failed to reload pic texture");
 		op->Tex = NULL;
@@ -550,6 +675,37 @@ NamedPic *PicManagerGetMaskedStylePic(
 	return PicManagerGetMaskedPic(pm, buf, mask, maskAlt);
 }
 
+// Apply mask based on which channel each pixel is
+static void MaskStylePixels(
+	Pic *p, const Pic *src, const color_t mask, const color_t maskAlt,
+	const bool noAltMask)
+{
+	const size_t n = (size_t)(p->size.x * p->size.y);
+	PixelLayout l;
+	if (PixelLayoutTryFromFormat(&l, gGraphicsDevice.Format))
+	{
+		PixelsMaskStyle(p->Data, src->Data, n, l, mask, maskAlt, noAltMask);
+		return;
+	}
+	// Unusual pixel format; mask a pixel at a time
+	for (size_t i = 0; i < n; i++)
+	{
+		color_t c = PIXEL2COLOR(src->Data[i]);
+		if (c.g <= 2 && c.b <= 2 && !noAltMask)
+		{
+			// Restore to white before masking
+			c.g = c.r;
+			c.b = c.r;
+			c = ColorMult(c, maskAlt);
+		}
+		else if (c.r == c.g && c.g == c.b)
+		{
+			c = ColorMult(c, mask);
+		}
+		p->Data[i] = COLOR2PIXEL(c);
+		// TODO: more channels
+	}
+}
 static void PicManagerGenerateMaskedPic(
 	PicManager *pm, const char *name, const color_t mask,
 	const color_t maskAlt, const bool noAltMask)
@@ -562,29 +718,37 @@ static void PicManagerGenerateMaskedPic(
 
 	// Check if the original pic is available; if not then it's impossible to
 	// create the masked version
-	Pic *original = PicManagerGetPic(pm, name);
+	const NamedPic *original = PicManagerGetNamedPic(pm, name);
 	CASSERT(original != NULL, "Cannot find original pic for masking");
 
-	// Create the new pic by masking the original pic
-	Pic p = PicCopy(original);
-	for (int i = 0; i < p.size.x * p.size.y; i++)
+	// Use the cached masked pic if there is one
+	CArray cached;
+	CArrayInit(&cached, sizeof(Pic));
+	uint64_t key = 0;
+	if (original->CacheKey != 0)
 	{
-		color_t c = PIXEL2COLOR(original->Data[i]);
-		// Apply mask based on which channel each pixel is
-		if (c.g <= 2 && c.b <= 2 && !noAltMask)
-		{
-			// Restore to white before masking
-			c.g = c.r;
-			c.b = c.r;
-			c = ColorMult(c, maskAlt);
-		}
-		else if (c.r == c.g && c.g == c.b)
+		const uint8_t params[] = {
+			mask.r,	   mask.g,	  mask.b,	 mask.a,		   maskAlt.r,
+			maskAlt.g, maskAlt.b, maskAlt.a, (uint8_t)noAltMask};
+		key = ImageCacheKey(params, sizeof params, original->CacheKey);
+	}
+	Pic p;
+	if (key != 0 && ImageCacheLoad(&gImageCache, key, &cached))
+	{
+		p = *(const Pic *)CArrayGet(&cached, 0);
+	}
+	else
+	{
+		// Create the new pic by masking the original pic
+		p = PicCopy(&original->pic);
+		MaskStylePixels(&p, &original->pic, mask, maskAlt, noAltMask);
+		if (key != 0)
 		{
-			c = ColorMult(c, mask);
+			CArrayPushBack(&cached, &p);
+			ImageCacheStore(&gImageCache, key, &cached);
 		}
-		p.Data[i] = COLOR2PIXEL(c);
-		// TODO: more channels
 	}
+	CArrayTerminate(&cached);
 	if (!PicTryMakeTex(&p))
 	{
 		p.Tex = NULL;
@@ -602,6 +766,225 @@ void PicManagerGenerateMaskedStylePic(
 	PicManagerGenerateMaskedPic(pm, buf, mask, maskAlt, noAltMask);
 }
 
+typedef struct
+{
+	char *Name;
+	const NamedSprites *Src;
+	CharColors Colors;
+	PixelLayout Layout;
+	bool HasLayout; // if false, mask with the scalar fallback
+	CArray Pics; // of Pic, masked but without textures
+} CharMaskJob;
+static void CharMaskJobFree(CharMaskJob *job)
+{
+	CA_FOREACH(Pic, p, job->Pics)
+	CFREE(p->Data);
+	CA_FOREACH_END()
+	CArrayTerminate(&job->Pics);
+	CFREE(job->Name);
+	CFREE(job);
+}
+static void CharMaskJobNoFree(any_t data)
+{
+	UNUSED(data);
+}
+// l can be NULL if the pixel format isn't supported by the pixel ops
+static Pic MaskCharPic(
+	const Pic *src, const PixelLayout *l, const CharColors *colors)
+{
+	Pic p = *src;
+	p.Tex = NULL;
+	const size_t n = (size_t)(p.size.x * p.size.y);
+	CMALLOC(p.Data, n * sizeof *p.Data);
+	if (l != NULL)
+	{
+		PixelsMaskCharColors(p.Data, src->Data, n, *l, colors);
+		return p;
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		if (src->Data[i] == 0)
+		{
+			p.Data[i] = 0;
+			continue;
+		}
+		const color_t c = PIXEL2COLOR(src->Data[i]);
+		p.Data[i] =
+			COLOR2PIXEL(ColorMult(c, CharColorsGetChannelMask(colors, c.a)));
+	}
+	return p;
+}
+// Mask all the sprites, or get them from the image cache
+static void MaskCharPics(
+	CArray *pics, const NamedSprites *src, const PixelLayout *l,
+	const CharColors *colors)
+{
+	uint64_t key = 0;
+	if (src->CacheKey != 0 && l != NULL)
+	{
+		const uint64_t layoutKey = ImageCacheKey(l, sizeof *l, src->CacheKey);
+		key = ImageCacheKey(colors, sizeof *colors, layoutKey);
+		if (ImageCacheLoad(&gImageCache, key, pics))
+		{
+			return;
+		}
+	}
+	CA_FOREACH(const Pic, op, src->pics)
+	const Pic p = MaskCharPic(op, l, colors);
+	CArrayPushBack(pics, &p);
+	CA_FOREACH_END()
+	if (key != 0)
+	{
+		ImageCacheStore(&gImageCache, key, pics);
+	}
+}
+static int CharMaskWorker(void *data)
+{
+	CharMaskQueue *q = data;
+	SDL_LockMutex(q->lock);
+	for (;;)
+	{
+		while (!q->quit && q->jobs.size == 0)
+		{
+			SDL_CondWait(q->cond, q->lock);
+		}
+		if (q->quit)
+		{
+			break;
+		}
+		CharMaskJob *job = *(CharMaskJob **)CArrayGet(&q->jobs, 0);
+		CArrayDelete(&q->jobs, 0);
+		q->busy = true;
+		SDL_UnlockMutex(q->lock);
+
+		MaskCharPics(
+			&job->Pics, job->Src, job->HasLayout ? &job->Layout : NULL,
+			&job->Colors);
+
+		SDL_LockMutex(q->lock);
+		CArrayPushBack(&q->done, &job);
+		q->busy = false;
+		SDL_CondBroadcast(q->cond);
+	}
+	SDL_UnlockMutex(q->lock);
+	return 0;
+}
+static void CharMaskQueueInit(CharMaskQueue *q)
+{
+	memset(q, 0, sizeof *q);
+	CArrayInit(&q->jobs, sizeof(CharMaskJob *));
+	CArrayInit(&q->done, sizeof(CharMaskJob *));
+	q->pending = hashmap_new();
+	q->lock = SDL_CreateMutex();
+	q->cond = SDL_CreateCond();
+	// Select the pixel ops now rather than racing the worker to do it
+	PixelOpsGetImpl();
+	if (q->lock != NULL && q->cond != NULL)
+	{
+		q->thread = SDL_CreateThread(CharMaskWorker, "CharMask", q);
+	}
+	if (q->thread == NULL)
+	{
+		// Fall back to masking synchronously
+		LOG(LM_GFX, LL_WARN, "cannot create char mask thread: %s",
+			SDL_GetError());
+	}
+}
+// Drop all queued jobs; they reference sprites that are about to be freed
+static void CharMaskQueueCancel(CharMaskQueue *q)
+{
+	if (q->thread == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(q->lock);
+	CA_FOREACH(CharMaskJob *, job, q->jobs)
+	CharMaskJobFree(*job);
+	CA_FOREACH_END()
+	CArrayClear(&q->jobs);
+	while (q->busy)
+	{
+		SDL_CondWait(q->cond, q->lock);
+	}
+	CA_FOREACH(CharMaskJob *, job, q->done)
+	CharMaskJobFree(*job);
+	CA_FOREACH_END()
+	CArrayClear(&q->done);
+	SDL_UnlockMutex(q->lock);
+	hashmap_clear(q->pending, CharMaskJobNoFree);
+}
+static void CharMaskQueueTerminate(CharMaskQueue *q)
+{
+	CharMaskQueueCancel(q);
+	if (q->thread != NULL)
+	{
+		SDL_LockMutex(q->lock);
+		q->quit = true;
+		SDL_CondBroadcast(q->cond);
+		SDL_UnlockMutex(q->lock);
+		SDL_WaitThread(q->thread, NULL);
+	}
+	SDL_DestroyCond(q->cond);
+	SDL_DestroyMutex(q->lock);
+	hashmap_free(q->pending);
+	CArrayTerminate(&q->jobs);
+	CArrayTerminate(&q->done);
+	memset(q, 0, sizeof *q);
+}
+
+static void AddCharSprites(
+	PicManager *pm, const char *name, const CArray *pics);
+void PicManagerUpdate(PicManager *pm)
+{
+	// Between frames, so no queued draw still refers to evicted textures
+	ResidencyEvict(&gTextureResidency);
+	CharMaskQueue *q = &pm->maskQueue;
+	if (q->thread == NULL)
+	{
+		return;
+	}
+	CArray done;
+	CArrayInit(&done, sizeof(CharMaskJob *));
+	SDL_LockMutex(q->lock);
+	const CArray tmp = q->done;
+	q->done = done;
+	done = tmp;
+	SDL_UnlockMutex(q->lock);
+
+	for (int i = 0; i < (int)done.size; i++)
+	{
+		CharMaskJob *job = *(CharMaskJob **)CArrayGet(&done, i);
+		AddCharSprites(pm, job->Name, &job->Pics);
+		// Pic data now owned by the sprites
+		CArrayClear(&job->Pics);
+		hashmap_remove(q->pending, job->Name);
+		CharMaskJobFree(job);
+	}
+	if (done.size > 0)
+	{
+		AfterAdd(pm);
+	}
+	CArrayTerminate(&done);
+}
+void PicManagerWaitCharSprites(PicManager *pm)
+{
+	CharMaskQueue *q = &pm->maskQueue;
+	if (q->thread == NULL)
+	{
+		return;
+	}
+	SDL_LockMutex(q->lock);
+	while (q->jobs.size > 0 || q->busy)
+	{
+		SDL_CondWait(q->cond, q->lock);
+	}
+	SDL_UnlockMutex(q->lock);
+	PicManagerUpdate(pm);
+}
+
+static const NamedSprites *GenerateCharSprites(
+	PicManager *pm, const char *name, const NamedSprites *ons,
+	const PixelLayout *l, const CharColors *colors);
 const NamedSprites *PicManagerGetCharSprites(
 	PicManager *pm, const char *name, const CharColors *colors)
 {
@@ -618,28 +1001,75 @@ const NamedSprites *PicManagerGetCharSprites(
 	{
 		return NULL;
 	}
-	NamedSprites *nsp = AddNamedSprites(pm->customSprites, buf);
-	CA_FOREACH(Pic, op, ons->pics)
-	Pic p = PicCopy(op);
-	p.Tex = NULL;
-	for (int i = 0; i < p.size.x * p.size.y; i++)
+	PixelLayout layout;
+	const bool hasLayout =
+		PixelLayoutTryFromFormat(&layout, gGraphicsDevice.Format);
+	const PixelLayout *l = hasLayout ? &layout : NULL;
+	CharMaskQueue *q = &pm->maskQueue;
+	if (q->thread == NULL)
 	{
-		if (op->Data[i] == 0)
+		return GenerateCharSprites(pm, buf, ons, l, colors);
+	}
+
+	CharMaskJob *job;
+	if (hashmap_get(q->pending, buf, (any_t *)&job) != MAP_OK)
+	{
+		CCALLOC(job, sizeof *job);
+		CSTRDUP(job->Name, buf);
+		job->Src = ons;
+		job->Colors = *colors;
+		job->HasLayout = l != NULL;
+		if (l != NULL)
 		{
-			continue;
+			job->Layout = *l;
 		}
-		const color_t c = PIXEL2COLOR(op->Data[i]);
-		p.Data[i] =
-			COLOR2PIXEL(ColorMult(c, CharColorsGetChannelMask(colors, c.a)));
+		CArrayInit(&job->Pics, sizeof(Pic));
+		hashmap_put(q->pending, buf, job);
+		SDL_LockMutex(q->lock);
+		CArrayPushBack(&q->jobs, &job);
+		SDL_CondBroadcast(q->cond);
+		SDL_UnlockMutex(q->lock);
+	}
+
+	// Use neutral grey sprites until the masked ones are ready;
+	// these are generated once per sprite sheet. Prefix the name so that
+	// they don't clash with the masked sprites of all-grey colours.
+	const CharColors neutral = CharColorsFromOneColor(colorGray);
+	char neutralName[CDOGS_PATH_MAX];
+	CharColorsGetMaskedName(neutralName, name, &neutral);
+	sprintf(buf, "grey:%s", neutralName);
+	ns = PicManagerGetSprites(pm, buf);
+	if (ns != NULL)
+	{
+		return ns;
 	}
+	return GenerateCharSprites(pm, buf, ons, l, &neutral);
+}
+static const NamedSprites *GenerateCharSprites(
+	PicManager *pm, const char *name, const NamedSprites *ons,
+	const PixelLayout *l, const CharColors *colors)
+{
+	CArray pics;
+	CArrayInit(&pics, sizeof(Pic));
+	MaskCharPics(&pics, ons, l, colors);
+	AddCharSprites(pm, name, &pics);
+	CArrayTerminate(&pics);
+	AfterAdd(pm);
+	return PicManagerGetSprites(pm, name);
+}
+// Add masked sprites, taking ownership of the pic data and making textures
+static void AddCharSprites(
+	PicManager *pm, const char *name, const CArray *pics)
+{
+	NamedSprites *nsp = AddNamedSprites(pm->customSprites, name);
+	CA_FOREACH(const Pic, src, *pics)
+	Pic p = *src;
 	if (!PicTryMakeTex(&p))
 	{
 		p.Tex = NULL;
 	}
 	CArrayPushBack(&nsp->pics, &p);
 	CA_FOREACH_END()
-	AfterAdd(pm);
-	return nsp;
 }
 
 static void GetMaskedName(
@@ -659,6 +1089,7 @@ static NamedPic *AddNamedPic(map_t pics, const char *name, const Pic *p)
 	if (p != NULL)
 		n->pic = *p;
 	CSTRDUP(n->name, name);
+	n->CacheKey = 0;
 	const int error = hashmap_put(pics, name, n);
 	if (error != MAP_OK)
 	{
@@ -27,10 +27,28 @@
 */
 #pragma once
 
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
+#include "asset_loader.h"
 #include "blit.h"
 #include "c_hashmap/hashmap.h"
 #include "cpic.h"
 
+// Masked char sprites are generated on a worker thread, then uploaded on
+// the main thread in PicManagerUpdate
+typedef struct
+{
+	SDL_Thread *thread;
+	SDL_mutex *lock;
+	SDL_cond *cond;
+	CArray jobs;	// of CharMaskJob *, waiting to be masked
+	CArray done;	// of CharMaskJob *, waiting to be uploaded
+	bool busy;
+	bool quit;
+	map_t pending;	// of CharMaskJob *, by masked name; main thread only
+} CharMaskQueue;
+
 typedef struct
 {
 	map_t pics;	// of NamedPic
@@ -44,18 +62,25 @@ typedef struct
 	CArray exitStyleNames;	// of char *
 	CArray doorStyleNames;	// of char *
 	CArray keyStyleNames;	// of char *
+
+	CharMaskQueue maskQueue;
 } PicManager;
 
 extern PicManager gPicManager;
 
 void PicManagerInit(PicManager *pm);
-void PicManagerLoad(PicManager *pm);
-void PicManagerLoadDir(
-	PicManager *pm, const char *path, const char *prefix,
+// Queue the pics to be loaded with the other assets in AssetLoaderFinish
+void PicManagerQueueLoad(AssetLoader *l, PicManager *pm);
+void PicManagerQueueDir(
+	AssetLoader *l, PicManager *pm, const char *path, const char *prefix,
 	map_t pics, map_t sprites);
 void PicManagerClearCustom(PicManager *pm);
 void PicManagerTerminate(PicManager *pm);
 void PicManagerReloadTextures(PicManager *pm);
+// Upload char sprites that have finished masking; call once per frame
+void PicManagerUpdate(PicManager *pm);
+// Block until all queued char sprites are masked and uploaded
+void PicManagerWaitCharSprites(PicManager *pm);
 
 // Note: return ptr to NamedPic so we can store that instead of the name
 NamedPic *PicManagerGetNamedPic(const PicManager *pm, const char *name);
@@ -75,6 +100,8 @@ void PicManagerGenerateMaskedStylePic(
 	PicManager *pm, const char *name, const char *style, const char *type,
 	const color_t mask, const color_t maskAlt, const bool noAltMask);
 // Get masked character pics
+// New colour combinations are masked in the background; until they are
+// ready, neutral grey sprites are returned instead
 const NamedSprites *PicManagerGetCharSprites(
 	PicManager *pm, const char *name, const CharColors *colors);
 
@@ -0,0 +1,531 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "pixel_ops.h"
+
+#include <SDL_cpuinfo.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_OPS_HAS_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXEL_OPS_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#include "log.h"
+#include "utils.h"
+
+
+typedef void (*PixelsConvertFunc)(
+	uint32_t *, const uint32_t *, const size_t, const PixelLayout,
+	const PixelLayout);
+typedef void (*PixelsMaskCharColorsFunc)(
+	uint32_t *, const uint32_t *, const size_t, const PixelLayout,
+	const CharColors *);
+typedef void (*PixelsMaskStyleFunc)(
+	uint32_t *, const uint32_t *, const size_t, const PixelLayout,
+	const color_t, const color_t, const bool);
+typedef void (*PixelsFillFunc)(uint32_t *, const size_t, const uint32_t);
+typedef struct
+{
+	PixelsConvertFunc Convert;
+	PixelsMaskCharColorsFunc MaskCharColors;
+	PixelsMaskStyleFunc MaskStyle;
+	PixelsFillFunc Fill;
+} PixelOps;
+
+
+// Scalar implementations; also used for the tails of the SIMD versions
+
+#define CH(_p, _shift) ((uint32_t)(((_p) >> (_shift)) & 0xff))
+// Exact (x / 255) for x in [0, 255*255]
+#define DIV255(_x) (((_x) + 1 + ((_x) >> 8)) >> 8)
+
+static uint32_t ColorToLayout(const color_t c, const PixelLayout l)
+{
+	return ((uint32_t)c.r << l.RShift) | ((uint32_t)c.g << l.GShift) |
+		((uint32_t)c.b << l.BShift) | ((uint32_t)c.a << l.AShift);
+}
+// Multiply each 8-bit channel of p by the same channel in m, as ColorMult
+static uint32_t PixelMult(const uint32_t p, const uint32_t m)
+{
+	uint32_t out = 0;
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		const uint32_t x = CH(p, shift) * CH(m, shift);
+		out |= DIV255(x) << shift;
+	}
+	return out;
+}
+
+static void ConvertScalar(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout from,
+	const PixelLayout to)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		const uint32_t p = src[i];
+		const uint32_t a = CH(p, from.AShift);
+		// If completely transparent, replace rgb with black (0) too
+		// This is because transparency blitting checks entire pixel
+		dst[i] = a == 0 ? 0
+						: (CH(p, from.RShift) << to.RShift) |
+							  (CH(p, from.GShift) << to.GShift) |
+							  (CH(p, from.BShift) << to.BShift) |
+							  (a << to.AShift);
+	}
+}
+
+// Char masks by alpha, from 255 down to 249
+#define CHAR_MASK_ALPHA_MIN 249
+#define CHAR_MASK_COUNT 7
+static void GetCharMasks(
+	uint32_t *masks, const PixelLayout l, const CharColors *colors)
+{
+	for (int i = 0; i < CHAR_MASK_COUNT; i++)
+	{
+		masks[i] = ColorToLayout(
+			CharColorsGetChannelMask(colors, (uint8_t)(255 - i)), l);
+	}
+}
+static void MaskCharColorsScalar(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const CharColors *colors)
+{
+	uint32_t masks[CHAR_MASK_COUNT];
+	GetCharMasks(masks, l, colors);
+	for (size_t i = 0; i < n; i++)
+	{
+		const uint32_t p = src[i];
+		const uint32_t a = CH(p, l.AShift);
+		const uint32_t m =
+			a >= CHAR_MASK_ALPHA_MIN ? masks[255 - a] : masks[0];
+		dst[i] = PixelMult(p, m);
+	}
+}
+
+static void MaskStyleScalar(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const color_t mask, const color_t maskAlt, const bool noAltMask)
+{
+	const uint32_t m = ColorToLayout(mask, l);
+	const uint32_t mAlt = ColorToLayout(maskAlt, l);
+	for (size_t i = 0; i < n; i++)
+	{
+		const uint32_t p = src[i];
+		const uint32_t r = CH(p, l.RShift);
+		const uint32_t g = CH(p, l.GShift);
+		const uint32_t b = CH(p, l.BShift);
+		if (g <= 2 && b <= 2 && !noAltMask)
+		{
+			// Restore to white before masking
+			const uint32_t white = (p & ((uint32_t)0xff << l.AShift)) |
+				(r << l.RShift) | (r << l.GShift) | (r << l.BShift);
+			dst[i] = PixelMult(white, mAlt);
+		}
+		else if (r == g && g == b)
+		{
+			dst[i] = PixelMult(p, m);
+		}
+		else
+		{
+			dst[i] = p;
+		}
+	}
+}
+
+static void FillScalar(uint32_t *dst, const size_t n, const uint32_t pixel)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		dst[i] = pixel;
+	}
+}
+
+
+#ifdef PIXEL_OPS_HAS_SSE2
+
+#define SSE2_CH(_p, _shift) \
+	_mm_and_si128( \
+		_mm_srl_epi32((_p), _mm_cvtsi32_si128(_shift)), _mm_set1_epi32(0xff))
+#define SSE2_SHL(_p, _shift) _mm_sll_epi32((_p), _mm_cvtsi32_si128(_shift))
+#define SSE2_SELECT(_mask, _a, _b) \
+	_mm_or_si128(_mm_and_si128((_mask), (_a)), _mm_andnot_si128((_mask), (_b)))
+
+static __m128i Div255SSE2(const __m128i x)
+{
+	const __m128i one = _mm_set1_epi16(1);
+	return _mm_srli_epi16(
+		_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+}
+static __m128i PixelMultSSE2(const __m128i p, const __m128i m)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = Div255SSE2(_mm_mullo_epi16(
+		_mm_unpacklo_epi8(p, zero), _mm_unpacklo_epi8(m, zero)));
+	const __m128i hi = Div255SSE2(_mm_mullo_epi16(
+		_mm_unpackhi_epi8(p, zero), _mm_unpackhi_epi8(m, zero)));
+	return _mm_packus_epi16(lo, hi);
+}
+
+static void ConvertSSE2(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout from,
+	const PixelLayout to)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i a = SSE2_CH(p, from.AShift);
+		__m128i out = SSE2_SHL(SSE2_CH(p, from.RShift), to.RShift);
+		out = _mm_or_si128(
+			out, SSE2_SHL(SSE2_CH(p, from.GShift), to.GShift));
+		out = _mm_or_si128(
+			out, SSE2_SHL(SSE2_CH(p, from.BShift), to.BShift));
+		out = _mm_or_si128(out, SSE2_SHL(a, to.AShift));
+		out = _mm_andnot_si128(_mm_cmpeq_epi32(a, zero), out);
+		_mm_storeu_si128((__m128i *)(dst + i), out);
+	}
+	ConvertScalar(dst + i, src + i, n - i, from, to);
+}
+
+static void MaskCharColorsSSE2(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const CharColors *colors)
+{
+	uint32_t masks[CHAR_MASK_COUNT];
+	GetCharMasks(masks, l, colors);
+	__m128i maskVs[CHAR_MASK_COUNT];
+	for (int j = 0; j < CHAR_MASK_COUNT; j++)
+	{
+		maskVs[j] = _mm_set1_epi32((int)masks[j]);
+	}
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i a = SSE2_CH(p, l.AShift);
+		__m128i m = maskVs[0];
+		for (int j = 1; j < CHAR_MASK_COUNT; j++)
+		{
+			const __m128i eq = _mm_cmpeq_epi32(a, _mm_set1_epi32(255 - j));
+			m = SSE2_SELECT(eq, maskVs[j], m);
+		}
+		_mm_storeu_si128((__m128i *)(dst + i), PixelMultSSE2(p, m));
+	}
+	MaskCharColorsScalar(dst + i, src + i, n - i, l, colors);
+}
+
+static void MaskStyleSSE2(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const color_t mask, const color_t maskAlt, const bool noAltMask)
+{
+	const __m128i m = _mm_set1_epi32((int)ColorToLayout(mask, l));
+	const __m128i mAlt = _mm_set1_epi32((int)ColorToLayout(maskAlt, l));
+	const __m128i alphaMask = _mm_set1_epi32((int)(0xffu << l.AShift));
+	const __m128i three = _mm_set1_epi32(3);
+	const __m128i allowAlt = noAltMask ? _mm_setzero_si128()
+									   : _mm_set1_epi32(-1);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i r = SSE2_CH(p, l.RShift);
+		const __m128i g = SSE2_CH(p, l.GShift);
+		const __m128i b = SSE2_CH(p, l.BShift);
+		const __m128i isAlt = _mm_and_si128(
+			allowAlt,
+			_mm_and_si128(_mm_cmplt_epi32(g, three), _mm_cmplt_epi32(b, three)));
+		const __m128i isGrey =
+			_mm_and_si128(_mm_cmpeq_epi32(r, g), _mm_cmpeq_epi32(g, b));
+		__m128i white = _mm_and_si128(p, alphaMask);
+		white = _mm_or_si128(white, SSE2_SHL(r, l.RShift));
+		white = _mm_or_si128(white, SSE2_SHL(r, l.GShift));
+		white = _mm_or_si128(white, SSE2_SHL(r, l.BShift));
+		__m128i out = SSE2_SELECT(isGrey, PixelMultSSE2(p, m), p);
+		out = SSE2_SELECT(isAlt, PixelMultSSE2(white, mAlt), out);
+		_mm_storeu_si128((__m128i *)(dst + i), out);
+	}
+	MaskStyleScalar(dst + i, src + i, n - i, l, mask, maskAlt, noAltMask);
+}
+
+static void FillSSE2(uint32_t *dst, const size_t n, const uint32_t pixel)
+{
+	const __m128i p = _mm_set1_epi32((int)pixel);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		_mm_storeu_si128((__m128i *)(dst + i), p);
+	}
+	FillScalar(dst + i, n - i, pixel);
+}
+
+#endif
+
+
+#ifdef PIXEL_OPS_HAS_NEON
+
+#define NEON_CH(_p, _shift) \
+	vandq_u32( \
+		vshlq_u32((_p), vdupq_n_s32(-(int32_t)(_shift))), vdupq_n_u32(0xff))
+#define NEON_SHL(_p, _shift) vshlq_u32((_p), vdupq_n_s32((int32_t)(_shift)))
+
+static uint8x8_t Div255NEON(const uint16x8_t x)
+{
+	return vshrn_n_u16(
+		vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+static uint32x4_t PixelMultNEON(const uint32x4_t p, const uint32x4_t m)
+{
+	const uint8x16_t p8 = vreinterpretq_u8_u32(p);
+	const uint8x16_t m8 = vreinterpretq_u8_u32(m);
+	const uint8x8_t lo =
+		Div255NEON(vmull_u8(vget_low_u8(p8), vget_low_u8(m8)));
+	const uint8x8_t hi =
+		Div255NEON(vmull_u8(vget_high_u8(p8), vget_high_u8(m8)));
+	return vreinterpretq_u32_u8(vcombine_u8(lo, hi));
+}
+
+static void ConvertNEON(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout from,
+	const PixelLayout to)
+{
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t p = vld1q_u32(src + i);
+		const uint32x4_t a = NEON_CH(p, from.AShift);
+		uint32x4_t out = NEON_SHL(NEON_CH(p, from.RShift), to.RShift);
+		out = vorrq_u32(out, NEON_SHL(NEON_CH(p, from.GShift), to.GShift));
+		out = vorrq_u32(out, NEON_SHL(NEON_CH(p, from.BShift), to.BShift));
+		out = vorrq_u32(out, NEON_SHL(a, to.AShift));
+		out = vbicq_u32(out, vceqq_u32(a, vdupq_n_u32(0)));
+		vst1q_u32(dst + i, out);
+	}
+	ConvertScalar(dst + i, src + i, n - i, from, to);
+}
+
+static void MaskCharColorsNEON(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const CharColors *colors)
+{
+	uint32_t masks[CHAR_MASK_COUNT];
+	GetCharMasks(masks, l, colors);
+	uint32x4_t maskVs[CHAR_MASK_COUNT];
+	for (int j = 0; j < CHAR_MASK_COUNT; j++)
+	{
+		maskVs[j] = vdupq_n_u32(masks[j]);
+	}
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t p = vld1q_u32(src + i);
+		const uint32x4_t a = NEON_CH(p, l.AShift);
+		uint32x4_t m = maskVs[0];
+		for (int j = 1; j < CHAR_MASK_COUNT; j++)
+		{
+			const uint32x4_t eq =
+				vceqq_u32(a, vdupq_n_u32((uint32_t)(255 - j)));
+			m = vbslq_u32(eq, maskVs[j], m);
+		}
+		vst1q_u32(dst + i, PixelMultNEON(p, m));
+	}
+	MaskCharColorsScalar(dst + i, src + i, n - i, l, colors);
+}
+
+static void MaskStyleNEON(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const color_t mask, const color_t maskAlt, const bool noAltMask)
+{
+	const uint32x4_t m = vdupq_n_u32(ColorToLayout(mask, l));
+	const uint32x4_t mAlt = vdupq_n_u32(ColorToLayout(maskAlt, l));
+	const uint32x4_t alphaMask = vdupq_n_u32(0xffu << l.AShift);
+	const uint32x4_t two = vdupq_n_u32(2);
+	const uint32x4_t allowAlt = vdupq_n_u32(noAltMask ? 0 : 0xffffffffu);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const uint32x4_t p = vld1q_u32(src + i);
+		const uint32x4_t r = NEON_CH(p, l.RShift);
+		const uint32x4_t g = NEON_CH(p, l.GShift);
+		const uint32x4_t b = NEON_CH(p, l.BShift);
+		const uint32x4_t isAlt = vandq_u32(
+			allowAlt, vandq_u32(vcleq_u32(g, two), vcleq_u32(b, two)));
+		const uint32x4_t isGrey =
+			vandq_u32(vceqq_u32(r, g), vceqq_u32(g, b));
+		uint32x4_t white = vandq_u32(p, alphaMask);
+		white = vorrq_u32(white, NEON_SHL(r, l.RShift));
+		white = vorrq_u32(white, NEON_SHL(r, l.GShift));
+		white = vorrq_u32(white, NEON_SHL(r, l.BShift));
+		uint32x4_t out = vbslq_u32(isGrey, PixelMultNEON(p, m), p);
+		out = vbslq_u32(isAlt, PixelMultNEON(white, mAlt), out);
+		vst1q_u32(dst + i, out);
+	}
+	MaskStyleScalar(dst + i, src + i, n - i, l, mask, maskAlt, noAltMask);
+}
+
+static void FillNEON(uint32_t *dst, const size_t n, const uint32_t pixel)
+{
+	const uint32x4_t p = vdupq_n_u32(pixel);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		vst1q_u32(dst + i, p);
+	}
+	FillScalar(dst + i, n - i, pixel);
+}
+
+#endif
+
+
+static const PixelOps sPixelOps[PIXEL_OPS_COUNT] = {
+	{ConvertScalar, MaskCharColorsScalar, MaskStyleScalar, FillScalar},
+#ifdef PIXEL_OPS_HAS_SSE2
+	{ConvertSSE2, MaskCharColorsSSE2, MaskStyleSSE2, FillSSE2},
+#else
+	{NULL, NULL, NULL, NULL},
+#endif
+#ifdef PIXEL_OPS_HAS_NEON
+	{ConvertNEON, MaskCharColorsNEON, MaskStyleNEON, FillNEON},
+#else
+	{NULL, NULL, NULL, NULL},
+#endif
+};
+static PixelOpsImpl sImpl = PIXEL_OPS_COUNT;
+
+const char *PixelOpsImplStr(const PixelOpsImpl impl)
+{
+	switch (impl)
+	{
+		T2S(PIXEL_OPS_SCALAR, "scalar");
+		T2S(PIXEL_OPS_SSE2, "SSE2");
+		T2S(PIXEL_OPS_NEON, "NEON");
+	default:
+		return "";
+	}
+}
+
+bool PixelOpsIsSupported(const PixelOpsImpl impl)
+{
+	switch (impl)
+	{
+	case PIXEL_OPS_SCALAR:
+		return true;
+	case PIXEL_OPS_SSE2:
+#ifdef PIXEL_OPS_HAS_SSE2
+		return SDL_HasSSE2();
+#else
+		return false;
+#endif
+	case PIXEL_OPS_NEON:
+#ifdef PIXEL_OPS_HAS_NEON
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return false;
+	}
+}
+
+PixelOpsImpl PixelOpsGetImpl(void)
+{
+	if (sImpl == PIXEL_OPS_COUNT)
+	{
+		sImpl = PIXEL_OPS_SCALAR;
+		for (PixelOpsImpl i = PIXEL_OPS_COUNT - 1; i > PIXEL_OPS_SCALAR; i--)
+		{
+			if (PixelOpsIsSupported(i))
+			{
+				sImpl = i;
+				break;
+			}
+		}
+		LOG(LM_GFX, LL_DEBUG, "using %s pixel ops", PixelOpsImplStr(sImpl));
+	}
+	return sImpl;
+}
+bool PixelOpsSetImpl(const PixelOpsImpl impl)
+{
+	if (!PixelOpsIsSupported(impl))
+	{
+		return false;
+	}
+	sImpl = impl;
+	return true;
+}
+
+bool PixelLayoutTryFromFormat(PixelLayout *l, const SDL_PixelFormat *f)
+{
+	if (f == NULL || f->BytesPerPixel != 4 || f->Amask == 0)
+	{
+		return false;
+	}
+	// Each channel must be a whole byte
+	const Uint32 masks[] = {f->Rmask, f->Gmask, f->Bmask, f->Amask};
+	const Uint8 shifts[] = {f->Rshift, f->Gshift, f->Bshift, f->Ashift};
+	for (int i = 0; i < 4; i++)
+	{
+		if (shifts[i] % 8 != 0 || masks[i] != (Uint32)0xff << shifts[i])
+		{
+			return false;
+		}
+	}
+	l->RShift = f->Rshift;
+	l->GShift = f->Gshift;
+	l->BShift = f->Bshift;
+	l->AShift = f->Ashift;
+	return true;
+}
+
+void PixelsConvert(
+	uint32_t *dst, const uint32_t *src, const size_t n,
+	const PixelLayout from, const PixelLayout to)
+{
+	sPixelOps[PixelOpsGetImpl()].Convert(dst, src, n, from, to);
+}
+void PixelsMaskCharColors(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const CharColors *colors)
+{
+	sPixelOps[PixelOpsGetImpl()].MaskCharColors(dst, src, n, l, colors);
+}
+void PixelsMaskStyle(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const color_t mask, const color_t maskAlt, const bool noAltMask)
+{
+	sPixelOps[PixelOpsGetImpl()].MaskStyle(
+		dst, src, n, l, mask, maskAlt, noAltMask);
+}
+void PixelsFill(uint32_t *dst, const size_t n, const uint32_t pixel)
+{
+	sPixelOps[PixelOpsGetImpl()].Fill(dst, n, pixel);
+}
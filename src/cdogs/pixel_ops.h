@@ -0,0 +1,80 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <SDL_pixels.h>
+
+#include "blit.h"
+
+// Bulk pixel operations, with SIMD implementations where available.
+// Pixels are 32-bit with 8-bit channels, in the layout given by the shifts.
+
+typedef struct
+{
+	uint8_t RShift;
+	uint8_t GShift;
+	uint8_t BShift;
+	uint8_t AShift;
+} PixelLayout;
+
+typedef enum
+{
+	PIXEL_OPS_SCALAR,
+	PIXEL_OPS_SSE2,
+	PIXEL_OPS_NEON,
+	PIXEL_OPS_COUNT
+} PixelOpsImpl;
+
+const char *PixelOpsImplStr(const PixelOpsImpl impl);
+bool PixelOpsIsSupported(const PixelOpsImpl impl);
+// Defaults to the best supported implementation
+PixelOpsImpl PixelOpsGetImpl(void);
+bool PixelOpsSetImpl(const PixelOpsImpl impl);
+
+// Returns false if the format isn't 32-bit with 8-bit channels and alpha
+bool PixelLayoutTryFromFormat(PixelLayout *l, const SDL_PixelFormat *f);
+
+// Convert between layouts; fully transparent pixels become 0
+void PixelsConvert(
+	uint32_t *dst, const uint32_t *src, const size_t n,
+	const PixelLayout from, const PixelLayout to);
+// Multiply each pixel by the char color selected by its alpha,
+// see CharColorsGetChannelMask
+void PixelsMaskCharColors(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const CharColors *colors);
+// Multiply greyscale pixels by mask, and red pixels (G and B near zero)
+// by maskAlt after restoring them to greyscale
+void PixelsMaskStyle(
+	uint32_t *dst, const uint32_t *src, const size_t n, const PixelLayout l,
+	const color_t mask, const color_t maskAlt, const bool noAltMask);
+void PixelsFill(uint32_t *dst, const size_t n, const uint32_t pixel);
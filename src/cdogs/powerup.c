@@ -30,6 +30,7 @@
 
 #include "ai_utils.h"
 #include "ammo.h"
+#include "collision/collision.h"
 #include "game_events.h"
 #include "gamedata.h"
 #include "net_util.h"
@@ -90,33 +91,49 @@ void PowerupSpawnerUpdate(PowerupSpawner *p, const int ticks)
 		}
 	}
 }
+typedef struct
+{
+	PowerupSpawner *p;
+	bool outOfSight;
+} TryPlacePickupData;
+static bool TryPlacePickupAt(
+	const Map *map, const struct vec2 pos, void *data);
 static bool TryPlacePickup(PowerupSpawner *p)
 {
-	const struct vec2i size = svec2i(HEALTH_W, HEALTH_H);
+	TryPlacePickupData data;
+	data.p = p;
 	// Attempt to place one in out-of-sight area
-	for (int i = 0; i < 100; i++)
+	data.outOfSight = true;
+	if (MapPlaceRandomPos(
+			p->map, PLACEMENT_ACCESS_ANY, TryPlacePickupAt, &data))
 	{
-		const struct vec2 v = MapGenerateFreePosition(p->map, size);
-		const TActor *closestPlayer = AIGetClosestPlayer(v);
-		if (!svec2_is_zero(v) &&
-			(!closestPlayer ||
-			 svec2_distance_squared(v, closestPlayer->Pos) >= SQUARED(150)))
-		{
-			p->PlaceFunc(v, p->Data);
-			return true;
-		}
+		return true;
 	}
 	// Attempt to place one anyway
-	for (int i = 0; i < 100; i++)
+	data.outOfSight = false;
+	return MapPlaceRandomPos(
+		p->map, PLACEMENT_ACCESS_ANY, TryPlacePickupAt, &data);
+}
+static bool TryPlacePickupAt(
+	const Map *map, const struct vec2 pos, void *data)
+{
+	UNUSED(map);
+	const TryPlacePickupData *pData = data;
+	if (IsCollisionWithWall(pos, svec2i(HEALTH_W, HEALTH_H)))
+	{
+		return false;
+	}
+	if (pData->outOfSight)
 	{
-		const struct vec2 v = MapGenerateFreePosition(p->map, size);
-		if (!svec2_is_zero(v))
+		const TActor *closestPlayer = AIGetClosestPlayer(pos);
+		if (closestPlayer != NULL &&
+			svec2_distance_squared(pos, closestPlayer->Pos) < SQUARED(150))
 		{
-			p->PlaceFunc(v, p->Data);
-			return true;
+			return false;
 		}
 	}
-	return false;
+	pData->p->PlaceFunc(pos, pData->p->Data);
+	return true;
 }
 
 void PowerupSpawnerRemoveOne(PowerupSpawner *p)
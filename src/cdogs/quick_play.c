@@ -76,7 +76,7 @@ static struct vec2i GenerateRandomPairPartitionWithRestrictions(
 	// Must be at most max, or total - min
 	xLow = MAX(min, total - max);
 	xHigh = MIN(max, total - min);
-	v.x = xLow + (rand() % (xHigh - xLow + 1));
+	v.x = RAND_INT(RNG_MAPGEN, xLow, xHigh + 1);
 	v.y = total - v.x;
 	assert(v.x >= min);
 	assert(v.y >= min);
@@ -98,16 +98,16 @@ static struct vec2i GenerateQuickPlayMapSize(QuickPlayQuantity size)
 	{
 	case QUICKPLAY_QUANTITY_ANY:
 		return GenerateRandomPairPartitionWithRestrictions(
-			RAND_INT(32, 128 + 1), minMapDim, maxMapDim);
+			RAND_INT(RNG_MAPGEN, 32, 128 + 1), minMapDim, maxMapDim);
 	case QUICKPLAY_QUANTITY_SMALL:
 		return GenerateRandomPairPartitionWithRestrictions(
-			RAND_INT(32, 64 + 1), minMapDim, maxMapDim);
+			RAND_INT(RNG_MAPGEN, 32, 64 + 1), minMapDim, maxMapDim);
 	case QUICKPLAY_QUANTITY_MEDIUM:
 		return GenerateRandomPairPartitionWithRestrictions(
-			RAND_INT(64, 96 + 1), minMapDim, maxMapDim);
+			RAND_INT(RNG_MAPGEN, 64, 96 + 1), minMapDim, maxMapDim);
 	case QUICKPLAY_QUANTITY_LARGE:
 		return GenerateRandomPairPartitionWithRestrictions(
-			RAND_INT(96, 128 + 1), minMapDim, maxMapDim);
+			RAND_INT(RNG_MAPGEN, 96, 128 + 1), minMapDim, maxMapDim);
 	default:
 		assert(0 && "invalid quick play map size config");
 		return svec2i_zero();
@@ -123,13 +123,13 @@ static int GenerateQuickPlayParam(
 	switch (qty)
 	{
 	case QUICKPLAY_QUANTITY_ANY:
-		return RAND_INT(low, max + 1);
+		return RAND_INT(RNG_MAPGEN, low, max + 1);
 	case QUICKPLAY_QUANTITY_SMALL:
-		return RAND_INT(low, medium + 1);
+		return RAND_INT(RNG_MAPGEN, low, medium + 1);
 	case QUICKPLAY_QUANTITY_MEDIUM:
-		return RAND_INT(medium, high + 1);
+		return RAND_INT(RNG_MAPGEN, medium, high + 1);
 	case QUICKPLAY_QUANTITY_LARGE:
-		return RAND_INT(high, max + 1);
+		return RAND_INT(RNG_MAPGEN, high, max + 1);
 	default:
 		CASSERT(false, "unknown quick play quantity");
 		return 0;
@@ -142,13 +142,13 @@ static float GenerateQuickPlayParamFloat(
 	switch (qty)
 	{
 	case QUICKPLAY_QUANTITY_ANY:
-		return RAND_FLOAT(low, max);
+		return RAND_FLOAT(RNG_MAPGEN, low, max);
 	case QUICKPLAY_QUANTITY_SMALL:
-		return RAND_FLOAT(low, medium);
+		return RAND_FLOAT(RNG_MAPGEN, low, medium);
 	case QUICKPLAY_QUANTITY_MEDIUM:
-		return RAND_FLOAT(medium, high);
+		return RAND_FLOAT(RNG_MAPGEN, medium, high);
 	case QUICKPLAY_QUANTITY_LARGE:
-		return RAND_FLOAT(high, max);
+		return RAND_FLOAT(RNG_MAPGEN, high, max);
 	default:
 		CASSERT(false, "unknown quick play quantity");
 		return 0;
@@ -167,33 +167,33 @@ static void SetupQuickPlayEnemy(Character *enemy, const WeaponClass *wc, const b
 	}
 	if (WeaponClassIsShortRange(enemy->Gun))
 	{
-		enemy->bot->probabilityToMove = 35 + (rand() % 35);
+		enemy->bot->probabilityToMove = RAND_INT(RNG_MAPGEN, 35, 70);
 	}
 	else
 	{
-		enemy->bot->probabilityToMove = 30 + (rand() % 30);
+		enemy->bot->probabilityToMove = RAND_INT(RNG_MAPGEN, 30, 60);
 	}
-	enemy->bot->probabilityToTrack = 10 + (rand() % 60);
+	enemy->bot->probabilityToTrack = RAND_INT(RNG_MAPGEN, 10, 70);
 	if (!WeaponClassCanShoot(enemy->Gun))
 	{
 		enemy->bot->probabilityToShoot = 0;
 	}
 	else if (WeaponClassIsHighDPS(enemy->Gun))
 	{
-		enemy->bot->probabilityToShoot = 1 + (rand() % 3);
+		enemy->bot->probabilityToShoot = RAND_INT(RNG_MAPGEN, 1, 4);
 	}
 	else
 	{
-		enemy->bot->probabilityToShoot = 1 + (rand() % 6);
+		enemy->bot->probabilityToShoot = RAND_INT(RNG_MAPGEN, 1, 7);
 	}
-	enemy->bot->actionDelay = rand() % (50 + 1);
+	enemy->bot->actionDelay = RAND_INT(RNG_MAPGEN, 0, 50 + 1);
 	enemy->maxHealth = GenerateQuickPlayParam(
 		ConfigGetEnum(&gConfig, "QuickPlay.EnemyHealth"), 10, 20, 40, 60);
 	enemy->flags = 0;
 	if (isBg)
 	{
 		enemy->flags |= FLAGS_AWAKEALWAYS;
-		if (RAND_BOOL())
+		if (RAND_BOOL(RNG_MAPGEN))
 		{
 			enemy->flags |= FLAGS_GOOD_GUY;
 		}
@@ -210,7 +210,7 @@ static void SetupQuickPlayEnemies(const int numEnemies, CharacterStore *store, c
 		{
 			wc = CArrayGet(
 				&gWeaponClasses.Guns,
-				rand() % (int)gWeaponClasses.Guns.size);
+				RAND_INT(RNG_MAPGEN, 0, (int)gWeaponClasses.Guns.size));
 			if (!wc->IsRealGun)
 			{
 				continue;
@@ -285,7 +285,7 @@ static void AddMission(
 	m.Size = GenerateQuickPlayMapSize(missionSizes[idx]);
 	do
 	{
-		m.Type = (MapType)(rand() % MAPTYPE_COUNT);
+		m.Type = (MapType)RAND_INT(RNG_MAPGEN, 0, MAPTYPE_COUNT);
 	}
 	// Can't randomly generate static maps
 	while (m.Type == MAPTYPE_STATIC);
@@ -297,44 +297,46 @@ static void AddMission(
 			ConfigGetEnum(&gConfig, "QuickPlay.WallCount"), 0, 5, 15, 30);
 		m.u.Classic.WallLength = GenerateQuickPlayParam(
 			ConfigGetEnum(&gConfig, "QuickPlay.WallLength"), 1, 3, 6, 12);
-		m.u.Classic.CorridorWidth = rand() % 3 + 1;
+		m.u.Classic.CorridorWidth = RAND_INT(RNG_MAPGEN, 1, 4);
 		m.u.Classic.Rooms = RandomRoomParams();
 		m.u.Classic.Squares = GenerateQuickPlayParam(
 			ConfigGetEnum(&gConfig, "QuickPlay.SquareCount"), 0, 1, 3, 6);
-		m.u.Classic.ExitEnabled = RAND_BOOL();
-		m.u.Classic.Doors.Enabled = RAND_BOOL();
+		m.u.Classic.ExitEnabled = RAND_BOOL(RNG_MAPGEN);
+		m.u.Classic.Doors.Enabled = RAND_BOOL(RNG_MAPGEN);
 		m.u.Classic.Doors.Min = 1;
 		m.u.Classic.Doors.Max = 6;
-		m.u.Classic.Pillars.Count = rand() % 5;
-		m.u.Classic.Pillars.Min = rand() % 3 + 1;
-		m.u.Classic.Pillars.Max = rand() % 3 + m.u.Classic.Pillars.Min;
+		m.u.Classic.Pillars.Count = RAND_INT(RNG_MAPGEN, 0, 5);
+		m.u.Classic.Pillars.Min = RAND_INT(RNG_MAPGEN, 1, 4);
+		m.u.Classic.Pillars.Max =
+			RAND_INT(RNG_MAPGEN, 0, 3) + m.u.Classic.Pillars.Min;
 		break;
 	case MAPTYPE_CAVE:
 		// TODO: quickplay configs for cave type
 		RandomMissionTileClasses(&m.u.Cave.TileClasses, pm);
-		m.u.Cave.FillPercent = rand() % 40 + 10;
-		m.u.Cave.Repeat = rand() % 6;
-		m.u.Cave.R1 = rand() % 2 + 4;
-		m.u.Cave.R2 = rand() % 5 - 1;
-		m.u.Cave.CorridorWidth = rand() % 3 + 1;
+		m.u.Cave.FillPercent = RAND_INT(RNG_MAPGEN, 10, 50);
+		m.u.Cave.Repeat = RAND_INT(RNG_MAPGEN, 0, 6);
+		m.u.Cave.R1 = RAND_INT(RNG_MAPGEN, 4, 6);
+		m.u.Cave.R2 = RAND_INT(RNG_MAPGEN, -1, 4);
+		m.u.Cave.CorridorWidth = RAND_INT(RNG_MAPGEN, 1, 4);
 		m.u.Cave.Rooms = RandomRoomParams();
 		m.u.Cave.Squares = GenerateQuickPlayParam(
 			ConfigGetEnum(&gConfig, "QuickPlay.SquareCount"), 0, 1, 3, 6);
-		m.u.Cave.ExitEnabled = RAND_BOOL();
-		m.u.Cave.DoorsEnabled = RAND_BOOL();
+		m.u.Cave.ExitEnabled = RAND_BOOL(RNG_MAPGEN);
+		m.u.Cave.DoorsEnabled = RAND_BOOL(RNG_MAPGEN);
 		break;
 	case MAPTYPE_INTERIOR:
 		// TODO: quickplay configs for interior type
 		RandomMissionTileClasses(&m.u.Interior.TileClasses, pm);
-		m.u.Interior.CorridorWidth = rand() % 3 + 1;
+		m.u.Interior.CorridorWidth = RAND_INT(RNG_MAPGEN, 1, 4);
 		m.u.Interior.Rooms = RandomRoomParams();
-		m.u.Interior.ExitEnabled = RAND_BOOL();
-		m.u.Interior.Doors.Enabled = RAND_BOOL();
+		m.u.Interior.ExitEnabled = RAND_BOOL(RNG_MAPGEN);
+		m.u.Interior.Doors.Enabled = RAND_BOOL(RNG_MAPGEN);
 		m.u.Interior.Doors.Min = 1;
 		m.u.Interior.Doors.Max = 6;
-		m.u.Interior.Pillars.Count = rand() % 5;
-		m.u.Interior.Pillars.Min = rand() % 3 + 1;
-		m.u.Interior.Pillars.Max = rand() % 3 + m.u.Interior.Pillars.Min;
+		m.u.Interior.Pillars.Count = RAND_INT(RNG_MAPGEN, 0, 5);
+		m.u.Interior.Pillars.Min = RAND_INT(RNG_MAPGEN, 1, 4);
+		m.u.Interior.Pillars.Max =
+			RAND_INT(RNG_MAPGEN, 0, 3) + m.u.Interior.Pillars.Min;
 		break;
 	default:
 		CASSERT(false, "unknown map type");
@@ -356,8 +358,8 @@ static void AddMission(
 		CSTRDUP(o.Description, "Kill the enemies");
 		o.Type = OBJECTIVE_KILL;
 		o.u.Index = 0;
-		o.Count = RAND_INT(missionKillCountMin[idx], missionKillCountMin[idx] * 3 / 2);
-		o.Required = RAND_INT(MAX(1, o.Count / 2), o.Count);
+		o.Count = RAND_INT(RNG_MAPGEN, missionKillCountMin[idx], missionKillCountMin[idx] * 3 / 2);
+		o.Required = RAND_INT(RNG_MAPGEN, MAX(1, o.Count / 2), o.Count);
 		o.Flags = OBJECTIVE_POSKNOWN;
 		CArrayPushBack(&m.Objectives, &o);
 	}
@@ -367,7 +369,8 @@ static void AddMission(
 	for (int i = 0; i < c; i++)
 	{
 		MapObjectDensity mop;
-		mop.M = IndexMapObject(rand() % MapObjectsCount(&gMapObjects));
+		mop.M = IndexMapObject(
+			RAND_INT(RNG_MAPGEN, 0, MapObjectsCount(&gMapObjects)));
 		if (mop.M->Type == MAP_OBJECT_TYPE_PICKUP_SPAWNER)
 		{
 			mop.Density = 1;
@@ -419,26 +422,26 @@ static RoomParams RandomRoomParams(void)
 	RoomParams r;
 	r.Count = GenerateQuickPlayParam(
 		ConfigGetEnum(&gConfig, "QuickPlay.RoomCount"), 0, 2, 5, 12);
-	r.Min = rand() % 10 + 5;
-	r.Max = rand() % 10 + r.Min;
+	r.Min = RAND_INT(RNG_MAPGEN, 5, 15);
+	r.Max = RAND_INT(RNG_MAPGEN, 0, 10) + r.Min;
 	r.Edge = 1;
 	r.Overlap = 1;
-	r.Walls = rand() % 5;
-	r.WallLength = rand() % 6 + 1;
-	r.WallPad = rand() % 4 + 1;
+	r.Walls = RAND_INT(RNG_MAPGEN, 0, 5);
+	r.WallLength = RAND_INT(RNG_MAPGEN, 1, 7);
+	r.WallPad = RAND_INT(RNG_MAPGEN, 1, 5);
 	return r;
 }
 static void RandomStyle(char *style, const CArray *styleNames)
 {
-	const int idx = rand() % styleNames->size;
+	const int idx = RAND_INT(RNG_MAPGEN, 0, (int)styleNames->size);
 	strcpy(style, *(char **)CArrayGet(styleNames, idx));
 }
 static color_t RandomBGColor(void)
 {
 	color_t c;
-	c.r = rand() % 128;
-	c.g = rand() % 128; 
-	c.b = rand() % 128;
+	c.r = RAND_INT(RNG_MAPGEN, 0, 128);
+	c.g = RAND_INT(RNG_MAPGEN, 0, 128);
+	c.b = RAND_INT(RNG_MAPGEN, 0, 128);
 	c.a = 255;
 	return c;
 }
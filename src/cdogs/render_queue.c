@@ -0,0 +1,219 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "render_queue.h"
+
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+
+RenderQueue gRenderQueue;
+
+
+void RenderQueueInit(RenderQueue *q)
+{
+	memset(q, 0, sizeof *q);
+	CArrayInit(&q->Cmds, sizeof(RenderCmd));
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	CArrayInit(&q->Vertices, sizeof(SDL_Vertex));
+	CArrayInit(&q->Indices, sizeof(int));
+#endif
+}
+void RenderQueueTerminate(RenderQueue *q)
+{
+	CArrayTerminate(&q->Cmds);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	CArrayTerminate(&q->Vertices);
+	CArrayTerminate(&q->Indices);
+#endif
+	memset(q, 0, sizeof *q);
+}
+
+static void RenderQueueClear(RenderQueue *q)
+{
+	CArrayClear(&q->Cmds);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	CArrayClear(&q->Vertices);
+	CArrayClear(&q->Indices);
+#endif
+}
+void RenderQueueBegin(RenderQueue *q)
+{
+	RenderQueueClear(q);
+	q->Clip = Rect2iZero();
+	q->Recording = true;
+}
+void RenderQueueEnd(RenderQueue *q)
+{
+	q->Recording = false;
+}
+
+static void SubmitShape(const RenderCmd *cmd);
+void RenderQueueSubmit(RenderQueue *q)
+{
+	CASSERT(!q->Recording, "cannot submit while recording");
+	CA_FOREACH(const RenderCmd, cmd, q->Cmds)
+	switch (cmd->Type)
+	{
+	case RENDER_CMD_COPY:
+		TextureRender(
+			cmd->u.Copy.Tex, cmd->Renderer, cmd->u.Copy.Src, cmd->u.Copy.Dest,
+			cmd->u.Copy.Mask, cmd->u.Copy.Angle, cmd->u.Copy.Flip);
+		break;
+	case RENDER_CMD_POINT:
+	case RENDER_CMD_RECT:
+	case RENDER_CMD_FILL_RECT:
+	case RENDER_CMD_LINE:
+		SubmitShape(cmd);
+		break;
+	case RENDER_CMD_GEOMETRY:
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+		if (SDL_RenderGeometry(
+				cmd->Renderer, cmd->u.Geometry.Tex,
+				CArrayGet(&q->Vertices, cmd->u.Geometry.VertexStart),
+				cmd->u.Geometry.NumVertices,
+				CArrayGet(&q->Indices, cmd->u.Geometry.IndexStart),
+				cmd->u.Geometry.NumIndices) != 0)
+		{
+			LOG(LM_GFX, LL_ERROR, "Failed to render geometry: %s",
+				SDL_GetError());
+		}
+#endif
+		break;
+	case RENDER_CMD_CLIP:
+		GraphicsSetClip(cmd->Renderer, cmd->u.Clip);
+		break;
+	default:
+		CASSERT(false, "unknown render command");
+		break;
+	}
+	CA_FOREACH_END()
+	RenderQueueClear(q);
+}
+static void SubmitShape(const RenderCmd *cmd)
+{
+	SDL_Renderer *r = cmd->Renderer;
+	const color_t c = cmd->u.Shape.Color;
+	if (SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to set draw blend mode: %s",
+			SDL_GetError());
+	}
+	if (SDL_SetRenderDrawColor(r, c.r, c.g, c.b, c.a) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to set draw color: %s", SDL_GetError());
+	}
+	const struct vec2i a = cmd->u.Shape.A;
+	const struct vec2i b = cmd->u.Shape.B;
+	const SDL_Rect rect = {a.x, a.y, b.x, b.y};
+	int result = 0;
+	switch (cmd->Type)
+	{
+	case RENDER_CMD_POINT:
+		result = SDL_RenderDrawPoint(r, a.x, a.y);
+		break;
+	case RENDER_CMD_RECT:
+		result = SDL_RenderDrawRect(r, &rect);
+		break;
+	case RENDER_CMD_FILL_RECT:
+		result = SDL_RenderFillRect(r, &rect);
+		break;
+	case RENDER_CMD_LINE:
+		result = SDL_RenderDrawLine(r, a.x, a.y, b.x, b.y);
+		break;
+	default:
+		CASSERT(false, "not a shape render command");
+		break;
+	}
+	if (result != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "Failed to render shape: %s", SDL_GetError());
+	}
+}
+
+void RenderQueuePushCopy(
+	RenderQueue *q, SDL_Texture *t, SDL_Renderer *r, const Rect2i src,
+	const Rect2i dest, const color_t mask, const double angle,
+	const SDL_RendererFlip flip)
+{
+	RenderCmd cmd;
+	cmd.Type = RENDER_CMD_COPY;
+	cmd.Renderer = r;
+	cmd.u.Copy.Tex = t;
+	cmd.u.Copy.Src = src;
+	cmd.u.Copy.Dest = dest;
+	cmd.u.Copy.Mask = mask;
+	cmd.u.Copy.Angle = angle;
+	cmd.u.Copy.Flip = flip;
+	CArrayPushBack(&q->Cmds, &cmd);
+}
+void RenderQueuePushShape(
+	RenderQueue *q, const RenderCmdType type, SDL_Renderer *r,
+	const struct vec2i a, const struct vec2i b, const color_t c)
+{
+	RenderCmd cmd;
+	cmd.Type = type;
+	cmd.Renderer = r;
+	cmd.u.Shape.A = a;
+	cmd.u.Shape.B = b;
+	cmd.u.Shape.Color = c;
+	CArrayPushBack(&q->Cmds, &cmd);
+}
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void RenderQueuePushGeometry(
+	RenderQueue *q, SDL_Renderer *r, SDL_Texture *t, const SDL_Vertex *v,
+	const int numVertices, const int *indices, const int numIndices)
+{
+	RenderCmd cmd;
+	cmd.Type = RENDER_CMD_GEOMETRY;
+	cmd.Renderer = r;
+	cmd.u.Geometry.Tex = t;
+	cmd.u.Geometry.VertexStart = (int)q->Vertices.size;
+	cmd.u.Geometry.NumVertices = numVertices;
+	cmd.u.Geometry.IndexStart = (int)q->Indices.size;
+	cmd.u.Geometry.NumIndices = numIndices;
+	// Indices stay relative to this command's first vertex
+	for (int i = 0; i < numVertices; i++)
+	{
+		CArrayPushBack(&q->Vertices, &v[i]);
+	}
+	for (int i = 0; i < numIndices; i++)
+	{
+		CArrayPushBack(&q->Indices, &indices[i]);
+	}
+	CArrayPushBack(&q->Cmds, &cmd);
+}
+#endif
+void RenderQueuePushClip(RenderQueue *q, SDL_Renderer *r, const Rect2i clip)
+{
+	RenderCmd cmd;
+	cmd.Type = RENDER_CMD_CLIP;
+	cmd.Renderer = r;
+	cmd.u.Clip = clip;
+	CArrayPushBack(&q->Cmds, &cmd);
+	q->Clip = clip;
+}
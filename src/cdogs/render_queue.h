@@ -0,0 +1,128 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_render.h>
+#include <SDL_version.h>
+
+#include "c_array.h"
+#include "color.h"
+#include "vector.h"
+
+// Deferred renderer commands.
+// While recording, TextureRender, the draw tools, text and clip rects are
+// stored instead of being sent to the renderer. They are sent in order by
+// RenderQueueSubmit, which lets a frame be recorded up front and submitted
+// while the next game tick runs on another thread.
+// Recording reads the game state directly, so it must finish before the
+// next tick starts; the queue is not a snapshot of the game state.
+// Other SDL calls (e.g. texture uploads) still happen immediately.
+
+typedef enum
+{
+	RENDER_CMD_COPY,
+	RENDER_CMD_POINT,
+	RENDER_CMD_RECT,
+	RENDER_CMD_FILL_RECT,
+	RENDER_CMD_LINE,
+	RENDER_CMD_GEOMETRY,
+	RENDER_CMD_CLIP
+} RenderCmdType;
+
+typedef struct
+{
+	RenderCmdType Type;
+	SDL_Renderer *Renderer;
+	union
+	{
+		struct
+		{
+			SDL_Texture *Tex;
+			Rect2i Src;
+			Rect2i Dest;
+			color_t Mask;
+			double Angle;
+			SDL_RendererFlip Flip;
+		} Copy;
+		// Point: A; rect: A is pos, B is size; line: A to B
+		struct
+		{
+			struct vec2i A;
+			struct vec2i B;
+			color_t Color;
+		} Shape;
+		struct
+		{
+			SDL_Texture *Tex;
+			int VertexStart;
+			int NumVertices;
+			int IndexStart;
+			int NumIndices;
+		} Geometry;
+		Rect2i Clip;
+	} u;
+} RenderCmd;
+
+typedef struct
+{
+	bool Recording;
+	CArray Cmds;	// of RenderCmd
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	CArray Vertices;	// of SDL_Vertex
+	CArray Indices;		// of int
+#endif
+	// Last clip rect recorded, so it can be read back while recording
+	Rect2i Clip;
+} RenderQueue;
+
+extern RenderQueue gRenderQueue;
+
+void RenderQueueInit(RenderQueue *q);
+void RenderQueueTerminate(RenderQueue *q);
+
+// Start recording; discards anything not yet submitted
+void RenderQueueBegin(RenderQueue *q);
+void RenderQueueEnd(RenderQueue *q);
+// Send all recorded commands to their renderers, then clear them
+void RenderQueueSubmit(RenderQueue *q);
+
+void RenderQueuePushCopy(
+	RenderQueue *q, SDL_Texture *t, SDL_Renderer *r, const Rect2i src,
+	const Rect2i dest, const color_t mask, const double angle,
+	const SDL_RendererFlip flip);
+void RenderQueuePushShape(
+	RenderQueue *q, const RenderCmdType type, SDL_Renderer *r,
+	const struct vec2i a, const struct vec2i b, const color_t c);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void RenderQueuePushGeometry(
+	RenderQueue *q, SDL_Renderer *r, SDL_Texture *t, const SDL_Vertex *v,
+	const int numVertices, const int *indices, const int numIndices);
+#endif
+void RenderQueuePushClip(RenderQueue *q, SDL_Renderer *r, const Rect2i clip);
@@ -0,0 +1,193 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "residency.h"
+
+#include <stdlib.h>
+
+#include <SDL_timer.h>
+
+#include "log.h"
+#include "utils.h"
+
+int ResidencyAdd(Residency *r, void *asset)
+{
+	if (r->Assets.elemSize == 0)
+	{
+		CArrayInit(&r->Assets, sizeof(ResidentAsset));
+	}
+	ResidentAsset a;
+	memset(&a, 0, sizeof a);
+	a.Asset = asset;
+	CArrayPushBack(&r->Assets, &a);
+	return (int)r->Assets.size;
+}
+void ResidencyRemove(Residency *r, const int id, const void *asset)
+{
+	if (!ResidencyHas(r, id, asset))
+	{
+		return;
+	}
+	ResidentAsset *a = CArrayGet(&r->Assets, id - 1);
+	r->Bytes -= a->Bytes;
+	// Move the last asset into this slot to keep the ids dense
+	const int lastId = (int)r->Assets.size;
+	if (id != lastId)
+	{
+		*a = *(const ResidentAsset *)CArrayGet(&r->Assets, lastId - 1);
+		r->SetId(a->Asset, id);
+	}
+	CArrayPopBack(&r->Assets);
+}
+void ResidencyTerminate(Residency *r)
+{
+	CArrayTerminate(&r->Assets);
+	r->Bytes = 0;
+	memset(&r->Stats, 0, sizeof r->Stats);
+}
+bool ResidencyHas(const Residency *r, const int id, const void *asset)
+{
+	if (id <= 0 || id > (int)r->Assets.size)
+	{
+		return false;
+	}
+	const ResidentAsset *a = CArrayGet(&r->Assets, id - 1);
+	return a->Asset == asset;
+}
+
+static bool Load(Residency *r, ResidentAsset *a)
+{
+	if (a->Bytes > 0)
+	{
+		return false;
+	}
+	if (a->Failed)
+	{
+		return false;
+	}
+	a->Bytes = r->Load(a->Asset);
+	if (a->Bytes == 0)
+	{
+		a->Failed = true;
+		return false;
+	}
+	r->Bytes += a->Bytes;
+	r->Stats.Loads++;
+	return true;
+}
+void ResidencyUse(Residency *r, const int id)
+{
+	ResidentAsset *a = CArrayGet(&r->Assets, id - 1);
+	a->LastUsed = r->Frame;
+	if (a->Bytes > 0)
+	{
+		return;
+	}
+	const Uint64 start = SDL_GetPerformanceCounter();
+	if (Load(r, a))
+	{
+		r->Stats.Stalls++;
+		r->Stats.StallTicks += SDL_GetPerformanceCounter() - start;
+	}
+}
+void ResidencyPrefetch(Residency *r, const int id)
+{
+	ResidentAsset *a = CArrayGet(&r->Assets, id - 1);
+	a->LastUsed = r->Frame;
+	Load(r, a);
+}
+void ResidencyUnload(Residency *r, const int id)
+{
+	ResidentAsset *a = CArrayGet(&r->Assets, id - 1);
+	if (a->Bytes == 0)
+	{
+		return;
+	}
+	r->Unload(a->Asset);
+	r->Bytes -= a->Bytes;
+	a->Bytes = 0;
+}
+
+typedef struct
+{
+	Uint32 LastUsed;
+	int Id;
+} EvictCandidate;
+static int CompareLastUsed(const void *v1, const void *v2)
+{
+	const EvictCandidate *c1 = v1;
+	const EvictCandidate *c2 = v2;
+	// Compare relative to each other so that frame wraparound is harmless
+	const Sint32 d = (Sint32)(c1->LastUsed - c2->LastUsed);
+	return d < 0 ? -1 : d > 0 ? 1 : c1->Id - c2->Id;
+}
+void ResidencyEvict(Residency *r)
+{
+	if (r->Budget > 0 && r->Bytes > r->Budget)
+	{
+		CArray candidates;
+		CArrayInit(&candidates, sizeof(EvictCandidate));
+		CA_FOREACH(const ResidentAsset, a, r->Assets)
+		if (a->Bytes == 0 || (r->InUse && r->InUse(a->Asset)))
+		{
+			continue;
+		}
+		const EvictCandidate c = {a->LastUsed, _ca_index + 1};
+		CArrayPushBack(&candidates, &c);
+		CA_FOREACH_END()
+		qsort(
+			candidates.data, candidates.size, candidates.elemSize,
+			CompareLastUsed);
+		// Go a bit under budget so that we don't evict every frame
+		const size_t target = r->Budget - r->Budget / 8;
+		CA_FOREACH(const EvictCandidate, c, candidates)
+		if (r->Bytes <= target)
+		{
+			break;
+		}
+		ResidencyUnload(r, c->Id);
+		r->Stats.Evictions++;
+		CA_FOREACH_END()
+		CArrayTerminate(&candidates);
+	}
+	r->Frame++;
+}
+void ResidencyLogStats(const Residency *r)
+{
+	int resident = 0;
+	CA_FOREACH(const ResidentAsset, a, r->Assets)
+	resident += a->Bytes > 0;
+	CA_FOREACH_END()
+	const double mb = 1024.0 * 1024.0;
+	LOG(LM_MAIN, LL_INFO,
+		"%s: %d/%d resident, %.1f/%.1fMB; %d loads, %d evictions, %d "
+		"first-use stalls (%.1fms)",
+		r->Name, resident, (int)r->Assets.size, r->Bytes / mb,
+		r->Budget / mb, r->Stats.Loads, r->Stats.Evictions, r->Stats.Stalls,
+		(double)r->Stats.StallTicks * 1000.0 /
+			(double)SDL_GetPerformanceFrequency());
+}
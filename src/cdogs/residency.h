@@ -0,0 +1,88 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <SDL_stdinc.h>
+
+#include "c_array.h"
+
+// Tracks assets that are registered up front but only made resident on
+// first use, evicting the least recently used when over a memory budget.
+// Assets are identified by a 1-based id; 0 means not tracked.
+typedef struct
+{
+	void *Asset;
+	size_t Bytes; // 0 if not resident
+	Uint32 LastUsed;
+	bool Failed; // don't keep retrying loads that fail
+} ResidentAsset;
+typedef struct
+{
+	const char *Name;
+	// Make the asset resident, returning its size in bytes, or 0 on failure
+	size_t (*Load)(void *asset);
+	void (*Unload)(void *asset);
+	// Optional; assets that are in use are not evicted
+	bool (*InUse)(const void *asset);
+	// Called when an asset's id changes
+	void (*SetId)(void *asset, const int id);
+
+	CArray Assets; // of ResidentAsset
+	size_t Budget; // in bytes; 0 for no limit
+	size_t Bytes;
+	Uint32 Frame;
+	struct
+	{
+		int Loads;
+		int Evictions;
+		// Loads at the point of use, rather than prefetched
+		int Stalls;
+		Uint64 StallTicks;
+	} Stats;
+} Residency;
+
+int ResidencyAdd(Residency *r, void *asset);
+// Forget the asset; it must already have been unloaded or freed
+void ResidencyRemove(Residency *r, const int id, const void *asset);
+void ResidencyTerminate(Residency *r);
+// Whether the asset is the one tracked by this id; copies of assets share
+// ids with the original
+bool ResidencyHas(const Residency *r, const int id, const void *asset);
+
+// Mark the asset used, loading it if necessary
+void ResidencyUse(Residency *r, const int id);
+// Load ahead of time, e.g. during loading screens
+void ResidencyPrefetch(Residency *r, const int id);
+void ResidencyUnload(Residency *r, const int id);
+// Evict least recently used assets until under budget, and start a new
+// frame; call when no evicted asset can be referenced
+void ResidencyEvict(Residency *r);
+void ResidencyLogStats(const Residency *r);
@@ -0,0 +1,110 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "rng.h"
+
+#include "utils.h"
+
+// PCG32 (XSH RR), see https://www.pcg-random.org
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+typedef struct
+{
+	uint64_t State;
+	uint64_t Inc;
+	uint64_t Seed;
+} Rng;
+
+// Usable before seeding; increments must be odd
+static Rng sRngs[RNG_COUNT] = {{0, 1, 0}, {0, 3, 0}, {0, 5, 0}, {0, 7, 0}};
+
+const char *RngStreamStr(const RngStream s)
+{
+	switch (s)
+	{
+		T2S(RNG_MAPGEN, "mapgen");
+		T2S(RNG_GAMEPLAY, "gameplay");
+		T2S(RNG_AI, "ai");
+		T2S(RNG_COSMETIC, "cosmetic");
+	default:
+		return "";
+	}
+}
+
+void RngSeed(const RngStream s, const uint64_t seed)
+{
+	Rng *r = &sRngs[s];
+	r->Seed = seed;
+	// Each stream gets its own increment, so streams with the same seed
+	// still produce different sequences
+	r->State = 0;
+	r->Inc = ((uint64_t)s << 1) | 1;
+	RngNext(s);
+	r->State += seed;
+	RngNext(s);
+}
+
+void RngSeedAll(const uint64_t seed)
+{
+	for (int i = 0; i < (int)RNG_COUNT; i++)
+	{
+		RngSeed((RngStream)i, seed);
+	}
+}
+
+uint64_t RngGetSeed(const RngStream s)
+{
+	return sRngs[s].Seed;
+}
+
+uint32_t RngNext(const RngStream s)
+{
+	Rng *r = &sRngs[s];
+	const uint64_t old = r->State;
+	r->State = old * PCG_MULTIPLIER + r->Inc;
+	const uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+	const uint32_t rot = (uint32_t)(old >> 59);
+	return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+int RngInt(const RngStream s, const int low, const int high)
+{
+	if (high <= low)
+	{
+		return low;
+	}
+	// Multiply-shift instead of modulo; much cheaper and the bias is
+	// negligible for our ranges
+	const uint32_t range = (uint32_t)high - (uint32_t)low;
+	return (int)((uint32_t)low +
+				 (uint32_t)(((uint64_t)RngNext(s) * range) >> 32));
+}
+
+double RngDouble(const RngStream s)
+{
+	return RngNext(s) * (1.0 / 4294967296.0);
+}
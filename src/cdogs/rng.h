@@ -0,0 +1,56 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdint.h>
+
+// Independent random number streams, one per subsystem, so that e.g.
+// particles spawned while drawing don't change how the map is generated.
+// Each stream is a PCG32 generator; seeding all streams with the same seed
+// reproduces the same sequences.
+typedef enum
+{
+	RNG_MAPGEN,	  // map and quick play generation
+	RNG_GAMEPLAY, // simulation: bullets, pickups, spawns
+	RNG_AI,		  // AI decisions
+	RNG_COSMETIC, // particles, sounds, menus; never affects the simulation
+	RNG_COUNT
+} RngStream;
+
+const char *RngStreamStr(const RngStream s);
+
+void RngSeed(const RngStream s, const uint64_t seed);
+void RngSeedAll(const uint64_t seed);
+// Seed used for the last RngSeed call on this stream
+uint64_t RngGetSeed(const RngStream s);
+
+uint32_t RngNext(const RngStream s);
+// Random int in [low, high), or low if high <= low
+int RngInt(const RngStream s, const int low, const int high);
+// Random double in [0, 1)
+double RngDouble(const RngStream s);
@@ -66,6 +66,8 @@ ScreenShake ScreenShakeUpdate(ScreenShake s, int ticks)
 	s.Delta =
 		maxDelta == 0 ?
 		svec2_zero() :
-		svec2(RAND_FLOAT(0, maxDelta), RAND_FLOAT(0, maxDelta));
+		svec2(
+			RAND_FLOAT(RNG_COSMETIC, 0, maxDelta),
+			RAND_FLOAT(RNG_COSMETIC, 0, maxDelta));
 	return s;
 }
@@ -0,0 +1,193 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "sound_mixer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "utils.h"
+
+void SoundMixerInit(SoundMixer *m, const int numVoices)
+{
+	memset(m, 0, sizeof *m);
+	m->lock = SDL_CreateMutex();
+	if (m->lock == NULL)
+	{
+		LOG(LM_SOUND, LL_ERROR, "cannot create mixer lock: %s",
+			SDL_GetError());
+	}
+	CCALLOC(m->Voices, numVoices * sizeof *m->Voices);
+	m->NumVoices = numVoices;
+	m->Volume = MIX_MAX_VOLUME;
+}
+void SoundMixerTerminate(SoundMixer *m)
+{
+	if (m->lock != NULL)
+	{
+		SDL_DestroyMutex(m->lock);
+	}
+	CFREE(m->Voices);
+	memset(m, 0, sizeof *m);
+}
+void SoundMixerLock(const SoundMixer *m)
+{
+	if (m->lock != NULL)
+	{
+		SDL_LockMutex(m->lock);
+	}
+}
+void SoundMixerUnlock(const SoundMixer *m)
+{
+	if (m->lock != NULL)
+	{
+		SDL_UnlockMutex(m->lock);
+	}
+}
+
+void SoundMixerPlay(SoundMixer *m, const int voice, const Mix_Chunk *chunk)
+{
+	MixerVoice *v = &m->Voices[voice];
+	memset(v, 0, sizeof *v);
+	v->Chunk = chunk;
+}
+void SoundMixerStop(SoundMixer *m, const int voice)
+{
+	m->Voices[voice].Chunk = NULL;
+}
+bool SoundMixerIsPlaying(const SoundMixer *m, const int voice)
+{
+	return m->Voices[voice].Chunk != NULL;
+}
+void SoundMixerSetPosition(
+	SoundMixer *m, const int voice, const Sint16 bearingDegrees,
+	const Uint8 distance)
+{
+	MixerVoice *v = &m->Voices[voice];
+	v->Bearing = bearingDegrees;
+	v->Distance = distance;
+}
+void SoundMixerSetMuffled(
+	SoundMixer *m, const int voice, const bool isMuffled)
+{
+	m->Voices[voice].IsMuffled = isMuffled;
+}
+
+// Gains out of 255 for each side, following SDL_mixer's stereo positioning:
+// full in front and behind, and silent in the far ear at either side
+static void GetSideGains(const Sint16 bearingDegrees, int *left, int *right)
+{
+	const int angle = abs(bearingDegrees) % 360;
+	*left = 255;
+	*right = 255;
+	if (angle < 90)
+	{
+		*left = 255 - 255 * angle / 89;
+	}
+	else if (angle < 180)
+	{
+		*left = 255 * (angle - 90) / 89;
+	}
+	else if (angle < 270)
+	{
+		*right = 255 - 255 * (angle - 180) / 89;
+	}
+	else
+	{
+		*right = 255 * (angle - 270) / 89;
+	}
+	*left = CLAMP(*left, 0, 255);
+	*right = CLAMP(*right, 0, 255);
+}
+#define GAIN_ONE 65536
+static Sint16 AddClipped(const Sint16 a, const Sint32 b)
+{
+	const Sint32 sum = a + b;
+	return (Sint16)CLAMP(sum, -32768, 32767);
+}
+static int MixVoice(
+	MixerVoice *v, const int volume, Sint16 *stream, const int frames)
+{
+	const int frameSize = SOUND_MIXER_CHANNELS * 2;
+	const Sint16 *src = (const Sint16 *)(v->Chunk->abuf + v->Pos);
+	const int framesLeft = (int)((v->Chunk->alen - v->Pos) / frameSize);
+	const int n = MIN(frames, framesLeft);
+
+	int left, right;
+	GetSideGains(v->Bearing, &left, &right);
+	const Sint64 scale = (Sint64)(255 - v->Distance) * volume;
+	const Sint64 divisor = (Sint64)255 * 255 * MIX_MAX_VOLUME;
+	const Sint32 gains[2] = {
+		(Sint32)(left * scale * GAIN_ONE / divisor),
+		(Sint32)(right * scale * GAIN_ONE / divisor)};
+
+	for (int i = 0; i < n; i++)
+	{
+		for (int c = 0; c < SOUND_MIXER_CHANNELS; c++)
+		{
+			Sint32 s = src[i * SOUND_MIXER_CHANNELS + c];
+			// Like SoundMuffle, but the next frames are always the sound's
+			if (v->IsMuffled && i + 2 < framesLeft)
+			{
+				s = (s + src[(i + 1) * SOUND_MIXER_CHANNELS + c] +
+					 src[(i + 2) * SOUND_MIXER_CHANNELS + c]) /
+					3;
+			}
+			Sint16 *out = &stream[i * SOUND_MIXER_CHANNELS + c];
+			*out = AddClipped(*out, s * gains[c] / GAIN_ONE);
+		}
+	}
+	v->Pos += n * frameSize;
+	if (n == framesLeft)
+	{
+		v->Chunk = NULL;
+	}
+	return n;
+}
+void SoundMixerMix(SoundMixer *m, Sint16 *stream, const int frames)
+{
+	m->Stats.Frames += frames;
+	for (int i = 0; i < m->NumVoices; i++)
+	{
+		MixerVoice *v = &m->Voices[i];
+		if (v->Chunk != NULL)
+		{
+			m->Stats.VoiceFrames += MixVoice(v, m->Volume, stream, frames);
+		}
+	}
+}
+
+void SoundMuffle(Sint16 *samples, const int frames)
+{
+	for (int i = 0; i < frames - 2; i++)
+	{
+		Sint16 *s = samples + i * SOUND_MIXER_CHANNELS;
+		s[0] = (Sint16)((s[0] + s[2] + s[4]) / 3);
+		s[1] = (Sint16)((s[1] + s[3] + s[5]) / 3);
+	}
+}
@@ -0,0 +1,91 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_mutex.h>
+
+#ifdef __EMSCRIPTEN__
+#include <SDL.h>
+#include <SDL2/SDL_mixer.h>
+#else
+#include <SDL_mixer.h>
+#endif
+
+// Output is interleaved signed 16-bit stereo, like the sound chunks
+#define SOUND_MIXER_CHANNELS 2
+
+typedef struct
+{
+	const Mix_Chunk *Chunk; // NULL if stopped
+	Uint32 Pos;				// bytes played
+	Sint16 Bearing;
+	Uint8 Distance;
+	bool IsMuffled;
+} MixerVoice;
+
+// Mixes sound effects in software into a memory buffer, with the same
+// distance, bearing and muffle effects as SDL_mixer channels. Used with
+// SDL's dummy audio driver and for measuring and testing the mix.
+// When mixing on the audio thread, hold the lock while mixing and while
+// using the voices from other threads.
+typedef struct
+{
+	SDL_mutex *lock;
+	MixerVoice *Voices;
+	int NumVoices;
+	int Volume; // 0 to MIX_MAX_VOLUME
+	struct
+	{
+		Uint64 Frames;
+		// Frames mixed by each playing voice, summed
+		Uint64 VoiceFrames;
+	} Stats;
+} SoundMixer;
+
+void SoundMixerInit(SoundMixer *m, const int numVoices);
+void SoundMixerTerminate(SoundMixer *m);
+void SoundMixerLock(const SoundMixer *m);
+void SoundMixerUnlock(const SoundMixer *m);
+// Like Mix_PlayChannel; replaces the voice's sound and effects
+void SoundMixerPlay(SoundMixer *m, const int voice, const Mix_Chunk *chunk);
+void SoundMixerStop(SoundMixer *m, const int voice);
+bool SoundMixerIsPlaying(const SoundMixer *m, const int voice);
+// Like Mix_SetPosition; bearing is in degrees clockwise from the front,
+// and distance 0 is loudest
+void SoundMixerSetPosition(
+	SoundMixer *m, const int voice, const Sint16 bearingDegrees,
+	const Uint8 distance);
+void SoundMixerSetMuffled(
+	SoundMixer *m, const int voice, const bool isMuffled);
+// Add the playing voices to the stream, clipping
+void SoundMixerMix(SoundMixer *m, Sint16 *stream, const int frames);
+
+// Muffle by averaging each frame with the next two, in place
+void SoundMuffle(Sint16 *samples, const int frames);
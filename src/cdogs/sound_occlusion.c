@@ -0,0 +1,145 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "sound_occlusion.h"
+
+#include <string.h>
+
+#include "algorithms.h"
+#include "log.h"
+#include "utils.h"
+
+typedef enum
+{
+	OCCLUSION_UNKNOWN,
+	OCCLUSION_CLEAR,
+	OCCLUSION_BLOCKED
+} OcclusionState;
+
+void SoundOcclusionInit(
+	SoundOcclusion *o, bool (*isOpaque)(void *, struct vec2i), void *data)
+{
+	memset(o, 0, sizeof *o);
+	o->IsOpaque = isOpaque;
+	o->Data = data;
+}
+void SoundOcclusionTerminate(SoundOcclusion *o)
+{
+	for (int i = 0; i < SOUND_OCCLUSION_GRIDS; i++)
+	{
+		CFREE(o->Grids[i].States);
+	}
+	memset(o, 0, sizeof *o);
+}
+
+void SoundOcclusionSetSize(SoundOcclusion *o, const struct vec2i size)
+{
+	if (svec2i_is_equal(o->Size, size))
+	{
+		return;
+	}
+	o->Size = size;
+	for (int i = 0; i < SOUND_OCCLUSION_GRIDS; i++)
+	{
+		CFREE(o->Grids[i].States);
+		o->Grids[i].States = NULL;
+		o->Grids[i].LastUsed = 0;
+	}
+}
+void SoundOcclusionInvalidate(SoundOcclusion *o)
+{
+	for (int i = 0; i < SOUND_OCCLUSION_GRIDS; i++)
+	{
+		o->Grids[i].LastUsed = 0;
+	}
+}
+
+static OcclusionGrid *GetGrid(SoundOcclusion *o, const struct vec2i listener)
+{
+	OcclusionGrid *g = NULL;
+	for (int i = 0; i < SOUND_OCCLUSION_GRIDS; i++)
+	{
+		OcclusionGrid *other = &o->Grids[i];
+		if (other->LastUsed != 0 &&
+			svec2i_is_equal(other->Listener, listener))
+		{
+			g = other;
+			break;
+		}
+		// Otherwise reuse the least recently used grid
+		if (g == NULL || other->LastUsed < g->LastUsed)
+		{
+			g = other;
+		}
+	}
+	if (g->LastUsed == 0 || !svec2i_is_equal(g->Listener, listener))
+	{
+		const size_t size = o->Size.x * o->Size.y * sizeof *g->States;
+		if (g->States == NULL)
+		{
+			CMALLOC(g->States, size);
+		}
+		memset(g->States, OCCLUSION_UNKNOWN, size);
+		g->Listener = listener;
+	}
+	o->Clock++;
+	g->LastUsed = o->Clock;
+	return g;
+}
+static bool Raycast(
+	SoundOcclusion *o, const struct vec2i source, const struct vec2i listener)
+{
+	o->Stats.Raycasts++;
+	HasClearLineData lineData;
+	lineData.IsBlocked = o->IsOpaque;
+	lineData.data = o->Data;
+	return !HasClearLineJMRaytrace(source, listener, &lineData);
+}
+bool SoundOcclusionIsBlocked(
+	SoundOcclusion *o, const struct vec2i source, const struct vec2i listener)
+{
+	o->Stats.Queries++;
+	if (source.x < 0 || source.y < 0 || source.x >= o->Size.x ||
+		source.y >= o->Size.y)
+	{
+		return Raycast(o, source, listener);
+	}
+	OcclusionGrid *g = GetGrid(o, listener);
+	Uint8 *state = &g->States[source.y * o->Size.x + source.x];
+	if (*state == OCCLUSION_UNKNOWN)
+	{
+		*state = Raycast(o, source, listener) ? OCCLUSION_BLOCKED
+											  : OCCLUSION_CLEAR;
+	}
+	return *state == OCCLUSION_BLOCKED;
+}
+
+void SoundOcclusionLogStats(const SoundOcclusion *o)
+{
+	LOG(LM_SOUND, LL_INFO, "sound occlusion: %d queries, %d raycasts",
+		o->Stats.Queries, o->Stats.Raycasts);
+}
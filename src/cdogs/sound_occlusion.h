@@ -0,0 +1,74 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_stdinc.h>
+
+#include "vector.h"
+
+// Listener tiles with remembered visibility; split screen has up to four
+// listeners, and sounds between them are heard at points along the way
+#define SOUND_OCCLUSION_GRIDS 8
+
+// Visibility of every source tile from one listener tile. Tiles are
+// raycast the first time a sound is heard from them, and forgotten when
+// the grid is reused for another listener tile.
+typedef struct
+{
+	struct vec2i Listener;
+	Uint8 *States; // of OcclusionState, per map tile
+	Uint32 LastUsed; // 0 if unused
+} OcclusionGrid;
+
+typedef struct
+{
+	struct vec2i Size;
+	bool (*IsOpaque)(void *, struct vec2i);
+	void *Data;
+	OcclusionGrid Grids[SOUND_OCCLUSION_GRIDS];
+	Uint32 Clock;
+	struct
+	{
+		int Queries;
+		int Raycasts;
+	} Stats;
+} SoundOcclusion;
+
+void SoundOcclusionInit(
+	SoundOcclusion *o, bool (*isOpaque)(void *, struct vec2i), void *data);
+void SoundOcclusionTerminate(SoundOcclusion *o);
+// Match the map size; forgets everything if the size changes
+void SoundOcclusionSetSize(SoundOcclusion *o, const struct vec2i size);
+// Forget visibility, e.g. when doors open or close
+void SoundOcclusionInvalidate(SoundOcclusion *o);
+// Whether sounds from the source tile are muffled for the listener tile
+bool SoundOcclusionIsBlocked(
+	SoundOcclusion *o, const struct vec2i source, const struct vec2i listener);
+void SoundOcclusionLogStats(const SoundOcclusion *o);
@@ -0,0 +1,200 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "sound_voices.h"
+
+#include <string.h>
+
+#include "log.h"
+#include "utils.h"
+
+void VoiceManagerInit(
+	VoiceManager *vm, const int numVoices,
+	bool (*isPlaying)(const int voice))
+{
+	memset(vm, 0, sizeof *vm);
+	CCALLOC(vm->Voices, numVoices * sizeof *vm->Voices);
+	vm->NumVoices = numVoices;
+	vm->IsPlaying = isPlaying;
+}
+void VoiceManagerTerminate(VoiceManager *vm)
+{
+	CFREE(vm->Voices);
+	memset(vm, 0, sizeof *vm);
+}
+
+// Free voices that have finished; at most once per tick
+static void Reap(VoiceManager *vm, const Uint32 ticks)
+{
+	if (vm->IsPlaying == NULL || ticks == vm->LastReap)
+	{
+		return;
+	}
+	vm->LastReap = ticks;
+	for (int i = 0; i < vm->NumVoices; i++)
+	{
+		if (vm->Voices[i].Key != NULL && !vm->IsPlaying(i))
+		{
+			vm->Voices[i].Key = NULL;
+		}
+	}
+}
+// Whether a is less important than b
+static bool VoiceIsLess(const Voice *a, const Voice *b)
+{
+	if (a->Priority != b->Priority)
+	{
+		return a->Priority < b->Priority;
+	}
+	if (a->Distance != b->Distance)
+	{
+		return a->Distance > b->Distance;
+	}
+	return a->Ticks < b->Ticks;
+}
+static bool CanMerge(const Voice *a, const Voice *b)
+{
+	// Ticks may wrap, so compare the difference
+	const Uint32 dt = b->Ticks - a->Ticks;
+	return a->Key == b->Key && dt <= VOICE_MERGE_MS &&
+		   svec2_distance_squared(a->Pos, b->Pos) <=
+			   SQUARED(VOICE_MERGE_DISTANCE);
+}
+static VoiceResult Steal(
+	VoiceManager *vm, const Voice *v, const int victim, int *voice)
+{
+	if (victim < 0 || !VoiceIsLess(&vm->Voices[victim], v))
+	{
+		vm->Stats.Dropped++;
+		return VOICE_DROPPED;
+	}
+	vm->Voices[victim] = *v;
+	*voice = victim;
+	vm->Stats.Started++;
+	vm->Stats.Stolen++;
+	return VOICE_STARTED;
+}
+VoiceResult VoiceManagerStart(
+	VoiceManager *vm, const Voice *v, const int maxInstances, int *voice)
+{
+	CASSERT(v->Key != NULL, "voice must have a key");
+	Reap(vm, v->Ticks);
+	int freeVoice = -1;
+	int instances = 0;
+	int leastInstance = -1;
+	int least = -1;
+	for (int i = 0; i < vm->NumVoices; i++)
+	{
+		const Voice *other = &vm->Voices[i];
+		if (other->Key == NULL)
+		{
+			if (freeVoice < 0)
+			{
+				freeVoice = i;
+			}
+			continue;
+		}
+		if (other->Key == v->Key)
+		{
+			if (CanMerge(other, v))
+			{
+				*voice = i;
+				vm->Stats.Merged++;
+				return VOICE_MERGED;
+			}
+			instances++;
+			if (leastInstance < 0 ||
+				VoiceIsLess(other, &vm->Voices[leastInstance]))
+			{
+				leastInstance = i;
+			}
+		}
+		if (least < 0 || VoiceIsLess(other, &vm->Voices[least]))
+		{
+			least = i;
+		}
+	}
+	if (maxInstances > 0 && instances >= maxInstances)
+	{
+		return Steal(vm, v, leastInstance, voice);
+	}
+	if (freeVoice < 0)
+	{
+		return Steal(vm, v, least, voice);
+	}
+	vm->Voices[freeVoice] = *v;
+	*voice = freeVoice;
+	vm->Stats.Started++;
+	return VOICE_STARTED;
+}
+void VoiceManagerStop(VoiceManager *vm, const int voice)
+{
+	vm->Voices[voice].Key = NULL;
+}
+
+void VoiceManagerLogStats(const VoiceManager *vm)
+{
+	LOG(LM_SOUND, LL_INFO,
+		"voices: %d started (%d stolen), %d merged, %d dropped",
+		vm->Stats.Started, vm->Stats.Stolen, vm->Stats.Merged,
+		vm->Stats.Dropped);
+}
+
+// Voice classes by sound name prefix; the first match is used
+static const struct
+{
+	const char *Prefix;
+	SoundVoiceClass Class;
+} voiceClasses[] = {
+	{"footsteps/", {SOUND_PRIORITY_LOW, 4}},
+	{"slide", {SOUND_PRIORITY_LOW, 2}},
+	{"ricochet", {SOUND_PRIORITY_LOW, 3}},
+	{"hits/", {SOUND_PRIORITY_NORMAL, 4}},
+	{"chars/", {SOUND_PRIORITY_NORMAL, 4}},
+	{"explosion", {SOUND_PRIORITY_HIGH, 4}},
+	{"boom", {SOUND_PRIORITY_HIGH, 4}},
+	{"bang", {SOUND_PRIORITY_HIGH, 4}},
+	{"menu_", {SOUND_PRIORITY_HIGH, 1}},
+	{"mission_complete", {SOUND_PRIORITY_HIGH, 1}},
+	{"victory", {SOUND_PRIORITY_HIGH, 1}},
+};
+#define DEFAULT_MAX_INSTANCES 6
+SoundVoiceClass SoundVoiceClassFromName(const char *name)
+{
+	for (int i = 0; i < (int)(sizeof voiceClasses / sizeof voiceClasses[0]);
+		 i++)
+	{
+		if (strncmp(
+				name, voiceClasses[i].Prefix,
+				strlen(voiceClasses[i].Prefix)) == 0)
+		{
+			return voiceClasses[i].Class;
+		}
+	}
+	const SoundVoiceClass c = {SOUND_PRIORITY_NORMAL, DEFAULT_MAX_INSTANCES};
+	return c;
+}
@@ -0,0 +1,101 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+
+#include <SDL_stdinc.h>
+
+#include "mathc/mathc.h"
+
+// Sounds started within this time at nearby positions are merged
+#define VOICE_MERGE_MS 20
+#define VOICE_MERGE_DISTANCE 32
+
+typedef enum
+{
+	SOUND_PRIORITY_LOW,
+	SOUND_PRIORITY_NORMAL,
+	SOUND_PRIORITY_HIGH
+} SoundPriority;
+
+typedef struct
+{
+	SoundPriority Priority;
+	int MaxInstances; // 0 for no limit
+} SoundVoiceClass;
+
+typedef struct
+{
+	const void *Key; // instances of the same sound share keys; NULL if free
+	SoundPriority Priority;
+	int Distance;	 // attenuation; 0 is loudest, 255 quietest
+	struct vec2 Pos; // relative to the listener
+	Uint32 Ticks;	 // when it started
+} Voice;
+
+typedef enum
+{
+	VOICE_STARTED,
+	VOICE_MERGED,
+	VOICE_DROPPED
+} VoiceResult;
+
+// Shares a fixed budget of voices between sounds. Identical sounds that
+// start together are merged, and when there are too many sounds the least
+// important (lowest priority, then quietest, then oldest) is stopped.
+typedef struct
+{
+	Voice *Voices;
+	int NumVoices;
+	// Whether the voice is still playing; finished voices are freed
+	bool (*IsPlaying)(const int voice);
+	Uint32 LastReap;
+	struct
+	{
+		int Started;
+		int Merged;
+		int Dropped;
+		// Voices stopped to start more important ones; also started
+		int Stolen;
+	} Stats;
+} VoiceManager;
+
+void VoiceManagerInit(
+	VoiceManager *vm, const int numVoices,
+	bool (*isPlaying)(const int voice));
+void VoiceManagerTerminate(VoiceManager *vm);
+// Find a voice to play the sound on; *voice is the voice to start it on,
+// replacing any stolen sound, or the voice it was merged with
+VoiceResult VoiceManagerStart(
+	VoiceManager *vm, const Voice *v, const int maxInstances, int *voice);
+void VoiceManagerStop(VoiceManager *vm, const int voice);
+void VoiceManagerLogStats(const VoiceManager *vm);
+
+// Priorities and instance limits by sound name
+SoundVoiceClass SoundVoiceClassFromName(const char *name);
@@ -60,7 +60,6 @@
 
 #include <tinydir/tinydir.h>
 
-#include "algorithms.h"
 #include "files.h"
 #include "log.h"
 #include "map.h"
@@ -69,6 +68,33 @@
 
 SoundDevice gSoundDevice;
 
+// A sound file that is decoded on first play, and can be evicted once it has
+// finished playing. The chunk is allocated up front so that the pointers
+// held by weapons, map objects etc. stay valid.
+typedef struct
+{
+	Mix_Chunk Chunk;
+	char *Path;
+	int ResidentId;
+	// Variations of random sounds share the same key
+	const void *VoiceKey;
+	SoundVoiceClass Voice;
+} LazySound;
+// of LazySound *, keyed by chunk address
+static map_t lazySounds = NULL;
+// Mixes sound effects in place of SDL_mixer channels on the dummy driver
+static SoundMixer *softMixer = NULL;
+static size_t LazySoundLoad(void *asset);
+static void LazySoundUnload(void *asset);
+static bool LazySoundInUse(const void *asset);
+static void LazySoundSetId(void *asset, const int id);
+Residency gSoundResidency = {
+	.Name = "sounds",
+	.Load = LazySoundLoad,
+	.Unload = LazySoundUnload,
+	.InUse = LazySoundInUse,
+	.SetId = LazySoundSetId};
+
 int OpenAudio(int frequency, Uint16 format, int channels, int chunkSize)
 {
 	int qFrequency;
@@ -94,15 +120,26 @@ int OpenAudio(int frequency, Uint16 format, int channels, int chunkSize)
 	return 0;
 }
 
-static Mix_Chunk *LoadSound(const char *path);
-static void SoundLoad(map_t sounds, const char *name, const char *path)
+// A sound file found on a loader thread, waiting to be added; its chunks
+// are decoded on first play
+typedef struct
+{
+	char Name[CDOGS_PATH_MAX];
+	SoundData *Sound;
+} SoundDecoded;
+static Mix_Chunk *NewLazySound(const char *path);
+static void SoundDataRegister(SoundData *s, const char *name);
+static void *SoundDecode(const AssetJob *job)
 {
+	const char *name = job->Name;
+	const char *path = job->Path;
 	// If the sound basename is a number, it is part of a group of random
 	// sounds
 	char basename[CDOGS_FILENAME_MAX];
 	PathGetBasenameWithoutExtension(basename, name);
-	char nameNoExt[CDOGS_PATH_MAX];
-	PathGetWithoutExtension(nameNoExt, name);
+	SoundDecoded *d;
+	CCALLOC(d, sizeof *d);
+	PathGetWithoutExtension(d->Name, name);
 	bool isNumber = true;
 	for (const char *c = basename; *c != '\0'; c++)
 	{
@@ -119,7 +156,7 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 		const int n = atoi(basename);
 		if (n != 0)
 		{
-			return;
+			goto bail;
 		}
 		SoundData *sound;
 		CCALLOC(sound, sizeof *sound);
@@ -136,29 +173,46 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 		{
 			char buf[CDOGS_PATH_MAX];
 			sprintf(buf, fmt, i);
-			Mix_Chunk *data = LoadSound(buf);
+			Mix_Chunk *data = NewLazySound(buf);
 			if (data == NULL)
 				break;
 			CArrayPushBack(&sound->u.random.sounds, &data);
 		}
 		// Remove "/0" from name and add
-		*strrchr(nameNoExt, '/') = '\0';
-		SoundAdd(sounds, nameNoExt, sound);
+		*strrchr(d->Name, '/') = '\0';
+		d->Sound = sound;
 	}
 	else
 	{
-		Mix_Chunk *data = LoadSound(path);
+		Mix_Chunk *data = NewLazySound(path);
 		if (data != NULL)
 		{
 			SoundData *sound;
 			CMALLOC(sound, sizeof *sound);
 			sound->Type = SOUND_NORMAL;
 			sound->u.normal = data;
-			SoundAdd(sounds, nameNoExt, sound);
+			d->Sound = sound;
 		}
 	}
+
+bail:
+	if (d->Sound == NULL)
+	{
+		CFREE(d);
+		return NULL;
+	}
+	return d;
+}
+static void SoundAddDecoded(const AssetJob *job, void *data)
+{
+	SoundDecoded *d = data;
+	SoundDataRegister(d->Sound, d->Name);
+	SoundAdd(job->Maps[0], d->Name, d->Sound);
+	CFREE(d);
 }
-static Mix_Chunk *LoadSound(const char *path)
+static const AssetKind soundAssetKind = {
+	"sounds", SoundDecode, SoundAddDecoded, NULL};
+static Mix_Chunk *NewLazySound(const char *path)
 {
 	// Only load sounds from known extensions
 	const char *ext = strrchr(path, '.');
@@ -169,8 +223,170 @@ static Mix_Chunk *LoadSound(const char *path)
 	{
 		return NULL;
 	}
-	LOG(LM_MAIN, LL_TRACE, "loading sound file %s", path);
-	return Mix_LoadWAV(path);
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return NULL;
+	}
+	LazySound *s;
+	CCALLOC(s, sizeof *s);
+	s->Chunk.volume = MIX_MAX_VOLUME;
+	CSTRDUP(s->Path, path);
+	return &s->Chunk;
+}
+static void LazySoundRegister(
+	Mix_Chunk *chunk, const void *voiceKey, const SoundVoiceClass voice)
+{
+	if (lazySounds == NULL)
+	{
+		lazySounds = hashmap_new();
+	}
+	LazySound *s = (LazySound *)chunk;
+	s->ResidentId = ResidencyAdd(&gSoundResidency, s);
+	s->VoiceKey = voiceKey;
+	s->Voice = voice;
+	char key[32];
+	sprintf(key, "%p", (void *)chunk);
+	if (hashmap_put(lazySounds, key, s) != MAP_OK)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to add lazy sound %s", s->Path);
+	}
+}
+static LazySound *GetLazySound(const Mix_Chunk *chunk)
+{
+	if (lazySounds == NULL || chunk == NULL)
+	{
+		return NULL;
+	}
+	char key[32];
+	sprintf(key, "%p", (const void *)chunk);
+	LazySound *s;
+	if (hashmap_get(lazySounds, key, (any_t *)&s) != MAP_OK)
+	{
+		return NULL;
+	}
+	return s;
+}
+static void SoundDataRegister(SoundData *s, const char *name)
+{
+	const SoundVoiceClass voice = SoundVoiceClassFromName(name);
+	switch (s->Type)
+	{
+	case SOUND_NORMAL:
+		LazySoundRegister(s->u.normal, s, voice);
+		break;
+	case SOUND_RANDOM:
+		CA_FOREACH(Mix_Chunk *, chunk, s->u.random.sounds)
+		LazySoundRegister(*chunk, s, voice);
+		CA_FOREACH_END()
+		break;
+	default:
+		CASSERT(false, "Unknown sound data type");
+		break;
+	}
+}
+static size_t LazySoundLoad(void *asset)
+{
+	LazySound *s = asset;
+	LOG(LM_MAIN, LL_TRACE, "loading sound file %s", s->Path);
+	Mix_Chunk *data = Mix_LoadWAV(s->Path);
+	if (data == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "cannot load sound %s: %s", s->Path,
+			Mix_GetError());
+		return 0;
+	}
+	// Take the samples and discard the rest
+	s->Chunk.abuf = data->abuf;
+	s->Chunk.alen = data->alen;
+	s->Chunk.allocated = data->allocated;
+	data->allocated = 0;
+	Mix_FreeChunk(data);
+	return s->Chunk.alen;
+}
+static void LazySoundUnload(void *asset)
+{
+	LazySound *s = asset;
+	if (s->Chunk.allocated)
+	{
+		SDL_free(s->Chunk.abuf);
+	}
+	s->Chunk.abuf = NULL;
+	s->Chunk.alen = 0;
+	s->Chunk.allocated = 0;
+}
+static bool LazySoundInUse(const void *asset)
+{
+	const LazySound *s = asset;
+	const int channels = Mix_AllocateChannels(-1);
+	for (int i = 0; i < channels; i++)
+	{
+		if (Mix_Playing(i) && Mix_GetChunk(i) == &s->Chunk)
+		{
+			return true;
+		}
+	}
+	bool inUse = false;
+	if (softMixer != NULL)
+	{
+		SoundMixerLock(softMixer);
+		for (int i = 0; i < softMixer->NumVoices; i++)
+		{
+			inUse = inUse || softMixer->Voices[i].Chunk == &s->Chunk;
+		}
+		SoundMixerUnlock(softMixer);
+	}
+	return inUse;
+}
+static void LazySoundSetId(void *asset, const int id)
+{
+	LazySound *s = asset;
+	s->ResidentId = id;
+}
+static void SoundFreeChunk(Mix_Chunk *chunk)
+{
+	LazySound *s = GetLazySound(chunk);
+	if (s == NULL)
+	{
+		Mix_FreeChunk(chunk);
+		return;
+	}
+	// Like Mix_FreeChunk, stop any channels still playing it
+	const int channels = Mix_AllocateChannels(-1);
+	for (int i = 0; i < channels; i++)
+	{
+		if (Mix_GetChunk(i) == chunk)
+		{
+			Mix_HaltChannel(i);
+		}
+	}
+	if (softMixer != NULL)
+	{
+		SoundMixerLock(softMixer);
+		for (int i = 0; i < softMixer->NumVoices; i++)
+		{
+			if (softMixer->Voices[i].Chunk == chunk)
+			{
+				SoundMixerStop(softMixer, i);
+			}
+		}
+		SoundMixerUnlock(softMixer);
+	}
+	ResidencyUnload(&gSoundResidency, s->ResidentId);
+	ResidencyRemove(&gSoundResidency, s->ResidentId, s);
+	char key[32];
+	sprintf(key, "%p", (void *)chunk);
+	hashmap_remove(lazySounds, key);
+	CFREE(s->Path);
+	CFREE(s);
+}
+void SoundPrefetch(const Mix_Chunk *data)
+{
+	const LazySound *s = GetLazySound(data);
+	if (s != NULL)
+	{
+		ResidencyPrefetch(&gSoundResidency, s->ResidentId);
+	}
 }
 static void SoundDataTerminate(any_t data);
 void SoundAdd(map_t sounds, const char *name, SoundData *sound)
@@ -183,19 +399,48 @@ void SoundAdd(map_t sounds, const char *name, SoundData *sound)
 	}
 }
 
-void SoundInitialize(SoundDevice *device, const char *path)
+static bool VoiceIsPlaying(const int voice)
+{
+	if (softMixer != NULL)
+	{
+		SoundMixerLock(softMixer);
+		const bool isPlaying = SoundMixerIsPlaying(softMixer, voice);
+		SoundMixerUnlock(softMixer);
+		return isPlaying;
+	}
+	return Mix_Playing(voice) != 0;
+}
+static bool IsTileNoSee(void *data, struct vec2i pos)
+{
+	const Tile *t = MapGetTile(data, pos);
+	return t != NULL && TileIsOpaque(t);
+}
+typedef struct
+{
+	Mix_Chunk *Data;
+	struct vec2 Pos;
+	struct vec2 Origin;
+	int PlusDistance;
+} PendingSound;
+void SoundInitializeQueue(
+	SoundDevice *device, const char *path, AssetLoader *l)
 {
 	memset(device, 0, sizeof *device);
+	VoiceManagerInit(&device->voices, SOUND_VOICES, VoiceIsPlaying);
+	SoundOcclusionInit(&device->occlusion, IsTileNoSee, &gMap);
+	CArrayInit(&device->pendingSounds, sizeof(PendingSound));
+	// Audio must be open before sounds can be decoded
 	SoundReopen(device);
 
 	device->sounds = hashmap_new();
 	device->customSounds = hashmap_new();
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, path);
-	SoundLoadDir(device->sounds, buf, NULL);
+	SoundQueueDir(l, device->sounds, buf, NULL);
 	MusicPlayerInit(&device->music);
 }
-void SoundLoadDir(map_t sounds, const char *path, const char *prefix)
+void SoundQueueDir(
+	AssetLoader *l, map_t sounds, const char *path, const char *prefix)
 {
 	tinydir_dir dir;
 	if (tinydir_open(&dir, path) == -1)
@@ -230,11 +475,12 @@ void SoundLoadDir(map_t sounds, const char *path, const char *prefix)
 		}
 		if (file.is_reg)
 		{
-			SoundLoad(sounds, buf, file.path);
+			AssetLoaderQueue(
+				l, &soundAssetKind, file.path, buf, NULL, sounds, NULL);
 		}
 		else if (file.is_dir)
 		{
-			SoundLoadDir(sounds, file.path, buf);
+			SoundQueueDir(l, sounds, file.path, buf);
 		}
 	}
 
@@ -242,6 +488,49 @@ bail:
 	tinydir_close(&dir);
 }
 
+static void SoftMixerPostMix(void *udata, Uint8 *stream, int len)
+{
+	// SDL_mixer opens its own audio device, so SDL_LockAudio doesn't stop
+	// this; the mixer's lock keeps the game from changing voices mid-mix
+	SoundMixer *m = udata;
+	SoundMixerLock(m);
+	SoundMixerMix(m, (Sint16 *)stream, len / (SOUND_MIXER_CHANNELS * 2));
+	SoundMixerUnlock(m);
+}
+static void SoftMixerOpen(const int volume)
+{
+	// There's no sound card to play to, but mix sound effects anyway so
+	// that headless runs exercise the audio path
+	const char *driver = SDL_GetCurrentAudioDriver();
+	if (driver == NULL || strcmp(driver, "dummy") != 0)
+	{
+		return;
+	}
+	if (softMixer == NULL)
+	{
+		LOG(LM_SOUND, LL_INFO, "mixing sounds in software");
+		CMALLOC(softMixer, sizeof *softMixer);
+		SoundMixerInit(softMixer, SOUND_VOICES);
+	}
+	SoundMixerLock(softMixer);
+	softMixer->Volume = volume;
+	SoundMixerUnlock(softMixer);
+	Mix_SetPostMix(SoftMixerPostMix, softMixer);
+}
+static void SoftMixerClose(void)
+{
+	if (softMixer == NULL)
+	{
+		return;
+	}
+	LOG(LM_SOUND, LL_INFO, "software mixer: %llu frames, %llu voice frames",
+		(unsigned long long)softMixer->Stats.Frames,
+		(unsigned long long)softMixer->Stats.VoiceFrames);
+	SoundMixerTerminate(softMixer);
+	CFREE(softMixer);
+	softMixer = NULL;
+}
+
 static void SoundClose(SoundDevice *s, const bool waitForSoundsComplete)
 {
 	if (!s->isInitialised)
@@ -262,6 +551,7 @@ static void SoundClose(SoundDevice *s, const bool waitForSoundsComplete)
 		Mix_Quit();
 	}
 	Mix_CloseAudio();
+	SoftMixerClose();
 }
 
 void SoundReconfigure(SoundDevice *s)
@@ -269,17 +559,22 @@ void SoundReconfigure(SoundDevice *s)
 	s->isInitialised = false;
 	s->music.isInitialised = false;
 
-	if (Mix_AllocateChannels(s->channels) != s->channels)
+	if (Mix_AllocateChannels(SOUND_MIX_CHANNELS) != SOUND_MIX_CHANNELS)
 	{
 		printf("Couldn't allocate channels!\n");
 		return;
 	}
+	// Keep the voice channels for sound effects
+	Mix_ReserveChannels(SOUND_VOICES);
 
 	const int sVol = ConfigGetInt(&gConfig, "Sound.SoundVolume");
 	Mix_Volume(-1, sVol);
+	SoftMixerOpen(sVol);
 	const int mVol = ConfigGetInt(&gConfig, "Sound.MusicVolume");
 	Mix_VolumeMusic(mVol);
 	MusicSetPlaying(&s->music, mVol > 0);
+	gSoundResidency.Budget =
+		(size_t)ConfigGetInt(&gConfig, "Sound.SoundBudget") * 1024 * 1024;
 
 	s->isInitialised = true;
 	s->music.isInitialised = true;
@@ -291,10 +586,18 @@ void SoundReopen(SoundDevice *s)
 	if (OpenAudio(CDOGS_SND_RATE, CDOGS_SND_FMT, CDOGS_SND_CHANNELS, 1024) !=
 		0)
 	{
-		return;
+		// Fall back to SDL's dummy driver, which plays to nowhere
+		LOG(LM_SOUND, LL_WARN, "cannot open audio; using the dummy driver");
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+		if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0 ||
+			OpenAudio(
+				CDOGS_SND_RATE, CDOGS_SND_FMT, CDOGS_SND_CHANNELS, 1024) != 0)
+		{
+			return;
+		}
 	}
 
-	s->channels = 64;
 	SoundReconfigure(s);
 }
 
@@ -310,6 +613,9 @@ void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete)
 	hashmap_destroy(device->customSounds, SoundDataTerminate);
 
 	MusicPlayerTerminate(&device->music);
+	VoiceManagerTerminate(&device->voices);
+	SoundOcclusionTerminate(&device->occlusion);
+	CArrayTerminate(&device->pendingSounds);
 }
 static void SoundDataTerminate(any_t data)
 {
@@ -317,11 +623,11 @@ static void SoundDataTerminate(any_t data)
 	switch (s->Type)
 	{
 	case SOUND_NORMAL:
-		Mix_FreeChunk(s->u.normal);
+		SoundFreeChunk(s->u.normal);
 		break;
 	case SOUND_RANDOM:
 		CA_FOREACH(Mix_Chunk *, chunk, s->u.random.sounds)
-		Mix_FreeChunk(*chunk);
+		SoundFreeChunk(*chunk);
 		CA_FOREACH_END()
 		CArrayTerminate(&s->u.random.sounds);
 		break;
@@ -333,19 +639,14 @@ static void SoundDataTerminate(any_t data)
 }
 
 #define OUT_OF_SIGHT_DISTANCE_PLUS 100
-static int GetChannel(SoundDevice *s, Mix_Chunk *data);
+static int GetChannel(
+	SoundDevice *s, Mix_Chunk *data, const int distance,
+	const struct vec2 dp);
 static void MuffleEffect(int chan, void *stream, int len, void *udata)
 {
 	UNUSED(chan);
 	UNUSED(udata);
-	const int channels = 2;
-	const int chunk = channels * 2;
-	for (int i = 0; i < len / chunk - 2; i++)
-	{
-		int16_t *samples = (int16_t *)((char *)stream + i * chunk);
-		samples[0] = (samples[0] + samples[2] + samples[4]) / 3;
-		samples[1] = (samples[1] + samples[3] + samples[5]) / 3;
-	}
+	SoundMuffle(stream, len / (SOUND_MIXER_CHANNELS * 2));
 }
 static void SetSoundEffect(
 	const int channel, const Sint16 bearingDegrees, const Uint8 distance,
@@ -406,7 +707,7 @@ static void SoundPlayAtPosition(
 		bearingDegrees);
 
 	// Get sound channel to play sound
-	const int channel = GetChannel(device, data);
+	const int channel = GetChannel(device, data, distance, dp);
 	if (channel < 0)
 	{
 		return;
@@ -414,30 +715,69 @@ static void SoundPlayAtPosition(
 
 	SetSoundEffect(channel, bearingDegrees, (Uint8)distance, isMuffled);
 }
-static int GetChannel(SoundDevice *s, Mix_Chunk *data)
+static int GetChannel(
+	SoundDevice *s, Mix_Chunk *data, const int distance,
+	const struct vec2 dp)
 {
-	for (;;)
-	{
-		const int channel = Mix_PlayChannel(-1, data, 0);
-		if (channel >= 0 || s->channels > 128)
-		{
-			return channel;
-		}
-		// Check if we cannot play the sound; allocate more channels
-		s->channels *= 2;
-		if (Mix_AllocateChannels(s->channels) != s->channels)
+	const LazySound *ls = GetLazySound(data);
+	// Sounds that aren't loaded from files, e.g. imported ones, have the
+	// default class
+	const SoundVoiceClass voiceClass =
+		ls != NULL ? ls->Voice : SoundVoiceClassFromName("");
+	Voice v;
+	v.Key = ls != NULL ? ls->VoiceKey : data;
+	v.Priority = voiceClass.Priority;
+	v.Distance = distance;
+	v.Pos = dp;
+	v.Ticks = SDL_GetTicks();
+	int channel;
+	const VoiceResult result = VoiceManagerStart(
+		&s->voices, &v, voiceClass.MaxInstances, &channel);
+	if (result != VOICE_STARTED)
+	{
+		return -1;
+	}
+	if (ls != NULL)
+	{
+		ResidencyUse(&gSoundResidency, ls->ResidentId);
+		if (data->alen == 0)
 		{
-			LOG(LM_SOUND, LL_ERROR, "Cannot allocate channels");
+			VoiceManagerStop(&s->voices, channel);
 			return -1;
 		}
-		// When allocating new channels, need to reset their volume
-		Mix_Volume(-1, ConfigGetInt(&gConfig, "Sound.SoundVolume"));
 	}
+	// This replaces any sound that was stolen
+	if (softMixer != NULL)
+	{
+		SoundMixerLock(softMixer);
+		SoundMixerPlay(softMixer, channel, data);
+		SoundMixerUnlock(softMixer);
+	}
+	else if (Mix_PlayChannel(channel, data, 0) < 0)
+	{
+		LOG(LM_SOUND, LL_ERROR, "cannot play sound: %s", Mix_GetError());
+		VoiceManagerStop(&s->voices, channel);
+		channel = -1;
+	}
+	if (ls != NULL)
+	{
+		// Now that this sound is playing it won't be evicted
+		ResidencyEvict(&gSoundResidency);
+	}
+	return channel;
 }
 static void SetSoundEffect(
 	const int channel, const Sint16 bearingDegrees, const Uint8 distance,
 	const bool isMuffled)
 {
+	if (softMixer != NULL)
+	{
+		SoundMixerLock(softMixer);
+		SoundMixerSetPosition(softMixer, channel, bearingDegrees, distance);
+		SoundMixerSetMuffled(softMixer, channel, isMuffled);
+		SoundMixerUnlock(softMixer);
+		return;
+	}
 #ifndef __EMSCRIPTEN__
 	Mix_SetPosition(channel, bearingDegrees, (Uint8)distance);
 	if (isMuffled)
@@ -519,10 +859,13 @@ void SoundPlayAt(SoundDevice *device, Mix_Chunk *data, const struct vec2 pos)
 	SoundPlayAtPlusDistance(device, data, pos, 0);
 }
 
-static bool IsPosNoSee(void *data, struct vec2i pos)
+static void PlayAtOrigin(
+	SoundDevice *device, Mix_Chunk *data, const struct vec2 pos,
+	const struct vec2 origin, const int plusDistance, const bool isMuffled)
 {
-	const Tile *t = MapGetTile(data, Vec2iToTile(pos));
-	return t != NULL && TileIsOpaque(t);
+	const struct vec2 dp = svec2_subtract(pos, origin);
+	SoundPlayAtPosition(
+		device, data, svec2(dp.x, fabsf(dp.y) + plusDistance), isMuffled);
 }
 void SoundPlayAtPlusDistance(
 	SoundDevice *device, Mix_Chunk *data, const struct vec2 pos,
@@ -556,28 +899,39 @@ void SoundPlayAtPlusDistance(
 
 	const struct vec2 origin = CalcClosestPointOnLineSegmentToPoint(
 		closestLeftEar, closestRightEar, pos);
-	bool isMuffled = false;
 	// Don't bother checking muffled if the distance is really close
 	// This is for player's own sounds like footsteps
-	if (svec2_distance_squared(pos, origin) > SQUARED(TILE_WIDTH))
+	if (svec2_distance_squared(pos, origin) <= SQUARED(TILE_WIDTH))
 	{
-		HasClearLineData lineData;
-		lineData.IsBlocked = IsPosNoSee;
-		lineData.data = &gMap;
-		if (!HasClearLineJMRaytrace(
-				svec2i_assign_vec2(pos), svec2i_assign_vec2(origin), &lineData))
-		{
-			isMuffled = true;
-		}
+		PlayAtOrigin(device, data, pos, origin, plusDistance, false);
+		return;
 	}
-	const struct vec2 dp = svec2_subtract(pos, origin);
-	SoundPlayAtPosition(
-		&gSoundDevice, data, svec2(dp.x, fabsf(dp.y) + plusDistance),
-		isMuffled);
+	PendingSound ps;
+	ps.Data = data;
+	ps.Pos = pos;
+	ps.Origin = origin;
+	ps.PlusDistance = plusDistance;
+	CArrayPushBack(&device->pendingSounds, &ps);
+}
+void SoundFlush(SoundDevice *device)
+{
+	if (device->pendingSounds.size == 0)
+	{
+		return;
+	}
+	// Sounds from the same tile to the same listener share one raycast,
+	// which is remembered until the listener moves to another tile
+	SoundOcclusionSetSize(&device->occlusion, gMap.Size);
+	CA_FOREACH(const PendingSound, ps, device->pendingSounds)
+	const bool isMuffled = SoundOcclusionIsBlocked(
+		&device->occlusion, Vec2ToTile(ps->Pos), Vec2ToTile(ps->Origin));
+	PlayAtOrigin(
+		device, ps->Data, ps->Pos, ps->Origin, ps->PlusDistance, isMuffled);
+	CA_FOREACH_END()
+	CArrayClear(&device->pendingSounds);
 }
 
-static Mix_Chunk *SoundDataGet(SoundData *s);
-Mix_Chunk *StrSound(const char *s)
+static SoundData *StrSoundData(const char *s)
 {
 	if (s == NULL || strlen(s) == 0 || !gSoundDevice.isInitialised)
 	{
@@ -587,15 +941,43 @@ Mix_Chunk *StrSound(const char *s)
 	int error = hashmap_get(gSoundDevice.customSounds, s, (any_t *)&sound);
 	if (error == MAP_OK)
 	{
-		return SoundDataGet(sound);
+		return sound;
 	}
 	error = hashmap_get(gSoundDevice.sounds, s, (any_t *)&sound);
 	if (error == MAP_OK)
 	{
-		return SoundDataGet(sound);
+		return sound;
 	}
 	return NULL;
 }
+static Mix_Chunk *SoundDataGet(SoundData *s);
+Mix_Chunk *StrSound(const char *s)
+{
+	SoundData *sound = StrSoundData(s);
+	return sound != NULL ? SoundDataGet(sound) : NULL;
+}
+void SoundPrefetchName(const char *s)
+{
+	const SoundData *sound = StrSoundData(s);
+	if (sound == NULL)
+	{
+		return;
+	}
+	switch (sound->Type)
+	{
+	case SOUND_NORMAL:
+		SoundPrefetch(sound->u.normal);
+		break;
+	case SOUND_RANDOM:
+		CA_FOREACH(const Mix_Chunk *, chunk, sound->u.random.sounds)
+		SoundPrefetch(*chunk);
+		CA_FOREACH_END()
+		break;
+	default:
+		CASSERT(false, "Unknown sound data type");
+		break;
+	}
+}
 static Mix_Chunk *SoundDataGet(SoundData *s)
 {
 	switch (s->Type)
@@ -614,7 +996,8 @@ static Mix_Chunk *SoundDataGet(SoundData *s)
 			while ((int)s->u.random.sounds.size > 1 &&
 				   idx == s->u.random.lastPlayed)
 			{
-				idx = rand() % s->u.random.sounds.size;
+				idx = RAND_INT(
+					RNG_COSMETIC, 0, (int)s->u.random.sounds.size);
 			}
 			Mix_Chunk **sound = CArrayGet(&s->u.random.sounds, idx);
 			s->u.random.lastPlayed = idx;
@@ -57,11 +57,16 @@
 #include <SDL_mixer.h>
 #endif
 
+#include "asset_loader.h"
 #include "c_array.h"
 #include "c_hashmap/hashmap.h"
 #include "defs.h"
 #include "mathc/mathc.h"
 #include "music.h"
+#include "residency.h"
+#include "sound_mixer.h"
+#include "sound_occlusion.h"
+#include "sound_voices.h"
 #include "sys_config.h"
 #include "utils.h"
 #include "vector.h"
@@ -69,6 +74,10 @@
 #define CDOGS_SND_RATE 44100
 #define CDOGS_SND_FMT AUDIO_S16
 #define CDOGS_SND_CHANNELS 2
+// Sound effects play on a fixed budget of voices, one mixer channel each.
+// The channels after them are for other uses like music chunks.
+#define SOUND_VOICES 32
+#define SOUND_MIX_CHANNELS (SOUND_VOICES + 2)
 
 typedef enum
 {
@@ -93,7 +102,11 @@ typedef struct
 {
 	MusicPlayer music;
 	bool isInitialised;
-	int channels;
+	VoiceManager voices;
+	SoundOcclusion occlusion;
+	// Positional sounds waiting for SoundFlush, to check their occlusion
+	// together
+	CArray pendingSounds;
 
 	// Two sets of ears for 4-player split screen
 	struct vec2 earLeft1;
@@ -106,15 +119,22 @@ typedef struct
 } SoundDevice;
 
 extern SoundDevice gSoundDevice;
-
-void SoundInitialize(SoundDevice *device, const char *path);
-void SoundLoadDir(map_t sounds, const char *path, const char *prefix);
+// Sounds loaded from files are decoded on first play
+extern Residency gSoundResidency;
+
+// Open the device and queue the sounds to be loaded in AssetLoaderFinish
+void SoundInitializeQueue(
+	SoundDevice *device, const char *path, AssetLoader *l);
+void SoundQueueDir(
+	AssetLoader *l, map_t sounds, const char *path, const char *prefix);
 void SoundAdd(map_t sounds, const char *name, SoundData *sound);
 void SoundReconfigure(SoundDevice *s);
 void SoundReopen(SoundDevice *s);
 void SoundClear(map_t sounds);
 void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete);
 void SoundPlay(SoundDevice *device, Mix_Chunk *data);
+// Decode now so that the first play doesn't stall
+void SoundPrefetch(const Mix_Chunk *data);
 void SoundSetEarsSide(const bool isLeft, const struct vec2 pos);
 void SoundSetEar(const bool isLeft, const int idx, const struct vec2 pos);
 void SoundSetEars(const struct vec2 pos);
@@ -125,5 +145,10 @@ void SoundPlayAt(SoundDevice *device, Mix_Chunk *data, const struct vec2 pos);
 void SoundPlayAtPlusDistance(
 	SoundDevice *device, Mix_Chunk *data, const struct vec2 pos,
 	const int plusDistance);
+// Play the sounds queued this tick; sounds away from the listener are
+// queued so that their occlusion is checked together
+void SoundFlush(SoundDevice *device);
 
 Mix_Chunk *StrSound(const char *s);
+// Prefetch all the variations of a sound
+void SoundPrefetchName(const char *s);
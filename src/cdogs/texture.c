@@ -26,6 +26,7 @@
 #include "texture.h"
 
 #include "log.h"
+#include "render_queue.h"
 
 
 SDL_Texture *TextureCreate(
@@ -62,6 +63,11 @@ void TextureRender(
 	SDL_Texture *t, SDL_Renderer *r, const Rect2i src, const Rect2i dest,
 	const color_t mask, const double angle, const SDL_RendererFlip flip)
 {
+	if (gRenderQueue.Recording)
+	{
+		RenderQueuePushCopy(&gRenderQueue, t, r, src, dest, mask, angle, flip);
+		return;
+	}
 	if (SDL_SetTextureColorMod(t, mask.r, mask.g, mask.b) != 0)
 	{
 		LOG(LM_MAIN, LL_ERROR, "Failed to set texture mask: %s",
@@ -45,8 +45,8 @@
 #define DRAW_SHAKE_FACTOR 0.3f
 #define DRAW_SHAKE_DECAY 0.8f
 #define ZERO_DRAW_SHAKE svec2(\
-	RAND_FLOAT(-DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f,\
-	RAND_FLOAT(-DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f)
+	RAND_FLOAT(RNG_COSMETIC, -DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f,\
+	RAND_FLOAT(RNG_COSMETIC, -DRAW_SHAKE_MAX, DRAW_SHAKE_MAX) * 0.7f)
 
 
 bool IsThingInsideTile(const Thing *i, const struct vec2i tilePos)
@@ -120,20 +120,20 @@ void TileClassLoadJSON(TileClass *tc, json_t *node)
 	LoadStr(&tc->DamageBullet, node, "DamageBullet");
 }
 
-json_t *TileClassSaveJSON(const TileClass *tc)
+void TileClassSave(const TileClass *tc, JSONWriter *w, const char *key)
 {
-	json_t *itemNode = json_new_object();
-	AddStringPair(itemNode, "Name", tc->Name);
-	AddStringPair(itemNode, "Type", TileClassTypeStr(tc->Type));
-	AddStringPair(itemNode, "Style", tc->Style);
-	AddColorPair(itemNode, "Mask", tc->Mask);
-	AddColorPair(itemNode, "MaskAlt", tc->MaskAlt);
-	AddBoolPair(itemNode, "CanWalk", tc->canWalk);
-	AddBoolPair(itemNode, "IsOpaque", tc->isOpaque);
-	AddBoolPair(itemNode, "Shootable", tc->shootable);
-	AddBoolPair(itemNode, "IsRoom", tc->IsRoom);
-	AddStringPair(itemNode, "DamageBullet", tc->DamageBullet);
-	return itemNode;
+	JSONWriterBeginObject(w, key);
+	JSONWriterString(w, "Name", tc->Name);
+	JSONWriterString(w, "Type", TileClassTypeStr(tc->Type));
+	JSONWriterString(w, "Style", tc->Style);
+	JSONWriterColor(w, "Mask", tc->Mask);
+	JSONWriterColor(w, "MaskAlt", tc->MaskAlt);
+	JSONWriterBool(w, "CanWalk", tc->canWalk);
+	JSONWriterBool(w, "IsOpaque", tc->isOpaque);
+	JSONWriterBool(w, "Shootable", tc->shootable);
+	JSONWriterBool(w, "IsRoom", tc->IsRoom);
+	JSONWriterString(w, "DamageBullet", tc->DamageBullet);
+	JSONWriterEndObject(w);
 }
 
 const char *TileClassBaseStyleType(const TileClassType type)
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 
 #include "c_hashmap/hashmap.h"
+#include "json_writer.h"
 #include "pic_manager.h"
 
 #define TILE_WIDTH      16
@@ -84,7 +85,7 @@ void TileClassesTerminate(map_t c);
 void TileClassDestroy(any_t data);
 void TileClassTerminate(TileClass *tc);
 void TileClassLoadJSON(TileClass *tc, json_t *node);
-json_t *TileClassSaveJSON(const TileClass *tc);
+void TileClassSave(const TileClass *tc, JSONWriter *w, const char *key);
 
 void TileClassInit(
 	TileClass *t, PicManager *pm, const TileClass *base,
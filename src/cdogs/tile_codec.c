@@ -0,0 +1,335 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "tile_codec.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "utils.h"
+
+static int GetValue(const CArray *a, const size_t i)
+{
+	if (a->elemSize == sizeof(uint16_t))
+	{
+		return ((const uint16_t *)a->data)[i];
+	}
+	return ((const int *)a->data)[i];
+}
+static void SetValue(CArray *a, const size_t i, const int value)
+{
+	if (a->elemSize == sizeof(uint16_t))
+	{
+		((uint16_t *)a->data)[i] = (uint16_t)value;
+	}
+	else
+	{
+		((int *)a->data)[i] = value;
+	}
+}
+// Grow geometrically, so that callers appending row by row don't
+// reallocate every row
+static void ReserveMore(CArray *a, const size_t count)
+{
+	const size_t needed = a->size + count;
+	if (needed > a->capacity)
+	{
+		CArrayReserve(a, MAX(needed, a->capacity * 2));
+	}
+}
+
+size_t TileCSVCount(const char *csv)
+{
+	size_t count = 0;
+	bool inValue = false;
+	for (const char *p = csv; *p; p++)
+	{
+		if (*p == ',')
+		{
+			inValue = false;
+		}
+		else if (!inValue)
+		{
+			inValue = true;
+			count++;
+		}
+	}
+	return count;
+}
+
+void TileCSVDecode(CArray *a, const char *csv)
+{
+	CASSERT(
+		a->elemSize == sizeof(int) || a->elemSize == sizeof(uint16_t),
+		"unsupported tile array");
+	ReserveMore(a, TileCSVCount(csv));
+	// Same results as atoi on each value, without the per-call overhead
+	const char *p = csv;
+	for (;;)
+	{
+		while (*p == ',')
+		{
+			p++;
+		}
+		if (*p == '\0')
+		{
+			break;
+		}
+		while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+		{
+			p++;
+		}
+		bool negative = false;
+		if (*p == '-' || *p == '+')
+		{
+			negative = *p == '-';
+			p++;
+		}
+		unsigned n = 0;
+		while (*p >= '0' && *p <= '9')
+		{
+			n = n * 10 + (unsigned)(*p - '0');
+			p++;
+		}
+		// Skip anything after the digits, like atoi
+		while (*p != ',' && *p != '\0')
+		{
+			p++;
+		}
+		SetValue(a, a->size, (int)(negative ? 0u - n : n));
+		a->size++;
+	}
+}
+
+size_t TileCSVEncode(
+	char *buf, const CArray *a, const size_t start, const size_t count)
+{
+	char *out = buf;
+	for (size_t i = start; i < start + count; i++)
+	{
+		if (i > start)
+		{
+			*out++ = ',';
+		}
+		const int value = GetValue(a, i);
+		unsigned u = (unsigned)value;
+		if (value < 0)
+		{
+			*out++ = '-';
+			u = 0u - u;
+		}
+		// Digits come out backwards
+		char digits[10];
+		int len = 0;
+		do
+		{
+			digits[len++] = (char)('0' + u % 10);
+			u /= 10;
+		} while (u > 0);
+		while (len > 0)
+		{
+			*out++ = digits[--len];
+		}
+	}
+	*out = '\0';
+	return (size_t)(out - buf);
+}
+
+static const char b64Chars[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static int B64Value(const char c)
+{
+	if (c >= 'A' && c <= 'Z')
+		return c - 'A';
+	if (c >= 'a' && c <= 'z')
+		return c - 'a' + 26;
+	if (c >= '0' && c <= '9')
+		return c - '0' + 52;
+	if (c == '+')
+		return 62;
+	if (c == '/')
+		return 63;
+	return -1;
+}
+
+static uint8_t *PutVarint(uint8_t *p, uint32_t v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (uint8_t)v;
+	return p;
+}
+// Returns false if the data ends early or the varint is too long
+static bool GetVarint(const uint8_t **p, const uint8_t *end, uint32_t *v)
+{
+	*v = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		if (*p == end)
+		{
+			return false;
+		}
+		const uint8_t b = *(*p)++;
+		*v |= (uint32_t)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+// Zigzag, so that small negative values are small varints too
+static uint32_t ZigZag(const int v)
+{
+	return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+static int UnZigZag(const uint32_t u)
+{
+	return (int)(u >> 1) ^ -(int)(u & 1);
+}
+
+char *TileRLEEncode(const CArray *a)
+{
+	// Worst case: every value is its own run of two 5-byte varints
+	uint8_t *runs;
+	CMALLOC(runs, a->size * 10 + 1);
+	uint8_t *p = runs;
+	for (size_t i = 0; i < a->size;)
+	{
+		const int value = GetValue(a, i);
+		size_t j = i + 1;
+		while (j < a->size && GetValue(a, j) == value)
+		{
+			j++;
+		}
+		p = PutVarint(p, ZigZag(value));
+		p = PutVarint(p, (uint32_t)(j - i));
+		i = j;
+	}
+	const size_t len = (size_t)(p - runs);
+
+	char *s;
+	CMALLOC(s, (len + 2) / 3 * 4 + 1);
+	char *out = s;
+	size_t i;
+	for (i = 0; i + 2 < len; i += 3)
+	{
+		const uint32_t v = ((uint32_t)runs[i] << 16) |
+						   ((uint32_t)runs[i + 1] << 8) | runs[i + 2];
+		*out++ = b64Chars[(v >> 18) & 63];
+		*out++ = b64Chars[(v >> 12) & 63];
+		*out++ = b64Chars[(v >> 6) & 63];
+		*out++ = b64Chars[v & 63];
+	}
+	if (i < len)
+	{
+		uint32_t v = (uint32_t)runs[i] << 16;
+		if (i + 1 < len)
+		{
+			v |= (uint32_t)runs[i + 1] << 8;
+		}
+		*out++ = b64Chars[(v >> 18) & 63];
+		*out++ = b64Chars[(v >> 12) & 63];
+		*out++ = i + 1 < len ? b64Chars[(v >> 6) & 63] : '=';
+		*out++ = '=';
+	}
+	*out = '\0';
+	CFREE(runs);
+	return s;
+}
+
+bool TileRLEDecode(CArray *a, const char *s)
+{
+	CASSERT(
+		a->elemSize == sizeof(int) || a->elemSize == sizeof(uint16_t),
+		"unsupported tile array");
+	bool ok = false;
+	size_t len = strlen(s);
+	while (len > 0 && s[len - 1] == '=')
+	{
+		len--;
+	}
+	if (len % 4 == 1)
+	{
+		return false;
+	}
+	uint8_t *runs;
+	CMALLOC(runs, len * 3 / 4 + 1);
+	uint8_t *out = runs;
+	uint32_t bits = 0;
+	int numBits = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		const int v = B64Value(s[i]);
+		if (v < 0)
+		{
+			goto bail;
+		}
+		bits = (bits << 6) | (uint32_t)v;
+		numBits += 6;
+		if (numBits >= 8)
+		{
+			numBits -= 8;
+			*out++ = (uint8_t)(bits >> numBits);
+		}
+	}
+	const uint8_t *end = out;
+
+	// Validate and count first, so the array is sized once
+	size_t total = 0;
+	for (const uint8_t *p = runs; p < end;)
+	{
+		uint32_t value, count;
+		if (!GetVarint(&p, end, &value) || !GetVarint(&p, end, &count) ||
+			count == 0 || count > TILE_RLE_MAX_COUNT - total)
+		{
+			goto bail;
+		}
+		total += count;
+	}
+	ReserveMore(a, total);
+	for (const uint8_t *p = runs; p < end;)
+	{
+		uint32_t value, count;
+		GetVarint(&p, end, &value);
+		GetVarint(&p, end, &count);
+		const int v = UnZigZag(value);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			SetValue(a, a->size + i, v);
+		}
+		a->size += count;
+	}
+	ok = true;
+
+bail:
+	CFREE(runs);
+	return ok;
+}
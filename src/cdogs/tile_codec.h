@@ -0,0 +1,59 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "c_array.h"
+
+// Encoding of static map tile and access layers, whose arrays hold either
+// int or uint16_t values.
+// CSV is the legacy format, one string per row of comma-separated ints.
+// RLE is a single base64 string of (value, count) runs, each as a varint;
+// much smaller and faster for large maps with big areas of one tile.
+
+// Max length of count CSV values including the terminator
+#define TILE_CSV_MAX_LEN(_count) ((_count) * 12 + 1)
+// Guard against corrupt RLE data allocating huge arrays
+#define TILE_RLE_MAX_COUNT (4096 * 4096)
+
+// Number of values in the comma-separated list
+size_t TileCSVCount(const char *csv);
+// Append the comma-separated values to the array; empty values are skipped
+void TileCSVDecode(CArray *a, const char *csv);
+// Write count values from start as comma-separated ints, into buf of at
+// least TILE_CSV_MAX_LEN(count); returns the length written
+size_t TileCSVEncode(
+	char *buf, const CArray *a, const size_t start, const size_t count);
+
+// Returns a new string, which must be freed
+char *TileRLEEncode(const CArray *a);
+// Append the decoded values to the array; false if the data is invalid,
+// in which case the array is unchanged
+bool TileRLEDecode(CArray *a, const char *s);
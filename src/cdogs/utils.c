@@ -605,6 +605,25 @@ bool IntsEqual(const void *v1, const void *v2)
 	return *(const int *)v1 == *(const int *)v2;
 }
 
+// FNV-1a, a word at a time
+uint64_t HashBytes(const void *data, const size_t size, const uint64_t seed)
+{
+	const uint8_t *p = data;
+	uint64_t h = 14695981039346656037ULL ^ seed;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t w;
+		memcpy(&w, p + i, sizeof w);
+		h = (h ^ w) * 1099511628211ULL;
+	}
+	for (; i < size; i++)
+	{
+		h = (h ^ p[i]) * 1099511628211ULL;
+	}
+	return h ^ (h >> 32);
+}
+
 BodyPart StrBodyPart(const char *s)
 {
 	S2T(BODY_PART_HEAD, "head");
@@ -50,11 +50,13 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h> /* for stderr */
 #include <stdlib.h>
 #include <string.h>
 
 #include "color.h"
+#include "rng.h"
 #include "sys_specifics.h"
 
 // Global variables so their address can be taken (passed into void * funcs)
@@ -196,6 +198,8 @@ int Stricmp(const char *a, const char *b);
 int CompareIntsAsc(const void *v1, const void *v2);
 int CompareIntsDesc(const void *v1, const void *v2);
 bool IntsEqual(const void *v1, const void *v2);
+// Fast non-cryptographic hash, for checksums and cache keys
+uint64_t HashBytes(const void *data, const size_t size, const uint64_t seed);
 
 // Helper macros for defining type/str conversion funcs
 #define T2S(_type, _str)                                                      \
@@ -207,12 +211,13 @@ bool IntsEqual(const void *v1, const void *v2);
 		return _type;                                                         \
 	}
 
-#define RAND_INT(_low, _high)                                                 \
-	((_low) == (_high) ? (_low) : (_low) + (rand() % ((_high) - (_low))))
-#define RAND_FLOAT(_low, _high) (float)RAND_DOUBLE(_low, _high)
-#define RAND_DOUBLE(_low, _high)                                              \
-	((_low) + ((double)rand() / RAND_MAX * ((_high) - (_low))))
-#define RAND_BOOL() (RAND_INT(0, 1) == 0)
+// Random numbers from one of the RngStream streams
+#define RAND_INT(_stream, _low, _high) RngInt(_stream, _low, _high)
+#define RAND_FLOAT(_stream, _low, _high)                                      \
+	(float)RAND_DOUBLE(_stream, _low, _high)
+#define RAND_DOUBLE(_stream, _low, _high)                                     \
+	((_low) + RngDouble(_stream) * ((_high) - (_low)))
+#define RAND_BOOL(_stream) ((RngNext(_stream) & 1) == 0)
 
 typedef enum
 {
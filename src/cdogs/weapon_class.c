@@ -62,6 +62,7 @@ static void WeaponClassTerminate(WeaponClass *wc);
 void WeaponClassesLoadJSON(WeaponClasses *wcs, CArray *classes, json_t *root)
 {
 	LOG(LM_MAP, LL_DEBUG, "loading weapons");
+	JSONTrackVisits(root, LM_MAP);
 	int version;
 	LoadInt(&version, root, "Version");
 	if (version > VERSION || version <= 0)
@@ -114,6 +115,7 @@ void WeaponClassesLoadJSON(WeaponClasses *wcs, CArray *classes, json_t *root)
 			CArrayPushBack(classes, &gd);
 		}
 	}
+	JSONLogUnvisited(root, LM_MAP, "guns");
 }
 static void LoadWeaponClass(WeaponClass *wc, json_t *node, const int version)
 {
@@ -370,6 +372,100 @@ static void LoadWeaponClass(WeaponClass *wc, json_t *node, const int version)
 			wc->u.Normal.Shake.CameraSubjectOnly ? "true" : "false");
 	}
 }
+static bool AmmoNameIsValid(const json_t *node)
+{
+	char *name = json_unescape(node->text);
+	const bool valid = strlen(name) == 0 || AmmoFindId(name) >= 0;
+	CFREE(name);
+	return valid;
+}
+static bool BarrelsAreValid(const json_t *node)
+{
+	int count = 0;
+	for (const json_t *c = node->child; c; c = c->next, count++)
+	{
+		if (c->type != JSON_STRING || !WeaponClassNameIsValid(c))
+		{
+			return false;
+		}
+	}
+	return count <= MAX_BARRELS;
+}
+static const JSONField gunFields[] = {
+	{"Guns", JSON_FIELD_ARRAY, BarrelsAreValid, 0},
+	{"CanShoot", JSON_FIELD_BOOL, NULL, 0},
+	{"IsGrenade", JSON_FIELD_BOOL, NULL, 0},
+	{"Icon", JSON_FIELD_STRING, NULL, 0},
+	{"Description", JSON_FIELD_STRING, NULL, 0},
+	{"Lock", JSON_FIELD_NUMBER, NULL, 0},
+	{"SwitchSound", JSON_FIELD_STRING, NULL, 0},
+	{"CanDrop", JSON_FIELD_BOOL, NULL, 0},
+	{"DropGun", JSON_FIELD_STRING, NULL, 0},
+	{"Pic", JSON_FIELD_STRING, NULL, 0},
+	{"Grips", JSON_FIELD_NUMBER, NULL, 0},
+	{"Bullet", JSON_FIELD_STRING, BulletClassNameIsValid, 0},
+	{"Bullets", JSON_FIELD_STRINGS, BulletClassNameIsValid, 0},
+	{"Ammo", JSON_FIELD_STRING, AmmoNameIsValid, 0},
+	{"Cost", JSON_FIELD_NUMBER, NULL, 0},
+	{"ReloadLead", JSON_FIELD_NUMBER, NULL, 0},
+	{"Sound", JSON_FIELD_STRING, NULL, 0},
+	{"ReloadSound", JSON_FIELD_STRING, NULL, 0},
+	{"SoundLockLength", JSON_FIELD_NUMBER, NULL, 0},
+	{"Recoil", JSON_FIELD_NUMBER, NULL, 0},
+	{"SpreadCount", JSON_FIELD_NUMBER, NULL, 0},
+	{"SpreadWidth", JSON_FIELD_NUMBER, NULL, 0},
+	{"AngleOffset", JSON_FIELD_NUMBER, NULL, 0},
+	{"MuzzleHeight", JSON_FIELD_NUMBER, NULL, 0},
+	{"Elevation", JSON_FIELD_NUMBER, NULL, 0},
+	{"ElevationLow", JSON_FIELD_NUMBER, NULL, 0},
+	{"ElevationHigh", JSON_FIELD_NUMBER, NULL, 0},
+	{"MuzzleFlashParticle", JSON_FIELD_STRING, ParticleClassNameIsValid, 0},
+	{"Brass", JSON_FIELD_STRING, ParticleClassNameIsValid, 0},
+	{"ShakeAmount", JSON_FIELD_NUMBER, NULL, 0},
+	{"Shake", JSON_FIELD_OBJECT, NULL, 3},
+	{"Shake/Amount", JSON_FIELD_NUMBER, NULL, 3},
+	{"Shake/CameraSubjectOnly", JSON_FIELD_BOOL, NULL, 3},
+	{"Index", JSON_FIELD_NUMBER, NULL, 0},
+	{NULL, JSON_FIELD_BOOL, NULL, 0}};
+bool WeaponClassesReloadJSON(WeaponClasses *wcs, json_t *root)
+{
+	if (!JSONCheckClassList(root, VERSION, "Guns", "guns", gunFields) ||
+		(json_find_first_label(root, "PseudoGuns") != NULL &&
+		 !JSONCheckClassList(
+			 root, VERSION, "PseudoGuns", "guns", gunFields)))
+	{
+		return false;
+	}
+	WeaponClasses loaded;
+	WeaponClassesInitialize(&loaded);
+	WeaponClassesLoadJSON(&loaded, &loaded.Guns, root);
+	int patched = 0;
+	int added = 0;
+	CA_FOREACH(WeaponClass, wc, loaded.Guns)
+	// Unused legacy gun slots
+	if (wc->name == NULL)
+	{
+		continue;
+	}
+	added++;
+	for (int i = 0; i < (int)wcs->Guns.size; i++)
+	{
+		WeaponClass *existing = CArrayGet(&wcs->Guns, i);
+		if (existing->name != NULL && strcmp(existing->name, wc->name) == 0)
+		{
+			WeaponClassTerminate(existing);
+			memcpy(existing, wc, sizeof *wc);
+			memset(wc, 0, sizeof *wc);
+			patched++;
+			added--;
+			break;
+		}
+	}
+	CA_FOREACH_END()
+	LOG(LM_MAIN, LL_INFO, "reloaded %d guns, %d new ignored", patched, added);
+	WeaponClassesTerminate(&loaded);
+	return true;
+}
 void WeaponClassesTerminate(WeaponClasses *wcs)
 {
 	WeaponClassesClear(&wcs->Guns);
@@ -421,6 +517,13 @@ const WeaponClass *StrWeaponClass(const char *s)
 	CA_FOREACH_END()
 	return NULL;
 }
+bool WeaponClassNameIsValid(const json_t *node)
+{
+	char *name = json_unescape(node->text);
+	const bool valid = StrWeaponClass(name) != NULL;
+	CFREE(name);
+	return valid;
+}
 WeaponClass *IdWeaponClass(const int i)
 {
 	CASSERT(
@@ -495,11 +598,11 @@ void WeaponClassAddBrass(
 	e.u.AddParticle.Z = (float)wc->u.Normal.MuzzleHeight;
 	e.u.AddParticle.Vel =
 		svec2_scale(Vec2FromRadians(radians + MPI_2), 0.333333f);
-	e.u.AddParticle.Vel.x += RAND_FLOAT(-0.25f, 0.25f);
-	e.u.AddParticle.Vel.y += RAND_FLOAT(-0.25f, 0.25f);
-	e.u.AddParticle.Angle = RAND_DOUBLE(0, MPI * 2);
-	e.u.AddParticle.DZ = (float)((rand() % 6) + 6);
-	e.u.AddParticle.Spin = RAND_DOUBLE(-0.1, 0.1);
+	e.u.AddParticle.Vel.x += RAND_FLOAT(RNG_COSMETIC, -0.25f, 0.25f);
+	e.u.AddParticle.Vel.y += RAND_FLOAT(RNG_COSMETIC, -0.25f, 0.25f);
+	e.u.AddParticle.Angle = RAND_DOUBLE(RNG_COSMETIC, 0, MPI * 2);
+	e.u.AddParticle.DZ = (float)RAND_INT(RNG_COSMETIC, 6, 12);
+	e.u.AddParticle.Spin = RAND_DOUBLE(RNG_COSMETIC, -0.1, 0.1);
 	GameEventsEnqueue(&gGameEvents, e);
 }
 
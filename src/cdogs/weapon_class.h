@@ -126,9 +126,13 @@ extern WeaponClasses gWeaponClasses;
 
 void WeaponClassesInitialize(WeaponClasses *wcs);
 void WeaponClassesLoadJSON(WeaponClasses *wcs, CArray *classes, json_t *root);
+// Update the guns from root in place, keeping pointers to them valid
+bool WeaponClassesReloadJSON(WeaponClasses *wcs, json_t *root);
 void WeaponClassesClear(CArray *classes);
 void WeaponClassesTerminate(WeaponClasses *wcs);
 const WeaponClass *StrWeaponClass(const char *s);
+// Whether a JSON string names a loaded gun
+bool WeaponClassNameIsValid(const json_t *node);
 WeaponClass *IdWeaponClass(const int i);
 int WeaponClassId(const WeaponClass *wc);
 struct vec2 WeaponClassGetBarrelMuzzleOffset(
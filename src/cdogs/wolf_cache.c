@@ -0,0 +1,384 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "wolf_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "files.h"
+#include "log.h"
+#include "sounds.h"
+#include "utils.h"
+
+#define ENTRY_MAGIC 0x43574443 // "CDWC"
+// Bump when the layout of an entry, or how anything in it is decoded,
+// changes
+#define ENTRY_VERSION 1
+#define ENTRY_EXT "cdogswolf"
+
+typedef struct
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t Key;
+	uint32_t NumLevels;
+	uint32_t NumSounds;
+	uint64_t Checksum; // of everything after the header
+} EntryHeader;
+// Followed by each level: the level header, a uint32 of whether it has a
+// player spawn, and a uint32 length and the bytes of each plane.
+// Then each sound: uint32 type, index and length, and the bytes.
+
+static void GetEntryPath(char *buf, const WolfCache *c)
+{
+	sprintf(buf, "%s/%016llx." ENTRY_EXT, c->Dir, (unsigned long long)c->Key);
+}
+
+static const char *sourceFiles[] = {
+	"MAPHEAD", "GAMEMAPS", "AUDIOHED", "AUDIOT", "VSWAP"};
+void WolfCacheInit(
+	WolfCache *c, const char *dir, const char *path, const int spearMission)
+{
+	memset(c, 0, sizeof *c);
+	CArrayInit(&c->Sounds, sizeof(WolfCacheSound));
+	if (dir == NULL)
+	{
+		return;
+	}
+	const char *ext = "WL1";
+	const char *ext1 = "WL1";
+	if (CWGetType(path, &ext, &ext1, spearMission) == CWMAPTYPE_UNKNOWN ||
+		!mkdir_deep(dir))
+	{
+		return;
+	}
+	// Also depends on the format sounds are converted to
+	const uint32_t format[] = {
+		CDOGS_SND_RATE, CDOGS_SND_FMT, CDOGS_SND_CHANNELS, ENTRY_VERSION};
+	uint64_t key = HashBytes(format, sizeof format, (uint64_t)spearMission);
+	for (int i = 0; i < (int)(sizeof sourceFiles / sizeof sourceFiles[0]);
+		 i++)
+	{
+		// Like CWLoad, try both extensions
+		char buf[CDOGS_PATH_MAX];
+		sprintf(buf, "%s/%s.%s", path, sourceFiles[i], ext);
+		long len;
+		char *data = ReadFileIntoBuf(buf, "rb", &len);
+		if (data == NULL)
+		{
+			sprintf(buf, "%s/%s.%s", path, sourceFiles[i], ext1);
+			data = ReadFileIntoBuf(buf, "rb", &len);
+		}
+		if (data == NULL)
+		{
+			return;
+		}
+		key = HashBytes(data, (size_t)len, key);
+		CFREE(data);
+	}
+	strcpy(c->Dir, dir);
+	c->Key = key;
+}
+static void CacheSoundTerminate(WolfCacheSound *s)
+{
+	CFREE(s->Data);
+}
+void WolfCacheTerminate(WolfCache *c)
+{
+	CA_FOREACH(WolfCacheSound, s, c->Sounds)
+	CacheSoundTerminate(s);
+	CA_FOREACH_END()
+	CArrayTerminate(&c->Sounds);
+	memset(c, 0, sizeof *c);
+}
+
+typedef struct
+{
+	const uint8_t *Ptr;
+	const uint8_t *End;
+} Reader;
+static bool ReadBytes(Reader *r, void *out, const size_t size)
+{
+	if ((size_t)(r->End - r->Ptr) < size)
+	{
+		return false;
+	}
+	memcpy(out, r->Ptr, size);
+	r->Ptr += size;
+	return true;
+}
+static bool ReadBlock(Reader *r, uint8_t **data, uint32_t *len)
+{
+	*data = NULL;
+	if (!ReadBytes(r, len, sizeof *len) || (size_t)(r->End - r->Ptr) < *len)
+	{
+		return false;
+	}
+	if (*len > 0)
+	{
+		CMALLOC(*data, *len);
+		ReadBytes(r, *data, *len);
+	}
+	return true;
+}
+static void FreeLevels(CWLevel *levels, const int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < NUM_PLANES; j++)
+		{
+			CFREE(levels[i].planes[j].plane);
+		}
+	}
+	CFREE(levels);
+}
+static bool ParseEntry(
+	WolfCache *c, const uint8_t *data, const size_t size, CWLevel **levels,
+	int *nLevels)
+{
+	const EntryHeader *h = (const EntryHeader *)data;
+	if (size < sizeof *h || h->Magic != ENTRY_MAGIC ||
+		h->Version != ENTRY_VERSION || h->Key != c->Key ||
+		HashBytes(data + sizeof *h, size - sizeof *h, 0) != h->Checksum)
+	{
+		return false;
+	}
+	Reader r = {data + sizeof *h, data + size};
+	*nLevels = 0;
+	CCALLOC(*levels, (h->NumLevels + 1) * sizeof **levels);
+	for (uint32_t i = 0; i < h->NumLevels; i++)
+	{
+		CWLevel *l = &(*levels)[i];
+		(*nLevels)++;
+		uint32_t hasPlayerSpawn;
+		if (!ReadBytes(&r, &l->header, sizeof l->header) ||
+			!ReadBytes(&r, &hasPlayerSpawn, sizeof hasPlayerSpawn))
+		{
+			return false;
+		}
+		l->hasPlayerSpawn = hasPlayerSpawn != 0;
+		for (int j = 0; j < NUM_PLANES; j++)
+		{
+			uint8_t *plane;
+			uint32_t len;
+			if (!ReadBlock(&r, &plane, &len))
+			{
+				return false;
+			}
+			l->planes[j].plane = (uint16_t *)plane;
+			l->planes[j].len = (int)len;
+		}
+	}
+	for (uint32_t i = 0; i < h->NumSounds; i++)
+	{
+		uint32_t type;
+		uint32_t index;
+		WolfCacheSound s;
+		if (!ReadBytes(&r, &type, sizeof type) ||
+			!ReadBytes(&r, &index, sizeof index) ||
+			!ReadBlock(&r, &s.Data, &s.Len))
+		{
+			return false;
+		}
+		s.Type = (WolfSoundType)type;
+		s.Index = (int)index;
+		CArrayPushBack(&c->Sounds, &s);
+	}
+	return r.Ptr == r.End;
+}
+bool WolfCacheLoad(WolfCache *c, CWolfMap *map)
+{
+	if (strlen(c->Dir) == 0)
+	{
+		return false;
+	}
+	char path[CDOGS_PATH_MAX];
+	GetEntryPath(path, c);
+	long len;
+	char *buf = ReadFileIntoBuf(path, "rb", &len);
+	if (buf == NULL)
+	{
+		c->Dirty = true;
+		return false;
+	}
+	CWLevel *levels = NULL;
+	int nLevels = 0;
+	const bool ok = ParseEntry(
+		c, (const uint8_t *)buf, (size_t)len, &levels, &nLevels);
+	CFREE(buf);
+	if (!ok)
+	{
+		LOG(LM_MAP, LL_WARN, "corrupt wolf cache entry %s", path);
+		FreeLevels(levels, nLevels);
+		CA_FOREACH(WolfCacheSound, s, c->Sounds)
+		CacheSoundTerminate(s);
+		CA_FOREACH_END()
+		CArrayClear(&c->Sounds);
+		remove(path);
+		c->Dirty = true;
+		return false;
+	}
+	map->levels = levels;
+	map->nLevels = nLevels;
+	LOG(LM_MAP, LL_DEBUG, "loaded wolf cache entry %s", path);
+	return true;
+}
+
+static size_t BlockSize(const uint32_t len)
+{
+	return sizeof len + len;
+}
+static uint8_t *WriteBytes(uint8_t *p, const void *data, const size_t size)
+{
+	if (size > 0)
+	{
+		memcpy(p, data, size);
+	}
+	return p + size;
+}
+static uint8_t *WriteBlock(uint8_t *p, const void *data, const uint32_t len)
+{
+	p = WriteBytes(p, &len, sizeof len);
+	return WriteBytes(p, data, len);
+}
+static uint32_t PlaneLen(const CWPlane *p)
+{
+	return p->plane != NULL ? (uint32_t)p->len : 0;
+}
+void WolfCacheStore(WolfCache *c, const CWolfMap *map)
+{
+	if (strlen(c->Dir) == 0 || !c->Dirty)
+	{
+		return;
+	}
+	size_t size = sizeof(EntryHeader);
+	for (int i = 0; i < map->nLevels; i++)
+	{
+		const CWLevel *l = &map->levels[i];
+		size += sizeof l->header + sizeof(uint32_t);
+		for (int j = 0; j < NUM_PLANES; j++)
+		{
+			size += BlockSize(PlaneLen(&l->planes[j]));
+		}
+	}
+	CA_FOREACH(const WolfCacheSound, s, c->Sounds)
+	size += 2 * sizeof(uint32_t) + BlockSize(s->Len);
+	CA_FOREACH_END()
+
+	uint8_t *data;
+	CMALLOC(data, size);
+	EntryHeader *h = (EntryHeader *)data;
+	memset(h, 0, sizeof *h);
+	h->Magic = ENTRY_MAGIC;
+	h->Version = ENTRY_VERSION;
+	h->Key = c->Key;
+	h->NumLevels = (uint32_t)map->nLevels;
+	h->NumSounds = (uint32_t)c->Sounds.size;
+	uint8_t *p = data + sizeof *h;
+	for (int i = 0; i < map->nLevels; i++)
+	{
+		const CWLevel *l = &map->levels[i];
+		const uint32_t hasPlayerSpawn = l->hasPlayerSpawn;
+		p = WriteBytes(p, &l->header, sizeof l->header);
+		p = WriteBytes(p, &hasPlayerSpawn, sizeof hasPlayerSpawn);
+		for (int j = 0; j < NUM_PLANES; j++)
+		{
+			const CWPlane *plane = &l->planes[j];
+			p = WriteBlock(p, plane->plane, PlaneLen(plane));
+		}
+	}
+	CA_FOREACH(const WolfCacheSound, s, c->Sounds)
+	const uint32_t type = (uint32_t)s->Type;
+	const uint32_t index = (uint32_t)s->Index;
+	p = WriteBytes(p, &type, sizeof type);
+	p = WriteBytes(p, &index, sizeof index);
+	p = WriteBlock(p, s->Data, s->Len);
+	CA_FOREACH_END()
+	CASSERT(p == data + size, "wolf cache entry size mismatch");
+	h->Checksum = HashBytes(data + sizeof *h, size - sizeof *h, 0);
+
+	// Write to a temporary file first so a partial entry is never loaded
+	char path[CDOGS_PATH_MAX];
+	GetEntryPath(path, c);
+	char tmp[CDOGS_PATH_MAX];
+	sprintf(tmp, "%s.tmp", path);
+	FILE *f = fopen(tmp, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot write wolf cache %s: %s", tmp,
+			strerror(errno));
+		goto bail;
+	}
+	const bool written = fwrite(data, 1, size, f) == size;
+	if (fclose(f) != 0 || !written)
+	{
+		LOG(LM_MAP, LL_WARN, "cannot write wolf cache %s", tmp);
+		remove(tmp);
+		goto bail;
+	}
+	remove(path);
+	if (rename(tmp, path) != 0)
+	{
+		remove(tmp);
+		goto bail;
+	}
+	c->Dirty = false;
+
+bail:
+	CFREE(data);
+}
+
+const WolfCacheSound *WolfCacheGetSound(
+	const WolfCache *c, const WolfSoundType type, const int index)
+{
+	CA_FOREACH(const WolfCacheSound, s, c->Sounds)
+	if (s->Type == type && s->Index == index)
+	{
+		return s;
+	}
+	CA_FOREACH_END()
+	return NULL;
+}
+void WolfCacheAddSound(
+	WolfCache *c, const WolfSoundType type, const int index,
+	const uint8_t *data, const uint32_t len)
+{
+	if (strlen(c->Dir) == 0)
+	{
+		return;
+	}
+	WolfCacheSound s;
+	s.Type = type;
+	s.Index = index;
+	s.Len = len;
+	CMALLOC(s.Data, len);
+	memcpy(s.Data, data, len);
+	CArrayPushBack(&c->Sounds, &s);
+	c->Dirty = true;
+}
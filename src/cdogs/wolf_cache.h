@@ -0,0 +1,84 @@
+/*
+	C-Dogs SDL
+	A port of the legendary (and fun) action/arcade cdogs.
+	Copyright (c) 2026 Cong Xu
+	All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	Redistributions of source code must retain the above copyright notice, this
+	list of conditions and the following disclaimer.
+	Redistributions in binary form must reproduce the above copyright notice,
+	this list of conditions and the following disclaimer in the documentation
+	and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "c_array.h"
+#include "cwolfmap/cwolfmap.h"
+#include "sys_config.h"
+
+typedef enum
+{
+	WOLF_SOUND_ADLIB,
+	WOLF_SOUND_DIGI
+} WolfSoundType;
+
+typedef struct
+{
+	WolfSoundType Type;
+	int Index;
+	uint8_t *Data; // in the mixer's format
+	uint32_t Len;
+} WolfCacheSound;
+
+// Imported Wolfenstein 3D and Spear of Destiny data, cached on disk so that
+// repeat imports skip decoding. An entry holds the expanded map planes and
+// the sounds, synthesized and converted to the mixer's format; it is named
+// by a key that hashes the game's source files, so changed files get a new
+// entry.
+typedef struct
+{
+	char Dir[CDOGS_PATH_MAX]; // empty to disable
+	uint64_t Key;
+	CArray Sounds; // of WolfCacheSound
+	// Whether there is anything new to store
+	bool Dirty;
+} WolfCache;
+
+// Set up the cache in dir for the game data at path, hashing the source
+// files; dir can be NULL to disable the cache
+void WolfCacheInit(
+	WolfCache *c, const char *dir, const char *path, const int spearMission);
+void WolfCacheTerminate(WolfCache *c);
+
+// Load the cached levels into map, and the cached sounds.
+// Returns false if there is no valid entry; map is unchanged.
+bool WolfCacheLoad(WolfCache *c, CWolfMap *map);
+// Store the map's levels and the cache's sounds, if anything is new
+void WolfCacheStore(WolfCache *c, const CWolfMap *map);
+
+// Get a cached sound; NULL if it isn't cached
+const WolfCacheSound *WolfCacheGetSound(
+	const WolfCache *c, const WolfSoundType type, const int index);
+// Add a decoded sound, copying the data
+void WolfCacheAddSound(
+	WolfCache *c, const WolfSoundType type, const int index,
+	const uint8_t *data, const uint32_t len);
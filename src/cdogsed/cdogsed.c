@@ -64,6 +64,7 @@
 #include <cdogs/font_utils.h>
 #include <cdogs/log.h>
 #include <cdogs/map_wolf.h>
+#include <cdogs/pic_manager.h>
 #include <cdogs/player_template.h>
 
 #include <tinydir/tinydir.h>
@@ -1163,6 +1164,7 @@ static void EditCampaign(void)
 		}
 
 		EventPoll(&gEventHandlers, ticksElapsed, NULL);
+		PicManagerUpdate(&gPicManager);
 		const SDL_Scancode sc = KeyGetPressed(&gEventHandlers.keyboard);
 		const int m = MouseGetPressed(&gEventHandlers.mouse);
 
@@ -1276,8 +1278,11 @@ int main(int argc, char *argv[])
 		exit(EXIT_FAILURE);
 	}
 	FontLoadFromJSON(&gFont, "graphics/font.png", "graphics/font.json");
-	PicManagerLoad(&gPicManager);
-	CharSpriteClassesInit(&gCharSpriteClasses);
+	AssetLoader assets;
+	AssetLoaderInit(&assets, -1);
+	PicManagerQueueLoad(&assets, &gPicManager);
+	CharSpriteClassesInitQueue(&gCharSpriteClasses, &assets);
+	AssetLoaderTerminate(&assets);
 
 	ParticleClassesInit(&gParticleClasses, "data/particles.json");
 	AmmoInitialize(&gAmmo, "data/ammo.json");
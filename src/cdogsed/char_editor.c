@@ -109,6 +109,18 @@ void CharEditor(
 	cc.Skin = colorSkin;
 	cc.Hair = colorRed;
 
+	// Generate the masked heads and hairs up front, as the textures are
+	// only loaded once
+	for (int i = 0; i < NumCharacterClasses(); i++)
+	{
+		GetHeadPic(IndexCharacterClass(i), DIRECTION_DOWN, false, &cc);
+	}
+	for (int i = 0; i < (int)gPicManager.hairstyleNames.size; i++)
+	{
+		GetHairPic(IndexHairName(i), DIRECTION_DOWN, false, &cc);
+	}
+	PicManagerWaitCharSprites(&gPicManager);
+
 	TexArrayInit(&ec.texIdsCharClasses, NumCharacterClasses());
 	CA_FOREACH(const GLuint, texid, ec.texIdsCharClasses)
 	const CharacterClass *c = IndexCharacterClass(_ca_index);
@@ -49,6 +49,7 @@
 #pragma warning(pop)
 #endif
 #include <cdogs/draw/draw_actor.h>
+#include <cdogs/pic_manager.h>
 #include <cdogs/sys_config.h>
 #include <nuklear/nuklear_sdl_gl2.h>
 
@@ -115,6 +116,7 @@ void NKWindow(NKWindowConfig cfg)
 		{
 			goto bail;
 		}
+		PicManagerUpdate(&gPicManager);
 		if (!Draw(cfg))
 		{
 			goto bail;
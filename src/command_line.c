@@ -27,6 +27,7 @@
 */
 #include "command_line.h"
 
+#include <limits.h>
 #include <stdio.h>
 
 #include <SDL_image.h>
@@ -98,7 +99,8 @@ void PrintHelp(void)
 		"%s\n",
 		"Other:\n"
 		"    --connect=host   (Experimental) connect to a game server\n"
-        "    --demo           (Experimental) run game for 30 seconds\n");
+        "    --demo           (Experimental) run game for 30 seconds\n"
+		"    --seed=n         Seed random numbers, for reproducible games\n");
 }
 
 void ProcessCommandLine(char *buf, const int argc, char *argv[])
@@ -122,7 +124,7 @@ void ProcessCommandLine(char *buf, const int argc, char *argv[])
 static void PrintConfig(const Config *c, const int indent);
 bool ParseArgs(
 	const int argc, char *argv[], ENetAddress *connectAddr,
-	const char **loadCampaign, int *demoQuitTimer)
+	const char **loadCampaign, int *demoQuitTimer, uint64_t *seed)
 {
 	struct option longopts[] = {
 		{"fullscreen", no_argument, NULL, 'f'},
@@ -133,6 +135,7 @@ bool ParseArgs(
 		{"log", required_argument, NULL, 1000},
 		{"logfile", required_argument, NULL, 1001},
         {"demo", no_argument, NULL, 1002},
+		{"seed", required_argument, NULL, 1003},
 		{"help", no_argument, NULL, 'h'},
 		{0, 0, NULL, 0}};
 	int opt = 0;
@@ -198,6 +201,12 @@ bool ParseArgs(
             *demoQuitTimer = 30 * 1000;
             printf("Entering demo mode; will auto-quit in 30 seconds\n");
             break;
+		case 1003:
+			// Seeds the campaign maps as well as everything else
+			*seed = (uint64_t)strtoull(optarg, NULL, 10);
+			ConfigSetInt(&gConfig, "Game.RandomSeed", (int)(*seed & INT_MAX));
+			printf("Random seed: %s\n", optarg);
+			break;
 		case 'x':
 			if (enet_address_set_host(connectAddr, optarg) != 0)
 			{
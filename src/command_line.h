@@ -28,6 +28,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <enet/enet.h>
 
@@ -41,4 +42,5 @@ void ProcessCommandLine(char *buf, const int argc, char *argv[]);
 // Parse command-line arguments and set config. Returns whether to run the game
 bool ParseArgs(
 	const int argc, char *argv[],
-	ENetAddress *connectAddr, const char **loadCampaign, int *demoQuitTimer);
+	ENetAddress *connectAddr, const char **loadCampaign, int *demoQuitTimer,
+	uint64_t *seed);
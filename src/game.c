@@ -55,6 +55,7 @@
 #include <cdogs/ai.h>
 #include <cdogs/ai_coop.h>
 #include <cdogs/automap.h>
+#include <cdogs/draw/draw_actor.h>
 #include <cdogs/draw/drawtools.h>
 #include <cdogs/events.h>
 #include <cdogs/grafx_bg.h>
@@ -66,6 +67,7 @@
 #include <cdogs/net_client.h>
 #include <cdogs/net_server.h>
 #include <cdogs/objs.h>
+#include <cdogs/pic_manager.h>
 #include <cdogs/pickup.h>
 
 #include "briefing_screens.h"
@@ -127,6 +129,7 @@ GameLoopData *RunGame(Campaign *co, struct MissionOptions *m, Map *map)
 	g->FPS = ConfigGetInt(&gConfig, "Game.FPS");
 	g->SuperhotMode = ConfigGetBool(&gConfig, "Game.Superhot(tm)Mode");
 	g->InputEverySecondFrame = true;
+	g->ThreadedUpdate = ConfigGetBool(&gConfig, "Graphics.ThreadedRender");
 	return g;
 }
 static void RunGameReset(RunGameData *rData)
@@ -142,23 +145,31 @@ static void RunGameTerminate(GameLoopData *data)
 
 	CFREE(rData);
 }
+static void PreloadSprites(const Campaign *co);
 static void RunGameOnEnter(GameLoopData *data)
 {
 	RunGameData *rData = data->Data;
 
 	RunGameReset(rData);
 
+	// Draw the PVP seed from the running simulation, before it is reset
+	// for the map, so that it is still reproducible from the startup seed
+	const uint32_t pvpSeed = RngNext(RNG_GAMEPLAY);
 	CampaignSeedRandom(rData->co);
+	MapBuildSetProgress(LoadingScreenMapBuildProgress, &gLoadingScreen);
 	MapBuild(
 		rData->map, rData->m->missionData, !rData->co->IsClient,
 		rData->m->index, rData->co->Entry.Mode,
 		&rData->co->Setting.characters);
+	MapBuildSetProgress(NULL, NULL);
+	SoundOcclusionInvalidate(&gSoundDevice.occlusion);
 
-	// Seed random if PVP mode (otherwise players will always spawn in same
-	// position)
+	// Reseed the simulation if PVP mode (otherwise players will always spawn
+	// in same position)
 	if (IsPVP(rData->co->Entry.Mode))
 	{
-		srand((unsigned int)time(NULL));
+		RngSeed(RNG_GAMEPLAY, pvpSeed);
+		RngSeed(RNG_AI, pvpSeed);
 	}
 
 	if (!rData->co->IsClient)
@@ -218,6 +229,8 @@ static void RunGameOnEnter(GameLoopData *data)
 		}
 	}
 
+	PreloadSprites(rData->co);
+
 	rData->m->state = MISSION_STATE_WAITING;
 	rData->m->isDone = false;
 	rData->m->DoneCounter = 0;
@@ -251,6 +264,22 @@ static void RunGameOnEnter(GameLoopData *data)
 	e.u.SetMessage.Ticks = 3000;
 	GameEventsEnqueue(&gGameEvents, e);
 }
+static void PreloadSprites(const Campaign *co)
+{
+	// Mask the sprites of every character known at mission start, so that
+	// they don't have to be generated when first drawn
+	CA_FOREACH(const PlayerData, p, gPlayerDatas)
+	PreloadCharacterSprites(&p->Char, NULL);
+	for (int i = 0; i < MAX_WEAPONS; i++)
+	{
+		PreloadCharacterSprites(&p->Char, p->guns[i]);
+	}
+	CA_FOREACH_END()
+	CA_FOREACH(const Character, c, co->Setting.characters.OtherChars)
+	PreloadCharacterSprites(c, c->Gun);
+	CA_FOREACH_END()
+	PicManagerWaitCharSprites(&gPicManager);
+}
 static void RunGameOnExit(GameLoopData *data)
 {
 	RunGameData *rData = data->Data;
@@ -433,7 +462,19 @@ static void RunGameInput(GameLoopData *data)
 }
 static void NextLoop(RunGameData *rData, LoopRunner *l);
 static void CheckMissionCompletion(const struct MissionOptions *mo);
+static GameLoopResult UpdateGame(GameLoopData *data, LoopRunner *l);
 static GameLoopResult RunGameUpdate(GameLoopData *data, LoopRunner *l)
+{
+	const GameLoopResult result = UpdateGame(data, l);
+	// Once the mission is done, the next updates will change loops, which
+	// must happen on the main thread
+	const RunGameData *rData = data->Data;
+	data->ThreadedUpdate =
+		!rData->m->isDone &&
+		ConfigGetBool(&gConfig, "Graphics.ThreadedRender");
+	return result;
+}
+static GameLoopResult UpdateGame(GameLoopData *data, LoopRunner *l)
 {
 	RunGameData *rData = data->Data;
 
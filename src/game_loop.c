@@ -28,12 +28,18 @@
 */
 #include "game_loop.h"
 
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
 #include <SDL_timer.h>
 
 #include "config.h"
 #include "events.h"
+#include "hot_reload.h"
+#include "log.h"
 #include "net_client.h"
 #include "net_server.h"
+#include "pic_manager.h"
+#include "render_queue.h"
 #include "sounds.h"
 
 #ifdef __EMSCRIPTEN__
@@ -183,15 +189,41 @@ typedef struct
 	int FramesSkipped;
 	int MaxFrameskip;
 } LoopRunParams;
+// Runs a loop's update on another thread, while the main thread submits
+// the previously recorded frame
+typedef struct
+{
+	SDL_Thread *thread;
+	SDL_mutex *lock;
+	SDL_cond *cond;
+	LoopRunner *l;
+	GameLoopData *data;
+	GameLoopResult result;
+	bool busy;
+	bool quit;
+} UpdateWorker;
 typedef struct
 {
 	LoopRunner *l;
 	GameLoopData *data;
 	LoopRunParams p;
+	UpdateWorker *worker;
+	// A frame has been recorded to gRenderQueue but not yet submitted
+	bool drawPending;
 } LoopRunInnerData;
 static LoopRunParams LoopRunParamsNew(const GameLoopData *data);
 static bool LoopRunParamsShouldSleep(LoopRunParams *p);
 static bool LoopRunParamsShouldSkip(LoopRunParams *p);
+#ifndef __EMSCRIPTEN__
+static void UpdateWorkerInit(UpdateWorker *w);
+static void UpdateWorkerTerminate(UpdateWorker *w);
+#endif
+static void UpdateWorkerStart(
+	UpdateWorker *w, GameLoopData *data, LoopRunner *l);
+static GameLoopResult UpdateWorkerWait(UpdateWorker *w);
+static void DrawLoops(LoopRunInnerData *ctx);
+static void RenderBegin(void);
+static void RenderEnd(GameLoopData *data);
 bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 {
 #ifndef __EMSCRIPTEN__
@@ -217,7 +249,22 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 	NetServerPoll(&gNetServer);
 
 	// Update
-	ctx->p.Result = ctx->data->UpdateFunc(ctx->data, ctx->l);
+	if (ctx->drawPending)
+	{
+		// Submit the recorded frame while the next update runs
+		UpdateWorkerStart(ctx->worker, ctx->data, ctx->l);
+		RenderBegin();
+		RenderQueueSubmit(&gRenderQueue);
+		RenderEnd(ctx->data);
+		ctx->p.Result = UpdateWorkerWait(ctx->worker);
+		ctx->drawPending = false;
+	}
+	else
+	{
+		ctx->p.Result = ctx->data->UpdateFunc(ctx->data, ctx->l);
+	}
+	// Ears are set by now; play this update's sounds
+	SoundFlush(&gSoundDevice);
 	GameLoopData *newData = GetCurrentLoop(ctx->l);
 	if (newData == NULL)
 	{
@@ -261,6 +308,8 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 		break;
 	}
 	ctx->data->Frames++;
+	// Nothing is using the classes between frames
+	HotReloadUpdate(&gHotReload, 1);
 #ifndef __EMSCRIPTEN__
 	// frame skip
 	if (LoopRunParamsShouldSkip(&(ctx->p)))
@@ -272,34 +321,60 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 	// Draw
 	if (draw)
 	{
-		WindowContextPreRender(&gGraphicsDevice.gameWindow);
-		if (gGraphicsDevice.cachedConfig.SecondWindow)
-		{
-			WindowContextPreRender(&gGraphicsDevice.secondWindow);
-		}
-		if (ctx->data->DrawParent)
+		PicManagerUpdate(&gPicManager);
+		if (ctx->worker != NULL && ctx->data->ThreadedUpdate)
 		{
-			GameLoopData *parent = GetParentLoop(ctx->l);
-			if (parent && parent->DrawFunc)
-			{
-				GameLoopOnEnter(parent);
-				parent->DrawFunc(parent);
-			}
+			// Record now, from the live game state; only submitting the
+			// recorded frame overlaps the next update, so recording is
+			// still on the update's critical path
+			RenderQueueBegin(&gRenderQueue);
+			DrawLoops(ctx);
+			RenderQueueEnd(&gRenderQueue);
+			ctx->drawPending = true;
 		}
-		if (ctx->data->DrawFunc)
-		{
-			ctx->data->DrawFunc(ctx->data);
-		}
-		WindowContextPostRender(&gGraphicsDevice.gameWindow);
-		if (gGraphicsDevice.cachedConfig.SecondWindow)
+		else
 		{
-			WindowContextPostRender(&gGraphicsDevice.secondWindow);
+			RenderBegin();
+			DrawLoops(ctx);
+			RenderEnd(ctx->data);
 		}
-		ctx->data->HasDrawnFirst = true;
 	}
 
 	return true;
 }
+static void DrawLoops(LoopRunInnerData *ctx)
+{
+	if (ctx->data->DrawParent)
+	{
+		GameLoopData *parent = GetParentLoop(ctx->l);
+		if (parent && parent->DrawFunc)
+		{
+			GameLoopOnEnter(parent);
+			parent->DrawFunc(parent);
+		}
+	}
+	if (ctx->data->DrawFunc)
+	{
+		ctx->data->DrawFunc(ctx->data);
+	}
+}
+static void RenderBegin(void)
+{
+	WindowContextPreRender(&gGraphicsDevice.gameWindow);
+	if (gGraphicsDevice.cachedConfig.SecondWindow)
+	{
+		WindowContextPreRender(&gGraphicsDevice.secondWindow);
+	}
+}
+static void RenderEnd(GameLoopData *data)
+{
+	WindowContextPostRender(&gGraphicsDevice.gameWindow);
+	if (gGraphicsDevice.cachedConfig.SecondWindow)
+	{
+		WindowContextPostRender(&gGraphicsDevice.secondWindow);
+	}
+	data->HasDrawnFirst = true;
+}
 
 #ifdef __EMSCRIPTEN__
 void EmscriptenMainLoop(void *arg)
@@ -323,11 +398,19 @@ void LoopRunnerRun(LoopRunner *l)
 	ctx.l = l;
 	ctx.data = data;
 	ctx.p = LoopRunParamsNew(data);
+	ctx.worker = NULL;
+	ctx.drawPending = false;
 
 #ifdef __EMSCRIPTEN__
 	// TODO use GameLoopData->FPS instead of FPS_FRAMELIMIT?
 	emscripten_set_main_loop_arg(EmscriptenMainLoop, &ctx, FPS_FRAMELIMIT, 1);
 #else
+	UpdateWorker worker;
+	UpdateWorkerInit(&worker);
+	if (worker.thread != NULL)
+	{
+		ctx.worker = &worker;
+	}
 	for (;;)
 	{
 		if (!LoopRunnerRunInner(&ctx))
@@ -335,9 +418,90 @@ void LoopRunnerRun(LoopRunner *l)
 			break;
 		}
 	}
+	UpdateWorkerTerminate(&worker);
 #endif
 	GameLoopOnExit(ctx.data);
 }
+
+#ifndef __EMSCRIPTEN__
+static int UpdateWorkerRun(void *arg)
+{
+	UpdateWorker *w = arg;
+	SDL_LockMutex(w->lock);
+	for (;;)
+	{
+		while (!w->quit && !w->busy)
+		{
+			SDL_CondWait(w->cond, w->lock);
+		}
+		if (w->quit)
+		{
+			break;
+		}
+		SDL_UnlockMutex(w->lock);
+
+		const GameLoopResult result = w->data->UpdateFunc(w->data, w->l);
+
+		SDL_LockMutex(w->lock);
+		w->result = result;
+		w->busy = false;
+		SDL_CondBroadcast(w->cond);
+	}
+	SDL_UnlockMutex(w->lock);
+	return 0;
+}
+static void UpdateWorkerInit(UpdateWorker *w)
+{
+	memset(w, 0, sizeof *w);
+	w->lock = SDL_CreateMutex();
+	w->cond = SDL_CreateCond();
+	if (w->lock != NULL && w->cond != NULL)
+	{
+		w->thread = SDL_CreateThread(UpdateWorkerRun, "Update", w);
+	}
+	if (w->thread == NULL)
+	{
+		// Fall back to updating and drawing serially
+		LOG(LM_MAIN, LL_WARN, "cannot create update thread: %s",
+			SDL_GetError());
+	}
+}
+static void UpdateWorkerTerminate(UpdateWorker *w)
+{
+	if (w->thread != NULL)
+	{
+		SDL_LockMutex(w->lock);
+		w->quit = true;
+		SDL_CondBroadcast(w->cond);
+		SDL_UnlockMutex(w->lock);
+		SDL_WaitThread(w->thread, NULL);
+	}
+	SDL_DestroyCond(w->cond);
+	SDL_DestroyMutex(w->lock);
+	memset(w, 0, sizeof *w);
+}
+#endif
+static void UpdateWorkerStart(
+	UpdateWorker *w, GameLoopData *data, LoopRunner *l)
+{
+	SDL_LockMutex(w->lock);
+	w->data = data;
+	w->l = l;
+	w->busy = true;
+	SDL_CondBroadcast(w->cond);
+	SDL_UnlockMutex(w->lock);
+}
+static GameLoopResult UpdateWorkerWait(UpdateWorker *w)
+{
+	SDL_LockMutex(w->lock);
+	while (w->busy)
+	{
+		SDL_CondWait(w->cond, w->lock);
+	}
+	const GameLoopResult result = w->result;
+	SDL_UnlockMutex(w->lock);
+	return result;
+}
 static LoopRunParams LoopRunParamsNew(const GameLoopData *data)
 {
 	LoopRunParams p;
@@ -65,6 +65,9 @@ typedef struct sGameLoopData
 	bool HasDrawnFirst;
 	bool IsUsed;
 	bool DrawParent;
+	// Update can run on a worker thread while the last frame is submitted;
+	// set by loops whose update won't touch the renderer or change loops
+	bool ThreadedUpdate;
 } GameLoopData;
 
 GameLoopData *GameLoopDataNew(
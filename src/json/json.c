@@ -186,54 +186,996 @@ rcs_length (rcstring * rcs)
 /* end of rc_string part */
 
 
-enum json_error
-json_stream_parse (FILE * file, json_t ** document)
+/* arena DOM parser */
+
+#define JSON_ARENA_ALIGN 16
+#define JSON_ARENA_ROUND(x) (((x) + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1))
+#define JSON_ARENA_MIN_BLOCK 4096
+#define JSON_MAX_DEPTH 1024
+
+struct json_arena_block
 {
-	char buffer[1024];	/* hard-coded value */
-	unsigned int error = JSON_INCOMPLETE_DOCUMENT;
+	struct json_arena_block *next;
+	size_t size;	/*<! usable bytes following the header */
+	size_t used;
+};
 
-	struct json_parsing_info state;
+#define JSON_ARENA_HEADER JSON_ARENA_ROUND (sizeof (struct json_arena_block))
+
+struct json_arena
+{
+	struct json_arena_block *blocks;	/*<! most recently allocated block first */
+	json_t *root;	/*<! the node which owns the arena */
+	int mixed;	/*<! nodes not belonging to the arena were inserted into the tree */
+};
+
+
+static struct json_arena_block *
+json_arena_block_new (size_t size)
+{
+	struct json_arena_block *block = malloc (JSON_ARENA_HEADER + size);
+	if (block == NULL)
+		return NULL;
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
+
+
+/* the arena itself lives at the start of its first block */
+static struct json_arena *
+json_arena_new (size_t size)
+{
+	struct json_arena *arena;
+	struct json_arena_block *block;
+
+	if (size < JSON_ARENA_MIN_BLOCK)
+		size = JSON_ARENA_MIN_BLOCK;
+	block = json_arena_block_new (JSON_ARENA_ROUND (sizeof (struct json_arena)) + size);
+	if (block == NULL)
+		return NULL;
+	arena = (struct json_arena *) ((char *) block + JSON_ARENA_HEADER);
+	block->used = JSON_ARENA_ROUND (sizeof (struct json_arena));
+	arena->blocks = block;
+	arena->root = NULL;
+	arena->mixed = 0;
+	return arena;
+}
+
+
+static void *
+json_arena_alloc (struct json_arena *arena, size_t size)
+{
+	struct json_arena_block *block = arena->blocks;
+	void *p;
+
+	size = JSON_ARENA_ROUND (size);
+	if (block->size - block->used < size)
+	{
+		size_t block_size = block->size * 2;
+		if (block_size < size)
+			block_size = size;
+		block = json_arena_block_new (block_size);
+		if (block == NULL)
+			return NULL;
+		block->next = arena->blocks;
+		arena->blocks = block;
+	}
+	p = (char *) block + JSON_ARENA_HEADER + block->used;
+	block->used += size;
+	return p;
+}
+
+
+static void
+json_arena_free (struct json_arena *arena)
+{
+	struct json_arena_block *block = arena->blocks;
+	while (block != NULL)
+	{
+		struct json_arena_block *next = block->next;
+		free (block);
+		block = next;
+	}
+}
+
+
+/* label index */
+
+#define JSON_INDEX_MIN_MEMBERS 6
+
+struct json_index_slot
+{
+	uint32_t hash;
+	json_t *label;	/*<! NULL if the slot is empty */
+};
+
+struct json_index
+{
+	size_t mask;	/*<! number of slots minus one; the number of slots is a power of two */
+	struct json_index_slot slots[1];
+};
+
+
+/* labels passed with this length are null-terminated */
+#define JSON_LABEL_TERMINATED ((size_t)-1)
+
+
+static int
+json_label_equals (const char *text, const char *text_label, size_t length)
+{
+	if (length == JSON_LABEL_TERMINATED)
+		return strcmp (text, text_label) == 0;
+	return strncmp (text, text_label, length) == 0 && text[length] == '\0';
+}
+
+
+/* FNV-1a */
+static uint32_t
+json_index_hash (const char *text, size_t length)
+{
+	uint32_t hash = 2166136261u;
+	size_t i;
+	for (i = 0; i < length && text[i] != '\0'; i++)
+	{
+		hash ^= (unsigned char) text[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+static json_t *
+json_index_find (const struct json_index *index, const char *text_label, size_t length)
+{
+	const uint32_t hash = json_index_hash (text_label, length);
+	size_t i;
+	for (i = hash & index->mask;; i = (i + 1) & index->mask)
+	{
+		const struct json_index_slot *slot = &index->slots[i];
+		if (slot->label == NULL)
+			return NULL;
+		if (slot->hash == hash && json_label_equals (slot->label->text, text_label, length))
+			return slot->label;
+	}
+}
 
-	assert (file != NULL);	/* must be an open stream */
-	assert (document != NULL);	/* must be a valid pointer reference */
-	assert (*document == NULL);	/* only accepts a null json_t pointer, to avoid memory leaks */
 
-	json_jpi_init (&state);	/* initializes the json_parsing_info object */
+/* indexes from arena nodes live in the arena; others are freed by json_index_drop */
+static void
+json_index_build (json_t * object)
+{
+	struct json_index *index;
+	size_t count = 0;
+	size_t slots = 1;
+	size_t size;
+	json_t *cursor;
 
-	while ((error == JSON_WAITING_FOR_EOF) || (error == JSON_INCOMPLETE_DOCUMENT))
+	for (cursor = object->child; cursor != NULL; cursor = cursor->next)
+		count++;
+	/* keep the table at most half full */
+	while (slots < count * 2)
+		slots *= 2;
+	size = sizeof (struct json_index) + (slots - 1) * sizeof (struct json_index_slot);
+	if (object->arena != NULL)
+		index = json_arena_alloc (object->arena, size);
+	else
+		index = malloc (size);
+	if (index == NULL)
+		return;	/* lookups will stay linear */
+	memset (index, 0, size);
+	index->mask = slots - 1;
+
+	for (cursor = object->child; cursor != NULL; cursor = cursor->next)
 	{
-		if (fgets (buffer, 1024, file) != NULL)
+		const uint32_t hash = json_index_hash (cursor->text, JSON_LABEL_TERMINATED);
+		size_t i;
+		for (i = hash & index->mask; index->slots[i].label != NULL; i = (i + 1) & index->mask)
 		{
-			switch (error = json_parse_fragment (&state, buffer))
-			{
-			case JSON_OK:
-			case JSON_WAITING_FOR_EOF:
-			case JSON_INCOMPLETE_DOCUMENT:
+			if (index->slots[i].hash == hash && strcmp (index->slots[i].label->text, cursor->text) == 0)
 				break;
+		}
+		/* duplicate labels: the first one is found, as with a linear search */
+		if (index->slots[i].label == NULL)
+		{
+			index->slots[i].hash = hash;
+			index->slots[i].label = cursor;
+		}
+	}
+	object->index = index;
+}
 
-			default:
-				json_free_value (&state.cursor);
-				return error;
-				break;
-			}
+
+/* indexes are built when a document is parsed, so that lookups don't change the tree */
+static void
+json_index_build_if_large (json_t * object)
+{
+	size_t count = 0;
+	json_t *cursor;
+
+	for (cursor = object->child; cursor != NULL && count < JSON_INDEX_MIN_MEMBERS; cursor = cursor->next)
+		count++;
+	if (count >= JSON_INDEX_MIN_MEMBERS)
+		json_index_build (object);
+}
+
+
+/* must be called whenever an object's members change */
+static void
+json_index_drop (json_t * object)
+{
+	if (object->index == NULL)
+		return;
+	if (object->arena == NULL)
+		free (object->index);
+	object->index = NULL;
+}
+
+
+struct json_dom_parser
+{
+	const char *p;
+	const char *end;
+	size_t line;
+	unsigned int depth;
+	struct json_arena *arena;
+};
+
+
+static void
+json_dom_skip_white_spaces (struct json_dom_parser *dp)
+{
+	while (dp->p < dp->end)
+	{
+		switch (*dp->p)
+		{
+		case '\x20':	/* space */
+		case '\x09':	/* horizontal tab */
+			break;
+		case '\x0A':	/* line feed or new line */
+		case '\x0D':	/* Carriage return */
+			dp->line++;
+			break;
+		default:
+			return;
 		}
+		dp->p++;
+	}
+}
+
+
+static json_t *
+json_dom_new_node (struct json_dom_parser *dp, const enum json_value_type type, json_t * parent)
+{
+	json_t *node = json_arena_alloc (dp->arena, sizeof (json_t));
+	if (node == NULL)
+		return NULL;
+
+	node->type = type;
+	node->text = NULL;
+	node->number = 0;
+	node->arena = dp->arena;
+	node->index = NULL;
+	node->visited = JSON_VISIT_UNTRACKED;
+	node->next = NULL;
+	node->parent = parent;
+	node->child = NULL;
+	node->child_end = NULL;
+	if (parent == NULL)
+	{
+		node->previous = NULL;
+	}
+	else
+	{
+		node->previous = parent->child_end;
+		if (parent->child_end != NULL)
+			parent->child_end->next = node;
 		else
+			parent->child = node;
+		parent->child_end = node;
+	}
+	return node;
+}
+
+
+static char *
+json_dom_copy_text (struct json_dom_parser *dp, const char *text, size_t length)
+{
+	char *copy = json_arena_alloc (dp->arena, length + 1);
+	if (copy == NULL)
+		return NULL;
+	memcpy (copy, text, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+
+static enum json_error
+json_dom_error (const struct json_dom_parser *dp)
+{
+	if (dp->p >= dp->end)
+		return JSON_INCOMPLETE_DOCUMENT;
+	fprintf (stderr, "JSON: unexpected character '%c' at line %ld\n", *dp->p, (long)dp->line);
+	return JSON_MALFORMED_DOCUMENT;
+}
+
+
+static int
+json_dom_is_hex (const char c)
+{
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+
+/* strings keep their escape sequences, as with the fragment parser; use json_unescape() to decode them */
+static enum json_error
+json_dom_parse_string (struct json_dom_parser *dp, char **text)
+{
+	const char *start;
+
+	assert (*dp->p == '\"');
+	start = ++dp->p;
+	for (;;)
+	{
+		unsigned char c;
+		if (dp->p >= dp->end)
+			return JSON_INCOMPLETE_DOCUMENT;
+		c = (unsigned char) *dp->p;
+		if (c == '\"')
+			break;
+		if (c < 0x20)
 		{
-			if (error == JSON_WAITING_FOR_EOF)
-				error = JSON_OK;
-			else
+			/* ASCII control characters can only be present in a JSON string if they are escaped */
+			return json_dom_error (dp);
+		}
+		dp->p++;
+		if (c != '\\')
+			continue;
+		if (dp->p >= dp->end)
+			return JSON_INCOMPLETE_DOCUMENT;
+		switch (*dp->p)
+		{
+		case '\\':
+		case '\"':
+		case '/':
+		case 'b':
+		case 'f':
+		case 'n':
+		case 'r':
+		case 't':
+			dp->p++;
+			break;
+
+		case 'u':
 			{
-				/*TODO refine this error code */
-				error = JSON_UNKNOWN_PROBLEM;
+				int i;
+				dp->p++;
+				for (i = 0; i < 4; i++, dp->p++)
+				{
+					if (dp->p >= dp->end)
+						return JSON_INCOMPLETE_DOCUMENT;
+					if (!json_dom_is_hex (*dp->p))
+						return json_dom_error (dp);
+				}
 			}
+			break;
+
+		default:
+			return json_dom_error (dp);
+		}
+	}
+	*text = json_dom_copy_text (dp, start, (size_t) (dp->p - start));
+	if (*text == NULL)
+		return JSON_MEMORY;
+	dp->p++;	/* closing quote */
+	return JSON_OK;
+}
+
+
+static int
+json_dom_is_digit (const struct json_dom_parser *dp)
+{
+	return dp->p < dp->end && *dp->p >= '0' && *dp->p <= '9';
+}
+
+
+static enum json_error
+json_dom_parse_number (struct json_dom_parser *dp, json_t * node)
+{
+	const char *start = dp->p;
+	int is_integer = 1;
+	double value = 0;
+
+	if (*dp->p == '-')
+		dp->p++;
+	if (!json_dom_is_digit (dp))
+		return json_dom_error (dp);
+	if (*dp->p == '0')
+	{
+		dp->p++;
+	}
+	else
+	{
+		while (json_dom_is_digit (dp))
+		{
+			value = value * 10 + (*dp->p - '0');
+			dp->p++;
 		}
 	}
+	if (dp->p < dp->end && *dp->p == '.')
+	{
+		is_integer = 0;
+		dp->p++;
+		if (!json_dom_is_digit (dp))
+			return json_dom_error (dp);
+		while (json_dom_is_digit (dp))
+			dp->p++;
+	}
+	if (dp->p < dp->end && (*dp->p == 'e' || *dp->p == 'E'))
+	{
+		is_integer = 0;
+		dp->p++;
+		if (dp->p < dp->end && (*dp->p == '+' || *dp->p == '-'))
+			dp->p++;
+		if (!json_dom_is_digit (dp))
+			return json_dom_error (dp);
+		while (json_dom_is_digit (dp))
+			dp->p++;
+	}
+
+	node->text = json_dom_copy_text (dp, start, (size_t) (dp->p - start));
+	if (node->text == NULL)
+		return JSON_MEMORY;
+	/* integers of up to 15 digits are exact in a double; leave the rest to strtod */
+	if (is_integer && dp->p - start <= 15)
+		node->number = *start == '-' ? -value : value;
+	else
+		node->number = strtod (node->text, NULL);
+	return JSON_OK;
+}
+
+
+static enum json_error
+json_dom_parse_literal (struct json_dom_parser *dp, const char *literal, size_t length)
+{
+	size_t i;
+	for (i = 0; i < length; i++, dp->p++)
+	{
+		if (dp->p >= dp->end)
+			return JSON_INCOMPLETE_DOCUMENT;
+		if (*dp->p != literal[i])
+			return json_dom_error (dp);
+	}
+	return JSON_OK;
+}
+
+
+static enum json_error json_dom_parse_value (struct json_dom_parser *dp, json_t * parent, json_t ** value);
+
+
+static enum json_error
+json_dom_parse_object (struct json_dom_parser *dp, json_t * object)
+{
+	enum json_error error;
 
+	dp->p++;	/* '{' */
+	json_dom_skip_white_spaces (dp);
+	if (dp->p < dp->end && *dp->p == '}')
+	{
+		dp->p++;
+		return JSON_OK;
+	}
+	for (;;)
+	{
+		json_t *label;
+
+		if (dp->p >= dp->end || *dp->p != '\"')
+			return json_dom_error (dp);
+		if ((label = json_dom_new_node (dp, JSON_STRING, object)) == NULL)
+			return JSON_MEMORY;
+		if ((error = json_dom_parse_string (dp, &label->text)) != JSON_OK)
+			return error;
+
+		json_dom_skip_white_spaces (dp);
+		if (dp->p >= dp->end || *dp->p != ':')
+			return json_dom_error (dp);
+		dp->p++;
+		json_dom_skip_white_spaces (dp);
+		if ((error = json_dom_parse_value (dp, label, NULL)) != JSON_OK)
+			return error;
+
+		json_dom_skip_white_spaces (dp);
+		if (dp->p >= dp->end)
+			return JSON_INCOMPLETE_DOCUMENT;
+		if (*dp->p == '}')
+		{
+			dp->p++;
+			json_index_build_if_large (object);
+			return JSON_OK;
+		}
+		if (*dp->p != ',')
+			return json_dom_error (dp);
+		dp->p++;
+		json_dom_skip_white_spaces (dp);
+	}
+}
+
+
+static enum json_error
+json_dom_parse_array (struct json_dom_parser *dp, json_t * array)
+{
+	enum json_error error;
+
+	dp->p++;	/* '[' */
+	json_dom_skip_white_spaces (dp);
+	if (dp->p < dp->end && *dp->p == ']')
+	{
+		dp->p++;
+		return JSON_OK;
+	}
+	for (;;)
+	{
+		if ((error = json_dom_parse_value (dp, array, NULL)) != JSON_OK)
+			return error;
+
+		json_dom_skip_white_spaces (dp);
+		if (dp->p >= dp->end)
+			return JSON_INCOMPLETE_DOCUMENT;
+		if (*dp->p == ']')
+		{
+			dp->p++;
+			return JSON_OK;
+		}
+		if (*dp->p != ',')
+			return json_dom_error (dp);
+		dp->p++;
+		json_dom_skip_white_spaces (dp);
+	}
+}
+
+
+static enum json_error
+json_dom_parse_value (struct json_dom_parser *dp, json_t * parent, json_t ** value)
+{
+	enum json_error error;
+	json_t *node;
+
+	if (dp->p >= dp->end)
+		return JSON_INCOMPLETE_DOCUMENT;
+	switch (*dp->p)
+	{
+	case '{':
+	case '[':
+		if (dp->depth >= JSON_MAX_DEPTH)
+		{
+			fprintf (stderr, "JSON: document nested too deeply at line %ld\n", (long)dp->line);
+			return JSON_MALFORMED_DOCUMENT;
+		}
+		if ((node = json_dom_new_node (dp, *dp->p == '{' ? JSON_OBJECT : JSON_ARRAY, parent)) == NULL)
+			return JSON_MEMORY;
+		dp->depth++;
+		error = node->type == JSON_OBJECT ? json_dom_parse_object (dp, node) : json_dom_parse_array (dp, node);
+		dp->depth--;
+		break;
+
+	case '\"':
+		if ((node = json_dom_new_node (dp, JSON_STRING, parent)) == NULL)
+			return JSON_MEMORY;
+		error = json_dom_parse_string (dp, &node->text);
+		break;
+
+	case 't':
+		if ((node = json_dom_new_node (dp, JSON_TRUE, parent)) == NULL)
+			return JSON_MEMORY;
+		error = json_dom_parse_literal (dp, "true", 4);
+		break;
+
+	case 'f':
+		if ((node = json_dom_new_node (dp, JSON_FALSE, parent)) == NULL)
+			return JSON_MEMORY;
+		error = json_dom_parse_literal (dp, "false", 5);
+		break;
+
+	case 'n':
+		if ((node = json_dom_new_node (dp, JSON_NULL, parent)) == NULL)
+			return JSON_MEMORY;
+		error = json_dom_parse_literal (dp, "null", 4);
+		break;
+
+	case '-':
+	case '0':
+	case '1':
+	case '2':
+	case '3':
+	case '4':
+	case '5':
+	case '6':
+	case '7':
+	case '8':
+	case '9':
+		if ((node = json_dom_new_node (dp, JSON_NUMBER, parent)) == NULL)
+			return JSON_MEMORY;
+		error = json_dom_parse_number (dp, node);
+		break;
+
+	default:
+		return json_dom_error (dp);
+	}
+	if (value != NULL)
+		*value = node;
+	return error;
+}
+
+
+/* sizes the first arena block from a count of the nodes and texts the document needs, so most documents fit in it */
+static size_t
+json_dom_estimate (const char *p, const char *end)
+{
+	size_t nodes = 1;	/* the root */
+	size_t labels = 0;
+	size_t text = 0;
+	int in_string = 0;
+
+	for (; p < end; p++)
+	{
+		if (in_string)
+		{
+			/* the closing quote makes room for the terminator */
+			text++;
+			if (*p == '\\' && p + 1 < end)
+			{
+				p++;
+				text++;
+			}
+			else if (*p == '\"')
+				in_string = 0;
+			continue;
+		}
+		switch (*p)
+		{
+		case '\"':
+			in_string = 1;
+			break;
+		case ':':	/* the value of a label */
+			labels++;
+			nodes++;
+			break;
+		case '{':	/* the first member or element */
+		case '[':
+		case ',':	/* the next member or element */
+			nodes++;
+			break;
+		case '-':
+		case '+':
+		case '.':
+		case 'e':
+		case 'E':
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+			text++;
+			break;
+		default:
+			break;
+		}
+	}
+	/* each text also needs a terminator and rounding; large objects need at least two index slots per label */
+	return nodes * (JSON_ARENA_ROUND (sizeof (json_t)) + JSON_ARENA_ALIGN) + text +
+		labels * 2 * sizeof (struct json_index_slot);
+}
+
+
+enum json_error
+json_parse_buffer (json_t ** root, const char *text, size_t length)
+{
+	struct json_dom_parser dp;
+	enum json_error error;
+	json_t *document = NULL;
+
+	assert (root != NULL);
+	assert (*root == NULL);
+	assert (text != NULL);
+
+	dp.p = text;
+	dp.end = text + length;
+	dp.line = 1;
+	dp.depth = 0;
+	dp.arena = json_arena_new (json_dom_estimate (text, text + length));
+	if (dp.arena == NULL)
+		return JSON_MEMORY;
+
+	json_dom_skip_white_spaces (&dp);
+	if (dp.p < dp.end && *dp.p != '{')
+	{
+		/* the document root must be an object */
+		error = json_dom_error (&dp);
+	}
+	else
+	{
+		error = json_dom_parse_value (&dp, NULL, &document);
+	}
 	if (error == JSON_OK)
 	{
-		*document = state.cursor;
+		/* only accept white spaces until the end of the buffer */
+		json_dom_skip_white_spaces (&dp);
+		if (dp.p < dp.end)
+			error = json_dom_error (&dp);
 	}
+	if (error != JSON_OK)
+	{
+		json_arena_free (dp.arena);
+		return error;
+	}
+
+	dp.arena->root = document;
+	*root = document;
+	return JSON_OK;
+}
+
+
+/* relocatable images */
+
+#define JSON_IMAGE_MAGIC 0x4e4f534au	/* "JSON" */
+
+struct json_image_header
+{
+	uint32_t magic;
+	uint32_t nodes;
+	uint32_t text_size;
+	uint32_t reserved;
+};
+
+/* nodes are stored in depth-first order, so that links only point forwards */
+struct json_image_node
+{
+	double number;
+	uint32_t type;
+	uint32_t text;	/*<! offset + 1 into the texts, or 0 for NULL */
+	uint32_t child;	/*<! node number + 1, or 0 for NULL */
+	uint32_t next;
+};
+
+/* the nodes follow the header, then the null-terminated texts */
+#define JSON_IMAGE_NODES JSON_ARENA_ROUND (sizeof (struct json_image_header))
+
+struct json_image_writer
+{
+	struct json_image_node *nodes;
+	char *text;
+	size_t num_nodes;
+	size_t text_used;
+};
+
+
+static void
+json_image_count (const json_t * node, size_t * nodes, size_t * text_size)
+{
+	const json_t *child;
 
+	(*nodes)++;
+	if (node->text != NULL)
+		*text_size += strlen (node->text) + 1;
+	for (child = node->child; child != NULL; child = child->next)
+		json_image_count (child, nodes, text_size);
+}
+
+
+/* writes the node and its subtree, returning the node's number */
+static size_t
+json_image_put (struct json_image_writer *w, const json_t * node)
+{
+	const size_t n = w->num_nodes++;
+	struct json_image_node *out = &w->nodes[n];
+	const json_t *child;
+	size_t previous = 0;
+
+	out->number = node->number;
+	out->type = (uint32_t) node->type;
+	out->text = 0;
+	out->child = 0;
+	out->next = 0;
+	if (node->text != NULL)
+	{
+		const size_t length = strlen (node->text) + 1;
+		memcpy (w->text + w->text_used, node->text, length);
+		out->text = (uint32_t) (w->text_used + 1);
+		w->text_used += length;
+	}
+	for (child = node->child; child != NULL; child = child->next)
+	{
+		const uint32_t c = (uint32_t) json_image_put (w, child) + 1;
+		if (previous != 0)
+			w->nodes[previous - 1].next = c;
+		else
+			out->child = c;
+		previous = c;
+	}
+	return n;
+}
+
+
+size_t
+json_image_write (const json_t * root, void *buffer, size_t size)
+{
+	struct json_image_header *header = buffer;
+	struct json_image_writer w;
+	size_t nodes = 0;
+	size_t text_size = 0;
+	size_t needed;
+
+	assert (root != NULL);
+
+	json_image_count (root, &nodes, &text_size);
+	if (nodes >= UINT32_MAX || text_size >= UINT32_MAX)
+		return 0;
+	needed = JSON_IMAGE_NODES + nodes * sizeof (struct json_image_node) + text_size;
+	if (buffer == NULL || size < needed)
+		return needed;
+
+	header->magic = JSON_IMAGE_MAGIC;
+	header->nodes = (uint32_t) nodes;
+	header->text_size = (uint32_t) text_size;
+	header->reserved = 0;
+	w.nodes = (struct json_image_node *) ((char *) buffer + JSON_IMAGE_NODES);
+	w.text = (char *) (w.nodes + nodes);
+	w.num_nodes = 0;
+	w.text_used = 0;
+	json_image_put (&w, root);
+	return needed;
+}
+
+
+json_t *
+json_image_load (void *image, size_t size)
+{
+	const struct json_image_header *header = image;
+	const struct json_image_node *in;
+	struct json_arena *arena;
+	json_t *nodes;
+	char *text;
+	size_t count;
+	size_t i;
+
+	assert (image != NULL);
+
+	if (size < JSON_IMAGE_NODES || header->magic != JSON_IMAGE_MAGIC || header->nodes == 0)
+		return NULL;
+	count = header->nodes;
+	if ((size - JSON_IMAGE_NODES) / sizeof (struct json_image_node) < count ||
+		size - JSON_IMAGE_NODES - count * sizeof (struct json_image_node) < header->text_size)
+		return NULL;
+	in = (const struct json_image_node *) ((const char *) image + JSON_IMAGE_NODES);
+	/* texts stay in the image, which the caller can write to */
+	text = (char *) image + JSON_IMAGE_NODES + count * sizeof (struct json_image_node);
+	if (header->text_size > 0 && text[header->text_size - 1] != '\0')
+		return NULL;
+
+	arena = json_arena_new (count * sizeof (json_t));
+	if (arena == NULL)
+		return NULL;
+	nodes = json_arena_alloc (arena, count * sizeof (json_t));
+	if (nodes == NULL)
+	{
+		json_arena_free (arena);
+		return NULL;
+	}
+	memset (nodes, 0, count * sizeof (json_t));
+
+	/* parents and previous siblings come first, so each node is linked to before it is reached */
+	for (i = 0; i < count; i++)
+	{
+		json_t *node = &nodes[i];
+		if (in[i].type > JSON_NULL || in[i].text > header->text_size ||
+			(in[i].child != 0 && (in[i].child <= i + 1 || in[i].child > count)) ||
+			(in[i].next != 0 && (in[i].next <= i + 1 || in[i].next > count)) ||
+			(i > 0 && node->parent == NULL && node->previous == NULL))
+		{
+			json_arena_free (arena);
+			return NULL;
+		}
+		node->type = (enum json_value_type) in[i].type;
+		node->text = in[i].text == 0 ? NULL : text + in[i].text - 1;
+		node->number = in[i].number;
+		node->arena = arena;
+		if (in[i].child != 0)
+		{
+			node->child = &nodes[in[i].child - 1];
+			node->child->parent = node;
+		}
+		if (in[i].next != 0)
+		{
+			node->next = &nodes[in[i].next - 1];
+			node->next->previous = node;
+			node->next->parent = node->parent;
+		}
+		else if (node->parent != NULL)
+		{
+			node->parent->child_end = node;
+		}
+	}
+	for (i = 0; i < count; i++)
+	{
+		if (nodes[i].type == JSON_OBJECT)
+			json_index_build_if_large (&nodes[i]);
+	}
+	arena->root = nodes;
+	return nodes;
+}
+
+/* reads the rest of the stream into a null-terminated buffer */
+static char *
+json_read_stream (FILE * file, size_t * length)
+{
+	size_t capacity = 4096;
+	char *buffer;
+	const long start = ftell (file);
+
+	if (start >= 0 && fseek (file, 0, SEEK_END) == 0)
+	{
+		const long end = ftell (file);
+		if (end > start)
+			capacity = (size_t) (end - start) + 1;
+		if (fseek (file, start, SEEK_SET) != 0)
+			return NULL;
+	}
+
+	buffer = malloc (capacity);
+	if (buffer == NULL)
+		return NULL;
+	*length = 0;
+	for (;;)
+	{
+		size_t n;
+		if (*length + 1 >= capacity)
+		{
+			char *temp = realloc (buffer, capacity * 2);
+			if (temp == NULL)
+			{
+				free (buffer);
+				return NULL;
+			}
+			buffer = temp;
+			capacity *= 2;
+		}
+		n = fread (buffer + *length, 1, capacity - 1 - *length, file);
+		*length += n;
+		if (n == 0)
+			break;
+	}
+	if (ferror (file))
+	{
+		free (buffer);
+		return NULL;
+	}
+	buffer[*length] = '\0';
+	return buffer;
+}
+
+
+enum json_error
+json_stream_parse (FILE * file, json_t ** document)
+{
+	enum json_error error;
+	size_t length = 0;
+	char *buffer;
+
+	assert (file != NULL);	/* must be an open stream */
+	assert (document != NULL);	/* must be a valid pointer reference */
+	assert (*document == NULL);	/* only accepts a null json_t pointer, to avoid memory leaks */
+
+	buffer = json_read_stream (file, &length);
+	if (buffer == NULL)
+		return JSON_MEMORY;
+	error = json_parse_buffer (document, buffer, length);
+	free (buffer);
 	return error;
 }
 
@@ -249,6 +1191,10 @@ json_new_value (const enum json_value_type type)
 
 	/* initialize members */
 	new_object->text = NULL;
+	new_object->number = 0;
+	new_object->arena = NULL;
+	new_object->index = NULL;
+	new_object->visited = JSON_VISIT_UNTRACKED;
 	new_object->parent = NULL;
 	new_object->child = NULL;
 	new_object->child_end = NULL;
@@ -284,6 +1230,10 @@ json_new_string (const char *text)
 		return NULL;
 	}
 	strncpy (new_object->text, text, length);
+	new_object->number = 0;
+	new_object->arena = NULL;
+	new_object->index = NULL;
+	new_object->visited = JSON_VISIT_UNTRACKED;
 	new_object->parent = NULL;
 	new_object->child = NULL;
 	new_object->child_end = NULL;
@@ -316,6 +1266,10 @@ json_new_number (const char *text)
 		return NULL;
 	}
 	strncpy (new_object->text, text, length);
+	new_object->number = strtod (text, NULL);
+	new_object->arena = NULL;
+	new_object->index = NULL;
+	new_object->visited = JSON_VISIT_UNTRACKED;
 	new_object->parent = NULL;
 	new_object->child = NULL;
 	new_object->child_end = NULL;
@@ -396,6 +1350,8 @@ intern_json_free_value (json_t ** value)
 	/*fixing parent node connections */
 	if ((*value)->parent)
 	{
+		json_index_drop ((*value)->parent);
+
 		/* fix the tree connection to the first node in the children's list */
 		if ((*value)->parent->child == (*value))
 		{
@@ -424,11 +1380,23 @@ intern_json_free_value (json_t ** value)
 	}
 
 	/*finally, freeing the memory allocated for this value */
-	if ((*value)->text != NULL)
+	json_index_drop (*value);
+	if ((*value)->arena != NULL)
+	{
+		/* arena nodes are all released together, with the node that owns the arena */
+		if ((*value)->arena->root == (*value))
+		{
+			json_arena_free ((*value)->arena);
+		}
+	}
+	else
 	{
-		free ((*value)->text);
+		if ((*value)->text != NULL)
+		{
+			free ((*value)->text);
+		}
+		free (*value);		/* the json value */
 	}
-	free (*value);		/* the json value */
 	(*value) = NULL;
 }
 
@@ -443,6 +1411,15 @@ json_free_value (json_t ** value)
 		return;
 	}
 
+	/* a parsed document holding only its own nodes can be freed in one go */
+	if (cursor->arena != NULL && cursor->arena->root == cursor &&
+		!cursor->arena->mixed && cursor->parent == NULL)
+	{
+		json_arena_free (cursor->arena);
+		*value = NULL;
+		return;
+	}
+
 	while (*value)
 	{
 		json_t *parent;
@@ -530,6 +1507,14 @@ json_insert_child (json_t * parent, json_t * child)
 		return JSON_BAD_TREE_STRUCTURE;
 	}
 
+	if (parent->arena != NULL && child->arena != parent->arena)
+	{
+		/* the tree can no longer be freed with its arena alone */
+		parent->arena->mixed = 1;
+	}
+
+	json_index_drop (parent);
+
 	child->parent = parent;
 	if (parent->child)
 	{
@@ -2474,6 +3459,7 @@ json_parse_fragment (struct json_parsing_info *info, const char *buffer)
 					if ((temp = json_new_value (JSON_NUMBER)) == NULL)
 						return JSON_MEMORY;
 					temp->text = rcs_unwrap (info->lex_text), info->lex_text = NULL;
+					temp->number = strtod (temp->text, NULL);
 					if (json_insert_child (info->cursor, temp) != JSON_OK)
 					{
 						/*TODO specify the exact error message */
@@ -2632,6 +3618,7 @@ json_parse_fragment (struct json_parsing_info *info, const char *buffer)
 					if ((temp = json_new_value (JSON_NUMBER)) == NULL)
 						return JSON_MEMORY;
 					temp->text = rcs_unwrap (info->lex_text), info->lex_text = NULL;
+					temp->number = strtod (temp->text, NULL);
 					if (json_insert_child (info->cursor, temp) != JSON_OK)
 					{
 						return JSON_UNKNOWN_PROBLEM;
@@ -2829,33 +3816,8 @@ json_parse_fragment (struct json_parsing_info *info, const char *buffer)
 enum json_error
 json_parse_document (json_t ** root, const char *text)
 {
-	enum json_error error;
-	struct json_parsing_info *jpi;
-
-	assert (root != NULL);
-	assert (*root == NULL);
 	assert (text != NULL);
-
-	/* initialize the parsing structure */
-	jpi = malloc (sizeof (struct json_parsing_info));
-	if (jpi == NULL)
-	{
-		return JSON_MEMORY;
-	}
-	json_jpi_init (jpi);
-
-	error = json_parse_fragment (jpi, text);
-	if ((error == JSON_WAITING_FOR_EOF) || (error == JSON_OK))
-	{
-		*root = jpi->cursor;
-		free (jpi);
-		return JSON_OK;
-	}
-	else
-	{
-		free (jpi);
-		return error;
-	}
+	return json_parse_buffer (root, text, strlen (text));
 }
 
 
@@ -4252,8 +5214,8 @@ json_saxy_parse (struct json_saxy_parser_status *jsps, struct json_saxy_function
 }
 
 
-json_t *
-json_find_first_label (const json_t * object, const char *text_label)
+static json_t *
+json_find_label (const json_t * object, const char *text_label, size_t length)
 {
 	json_t *cursor;
 
@@ -4261,10 +5223,61 @@ json_find_first_label (const json_t * object, const char *text_label)
 	assert (text_label != NULL);
 	assert (object->type == JSON_OBJECT);
 
-	for (cursor = object->child; cursor != NULL; cursor = cursor->next)
+	if (object->index != NULL)
 	{
-		if (strcmp (cursor->text, text_label) == 0)
-			break;
+		cursor = json_index_find (object->index, text_label, length);
+	}
+	else
+	{
+		if (length == JSON_LABEL_TERMINATED)
+		{
+			for (cursor = object->child; cursor != NULL; cursor = cursor->next)
+			{
+				if (strcmp (cursor->text, text_label) == 0)
+					break;
+			}
+		}
+		else
+		{
+			for (cursor = object->child; cursor != NULL; cursor = cursor->next)
+			{
+				if (json_label_equals (cursor->text, text_label, length))
+					break;
+			}
+		}
 	}
+	/* Only trees that opted in are written to; see json_track_visits () */
+	if (cursor != NULL && cursor->visited == JSON_VISIT_PENDING)
+		cursor->visited = JSON_VISIT_DONE;
 	return cursor;
 }
+
+
+json_t *
+json_find_first_label (const json_t * object, const char *text_label)
+{
+	return json_find_label (object, text_label, JSON_LABEL_TERMINATED);
+}
+
+
+json_t *
+json_find_first_label_n (const json_t * object, const char *text_label, size_t length)
+{
+	return json_find_label (object, text_label, length);
+}
+
+
+void
+json_track_visits (json_t * node)
+{
+	json_t *child;
+
+	assert (node != NULL);
+
+	for (child = node->child; child != NULL; child = child->next)
+	{
+		if (node->type == JSON_OBJECT)
+			child->visited = JSON_VISIT_PENDING;
+		json_track_visits (child);
+	}
+}
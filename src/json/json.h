@@ -84,6 +84,29 @@ The error messages produced by the JSON parsers
 	};
 
 
+/**
+Block allocator holding the nodes and strings of a parsed document
+**/
+	struct json_arena;
+
+
+/**
+Hash index of the labels of an object with many members, built when a document is parsed
+**/
+	struct json_index;
+
+
+/**
+Whether a label has been found by a lookup, for trees that track visits
+**/
+	enum json_visit_state
+	{
+		JSON_VISIT_UNTRACKED = 0,	/*!< the tree does not track visits; lookups never write to it */
+		JSON_VISIT_PENDING,	/*!< the label has not been found yet */
+		JSON_VISIT_DONE	/*!< the label has been found by a lookup */
+	};
+
+
 /**
 The JSON document tree node, which is a basic JSON type
 **/
@@ -91,6 +114,10 @@ The JSON document tree node, which is a basic JSON type
 	{
 		enum json_value_type type;	/*!< the type of node */
 		char *text;	/*!< The text stored by the node. It stores UTF-8 strings and is used exclusively by the JSON_STRING and JSON_NUMBER node types */
+		double number;	/*!< The value of a JSON_NUMBER node, parsed from its text */
+		struct json_arena *arena;	/*!< The arena this node was allocated from, or NULL if it was allocated on its own */
+		struct json_index *index;	/*!< Label lookup index of a JSON_OBJECT node with many members, or NULL */
+		int visited;	/*!< A json_visit_state; only written on trees passed to json_track_visits() */
 
 		/* FIFO queue data */
 		struct json_value *next;	/*!< The pointer pointing to the next element in the FIFO sibling list */
@@ -148,6 +175,7 @@ The structure holding the information needed for json_saxy_parse to resume parsi
 
 /** 
 Buils a json_t document by parsing an open file stream
+The rest of the stream is read in one go and parsed with json_parse_buffer()
 @param file a pointer to an object controlling a stream, returned by fopen()
 @param document a reference to a json_t pointer, set to NULL, which will store the parsed document
 @return a json_error error code according to how the parsing operation went.
@@ -155,6 +183,37 @@ Buils a json_t document by parsing an open file stream
 	enum json_error json_stream_parse (FILE * file, json_t ** document);
 
 
+/**
+Builds a json_t document from a buffer holding a complete JSON document, in a single pass.
+All nodes, strings and number values are allocated from one arena, which is released when the root is passed to json_free_value()
+@param root a reference to a json_t pointer, set to NULL, which will store the parsed document
+@param text the JSON document; it need not be null-terminated
+@param length the length of text in bytes
+@return a json_error error code according to how the parsing operation went.
+**/
+	enum json_error json_parse_buffer (json_t ** root, const char *text, size_t length);
+
+
+/**
+Writes a relocatable image of a document tree: compact nodes linked by number, followed by their texts
+@param root the root of the tree
+@param buffer where to write the image, aligned for a double, or NULL to only get its size
+@param size the size of buffer in bytes
+@return the size of the image in bytes; nothing is written if it is larger than size. 0 if the tree is too large for an image
+**/
+	size_t json_image_write (const json_t * root, void *buffer, size_t size);
+
+
+/**
+Builds a document tree from an image written by json_image_write(), turning the node numbers into pointers.
+The nodes are allocated from one arena, as with json_parse_buffer(), but texts point into the image, so it must outlive the tree.
+@param image the image, such as a file mapped into memory, aligned for a double
+@param size the size of image in bytes
+@return the root of the tree, or NULL if the image is malformed
+**/
+	json_t *json_image_load (void *image, size_t size);
+
+
 /**
 Creates a new JSON value and defines it's type
 @param type the value's type
@@ -315,7 +374,7 @@ Produces a document tree sequentially from a JSON markup text fragment
 
 
 /**
-Produces a document tree from a JSON markup text string that contains a complete document
+Produces a document tree from a JSON markup text string that contains a complete document, using json_parse_buffer()
 @param root a reference to a pointer to a json_t type. The function allocates memory to the passed pointer and sets up the value
 @param text a c-string containing a complete JSON text document
 @return a pointer to the new document tree or NULL if some error occurred
@@ -335,6 +394,8 @@ Function to perform a SAX-like parsing of any JSON document or document fragment
 
 /**
 Searches through the object's children for a label holding the text text_label
+Objects with many members are indexed when parsed by json_parse_buffer() or loaded by json_image_load(), so searching them takes constant time
+If the tree tracks visits (see json_track_visits()), the label found is marked as visited; otherwise the tree is only read, so it may be shared between threads
 @param object a json_value of type JSON_OBJECT
 @param text_label the c-string to search for through the object's child labels
 @return a pointer to the first label holding a text equal to text_label or NULL if there is no such label or if object has no children
@@ -342,6 +403,24 @@ Searches through the object's children for a label holding the text text_label
 	json_t *json_find_first_label (const json_t * object, const char *text_label);
 
 
+/**
+Same as json_find_first_label, for a label that need not be null-terminated
+@param object a json_value of type JSON_OBJECT
+@param text_label the label to search for
+@param length the length of text_label in bytes
+@return a pointer to the first label holding a text equal to text_label or NULL if there is no such label or if object has no children
+**/
+	json_t *json_find_first_label_n (const json_t * object, const char *text_label, size_t length);
+
+
+/**
+Opts a tree into visit tracking: every label below node is reset to JSON_VISIT_PENDING, and later lookups mark the labels they find as JSON_VISIT_DONE
+Lookups then write to the tree, so it must not be shared with other threads until it is freed
+@param node the root of the tree to track
+**/
+	void json_track_visits (json_t * node);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,7 @@
 #include <cdogs/map_build.h>
 #include <cdogs/pic_manager.h>
 #include <cdogs/pics.h>
+#include <cdogs/render_queue.h>
 #include <cdogs/tile_class.h>
 
 LoadingScreen gLoadingScreen;
@@ -70,7 +71,7 @@ static void LazyLoad(LoadingScreen *l)
 			{
 				CArrayPushBack(&l->panelIndices, &i);
 			}
-			CArrayShuffle(&l->panelIndices);
+			CArrayShuffle(&l->panelIndices, RNG_COSMETIC);
 		}
 	}
 
@@ -132,6 +133,21 @@ void LoadingScreenDraw(
 
 	SDL_Delay(70);
 }
+void LoadingScreenMapBuildProgress(
+	void *data, const char *phase, const float pct)
+{
+	LoadingScreen *l = data;
+	// Don't interrupt a frame that is being recorded
+	if (gRenderQueue.Recording)
+	{
+		return;
+	}
+	char buf[256];
+	sprintf(buf, "%s... %d%%", phase, (int)(pct * 100));
+	WindowContextPreRender(&l->g->gameWindow);
+	LoadingScreenDrawInner(l, buf, 1.0f);
+	WindowContextPostRender(&l->g->gameWindow);
+}
 
 typedef struct
 {
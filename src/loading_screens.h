@@ -49,6 +49,10 @@ void LoadingScreenTerminate(LoadingScreen *l);
 
 void LoadingScreenDraw(
 	LoadingScreen *l, const char *loadingText, const float showPct);
+// Redraw a covered loading screen with the map build phase; pass to
+// MapBuildSetProgress with the loading screen as data
+void LoadingScreenMapBuildProgress(
+	void *data, const char *phase, const float pct);
 
 GameLoopData *ScreenLoading(
 	const char *loadingText, const bool ascending, GameLoopData *nextLoop, const bool removeParent);
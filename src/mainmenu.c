@@ -116,7 +116,9 @@ static void GenerateLiveBackground(MainMenuData *data)
 	PlacePlayer(&gMap, p, svec2_zero(), true);
 	CA_FOREACH_END()
 
-	const HSV tint = {rand() * 360.0 / RAND_MAX, rand() * 1.0 / RAND_MAX, 0.5};
+	const HSV tint = {
+		RAND_DOUBLE(RNG_COSMETIC, 0, 360), RAND_DOUBLE(RNG_COSMETIC, 0, 1),
+		0.5};
 	data->bgTint = tint;
 	DrawBufferInit(&data->buffer, svec2i(X_TILES, Y_TILES), data->graphics);
 	InitializeBadGuys();
@@ -281,18 +283,28 @@ static void MenuCreateAll(
 
 typedef struct
 {
+	MainMenuData *MainMenu;
+	// The indices of the campaign list menu items
+	// so we can fill them in once the lists are loaded
+	int MenuCampaignIndex;
+	int MenuDogfightIndex;
+	int MenuDeathmatchIndex;
+	int ListsAdded;
 	// The index of the join game menu item
 	// so we can enable it if LAN servers are found
 	int MenuJoinIndex;
-} CheckLANServerData;
+} StartMenuData;
 static menu_t *MenuCreateContinue(const char *name, MainMenuData *mainMenu, const CampaignEntry *entry);
 static menu_t *MenuCreateQuickPlay(const char *name, MainMenuData *mainMenu);
 static menu_t *MenuCreateCampaigns(
 	const char *name, const char *title, MainMenuData *mainMenu, CampaignList *list,
 	const GameMode mode);
+static void MenuAddCampaigns(
+	menu_t *menu, MainMenuData *mainMenu, CampaignList *list,
+	const GameMode mode);
 static menu_t *CreateJoinLANGame(
 	const char *name, const char *title, MenuSystem *ms, LoopRunner *l);
-static void CheckLANServers(menu_t *menu, void *data);
+static void StartMenuUpdate(menu_t *menu, void *data);
 static menu_t *MenuCreateStart(
 	const char *name, MainMenuData *mainMenu, LoopRunner *l)
 {
@@ -301,24 +313,29 @@ static menu_t *MenuCreateStart(
 	MenuAddSubmenu(
 		menu, MenuCreateContinue("Continue", mainMenu, &cs->Campaign));
 	const int menuContinueIndex = (int)menu->u.normal.subMenus.size - 1;
+	StartMenuData *cdata;
+	CCALLOC(cdata, sizeof *cdata);
+	cdata->MainMenu = mainMenu;
+	// The campaign lists are still loading; add them as they become ready
 	MenuAddSubmenu(
 		menu, MenuCreateCampaigns(
-				  "Campaign", "Select a campaign:", mainMenu, &mainMenu->campaigns.campaignList,
+				  "Campaign", "Select a campaign:", mainMenu, NULL,
 				  GAME_MODE_NORMAL));
+	cdata->MenuCampaignIndex = (int)menu->u.normal.subMenus.size - 1;
 	MenuAddSubmenu(
 		menu, MenuCreateQuickPlay("Quick Play", mainMenu));
 	MenuAddSubmenu(
 		menu, MenuCreateCampaigns(
 				  "Dogfight", "Select a dogfight scenario:",
-				  mainMenu, &mainMenu->campaigns.dogfightList, GAME_MODE_DOGFIGHT));
+				  mainMenu, NULL, GAME_MODE_DOGFIGHT));
+	cdata->MenuDogfightIndex = (int)menu->u.normal.subMenus.size - 1;
 	MenuAddSubmenu(
 		menu, MenuCreateCampaigns(
 				  "Deathmatch", "Select a deathmatch scenario:",
-				  mainMenu, &mainMenu->campaigns.dogfightList, GAME_MODE_DEATHMATCH));
+				  mainMenu, NULL, GAME_MODE_DEATHMATCH));
+	cdata->MenuDeathmatchIndex = (int)menu->u.normal.subMenus.size - 1;
 	MenuAddSubmenu(
 		menu, CreateJoinLANGame("Join LAN game", "Choose LAN server", &mainMenu->ms, l));
-	CheckLANServerData *cdata;
-	CMALLOC(cdata, sizeof *cdata);
 	cdata->MenuJoinIndex = (int)menu->u.normal.subMenus.size - 1;
 	MenuAddSubmenu(menu, MenuCreateSeparator(""));
 	MenuAddSubmenu(menu, MenuCreateBack("Back"));
@@ -328,9 +345,13 @@ static menu_t *MenuCreateStart(
 		MenuDisableSubmenu(menu, menuContinueIndex);
 	}
 
+	MenuDisableSubmenu(menu, cdata->MenuCampaignIndex);
+	MenuDisableSubmenu(menu, cdata->MenuDogfightIndex);
+	MenuDisableSubmenu(menu, cdata->MenuDeathmatchIndex);
 	MenuDisableSubmenu(menu, cdata->MenuJoinIndex);
-	// Periodically check if LAN servers are available
-	MenuSetPostUpdateFunc(menu, CheckLANServers, cdata, true);
+	// Periodically check if campaign lists have loaded and if LAN servers are
+	// available
+	MenuSetPostUpdateFunc(menu, StartMenuUpdate, cdata, true);
 
 	return menu;
 }
@@ -408,17 +429,27 @@ static menu_t *MenuCreateCampaigns(
 	menu_t *menu = MenuCreateNormal(name, title, MENU_TYPE_NORMAL, 0);
 	menu->u.normal.maxItems = 20;
 	menu->u.normal.align = MENU_ALIGN_CENTER;
+	if (list != NULL)
+	{
+		MenuAddCampaigns(menu, mainMenu, list, mode);
+	}
+	MenuSetCustomDisplay(menu, CampaignsDisplayFilename, NULL);
+	return menu;
+}
+static void MenuAddCampaigns(
+	menu_t *menu, MainMenuData *mainMenu, CampaignList *list,
+	const GameMode mode)
+{
 	CA_FOREACH(CampaignList, subList, list->subFolders)
 	char folderName[CDOGS_FILENAME_MAX];
 	sprintf(folderName, "%s/", subList->Name);
 	MenuAddSubmenu(
-		menu, MenuCreateCampaigns(folderName, title, mainMenu, subList, mode));
+		menu, MenuCreateCampaigns(
+				  folderName, menu->u.normal.title, mainMenu, subList, mode));
 	CA_FOREACH_END()
 	CA_FOREACH(CampaignEntry, e, list->list)
 	MenuAddSubmenu(menu, MenuCreateCampaignItem(mainMenu, e, mode));
 	CA_FOREACH_END()
-	MenuSetCustomDisplay(menu, CampaignsDisplayFilename, NULL);
-	return menu;
 }
 
 static menu_t *MenuCreateCampaignItem(MainMenuData *mainMenu, CampaignEntry *entry, const GameMode mode)
@@ -533,9 +564,40 @@ bail:
 	// Don't activate the menu item
 	jdata->MS->current = menu->parentMenu;
 }
-static void CheckLANServers(menu_t *menu, void *data)
+static void AddCampaignList(
+	menu_t *menu, StartMenuData *cdata, const int idx, CampaignList *list,
+	const GameMode mode)
+{
+	menu_t *listMenu = CArrayGet(&menu->u.normal.subMenus, idx);
+	MenuAddCampaigns(listMenu, cdata->MainMenu, list, mode);
+	MenuEnableSubmenu(menu, idx);
+}
+static void CheckLANServers(menu_t *menu, StartMenuData *cdata);
+static void StartMenuUpdate(menu_t *menu, void *data)
+{
+	StartMenuData *cdata = data;
+	CustomCampaigns *campaigns = &cdata->MainMenu->campaigns;
+	const int added = CampaignsLoaded(campaigns) & ~cdata->ListsAdded;
+	if (added & CAMPAIGN_LIST_CAMPAIGNS)
+	{
+		AddCampaignList(
+			menu, cdata, cdata->MenuCampaignIndex, &campaigns->campaignList,
+			GAME_MODE_NORMAL);
+	}
+	if (added & CAMPAIGN_LIST_DOGFIGHTS)
+	{
+		AddCampaignList(
+			menu, cdata, cdata->MenuDogfightIndex, &campaigns->dogfightList,
+			GAME_MODE_DOGFIGHT);
+		AddCampaignList(
+			menu, cdata, cdata->MenuDeathmatchIndex, &campaigns->dogfightList,
+			GAME_MODE_DEATHMATCH);
+	}
+	cdata->ListsAdded |= added;
+	CheckLANServers(menu, cdata);
+}
+static void CheckLANServers(menu_t *menu, StartMenuData *cdata)
 {
-	CheckLANServerData *cdata = data;
 	if (gNetClient.ScannedAddrs.size > 0)
 	{
 		MenuEnableSubmenu(menu, cdata->MenuJoinIndex);
@@ -179,11 +179,14 @@ static GameLoopResult LevelSelectionUpdate(GameLoopData *data, LoopRunner *l)
 				break;
 			}
 
-			// Load autosaved player data
+			// Load autosaved player data, and the seed so the maps are the
+			// same as before
 			if (pData->save != NULL && gCampaign.MissionIndex > 0)
 			{
 				const Mission *m = CampaignGetCurrentMission(&gCampaign);
 				PlayerSavesApply(&pData->save->Players, m->WeaponPersist);
+				ConfigSetInt(
+					&gConfig, "Game.RandomSeed", pData->save->RandomSeed);
 			}
 		}
 	}
@@ -220,7 +220,7 @@ static GameLoopResult NumPlayersUpdate(GameLoopData *data, LoopRunner *l)
 	if (gEventHandlers.DemoQuitTimer > 0)
 	{
 		// Select random number of players for demo
-		numPlayers = RAND_INT(1, 5);
+		numPlayers = RAND_INT(RNG_COSMETIC, 1, 5);
 		result = UPDATE_RESULT_OK;
 	}
 	else
@@ -369,12 +369,14 @@ GameLoopData *ScreenVictory(Campaign *c)
 	if (GetNumPlayers(PLAYER_ANY, false, true) == 1)
 	{
 		const int numWords = sizeof finalWordsSingle / sizeof(char *);
-		data->FinalWords = finalWordsSingle[rand() % numWords];
+		data->FinalWords =
+			finalWordsSingle[RAND_INT(RNG_COSMETIC, 0, numWords)];
 	}
 	else
 	{
 		const int numWords = sizeof finalWordsMulti / sizeof(char *);
-		data->FinalWords = finalWordsMulti[rand() % numWords];
+		data->FinalWords =
+			finalWordsMulti[RAND_INT(RNG_COSMETIC, 0, numWords)];
 	}
 	PlayerList *pl =
 		PlayerListNew(PlayerListUpdate, VictoryDraw, data, true, false);
@@ -0,0 +1,244 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <asset_loader.h>
+
+#include <config.h>
+#include <draw/char_sprites.h>
+#include <grafx.h>
+#include <pic_manager.h>
+#include <sounds.h>
+
+
+// Run from the src dir, like the game, so that the data dir is found
+static void InitSDL(void)
+{
+	// Headless; the dummy drivers still give us a renderer and a mixer
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0)
+	{
+		printf("Failed to init SDL: %s\n", SDL_GetError());
+	}
+	gConfig = ConfigDefault();
+	ConfigResetDefault(ConfigGet(&gConfig, "Graphics"));
+	GraphicsInit(&gGraphicsDevice, &gConfig);
+	GraphicsInitialize(&gGraphicsDevice);
+}
+
+typedef struct
+{
+	map_t Map;
+	map_t Other;
+	int Count;
+	int Mismatches;
+} CompareData;
+static bool PicEqual(const Pic *a, const Pic *b)
+{
+	if (!svec2i_is_equal(a->size, b->size) ||
+		!svec2i_is_equal(a->offset, b->offset))
+	{
+		return false;
+	}
+	if (a->Data == NULL || b->Data == NULL)
+	{
+		return a->Data == b->Data;
+	}
+	return memcmp(
+			   a->Data, b->Data,
+			   a->size.x * a->size.y * sizeof *a->Data) == 0;
+}
+static int ComparePics(any_t data, any_t key)
+{
+	CompareData *c = data;
+	NamedPic *a;
+	NamedPic *b;
+	c->Count++;
+	if (hashmap_get(c->Map, key, (any_t *)&a) != MAP_OK ||
+		hashmap_get(c->Other, key, (any_t *)&b) != MAP_OK ||
+		!PicEqual(&a->pic, &b->pic))
+	{
+		c->Mismatches++;
+	}
+	return MAP_OK;
+}
+static int CompareSprites(any_t data, any_t key)
+{
+	CompareData *c = data;
+	NamedSprites *a;
+	NamedSprites *b;
+	c->Count++;
+	if (hashmap_get(c->Map, key, (any_t *)&a) != MAP_OK ||
+		hashmap_get(c->Other, key, (any_t *)&b) != MAP_OK ||
+		a->pics.size != b->pics.size)
+	{
+		c->Mismatches++;
+		return MAP_OK;
+	}
+	CA_FOREACH(const Pic, p, a->pics)
+	if (!PicEqual(p, CArrayGet(&b->pics, _ca_index)))
+	{
+		c->Mismatches++;
+		break;
+	}
+	CA_FOREACH_END()
+	return MAP_OK;
+}
+static bool ChunkEqual(const Mix_Chunk *a, const Mix_Chunk *b)
+{
+	// Sounds are decoded on first play
+	SoundPrefetch(a);
+	SoundPrefetch(b);
+	return a->alen > 0 && a->alen == b->alen &&
+		   memcmp(a->abuf, b->abuf, a->alen) == 0;
+}
+static int CompareSounds(any_t data, any_t key)
+{
+	CompareData *c = data;
+	SoundData *a;
+	SoundData *b;
+	c->Count++;
+	if (hashmap_get(c->Map, key, (any_t *)&a) != MAP_OK ||
+		hashmap_get(c->Other, key, (any_t *)&b) != MAP_OK ||
+		a->Type != b->Type)
+	{
+		c->Mismatches++;
+		return MAP_OK;
+	}
+	if (a->Type == SOUND_NORMAL)
+	{
+		c->Mismatches += !ChunkEqual(a->u.normal, b->u.normal);
+		return MAP_OK;
+	}
+	if (a->u.random.sounds.size != b->u.random.sounds.size)
+	{
+		c->Mismatches++;
+		return MAP_OK;
+	}
+	CA_FOREACH(const Mix_Chunk *, chunk, a->u.random.sounds)
+	const Mix_Chunk **other = CArrayGet(&b->u.random.sounds, _ca_index);
+	if (!ChunkEqual(*chunk, *other))
+	{
+		c->Mismatches++;
+		break;
+	}
+	CA_FOREACH_END()
+	return MAP_OK;
+}
+static int CompareCharSprites(any_t data, any_t key)
+{
+	CompareData *c = data;
+	CharSprites *a;
+	CharSprites *b;
+	c->Count++;
+	if (hashmap_get(c->Map, key, (any_t *)&a) != MAP_OK ||
+		hashmap_get(c->Other, key, (any_t *)&b) != MAP_OK ||
+		strcmp(a->Name, b->Name) != 0 ||
+		memcmp(a->Order, b->Order, sizeof a->Order) != 0 ||
+		memcmp(&a->Offsets.Dir, &b->Offsets.Dir, sizeof a->Offsets.Dir) !=
+			0)
+	{
+		c->Mismatches++;
+	}
+	return MAP_OK;
+}
+static CompareData Compare(map_t a, map_t b, PFany f)
+{
+	CompareData c;
+	memset(&c, 0, sizeof c);
+	c.Map = a;
+	c.Other = b;
+	hashmap_iterate_keys(a, f, &c);
+	return c;
+}
+
+
+FEATURE(AssetLoaderFinish, "Load assets in parallel")
+	InitSDL();
+	SCENARIO("Load graphics")
+		GIVEN("graphics loaded serially")
+			ASSERT(gGraphicsDevice.IsInitialized, 1);
+			PicManager serial;
+			PicManagerInit(&serial);
+			AssetLoader l;
+			AssetLoaderInit(&l, 0);
+			PicManagerQueueLoad(&l, &serial);
+			AssetLoaderTerminate(&l);
+		WHEN("I load the graphics with worker threads")
+			PicManager parallel;
+			PicManagerInit(&parallel);
+			AssetLoaderInit(&l, 4);
+			PicManagerQueueLoad(&l, &parallel);
+			AssetLoaderTerminate(&l);
+		THEN("the pics and sprites should be the same")
+			const CompareData pics =
+				Compare(serial.pics, parallel.pics, ComparePics);
+			SHOULD_BE_TRUE(pics.Count > 0);
+			SHOULD_INT_EQUAL(pics.Count, hashmap_length(parallel.pics));
+			SHOULD_INT_EQUAL(pics.Mismatches, 0);
+			const CompareData sprites =
+				Compare(serial.sprites, parallel.sprites, CompareSprites);
+			SHOULD_BE_TRUE(sprites.Count > 0);
+			SHOULD_INT_EQUAL(sprites.Count, hashmap_length(parallel.sprites));
+			SHOULD_INT_EQUAL(sprites.Mismatches, 0);
+		AND("the style names should be the same")
+			SHOULD_INT_EQUAL(
+				(int)serial.wallStyleNames.size,
+				(int)parallel.wallStyleNames.size);
+			SHOULD_INT_EQUAL(
+				(int)serial.hairstyleNames.size,
+				(int)parallel.hairstyleNames.size);
+		PicManagerTerminate(&serial);
+		PicManagerTerminate(&parallel);
+	SCENARIO_END
+
+	SCENARIO("Load sounds")
+		GIVEN("sounds loaded serially")
+			SoundDevice serial;
+			AssetLoader l;
+			AssetLoaderInit(&l, 0);
+			SoundInitializeQueue(&serial, "sounds", &l);
+			AssetLoaderTerminate(&l);
+			ASSERT(serial.isInitialised, 1);
+		WHEN("I load the sounds with worker threads")
+			map_t parallel = hashmap_new();
+			char buf[CDOGS_PATH_MAX];
+			GetDataFilePath(buf, "sounds");
+			AssetLoaderInit(&l, 4);
+			SoundQueueDir(&l, parallel, buf, NULL);
+			AssetLoaderTerminate(&l);
+		THEN("the sounds should be the same")
+			const CompareData sounds =
+				Compare(serial.sounds, parallel, CompareSounds);
+			SHOULD_BE_TRUE(sounds.Count > 0);
+			SHOULD_INT_EQUAL(sounds.Count, hashmap_length(parallel));
+			SHOULD_INT_EQUAL(sounds.Mismatches, 0);
+		SoundClear(parallel);
+		hashmap_free(parallel);
+		SoundTerminate(&serial, false);
+	SCENARIO_END
+
+	SCENARIO("Load char sprite classes")
+		GIVEN("classes loaded serially")
+			CharSpriteClasses serial;
+			AssetLoader l;
+			AssetLoaderInit(&l, 0);
+			CharSpriteClassesInitQueue(&serial, &l);
+			AssetLoaderTerminate(&l);
+		WHEN("I load the classes with worker threads")
+			CharSpriteClasses parallel;
+			AssetLoaderInit(&l, 4);
+			CharSpriteClassesInitQueue(&parallel, &l);
+			AssetLoaderTerminate(&l);
+		THEN("the classes should be the same")
+			const CompareData classes =
+				Compare(serial.classes, parallel.classes, CompareCharSprites);
+			SHOULD_BE_TRUE(classes.Count > 0);
+			SHOULD_INT_EQUAL(classes.Count, hashmap_length(parallel.classes));
+			SHOULD_INT_EQUAL(classes.Mismatches, 0);
+		CharSpriteClassesTerminate(&serial);
+		CharSpriteClassesTerminate(&parallel);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Asset loader features are:", TEST_FEATURE(AssetLoaderFinish))
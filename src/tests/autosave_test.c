@@ -30,6 +30,7 @@ FEATURE(save_and_load, "Save and load")
 			CampaignSaveInit(&cs1);
 			CSTRDUP(cs1.Campaign.Path, "campaign.cdogscpn");
 			cs1.NextMission = 1;
+			cs1.RandomSeed = 1234;
 			AutosaveAddCampaign(&autosave1, &cs1);
 		AND("I save it to file")
 			AutosaveSave(&autosave1, "tmp");
@@ -44,6 +45,8 @@ FEATURE(save_and_load, "Save and load")
 			SHOULD_STR_EQUAL(cs2->Campaign.Path, cs1.Campaign.Path);
 		AND("their next missions should equal")
 			SHOULD_INT_EQUAL(cs2->NextMission, cs1.NextMission);
+		AND("their random seeds should equal")
+			SHOULD_INT_EQUAL(cs2->RandomSeed, cs1.RandomSeed);
 	SCENARIO_END
 FEATURE_END
 
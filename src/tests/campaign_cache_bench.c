@@ -0,0 +1,149 @@
+// Benchmark for the campaign cache; compares reading and parsing the JSON
+// files of campaign archives and decoding their static tiles, with getting
+// the same from their compiled caches. Writes the caches to the config dir.
+// Not run as part of the tests.
+// Usage: campaign_cache_bench [archive...]; defaults are relative to the
+// repo root
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <campaign_cache.h>
+#include <files.h>
+#include <json_utils.h>
+#include <mission.h>
+#include <mission_static.h>
+#include <utils.h>
+
+#define ITERATIONS 20
+
+static const char *docNames[] = {
+	"campaign.json",	 "particles.json", "character_classes.json",
+	"bullets.json",		 "ammo.json",	   "guns.json",
+	"pickups.json",		 "map_objects.json", "missions.json",
+	"characters.json"};
+#define NUM_DOCS (sizeof docNames / sizeof docNames[0])
+
+typedef struct
+{
+	size_t Missions;
+	size_t Tiles;
+} Totals;
+
+static void LoadTiles(
+	json_t *missionsRoot, const int version, CampaignCache *cache,
+	Totals *t)
+{
+	const json_t *missions =
+		json_find_first_label(missionsRoot, "Missions")->child;
+	int mission = 0;
+	for (json_t *child = missions->child; child;
+		 child = child->next, mission++)
+	{
+		CArray tiles, access;
+		CArrayInit(&tiles, sizeof(int));
+		CArrayInit(&access, sizeof(uint16_t));
+		MapType type = MAPTYPE_CLASSIC;
+		JSON_UTILS_LOAD_ENUM(type, child, "Type", StrMapType);
+		struct vec2i size = svec2i_zero();
+		LoadInt(&size.x, child, "Width");
+		LoadInt(&size.y, child, "Height");
+		if (version > 14 && type == MAPTYPE_STATIC &&
+			!CampaignCacheLoadTiles(cache, mission, &tiles, &access))
+		{
+			MissionStaticLoadTiles(&tiles, &access, child, size);
+		}
+		t->Missions++;
+		t->Tiles += tiles.size;
+		CArrayTerminate(&tiles);
+		CArrayTerminate(&access);
+	}
+}
+
+// What loading an archive does before handing the documents to the loaders
+static void Load(const char *archive, CampaignCache *cache, Totals *t)
+{
+	json_t *roots[NUM_DOCS];
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		roots[i] = NULL;
+		if (CampaignCacheTryGetJSON(cache, docNames[i], &roots[i]))
+		{
+			continue;
+		}
+		char path[CDOGS_PATH_MAX];
+		sprintf(path, "%s/%s", archive, docNames[i]);
+		long len;
+		char *buf = ReadFileIntoBuf(path, "rb", &len);
+		if (buf != NULL)
+		{
+			json_parse_buffer(&roots[i], buf, (size_t)len);
+			CFREE(buf);
+		}
+	}
+	int version = 0;
+	LoadInt(&version, roots[0], "Version");
+	LoadTiles(roots[8], version, cache, t);
+	for (int i = 0; i < (int)NUM_DOCS; i++)
+	{
+		json_free_value(&roots[i]);
+	}
+}
+
+static void Bench(const char *archive)
+{
+	Totals t[2];
+	memset(t, 0, sizeof t);
+	double ms[2];
+	for (int i = 0; i < 2; i++)
+	{
+		const clock_t start = clock();
+		for (int j = 0; j < ITERATIONS; j++)
+		{
+			CampaignCache cache;
+			memset(&cache, 0, sizeof cache);
+			if (i == 1 && !CampaignCacheOpen(&cache, archive, false))
+			{
+				printf("%s: no cache\n", archive);
+				return;
+			}
+			memset(&t[i], 0, sizeof t[i]);
+			Load(archive, &cache, &t[i]);
+			CampaignCacheClose(&cache);
+		}
+		ms[i] = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC / ITERATIONS;
+	}
+	printf(
+		"%s: json %.3f ms, cache %.3f ms (%zu missions, %zu tiles%s)\n",
+		archive, ms[0], ms[1], t[1].Missions, t[1].Tiles,
+		t[0].Tiles == t[1].Tiles ? "" : " MISMATCH");
+}
+
+int main(int argc, char *argv[])
+{
+	static const char *defaultPaths[] = {
+		"missions/doom.cdogscpn", "missions/harmful_crysalis.cdogscpn",
+		"missions/ai_insurgency_2.cdogscpn", "missions/Sand.cdogscpn"};
+	// Archives given on the command line replace the defaults
+	const bool hasArgs = argc > 1;
+	const int numPaths =
+		hasArgs ? argc - 1
+				: (int)(sizeof defaultPaths / sizeof defaultPaths[0]);
+	for (int i = 0; i < numPaths; i++)
+	{
+		const char *path = hasArgs ? argv[i + 1] : defaultPaths[i];
+		CampaignCache cache;
+		const clock_t start = clock();
+		if (!CampaignCacheOpen(&cache, path, true))
+		{
+			printf("%s: cannot compile cache\n", path);
+			continue;
+		}
+		printf(
+			"%s: opened or compiled cache in %.3f ms, %zu bytes\n", path,
+			(double)(clock() - start) * 1000 / CLOCKS_PER_SEC, cache.Size);
+		CampaignCacheClose(&cache);
+		Bench(path);
+	}
+	return 0;
+}
@@ -0,0 +1,151 @@
+// Benchmark for the campaign index; lists a generated folder of campaigns
+// by scanning every campaign, with an empty (cold) index and with a full
+// (warm) one. Writes the campaigns and the index to a dir in the working
+// dir.
+// Not run as part of the tests.
+// Usage: campaign_index_bench [count]
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL_timer.h>
+#include <tinydir/tinydir.h>
+
+#include <campaign_entry.h>
+#include <campaign_index.h>
+#include <files.h>
+
+#define BENCH_DIR "campaign_index_bench"
+#define INDEX_PATH BENCH_DIR "/campaigns.cdogsidx"
+#define DEFAULT_COUNT 1000
+
+static void WriteFile(const char *path, const char *s)
+{
+	FILE *f = fopen(path, "w");
+	if (f == NULL)
+	{
+		printf("cannot write %s\n", path);
+		exit(1);
+	}
+	fputs(s, f);
+	fclose(f);
+}
+// Campaign archives with a campaign.json like the editor saves, and some
+// missions that listing campaigns shouldn't read
+static void Generate(const int count)
+{
+	char desc[2048];
+	memset(desc, 'x', sizeof desc - 1);
+	desc[sizeof desc - 1] = '\0';
+	char *buf;
+	CMALLOC(buf, 64 * 1024);
+	for (int i = 0; i < count; i++)
+	{
+		char dir[CDOGS_PATH_MAX];
+		sprintf(dir, BENCH_DIR "/missions/bench%04d.cdogscpn", i);
+		mkdir_deep(dir);
+		char path[CDOGS_PATH_MAX];
+		sprintf(path, "%s/campaign.json", dir);
+		sprintf(
+			buf,
+			"{\n\t\"Version\": 16,\n\t\"Title\": \"Benchmark %d\",\n"
+			"\t\"Author\": \"bench\",\n\t\"Description\": \"%s\",\n"
+			"\t\"Ammo\": true,\n\t\"Missions\": %d\n}\n",
+			i, desc, 1 + i % 10);
+		WriteFile(path, buf);
+		sprintf(path, "%s/missions.json", dir);
+		strcpy(buf, "{\"Missions\": [");
+		for (int m = 0; m < 1 + i % 10; m++)
+		{
+			sprintf(
+				buf + strlen(buf), "%s{\"Title\": \"Mission %d\", \"Size\": "
+				"[64, 64], \"Description\": \"%.1000s\"}",
+				m > 0 ? ", " : "", m, desc);
+		}
+		strcat(buf, "]}\n");
+		WriteFile(path, buf);
+	}
+	CFREE(buf);
+}
+
+// What listing the campaigns does for each file
+static int List(CampaignIndex *ci)
+{
+	tinydir_dir dir;
+	if (tinydir_open_sorted(&dir, BENCH_DIR "/missions") == -1)
+	{
+		return 0;
+	}
+	int found = 0;
+	for (int i = 0; i < (int)dir.n_files; i++)
+	{
+		tinydir_file file;
+		tinydir_readfile_n(&dir, &file, i);
+		if (file.name[0] == '.')
+		{
+			continue;
+		}
+		CampaignEntry entry;
+		if (CampaignEntryTryLoadIndexed(&entry, file.path, GAME_MODE_NORMAL, ci))
+		{
+			found++;
+			CampaignEntryTerminate(&entry);
+		}
+	}
+	tinydir_close(&dir);
+	return found;
+}
+
+static double Bench(const char *name, const bool useIndex)
+{
+	CampaignIndex ci;
+	if (useIndex)
+	{
+		CampaignIndexInit(&ci, INDEX_PATH);
+	}
+	const Uint64 start = SDL_GetPerformanceCounter();
+	const int found = List(useIndex ? &ci : NULL);
+	if (useIndex)
+	{
+		CampaignIndexSave(&ci, true);
+	}
+	const double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000 /
+					  SDL_GetPerformanceFrequency();
+	printf("%s: %.1f ms, %d campaigns", name, ms, found);
+	if (useIndex)
+	{
+		printf(" (%d scanned)", ci.Stats.Misses);
+		CampaignIndexTerminate(&ci);
+	}
+	printf("\n");
+	return ms;
+}
+
+int main(int argc, char *argv[])
+{
+	const int count = argc > 1 ? atoi(argv[1]) : DEFAULT_COUNT;
+	printf("generating %d campaigns in %s...\n", count, BENCH_DIR);
+	Generate(count);
+	remove(INDEX_PATH);
+
+	Bench("no index", false);
+	Bench("cold index", true);
+	const double warm = Bench("warm index", true);
+	// Touch a tenth of the campaigns, as if they were edited
+	for (int i = 0; i < count; i += 10)
+	{
+		char path[CDOGS_PATH_MAX];
+		sprintf(
+			path, BENCH_DIR "/missions/bench%04d.cdogscpn/campaign.json", i);
+		FILE *f = fopen(path, "a");
+		if (f != NULL)
+		{
+			fputs("\n", f);
+			fclose(f);
+		}
+	}
+	Bench("10% changed", true);
+	printf("warm index: %.3f ms per campaign\n", warm / count);
+	return 0;
+}
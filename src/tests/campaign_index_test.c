@@ -0,0 +1,124 @@
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <campaign_index.h>
+#include <files.h>
+
+#define TEST_DIR "campaign_index_test"
+#define INDEX_PATH TEST_DIR "/campaigns.cdogsidx"
+
+static void WriteCampaign(const char *path, const char *title, const int missions)
+{
+	mkdir_deep(path);
+	char buf[CDOGS_PATH_MAX];
+	sprintf(buf, "%s/campaign.json", path);
+	FILE *f = fopen(buf, "w");
+	fprintf(
+		f, "{\"Version\": 15, \"Title\": \"%s\", \"Missions\": %d}", title,
+		missions);
+	fclose(f);
+}
+static bool Scan(
+	CampaignIndex *ci, const char *path, char *title, int *numMissions)
+{
+	char *t = NULL;
+	const bool ok = CampaignIndexScan(ci, path, &t, numMissions);
+	strcpy(title, ok ? t : "");
+	CFREE(t);
+	return ok;
+}
+
+
+FEATURE(CampaignIndexScan, "Scan campaigns using the index")
+	SCENARIO("Scan unchanged campaigns")
+		GIVEN("an index of a campaign")
+			WriteCampaign(TEST_DIR "/a.cdogscpn", "Alpha", 3);
+			remove(INDEX_PATH);
+			CampaignIndex ci;
+			CampaignIndexInit(&ci, INDEX_PATH);
+			char title[256];
+			int missions;
+			Scan(&ci, TEST_DIR "/a.cdogscpn", title, &missions);
+			CampaignIndexSave(&ci, true);
+			CampaignIndexTerminate(&ci);
+		WHEN("I load the index and scan the campaign again")
+			CampaignIndexInit(&ci, INDEX_PATH);
+			const bool ok = Scan(&ci, TEST_DIR "/a.cdogscpn", title, &missions);
+		THEN("it should come from the index")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_STR_EQUAL(title, "Alpha");
+			SHOULD_INT_EQUAL(missions, 3);
+			SHOULD_INT_EQUAL(ci.Stats.Hits, 1);
+			SHOULD_INT_EQUAL(ci.Stats.Misses, 0);
+		CampaignIndexTerminate(&ci);
+	SCENARIO_END
+
+	SCENARIO("Scan changed campaigns")
+		GIVEN("an index of a campaign")
+			WriteCampaign(TEST_DIR "/b.cdogscpn", "Bravo", 2);
+			CampaignIndex ci;
+			CampaignIndexInit(&ci, INDEX_PATH);
+			char title[256];
+			int missions;
+			Scan(&ci, TEST_DIR "/b.cdogscpn", title, &missions);
+		WHEN("I change the campaign and scan it again")
+			WriteCampaign(TEST_DIR "/b.cdogscpn", "Bravo Two", 12);
+			const bool ok = Scan(&ci, TEST_DIR "/b.cdogscpn", title, &missions);
+		THEN("it should be scanned again")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_STR_EQUAL(title, "Bravo Two");
+			SHOULD_INT_EQUAL(missions, 12);
+			SHOULD_INT_EQUAL(ci.Stats.Misses, 2);
+		CampaignIndexTerminate(&ci);
+	SCENARIO_END
+
+	SCENARIO("Remember files that aren't campaigns")
+		GIVEN("an index with a file that isn't a campaign")
+			FILE *f = fopen(TEST_DIR "/readme.txt", "w");
+			fputs("not a campaign", f);
+			fclose(f);
+			CampaignIndex ci;
+			CampaignIndexInit(&ci, INDEX_PATH);
+			char title[256];
+			int missions;
+			Scan(&ci, TEST_DIR "/readme.txt", title, &missions);
+			CampaignIndexSave(&ci, false);
+			CampaignIndexTerminate(&ci);
+		WHEN("I scan it again")
+			CampaignIndexInit(&ci, INDEX_PATH);
+			const bool ok = Scan(&ci, TEST_DIR "/readme.txt", title, &missions);
+		THEN("it should be rejected from the index")
+			SHOULD_BE_FALSE(ok);
+			SHOULD_INT_EQUAL(ci.Stats.Hits, 1);
+			SHOULD_INT_EQUAL(ci.Stats.Misses, 0);
+		CampaignIndexTerminate(&ci);
+	SCENARIO_END
+
+	SCENARIO("Forget missing files")
+		GIVEN("an index of two campaigns")
+			WriteCampaign(TEST_DIR "/c.cdogscpn", "Charlie", 1);
+			WriteCampaign(TEST_DIR "/d.cdogscpn", "Delta", 1);
+			remove(INDEX_PATH);
+			CampaignIndex ci;
+			CampaignIndexInit(&ci, INDEX_PATH);
+			char title[256];
+			int missions;
+			Scan(&ci, TEST_DIR "/c.cdogscpn", title, &missions);
+			Scan(&ci, TEST_DIR "/d.cdogscpn", title, &missions);
+			CampaignIndexSave(&ci, true);
+			CampaignIndexTerminate(&ci);
+		WHEN("I only see one of them and save with pruning")
+			CampaignIndexInit(&ci, INDEX_PATH);
+			Scan(&ci, TEST_DIR "/c.cdogscpn", title, &missions);
+			CampaignIndexSave(&ci, true);
+			CampaignIndexTerminate(&ci);
+			CampaignIndexInit(&ci, INDEX_PATH);
+		THEN("only that one should be in the index")
+			SHOULD_INT_EQUAL(hashmap_length(ci.entries), 1);
+		CampaignIndexTerminate(&ci);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Campaign index features are:", TEST_FEATURE(CampaignIndexScan))
@@ -0,0 +1,142 @@
+// Benchmark for the cave automaton; generates 512x512 caves from fixed seeds
+// with the default cave rules, on whole tiles as cave maps used to, and with
+// the cave grid. Prints the time per cave for each.
+// Not run as part of the tests.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <c_array.h>
+#include <cave_grid.h>
+
+#define SIZE 512
+#define SEEDS 5
+#define FILL_PERCENT 45
+#define REPEAT 4
+#define R1 5
+#define R2 2
+
+// Like TileClass; the old automaton copied these around whole
+typedef struct
+{
+	int Type;
+	char Pad[124];
+} Tile;
+static bool IsWall(const CArray *tiles, const int x, const int y)
+{
+	if (x < 0 || y < 0 || x >= SIZE || y >= SIZE)
+	{
+		return true;
+	}
+	return ((const Tile *)CArrayGet(tiles, y * SIZE + x))->Type == 1;
+}
+static int CountWallsAround(
+	const CArray *tiles, const int x, const int y, const int d)
+{
+	int c = 0;
+	for (int dy = -d; dy <= d; dy++)
+	{
+		for (int dx = -d; dx <= d; dx++)
+		{
+			c += IsWall(tiles, x + dx, y + dy);
+		}
+	}
+	return c;
+}
+static int OldCave(const unsigned seed)
+{
+	CArray tiles;
+	CArrayInit(&tiles, sizeof(Tile));
+	for (int i = 0; i < SIZE * SIZE; i++)
+	{
+		Tile t;
+		memset(&t, 0, sizeof t);
+		t.Type = i < FILL_PERCENT * SIZE * SIZE / 100;
+		CArrayPushBack(&tiles, &t);
+	}
+	RngSeed(RNG_MAPGEN, seed);
+	CArrayShuffle(&tiles, RNG_MAPGEN);
+	CArray buf;
+	CArrayInitFillZero(&buf, sizeof(Tile), tiles.size);
+	for (int i = 0; i < REPEAT; i++)
+	{
+		for (int y = 0; y < SIZE; y++)
+		{
+			for (int x = 0; x < SIZE; x++)
+			{
+				Tile t;
+				memset(&t, 0, sizeof t);
+				t.Type = CountWallsAround(&tiles, x, y, 1) >= R1 ||
+						 CountWallsAround(&tiles, x, y, 2) <= R2;
+				*(Tile *)CArrayGet(&buf, y * SIZE + x) = t;
+			}
+		}
+		for (int j = 0; j < SIZE * SIZE; j++)
+		{
+			*(Tile *)CArrayGet(&tiles, j) = *(const Tile *)CArrayGet(&buf, j);
+		}
+	}
+	int walls = 0;
+	for (int j = 0; j < SIZE * SIZE; j++)
+	{
+		walls += ((const Tile *)CArrayGet(&tiles, j))->Type;
+	}
+	CArrayTerminate(&buf);
+	CArrayTerminate(&tiles);
+	return walls;
+}
+static int NewCave(const unsigned seed)
+{
+	CaveGrid g;
+	CaveGridInit(&g, svec2i(SIZE, SIZE));
+	for (int i = 0; i < FILL_PERCENT * SIZE * SIZE / 100; i++)
+	{
+		CaveGridSetWall(&g, svec2i(i % SIZE, i / SIZE), true);
+	}
+	RngSeed(RNG_MAPGEN, seed);
+	CaveGridShuffle(&g, RNG_MAPGEN);
+	for (int i = 0; i < REPEAT; i++)
+	{
+		CaveGridStep(&g, R1, R2);
+	}
+	int walls = 0;
+	for (int y = 0; y < SIZE; y++)
+	{
+		for (int x = 0; x < SIZE; x++)
+		{
+			walls += CaveGridIsWall(&g, svec2i(x, y));
+		}
+	}
+	CaveGridTerminate(&g);
+	return walls;
+}
+
+int main(void)
+{
+	int oldWalls = 0;
+	clock_t start = clock();
+	for (unsigned seed = 1; seed <= SEEDS; seed++)
+	{
+		oldWalls += OldCave(seed);
+	}
+	const double oldSecs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	int newWalls = 0;
+	start = clock();
+	for (unsigned seed = 1; seed <= SEEDS; seed++)
+	{
+		newWalls += NewCave(seed);
+	}
+	const double newSecs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("%dx%d caves, %d generations:\n", SIZE, SIZE, REPEAT);
+	printf("tiles: %.1f ms per cave\n", oldSecs * 1000 / SEEDS);
+	printf("grid: %.1f ms per cave\n", newSecs * 1000 / SEEDS);
+	if (oldWalls != newWalls)
+	{
+		printf("caves differ! %d vs %d walls\n", oldWalls, newWalls);
+		return 1;
+	}
+	return 0;
+}
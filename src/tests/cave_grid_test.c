@@ -0,0 +1,126 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <c_array.h>
+#include <cave_grid.h>
+
+// The automaton as cave maps used to run it, on whole tiles
+typedef struct
+{
+	int Type;
+	char Pad[60];
+} Tile;
+static bool IsWall(const CArray *tiles, const struct vec2i size, const int x,
+	const int y)
+{
+	if (x < 0 || y < 0 || x >= size.x || y >= size.y)
+	{
+		return true;
+	}
+	return ((const Tile *)CArrayGet(tiles, y * size.x + x))->Type == 1;
+}
+static int CountWallsAround(
+	const CArray *tiles, const struct vec2i size, const int x, const int y,
+	const int d)
+{
+	int c = 0;
+	for (int dy = -d; dy <= d; dy++)
+	{
+		for (int dx = -d; dx <= d; dx++)
+		{
+			c += IsWall(tiles, size, x + dx, y + dy);
+		}
+	}
+	return c;
+}
+static void CaveRep(
+	CArray *tiles, const struct vec2i size, const int r1, const int r2)
+{
+	CArray buf;
+	memset(&buf, 0, sizeof buf);
+	CArrayCopy(&buf, tiles);
+	for (int y = 0; y < size.y; y++)
+	{
+		for (int x = 0; x < size.x; x++)
+		{
+			Tile *t = CArrayGet(&buf, y * size.x + x);
+			t->Type = CountWallsAround(tiles, size, x, y, 1) >= r1 ||
+					  CountWallsAround(tiles, size, x, y, 2) <= r2;
+		}
+	}
+	CArrayTerminate(tiles);
+	*tiles = buf;
+}
+
+// Generate a cave both ways, from the same seed; returns the number of
+// tiles that differ
+static int Compare(
+	const struct vec2i size, const int fillPercent, const int repeat,
+	const int r1, const int r2, const unsigned seed)
+{
+	CArray tiles;
+	CArrayInit(&tiles, sizeof(Tile));
+	CaveGrid g;
+	CaveGridInit(&g, size);
+	const int n = size.x * size.y;
+	for (int i = 0; i < n; i++)
+	{
+		Tile t;
+		memset(&t, 0, sizeof t);
+		t.Type = i < fillPercent * n / 100;
+		CArrayPushBack(&tiles, &t);
+		CaveGridSetWall(&g, svec2i(i % size.x, i / size.x), t.Type == 1);
+	}
+	RngSeed(RNG_MAPGEN, seed);
+	CArrayShuffle(&tiles, RNG_MAPGEN);
+	RngSeed(RNG_MAPGEN, seed);
+	CaveGridShuffle(&g, RNG_MAPGEN);
+	for (int i = 0; i < repeat; i++)
+	{
+		CaveRep(&tiles, size, r1, r2);
+		CaveGridStep(&g, r1, r2);
+	}
+	int diffs = 0;
+	for (int i = 0; i < n; i++)
+	{
+		const struct vec2i v = svec2i(i % size.x, i / size.x);
+		diffs += IsWall(&tiles, size, v.x, v.y) != CaveGridIsWall(&g, v);
+	}
+	CArrayTerminate(&tiles);
+	CaveGridTerminate(&g);
+	return diffs;
+}
+
+
+FEATURE(CaveGridSame, "Same caves as the tile automaton")
+	SCENARIO("Generate caves of many sizes")
+		GIVEN("map widths around word boundaries")
+			const int widths[] = {1, 2, 5, 63, 64, 65, 100, 128, 130};
+			int diffs = 0;
+		WHEN("I generate caves with the default and edge case rules")
+			for (int i = 0; i < (int)(sizeof widths / sizeof widths[0]); i++)
+			{
+				const struct vec2i size = svec2i(widths[i], 3 + i * 7);
+				diffs += Compare(size, 45, 4, 5, 2, 1 + i);
+				diffs += Compare(size, 30, 2, 4, 0, 100 + i);
+				diffs += Compare(size, 60, 3, 9, 25, 200 + i);
+				diffs += Compare(size, 50, 1, 0, -1, 300 + i);
+				diffs += Compare(size, 50, 2, 10, 26, 400 + i);
+			}
+		THEN("the caves should be identical")
+			SHOULD_INT_EQUAL(diffs, 0);
+	SCENARIO_END
+
+	SCENARIO("Shuffle without generations")
+		GIVEN("a map")
+			const struct vec2i size = svec2i(77, 41);
+		WHEN("I only shuffle the walls")
+			const int diffs = Compare(size, 40, 0, 5, 2, 42);
+		THEN("they should be shuffled the same")
+			SHOULD_INT_EQUAL(diffs, 0);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Cave grid features are:", TEST_FEATURE(CaveGridSame))
@@ -0,0 +1,115 @@
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hot_reload.h>
+#include <particle.h>
+#include <sys_config.h>
+#include <utils.h>
+
+#define TEST_FILE "hot_reload_test.json"
+
+static const char *particlesText =
+	"{\"Version\": 2, \"Particles\": ["
+	"{\"Name\": \"spark\", \"Type\": \"Text\", \"RangeLow\": 10, "
+	"\"RangeHigh\": 20},"
+	"{\"Name\": \"smoke\", \"Type\": \"Text\", \"Range\": 5}]}";
+
+static void LoadParticles(const char *text)
+{
+	CArrayInit(&gParticleClasses.Classes, sizeof(ParticleClass));
+	CArrayInit(&gParticleClasses.CustomClasses, sizeof(ParticleClass));
+	json_t *root = NULL;
+	json_parse_buffer(&root, text, strlen(text));
+	ParticleClassesLoadJSON(&gParticleClasses.Classes, root);
+	json_free_value(&root);
+}
+static bool ReloadParticles(json_t *root)
+{
+	return ParticleClassesReloadJSON(&gParticleClasses.Classes, root);
+}
+// Watch a file with an absolute path, so it is not looked up in the data dir
+static void WatchFile(HotReload *h, char *path, const char *text)
+{
+	char cwd[CDOGS_PATH_MAX];
+	CDogsGetCWD(cwd);
+	sprintf(path, "%s/%s", cwd, TEST_FILE);
+	FILE *f = fopen(path, "w");
+	fputs(text, f);
+	fclose(f);
+	memset(h, 0, sizeof *h);
+	CArrayInit(&h->Files, sizeof(HotReloadFile));
+	HotReloadFile hf;
+	memset(&hf, 0, sizeof hf);
+	hf.Path = path;
+	hf.Reload = ReloadParticles;
+	CArrayPushBack(&h->Files, &hf);
+}
+static bool Reload(const char *text)
+{
+	json_t *root = NULL;
+	json_parse_buffer(&root, text, strlen(text));
+	const bool ok = ReloadParticles(root);
+	json_free_value(&root);
+	return ok;
+}
+
+
+FEATURE(HotReloadUpdate, "Reload changed data files")
+	SCENARIO("Reload a changed file")
+		GIVEN("loaded particles and a changed particles file")
+			LoadParticles(particlesText);
+			const ParticleClass *spark =
+				ParticleClassFind(&gParticleClasses, "spark");
+			HotReload h;
+			char path[CDOGS_PATH_MAX];
+			WatchFile(
+				&h, path,
+				"{\"Version\": 2, \"Particles\": ["
+				"{\"Name\": \"spark\", \"Type\": \"Text\", "
+				"\"RangeLow\": 30, \"RangeHigh\": 40},"
+				"{\"Name\": \"steam\", \"Type\": \"Text\"}]}");
+		WHEN("I check for changes")
+			HotReloadUpdate(&h, 1);
+		THEN("the class should be patched in place")
+			SHOULD_BE_TRUE(
+				ParticleClassFind(&gParticleClasses, "spark") == spark);
+			SHOULD_INT_EQUAL(spark->RangeLow, 30);
+			SHOULD_INT_EQUAL(spark->RangeHigh, 40);
+		AND("new classes should be ignored")
+			SHOULD_INT_EQUAL((int)gParticleClasses.Classes.size, 2);
+			SHOULD_BE_TRUE(
+				ParticleClassFind(&gParticleClasses, "steam") == NULL);
+		HotReloadTerminate(&h);
+		remove(path);
+		ParticleClassesTerminate(&gParticleClasses);
+	SCENARIO_END
+
+	SCENARIO("Reject invalid classes")
+		GIVEN("loaded particles")
+			LoadParticles(particlesText);
+			const ParticleClass *spark =
+				ParticleClassFind(&gParticleClasses, "spark");
+		WHEN("I reload classes with fields of the wrong type")
+			const bool badType = Reload(
+				"{\"Version\": 2, \"Particles\": ["
+				"{\"Name\": \"spark\", \"Type\": \"Text\", "
+				"\"RangeLow\": 50, \"Bounces\": 3}]}");
+		AND("with a pic that cannot be loaded")
+			const bool badPic = Reload(
+				"{\"Version\": 2, \"Particles\": ["
+				"{\"Name\": \"spark\", \"RangeLow\": 50, "
+				"\"Pic\": {\"Type\": \"Sideways\"}}]}");
+		THEN("the reloads should fail")
+			SHOULD_BE_FALSE(badType);
+			SHOULD_BE_FALSE(badPic);
+		AND("the old classes should be kept")
+			SHOULD_INT_EQUAL(spark->Type, PARTICLE_TEXT);
+			SHOULD_INT_EQUAL(spark->RangeLow, 10);
+			SHOULD_INT_EQUAL(spark->RangeHigh, 20);
+		ParticleClassesTerminate(&gParticleClasses);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Hot reload features are:", TEST_FEATURE(HotReloadUpdate))
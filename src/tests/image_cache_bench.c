@@ -0,0 +1,129 @@
+// Benchmark for the image cache; compares starting up with no cache, with
+// an empty (cold) cache and with a full (warm) one. Starting up here means
+// decoding the graphics, then masking every wall style and every char sprite
+// sheet. Writes the cache to a dir under the config dir.
+// Not run as part of the tests.
+// Usage: image_cache_bench, from the src dir like the game
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <string.h>
+
+#include <asset_loader.h>
+#include <config.h>
+#include <files.h>
+#include <grafx.h>
+#include <image_cache.h>
+#include <pic_manager.h>
+#include <pics.h>
+
+#define CACHE_SIZE (512ULL * 1024 * 1024)
+
+static int AddCharName(any_t data, any_t key)
+{
+	if (strncmp(key, "chars/", strlen("chars/")) == 0)
+	{
+		CArray *names = data;
+		char *name;
+		CSTRDUP(name, key);
+		CArrayPushBack(names, &name);
+	}
+	return MAP_OK;
+}
+
+typedef struct
+{
+	double Decode;
+	double Mask;
+	int Pics;
+} Times;
+static double Ms(const Uint64 start)
+{
+	return (double)(SDL_GetPerformanceCounter() - start) * 1000 /
+		   SDL_GetPerformanceFrequency();
+}
+static Times Startup(void)
+{
+	Times t;
+	Uint64 start = SDL_GetPerformanceCounter();
+	PicManagerInit(&gPicManager);
+	AssetLoader l;
+	AssetLoaderInit(&l, -1);
+	PicManagerQueueLoad(&l, &gPicManager);
+	AssetLoaderTerminate(&l);
+	t.Decode = Ms(start);
+	t.Pics = hashmap_length(gPicManager.pics) +
+			 hashmap_length(gPicManager.sprites);
+
+	start = SDL_GetPerformanceCounter();
+	CA_FOREACH(const char *, style, gPicManager.wallStyleNames)
+	for (int i = 0; i < WALL_TYPE_COUNT; i++)
+	{
+		PicManagerGenerateMaskedStylePic(
+			&gPicManager, "wall", *style, IntWallType(i),
+			colorBattleshipGrey, colorOfficeGreen, false);
+	}
+	CA_FOREACH_END()
+	CArray names;
+	CArrayInit(&names, sizeof(char *));
+	hashmap_iterate_keys(gPicManager.sprites, AddCharName, &names);
+	const CharColors colors = CharColorsFromOneColor(colorOfficeGreen);
+	CA_FOREACH(char *, name, names)
+	PicManagerGetCharSprites(&gPicManager, *name, &colors);
+	CFREE(*name);
+	CA_FOREACH_END()
+	CArrayTerminate(&names);
+	PicManagerWaitCharSprites(&gPicManager);
+	t.Mask = Ms(start);
+
+	PicManagerTerminate(&gPicManager);
+	return t;
+}
+static void Print(const char *name, const Times t)
+{
+	printf(
+		"%-8s decode %8.1f ms, mask %8.1f ms (%d pics); %d hits, %d "
+		"misses, %d writes\n",
+		name, t.Decode, t.Mask, t.Pics, SDL_AtomicGet(&gImageCache.Stats.Hits),
+		SDL_AtomicGet(&gImageCache.Stats.Misses),
+		SDL_AtomicGet(&gImageCache.Stats.Writes));
+}
+
+int main(void)
+{
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		printf("Failed to init SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+	gConfig = ConfigDefault();
+	ConfigResetDefault(ConfigGet(&gConfig, "Graphics"));
+	GraphicsInit(&gGraphicsDevice, &gConfig);
+	GraphicsInitialize(&gGraphicsDevice);
+	if (!gGraphicsDevice.IsInitialized)
+	{
+		printf("Failed to init graphics\n");
+		return 1;
+	}
+
+	char dir[CDOGS_PATH_MAX];
+	strcpy(dir, GetConfigFilePath("cache/images_bench"));
+
+	ImageCacheInit(&gImageCache, dir, 0);
+	Print("none", Startup());
+
+	// Prune everything for a cold start
+	ImageCacheInit(&gImageCache, dir, 1);
+	ImageCacheInit(&gImageCache, dir, CACHE_SIZE);
+	Print("cold", Startup());
+
+	ImageCacheInit(&gImageCache, dir, CACHE_SIZE);
+	const Times warm = Startup();
+	Print("warm", warm);
+	printf("cache size %.1f MB\n", SDL_AtomicGet(&gImageCache.KBytes) / 1024.0);
+
+	GraphicsTerminate(&gGraphicsDevice);
+	ConfigDestroy(&gConfig);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,132 @@
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <image_cache.h>
+#include <pic.h>
+
+#define CACHE_DIR "image_cache_test"
+
+static Pic NewPic(const struct vec2i size, const Uint32 seed)
+{
+	Pic p;
+	memset(&p, 0, sizeof p);
+	p.size = size;
+	CMALLOC(p.Data, size.x * size.y * sizeof *p.Data);
+	for (int i = 0; i < size.x * size.y; i++)
+	{
+		p.Data[i] = seed + (Uint32)i;
+	}
+	return p;
+}
+static void FreePics(CArray *pics)
+{
+	CA_FOREACH(Pic, p, *pics)
+	CFREE(p->Data);
+	CA_FOREACH_END()
+	CArrayTerminate(pics);
+}
+static bool PicsEqual(const CArray *a, const CArray *b)
+{
+	if (a->size != b->size)
+	{
+		return false;
+	}
+	CA_FOREACH(const Pic, pa, *a)
+	const Pic *pb = CArrayGet(b, _ca_index);
+	if (!svec2i_is_equal(pa->size, pb->size) ||
+		memcmp(
+			pa->Data, pb->Data,
+			pa->size.x * pa->size.y * sizeof *pa->Data) != 0)
+	{
+		return false;
+	}
+	CA_FOREACH_END()
+	return true;
+}
+
+
+FEATURE(ImageCacheLoad, "Load cached images")
+	SCENARIO("Round trip")
+		GIVEN("a cache with some pics stored")
+			ImageCache c;
+			ImageCacheInit(&c, CACHE_DIR, 1024 * 1024);
+			CArray pics;
+			CArrayInit(&pics, sizeof(Pic));
+			Pic p = NewPic(svec2i(3, 5), 1);
+			CArrayPushBack(&pics, &p);
+			p = NewPic(svec2i(8, 2), 100);
+			CArrayPushBack(&pics, &p);
+			ImageCacheStore(&c, 123, &pics);
+		WHEN("I load them")
+			CArray loaded;
+			CArrayInit(&loaded, sizeof(Pic));
+			const bool ok = ImageCacheLoad(&c, 123, &loaded);
+		THEN("they should be the same")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_BE_TRUE(PicsEqual(&pics, &loaded));
+		AND("other keys should miss")
+			CArray other;
+			CArrayInit(&other, sizeof(Pic));
+			SHOULD_BE_FALSE(ImageCacheLoad(&c, 456, &other));
+			SHOULD_INT_EQUAL((int)other.size, 0);
+		FreePics(&pics);
+		FreePics(&loaded);
+		CArrayTerminate(&other);
+		ImageCacheTerminate(&c);
+	SCENARIO_END
+
+	SCENARIO("Corrupt entry")
+		GIVEN("a stored pic whose file is then damaged")
+			ImageCache c;
+			ImageCacheInit(&c, CACHE_DIR, 1024 * 1024);
+			CArray pics;
+			CArrayInit(&pics, sizeof(Pic));
+			Pic p = NewPic(svec2i(4, 4), 7);
+			CArrayPushBack(&pics, &p);
+			ImageCacheStore(&c, 789, &pics);
+			char path[CDOGS_PATH_MAX];
+			sprintf(path, CACHE_DIR "/%016llx.cdogspx", 789ULL);
+			FILE *f = fopen(path, "r+b");
+			fseek(f, -1, SEEK_END);
+			fputc(0xff, f);
+			fclose(f);
+		WHEN("I load it")
+			CArray loaded;
+			CArrayInit(&loaded, sizeof(Pic));
+			const bool ok = ImageCacheLoad(&c, 789, &loaded);
+		THEN("it should be rejected and removed")
+			SHOULD_BE_FALSE(ok);
+			SHOULD_INT_EQUAL((int)loaded.size, 0);
+			SHOULD_INT_EQUAL(SDL_AtomicGet(&c.Stats.Corrupt), 1);
+			f = fopen(path, "rb");
+			SHOULD_BE_TRUE(f == NULL);
+		FreePics(&pics);
+		CArrayTerminate(&loaded);
+		ImageCacheTerminate(&c);
+	SCENARIO_END
+
+	SCENARIO("Size limit")
+		GIVEN("a cache with some pics stored")
+			ImageCache c;
+			ImageCacheInit(&c, CACHE_DIR, 1024 * 1024);
+			CArray pics;
+			CArrayInit(&pics, sizeof(Pic));
+			Pic p = NewPic(svec2i(64, 64), 3);
+			CArrayPushBack(&pics, &p);
+			ImageCacheStore(&c, 1000, &pics);
+		WHEN("I open it with a smaller limit")
+			ImageCacheInit(&c, CACHE_DIR, 1);
+		THEN("the entries should be pruned")
+			CArray loaded;
+			CArrayInit(&loaded, sizeof(Pic));
+			SHOULD_BE_FALSE(ImageCacheLoad(&c, 1000, &loaded));
+			SHOULD_INT_EQUAL(SDL_AtomicGet(&c.KBytes), 0);
+		FreePics(&pics);
+		CArrayTerminate(&loaded);
+		ImageCacheTerminate(&c);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Image cache features are:", TEST_FEATURE(ImageCacheLoad))
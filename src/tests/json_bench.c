@@ -0,0 +1,234 @@
+// Benchmark for the JSON parser; compares the old streaming fragment parser
+// with the arena parser used by json_stream_parse, printing parse time and
+// allocations per parse. Then compares label lookups over the class data
+// using a linear scan against json_find_first_label.
+// Not run as part of the tests.
+// Usage: json_bench [file.json...]; defaults are relative to the repo root
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <json/json.h>
+
+#define ITERATIONS 50
+#define LOOKUP_ITERATIONS 2000
+
+#ifdef JSON_BENCH_COUNT_ALLOCS
+// Linked with -Wl,--wrap=malloc etc. so the parser's allocations are counted
+static size_t allocs = 0;
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+void *__wrap_malloc(size_t size)
+{
+	allocs++;
+	return __real_malloc(size);
+}
+void *__wrap_calloc(size_t n, size_t size)
+{
+	allocs++;
+	return __real_calloc(n, size);
+}
+void *__wrap_realloc(void *p, size_t size)
+{
+	allocs++;
+	return __real_realloc(p, size);
+}
+#endif
+
+// The parser json_stream_parse used before: fragments of up to 1024 chars
+static enum json_error FragmentParse(FILE *f, json_t **root)
+{
+	char buf[1024];
+	struct json_parsing_info state;
+	json_jpi_init(&state);
+	enum json_error e = JSON_INCOMPLETE_DOCUMENT;
+	while (e == JSON_WAITING_FOR_EOF || e == JSON_INCOMPLETE_DOCUMENT)
+	{
+		if (fgets(buf, sizeof buf, f) == NULL)
+		{
+			if (e == JSON_WAITING_FOR_EOF)
+			{
+				e = JSON_OK;
+			}
+			else
+			{
+				e = JSON_UNKNOWN_PROBLEM;
+			}
+			break;
+		}
+		e = json_parse_fragment(&state, buf);
+		if (e != JSON_OK && e != JSON_WAITING_FOR_EOF &&
+			e != JSON_INCOMPLETE_DOCUMENT)
+		{
+			json_free_value(&state.cursor);
+			return e;
+		}
+	}
+	*root = state.cursor;
+	return e;
+}
+
+typedef enum json_error (*ParseFunc)(FILE *, json_t **);
+
+static void Bench(const char *path, const char *name, ParseFunc parse)
+{
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+	{
+		printf("%s: cannot open\n", path);
+		return;
+	}
+	size_t numAllocs = 0;
+	const clock_t start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		rewind(f);
+		json_t *root = NULL;
+#ifdef JSON_BENCH_COUNT_ALLOCS
+		const size_t allocsBefore = allocs;
+#endif
+		const enum json_error e = parse(f, &root);
+#ifdef JSON_BENCH_COUNT_ALLOCS
+		numAllocs = allocs - allocsBefore;
+#endif
+		if (e != JSON_OK)
+		{
+			printf("%s: %s parse error %d\n", path, name, (int)e);
+			fclose(f);
+			return;
+		}
+		json_free_value(&root);
+	}
+	const double ms =
+		(double)(clock() - start) * 1000 / CLOCKS_PER_SEC / ITERATIONS;
+#ifdef JSON_BENCH_COUNT_ALLOCS
+	printf("%s: %s %.3f ms, %zu allocs\n", path, name, ms, numAllocs);
+#else
+	(void)numAllocs;
+	printf("%s: %s %.3f ms\n", path, name, ms);
+#endif
+	fclose(f);
+}
+
+// The lookup json_find_first_label used before: a linear scan
+static json_t *LinearFind(const json_t *object, const char *label)
+{
+	json_t *cursor;
+	assert(object != NULL);
+	assert(label != NULL);
+	assert(object->type == JSON_OBJECT);
+	for (cursor = object->child; cursor != NULL; cursor = cursor->next)
+	{
+		if (strcmp(cursor->text, label) == 0)
+		{
+			break;
+		}
+	}
+	return cursor;
+}
+
+typedef json_t *(*FindFunc)(const json_t *, const char *);
+
+// Look up every member of every object, like the class loaders do,
+// plus some optional members which are missing
+static size_t LookupAll(const json_t *node, FindFunc find, size_t *indexed)
+{
+	static const char *missing[] = {"Missing", "Sound", "Index", "Hidden"};
+	size_t found = 0;
+	switch (node->type)
+	{
+	case JSON_OBJECT:
+		for (const json_t *label = node->child; label; label = label->next)
+		{
+			found += find(node, label->text) != NULL;
+			found += LookupAll(label->child, find, indexed);
+		}
+		for (int i = 0; i < (int)(sizeof missing / sizeof missing[0]); i++)
+		{
+			found += find(node, missing[i]) != NULL;
+		}
+		*indexed += node->index != NULL;
+		break;
+	case JSON_ARRAY:
+		for (const json_t *child = node->child; child; child = child->next)
+		{
+			found += LookupAll(child, find, indexed);
+		}
+		break;
+	default:
+		break;
+	}
+	return found;
+}
+
+static void BenchLookup(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+	{
+		printf("%s: cannot open\n", path);
+		return;
+	}
+	json_t *root = NULL;
+	const enum json_error e = json_stream_parse(f, &root);
+	fclose(f);
+	if (e != JSON_OK)
+	{
+		printf("%s: parse error %d\n", path, (int)e);
+		return;
+	}
+	size_t indexed = 0;
+	size_t found[2] = {0, 0};
+	double us[2];
+	const FindFunc funcs[2] = {LinearFind, json_find_first_label};
+	for (int i = 0; i < 2; i++)
+	{
+		const clock_t start = clock();
+		for (int j = 0; j < LOOKUP_ITERATIONS; j++)
+		{
+			indexed = 0;
+			found[i] = LookupAll(root, funcs[i], &indexed);
+		}
+		us[i] = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC /
+				LOOKUP_ITERATIONS;
+	}
+	printf(
+		"%s: lookups linear %.1f us, indexed %.1f us (%zu found%s, %zu "
+		"objects indexed)\n",
+		path, us[0], us[1], found[1], found[0] == found[1] ? "" : " MISMATCH",
+		indexed);
+	json_free_value(&root);
+}
+
+int main(int argc, char *argv[])
+{
+	static const char *defaultPaths[] = {
+		"data/guns.json", "data/bullets.json",
+		"missions/doom.cdogscpn/missions.json"};
+	static const char *classPaths[] = {
+		"data/ammo.json",		 "data/bullets.json",	"data/character_classes.json",
+		"data/guns.json",		 "data/map_objects.json", "data/particles.json",
+		"data/pickups.json"};
+	// Paths given on the command line replace both lists
+	const bool hasArgs = argc > 1;
+	const int numPaths =
+		hasArgs ? argc - 1
+				: (int)(sizeof defaultPaths / sizeof defaultPaths[0]);
+	const int numLookupPaths =
+		hasArgs ? argc - 1 : (int)(sizeof classPaths / sizeof classPaths[0]);
+	for (int i = 0; i < numPaths; i++)
+	{
+		const char *path = hasArgs ? argv[i + 1] : defaultPaths[i];
+		Bench(path, "fragment", FragmentParse);
+		Bench(path, "arena", json_stream_parse);
+	}
+	for (int i = 0; i < numLookupPaths; i++)
+	{
+		BenchLookup(hasArgs ? argv[i + 1] : classPaths[i]);
+	}
+	return 0;
+}
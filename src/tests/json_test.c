@@ -77,4 +77,247 @@ FEATURE(json_format_string, "String format")
 
 FEATURE_END
 
-CBEHAVE_RUN("JSON features are:", TEST_FEATURE(json_format_string))
+FEATURE(json_parse_buffer, "Arena parser")
+	SCENARIO("Parse a document")
+		GIVEN("a JSON document with nested values")
+		const char *text =
+			"{\"Name\": \"a \\\"b\\\"\", \"Num\": -12, \"F\": 2.5e1,\n"
+			" \"Arr\": [1, true, null, {}], \"Obj\": {\"X\": false}}";
+
+		WHEN("I parse it")
+		json_t *root = NULL;
+		const enum json_error e = json_parse_buffer(&root, text, strlen(text));
+
+		THEN("the parse should succeed")
+		SHOULD_INT_EQUAL((int)e, (int)JSON_OK);
+		AND("strings should keep their escapes")
+		SHOULD_STR_EQUAL(
+			json_find_first_label(root, "Name")->child->text, "a \\\"b\\\"");
+		AND("numbers should be parsed")
+		int num = 0;
+		LoadInt(&num, root, "Num");
+		SHOULD_INT_EQUAL(num, -12);
+		float f = 0;
+		LoadFloat(&f, root, "F");
+		SHOULD_BE_TRUE(f == 25.0f);
+		AND("arrays and objects should have their children")
+		const json_t *arr = json_find_first_label(root, "Arr")->child;
+		SHOULD_INT_EQUAL((int)arr->child->type, (int)JSON_NUMBER);
+		SHOULD_INT_EQUAL((int)arr->child->next->type, (int)JSON_TRUE);
+		SHOULD_INT_EQUAL((int)arr->child_end->type, (int)JSON_OBJECT);
+		SHOULD_BE_TRUE(arr->child_end->previous->next == arr->child_end);
+		bool x = true;
+		LoadBool(&x, json_find_first_label(root, "Obj")->child, "X");
+		SHOULD_BE_FALSE(x);
+
+		json_free_value(&root);
+		SHOULD_BE_TRUE(root == NULL);
+	SCENARIO_END
+
+	SCENARIO("Add to a parsed document")
+		GIVEN("a parsed document")
+		const char *text = "{\"A\": [1]}";
+		json_t *root = NULL;
+		json_parse_buffer(&root, text, strlen(text));
+
+		WHEN("I add new values to it")
+		AddIntPair(root, "B", 2);
+		json_insert_child(json_find_first_label(root, "A")->child,
+			json_new_number("3"));
+
+		THEN("the new values should be found")
+		int b = 0;
+		LoadInt(&b, root, "B");
+		SHOULD_INT_EQUAL(b, 2);
+		SHOULD_STR_EQUAL(
+			json_find_first_label(root, "A")->child->child_end->text, "3");
+		AND("the document can be freed")
+		json_free_value(&root);
+		SHOULD_BE_TRUE(root == NULL);
+	SCENARIO_END
+
+	SCENARIO("Relocatable images")
+		GIVEN("a parsed document")
+		const char *text =
+			"{\"Name\": \"a\", \"Num\": 7, \"Arr\": [1, [], {\"X\": true}]}";
+		json_t *root = NULL;
+		json_parse_buffer(&root, text, strlen(text));
+
+		WHEN("I write an image of it and load a copy of the image")
+		const size_t size = json_image_write(root, NULL, 0);
+		void *image = malloc(size);
+		json_image_write(root, image, size);
+		json_free_value(&root);
+		void *copy = malloc(size);
+		memcpy(copy, image, size);
+		json_t *loaded = json_image_load(copy, size);
+
+		THEN("the loaded tree should have the same values")
+		SHOULD_BE_TRUE(loaded != NULL);
+		char *name = GetString(loaded, "Name");
+		SHOULD_STR_EQUAL(name, "a");
+		CFREE(name);
+		int num = 0;
+		LoadInt(&num, loaded, "Num");
+		SHOULD_INT_EQUAL(num, 7);
+		const json_t *arr = json_find_first_label(loaded, "Arr")->child;
+		SHOULD_BE_TRUE(arr->child->next->child == NULL);
+		SHOULD_BE_TRUE(arr->child_end->previous == arr->child->next);
+		SHOULD_BE_TRUE(arr->child_end->parent == arr);
+		bool x = false;
+		LoadBool(&x, arr->child_end, "X");
+		SHOULD_BE_TRUE(x);
+		AND("truncated images should not load")
+		SHOULD_BE_TRUE(json_image_load(image, size - 1) == NULL);
+
+		json_free_value(&loaded);
+		SHOULD_BE_TRUE(loaded == NULL);
+		free(copy);
+		free(image);
+	SCENARIO_END
+
+	SCENARIO("Malformed documents")
+		GIVEN("documents with errors")
+		const char *trailing = "{\"A\": 1,}";
+		const char *truncated = "{\"A\": [1, 2";
+		const char *notObject = "[1]";
+		const char garbage[] = "{\"A\": 1}\0{";
+
+		WHEN("I parse them")
+		json_t *root1 = NULL;
+		json_t *root2 = NULL;
+		json_t *root3 = NULL;
+		json_t *root4 = NULL;
+		const enum json_error e1 =
+			json_parse_buffer(&root1, trailing, strlen(trailing));
+		const enum json_error e2 =
+			json_parse_buffer(&root2, truncated, strlen(truncated));
+		const enum json_error e3 =
+			json_parse_buffer(&root3, notObject, strlen(notObject));
+		const enum json_error e4 =
+			json_parse_buffer(&root4, garbage, sizeof garbage - 1);
+
+		THEN("the parse should fail")
+		SHOULD_INT_EQUAL((int)e1, (int)JSON_MALFORMED_DOCUMENT);
+		SHOULD_INT_EQUAL((int)e2, (int)JSON_INCOMPLETE_DOCUMENT);
+		SHOULD_INT_EQUAL((int)e3, (int)JSON_MALFORMED_DOCUMENT);
+		SHOULD_INT_EQUAL((int)e4, (int)JSON_MALFORMED_DOCUMENT);
+		AND("no document should be returned")
+		SHOULD_BE_TRUE(
+			root1 == NULL && root2 == NULL && root3 == NULL && root4 == NULL);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(json_find_first_label, "Label lookup")
+	SCENARIO("Objects with many members")
+		GIVEN("an object with many members, including a duplicate label")
+		json_t *root = json_new_object();
+		for (int i = 0; i < 20; i++)
+		{
+			char name[8];
+			sprintf(name, "K%d", i);
+			AddIntPair(root, name, i);
+		}
+		AddIntPair(root, "K5", 100);
+
+		WHEN("I look up its labels")
+		int k0 = -1, k19 = -1, k5 = -1;
+		LoadInt(&k0, root, "K0");
+		LoadInt(&k19, root, "K19");
+		LoadInt(&k5, root, "K5");
+
+		THEN("the first label with each name should be found")
+		SHOULD_INT_EQUAL(k0, 0);
+		SHOULD_INT_EQUAL(k19, 19);
+		SHOULD_INT_EQUAL(k5, 5);
+		AND("missing labels should not be found")
+		SHOULD_BE_TRUE(json_find_first_label(root, "K20") == NULL);
+		SHOULD_BE_TRUE(json_find_first_label(root, "K") == NULL);
+		AND("labels added later should be found")
+		AddIntPair(root, "K20", 20);
+		int k20 = -1;
+		LoadInt(&k20, root, "K20");
+		SHOULD_INT_EQUAL(k20, 20);
+		AND("the lookups should not have written to the tree")
+		SHOULD_INT_EQUAL(
+			json_find_first_label(root, "K0")->visited, JSON_VISIT_UNTRACKED);
+
+		json_free_value(&root);
+	SCENARIO_END
+
+	SCENARIO("Tracking visited labels")
+		GIVEN("a parsed document that tracks visits")
+		const char *text = "{\"A\": 1, \"B\": {\"C\": 2, \"D\": 3}}";
+		json_t *root = NULL;
+		SHOULD_INT_EQUAL(
+			json_parse_buffer(&root, text, strlen(text)), JSON_OK);
+		json_track_visits(root);
+
+		WHEN("I look up some of its labels")
+		int a = 0, c = 0;
+		LoadInt(&a, root, "A");
+		LoadInt(&c, json_find_first_label(root, "B")->child, "C");
+
+		THEN("only the labels looked up should be visited")
+		SHOULD_INT_EQUAL(a, 1);
+		SHOULD_INT_EQUAL(c, 2);
+		const json_t *b = json_find_first_label(root, "B");
+		SHOULD_INT_EQUAL(b->visited, JSON_VISIT_DONE);
+		SHOULD_INT_EQUAL(
+			json_find_first_label(b->child, "C")->visited, JSON_VISIT_DONE);
+		SHOULD_INT_EQUAL(b->child->child_end->visited, JSON_VISIT_PENDING);
+
+		json_free_value(&root);
+	SCENARIO_END
+
+	SCENARIO("Parsed objects with many members")
+		GIVEN("a parsed document with a large and a small object")
+		const char *text =
+			"{\"Big\": {\"K0\": 0, \"K1\": 1, \"K2\": 2, \"K3\": 3, "
+			"\"K4\": 4, \"K5\": 5, \"K1\": 100}, \"Small\": {\"K0\": 0}}";
+		json_t *root = NULL;
+		json_parse_buffer(&root, text, strlen(text));
+
+		WHEN("I look up their labels")
+		const json_t *big = json_find_first_label(root, "Big")->child;
+		const json_t *small = json_find_first_label(root, "Small")->child;
+		const json_t *k1 = json_find_first_label(big, "K1");
+		const json_t *k5 = json_find_first_label(big, "K5");
+
+		THEN("only the large object should be indexed")
+		SHOULD_BE_TRUE(big->index != NULL);
+		SHOULD_BE_TRUE(small->index == NULL);
+		AND("the first label with each name should be found")
+		SHOULD_STR_EQUAL(k1->child->text, "1");
+		SHOULD_STR_EQUAL(k5->child->text, "5");
+		SHOULD_BE_TRUE(json_find_first_label(big, "K6") == NULL);
+
+		json_free_value(&root);
+	SCENARIO_END
+
+	SCENARIO("Find nodes by path")
+		GIVEN("a parsed document with nested objects")
+		const char *text = "{\"A\": {\"B\": {\"C\": 3}}, \"D\": 4}";
+		json_t *root = NULL;
+		json_parse_buffer(&root, text, strlen(text));
+
+		WHEN("I find nodes by their paths")
+		const json_t *c = JSONFindNode(root, "A/B/C");
+		const json_t *d = JSONFindNode(root, "D");
+		const json_t *missing = JSONFindNode(root, "A/X/C");
+
+		THEN("the nodes at those paths should be found")
+		SHOULD_STR_EQUAL(c->text, "3");
+		SHOULD_STR_EQUAL(d->text, "4");
+		SHOULD_BE_TRUE(missing == NULL);
+
+		json_free_value(&root);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"JSON features are:",
+	TEST_FEATURE(json_format_string),
+	TEST_FEATURE(json_parse_buffer),
+	TEST_FEATURE(json_find_first_label)
+)
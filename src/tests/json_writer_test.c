@@ -0,0 +1,523 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <autosave.h>
+#include <config.h>
+#include <config_json.h>
+#include <json_utils.h>
+#include <json_writer.h>
+#include <map_archive.h>
+#include <map_object.h>
+#include <pickup_class.h>
+#include <sys_specifics.h>
+#include <weapon_class.h>
+
+#define TMP_FILE "json_writer_test.json"
+
+// Same as one tree parsed from the other: same types, keys, text and order
+static bool TreesEqual(const json_t *a, const json_t *b)
+{
+	if (a == NULL || b == NULL)
+	{
+		return a == b;
+	}
+	if (a->type != b->type)
+	{
+		return false;
+	}
+	if ((a->text == NULL) != (b->text == NULL) ||
+		(a->text != NULL && strcmp(a->text, b->text) != 0))
+	{
+		return false;
+	}
+	const json_t *ca = a->child;
+	const json_t *cb = b->child;
+	for (; ca != NULL && cb != NULL; ca = ca->next, cb = cb->next)
+	{
+		if (!TreesEqual(ca, cb))
+		{
+			return false;
+		}
+	}
+	return ca == NULL && cb == NULL;
+}
+// Save the tree the way files were saved before the writer
+static json_t *ParseTree(json_t *root)
+{
+	char *text;
+	json_tree_to_string(root, &text);
+	char *ftext = json_format_string(text);
+	json_t *parsed = NULL;
+	json_parse_document(&parsed, ftext);
+	CFREE(text);
+	CFREE(ftext);
+	return parsed;
+}
+static json_t *ParseFile(const char *filename)
+{
+	json_t *parsed = NULL;
+	FILE *f = fopen(filename, "r");
+	if (f != NULL)
+	{
+		json_stream_parse(f, &parsed);
+		fclose(f);
+	}
+	return parsed;
+}
+
+static const char *tricky = "quotes \" slash / back \\ tab \t\nnew é";
+
+static json_t *Vec2iNode(const struct vec2i v)
+{
+	json_t *node = json_new_array();
+	char buf[32];
+	sprintf(buf, "%d", v.x);
+	json_insert_child(node, json_new_number(buf));
+	sprintf(buf, "%d", v.y);
+	json_insert_child(node, json_new_number(buf));
+	return node;
+}
+static json_t *MakeTree(const CArray *ints)
+{
+	json_t *root = json_new_object();
+	AddIntPair(root, "Version", 17);
+	AddIntPair(root, "Negative", -2147483647 - 1);
+	AddBoolPair(root, "Yes", true);
+	AddBoolPair(root, "No", false);
+	AddStringPair(root, "Tricky", tricky);
+	AddStringPair(root, "Null", NULL);
+	AddColorPair(root, "Color", colorRed);
+	AddVec2iPair(root, "Vec", svec2i(-3, 4));
+	AddRect2iPair(root, "Rect", Rect2iNew(svec2i(1, 2), svec2i(3, 4)));
+	AddIntArray(root, "Ints", ints);
+	json_insert_pair_into_object(root, "EmptyArray", json_new_array());
+	json_insert_pair_into_object(root, "EmptyObject", json_new_object());
+	json_t *rows = json_new_array();
+	json_insert_child(rows, json_new_string("1,2,3"));
+	json_insert_child(rows, json_new_string("4,5,6"));
+	json_insert_child(rows, json_new_string("7,8,9"));
+	json_insert_pair_into_object(root, "Rows", rows);
+	json_t *objs = json_new_array();
+	for (int i = 0; i < 3; i++)
+	{
+		json_t *obj = json_new_object();
+		AddIntPair(obj, "Index", i);
+		json_t *positions = json_new_array();
+		for (int j = 0; j < i; j++)
+		{
+			json_insert_child(positions, Vec2iNode(svec2i(i, j)));
+		}
+		json_insert_pair_into_object(obj, "Positions", positions);
+		json_t *nested = json_new_object();
+		AddStringPair(nested, "Name", "nested");
+		json_insert_pair_into_object(obj, "Nested", nested);
+		json_insert_child(objs, obj);
+	}
+	json_insert_pair_into_object(root, "Objects", objs);
+	return root;
+}
+static void WriteDoc(JSONWriter *w, const CArray *ints)
+{
+	JSONWriterBeginObject(w, NULL);
+	JSONWriterInt(w, "Version", 17);
+	JSONWriterInt(w, "Negative", -2147483647 - 1);
+	JSONWriterBool(w, "Yes", true);
+	JSONWriterBool(w, "No", false);
+	JSONWriterString(w, "Tricky", tricky);
+	JSONWriterString(w, "Null", NULL);
+	JSONWriterColor(w, "Color", colorRed);
+	JSONWriterVec2i(w, "Vec", svec2i(-3, 4));
+	JSONWriterRect2i(w, "Rect", Rect2iNew(svec2i(1, 2), svec2i(3, 4)));
+	JSONWriterIntArray(w, "Ints", ints);
+	JSONWriterBeginArray(w, "EmptyArray");
+	JSONWriterEndArray(w);
+	JSONWriterBeginObject(w, "EmptyObject");
+	JSONWriterEndObject(w);
+	JSONWriterBeginArray(w, "Rows");
+	JSONWriterString(w, NULL, "1,2,3");
+	JSONWriterString(w, NULL, "4,5,6");
+	JSONWriterString(w, NULL, "7,8,9");
+	JSONWriterEndArray(w);
+	JSONWriterBeginArray(w, "Objects");
+	for (int i = 0; i < 3; i++)
+	{
+		JSONWriterBeginObject(w, NULL);
+		JSONWriterInt(w, "Index", i);
+		JSONWriterBeginArray(w, "Positions");
+		for (int j = 0; j < i; j++)
+		{
+			JSONWriterVec2i(w, NULL, svec2i(i, j));
+		}
+		JSONWriterEndArray(w);
+		JSONWriterBeginObject(w, "Nested");
+		JSONWriterString(w, "Name", "nested");
+		JSONWriterEndObject(w);
+		JSONWriterEndObject(w);
+	}
+	JSONWriterEndArray(w);
+	JSONWriterEndObject(w);
+}
+
+// As config files were saved before the writer
+static void ConfigSaveVisitTree(const Config *c, json_t *node)
+{
+	switch (c->Type)
+	{
+	case CONFIG_TYPE_INT:
+		AddIntPair(node, c->Name, c->u.Int.Value);
+		break;
+	case CONFIG_TYPE_BOOL:
+		json_insert_pair_into_object(
+			node, c->Name, json_new_bool(c->u.Bool.Value));
+		break;
+	case CONFIG_TYPE_ENUM:
+		JSON_UTILS_ADD_ENUM_PAIR(
+			node, c->Name, c->u.Enum.Value, c->u.Enum.EnumToStr);
+		break;
+	case CONFIG_TYPE_GROUP:
+		{
+			json_t *child = node;
+			if (c->Name != NULL)
+			{
+				child = json_new_object();
+			}
+			CA_FOREACH(const Config, cg, c->u.Group)
+				ConfigSaveVisitTree(cg, child);
+			CA_FOREACH_END()
+			if (c->Name != NULL)
+			{
+				json_insert_pair_into_object(node, c->Name, child);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+// Names that need escaping, for the saved campaign's classes
+static const char *trickyGun = "Gun \"with\" \\ quotes";
+static const char *trickyObject = "barrel \"red\"";
+static const char *trickyPickup = "health\tpack";
+
+#define SAVED_ARCHIVE "json_writer_test.cdogscpn"
+static const char *campaignFiles[] = {
+	"campaign.json", "missions.json", "characters.json"};
+#define NUM_CAMPAIGN_FILES                                                    \
+	(sizeof campaignFiles / sizeof campaignFiles[0])
+// A static mission with a tile class, a tile layout, and classes that are
+// saved by name
+static void AddStaticMission(
+	CArray *missions, const WeaponClass *wc, const MapObject *mo,
+	const PickupClass *pc)
+{
+	Mission m;
+	memset(&m, 0, sizeof m);
+	CSTRDUP(m.Title, tricky);
+	CSTRDUP(m.Description, "");
+	m.Type = MAPTYPE_STATIC;
+	m.Size = svec2i(3, 2);
+	strcpy(m.ExitStyle, "plate2");
+	strcpy(m.KeyStyle, "office");
+	CArrayInit(&m.Objectives, sizeof(Objective));
+	CArrayInit(&m.Enemies, sizeof(int));
+	CArrayInit(&m.SpecialChars, sizeof(int));
+	CArrayInit(&m.MapObjectDensities, sizeof(MapObjectDensity));
+	const MapObjectDensity mod = {mo, 3};
+	CArrayPushBack(&m.MapObjectDensities, &mod);
+	CArrayInit(&m.Weapons, sizeof(const WeaponClass *));
+	CArrayPushBack(&m.Weapons, &wc);
+
+	MissionStatic *ms = &m.u.Static;
+	MissionStaticInit(ms);
+	TileClass *tc;
+	CCALLOC(tc, sizeof *tc);
+	CSTRDUP(tc->Name, "tile");
+	CSTRDUP(tc->Style, "rock");
+	tc->canWalk = true;
+	hashmap_put(ms->TileClasses, "0", (any_t)tc);
+	for (int i = 0; i < m.Size.x * m.Size.y; i++)
+	{
+		const int tile = 0;
+		const uint16_t access = (uint16_t)(i == 4 ? 1 : 0);
+		CArrayPushBack(&ms->Tiles, &tile);
+		CArrayPushBack(&ms->Access, &access);
+	}
+	MapObjectPositions mop = {mo, {0}};
+	CArrayInit(&mop.Positions, sizeof(struct vec2i));
+	const struct vec2i itemPos = svec2i(1, 0);
+	CArrayPushBack(&mop.Positions, &itemPos);
+	CArrayPushBack(&ms->Items, &mop);
+	PickupPositions pp = {pc, {0}};
+	CArrayInit(&pp.Positions, sizeof(struct vec2i));
+	const struct vec2i pickupPos = svec2i(0, 1);
+	CArrayPushBack(&pp.Positions, &pickupPos);
+	CArrayPushBack(&ms->Pickups, &pp);
+	CArrayPushBack(missions, &m);
+}
+static bool ArraysEqual(const CArray *a, const CArray *b)
+{
+	return a->size == b->size && a->elemSize == b->elemSize &&
+		   memcmp(a->data, b->data, a->size * a->elemSize) == 0;
+}
+static void RemoveStaticMission(Mission *m)
+{
+	CA_FOREACH(MapObjectPositions, mop, m->u.Static.Items)
+	CArrayTerminate(&mop->Positions);
+	CA_FOREACH_END()
+	CA_FOREACH(PickupPositions, pp, m->u.Static.Pickups)
+	CArrayTerminate(&pp->Positions);
+	CA_FOREACH_END()
+	MissionTerminate(m);
+}
+// Save with MapArchiveSave and parse each file it wrote
+static bool SaveCampaign(json_t **roots, CampaignSetting *c)
+{
+	if (!MapArchiveSave(SAVED_ARCHIVE, c))
+	{
+		return false;
+	}
+	for (int i = 0; i < (int)NUM_CAMPAIGN_FILES; i++)
+	{
+		char path[CDOGS_PATH_MAX];
+		sprintf(path, "%s/%s", SAVED_ARCHIVE, campaignFiles[i]);
+		roots[i] = ParseFile(path);
+		if (roots[i] == NULL)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static void RemoveCampaign(const char *archive)
+{
+	for (int i = 0; i < (int)NUM_CAMPAIGN_FILES; i++)
+	{
+		char path[CDOGS_PATH_MAX];
+		sprintf(path, "%s/%s", archive, campaignFiles[i]);
+		remove(path);
+	}
+	rmdir(archive);
+}
+
+
+FEATURE(JSONWriterSame, "Same output as the tree")
+	SCENARIO("Write a document")
+		GIVEN("a document built as a tree")
+			CArray ints;
+			CArrayInit(&ints, sizeof(int));
+			for (int i = -5; i < 100; i += 7)
+			{
+				CArrayPushBack(&ints, &i);
+			}
+			json_t *root = MakeTree(&ints);
+			json_t *expected = ParseTree(root);
+			SHOULD_BE_TRUE(expected != NULL);
+		WHEN("I write the same document with the writer")
+			JSONWriter w;
+			const bool opened = JSONWriterOpen(&w, TMP_FILE);
+			if (opened)
+			{
+				WriteDoc(&w, &ints);
+			}
+			const bool closed = opened && JSONWriterClose(&w);
+		THEN("it should parse to the same tree")
+			SHOULD_BE_TRUE(closed);
+			json_t *parsed = ParseFile(TMP_FILE);
+			SHOULD_BE_TRUE(parsed != NULL);
+			SHOULD_BE_TRUE(TreesEqual(expected, parsed));
+			json_free_value(&root);
+			json_free_value(&expected);
+			json_free_value(&parsed);
+			CArrayTerminate(&ints);
+			remove(TMP_FILE);
+	SCENARIO_END
+
+	SCENARIO("Write a config")
+		GIVEN("the default config saved as a tree")
+			Config config = ConfigDefault();
+			ConfigGet(&config, "Game.FriendlyFire")->u.Bool.Value = true;
+			ConfigGet(&config, "Graphics.Brightness")->u.Int.Value = -3;
+			json_t *root = json_new_object();
+			AddIntPair(root, "Version", CONFIG_VERSION);
+			ConfigSaveVisitTree(&config, root);
+			json_t *expected = ParseTree(root);
+		WHEN("I save the config")
+			ConfigSaveJSON(&config, TMP_FILE);
+		THEN("it should parse to the same tree")
+			json_t *parsed = ParseFile(TMP_FILE);
+			SHOULD_BE_TRUE(parsed != NULL);
+			SHOULD_BE_TRUE(TreesEqual(expected, parsed));
+			json_free_value(&root);
+			json_free_value(&expected);
+			json_free_value(&parsed);
+			ConfigDestroy(&config);
+			remove(TMP_FILE);
+	SCENARIO_END
+
+	SCENARIO("Write a long document")
+		GIVEN("an array longer than the write buffer")
+			CArray ints;
+			CArrayInit(&ints, sizeof(int));
+			for (int i = 0; i < JSON_WRITER_BUF_SIZE; i++)
+			{
+				CArrayPushBack(&ints, &i);
+			}
+			json_t *root = json_new_object();
+			AddIntArray(root, "Ints", &ints);
+			json_t *expected = ParseTree(root);
+		WHEN("I write it")
+			JSONWriter w;
+			const bool opened = JSONWriterOpen(&w, TMP_FILE);
+			if (opened)
+			{
+				JSONWriterBeginObject(&w, NULL);
+				JSONWriterIntArray(&w, "Ints", &ints);
+				JSONWriterEndObject(&w);
+			}
+			const bool closed = opened && JSONWriterClose(&w);
+		THEN("it should parse to the same tree")
+			SHOULD_BE_TRUE(closed);
+			json_t *parsed = ParseFile(TMP_FILE);
+			SHOULD_BE_TRUE(TreesEqual(expected, parsed));
+			json_free_value(&root);
+			json_free_value(&expected);
+			json_free_value(&parsed);
+			CArrayTerminate(&ints);
+			remove(TMP_FILE);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(JSONWriterRoundTrip, "Saved files load back the same")
+	SCENARIO("Save a campaign")
+		GIVEN("a campaign with strings and class names that need escaping")
+			gConfig = ConfigDefault();
+			ConfigGet(&gConfig, "CompactTiles")->u.Bool.Value = true;
+			WeaponClass wc;
+			memset(&wc, 0, sizeof wc);
+			CSTRDUP(wc.name, trickyGun);
+			MapObject mo;
+			memset(&mo, 0, sizeof mo);
+			CSTRDUP(mo.Name, trickyObject);
+			PickupClass pc;
+			memset(&pc, 0, sizeof pc);
+			CSTRDUP(pc.Name, trickyPickup);
+			CampaignSetting c;
+			CampaignSettingInit(&c);
+			CFREE(c.Title);
+			CSTRDUP(c.Title, tricky);
+			CFREE(c.Description);
+			CSTRDUP(c.Description, tricky);
+			AddStaticMission(&c.Missions, &wc, &mo, &pc);
+		WHEN("I save it")
+			json_t *roots[NUM_CAMPAIGN_FILES] = {NULL};
+			SHOULD_BE_TRUE(SaveCampaign(roots, &c));
+		THEN("its strings should load back unescaped")
+			char *title = GetString(roots[0], "Title");
+			SHOULD_STR_EQUAL(title, tricky);
+			int version = 0;
+			LoadInt(&version, roots[0], "Version");
+			SHOULD_INT_EQUAL(version, MAP_VERSION);
+			json_t *node =
+				json_find_first_label(roots[1], "Missions")->child->child;
+			char *missionTitle = GetString(node, "Title");
+			SHOULD_STR_EQUAL(missionTitle, tricky);
+		AND("so should its class names")
+			char *gun = json_unescape(
+				json_find_first_label(node, "Weapons")->child->child->text);
+			SHOULD_STR_EQUAL(gun, trickyGun);
+			char *density = GetString(
+				json_find_first_label(node, "MapObjectDensities")
+					->child->child,
+				"MapObject");
+			SHOULD_STR_EQUAL(density, trickyObject);
+			char *item = GetString(
+				json_find_first_label(node, "StaticItems")->child->child,
+				"MapObject");
+			SHOULD_STR_EQUAL(item, trickyObject);
+			char *pickup = GetString(
+				json_find_first_label(node, "StaticPickups")->child->child,
+				"Pickup");
+			SHOULD_STR_EQUAL(pickup, trickyPickup);
+		AND("its tiles should load back the same")
+			CArray tiles, access;
+			CArrayInit(&tiles, sizeof(int));
+			CArrayInit(&access, sizeof(uint16_t));
+			const Mission *m = CArrayGet(&c.Missions, 0);
+			SHOULD_BE_TRUE(
+				MissionStaticLoadTiles(&tiles, &access, node, m->Size));
+			SHOULD_BE_TRUE(ArraysEqual(&tiles, &m->u.Static.Tiles));
+			SHOULD_BE_TRUE(ArraysEqual(&access, &m->u.Static.Access));
+			CFREE(title);
+			CFREE(missionTitle);
+			CFREE(gun);
+			CFREE(density);
+			CFREE(item);
+			CFREE(pickup);
+			CArrayTerminate(&tiles);
+			CArrayTerminate(&access);
+			for (int i = 0; i < (int)NUM_CAMPAIGN_FILES; i++)
+			{
+				json_free_value(&roots[i]);
+			}
+			RemoveStaticMission(CArrayGet(&c.Missions, 0));
+			CArrayClear(&c.Missions);
+			CampaignSettingTerminate(&c);
+			CFREE(wc.name);
+			CFREE(mo.Name);
+			CFREE(pc.Name);
+			RemoveCampaign(SAVED_ARCHIVE);
+	SCENARIO_END
+
+	SCENARIO("Save and reload an autosave")
+		GIVEN("an autosave with escaped strings")
+			Autosave a1;
+			AutosaveInit(&a1);
+			CampaignSave cs;
+			CampaignSaveInit(&cs);
+			CSTRDUP(cs.Campaign.Path, "missions/\"quoted\" path.cdogscpn");
+			cs.NextMission = 2;
+			const int completed = 1;
+			CArrayPushBack(&cs.MissionsCompleted, &completed);
+			PlayerSave ps;
+			memset(&ps, 0, sizeof ps);
+			CArrayInit(&ps.ammo, sizeof(int));
+			CSTRDUP(ps.Guns[0], trickyGun);
+			CArrayPushBack(&ps.ammo, &completed);
+			ps.Lives = 3;
+			CArrayPushBack(&cs.Players, &ps);
+			AutosaveAddCampaign(&a1, &cs);
+		WHEN("I save, load and save it again")
+			AutosaveSave(&a1, TMP_FILE);
+			json_t *saved1 = ParseFile(TMP_FILE);
+			Autosave a2;
+			AutosaveInit(&a2);
+			AutosaveLoad(&a2, TMP_FILE);
+			AutosaveSave(&a2, TMP_FILE);
+			json_t *saved2 = ParseFile(TMP_FILE);
+		THEN("both saves should be the same")
+			SHOULD_BE_TRUE(saved1 != NULL);
+			SHOULD_BE_TRUE(TreesEqual(saved1, saved2));
+		AND("the strings should load unescaped")
+			SHOULD_INT_EQUAL((int)a2.Campaigns.size, 1);
+			const CampaignSave *cs2 = CArrayGet(&a2.Campaigns, 0);
+			SHOULD_STR_EQUAL(cs2->Campaign.Path, cs.Campaign.Path);
+			SHOULD_INT_EQUAL((int)cs2->Players.size, 1);
+			const PlayerSave *ps2 = CArrayGet(&cs2->Players, 0);
+			SHOULD_STR_EQUAL(ps2->Guns[0], trickyGun);
+			json_free_value(&saved1);
+			json_free_value(&saved2);
+			AutosaveTerminate(&a1);
+			AutosaveTerminate(&a2);
+			remove(TMP_FILE);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"JSON writer features are:", TEST_FEATURE(JSONWriterSame),
+	TEST_FEATURE(JSONWriterRoundTrip))
@@ -0,0 +1,64 @@
+#include <cbehave/cbehave.h>
+
+#include <los.h>
+
+
+// Set the tiles of a LOS from a string of '#' for visible and '.' for not
+static void SetLOS(LineOfSight *los, const char *tiles)
+{
+	CArrayClear(&los->LOS);
+	for (int i = 0; tiles[i] != '\0'; i++)
+	{
+		const bool v = tiles[i] == '#';
+		CArrayPushBack(&los->LOS, &v);
+	}
+}
+static bool LOSEquals(const LineOfSight *los, const char *tiles)
+{
+	for (int i = 0; i < (int)los->LOS.size; i++)
+	{
+		if (*(const bool *)CArrayGet(&los->LOS, i) != (tiles[i] == '#'))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+// 40 tiles, so that the bits span more than one word
+static const char *sView1 = "#..#....#.........................##...#";
+static const char *sView2 = "##......................#..........#....";
+static const char *sUnion = "##.#....#...............#.........##...#";
+
+
+FEATURE(LOSBits, "Packed LOS for split screen views")
+	SCENARIO("Pack and combine views")
+		GIVEN("the LOS of two views")
+			LineOfSight los;
+			CArrayInit(&los.LOS, sizeof(bool));
+			LOSBits views[2];
+			LOSBitsInit(&views[0]);
+			LOSBitsInit(&views[1]);
+			SetLOS(&los, sView1);
+			LOSBitsFromLOS(&views[0], &los);
+			SetLOS(&los, sView2);
+			LOSBitsFromLOS(&views[1], &los);
+		WHEN("I get the union of the packed views")
+			LOSBitsUnionToLOS(&los, views, 2);
+		THEN("each view's bits should match its LOS")
+			int mismatches = 0;
+			for (int i = 0; i < 40; i++)
+			{
+				mismatches += LOSBitsGet(&views[0], i) != (sView1[i] == '#');
+				mismatches += LOSBitsGet(&views[1], i) != (sView2[i] == '#');
+			}
+			SHOULD_INT_EQUAL(mismatches, 0);
+			SHOULD_INT_EQUAL((int)views[0].Words.size, 2);
+		AND("the LOS should be the union of the views")
+			SHOULD_BE_TRUE(LOSEquals(&los, sUnion));
+		LOSBitsTerminate(&views[0]);
+		LOSBitsTerminate(&views[1]);
+		CArrayTerminate(&los.LOS);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("LOS features are:", TEST_FEATURE(LOSBits))
@@ -0,0 +1,187 @@
+#include <cbehave/cbehave.h>
+
+#include <map_placement.h>
+
+#include <string.h>
+
+
+// Maps are drawn with '#' for walls, '.' for floors and 'r' for room floors
+static TileClass sWall = {.Type = TILE_CLASS_WALL};
+static TileClass sFloor = {.canWalk = true, .Type = TILE_CLASS_FLOOR};
+static TileClass sRoom = {
+	.canWalk = true, .IsRoom = true, .Type = TILE_CLASS_FLOOR};
+static Map MakeMap(const char *rows, const int width, const int height)
+{
+	Map m;
+	memset(&m, 0, sizeof m);
+	m.Size = svec2i(width, height);
+	CArrayInit(&m.Tiles, sizeof(Tile));
+	for (int i = 0; i < width * height; i++)
+	{
+		Tile t;
+		memset(&t, 0, sizeof t);
+		t.Class = rows[i] == '#' ? &sWall : rows[i] == 'r' ? &sRoom : &sFloor;
+		CArrayPushBack(&m.Tiles, &t);
+	}
+	return m;
+}
+static const char *sRows = "######"
+						   "#....#"
+						   "#.rr.#"
+						   "#....#"
+						   "######";
+
+typedef struct
+{
+	const Map *Map;
+	bool Accept;
+	int Calls;
+	int *Seen; // times each tile was tried
+} TryPlaceData;
+static bool TryPlace(void *data, const struct vec2i v)
+{
+	TryPlaceData *d = data;
+	d->Calls++;
+	d->Seen[v.y * d->Map->Size.x + v.x]++;
+	return d->Accept;
+}
+// Count tiles that were tried more than once, or that aren't walkable
+static int CountBadTries(const TryPlaceData *d)
+{
+	int bad = 0;
+	for (int i = 0; i < d->Map->Size.x * d->Map->Size.y; i++)
+	{
+		const Tile *t = CArrayGet(&d->Map->Tiles, i);
+		bad += d->Seen[i] > 1 || (d->Seen[i] > 0 && !t->Class->canWalk);
+	}
+	return bad;
+}
+
+
+FEATURE(MapPlacementInit, "Tile rules")
+	SCENARIO("Rules of a small map")
+		GIVEN("a map with a room surrounded by floor and walls")
+			Map m = MakeMap(sRows, 6, 5);
+		WHEN("I set up placement")
+			MapPlacement mp;
+			MapPlacementInit(&mp, &m, RNG_MAPGEN);
+		THEN("corner floors should count their walls")
+			SHOULD_INT_EQUAL(
+				MapPlacementGetWallsAdjacent(&mp, svec2i(1, 1)), 2);
+			SHOULD_INT_EQUAL(MapPlacementGetWallsAround(&mp, svec2i(1, 1)), 5);
+			const int corner = MapPlacementGetRules(&mp, svec2i(1, 1));
+			SHOULD_BE_TRUE(corner & (1 << PLACEMENT_ONE_OR_MORE_WALLS));
+			SHOULD_BE_FALSE(corner & (1 << PLACEMENT_ONE_WALL));
+			SHOULD_BE_TRUE(corner & (1 << PLACEMENT_ON_WALL));
+			SHOULD_BE_TRUE(corner & (1 << PLACEMENT_OUTSIDE));
+			SHOULD_BE_TRUE(corner & PLACEMENT_RULE_WALKABLE);
+		AND("floors along a wall should have one wall")
+			const int side = MapPlacementGetRules(&mp, svec2i(2, 1));
+			SHOULD_BE_TRUE(side & (1 << PLACEMENT_ONE_WALL));
+			SHOULD_BE_TRUE(side & (1 << PLACEMENT_FREE_IN_FRONT));
+		AND("room floors should be inside with no walls")
+			const int room = MapPlacementGetRules(&mp, svec2i(2, 2));
+			SHOULD_BE_TRUE(room & (1 << PLACEMENT_INSIDE));
+			SHOULD_BE_TRUE(room & (1 << PLACEMENT_NO_WALLS));
+			SHOULD_BE_FALSE(room & (1 << PLACEMENT_OUTSIDE));
+			SHOULD_BE_FALSE(room & (1 << PLACEMENT_ON_WALL));
+		AND("walls at the edge should not count walls")
+			SHOULD_INT_EQUAL(MapPlacementGetWallsAround(&mp, svec2i(0, 0)), 0);
+			SHOULD_BE_FALSE(
+				MapPlacementGetRules(&mp, svec2i(0, 0)) &
+				PLACEMENT_RULE_WALKABLE);
+		AND("the floor in front of the bottom wall should not be free")
+			SHOULD_BE_FALSE(
+				MapPlacementGetRules(&mp, svec2i(1, 3)) &
+				(1 << PLACEMENT_FREE_IN_FRONT));
+		MapPlacementTerminate(&mp);
+		CArrayTerminate(&m.Tiles);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(MapPlacementTryPlace, "Place on candidate tiles")
+	SCENARIO("Use up every tile")
+		GIVEN("placement for a map with 12 walkable tiles")
+			Map m = MakeMap(sRows, 6, 5);
+			MapPlacement mp;
+			MapPlacementInit(&mp, &m, RNG_MAPGEN);
+			SHOULD_INT_EQUAL(
+				MapPlacementCount(&mp, PLACEMENT_RULE_WALKABLE), 12);
+			TryPlaceData d;
+			d.Map = &m;
+			d.Accept = true;
+			d.Calls = 0;
+			CCALLOC(d.Seen, 6 * 5 * sizeof *d.Seen);
+		WHEN("I place on walkable tiles until it fails")
+			int placed = 0;
+			while (MapPlacementTryPlace(
+				&mp, PLACEMENT_RULE_WALKABLE, TryPlace, &d))
+			{
+				placed++;
+			}
+		THEN("every walkable tile should be used once")
+			SHOULD_INT_EQUAL(placed, 12);
+			SHOULD_INT_EQUAL(d.Calls, 12);
+			SHOULD_INT_EQUAL(CountBadTries(&d), 0);
+		AND("the count should include used tiles")
+			SHOULD_INT_EQUAL(
+				MapPlacementCount(&mp, PLACEMENT_RULE_WALKABLE), 12);
+		CFREE(d.Seen);
+		MapPlacementTerminate(&mp);
+		CArrayTerminate(&m.Tiles);
+	SCENARIO_END
+	SCENARIO("Fail after trying each tile once")
+		GIVEN("placement for a map with 2 room tiles")
+			Map m = MakeMap(sRows, 6, 5);
+			MapPlacement mp;
+			MapPlacementInit(&mp, &m, RNG_MAPGEN);
+			TryPlaceData d;
+			d.Map = &m;
+			d.Accept = false;
+			d.Calls = 0;
+			CCALLOC(d.Seen, 6 * 5 * sizeof *d.Seen);
+		WHEN("I try to place on room tiles and every tile is rejected")
+			const int rules =
+				PLACEMENT_RULE_WALKABLE | (1 << PLACEMENT_INSIDE);
+			const bool placed = MapPlacementTryPlace(&mp, rules, TryPlace, &d);
+		THEN("placement should fail after trying both tiles")
+			SHOULD_BE_FALSE(placed);
+			SHOULD_INT_EQUAL(d.Calls, 2);
+			SHOULD_INT_EQUAL(d.Seen[2 * 6 + 2], 1);
+			SHOULD_INT_EQUAL(d.Seen[2 * 6 + 3], 1);
+		AND("rejected tiles should be tried again next time")
+			d.Accept = true;
+			SHOULD_BE_TRUE(MapPlacementTryPlace(&mp, rules, TryPlace, &d));
+		CFREE(d.Seen);
+		MapPlacementTerminate(&mp);
+		CArrayTerminate(&m.Tiles);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(PlacementOrder, "Random order")
+	SCENARIO("Visit every index once")
+		GIVEN("lists of many sizes")
+			int bad = 0;
+		WHEN("I visit each of them in random order")
+			for (int n = 0; n < 100; n++)
+			{
+				int seen[100] = {0};
+				PlacementOrder o;
+				PlacementOrderInit(&o, n, RNG_MAPGEN);
+				int i;
+				int count = 0;
+				while (PlacementOrderNext(&o, &i))
+				{
+					bad += i < 0 || i >= n || seen[i]++ > 0;
+					count++;
+				}
+				bad += count != n;
+			}
+		THEN("every index should be visited exactly once")
+			SHOULD_INT_EQUAL(bad, 0);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Map placement features are:", TEST_FEATURE(MapPlacementInit),
+	TEST_FEATURE(MapPlacementTryPlace), TEST_FEATURE(PlacementOrder))
@@ -0,0 +1,194 @@
+// Benchmark for linking cave areas; generates 256x256 and 512x512 caves from
+// fixed seeds, then finds and links their areas the way caves used to (flood
+// fill, shuffle every tile, link consecutive areas), and with map regions
+// (union-find, reservoir sampling, minimum spanning tree).
+// Prints the time per cave and the total corridor length for each.
+// Not run as part of the tests.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <c_array.h>
+#include <cave_grid.h>
+#include <map_regions.h>
+
+#define SEEDS 5
+#define FILL_PERCENT 45
+#define REPEAT 4
+#define R1 5
+#define R2 2
+
+static void MakeCave(CaveGrid *g, const int size, const unsigned seed)
+{
+	CaveGridInit(g, svec2i(size, size));
+	for (int i = 0; i < FILL_PERCENT * size * size / 100; i++)
+	{
+		CaveGridSetWall(g, svec2i(i % size, i / size), true);
+	}
+	RngSeed(RNG_MAPGEN, seed);
+	CaveGridShuffle(g, RNG_MAPGEN);
+	for (int i = 0; i < REPEAT; i++)
+	{
+		CaveGridStep(g, R1, R2);
+	}
+}
+
+static int Distance(const struct vec2i a, const struct vec2i b)
+{
+	return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+static void FloodFill(
+	CArray *fl, const struct vec2i size, const int idx, const int elem)
+{
+	CArray indices;
+	CArrayInit(&indices, sizeof(int));
+	CArrayPushBack(&indices, &idx);
+	const int floodTile = *(int *)CArrayGet(fl, idx);
+	*(int *)CArrayGet(fl, idx) = elem;
+	for (int j = 0; j < (int)indices.size; j++)
+	{
+		const int i = *(int *)CArrayGet(&indices, j);
+		const int x = i % size.x;
+		const int y = i / size.x;
+		const int neighbours[4] = {
+			y > 0 ? i - size.x : -1, y < size.y - 1 ? i + size.x : -1,
+			x > 0 ? i - 1 : -1, x < size.x - 1 ? i + 1 : -1};
+		for (int k = 0; k < 4; k++)
+		{
+			const int next = neighbours[k];
+			if (next >= 0 && *(int *)CArrayGet(fl, next) == floodTile)
+			{
+				CArrayPushBack(&indices, &next);
+				*(int *)CArrayGet(fl, next) = elem;
+			}
+		}
+	}
+	CArrayTerminate(&indices);
+}
+// Returns the total corridor length
+static int OldLink(const CaveGrid *g)
+{
+	const struct vec2i size = g->Size;
+	CArray fl;
+	CArrayInitFillZero(&fl, sizeof(int), size.x * size.y);
+	for (int i = 0; i < size.x * size.y; i++)
+	{
+		if (CaveGridIsWall(g, svec2i(i % size.x, i / size.x)))
+		{
+			*(int *)CArrayGet(&fl, i) = -1;
+		}
+	}
+	int idx = 1;
+	for (int i = 0; i < (int)fl.size; i++)
+	{
+		if (*(int *)CArrayGet(&fl, i) == 0)
+		{
+			FloodFill(&fl, size, i, idx);
+			idx++;
+		}
+	}
+	const int numAreas = idx - 1;
+	CArray areaTiles;
+	CArrayInit(&areaTiles, sizeof(int));
+	for (int i = 0; i < (int)fl.size; i++)
+	{
+		CArrayPushBack(&areaTiles, &i);
+	}
+	CArrayShuffle(&areaTiles, RNG_MAPGEN);
+	CArray areaStarts;
+	CArrayInitFillZero(&areaStarts, sizeof(int), numAreas);
+	for (int i = 0; i < (int)areaTiles.size; i++)
+	{
+		const int areaIdx = *(int *)CArrayGet(&areaTiles, i);
+		const int tile = *(int *)CArrayGet(&fl, areaIdx) - 1;
+		if (tile >= 0 && tile < numAreas)
+		{
+			int *areaStart = CArrayGet(&areaStarts, tile);
+			if (*areaStart == 0)
+			{
+				*areaStart = areaIdx;
+			}
+		}
+	}
+	int length = 0;
+	for (int i = 0; i < (int)areaStarts.size - 1; i++)
+	{
+		const int a1 = *(int *)CArrayGet(&areaStarts, i);
+		const int a2 = *(int *)CArrayGet(&areaStarts, i + 1);
+		length += Distance(
+			svec2i(a1 % size.x, a1 / size.x),
+			svec2i(a2 % size.x, a2 / size.x));
+	}
+	CArrayTerminate(&fl);
+	CArrayTerminate(&areaTiles);
+	CArrayTerminate(&areaStarts);
+	return length;
+}
+
+static bool IsFloor(void *data, struct vec2i v)
+{
+	return !CaveGridIsWall(data, v);
+}
+static int NewLink(CaveGrid *g)
+{
+	MapRegions r;
+	MapRegionsInit(&r, g->Size, IsFloor, g, RNG_MAPGEN);
+	CArray links;
+	MapRegionsLinks(&r, &links);
+	int length = 0;
+	for (int i = 0; i < (int)links.size; i++)
+	{
+		const MapRegionLink *l = CArrayGet(&links, i);
+		length += Distance(
+			MapRegionsGetRep(&r, l->A), MapRegionsGetRep(&r, l->B));
+	}
+	CArrayTerminate(&links);
+	MapRegionsTerminate(&r);
+	return length;
+}
+
+static void Bench(const int size)
+{
+	CaveGrid caves[SEEDS];
+	for (int i = 0; i < SEEDS; i++)
+	{
+		MakeCave(&caves[i], size, i + 1);
+	}
+
+	int oldLength = 0;
+	clock_t start = clock();
+	for (int i = 0; i < SEEDS; i++)
+	{
+		oldLength += OldLink(&caves[i]);
+	}
+	const double oldSecs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	int newLength = 0;
+	start = clock();
+	for (int i = 0; i < SEEDS; i++)
+	{
+		newLength += NewLink(&caves[i]);
+	}
+	const double newSecs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("%dx%d caves:\n", size, size);
+	printf(
+		"flood fill: %.1f ms per cave, corridors %d tiles\n",
+		oldSecs * 1000 / SEEDS, oldLength / SEEDS);
+	printf(
+		"regions: %.1f ms per cave, corridors %d tiles\n",
+		newSecs * 1000 / SEEDS, newLength / SEEDS);
+	for (int i = 0; i < SEEDS; i++)
+	{
+		CaveGridTerminate(&caves[i]);
+	}
+}
+
+int main(void)
+{
+	Bench(256);
+	Bench(512);
+	return 0;
+}
@@ -0,0 +1,224 @@
+#include <cbehave/cbehave.h>
+
+#include <map_regions.h>
+
+#include <string.h>
+
+
+// Maps are drawn with '.' for open tiles and '#' for walls
+typedef struct
+{
+	const char *Rows;
+	int Width;
+} TestMap;
+static bool IsOpen(void *data, struct vec2i v)
+{
+	const TestMap *m = data;
+	return m->Rows[v.y * m->Width + v.x] == '.';
+}
+static MapRegions Label(TestMap *m, const int width, const int height)
+{
+	m->Width = width;
+	MapRegions r;
+	MapRegionsInit(&r, svec2i(width, height), IsOpen, m, RNG_MAPGEN);
+	return r;
+}
+
+// Reference labeling: flood fill every unlabeled open tile
+static void FloodFill(
+	const TestMap *m, const struct vec2i size, int *labels, const int start,
+	const int label)
+{
+	int *stack;
+	CMALLOC(stack, size.x * size.y * sizeof *stack);
+	int n = 0;
+	stack[n++] = start;
+	labels[start] = label;
+	while (n > 0)
+	{
+		const int i = stack[--n];
+		const int x = i % size.x;
+		const int y = i / size.x;
+		const int neighbours[4] = {
+			x > 0 ? i - 1 : -1, x < size.x - 1 ? i + 1 : -1,
+			y > 0 ? i - size.x : -1, y < size.y - 1 ? i + size.x : -1};
+		for (int j = 0; j < 4; j++)
+		{
+			const int k = neighbours[j];
+			if (k >= 0 && labels[k] < 0 && m->Rows[k] == '.')
+			{
+				labels[k] = label;
+				stack[n++] = k;
+			}
+		}
+	}
+	CFREE(stack);
+}
+// Count tiles whose labels disagree with the reference
+static int CompareWithFloodFill(const TestMap *m, const MapRegions *r)
+{
+	const int n = r->Size.x * r->Size.y;
+	int *labels;
+	CMALLOC(labels, n * sizeof *labels);
+	for (int i = 0; i < n; i++)
+	{
+		labels[i] = -1;
+	}
+	int count = 0;
+	for (int i = 0; i < n; i++)
+	{
+		if (labels[i] < 0 && m->Rows[i] == '.')
+		{
+			FloodFill(m, r->Size, labels, i, count++);
+		}
+	}
+	int mismatches = count == r->Count ? 0 : 1;
+	for (int i = 0; i < n; i++)
+	{
+		mismatches += labels[i] != r->Labels[i];
+	}
+	CFREE(labels);
+	return mismatches;
+}
+
+// Count regions not reachable from region 0 through the links
+static int CountUnlinked(const MapRegions *r, const CArray *links)
+{
+	bool *linked;
+	CCALLOC(linked, r->Count * sizeof *linked);
+	linked[0] = true;
+	// Prim's links only ever join a new region to the tree so far
+	CA_FOREACH(const MapRegionLink, l, *links)
+	if (linked[l->A])
+	{
+		linked[l->B] = true;
+	}
+	CA_FOREACH_END()
+	int unlinked = 0;
+	for (int i = 0; i < r->Count; i++)
+	{
+		unlinked += !linked[i];
+	}
+	CFREE(linked);
+	return unlinked;
+}
+
+
+FEATURE(MapRegionsLabel, "Label regions")
+	SCENARIO("Regions joined late")
+		GIVEN("a map with a U-shaped region and a separate region")
+			TestMap m;
+			m.Rows = ".#.#."
+					 ".#.#."
+					 "...#."
+					 "####."
+					 "..#..";
+		WHEN("I label the regions")
+			MapRegions r = Label(&m, 5, 5);
+		THEN("there should be three regions")
+			SHOULD_INT_EQUAL(r.Count, 3);
+		AND("both arms of the U should be the same region")
+			SHOULD_INT_EQUAL(MapRegionsGet(&r, svec2i(0, 0)), 0);
+			SHOULD_INT_EQUAL(MapRegionsGet(&r, svec2i(2, 0)), 0);
+		AND("regions should be numbered in row order")
+			SHOULD_INT_EQUAL(MapRegionsGet(&r, svec2i(4, 0)), 1);
+			SHOULD_INT_EQUAL(MapRegionsGet(&r, svec2i(3, 4)), 1);
+			SHOULD_INT_EQUAL(MapRegionsGet(&r, svec2i(0, 4)), 2);
+		AND("walls should have no region")
+			SHOULD_INT_EQUAL(MapRegionsGet(&r, svec2i(1, 0)), -1);
+		AND("the region sizes should be counted")
+			SHOULD_INT_EQUAL(*(int *)CArrayGet(&r.Sizes, 0), 7);
+			SHOULD_INT_EQUAL(*(int *)CArrayGet(&r.Sizes, 1), 6);
+			SHOULD_INT_EQUAL(*(int *)CArrayGet(&r.Sizes, 2), 2);
+		AND("each representative should be in its region")
+			for (int i = 0; i < r.Count; i++)
+			{
+				SHOULD_INT_EQUAL(
+					MapRegionsGet(&r, MapRegionsGetRep(&r, i)), i);
+			}
+		MapRegionsTerminate(&r);
+	SCENARIO_END
+
+	SCENARIO("Random maps")
+		GIVEN("random maps")
+			const struct vec2i size = svec2i(64, 48);
+			char *rows;
+			CMALLOC(rows, size.x * size.y);
+			TestMap m;
+			m.Rows = rows;
+			m.Width = size.x;
+			srand(1);
+		WHEN("I label the regions")
+			int mismatches = 0;
+			for (int j = 0; j < 20; j++)
+			{
+				for (int i = 0; i < size.x * size.y; i++)
+				{
+					rows[i] = rand() % 100 < 45 ? '#' : '.';
+				}
+				MapRegions r = Label(&m, size.x, size.y);
+				mismatches += CompareWithFloodFill(&m, &r);
+				MapRegionsTerminate(&r);
+			}
+		THEN("they should be the same as flood filling")
+			SHOULD_INT_EQUAL(mismatches, 0);
+		CFREE(rows);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(MapRegionsLinks, "Link regions")
+	SCENARIO("Shortest links")
+		GIVEN("single tile regions, with the middle one on the next row")
+			TestMap m;
+			m.Rows = ".#########."
+					 "#####.#####";
+			MapRegions r = Label(&m, 11, 2);
+		WHEN("I link the regions")
+			CArray links;
+			MapRegionsLinks(&r, &links);
+		THEN("there should be one less link than regions")
+			SHOULD_INT_EQUAL(r.Count, 3);
+			SHOULD_INT_EQUAL((int)links.size, 2);
+		AND("both links should go through the middle region")
+			int total = 0;
+			CA_FOREACH(const MapRegionLink, l, links)
+			const struct vec2i a = MapRegionsGetRep(&r, l->A);
+			const struct vec2i b = MapRegionsGetRep(&r, l->B);
+			total += abs(a.x - b.x) + abs(a.y - b.y);
+			SHOULD_BE_TRUE(l->A == 2 || l->B == 2);
+			CA_FOREACH_END()
+			SHOULD_INT_EQUAL(total, 12);
+		CArrayTerminate(&links);
+		MapRegionsTerminate(&r);
+	SCENARIO_END
+
+	SCENARIO("Link random maps")
+		GIVEN("a random map")
+			const struct vec2i size = svec2i(64, 64);
+			char *rows;
+			CMALLOC(rows, size.x * size.y);
+			srand(2);
+			for (int i = 0; i < size.x * size.y; i++)
+			{
+				rows[i] = rand() % 100 < 50 ? '#' : '.';
+			}
+			TestMap m;
+			m.Rows = rows;
+			MapRegions r = Label(&m, size.x, size.y);
+			SHOULD_BE_TRUE(r.Count > 10);
+		WHEN("I link the regions")
+			CArray links;
+			MapRegionsLinks(&r, &links);
+		THEN("every region should be linked")
+			SHOULD_INT_EQUAL((int)links.size, r.Count - 1);
+			SHOULD_INT_EQUAL(CountUnlinked(&r, &links), 0);
+		CArrayTerminate(&links);
+		MapRegionsTerminate(&r);
+		CFREE(rows);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Map regions features are:",
+	TEST_FEATURE(MapRegionsLabel),
+	TEST_FEATURE(MapRegionsLinks))
@@ -0,0 +1,168 @@
+#include <cbehave/cbehave.h>
+
+#include <parallel.h>
+
+#include <string.h>
+
+#include <SDL_atomic.h>
+
+#include <map_build.h>
+#include <map_placement.h>
+#include <pics.h>
+
+
+typedef struct
+{
+	SDL_atomic_t *Seen; // times each index was visited
+	SDL_atomic_t Bands;
+} VisitData;
+static void Visit(void *data, const int start, const int end)
+{
+	VisitData *d = data;
+	SDL_AtomicAdd(&d->Bands, 1);
+	for (int i = start; i < end; i++)
+	{
+		SDL_AtomicAdd(&d->Seen[i], 1);
+	}
+}
+
+// Tile classes without pics, so maps can be set up without graphics
+static TileClass sWall = {.isOpaque = true, .Type = TILE_CLASS_WALL};
+static TileClass sFloor = {.canWalk = true, .Type = TILE_CLASS_FLOOR};
+static TileClass sRoom = {
+	.canWalk = true, .IsRoom = true, .Type = TILE_CLASS_FLOOR};
+static char sStyle[] = "test";
+static void AddTileClasses(Map *m, const TileClass *base)
+{
+	for (int i = 0; i < WALL_TYPE_COUNT; i++)
+	{
+		TileClassesAdd(
+			m->TileClasses, NULL, base, sStyle, IntWallType(i), base->Mask,
+			base->MaskAlt);
+	}
+	TileClassesAdd(
+		m->TileClasses, NULL, base, sStyle, "normal", base->Mask,
+		base->MaskAlt);
+	TileClassesAdd(
+		m->TileClasses, NULL, base, sStyle, "shadow", base->Mask,
+		base->MaskAlt);
+}
+#define MAP_SEED 1234
+#define MAP_WIDTH 40
+#define MAP_HEIGHT 128
+// Set up a random map from a fixed seed, split into numBands bands
+static void BuildMap(Map *m, MapPlacement *mp, const int numBands)
+{
+	sWall.Style = sFloor.Style = sRoom.Style = sStyle;
+	Mission mission;
+	memset(&mission, 0, sizeof mission);
+	mission.Size = svec2i(MAP_WIDTH, MAP_HEIGHT);
+	memset(m, 0, sizeof *m);
+	MapInit(m, mission.Size);
+	AddTileClasses(m, &sWall);
+	AddTileClasses(m, &sFloor);
+	AddTileClasses(m, &sRoom);
+	MapBuilder mb;
+	MapBuilderInit(&mb, m, &mission, GAME_MODE_NORMAL, NULL);
+	RngSeed(RNG_MAPGEN, MAP_SEED);
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), m->Size))
+	const int r = RAND_INT(RNG_MAPGEN, 0, 3);
+	MapBuilderSetTile(&mb, _v, r == 0 ? &sWall : r == 1 ? &sRoom : &sFloor);
+	RECT_FOREACH_END()
+
+	ParallelSetBands(numBands);
+	MapBuilderSetupTiles(&mb);
+	MapPlacementInit(mp, m, RNG_MAPGEN);
+	ParallelSetBands(0);
+	MapBuilderTerminate(&mb);
+}
+// Count tiles that were set up differently, or not at all
+static int CountDifferentTiles(const Map *a, const Map *b)
+{
+	int bad = 0;
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), a->Size))
+	const TileClass *ta = MapGetTile(a, _v)->Class;
+	const TileClass *tb = MapGetTile(b, _v)->Class;
+	bad += ta->StyleType == NULL || tb->StyleType == NULL ||
+		   ta->Type != tb->Type || ta->IsRoom != tb->IsRoom ||
+		   strcmp(ta->StyleType, tb->StyleType) != 0;
+	RECT_FOREACH_END()
+	return bad;
+}
+static int CountDifferentRules(const MapPlacement *a, const MapPlacement *b)
+{
+	int bad = 0;
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), a->Size))
+	bad += MapPlacementGetWallsAdjacent(a, _v) !=
+			   MapPlacementGetWallsAdjacent(b, _v) ||
+		   MapPlacementGetWallsAround(a, _v) !=
+			   MapPlacementGetWallsAround(b, _v) ||
+		   MapPlacementGetRules(a, _v) != MapPlacementGetRules(b, _v);
+	RECT_FOREACH_END()
+	return bad;
+}
+
+
+FEATURE(ParallelForBands, "Run in bands")
+	SCENARIO("Visit every index once")
+		GIVEN("ranges of many sizes and band lengths")
+			int bad = 0;
+			int maxBands = 0;
+		WHEN("I visit each of them in bands")
+			for (int n = 0; n < 200; n += 7)
+			{
+				for (int minBand = 0; minBand < 40; minBand += 13)
+				{
+					SDL_atomic_t seen[200];
+					memset(seen, 0, sizeof seen);
+					VisitData d;
+					d.Seen = seen;
+					SDL_AtomicSet(&d.Bands, 0);
+					ParallelForBands(n, minBand, Visit, &d);
+					for (int i = 0; i < n; i++)
+					{
+						bad += SDL_AtomicGet(&seen[i]) != 1;
+					}
+					const int bands = SDL_AtomicGet(&d.Bands);
+					// Bands are never shorter than the minimum
+					bad += minBand > 0 && n >= minBand &&
+						   bands > n / minBand;
+					if (bands > maxBands)
+					{
+						maxBands = bands;
+					}
+				}
+			}
+		THEN("every index should be visited exactly once")
+			SHOULD_INT_EQUAL(bad, 0);
+		AND("there should be at least one band")
+			SHOULD_BE_TRUE(maxBands >= 1);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(ParallelMapSetup, "Set up maps in bands")
+	SCENARIO("Same map however many bands")
+		GIVEN("a map set up in one band")
+			Map m1;
+			MapPlacement mp1;
+			BuildMap(&m1, &mp1, 1);
+		WHEN("I set up the same seeded map in several bands")
+			Map m4;
+			MapPlacement mp4;
+			BuildMap(&m4, &mp4, 4);
+		THEN("the tiles should be the same")
+			SHOULD_INT_EQUAL(CountDifferentTiles(&m1, &m4), 0);
+		AND("the placement rules should be the same")
+			SHOULD_INT_EQUAL(CountDifferentRules(&mp1, &mp4), 0);
+			MapPlacementTerminate(&mp1);
+			MapPlacementTerminate(&mp4);
+			MapTerminate(&m1);
+			MapTerminate(&m4);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Parallel features are:",
+	TEST_FEATURE(ParallelForBands),
+	TEST_FEATURE(ParallelMapSetup)
+)
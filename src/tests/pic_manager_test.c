@@ -0,0 +1,88 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <pic_manager.h>
+
+#include <config.h>
+#include <grafx.h>
+
+
+static void InitSDL(void)
+{
+	// Headless; the dummy driver still gives us a renderer
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		printf("Failed to init SDL: %s\n", SDL_GetError());
+	}
+	gConfig = ConfigDefault();
+	ConfigResetDefault(ConfigGet(&gConfig, "Graphics"));
+	GraphicsInit(&gGraphicsDevice, &gConfig);
+	GraphicsInitialize(&gGraphicsDevice);
+}
+// Add a sprite sheet of one 2x2 pic, with a pixel for each char channel
+static void AddSprites(PicManager *pm, const char *name)
+{
+	NamedSprites *ns;
+	CMALLOC(ns, sizeof *ns);
+	NamedSpritesInit(ns, name);
+	Pic p;
+	memset(&p, 0, sizeof p);
+	p.size = svec2i(2, 2);
+	CMALLOC(p.Data, 4 * sizeof *p.Data);
+	const uint8_t alphas[] = {255, 254, 253, 0};
+	for (int i = 0; i < 4; i++)
+	{
+		p.Data[i] = COLOR2PIXEL(((color_t){200, 200, 200, alphas[i]}));
+	}
+	CArrayPushBack(&ns->pics, &p);
+	hashmap_put(pm->sprites, name, ns);
+}
+static bool SpritesEqual(const NamedSprites *a, const NamedSprites *b)
+{
+	if (a->pics.size != b->pics.size)
+	{
+		return false;
+	}
+	CA_FOREACH(const Pic, pa, a->pics)
+	const Pic *pb = CArrayGet(&b->pics, _ca_index);
+	const size_t n = (size_t)(pa->size.x * pa->size.y);
+	if (!svec2i_is_equal(pa->size, pb->size) ||
+		memcmp(pa->Data, pb->Data, n * sizeof *pa->Data) != 0)
+	{
+		return false;
+	}
+	CA_FOREACH_END()
+	return true;
+}
+
+
+FEATURE(PicManagerGetCharSprites, "Masked char sprites")
+	InitSDL();
+	SCENARIO("All grey colours")
+		GIVEN("a char sprite sheet")
+			ASSERT(gGraphicsDevice.IsInitialized, 1);
+			PicManagerInit(&gPicManager);
+			AddSprites(&gPicManager, "chars/test");
+			const CharColors grey = CharColorsFromOneColor(colorGray);
+		WHEN("I get the sprites masked with all grey colours")
+			const NamedSprites *fallback =
+				PicManagerGetCharSprites(&gPicManager, "chars/test", &grey);
+		AND("the masking finishes")
+			PicManagerWaitCharSprites(&gPicManager);
+			const NamedSprites *masked =
+				PicManagerGetCharSprites(&gPicManager, "chars/test", &grey);
+		THEN("the masked sprites should be separate from the fallback")
+			SHOULD_BE_TRUE(fallback != NULL);
+			SHOULD_BE_TRUE(masked != NULL);
+			SHOULD_BE_TRUE(masked != fallback);
+			SHOULD_BE_FALSE(strcmp(masked->name, fallback->name) == 0);
+			SHOULD_INT_EQUAL(hashmap_length(gPicManager.customSprites), 2);
+		AND("they should have the same pixels")
+			SHOULD_BE_TRUE(SpritesEqual(masked, fallback));
+		PicManagerTerminate(&gPicManager);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Pic manager features are:", TEST_FEATURE(PicManagerGetCharSprites))
@@ -0,0 +1,88 @@
+// Benchmark for the pixel ops kernels; prints megapixels/second per
+// supported implementation. Not run as part of the tests.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <pixel_ops.h>
+
+#define NUM_PIXELS (1024 * 1024)
+#define ITERATIONS 50
+
+static const PixelLayout argb = {16, 8, 0, 24};
+static const PixelLayout abgr = {0, 8, 16, 24};
+
+static uint32_t src[NUM_PIXELS];
+static uint32_t dst[NUM_PIXELS];
+
+typedef enum
+{
+	OP_CONVERT,
+	OP_MASK_CHAR_COLORS,
+	OP_MASK_STYLE,
+	OP_FILL,
+	OP_COUNT
+} Op;
+static const char *opNames[OP_COUNT] = {
+	"convert", "mask char colors", "mask style", "fill"};
+
+static void RunOp(const Op op, const CharColors *colors)
+{
+	switch (op)
+	{
+	case OP_CONVERT:
+		PixelsConvert(dst, src, NUM_PIXELS, abgr, argb);
+		break;
+	case OP_MASK_CHAR_COLORS:
+		PixelsMaskCharColors(dst, src, NUM_PIXELS, argb, colors);
+		break;
+	case OP_MASK_STYLE:
+		PixelsMaskStyle(
+			dst, src, NUM_PIXELS, argb, colors->Body, colors->Hair, false);
+		break;
+	case OP_FILL:
+		PixelsFill(dst, NUM_PIXELS, 0xff123456);
+		break;
+	default:
+		break;
+	}
+}
+
+int main(void)
+{
+	srand(42);
+	for (int i = 0; i < NUM_PIXELS; i++)
+	{
+		src[i] = (uint32_t)rand() ^ ((uint32_t)rand() << 16);
+	}
+	CharColors colors;
+	colors.Skin = StrColor("f0c0a0ff");
+	colors.Arms = StrColor("8040c0ff");
+	colors.Body = StrColor("2080ffff");
+	colors.Legs = StrColor("ff0000ff");
+	colors.Hair = StrColor("ffff00ff");
+	colors.Feet = StrColor("000000ff");
+
+	for (PixelOpsImpl impl = 0; impl < PIXEL_OPS_COUNT; impl++)
+	{
+		if (!PixelOpsSetImpl(impl))
+		{
+			printf("%s: not supported\n", PixelOpsImplStr(impl));
+			continue;
+		}
+		for (Op op = 0; op < OP_COUNT; op++)
+		{
+			const clock_t start = clock();
+			for (int i = 0; i < ITERATIONS; i++)
+			{
+				RunOp(op, &colors);
+			}
+			const double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+			const double mpix = (double)NUM_PIXELS * ITERATIONS / 1e6;
+			printf(
+				"%s %s: %.1f Mpx/s\n", PixelOpsImplStr(impl), opNames[op],
+				secs > 0 ? mpix / secs : 0.0);
+		}
+	}
+	return 0;
+}
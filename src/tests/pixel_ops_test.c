@@ -0,0 +1,209 @@
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <pixel_ops.h>
+
+#define NUM_PIXELS 1027
+
+static const PixelLayout argb = {16, 8, 0, 24};
+static const PixelLayout abgr = {0, 8, 16, 24};
+
+static color_t LayoutToColor(const uint32_t p, const PixelLayout l)
+{
+	color_t c;
+	c.r = (uint8_t)(p >> l.RShift);
+	c.g = (uint8_t)(p >> l.GShift);
+	c.b = (uint8_t)(p >> l.BShift);
+	c.a = (uint8_t)(p >> l.AShift);
+	return c;
+}
+static uint32_t ColorToLayout(const color_t c, const PixelLayout l)
+{
+	return ((uint32_t)c.r << l.RShift) | ((uint32_t)c.g << l.GShift) |
+		((uint32_t)c.b << l.BShift) | ((uint32_t)c.a << l.AShift);
+}
+// Random pixels, with a good share of the special cases:
+// transparent, greyscale, red, and char channel alphas
+static void MakePixels(uint32_t *pixels)
+{
+	srand(42);
+	for (int i = 0; i < NUM_PIXELS; i++)
+	{
+		color_t c;
+		c.r = (uint8_t)(rand() & 0xff);
+		c.g = (uint8_t)(rand() & 0xff);
+		c.b = (uint8_t)(rand() & 0xff);
+		c.a = (uint8_t)(rand() & 0xff);
+		switch (rand() % 5)
+		{
+		case 0:
+			c.a = 0;
+			break;
+		case 1:
+			c.g = c.b = c.r;
+			break;
+		case 2:
+			c.g = (uint8_t)(rand() % 3);
+			c.b = (uint8_t)(rand() % 3);
+			break;
+		case 3:
+			c.a = (uint8_t)(249 + rand() % 7);
+			break;
+		default:
+			break;
+		}
+		pixels[i] = ColorToLayout(c, argb);
+	}
+}
+static CharColors MakeCharColors(void)
+{
+	CharColors c;
+	c.Skin = StrColor("f0c0a0ff");
+	c.Arms = StrColor("8040c0ff");
+	c.Body = StrColor("2080ff80");
+	c.Legs = StrColor("ff0000ff");
+	c.Hair = StrColor("ffff0040");
+	c.Feet = StrColor("000000ff");
+	return c;
+}
+
+// Reference implementations built from the per-color functions
+static void ConvertRef(uint32_t *dst, const uint32_t *src)
+{
+	for (int i = 0; i < NUM_PIXELS; i++)
+	{
+		const color_t c = LayoutToColor(src[i], abgr);
+		dst[i] = c.a == 0 ? 0 : ColorToLayout(c, argb);
+	}
+}
+static void MaskCharColorsRef(
+	uint32_t *dst, const uint32_t *src, const CharColors *colors)
+{
+	for (int i = 0; i < NUM_PIXELS; i++)
+	{
+		const color_t c = LayoutToColor(src[i], argb);
+		dst[i] = ColorToLayout(
+			ColorMult(c, CharColorsGetChannelMask(colors, c.a)), argb);
+	}
+}
+static void MaskStyleRef(
+	uint32_t *dst, const uint32_t *src, const color_t mask,
+	const color_t maskAlt, const bool noAltMask)
+{
+	for (int i = 0; i < NUM_PIXELS; i++)
+	{
+		color_t c = LayoutToColor(src[i], argb);
+		if (c.g <= 2 && c.b <= 2 && !noAltMask)
+		{
+			c.g = c.r;
+			c.b = c.r;
+			c = ColorMult(c, maskAlt);
+		}
+		else if (c.r == c.g && c.g == c.b)
+		{
+			c = ColorMult(c, mask);
+		}
+		dst[i] = ColorToLayout(c, argb);
+	}
+}
+
+
+FEATURE(PixelsConvert, "Convert pixels")
+	SCENARIO("Convert pixels between layouts")
+		for (PixelOpsImpl impl = 0; impl < PIXEL_OPS_COUNT; impl++)
+		{
+			if (!PixelOpsSetImpl(impl)) continue;
+			GIVEN("some pixels")
+				uint32_t src[NUM_PIXELS];
+				MakePixels(src);
+				uint32_t expected[NUM_PIXELS];
+				ConvertRef(expected, src);
+
+			WHEN("I convert them")
+				uint32_t out[NUM_PIXELS];
+				PixelsConvert(out, src, NUM_PIXELS, abgr, argb);
+
+			THEN("the result should match the per-color conversion")
+				SHOULD_MEM_EQUAL(out, expected, sizeof out);
+		}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(PixelsMaskCharColors, "Mask char colors")
+	SCENARIO("Mask pixels by alpha channel")
+		for (PixelOpsImpl impl = 0; impl < PIXEL_OPS_COUNT; impl++)
+		{
+			if (!PixelOpsSetImpl(impl)) continue;
+			GIVEN("some pixels and char colors")
+				uint32_t src[NUM_PIXELS];
+				MakePixels(src);
+				const CharColors colors = MakeCharColors();
+				uint32_t expected[NUM_PIXELS];
+				MaskCharColorsRef(expected, src, &colors);
+
+			WHEN("I mask them")
+				uint32_t out[NUM_PIXELS];
+				PixelsMaskCharColors(out, src, NUM_PIXELS, argb, &colors);
+
+			THEN("the result should match the per-color masking")
+				SHOULD_MEM_EQUAL(out, expected, sizeof out);
+		}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(PixelsMaskStyle, "Mask style")
+	SCENARIO("Mask greyscale and red pixels")
+		for (PixelOpsImpl impl = 0; impl < PIXEL_OPS_COUNT; impl++)
+		{
+			if (!PixelOpsSetImpl(impl)) continue;
+			for (int noAltMask = 0; noAltMask < 2; noAltMask++)
+			{
+				GIVEN("some pixels and masks")
+					uint32_t src[NUM_PIXELS];
+					MakePixels(src);
+					const color_t mask = StrColor("80ff40c0");
+					const color_t maskAlt = StrColor("ff8000ff");
+					uint32_t expected[NUM_PIXELS];
+					MaskStyleRef(expected, src, mask, maskAlt, noAltMask);
+
+				WHEN("I mask them")
+					uint32_t out[NUM_PIXELS];
+					PixelsMaskStyle(
+						out, src, NUM_PIXELS, argb, mask, maskAlt, noAltMask);
+
+				THEN("the result should match the per-color masking")
+					SHOULD_MEM_EQUAL(out, expected, sizeof out);
+			}
+		}
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(PixelsFill, "Fill pixels")
+	SCENARIO("Fill with a pixel")
+		for (PixelOpsImpl impl = 0; impl < PIXEL_OPS_COUNT; impl++)
+		{
+			if (!PixelOpsSetImpl(impl)) continue;
+			GIVEN("a buffer")
+				uint32_t out[NUM_PIXELS + 1];
+				memset(out, 0, sizeof out);
+
+			WHEN("I fill all but the last pixel")
+				PixelsFill(out, NUM_PIXELS, 0x12345678);
+
+			THEN("those pixels should be filled and the last untouched")
+				SHOULD_INT_EQUAL(out[0], 0x12345678);
+				SHOULD_INT_EQUAL(out[NUM_PIXELS - 1], 0x12345678);
+				SHOULD_INT_EQUAL(out[NUM_PIXELS], 0);
+		}
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Pixel ops features are:",
+	TEST_FEATURE(PixelsConvert),
+	TEST_FEATURE(PixelsMaskCharColors),
+	TEST_FEATURE(PixelsMaskStyle),
+	TEST_FEATURE(PixelsFill)
+)
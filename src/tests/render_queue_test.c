@@ -0,0 +1,112 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <render_queue.h>
+
+#include <grafx.h>
+#include <texture.h>
+
+#define SIZE 8
+#define RED 0xFFFF0000
+#define GREEN 0xFF00FF00
+#define BLUE 0xFF0000FF
+
+
+// Draw into a surface with the software renderer; no video device needed
+static SDL_Surface *sSurface;
+static SDL_Renderer *NewRenderer(void)
+{
+	sSurface = SDL_CreateRGBSurfaceWithFormat(
+		0, SIZE, SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_FillRect(sSurface, NULL, 0);
+	return SDL_CreateSoftwareRenderer(sSurface);
+}
+static void FreeRenderer(SDL_Renderer *r)
+{
+	SDL_DestroyRenderer(r);
+	SDL_FreeSurface(sSurface);
+}
+static Uint32 GetPixel(SDL_Renderer *r, const int x, const int y)
+{
+	const SDL_Rect rect = {x, y, 1, 1};
+	Uint32 p = 0;
+	SDL_RenderReadPixels(r, &rect, SDL_PIXELFORMAT_ARGB8888, &p, sizeof p);
+	return p;
+}
+static SDL_Texture *NewWhiteTexture(SDL_Renderer *r)
+{
+	SDL_Surface *s = SDL_CreateRGBSurfaceWithFormat(
+		0, 2, 2, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_FillRect(s, NULL, 0xFFFFFFFF);
+	SDL_Texture *t = SDL_CreateTextureFromSurface(r, s);
+	SDL_FreeSurface(s);
+	return t;
+}
+static void FillRect(SDL_Renderer *r, const color_t c)
+{
+	RenderQueuePushShape(
+		&gRenderQueue, RENDER_CMD_FILL_RECT, r, svec2i_zero(),
+		svec2i(SIZE, SIZE), c);
+}
+
+
+FEATURE(RenderQueueSubmit, "Record and replay draw commands")
+	SCENARIO("Replay in order with the recorded state")
+		GIVEN("a frame recorded with fills, clip rects and a texture")
+			RenderQueueInit(&gRenderQueue);
+			SDL_Renderer *r = NewRenderer();
+			SDL_Texture *t = NewWhiteTexture(r);
+			RenderQueueBegin(&gRenderQueue);
+			FillRect(r, colorRed);
+			const Rect2i right =
+				Rect2iNew(svec2i(SIZE / 2, 0), svec2i(SIZE / 2, SIZE));
+			GraphicsSetClip(r, right);
+			const Rect2i clip = GraphicsGetClip(r);
+			FillRect(r, colorBlue);
+			GraphicsSetClip(r, Rect2iZero());
+			const Rect2i corner = Rect2iNew(svec2i(0, SIZE - 2), svec2i(2, 2));
+			TextureRender(
+				t, r, Rect2iZero(), corner, colorGreen, 0, SDL_FLIP_NONE);
+			RenderQueueEnd(&gRenderQueue);
+		THEN("the clip rect should be read back while recording")
+			SHOULD_BE_TRUE(
+				svec2i_is_equal(clip.Pos, right.Pos) &&
+				svec2i_is_equal(clip.Size, right.Size));
+		AND("nothing should be drawn until the frame is submitted")
+			SHOULD_INT_EQUAL((int)gRenderQueue.Cmds.size, 5);
+			SHOULD_INT_EQUAL((int)GetPixel(r, 0, 0), 0);
+		WHEN("I submit the frame")
+			RenderQueueSubmit(&gRenderQueue);
+		THEN("later commands should be drawn over earlier ones")
+			SHOULD_INT_EQUAL((int)GetPixel(r, SIZE - 1, 0), (int)BLUE);
+			SHOULD_INT_EQUAL((int)GetPixel(r, 0, SIZE - 1), (int)GREEN);
+		AND("the clip rect should only apply to the commands after it")
+			SHOULD_INT_EQUAL((int)GetPixel(r, 0, 0), (int)RED);
+			SHOULD_INT_EQUAL(
+				(int)GetPixel(r, SIZE / 2 - 1, SIZE / 2), (int)RED);
+		AND("the queue should be empty")
+			SHOULD_INT_EQUAL((int)gRenderQueue.Cmds.size, 0);
+		SDL_DestroyTexture(t);
+		FreeRenderer(r);
+		RenderQueueTerminate(&gRenderQueue);
+	SCENARIO_END
+
+	SCENARIO("Discard an unsubmitted frame")
+		GIVEN("a recorded frame")
+			RenderQueueInit(&gRenderQueue);
+			SDL_Renderer *r = NewRenderer();
+			RenderQueueBegin(&gRenderQueue);
+			FillRect(r, colorRed);
+			RenderQueueEnd(&gRenderQueue);
+		WHEN("I record an empty frame over it and submit")
+			RenderQueueBegin(&gRenderQueue);
+			RenderQueueEnd(&gRenderQueue);
+			RenderQueueSubmit(&gRenderQueue);
+		THEN("nothing should be drawn")
+			SHOULD_INT_EQUAL((int)GetPixel(r, 0, 0), 0);
+		FreeRenderer(r);
+		RenderQueueTerminate(&gRenderQueue);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Render queue features are:", TEST_FEATURE(RenderQueueSubmit))
@@ -0,0 +1,157 @@
+#include <cbehave/cbehave.h>
+
+#include <string.h>
+
+#include <residency.h>
+
+typedef struct
+{
+	size_t Size;
+	bool Loaded;
+	bool Playing;
+	int Id;
+} FakeAsset;
+static size_t FakeLoad(void *asset)
+{
+	FakeAsset *a = asset;
+	a->Loaded = true;
+	return a->Size;
+}
+static void FakeUnload(void *asset)
+{
+	FakeAsset *a = asset;
+	a->Loaded = false;
+}
+static bool FakeInUse(const void *asset)
+{
+	const FakeAsset *a = asset;
+	return a->Playing;
+}
+static void FakeSetId(void *asset, const int id)
+{
+	FakeAsset *a = asset;
+	a->Id = id;
+}
+static Residency FakeResidency(const size_t budget)
+{
+	Residency r;
+	memset(&r, 0, sizeof r);
+	r.Name = "fake";
+	r.Load = FakeLoad;
+	r.Unload = FakeUnload;
+	r.InUse = FakeInUse;
+	r.SetId = FakeSetId;
+	r.Budget = budget;
+	return r;
+}
+
+
+FEATURE(ResidencyUse, "Load on first use")
+	SCENARIO("Use an asset")
+		GIVEN("a registered asset")
+			Residency r = FakeResidency(0);
+			FakeAsset a = {10, false, false, 0};
+			a.Id = ResidencyAdd(&r, &a);
+		WHEN("I use it twice")
+			ResidencyUse(&r, a.Id);
+			ResidencyUse(&r, a.Id);
+		THEN("it should be loaded once, as a first-use stall")
+			SHOULD_BE_TRUE(a.Loaded);
+			SHOULD_INT_EQUAL((int)r.Bytes, 10);
+			SHOULD_INT_EQUAL(r.Stats.Loads, 1);
+			SHOULD_INT_EQUAL(r.Stats.Stalls, 1);
+		ResidencyTerminate(&r);
+	SCENARIO_END
+
+	SCENARIO("Prefetch an asset")
+		GIVEN("a registered asset")
+			Residency r = FakeResidency(0);
+			FakeAsset a = {10, false, false, 0};
+			a.Id = ResidencyAdd(&r, &a);
+		WHEN("I prefetch it and then use it")
+			ResidencyPrefetch(&r, a.Id);
+			ResidencyUse(&r, a.Id);
+		THEN("it should be loaded without a stall")
+			SHOULD_BE_TRUE(a.Loaded);
+			SHOULD_INT_EQUAL(r.Stats.Loads, 1);
+			SHOULD_INT_EQUAL(r.Stats.Stalls, 0);
+		ResidencyTerminate(&r);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(ResidencyEvict, "Evict least recently used")
+	SCENARIO("Go over budget")
+		GIVEN("three assets used in order, over budget")
+			Residency r = FakeResidency(24);
+			FakeAsset assets[3] = {
+				{10, false, false, 0},
+				{10, false, false, 0},
+				{10, false, false, 0}};
+			for (int i = 0; i < 3; i++)
+			{
+				assets[i].Id = ResidencyAdd(&r, &assets[i]);
+			}
+			ResidencyUse(&r, assets[1].Id);
+			ResidencyEvict(&r);
+			ResidencyUse(&r, assets[0].Id);
+			ResidencyEvict(&r);
+			ResidencyUse(&r, assets[2].Id);
+		WHEN("I evict")
+			ResidencyEvict(&r);
+		THEN("the least recently used asset should be unloaded")
+			SHOULD_BE_FALSE(assets[1].Loaded);
+			SHOULD_BE_TRUE(assets[0].Loaded);
+			SHOULD_BE_TRUE(assets[2].Loaded);
+			SHOULD_INT_EQUAL((int)r.Bytes, 20);
+			SHOULD_INT_EQUAL(r.Stats.Evictions, 1);
+		ResidencyTerminate(&r);
+	SCENARIO_END
+
+	SCENARIO("Skip assets in use")
+		GIVEN("two assets over budget, the older one in use")
+			Residency r = FakeResidency(10);
+			FakeAsset assets[2] = {{10, false, true, 0}, {10, false, false, 0}};
+			for (int i = 0; i < 2; i++)
+			{
+				assets[i].Id = ResidencyAdd(&r, &assets[i]);
+			}
+			ResidencyUse(&r, assets[0].Id);
+			ResidencyEvict(&r);
+			ResidencyUse(&r, assets[1].Id);
+		WHEN("I evict")
+			ResidencyEvict(&r);
+		THEN("the asset in use should stay loaded")
+			SHOULD_BE_TRUE(assets[0].Loaded);
+			SHOULD_BE_FALSE(assets[1].Loaded);
+		ResidencyTerminate(&r);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(ResidencyRemove, "Remove assets")
+	SCENARIO("Remove from the middle")
+		GIVEN("three loaded assets")
+			Residency r = FakeResidency(0);
+			FakeAsset assets[3] = {
+				{10, false, false, 0},
+				{20, false, false, 0},
+				{30, false, false, 0}};
+			for (int i = 0; i < 3; i++)
+			{
+				assets[i].Id = ResidencyAdd(&r, &assets[i]);
+				ResidencyUse(&r, assets[i].Id);
+			}
+		WHEN("I remove the first")
+			ResidencyRemove(&r, assets[0].Id, &assets[0]);
+		THEN("its bytes should no longer be counted")
+			SHOULD_INT_EQUAL((int)r.Bytes, 50);
+		AND("the others should still be found by their ids")
+			SHOULD_BE_FALSE(ResidencyHas(&r, assets[0].Id, &assets[0]));
+			SHOULD_BE_TRUE(ResidencyHas(&r, assets[1].Id, &assets[1]));
+			SHOULD_BE_TRUE(ResidencyHas(&r, assets[2].Id, &assets[2]));
+		ResidencyTerminate(&r);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Residency features are:", TEST_FEATURE(ResidencyUse),
+	TEST_FEATURE(ResidencyEvict), TEST_FEATURE(ResidencyRemove))
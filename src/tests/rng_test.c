@@ -0,0 +1,134 @@
+#include <cbehave/cbehave.h>
+
+#include <rng.h>
+
+#define SAMPLES 1000
+
+
+FEATURE(RngSeed, "Seeding")
+	SCENARIO("Same seed")
+		GIVEN("a stream seeded with a seed")
+			RngSeed(RNG_MAPGEN, 1234);
+			uint32_t first[SAMPLES];
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				first[i] = RngNext(RNG_MAPGEN);
+			}
+		WHEN("I seed it again with the same seed")
+			RngSeed(RNG_MAPGEN, 1234);
+		THEN("it should produce the same numbers")
+			int mismatches = 0;
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				mismatches += RngNext(RNG_MAPGEN) != first[i];
+			}
+			SHOULD_INT_EQUAL(mismatches, 0);
+		AND("remember the seed")
+			SHOULD_BE_TRUE(RngGetSeed(RNG_MAPGEN) == 1234);
+	SCENARIO_END
+
+	SCENARIO("Different seeds")
+		GIVEN("two streams seeded differently")
+			RngSeed(RNG_MAPGEN, 1);
+			RngSeed(RNG_GAMEPLAY, 2);
+		WHEN("I draw numbers from both")
+			int same = 0;
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				same += RngNext(RNG_MAPGEN) == RngNext(RNG_GAMEPLAY);
+			}
+		THEN("they should be different")
+			SHOULD_BE_TRUE(same < 5);
+	SCENARIO_END
+
+	SCENARIO("Same seed, different streams")
+		GIVEN("all streams seeded with the same seed")
+			RngSeedAll(42);
+		WHEN("I draw numbers from two streams")
+			int same = 0;
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				same += RngNext(RNG_AI) == RngNext(RNG_COSMETIC);
+			}
+		THEN("they should be different")
+			SHOULD_BE_TRUE(same < 5);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(RngIndependence, "Stream independence")
+	SCENARIO("Draw from another stream")
+		GIVEN("a stream seeded and drawn from")
+			RngSeedAll(99);
+			uint32_t first[SAMPLES];
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				first[i] = RngNext(RNG_MAPGEN);
+			}
+		WHEN("I reseed it, and draw from other streams in between")
+			RngSeedAll(99);
+			int mismatches = 0;
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				RngNext(RNG_COSMETIC);
+				RngInt(RNG_GAMEPLAY, 0, 10);
+				mismatches += RngNext(RNG_MAPGEN) != first[i];
+			}
+		THEN("it should produce the same numbers")
+			SHOULD_INT_EQUAL(mismatches, 0);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(RngRange, "Ranges")
+	SCENARIO("Ints")
+		GIVEN("a seeded stream")
+			RngSeed(RNG_GAMEPLAY, 7);
+		WHEN("I draw ints in a range")
+			int counts[5] = {0, 0, 0, 0, 0};
+			int outOfRange = 0;
+			for (int i = 0; i < SAMPLES * 5; i++)
+			{
+				const int v = RngInt(RNG_GAMEPLAY, -2, 3);
+				if (v < -2 || v >= 3)
+				{
+					outOfRange++;
+				}
+				else
+				{
+					counts[v + 2]++;
+				}
+			}
+		THEN("they should all be in range")
+			SHOULD_INT_EQUAL(outOfRange, 0);
+		AND("cover the whole range")
+			for (int i = 0; i < 5; i++)
+			{
+				SHOULD_BE_TRUE(counts[i] > SAMPLES / 2);
+			}
+		AND("an empty range should give the low value")
+			SHOULD_INT_EQUAL(RngInt(RNG_GAMEPLAY, 4, 4), 4);
+	SCENARIO_END
+
+	SCENARIO("Doubles")
+		GIVEN("a seeded stream")
+			RngSeed(RNG_COSMETIC, 7);
+		WHEN("I draw doubles")
+			int outOfRange = 0;
+			double sum = 0;
+			for (int i = 0; i < SAMPLES; i++)
+			{
+				const double d = RngDouble(RNG_COSMETIC);
+				outOfRange += d < 0 || d >= 1;
+				sum += d;
+			}
+		THEN("they should all be in [0, 1)")
+			SHOULD_INT_EQUAL(outOfRange, 0);
+		AND("average about a half")
+			SHOULD_BE_TRUE(sum / SAMPLES > 0.4 && sum / SAMPLES < 0.6);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Random number streams features are:",
+	TEST_FEATURE(RngSeed),
+	TEST_FEATURE(RngIndependence),
+	TEST_FEATURE(RngRange))
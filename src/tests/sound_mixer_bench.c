@@ -0,0 +1,72 @@
+// Benchmark for the software sound mixer; prints the mixing cost per
+// voice for different numbers of voices. Not run as part of the tests.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sound_mixer.h>
+
+#define SOUND_FRAMES (44100 * 2)
+#define BUFFER_FRAMES 1024
+#define BUFFERS 2000
+
+static Sint16 sound[SOUND_FRAMES * SOUND_MIXER_CHANNELS];
+static Sint16 buffer[BUFFER_FRAMES * SOUND_MIXER_CHANNELS];
+
+static double Run(const int voices, const bool isMuffled, Uint64 *frames)
+{
+	Mix_Chunk c;
+	c.abuf = (Uint8 *)sound;
+	c.alen = sizeof sound;
+	c.allocated = 0;
+	c.volume = MIX_MAX_VOLUME;
+	SoundMixer m;
+	SoundMixerInit(&m, voices);
+	const clock_t start = clock();
+	for (int i = 0; i < BUFFERS; i++)
+	{
+		for (int v = 0; v < voices; v++)
+		{
+			// Keep every voice playing, at different positions
+			if (!SoundMixerIsPlaying(&m, v))
+			{
+				SoundMixerPlay(&m, v, &c);
+				SoundMixerSetPosition(
+					&m, v, (Sint16)(v * 360 / voices), (Uint8)(v * 8));
+				SoundMixerSetMuffled(&m, v, isMuffled);
+			}
+		}
+		memset(buffer, 0, sizeof buffer);
+		SoundMixerMix(&m, buffer, BUFFER_FRAMES);
+	}
+	const double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	*frames = m.Stats.VoiceFrames;
+	SoundMixerTerminate(&m);
+	return secs;
+}
+
+int main(void)
+{
+	srand(42);
+	for (int i = 0; i < SOUND_FRAMES * SOUND_MIXER_CHANNELS; i++)
+	{
+		sound[i] = (Sint16)(rand() % 65536 - 32768);
+	}
+	const int voiceCounts[] = {1, 8, 32};
+	for (int i = 0; i < 3; i++)
+	{
+		for (int muffled = 0; muffled < 2; muffled++)
+		{
+			Uint64 frames;
+			const double secs = Run(voiceCounts[i], muffled, &frames);
+			const double audioSecs = (double)BUFFER_FRAMES * BUFFERS / 44100;
+			printf(
+				"%2d voices%s: %.2f ns per voice frame, %.2f%% of real time\n",
+				voiceCounts[i], muffled ? " muffled" : "",
+				frames > 0 ? secs * 1e9 / frames : 0.0,
+				secs * 100 / audioSecs);
+		}
+	}
+	return 0;
+}
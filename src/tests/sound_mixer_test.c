@@ -0,0 +1,217 @@
+#include <cbehave/cbehave.h>
+
+#include <sound_mixer.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL_atomic.h>
+#include <SDL_thread.h>
+
+
+#define FRAMES 8
+static Sint16 sSamples[FRAMES * SOUND_MIXER_CHANNELS];
+// A sound with the same sample in every frame, or an impulse
+static Mix_Chunk MakeChunk(const Sint16 sample, const bool isImpulse)
+{
+	for (int i = 0; i < FRAMES * SOUND_MIXER_CHANNELS; i++)
+	{
+		sSamples[i] = isImpulse && i >= SOUND_MIXER_CHANNELS ? 0 : sample;
+	}
+	Mix_Chunk c;
+	memset(&c, 0, sizeof c);
+	c.abuf = (Uint8 *)sSamples;
+	c.alen = sizeof sSamples;
+	return c;
+}
+// Mix one frame of the sound played at the position
+static void MixAt(
+	const Mix_Chunk *c, const Sint16 bearing, const Uint8 distance,
+	const bool isMuffled, Sint16 *out)
+{
+	SoundMixer m;
+	SoundMixerInit(&m, 1);
+	SoundMixerPlay(&m, 0, c);
+	SoundMixerSetPosition(&m, 0, bearing, distance);
+	SoundMixerSetMuffled(&m, 0, isMuffled);
+	out[0] = 0;
+	out[1] = 0;
+	SoundMixerMix(&m, out, 1);
+	SoundMixerTerminate(&m);
+}
+
+#define THREAD_VOICES 4
+// Long sounds, so that voices are still playing whenever the mixing thread
+// is interrupted
+#define THREAD_FRAMES 44100
+#define THREAD_MIX_FRAMES 512
+#define THREAD_SAMPLE 1000
+#define FREED_SAMPLE 7
+typedef struct
+{
+	SoundMixer *Mixer;
+	SDL_atomic_t Done;
+	SDL_atomic_t Mixes;
+	int BadSamples; // not a whole number of playing voices
+} MixThreadData;
+// Mix like the audio thread until told to stop
+static int MixThread(void *data)
+{
+	MixThreadData *d = data;
+	while (!SDL_AtomicGet(&d->Done))
+	{
+		Sint16 out[THREAD_MIX_FRAMES * SOUND_MIXER_CHANNELS];
+		memset(out, 0, sizeof out);
+		SoundMixerLock(d->Mixer);
+		SoundMixerMix(d->Mixer, out, THREAD_MIX_FRAMES);
+		SoundMixerUnlock(d->Mixer);
+		for (int i = 0; i < THREAD_MIX_FRAMES * SOUND_MIXER_CHANNELS; i++)
+		{
+			d->BadSamples += out[i] % THREAD_SAMPLE != 0;
+		}
+		SDL_AtomicAdd(&d->Mixes, 1);
+	}
+	return 0;
+}
+// Stop a voice and free its sound, then play a newly loaded sound, the way
+// the game does from the main thread
+static void ReplaceVoiceSound(SoundMixer *m, const int voice, Mix_Chunk *c)
+{
+	SoundMixerLock(m);
+	SoundMixerStop(m, voice);
+	SoundMixerUnlock(m);
+	if (c->abuf != NULL)
+	{
+		// Mark the freed sound so that mixing it afterwards shows up
+		Sint16 *samples = (Sint16 *)c->abuf;
+		for (int i = 0; i < THREAD_FRAMES * SOUND_MIXER_CHANNELS; i++)
+		{
+			samples[i] = FREED_SAMPLE;
+		}
+		free(c->abuf);
+	}
+	Sint16 *samples =
+		malloc(THREAD_FRAMES * SOUND_MIXER_CHANNELS * sizeof *samples);
+	for (int i = 0; i < THREAD_FRAMES * SOUND_MIXER_CHANNELS; i++)
+	{
+		samples[i] = THREAD_SAMPLE;
+	}
+	c->abuf = (Uint8 *)samples;
+	c->alen = THREAD_FRAMES * SOUND_MIXER_CHANNELS * sizeof *samples;
+	SoundMixerLock(m);
+	SoundMixerPlay(m, voice, c);
+	SoundMixerSetPosition(m, voice, 0, 0);
+	SoundMixerUnlock(m);
+}
+
+
+FEATURE(SoundMixerMix, "Spatialization")
+	SCENARIO("Distance and bearing")
+		GIVEN("a constant sound")
+			const Mix_Chunk c = MakeChunk(12000, false);
+			Sint16 out[2];
+		WHEN("I play it in front")
+			MixAt(&c, 0, 0, false, out);
+		THEN("both sides should be at full volume")
+			SHOULD_INT_EQUAL(out[0], 12000);
+			SHOULD_INT_EQUAL(out[1], 12000);
+		WHEN("I play it to the right")
+			MixAt(&c, 90, 0, false, out);
+		THEN("only the right side should play")
+			SHOULD_INT_EQUAL(out[0], 0);
+			SHOULD_INT_EQUAL(out[1], 12000);
+		WHEN("I play it to the left")
+			MixAt(&c, 270, 0, false, out);
+		THEN("only the left side should play")
+			SHOULD_INT_EQUAL(out[0], 12000);
+			SHOULD_INT_EQUAL(out[1], 0);
+		WHEN("I play it at half distance in front")
+			MixAt(&c, 0, 128, false, out);
+		THEN("it should be attenuated")
+			SHOULD_INT_EQUAL(out[0], 5976);
+			SHOULD_INT_EQUAL(out[1], 5976);
+		WHEN("I play it at the furthest distance")
+			MixAt(&c, 0, 255, false, out);
+		THEN("it should be silent")
+			SHOULD_INT_EQUAL(out[0], 0);
+			SHOULD_INT_EQUAL(out[1], 0);
+	SCENARIO_END
+	SCENARIO("Muffle")
+		GIVEN("an impulse")
+			const Mix_Chunk c = MakeChunk(3000, true);
+			Sint16 out[2];
+		WHEN("I play it muffled")
+			MixAt(&c, 0, 0, true, out);
+		THEN("it should be spread over three frames")
+			SHOULD_INT_EQUAL(out[0], 1000);
+			SHOULD_INT_EQUAL(out[1], 1000);
+		AND("it should match the muffle effect")
+			Sint16 muffled[FRAMES * SOUND_MIXER_CHANNELS];
+			memcpy(muffled, sSamples, sizeof muffled);
+			SoundMuffle(muffled, FRAMES);
+			SHOULD_INT_EQUAL(out[0], muffled[0]);
+	SCENARIO_END
+	SCENARIO("Mix voices")
+		GIVEN("two loud voices")
+			const Mix_Chunk c = MakeChunk(20000, false);
+			SoundMixer m;
+			SoundMixerInit(&m, 2);
+			SoundMixerPlay(&m, 0, &c);
+			SoundMixerPlay(&m, 1, &c);
+		WHEN("I mix past the end of the sound")
+			Sint16 out[(FRAMES + 2) * SOUND_MIXER_CHANNELS];
+			memset(out, 0, sizeof out);
+			SoundMixerMix(&m, out, FRAMES + 2);
+		THEN("the mix should be clipped")
+			SHOULD_INT_EQUAL(out[0], 32767);
+		AND("the frames after the sound should be silent")
+			SHOULD_INT_EQUAL(out[FRAMES * SOUND_MIXER_CHANNELS], 0);
+		AND("the voices should have stopped")
+			SHOULD_BE_FALSE(SoundMixerIsPlaying(&m, 0));
+			SHOULD_BE_FALSE(SoundMixerIsPlaying(&m, 1));
+		AND("the voice frames should be counted")
+			SHOULD_INT_EQUAL((int)m.Stats.Frames, FRAMES + 2);
+			SHOULD_INT_EQUAL((int)m.Stats.VoiceFrames, FRAMES * 2);
+		SoundMixerTerminate(&m);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(SoundMixerLock, "Mixing on another thread")
+	SCENARIO("Play and stop voices while mixing")
+		GIVEN("a mixer mixing on another thread")
+			SoundMixer m;
+			SoundMixerInit(&m, THREAD_VOICES);
+			Mix_Chunk chunks[THREAD_VOICES];
+			memset(chunks, 0, sizeof chunks);
+			MixThreadData d;
+			d.Mixer = &m;
+			SDL_AtomicSet(&d.Done, 0);
+			SDL_AtomicSet(&d.Mixes, 0);
+			d.BadSamples = 0;
+			SDL_Thread *t = SDL_CreateThread(MixThread, "Mix", &d);
+			SHOULD_BE_TRUE(t != NULL);
+		WHEN("I keep freeing sounds and playing new ones")
+			for (int i = 0; t != NULL && SDL_AtomicGet(&d.Mixes) < 1000; i++)
+			{
+				const int voice = i % THREAD_VOICES;
+				ReplaceVoiceSound(&m, voice, &chunks[voice]);
+			}
+			SDL_AtomicSet(&d.Done, 1);
+			SDL_WaitThread(t, NULL);
+		THEN("the mix should never have used a freed sound")
+			SHOULD_INT_EQUAL(d.BadSamples, 0);
+		AND("the mix should have run")
+			SHOULD_BE_TRUE(SDL_AtomicGet(&d.Mixes) > 0);
+		for (int i = 0; i < THREAD_VOICES; i++)
+		{
+			free(chunks[i].abuf);
+		}
+		SoundMixerTerminate(&m);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Sound mixer features are:",
+	TEST_FEATURE(SoundMixerMix),
+	TEST_FEATURE(SoundMixerLock)
+)
@@ -0,0 +1,83 @@
+#include <cbehave/cbehave.h>
+
+#include <sound_occlusion.h>
+
+
+// A 6x5 map with a wall down the middle, drawn with '#' for walls
+static char sRows[] = "......"
+					  "...#.."
+					  "...#.."
+					  "...#.."
+					  "......";
+static bool IsOpaque(void *data, const struct vec2i v)
+{
+	const char *rows = data;
+	if (v.x < 0 || v.y < 0 || v.x >= 6 || v.y >= 5)
+	{
+		return false;
+	}
+	return rows[v.y * 6 + v.x] == '#';
+}
+
+
+FEATURE(SoundOcclusionIsBlocked, "Occlusion of sounds")
+	SCENARIO("Sounds behind walls")
+		GIVEN("occlusion for a map with a wall")
+			SoundOcclusion o;
+			SoundOcclusionInit(&o, IsOpaque, sRows);
+			SoundOcclusionSetSize(&o, svec2i(6, 5));
+		WHEN("I hear sounds from both sides of the wall")
+			const bool behind =
+				SoundOcclusionIsBlocked(&o, svec2i(5, 2), svec2i(1, 2));
+			const bool inFront =
+				SoundOcclusionIsBlocked(&o, svec2i(2, 0), svec2i(1, 2));
+		THEN("only the sound behind the wall should be muffled")
+			SHOULD_BE_TRUE(behind);
+			SHOULD_BE_FALSE(inFront);
+		SoundOcclusionTerminate(&o);
+	SCENARIO_END
+	SCENARIO("Raycast each tile once per listener tile")
+		GIVEN("occlusion for a map with a wall")
+			SoundOcclusion o;
+			SoundOcclusionInit(&o, IsOpaque, sRows);
+			SoundOcclusionSetSize(&o, svec2i(6, 5));
+		WHEN("I hear many sounds from the same tiles")
+			for (int i = 0; i < 10; i++)
+			{
+				SoundOcclusionIsBlocked(&o, svec2i(5, 2), svec2i(1, 2));
+				SoundOcclusionIsBlocked(&o, svec2i(2, 0), svec2i(1, 2));
+			}
+		THEN("each tile should be raycast once")
+			SHOULD_INT_EQUAL(o.Stats.Queries, 20);
+			SHOULD_INT_EQUAL(o.Stats.Raycasts, 2);
+		AND("moving the listener to another tile should raycast again")
+			SHOULD_BE_FALSE(
+				SoundOcclusionIsBlocked(&o, svec2i(5, 2), svec2i(5, 0)));
+			SHOULD_INT_EQUAL(o.Stats.Raycasts, 3);
+		AND("moving back should remember the first listener tile")
+			SHOULD_BE_TRUE(
+				SoundOcclusionIsBlocked(&o, svec2i(5, 2), svec2i(1, 2)));
+			SHOULD_INT_EQUAL(o.Stats.Raycasts, 3);
+		AND("invalidating should raycast again")
+			SoundOcclusionInvalidate(&o);
+			SoundOcclusionIsBlocked(&o, svec2i(5, 2), svec2i(1, 2));
+			SHOULD_INT_EQUAL(o.Stats.Raycasts, 4);
+		SoundOcclusionTerminate(&o);
+	SCENARIO_END
+	SCENARIO("Sounds outside the map")
+		GIVEN("occlusion for a map with a wall")
+			SoundOcclusion o;
+			SoundOcclusionInit(&o, IsOpaque, sRows);
+			SoundOcclusionSetSize(&o, svec2i(6, 5));
+		WHEN("I hear a sound from outside the map")
+			const bool blocked =
+				SoundOcclusionIsBlocked(&o, svec2i(-1, 2), svec2i(1, 2));
+		THEN("it should be raycast without being remembered")
+			SHOULD_BE_FALSE(blocked);
+			SHOULD_INT_EQUAL(o.Stats.Raycasts, 1);
+		SoundOcclusionTerminate(&o);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Sound occlusion features are:", TEST_FEATURE(SoundOcclusionIsBlocked))
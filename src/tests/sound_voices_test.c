@@ -0,0 +1,151 @@
+#include <cbehave/cbehave.h>
+
+#include <sound_voices.h>
+
+
+static bool sPlaying[8];
+static bool IsPlaying(const int voice)
+{
+	return sPlaying[voice];
+}
+static int sKeys[4];
+static Voice MakeVoice(
+	const int key, const SoundPriority priority, const int distance,
+	const float x, const Uint32 ticks)
+{
+	Voice v;
+	v.Key = &sKeys[key];
+	v.Priority = priority;
+	v.Distance = distance;
+	v.Pos = svec2(x, 0);
+	v.Ticks = ticks;
+	return v;
+}
+// Start a voice and mark it playing
+static VoiceResult Start(
+	VoiceManager *vm, const Voice v, const int maxInstances, int *voice)
+{
+	const VoiceResult r = VoiceManagerStart(vm, &v, maxInstances, voice);
+	if (r == VOICE_STARTED)
+	{
+		sPlaying[*voice] = true;
+	}
+	return r;
+}
+
+
+FEATURE(VoiceManagerStart, "Start voices")
+	SCENARIO("Merge identical sounds")
+		GIVEN("a sound that has just started")
+			memset(sPlaying, 0, sizeof sPlaying);
+			VoiceManager vm;
+			VoiceManagerInit(&vm, 8, IsPlaying);
+			int first;
+			Start(&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 10, 0, 100), 0,
+				  &first);
+		WHEN("I start the same sound nearby in the same tick")
+			int second;
+			const VoiceResult r = Start(
+				&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 10, 4, 101), 0,
+				&second);
+		THEN("it should be merged with the first")
+			SHOULD_INT_EQUAL(r, VOICE_MERGED);
+			SHOULD_INT_EQUAL(second, first);
+			SHOULD_INT_EQUAL(vm.Stats.Merged, 1);
+		AND("the same sound far away or later should start")
+			SHOULD_INT_EQUAL(
+				Start(&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 10, 200, 101),
+					  0, &second),
+				VOICE_STARTED);
+			SHOULD_INT_EQUAL(
+				Start(&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 10, 0, 200), 0,
+					  &second),
+				VOICE_STARTED);
+			SHOULD_INT_EQUAL(vm.Stats.Started, 3);
+		VoiceManagerTerminate(&vm);
+	SCENARIO_END
+
+	SCENARIO("Limit instances")
+		GIVEN("two instances of a sound limited to two")
+			memset(sPlaying, 0, sizeof sPlaying);
+			VoiceManager vm;
+			VoiceManagerInit(&vm, 8, IsPlaying);
+			int a, b;
+			Start(&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 50, 0, 0), 2, &a);
+			Start(&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 10, 0, 100), 2, &b);
+		WHEN("I start a quieter instance")
+			int c;
+			const VoiceResult quieter = Start(
+				&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 80, 0, 200), 2, &c);
+		THEN("it should be dropped")
+			SHOULD_INT_EQUAL(quieter, VOICE_DROPPED);
+			SHOULD_INT_EQUAL(vm.Stats.Dropped, 1);
+		AND("a louder instance should replace the quietest one")
+			SHOULD_INT_EQUAL(
+				Start(&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 20, 0, 300), 2,
+					  &c),
+				VOICE_STARTED);
+			SHOULD_INT_EQUAL(c, a);
+			SHOULD_INT_EQUAL(vm.Stats.Stolen, 1);
+		AND("other sounds should not be limited")
+			SHOULD_INT_EQUAL(
+				Start(&vm, MakeVoice(1, SOUND_PRIORITY_NORMAL, 80, 0, 300), 2,
+					  &c),
+				VOICE_STARTED);
+		VoiceManagerTerminate(&vm);
+	SCENARIO_END
+
+	SCENARIO("Steal voices")
+		GIVEN("all voices in use")
+			memset(sPlaying, 0, sizeof sPlaying);
+			VoiceManager vm;
+			VoiceManagerInit(&vm, 4, IsPlaying);
+			int v[4];
+			Start(&vm, MakeVoice(0, SOUND_PRIORITY_HIGH, 90, 0, 0), 0, &v[0]);
+			Start(&vm, MakeVoice(1, SOUND_PRIORITY_LOW, 10, 0, 0), 0, &v[1]);
+			Start(&vm, MakeVoice(2, SOUND_PRIORITY_LOW, 60, 0, 0), 0, &v[2]);
+			Start(&vm, MakeVoice(3, SOUND_PRIORITY_LOW, 60, 0, 50), 0, &v[3]);
+		WHEN("I start a normal priority sound")
+			int voice;
+			const VoiceResult r = Start(
+				&vm, MakeVoice(0, SOUND_PRIORITY_NORMAL, 90, 0, 100), 0,
+				&voice);
+		THEN("the oldest of the quietest low priority sounds is stolen")
+			SHOULD_INT_EQUAL(r, VOICE_STARTED);
+			SHOULD_INT_EQUAL(voice, v[2]);
+		AND("a quieter low priority sound should be dropped")
+			SHOULD_INT_EQUAL(
+				Start(&vm, MakeVoice(1, SOUND_PRIORITY_LOW, 90, 50, 100), 0,
+					  &voice),
+				VOICE_DROPPED);
+		AND("finished voices should be reused")
+			sPlaying[v[1]] = false;
+			SHOULD_INT_EQUAL(
+				Start(&vm, MakeVoice(1, SOUND_PRIORITY_LOW, 0, 50, 101), 0,
+					  &voice),
+				VOICE_STARTED);
+			SHOULD_INT_EQUAL(voice, v[1]);
+		VoiceManagerTerminate(&vm);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(SoundVoiceClassFromName, "Voice classes")
+	SCENARIO("Classes by name")
+		GIVEN("sound names")
+		WHEN("I get their voice classes")
+			const SoundVoiceClass footsteps =
+				SoundVoiceClassFromName("footsteps/boots");
+			const SoundVoiceClass menu = SoundVoiceClassFromName("menu_back");
+			const SoundVoiceClass other = SoundVoiceClassFromName("mg");
+		THEN("they should have their priorities")
+			SHOULD_INT_EQUAL(footsteps.Priority, SOUND_PRIORITY_LOW);
+			SHOULD_INT_EQUAL(menu.Priority, SOUND_PRIORITY_HIGH);
+			SHOULD_INT_EQUAL(other.Priority, SOUND_PRIORITY_NORMAL);
+		AND("a limit on instances")
+			SHOULD_BE_TRUE(other.MaxInstances > 0);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Sound voice features are:", TEST_FEATURE(VoiceManagerStart),
+	TEST_FEATURE(SoundVoiceClassFromName))
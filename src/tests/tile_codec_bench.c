@@ -0,0 +1,166 @@
+// Benchmark for decoding and encoding static map tiles; prints megatiles per
+// second for the old strtok/atoi CSV decoder and snprintf encoder, and the
+// tile codec CSV and RLE, on a large generated map.
+// Not run as part of the tests.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <tile_codec.h>
+#include <utils.h>
+
+#define WIDTH 256
+#define HEIGHT 256
+#define ITERATIONS 50
+
+// As MissionStaticLoadTileCSV used to
+static void OldDecode(CArray *tiles, const char *tileCSV)
+{
+	const char *p = tileCSV;
+	for (;;)
+	{
+		while (*p == ',')
+		{
+			p++;
+		}
+		if (*p == '\0')
+		{
+			break;
+		}
+		const int n = atoi(p);
+		CArrayPushBack(tiles, &n);
+		p += strcspn(p, ",");
+	}
+}
+// As SaveStaticCSV used to
+static void OldEncode(char *rowBuf, const CArray *values, const int row)
+{
+	char *pBuf = rowBuf;
+	*pBuf = '\0';
+	for (int j = 0; j < WIDTH; j++)
+	{
+		char buf[6];
+		snprintf(buf, 6, "%d", *(int *)CArrayGet(values, row * WIDTH + j));
+		strcpy(pBuf, buf);
+		pBuf += strlen(buf);
+		if (j < WIDTH - 1)
+		{
+			*pBuf++ = ',';
+		}
+	}
+}
+
+static void Report(const char *name, const clock_t start)
+{
+	const double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf(
+		"%s: %.1f Mtiles/s\n", name,
+		(double)WIDTH * HEIGHT * ITERATIONS / 1000000 / secs);
+}
+
+int main(void)
+{
+	// Rooms of a few tile types, like an imported map
+	srand(42);
+	CArray tiles;
+	CArrayInit(&tiles, sizeof(int));
+	int value = 0;
+	for (int i = 0; i < WIDTH * HEIGHT; i++)
+	{
+		if (rand() % 16 == 0)
+		{
+			value = rand() % 200;
+		}
+		CArrayPushBack(&tiles, &value);
+	}
+	char *rows[HEIGHT];
+	size_t csvLen = 0;
+	for (int y = 0; y < HEIGHT; y++)
+	{
+		CMALLOC(rows[y], TILE_CSV_MAX_LEN(WIDTH));
+		csvLen += TileCSVEncode(rows[y], &tiles, y * WIDTH, WIDTH);
+	}
+	char *rle = TileRLEEncode(&tiles);
+	printf(
+		"%dx%d map: CSV %d bytes, RLE %d bytes\n", WIDTH, HEIGHT, (int)csvLen,
+		(int)strlen(rle));
+
+	CArray decoded;
+	clock_t start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		CArrayInit(&decoded, sizeof(int));
+		for (int y = 0; y < HEIGHT; y++)
+		{
+			OldDecode(&decoded, rows[y]);
+		}
+		CArrayTerminate(&decoded);
+	}
+	Report("decode old CSV", start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		CArrayInit(&decoded, sizeof(int));
+		CArrayReserve(&decoded, WIDTH * HEIGHT);
+		for (int y = 0; y < HEIGHT; y++)
+		{
+			TileCSVDecode(&decoded, rows[y]);
+		}
+		CArrayTerminate(&decoded);
+	}
+	Report("decode CSV", start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		CArrayInit(&decoded, sizeof(int));
+		if (!TileRLEDecode(&decoded, rle))
+		{
+			printf("RLE decode failed\n");
+			return 1;
+		}
+		CArrayTerminate(&decoded);
+	}
+	Report("decode RLE", start);
+
+	char *buf;
+	CMALLOC(buf, TILE_CSV_MAX_LEN(WIDTH));
+	start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		for (int y = 0; y < HEIGHT; y++)
+		{
+			OldEncode(buf, &tiles, y);
+		}
+	}
+	Report("encode old CSV", start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		for (int y = 0; y < HEIGHT; y++)
+		{
+			TileCSVEncode(buf, &tiles, y * WIDTH, WIDTH);
+		}
+	}
+	Report("encode CSV", start);
+
+	start = clock();
+	for (int i = 0; i < ITERATIONS; i++)
+	{
+		CFREE(rle);
+		rle = TileRLEEncode(&tiles);
+	}
+	Report("encode RLE", start);
+
+	CFREE(buf);
+	CFREE(rle);
+	for (int y = 0; y < HEIGHT; y++)
+	{
+		CFREE(rows[y]);
+	}
+	CArrayTerminate(&tiles);
+	return 0;
+}
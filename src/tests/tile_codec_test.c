@@ -0,0 +1,243 @@
+#include <cbehave/cbehave.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mission_static.h>
+#include <tile_codec.h>
+#include <utils.h>
+
+#define WIDTH 37
+#define HEIGHT 23
+
+// Large areas of the same tile, like a real map, with some noise
+static void MakeTiles(CArray *a, const size_t elemSize, const int maxValue)
+{
+	srand(42);
+	CArrayInit(a, elemSize);
+	int value = 0;
+	for (int i = 0; i < WIDTH * HEIGHT; i++)
+	{
+		if (rand() % 8 == 0)
+		{
+			value = rand() % maxValue;
+		}
+		if (elemSize == sizeof(uint16_t))
+		{
+			const uint16_t v = (uint16_t)value;
+			CArrayPushBack(a, &v);
+		}
+		else
+		{
+			CArrayPushBack(a, &value);
+		}
+	}
+}
+static bool ArraysEqual(const CArray *a, const CArray *b)
+{
+	return a->elemSize == b->elemSize && a->size == b->size &&
+		   memcmp(a->data, b->data, a->size * a->elemSize) == 0;
+}
+
+
+FEATURE(TileCSV, "Tile CSV")
+	SCENARIO("Decode legacy CSV")
+		GIVEN("CSV with empty values, signs and trailing junk")
+			const char *csv = ",12,,0,-3, 7,+5,40x,";
+		WHEN("I decode it")
+			CArray a;
+			CArrayInit(&a, sizeof(int));
+			TileCSVDecode(&a, csv);
+		THEN("the values should be the same as parsing with atoi")
+			SHOULD_INT_EQUAL((int)TileCSVCount(csv), 6);
+			SHOULD_INT_EQUAL((int)a.size, 6);
+			const int expected[] = {12, 0, -3, 7, 5, 40};
+			for (int i = 0; i < 6; i++)
+			{
+				SHOULD_INT_EQUAL(*(int *)CArrayGet(&a, i), expected[i]);
+			}
+			CArrayTerminate(&a);
+	SCENARIO_END
+
+	SCENARIO("Round trip tiles by row")
+		GIVEN("some tiles")
+			CArray tiles;
+			MakeTiles(&tiles, sizeof(int), 1000);
+		WHEN("I encode each row and decode them again")
+			CArray decoded;
+			CArrayInit(&decoded, sizeof(int));
+			char buf[TILE_CSV_MAX_LEN(WIDTH)];
+			for (int y = 0; y < HEIGHT; y++)
+			{
+				TileCSVEncode(buf, &tiles, y * WIDTH, WIDTH);
+				TileCSVDecode(&decoded, buf);
+			}
+		THEN("the tiles should be the same")
+			SHOULD_BE_TRUE(ArraysEqual(&tiles, &decoded));
+			CArrayTerminate(&tiles);
+			CArrayTerminate(&decoded);
+	SCENARIO_END
+
+	SCENARIO("Round trip access")
+		GIVEN("some 16-bit access values")
+			CArray access;
+			MakeTiles(&access, sizeof(uint16_t), 65536);
+		WHEN("I encode and decode them")
+			char *buf;
+			CMALLOC(buf, TILE_CSV_MAX_LEN(access.size));
+			TileCSVEncode(buf, &access, 0, access.size);
+			CArray decoded;
+			CArrayInit(&decoded, sizeof(uint16_t));
+			TileCSVDecode(&decoded, buf);
+		THEN("the values should be the same")
+			SHOULD_BE_TRUE(ArraysEqual(&access, &decoded));
+			CFREE(buf);
+			CArrayTerminate(&access);
+			CArrayTerminate(&decoded);
+	SCENARIO_END
+FEATURE_END
+
+FEATURE(TileRLE, "Tile RLE")
+	SCENARIO("Round trip tiles")
+		GIVEN("some tiles")
+			CArray tiles;
+			MakeTiles(&tiles, sizeof(int), 1000);
+			const int negative = -2;
+			CArrayPushBack(&tiles, &negative);
+		WHEN("I encode and decode them")
+			char *s = TileRLEEncode(&tiles);
+			CArray decoded;
+			CArrayInit(&decoded, sizeof(int));
+			const bool ok = TileRLEDecode(&decoded, s);
+		THEN("the tiles should be the same")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_BE_TRUE(ArraysEqual(&tiles, &decoded));
+		AND("be smaller than CSV")
+			SHOULD_BE_TRUE(strlen(s) < tiles.size);
+			CFREE(s);
+			CArrayTerminate(&tiles);
+			CArrayTerminate(&decoded);
+	SCENARIO_END
+
+	SCENARIO("Round trip short arrays")
+		GIVEN("arrays of every padding length")
+			int mismatches = 0;
+		WHEN("I encode and decode them")
+			for (int n = 0; n < 8; n++)
+			{
+				CArray a;
+				CArrayInit(&a, sizeof(uint16_t));
+				for (int i = 0; i < n; i++)
+				{
+					const uint16_t v = (uint16_t)(i * 4099);
+					CArrayPushBack(&a, &v);
+				}
+				char *s = TileRLEEncode(&a);
+				CArray decoded;
+				CArrayInit(&decoded, sizeof(uint16_t));
+				mismatches += !TileRLEDecode(&decoded, s);
+				mismatches += !ArraysEqual(&a, &decoded);
+				CFREE(s);
+				CArrayTerminate(&a);
+				CArrayTerminate(&decoded);
+			}
+		THEN("they should be the same")
+			SHOULD_INT_EQUAL(mismatches, 0);
+	SCENARIO_END
+
+	SCENARIO("Reject invalid data")
+		GIVEN("an array with some values")
+			CArray a;
+			CArrayInit(&a, sizeof(int));
+			const int v = 5;
+			CArrayPushBack(&a, &v);
+		WHEN("I decode bad characters, a truncated run and a zero run")
+			const bool badChars = TileRLEDecode(&a, "AB$D");
+			// value 1 with no count
+			const bool truncated = TileRLEDecode(&a, "Ag==");
+			// value 1, count 0
+			const bool zeroRun = TileRLEDecode(&a, "AgA=");
+		THEN("decoding should fail")
+			SHOULD_BE_FALSE(badChars);
+			SHOULD_BE_FALSE(truncated);
+			SHOULD_BE_FALSE(zeroRun);
+		AND("the array should be unchanged")
+			SHOULD_INT_EQUAL((int)a.size, 1);
+			SHOULD_INT_EQUAL(*(int *)CArrayGet(&a, 0), 5);
+			CArrayTerminate(&a);
+	SCENARIO_END
+FEATURE_END
+
+// A 3x2 mission with CSV tiles and the given access
+static json_t *MakeMission(const char *access)
+{
+	char text[256];
+	sprintf(
+		text, "{\"Tiles\": [\"1,1,2\", \"2,3,3\"], \"Access\": %s}", access);
+	json_t *root = NULL;
+	json_parse_buffer(&root, text, strlen(text));
+	return root;
+}
+
+FEATURE(MissionStaticLoadTiles, "Static mission tiles")
+	SCENARIO("Load CSV and RLE layers")
+		GIVEN("a mission with CSV tiles and RLE access")
+			CArray zeros;
+			CArrayInitFillZero(&zeros, sizeof(uint16_t), 6);
+			char *rle = TileRLEEncode(&zeros);
+			char access[64];
+			sprintf(access, "\"%s\"", rle);
+			json_t *root = MakeMission(access);
+		WHEN("I load them for the mission size")
+			CArray tiles, accessValues;
+			CArrayInit(&tiles, sizeof(int));
+			CArrayInit(&accessValues, sizeof(uint16_t));
+			const bool ok = MissionStaticLoadTiles(
+				&tiles, &accessValues, root, svec2i(3, 2));
+		THEN("both layers should be loaded")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_INT_EQUAL((int)tiles.size, 6);
+			SHOULD_INT_EQUAL(*(int *)CArrayGet(&tiles, 5), 3);
+			SHOULD_INT_EQUAL((int)accessValues.size, 6);
+		CArrayTerminate(&tiles);
+		CArrayTerminate(&accessValues);
+		json_free_value(&root);
+		CFREE(rle);
+		CArrayTerminate(&zeros);
+	SCENARIO_END
+
+	SCENARIO("Reject invalid layers")
+		GIVEN("missions with invalid RLE access and too few access values")
+			json_t *badRLE = MakeMission("\"AB$D\"");
+			json_t *shortAccess = MakeMission("[\"0,0,0\"]");
+			json_t *valid = MakeMission("[\"0,0,0\", \"0,0,0\"]");
+		WHEN("I load them, and a valid mission for a bigger size")
+			CArray tiles, access;
+			CArrayInit(&tiles, sizeof(int));
+			CArrayInit(&access, sizeof(uint16_t));
+			const struct vec2i size = svec2i(3, 2);
+			const bool loadedBadRLE =
+				MissionStaticLoadTiles(&tiles, &access, badRLE, size);
+			const bool loadedShort =
+				MissionStaticLoadTiles(&tiles, &access, shortAccess, size);
+			const bool loadedBigger =
+				MissionStaticLoadTiles(&tiles, &access, valid, svec2i(3, 3));
+		THEN("loading should fail")
+			SHOULD_BE_FALSE(loadedBadRLE);
+			SHOULD_BE_FALSE(loadedShort);
+			SHOULD_BE_FALSE(loadedBigger);
+		AND("the arrays should be unchanged")
+			SHOULD_INT_EQUAL((int)tiles.size, 0);
+			SHOULD_INT_EQUAL((int)access.size, 0);
+		CArrayTerminate(&tiles);
+		CArrayTerminate(&access);
+		json_free_value(&badRLE);
+		json_free_value(&shortAccess);
+		json_free_value(&valid);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Tile codec features are:", TEST_FEATURE(TileCSV), TEST_FEATURE(TileRLE),
+	TEST_FEATURE(MissionStaticLoadTiles))
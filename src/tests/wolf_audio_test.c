@@ -0,0 +1,203 @@
+#include <cbehave/cbehave.h>
+
+#include <cwolfmap/audio.h>
+
+#include <stdlib.h>
+
+
+// Audio with one song of notes on a few channels, and one short sound
+static char sData[2048];
+static uint32_t sOffsets[3];
+static CWAudio MakeAudio(void)
+{
+	CWAudio a;
+	memset(&a, 0, sizeof a);
+	memset(sData, 0, sizeof sData);
+	a.data = sData;
+	a.head.offsets = sOffsets;
+	a.head.nOffsets = 3;
+	a.nMusic = 1;
+	a.nSound = 1;
+	a.startMusic = 0;
+	a.startAdlibSounds = 1;
+
+	// Song: length, then register, value and delay in ticks
+	uint8_t *p = (uint8_t *)sData + 2;
+	for (int i = 0; i < 30; i++)
+	{
+		const int chan = i % 3;
+		// Modulator and carrier of each channel, then the note
+		const uint8_t regs[][2] = {
+			{(uint8_t)(0x20 + chan), 0x01},
+			{(uint8_t)(0x23 + chan), 0x01},
+			{(uint8_t)(0x60 + chan), 0xf4},
+			{(uint8_t)(0x63 + chan), 0xf4},
+			{(uint8_t)(0x80 + chan), 0x77},
+			{(uint8_t)(0x83 + chan), 0x77},
+			{(uint8_t)(0xe0 + chan), (uint8_t)(i % 4)},
+			{(uint8_t)(0xe3 + chan), (uint8_t)((i + 1) % 4)},
+			{(uint8_t)(0xa0 + chan), (uint8_t)(0x40 + i * 7)},
+			{(uint8_t)(0xb0 + chan), (uint8_t)(0x20 | (i % 2 ? 0x0d : 0))}};
+		const int nRegs = (int)(sizeof regs / sizeof regs[0]);
+		for (int j = 0; j < nRegs; j++)
+		{
+			*p++ = regs[j][0];
+			*p++ = regs[j][1];
+			*p++ = (uint8_t)(j == nRegs - 1 ? 5 + i % 4 : 0);
+			*p++ = 0;
+		}
+	}
+	const uint16_t songLen = (uint16_t)(p - (uint8_t *)sData - 2);
+	memcpy(sData, &songLen, sizeof songLen);
+	sOffsets[0] = 0;
+	sOffsets[1] = (uint32_t)(p - (uint8_t *)sData);
+
+	// Sound: length, priority, instrument, block and notes
+	const uint32_t soundLen = 4;
+	memcpy(p, &soundLen, sizeof soundLen);
+	p += 4 + 2;
+	const uint8_t inst[16] = {
+		0x21, 0x21, 0, 0, 0xf4, 0xf4, 0x77, 0x77, 0, 0, 0};
+	memcpy(p, inst, sizeof inst);
+	p += sizeof inst;
+	*p++ = 4;
+	const uint8_t notes[] = {0x80, 0x90, 0, 0xa0};
+	memcpy(p, notes, sizeof notes);
+	p += sizeof notes;
+	sOffsets[2] = (uint32_t)(p - (uint8_t *)sData);
+	return a;
+}
+
+// Hashes of each tick of the song, as rendered by the whole-song renderer
+// before music was streamed, after loading the audio head had reset the chip
+// and enabled waveform select
+#define TICK_SAMPLES (MUSIC_SAMPLE_RATE / 700)
+static const uint32_t sGoldenTicks[] = {
+	0x5d470f75, 0x5d470f75, 0x2a316355, 0xb7a75015, 0xf2d79ce5, 0x15d1cfc5,
+	0x7b9aee15, 0x43f32435, 0x7ff60215, 0x0a89b4a5, 0x2c38e395, 0x6825aef5,
+	0x22a357b5, 0x74e6e7d5, 0xabc431f5, 0xeb70f7c5, 0x45556e25, 0x22b927d5,
+	0x096e5195, 0xd25e2265, 0xf9ce8b05, 0xb85312b5, 0x36e9f115, 0x986306e5,
+	0xb3c6f565, 0x2680e595, 0xf7553de5, 0xc42810d5, 0xd7e1ac05, 0x4eec3b85,
+	0xa30d5f35, 0x3a47bef5, 0x6e04c5ad, 0x6d754065, 0x534b01f5, 0x75460735,
+	0x3ef8eda5, 0x1f09e0d5, 0x9c66ae05, 0x1b5117b5, 0x90335e75, 0xbaaa3a75,
+	0x54b28ff5, 0xee4071a5, 0xfcc2e725, 0x0ea6b455, 0x98bb49f5, 0x7a5b9b25,
+	0x145b1545, 0x1f6f2305, 0x5d7a5aa5, 0x4f4fa185, 0x75a0a7f5, 0x62e58295,
+	0x845275b5, 0xa8d0a2b5, 0x0ad3ca75, 0x3177b4e5, 0x4ae279f5, 0xd1c6c1a5,
+	0x539a02f5, 0xd51dae35, 0x03159135, 0xccf9b195, 0x1322bf15, 0xc5586245,
+	0xa7bf4575, 0x0893a975, 0x1d39c595, 0xd2387565, 0x6146dbe5, 0x6ae9c155,
+	0x80ee0435, 0x7c823c35, 0xc5ae4895, 0xa7972f95, 0x6d522ff5, 0xc0f42d65,
+	0xa0ad21e5, 0x9c534145, 0x4598c3a5, 0x859f8c8d, 0xed93ed45, 0x3886c225,
+	0xd10d2105, 0x1ade757d, 0x6f93c4e5, 0xad3b8315, 0x7884db65, 0x21f243c5,
+	0xace9e025, 0xf70d0c15, 0x80dae725, 0xa7d50e45, 0x4c8c5775, 0x9d323155,
+	0x5d617c75, 0x1b5c5b6d, 0xa65b6905, 0xa06322d5, 0xc1e17ce5, 0x73126685,
+	0x19745ecd, 0x0732a825, 0x2f520f65, 0xba9429d5, 0x3148088d, 0x098bf68d,
+	0x6794d925, 0x05e29b45, 0x7bf7b635, 0xa03e932d, 0xbd51a175, 0x95499445,
+	0xff710c25, 0xaf227085, 0x0cdfbb35, 0x07e6f4a5, 0x6ab81305, 0x283f6145,
+	0xb5fcd525, 0x7a8ab855, 0x2f329595, 0x8f3db455, 0x6632df75, 0x5cd3a8fd,
+	0x5cc6abb5, 0x3ac8a235, 0x3e8405b5, 0x05f9a1d5, 0x201b477d, 0xe80856ed,
+	0x8892d935, 0xf5226285, 0x942c30bd, 0x9640c425, 0x8eec4cf5, 0x70ef4b25,
+	0xa3d2da35, 0xb65f5dbd, 0x8a680b75, 0x4bd025d5, 0x53da5795, 0xf8973005,
+	0xb659d3c5, 0x8574c635, 0x12c4a7b5, 0xc8e93fa5, 0xfe58ec25, 0x3891de15,
+	0xcda3d475, 0x3c6292c5, 0x20972855, 0x29270695, 0xad631365, 0xbf884385,
+	0x4ed82cd5, 0x88c58825, 0x5dd46835, 0x53ca1f15, 0xd29d44d5, 0xd39b6b85,
+	0xe4afebd5, 0x1bc00b05, 0x5814dd65, 0xc63a20d5, 0xbf6c5ff5, 0xa0a4f4e5,
+	0xb7f58675, 0xd0efaca5, 0xb148b4d5, 0xabaa3385, 0x4b5a8eb5, 0xe3fe54b5,
+	0xec33c79d, 0xd6bf59ad, 0x19235d05, 0x54d58895, 0xcef158f5, 0x7a3fbe75,
+	0xd92cc8a5, 0x95c95ea5, 0x75a6b645, 0xd1629ff5, 0x17d88e35, 0x76dffa45,
+	0xe64366f5, 0x1cc25355,
+};
+#define GOLDEN_TICKS (int)(sizeof sGoldenTicks / sizeof sGoldenTicks[0])
+static uint32_t HashTick(const int16_t *samples)
+{
+	uint32_t h = 2166136261u;
+	for (int i = 0; i < TICK_SAMPLES * MUSIC_AUDIO_CHANNELS; i++)
+	{
+		const uint16_t v = (uint16_t)samples[i];
+		h = (h ^ (v & 0xff)) * 16777619u;
+		h = (h ^ (v >> 8)) * 16777619u;
+	}
+	return h;
+}
+// Count ticks that don't match the golden song
+static int CountDifferentTicks(const int16_t *samples)
+{
+	int bad = 0;
+	for (int i = 0; i < GOLDEN_TICKS; i++)
+	{
+		const int offset = i * TICK_SAMPLES * MUSIC_AUDIO_CHANNELS;
+		bad += HashTick(samples + offset) != sGoldenTicks[i];
+	}
+	return bad;
+}
+
+
+FEATURE(CWAudioMusicStream, "Stream music")
+	CWAudioInit();
+	SCENARIO("Render the same music as before streaming")
+		GIVEN("a song")
+			const CWAudio a = MakeAudio();
+		WHEN("I render the whole song")
+			char *whole;
+			size_t len;
+			SHOULD_INT_EQUAL(CWAudioGetMusic(&a, 0, &whole, &len), 0);
+		THEN("the song should be as long as before")
+			const int samples = (int)(len / (MUSIC_AUDIO_CHANNELS * 2));
+			SHOULD_INT_EQUAL(samples, GOLDEN_TICKS * TICK_SAMPLES);
+		AND("the audio should be the same as before")
+			SHOULD_INT_EQUAL(CountDifferentTicks((const int16_t *)whole), 0);
+		free(whole);
+	SCENARIO_END
+	SCENARIO("Stream music in small pieces")
+		GIVEN("a song")
+			const CWAudio a = MakeAudio();
+			const char *raw;
+			size_t rawLen;
+			CWAudioGetMusicRaw(&a, 0, &raw, &rawLen);
+		WHEN("I stream the song in pieces that don't line up with ticks")
+			CWMusicStream s;
+			SHOULD_INT_EQUAL(CWAudioMusicStreamInit(&s, raw, rawLen), 0);
+			const int samples = GOLDEN_TICKS * TICK_SAMPLES;
+			int16_t *streamed =
+				malloc(samples * MUSIC_AUDIO_CHANNELS * sizeof *streamed);
+			for (int i = 0; i < samples; i += 100)
+			{
+				const int n = samples - i < 100 ? samples - i : 100;
+				CWAudioMusicStreamRender(
+					&s, streamed + i * MUSIC_AUDIO_CHANNELS, n);
+			}
+		THEN("the audio should be the same as before")
+			SHOULD_INT_EQUAL(CountDifferentTicks(streamed), 0);
+		AND("the song should start again after the end")
+			int16_t more[2 * MUSIC_AUDIO_CHANNELS];
+			CWAudioMusicStreamRender(&s, more, 2);
+			SHOULD_INT_EQUAL(s.tick, 1);
+		free(streamed);
+	SCENARIO_END
+	CWAudioTerminate();
+FEATURE_END
+
+FEATURE(CWAudioGetAdlibSound, "Adlib sounds")
+	CWAudioInit();
+	SCENARIO("Cache sounds")
+		GIVEN("a sound that has been synthesised")
+			const CWAudio a = MakeAudio();
+			char *first;
+			size_t firstLen;
+			SHOULD_INT_EQUAL(
+				CWAudioGetAdlibSound(&a, 0, &first, &firstLen), 0);
+			SHOULD_BE_TRUE(firstLen > 0);
+		WHEN("I get the sound again")
+			char *second;
+			size_t secondLen;
+			SHOULD_INT_EQUAL(
+				CWAudioGetAdlibSound(&a, 0, &second, &secondLen), 0);
+		THEN("the cached sound should be returned")
+			SHOULD_BE_TRUE(first == second);
+			SHOULD_INT_EQUAL((int)firstLen, (int)secondLen);
+	SCENARIO_END
+	CWAudioTerminate();
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Wolf audio features are:", TEST_FEATURE(CWAudioMusicStream),
+	TEST_FEATURE(CWAudioGetAdlibSound))
@@ -0,0 +1,113 @@
+// Benchmark for the Wolfenstein import cache; compares a cold import, which
+// expands the levels and synthesizes the adlib sounds, with a warm import
+// that loads them from the cache.
+// Not run as part of the tests.
+// Usage: wolf_cache_bench <wolf3d or spear dir> [spear mission]
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL.h>
+#include <cwolfmap/audio.h>
+#include <cwolfmap/cwolfmap.h>
+#include <wolf_cache.h>
+
+#define CACHE_DIR "wolf_cache_bench"
+#define RUNS 5
+
+static double Ms(const Uint64 start)
+{
+	return (double)(SDL_GetPerformanceCounter() - start) * 1000 /
+		   SDL_GetPerformanceFrequency();
+}
+
+// Import like a cache miss, filling the cache; returns -1 on error
+static double ImportCold(const char *path, const int mission)
+{
+	const Uint64 start = SDL_GetPerformanceCounter();
+	WolfCache c;
+	WolfCacheInit(&c, CACHE_DIR, path, mission);
+	CWolfMap map;
+	if (CWLoad(&map, path, mission) != 0)
+	{
+		WolfCacheTerminate(&c);
+		return -1;
+	}
+	for (int i = 0; i < map.audio.nSound; i++)
+	{
+		char *data = NULL;
+		size_t len;
+		if (CWAudioGetAdlibSound(&map.audio, i, &data, &len) == 0 && len > 0)
+		{
+			WolfCacheAddSound(
+				&c, WOLF_SOUND_ADLIB, i, (const uint8_t *)data,
+				(uint32_t)len);
+		}
+		free(data);
+	}
+	c.Dirty = true;
+	WolfCacheStore(&c, &map);
+	const double ms = Ms(start);
+	CWFree(&map);
+	WolfCacheTerminate(&c);
+	return ms;
+}
+// Import like a cache hit; returns -1 on a miss
+static double ImportWarm(const char *path, const int mission)
+{
+	const Uint64 start = SDL_GetPerformanceCounter();
+	WolfCache c;
+	WolfCacheInit(&c, CACHE_DIR, path, mission);
+	CWolfMap cached;
+	double ms = -1;
+	if (WolfCacheLoad(&c, &cached))
+	{
+		CWolfMap map;
+		if (CWLoadNoLevels(&map, path, mission) == 0)
+		{
+			map.levels = cached.levels;
+			map.nLevels = cached.nLevels;
+			ms = Ms(start);
+			CWFree(&map);
+		}
+	}
+	WolfCacheTerminate(&c);
+	return ms;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: wolf_cache_bench <wolf3d or spear dir> [mission]\n");
+		return 1;
+	}
+	if (SDL_Init(0) != 0)
+	{
+		printf("Failed to init SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+	CWAudioInit();
+	const int mission = argc > 2 ? atoi(argv[2]) : 1;
+	double cold = 0;
+	double warm = 0;
+	for (int i = 0; i < RUNS; i++)
+	{
+		const double c = ImportCold(argv[1], mission);
+		const double w = ImportWarm(argv[1], mission);
+		if (c < 0 || w < 0)
+		{
+			printf("Failed to import %s\n", argv[1]);
+			return 1;
+		}
+		printf("run %d: cold %8.1f ms, warm %8.1f ms\n", i, c, w);
+		cold += c;
+		warm += w;
+	}
+	printf("mean import: cold %.1f ms, warm %.1f ms\n", cold / RUNS,
+		   warm / RUNS);
+
+	CWAudioTerminate();
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,199 @@
+#include <cbehave/cbehave.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <files.h>
+#include <wolf_cache.h>
+
+#define CACHE_DIR "wolf_cache_test"
+#define GAME_DIR "wolf_cache_test_game"
+
+// Fake game files; only their bytes matter to the cache
+static void WriteGameFiles(const char *contents)
+{
+	const char *names[] = {"MAPHEAD", "GAMEMAPS", "AUDIOHED", "AUDIOT",
+						   "VSWAP"};
+	mkdir_deep(GAME_DIR);
+	for (int i = 0; i < 5; i++)
+	{
+		char buf[CDOGS_PATH_MAX];
+		sprintf(buf, GAME_DIR "/%s.WL1", names[i]);
+		FILE *f = fopen(buf, "wb");
+		fprintf(f, "%s %s", names[i], contents);
+		fclose(f);
+	}
+}
+// A map of one level, with planes filled from seed
+static CWolfMap NewMap(const uint16_t seed)
+{
+	CWolfMap m;
+	memset(&m, 0, sizeof m);
+	m.nLevels = 1;
+	CCALLOC(m.levels, sizeof *m.levels);
+	CWLevel *l = &m.levels[0];
+	l->header.width = 4;
+	l->header.height = 2;
+	strcpy(l->header.name, "Wolf1 Map1");
+	l->hasPlayerSpawn = true;
+	// The last plane is unused, like in the game
+	for (int i = 0; i < NUM_PLANES - 1; i++)
+	{
+		l->planes[i].len = 4 * 2 * sizeof(uint16_t);
+		CMALLOC(l->planes[i].plane, l->planes[i].len);
+		for (int j = 0; j < 4 * 2; j++)
+		{
+			l->planes[i].plane[j] = (uint16_t)(seed + i * 100 + j);
+		}
+	}
+	return m;
+}
+static void FreeMap(CWolfMap *m)
+{
+	for (int i = 0; i < m->nLevels; i++)
+	{
+		for (int j = 0; j < NUM_PLANES; j++)
+		{
+			CFREE(m->levels[i].planes[j].plane);
+		}
+	}
+	CFREE(m->levels);
+}
+static bool LevelsEqual(const CWolfMap *a, const CWolfMap *b)
+{
+	if (a->nLevels != b->nLevels)
+	{
+		return false;
+	}
+	for (int i = 0; i < a->nLevels; i++)
+	{
+		const CWLevel *la = &a->levels[i];
+		const CWLevel *lb = &b->levels[i];
+		if (memcmp(&la->header, &lb->header, sizeof la->header) != 0 ||
+			la->hasPlayerSpawn != lb->hasPlayerSpawn)
+		{
+			return false;
+		}
+		for (int j = 0; j < NUM_PLANES; j++)
+		{
+			const CWPlane *pa = &la->planes[j];
+			const CWPlane *pb = &lb->planes[j];
+			if ((pa->plane == NULL) != (pb->plane == NULL) ||
+				(pa->plane != NULL &&
+				 (pa->len != pb->len ||
+				  memcmp(pa->plane, pb->plane, pa->len) != 0)))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+static void GetEntryPath(char *buf, const WolfCache *c)
+{
+	sprintf(buf, CACHE_DIR "/%016llx.cdogswolf", (unsigned long long)c->Key);
+}
+static const uint8_t sSound[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+
+FEATURE(WolfCacheLoad, "Load cached Wolfenstein imports")
+	SCENARIO("Round trip")
+		GIVEN("a cache with a level and sounds stored")
+			WriteGameFiles("v1");
+			WolfCache c;
+			WolfCacheInit(&c, CACHE_DIR, GAME_DIR, 1);
+			// Remove the entry from earlier runs
+			char path[CDOGS_PATH_MAX];
+			GetEntryPath(path, &c);
+			remove(path);
+			CWolfMap m;
+			memset(&m, 0, sizeof m);
+			SHOULD_BE_FALSE(WolfCacheLoad(&c, &m));
+			m = NewMap(7);
+			WolfCacheAddSound(&c, WOLF_SOUND_ADLIB, 3, sSound, sizeof sSound);
+			WolfCacheAddSound(&c, WOLF_SOUND_DIGI, 3, sSound, 4);
+			WolfCacheStore(&c, &m);
+			WolfCacheTerminate(&c);
+		WHEN("I load it with another cache")
+			WolfCache c2;
+			WolfCacheInit(&c2, CACHE_DIR, GAME_DIR, 1);
+			CWolfMap loaded;
+			memset(&loaded, 0, sizeof loaded);
+			const bool ok = WolfCacheLoad(&c2, &loaded);
+		THEN("the levels should be the same")
+			SHOULD_BE_TRUE(ok);
+			SHOULD_BE_TRUE(LevelsEqual(&m, &loaded));
+		AND("the sounds should be the same")
+			const WolfCacheSound *adlib =
+				WolfCacheGetSound(&c2, WOLF_SOUND_ADLIB, 3);
+			const WolfCacheSound *digi =
+				WolfCacheGetSound(&c2, WOLF_SOUND_DIGI, 3);
+			SHOULD_BE_TRUE(adlib != NULL && digi != NULL);
+			SHOULD_INT_EQUAL((int)adlib->Len, (int)sizeof sSound);
+			SHOULD_MEM_EQUAL(adlib->Data, sSound, sizeof sSound);
+			SHOULD_INT_EQUAL((int)digi->Len, 4);
+			SHOULD_BE_TRUE(
+				WolfCacheGetSound(&c2, WOLF_SOUND_DIGI, 4) == NULL);
+		AND("there should be nothing new to store")
+			SHOULD_BE_FALSE(c2.Dirty);
+		WolfCacheTerminate(&c2);
+		FreeMap(&m);
+		FreeMap(&loaded);
+	SCENARIO_END
+
+	SCENARIO("Changed game files")
+		GIVEN("a cache stored for some game files")
+			WriteGameFiles("v1");
+			WolfCache c;
+			WolfCacheInit(&c, CACHE_DIR, GAME_DIR, 1);
+			CWolfMap m = NewMap(1);
+			c.Dirty = true;
+			WolfCacheStore(&c, &m);
+			WolfCacheTerminate(&c);
+		WHEN("the game files change")
+			WriteGameFiles("v2");
+			WolfCacheInit(&c, CACHE_DIR, GAME_DIR, 1);
+			CWolfMap loaded;
+			memset(&loaded, 0, sizeof loaded);
+		THEN("the old entry should not be loaded")
+			SHOULD_BE_FALSE(WolfCacheLoad(&c, &loaded));
+			SHOULD_INT_EQUAL(loaded.nLevels, 0);
+		WolfCacheTerminate(&c);
+		FreeMap(&m);
+	SCENARIO_END
+
+	SCENARIO("Corrupt entry")
+		GIVEN("a cache entry that has been damaged")
+			WriteGameFiles("v3");
+			WolfCache c;
+			WolfCacheInit(&c, CACHE_DIR, GAME_DIR, 1);
+			CWolfMap m = NewMap(2);
+			WolfCacheAddSound(&c, WOLF_SOUND_ADLIB, 0, sSound, sizeof sSound);
+			WolfCacheStore(&c, &m);
+			char path[CDOGS_PATH_MAX];
+			GetEntryPath(path, &c);
+			WolfCacheTerminate(&c);
+			FILE *f = fopen(path, "r+b");
+			fseek(f, -2, SEEK_END);
+			fputc('x', f);
+			fclose(f);
+		WHEN("I load it")
+			WolfCacheInit(&c, CACHE_DIR, GAME_DIR, 1);
+			CWolfMap loaded;
+			memset(&loaded, 0, sizeof loaded);
+			const bool ok = WolfCacheLoad(&c, &loaded);
+		THEN("it should be rejected and removed")
+			SHOULD_BE_FALSE(ok);
+			SHOULD_INT_EQUAL((int)c.Sounds.size, 0);
+			FILE *removed = fopen(path, "rb");
+			SHOULD_BE_TRUE(removed == NULL);
+			if (removed != NULL)
+			{
+				fclose(removed);
+			}
+		WolfCacheTerminate(&c);
+		FreeMap(&m);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Wolf cache features are:", TEST_FEATURE(WolfCacheLoad))
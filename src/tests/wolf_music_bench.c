@@ -0,0 +1,148 @@
+// Benchmark for Wolfenstein music; compares rendering each whole song before
+// playing it, with streaming it from the music hook. Reports the time until
+// the song is first mixed, and the memory the song's audio needs.
+// Not run as part of the tests.
+// Usage: wolf_music_bench <wolf3d or spear dir> [spear mission]
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <cwolfmap/audio.h>
+#include <cwolfmap/cwolfmap.h>
+#include <utils.h>
+
+#define CHUNK_SIZE 1024
+
+static SDL_atomic_t sMixed;
+static void PostMix(void *udata, Uint8 *stream, int len)
+{
+	UNUSED(udata);
+	UNUSED(stream);
+	UNUSED(len);
+	SDL_AtomicAdd(&sMixed, 1);
+}
+// Wait for the mixer to output a buffer with the song in it
+static double WaitForMix(const Uint64 start)
+{
+	SDL_AtomicSet(&sMixed, 0);
+	while (SDL_AtomicGet(&sMixed) == 0)
+	{
+		SDL_Delay(1);
+	}
+	return (double)(SDL_GetPerformanceCounter() - start) * 1000 /
+		   SDL_GetPerformanceFrequency();
+}
+
+static void FillMusic(void *data, Uint8 *stream, int len)
+{
+	CWAudioMusicStreamRender(
+		data, (int16_t *)stream, len / (MUSIC_AUDIO_CHANNELS * 2));
+}
+
+typedef struct
+{
+	double Ms;
+	size_t Bytes;
+} Result;
+static Result PlayWhole(const CWolfMap *map, const int i)
+{
+	Result r;
+	const Uint64 start = SDL_GetPerformanceCounter();
+	char *data;
+	CWAudioGetMusic(&map->audio, i, &data, &r.Bytes);
+	Mix_Chunk *chunk = Mix_QuickLoad_RAW((Uint8 *)data, (Uint32)r.Bytes);
+	const int channel = Mix_PlayChannel(-1, chunk, -1);
+	r.Ms = WaitForMix(start);
+	Mix_HaltChannel(channel);
+	Mix_FreeChunk(chunk);
+	free(data);
+	return r;
+}
+static Result PlayStream(const CWolfMap *map, const int i)
+{
+	Result r;
+	const Uint64 start = SDL_GetPerformanceCounter();
+	const char *raw;
+	CWAudioGetMusicRaw(&map->audio, i, &raw, &r.Bytes);
+	CWMusicStream s;
+	CWAudioMusicStreamInit(&s, raw, r.Bytes);
+	Mix_HookMusic(FillMusic, &s);
+	r.Ms = WaitForMix(start);
+	Mix_HookMusic(NULL, NULL);
+	// The stream renders into the mixer's buffer; it only keeps the song
+	r.Bytes += sizeof s;
+	return r;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: wolf_music_bench <wolf3d or spear dir> [mission]\n");
+		return 1;
+	}
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+	if (SDL_Init(SDL_INIT_AUDIO) != 0)
+	{
+		printf("Failed to init SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+	if (Mix_OpenAudio(
+			MUSIC_SAMPLE_RATE, MUSIC_AUDIO_FMT, MUSIC_AUDIO_CHANNELS,
+			CHUNK_SIZE) != 0)
+	{
+		printf("Failed to open audio: %s\n", Mix_GetError());
+		return 1;
+	}
+	Mix_SetPostMix(PostMix, NULL);
+	CWAudioInit();
+	CWolfMap map;
+	const int err = CWLoad(&map, argv[1], argc > 2 ? atoi(argv[2]) : 1);
+	if (err != 0)
+	{
+		printf("Failed to load %s: %d\n", argv[1], err);
+		return 1;
+	}
+
+	Result whole = {0, 0};
+	Result stream = {0, 0};
+	size_t wholePeak = 0;
+	int songs = 0;
+	for (int i = 0; i < map.audio.nMusic; i++)
+	{
+		const char *raw;
+		size_t rawLen;
+		if (CWAudioGetMusicRaw(&map.audio, i, &raw, &rawLen) != 0 ||
+			rawLen == 0)
+		{
+			continue;
+		}
+		const Result w = PlayWhole(&map, i);
+		const Result s = PlayStream(&map, i);
+		printf(
+			"song %2d: whole %8.1f ms %8.1f KB, stream %8.1f ms %8.1f KB\n",
+			i, w.Ms, w.Bytes / 1024.0, s.Ms, s.Bytes / 1024.0);
+		whole.Ms += w.Ms;
+		stream.Ms += s.Ms;
+		wholePeak = w.Bytes > wholePeak ? w.Bytes : wholePeak;
+		stream.Bytes = s.Bytes > stream.Bytes ? s.Bytes : stream.Bytes;
+		songs++;
+	}
+	if (songs > 0)
+	{
+		printf(
+			"mean time to first audio: whole %.1f ms, stream %.1f ms\n",
+			whole.Ms / songs, stream.Ms / songs);
+		printf(
+			"peak song memory: whole %.1f KB, stream %.1f KB\n",
+			wholePeak / 1024.0, stream.Bytes / 1024.0);
+	}
+
+	CWFree(&map);
+	CWAudioTerminate();
+	Mix_CloseAudio();
+	SDL_Quit();
+	return 0;
+}